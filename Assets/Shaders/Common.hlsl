@@ -35,6 +35,16 @@ struct InstanceData {
 	uint		MaterialIndex;
 	int			AnimClipIndex;
 	uint		InstPad0;
+	// Clip samples blended with (AnimClipIndex, TimePos); an unused one has the clip index of -1.
+	// BlendWeights.x weighs the primary sample and BlendWeights[i + 1] the i-th of these.
+	int3		BlendAnimClipIndices;
+	float3		BlendTimePos;
+	float4		BlendWeights;
+	// TimePos plays on at TimeRate frames per second since TimeBase(gTotalTime), wrapped at TimeEnd; 0 holds it.
+	float		TimeRate;
+	float		TimeBase;
+	float		TimeEnd;
+	uint3		InstPad1;
 };
 
 struct MaterialData {
@@ -78,6 +88,30 @@ StructuredBuffer<InstanceIdxData>	gInstIdxData	: register(t0, space1);
 StructuredBuffer<InstanceData>		gInstanceData	: register(t1, space1);
 StructuredBuffer<MaterialData>		gMaterialData	: register(t2, space1);
 
+// Skinning matrix of a bone at a fractional frame of a clip; the two baked frames around it are blended.
+float4x4 SampleBoneTransform(int boneIndex, int animClipIndex, float timePos) {
+	int rowIndex = boneIndex * 4;
+	int colIndex = animClipIndex + (int)timePos;
+	float pct = timePos - (int)timePos;
+
+	float4 r1_f0 = gAnimationsDataMap.Load(int3(rowIndex, colIndex, 0));
+	float4 r2_f0 = gAnimationsDataMap.Load(int3(rowIndex + 1, colIndex, 0));
+	float4 r3_f0 = gAnimationsDataMap.Load(int3(rowIndex + 2, colIndex, 0));
+	float4 r4_f0 = gAnimationsDataMap.Load(int3(rowIndex + 3, colIndex, 0));
+
+	float4 r1_f1 = gAnimationsDataMap.Load(int3(rowIndex, colIndex + 1, 0));
+	float4 r2_f1 = gAnimationsDataMap.Load(int3(rowIndex + 1, colIndex + 1, 0));
+	float4 r3_f1 = gAnimationsDataMap.Load(int3(rowIndex + 2, colIndex + 1, 0));
+	float4 r4_f1 = gAnimationsDataMap.Load(int3(rowIndex + 3, colIndex + 1, 0));
+
+	float4 r1 = r1_f0 + pct * (r1_f1 - r1_f0);
+	float4 r2 = r2_f0 + pct * (r2_f1 - r2_f0);
+	float4 r3 = r3_f0 + pct * (r3_f1 - r3_f0);
+	float4 r4 = r4_f0 + pct * (r4_f1 - r4_f0);
+
+	return float4x4(r1, r2, r3, r4);
+}
+
 SamplerState			gsamPointWrap				: register(s0);
 SamplerState			gsamPointClamp				: register(s1);
 SamplerState			gsamLinearWrap				: register(s2);
@@ -90,7 +124,7 @@ SamplerState			gsamDepthMap				: register(s7);
 // Constant data that varies per frame.
 cbuffer cbPerObject : register(b0) {
 	uint gObjectIndex;
-	uint gObjectPad0;
+	uint gInstanceOffset;
 	uint gObjectPad1;
 	uint gObjectPad2;
 };
@@ -123,10 +157,27 @@ cbuffer cbPass : register(b1) {
 };
 
 cbuffer cbRootConstants : register(b2) {
-	uint	gMaxInstanceCount;
+	uint	gConstantsPad0;
 	uint	gEffectEnabled;
 };
 
+// Skinning matrix of a bone blended over the weighted clip samples of an instance.
+float4x4 GetBoneTransform(InstanceData instData, int boneIndex) {
+	float timePos = instData.TimePos;
+	if (instData.TimeRate > 0.0f)
+		timePos = fmod(timePos + max(gTotalTime - instData.TimeBase, 0.0f) * instData.TimeRate, instData.TimeEnd);
+
+	float4x4 trans = instData.BlendWeights.x * SampleBoneTransform(boneIndex, instData.AnimClipIndex, timePos);
+
+	[unroll]
+	for (int i = 0; i < 3; ++i) {
+		if (instData.BlendAnimClipIndices[i] != -1)
+			trans += instData.BlendWeights[i + 1] * SampleBoneTransform(boneIndex, instData.BlendAnimClipIndices[i], instData.BlendTimePos[i]);
+	}
+
+	return trans;
+}
+
 //---------------------------------------------------------------------------------------
 // Transforms a normal map sample to world space.
 //---------------------------------------------------------------------------------------
@@ -22,11 +22,17 @@ struct VertexIn {
 	float3 PosL						: POSITION;
 	float2 TexC						: TEXCOORD;
 #ifdef SKINNED
+#ifdef QUANTIZED_SKIN
+	// Unorm weights and bone indices of the compact skin stream(input slot 1).
+	float4 BoneWeights0				: BONEWEIGHTS0;
+	uint4 BoneIndices0				: BONEINDICES0;
+#else
 	float4 BoneWeights0				: BONEWEIGHTS0;
 	float4 BoneWeights1				: BONEWEIGHTS1;
 	int4 BoneIndices0				: BONEINDICES0;
 	int4 BoneIndices1				: BONEINDICES1;
 #endif
+#endif
 };
 
 struct VertexOut {
@@ -38,7 +44,7 @@ struct VertexOut {
 VertexOut VS(VertexIn vin, uint instanceID : SV_InstanceID) {
 	VertexOut vout = (VertexOut)0.0f;
 
-	InstanceIdxData instIdxData = gInstIdxData[gObjectIndex * gMaxInstanceCount + instanceID];
+	InstanceIdxData instIdxData = gInstIdxData[gInstanceOffset + instanceID];
 	InstanceData instData = gInstanceData[instIdxData.InstIdx];
 	float4x4 world = instData.World;
 	float4x4 texTransform = instData.TexTransform;
@@ -48,7 +54,32 @@ VertexOut VS(VertexIn vin, uint instanceID : SV_InstanceID) {
 
 	MaterialData matData = gMaterialData[matIndex];
 	
-#ifdef SKINNED
+#if defined(SKINNED) && defined(QUANTIZED_SKIN)
+	float weights[4];
+	weights[0] = vin.BoneWeights0.x;
+	weights[1] = vin.BoneWeights0.y;
+	weights[2] = vin.BoneWeights0.z;
+	weights[3] = vin.BoneWeights0.w;
+
+	uint indices[4];
+	indices[0] = vin.BoneIndices0.x;
+	indices[1] = vin.BoneIndices0.y;
+	indices[2] = vin.BoneIndices0.z;
+	indices[3] = vin.BoneIndices0.w;
+
+	float3 posL = float3(0.0f, 0.0f, 0.0f);
+	for (int i = 0; i < 4; ++i) {
+		// The influences are sorted by weight and the unused ones weigh 0.
+		if (weights[i] == 0.0f)
+			break;
+
+		float4x4 trans = GetBoneTransform(instData, indices[i]);
+
+		posL += weights[i] * mul(float4(vin.PosL, 1.0f), trans).xyz;
+	}
+
+	vin.PosL = posL;
+#elif defined(SKINNED)
 	float weights[8];
 	weights[0] = vin.BoneWeights0.x;
 	weights[1] = vin.BoneWeights0.y;
@@ -76,26 +107,7 @@ VertexOut VS(VertexIn vin, uint instanceID : SV_InstanceID) {
 		if (indices[i] == -1)
 			break;
 
-		int rowIndex = indices[i] * 4;
-		int colIndex = instData.AnimClipIndex + (int)instData.TimePos;
-		float pct = instData.TimePos - (int)instData.TimePos;
-
-		float4 r1_f0 = gAnimationsDataMap.Load(int3(rowIndex, colIndex, 0));
-		float4 r2_f0 = gAnimationsDataMap.Load(int3(rowIndex + 1, colIndex, 0));
-		float4 r3_f0 = gAnimationsDataMap.Load(int3(rowIndex + 2, colIndex, 0));
-		float4 r4_f0 = gAnimationsDataMap.Load(int3(rowIndex + 3, colIndex, 0));
-
-		float4 r1_f1 = gAnimationsDataMap.Load(int3(rowIndex, colIndex + 1, 0));
-		float4 r2_f1 = gAnimationsDataMap.Load(int3(rowIndex + 1, colIndex + 1, 0));
-		float4 r3_f1 = gAnimationsDataMap.Load(int3(rowIndex + 2, colIndex + 1, 0));
-		float4 r4_f1 = gAnimationsDataMap.Load(int3(rowIndex + 3, colIndex + 1, 0));
-
-		float4 r1 = r1_f0 + pct * (r1_f1 - r1_f0);
-		float4 r2 = r2_f0 + pct * (r2_f1 - r2_f0);
-		float4 r3 = r3_f0 + pct * (r3_f1 - r3_f0);
-		float4 r4 = r4_f0 + pct * (r4_f1 - r4_f0);
-
-		float4x4 trans = { r1, r2, r3, r4 };
+		float4x4 trans = GetBoneTransform(instData, indices[i]);
 
 		posL += weights[i] * mul(float4(vin.PosL, 1.0f), trans).xyz;
 	}
@@ -26,8 +26,7 @@ struct VertexIn {
 struct VertexOut {
     float3		PosW			: POSITION;
 	float2		TexC			: TEXCOORD;
-	float		TimePos			: TIMEPOS;
-	uint		AnimClipIndex	: CLIPIDX;
+	uint		InstIdx			: INSTIDX;
 	float4x4	World			: WORLDMAT;
 };
 
@@ -39,14 +38,13 @@ struct GeoOut {
 VertexOut VS(VertexIn vin, uint instanceID : SV_InstanceID) {
 	VertexOut vout = (VertexOut)0.0f; 
 
-	InstanceIdxData instIdxData = gInstIdxData[gObjectIndex * gMaxInstanceCount + instanceID];
+	InstanceIdxData instIdxData = gInstIdxData[gInstanceOffset + instanceID];
 	InstanceData instData = gInstanceData[instIdxData.InstIdx];
 	float4x4 world = instData.World;
 
 	vout.PosW = vin.PosL;
 	vout.TexC = vin.TexC;
-	vout.TimePos = instData.TimePos;
-	vout.AnimClipIndex = instData.AnimClipIndex;
+	vout.InstIdx = instIdxData.InstIdx;
 	vout.World = world;
 
     return vout;
@@ -63,26 +61,7 @@ void GS(line VertexOut gin[2],
 		float3 posL = gin[i].PosW;		
 		int boneIndex = (int)gin[i].TexC.x;
 
-		int rowIndex = boneIndex * 4;
-		int colIndex = gin[i].AnimClipIndex + (int)gin[i].TimePos;
-		float pct = gin[i].TimePos - (int)gin[i].TimePos;
-
-		float4 r1_f0 = gAnimationsDataMap.Load(int3(rowIndex, colIndex, 0));
-		float4 r2_f0 = gAnimationsDataMap.Load(int3(rowIndex + 1, colIndex, 0));
-		float4 r3_f0 = gAnimationsDataMap.Load(int3(rowIndex + 2, colIndex, 0));
-		float4 r4_f0 = gAnimationsDataMap.Load(int3(rowIndex + 3, colIndex, 0));
-		
-		float4 r1_f1 = gAnimationsDataMap.Load(int3(rowIndex, colIndex + 1, 0));
-		float4 r2_f1 = gAnimationsDataMap.Load(int3(rowIndex + 1, colIndex + 1, 0));
-		float4 r3_f1 = gAnimationsDataMap.Load(int3(rowIndex + 2, colIndex + 1, 0));
-		float4 r4_f1 = gAnimationsDataMap.Load(int3(rowIndex + 3, colIndex + 1, 0));
-		
-		float4 r1 = r1_f0 + pct * (r1_f1 - r1_f0);
-		float4 r2 = r2_f0 + pct * (r2_f1 - r2_f0);
-		float4 r3 = r3_f0 + pct * (r3_f1 - r3_f0);
-		float4 r4 = r4_f0 + pct * (r4_f1 - r4_f0);
-		
-		float4x4 trans = { r1, r2, r3, r4 };
+		float4x4 trans = GetBoneTransform(gInstanceData[gin[i].InstIdx], boneIndex);
 
 		if (boneIndex != -1)
 			posL = mul(float4(posL, 1.0f), trans).xyz;
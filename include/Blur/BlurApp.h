@@ -6,6 +6,7 @@
 #include "common/MathHelper.h"
 #include "common/UploadBuffer.h"
 #include "common/GeometryGenerator.h"
+#include "common/TextModelLoader.h"
 #include "FrameResource.h"
 #include "Waves.h"
 #include "BlurFilter.h"
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace Game {
+	class Animation;
+
+	struct AnimationCompressionSettings;
+	struct AnimationCompressionStatistics;
+	class CompressedAnimation;
+}
+
+struct Game::AnimationCompressionSettings {
+public:
+	// Maximum distance between an interpolated translation(or scale) and the source value.
+	float mTranslationTolerance = 0.001f;
+	float mScaleTolerance = 0.0001f;
+	// Maximum angle in radians between an interpolated rotation and the source value.
+	float mRotationTolerance = 0.0005f;
+
+	// Distance from the bone origin of the points the reported error is measured at.
+	float mErrorDistance = 1.0f;
+	// Largest measured error(AnimationCompressionStatistics::mMaxError) a compressed clip may have.
+	// The channels can't represent a matrix with shear, so such a clip fails and keeps its raw curves.
+	float mMaxError = 0.01f;
+};
+
+struct Game::AnimationCompressionStatistics {
+public:
+	std::uint64_t mRawBytes = 0;
+	std::uint64_t mCompressedBytes = 0;
+
+	// Channels(translation, rotation and scale of every track) by the way they are stored.
+	std::uint32_t mNumDefaultChannels = 0;
+	std::uint32_t mNumConstantChannels = 0;
+	std::uint32_t mNumAnimatedChannels = 0;
+
+	// Keys of the animated channels before and after the key reduction.
+	std::uint64_t mNumSourceKeys = 0;
+	std::uint64_t mNumKeys = 0;
+
+	// Largest distance between the source and the decompressed transform of a point mErrorDistance
+	//  away from a bone origin, over all the baked frames.
+	float mMaxError = 0.0f;
+	std::uint32_t mMaxErrorTrack = 0;
+	std::uint32_t mMaxErrorFrame = 0;
+};
+
+//* Compressed copy of the baked curves of a clip.
+//* Every bone matrix is decomposed into translation, rotation and scale channels, and each channel is
+//*  -dropped when it stays at the identity value(default),
+//*  -stored once when it doesn't change within the tolerance(constant),
+//*  -otherwise quantized(smallest-three 48-bit rotations, 16-bit range-relative translations and scales)
+//*   and reduced to the keys that linear interpolation can't reproduce within the tolerance(animated).
+//* The quantization step is the error floor; the tolerances bound what the key reduction adds to it.
+class Game::CompressedAnimation {
+public:
+	enum EChannelMode : std::uint8_t {
+		EDefault,
+		EConstant,
+		EAnimated
+	};
+
+	struct Channel {
+		EChannelMode mMode = EDefault;
+		std::uint32_t mFirstKey = 0;
+		std::uint32_t mNumKeys = 0;
+		// The value of a constant channel, or the minimum and the quantization step of an animated one.
+		DirectX::XMFLOAT4 mMin = { 0.0f, 0.0f, 0.0f, 0.0f };
+		DirectX::XMFLOAT4 mStep = { 0.0f, 0.0f, 0.0f, 0.0f };
+	};
+
+public:
+	CompressedAnimation() = default;
+	virtual ~CompressedAnimation() = default;
+
+public:
+	//* Builds the compressed copy of inAnimation.mCurves.
+	//* Returns false(and stays empty) if the curves aren't all mNumFrames long,
+	//*  a matrix can't be decomposed, the clip has more frames than the key format can address
+	//*  or the measured error exceeds inSettings.mMaxError(the statistics keep the measured error).
+	bool Compress(const Game::Animation& inAnimation, const AnimationCompressionSettings& inSettings);
+
+	//* Restores a clip from the arrays the getters below return(the cooked container stores them as they are).
+	//* Returns false(and stays empty) if a channel is broken or indexes keys out of bounds.
+	bool Assign(std::uint32_t inNumTracks, std::uint32_t inNumFrames, std::vector<Channel> inChannels,
+		std::vector<std::uint16_t> inKeyFrames, std::vector<std::uint16_t> inKeyData, float inMaxError);
+
+	//* Writes a transform per track to outTransforms(GetNumTracks() elements).
+	//* inFrame is a fractional frame index and is clamped to the clip.
+	void SamplePose(float inFrame, DirectX::XMFLOAT4X4* outTransforms) const;
+
+	bool IsEmpty() const;
+	size_t GetNumTracks() const;
+	size_t GetNumFrames() const;
+	size_t GetByteSize() const;
+
+	const AnimationCompressionStatistics& GetStatistics() const;
+
+	//* Translation, rotation and scale channels of every track.
+	const std::vector<Channel>& GetChannels() const;
+	//* Frame index of every key of the animated channels.
+	const std::vector<std::uint16_t>& GetKeyFrames() const;
+	//* Three words per key.
+	const std::vector<std::uint16_t>& GetKeyData() const;
+
+private:
+	enum EChannelType {
+		ETranslation,
+		ERotation,
+		EScale,
+		ENumChannelTypes
+	};
+
+	void BuildVectorChannel(Channel& outChannel, const std::vector<DirectX::XMFLOAT4>& inValues,
+		const DirectX::XMFLOAT4& inDefault, float inTolerance);
+	void BuildRotationChannel(Channel& outChannel, const std::vector<DirectX::XMFLOAT4>& inValues, float inTolerance);
+	//* Keeps the first and the last key and every key the segments between them need.
+	void AddReducedKeys(Channel& outChannel, const std::vector<DirectX::XMFLOAT4>& inValues,
+		const std::vector<std::uint16_t>& inEncoded, bool inIsRotation, float inTolerance);
+
+	DirectX::XMVECTOR SampleChannel(const Channel& inChannel, EChannelType inType, float inFrame) const;
+	DirectX::XMVECTOR DecodeKey(const Channel& inChannel, EChannelType inType, std::uint32_t inKey) const;
+
+	void Clear();
+	//* Counts the channels and the bytes; the error is measured separately.
+	void BuildStatistics();
+	void MeasureError(const Game::Animation& inAnimation, float inErrorDistance);
+
+private:
+	std::uint32_t mNumTracks = 0;
+	std::uint32_t mNumFrames = 0;
+
+	// ENumChannelTypes channels per track.
+	std::vector<Channel> mChannels;
+
+	// Frame index and three 16-bit words of every key of the animated channels.
+	std::vector<std::uint16_t> mKeyFrames;
+	std::vector<std::uint16_t> mKeyData;
+
+	AnimationCompressionStatistics mStatistics;
+};
\ No newline at end of file
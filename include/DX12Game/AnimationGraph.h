@@ -0,0 +1,213 @@
+#pragma once
+
+#include "DX12Game/PoseSampler.h"
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Game {
+	class SkinnedData;
+
+	struct AnimationGraphStatistics;
+	class AnimationGraph;
+	class AnimationGraphBatch;
+}
+
+struct Game::AnimationGraphStatistics {
+public:
+	std::uint32_t mNumGraphs = 0;
+
+	// Milliseconds spent on the whole batch and on the characters of the last evaluation.
+	float mBatchTime = 0.0f;
+	float mMaxGraphTime = 0.0f;
+	float mAverageGraphTime = 0.0f;
+};
+
+//* Blends the clips of a skeletal mesh by named parameters.
+//* The nodes are clips and 1D/2D blend spaces of other nodes;
+//*  the played node(motion) crossfades from the previous one and additive layers are added on top of it.
+//* Every clip under a motion runs at the same normalized phase, so a walk and a run of different lengths
+//*  stay in step while blended.
+//* Evaluate flattens the graph into weighted clip samples(terms); an additive layer is the difference
+//*  between its clip and the first frame of that clip, i.e. a +weight term and a -weight reference term.
+class Game::AnimationGraph {
+public:
+	using NodeId = std::uint32_t;
+	using ParameterId = std::uint32_t;
+
+	static const NodeId InvalidNode = 0xFFFFFFFF;
+	static const ParameterId InvalidParameter = 0xFFFFFFFF;
+
+	// Clip samples per instance the skinning shaders blend.
+	static const size_t MaxGpuTerms = 4;
+
+public:
+	AnimationGraph() = default;
+	virtual ~AnimationGraph() = default;
+
+private:
+	AnimationGraph(const AnimationGraph& src) = delete;
+	AnimationGraph& operator=(const AnimationGraph& rhs) = delete;
+	AnimationGraph(AnimationGraph&& src) = delete;
+	AnimationGraph& operator=(AnimationGraph&& rhs) = delete;
+
+public:
+	//* Returns the existing parameter if the name is already added.
+	ParameterId AddParameter(const std::string& inName, float inValue = 0.0f);
+	ParameterId FindParameter(const std::string& inName) const;
+	void SetParameter(ParameterId inParameter, float inValue);
+	float GetParameter(ParameterId inParameter) const;
+
+	//* inRate scales the playback speed of the clip.
+	NodeId AddClip(const std::string& inClipName, float inRate = 1.0f);
+	NodeId AddBlendSpace1D(ParameterId inParameter);
+	//* The two samples around the parameter value are blended linearly;
+	//*  the value is clamped to the first and the last threshold.
+	//* A sample that would make the blend space its own descendant is rejected.
+	bool AddBlendSpace1DSample(NodeId inBlendSpace, NodeId inChild, float inThreshold);
+	NodeId AddBlendSpace2D(ParameterId inParameterX, ParameterId inParameterY);
+	//* The samples are weighted by gradient band interpolation.
+	bool AddBlendSpace2DSample(NodeId inBlendSpace, NodeId inChild, float inX, float inY);
+
+	//* Crossfades from the current motion to inNode over inFadeDuration seconds.
+	void Play(NodeId inNode, float inFadeDuration = 0.2f);
+	NodeId GetCurrentMotion() const;
+
+	//* Returns the index of the layer.
+	size_t AddAdditiveLayer(NodeId inNode, float inWeight = 1.0f);
+	void SetLayerWeight(size_t inLayer, float inWeight);
+
+	//* Resolves the clip names against the skinned data of a mesh; clips it doesn't have contribute nothing.
+	//* inGetClipIndex maps a clip name to its index in the animations map(Mesh::GetClipIndex).
+	void Bind(const Game::SkinnedData* inSkinnedData, const std::function<std::uint32_t(const std::string&)>& inGetClipIndex);
+	//* Samples the blended pose into the buffers as part of Evaluate; they must outlive the graph or be reset.
+	//* Pass nullptr to stop sampling on the CPU.
+	void SetCpuPoseOutput(const Game::SkinnedData* inSkinnedData,
+		DirectX::XMFLOAT4X4* outSkinningPalette, DirectX::XMFLOAT4X4* outBoneTransforms);
+
+	//* Advances the phases by inDeltaTime seconds and rebuilds the terms.
+	void Evaluate(float inDeltaTime);
+
+	const std::vector<Game::PoseTerm>& GetTerms() const;
+	//* The MaxGpuTerms heaviest terms; an additive term is kept or dropped with its reference term
+	//*  and only the weights of the motions are renormalized.
+	const std::vector<Game::PoseTerm>& GetGpuTerms() const;
+	//* Milliseconds the last Evaluate took.
+	float GetEvaluationTime() const;
+
+private:
+	enum ENodeType {
+		EClip,
+		EBlendSpace1D,
+		EBlendSpace2D
+	};
+
+	struct Node {
+		ENodeType mType = EClip;
+
+		std::string mClipName;
+		float mRate = 1.0f;
+		const Game::Animation* mAnimation = nullptr;
+		std::uint32_t mClipIndex = 0;
+
+		ParameterId mParameterX = InvalidParameter;
+		ParameterId mParameterY = InvalidParameter;
+		std::vector<NodeId> mChildren;
+		std::vector<DirectX::XMFLOAT2> mPositions;
+		// Weights of the children as of the last evaluation.
+		std::vector<float> mWeights;
+	};
+
+	struct Motion {
+		NodeId mNode = InvalidNode;
+		// Normalized time in [0, 1).
+		float mPhase = 0.0f;
+	};
+
+	struct Layer {
+		Motion mMotion;
+		float mWeight = 1.0f;
+	};
+
+	struct Leaf {
+		NodeId mNode;
+		float mWeight;
+	};
+
+	// A motion term or an additive term with its reference term, picked for the GPU as a unit.
+	struct TermGroup {
+		size_t mFirstTerm;
+		size_t mNumTerms;
+		float mWeight;
+	};
+
+	//* Whether inTo is inFrom or one of its descendants.
+	bool IsReachable(NodeId inFrom, NodeId inTo) const;
+
+	void UpdateWeights(Node& ioNode);
+	//* Appends the clips under inNode with their weights to mLeaves.
+	void CollectLeaves(NodeId inNode, float inWeight);
+	//* Advances the phase of a motion and appends its terms; mLeaves holds the clips of the motion.
+	void AddMotionTerms(Motion& ioMotion, float inWeight, float inDeltaTime, bool inIsAdditive);
+	void BuildGpuTerms();
+
+private:
+	std::vector<float> mParameters;
+	std::unordered_map<std::string, ParameterId> mParameterIds;
+
+	std::vector<Node> mNodes;
+
+	Motion mCurrMotion;
+	Motion mPrevMotion;
+	float mFadeDuration = 0.0f;
+	float mFadeTime = 0.0f;
+
+	std::vector<Layer> mLayers;
+
+	const Game::SkinnedData* mSkinnedData = nullptr;
+	DirectX::XMFLOAT4X4* mSkinningPalette = nullptr;
+	DirectX::XMFLOAT4X4* mBoneTransforms = nullptr;
+
+	// Reused by every evaluation, so Evaluate doesn't allocate once they have grown.
+	std::vector<Leaf> mLeaves;
+	std::vector<Game::PoseTerm> mTerms;
+	std::vector<Game::PoseTerm> mGpuTerms;
+	std::vector<TermGroup> mTermGroups;
+	// The motions come first in mTerms; the additive pairs follow them.
+	size_t mNumMotionTerms = 0;
+
+	float mEvaluationTime = 0.0f;
+};
+
+//* The graphs of every character, evaluated as parallel jobs once a frame.
+//* Evaluate must run while no graph is read or written by the game threads;
+//*  Add and Remove may be called from any thread.
+class Game::AnimationGraphBatch {
+public:
+	AnimationGraphBatch() = default;
+	virtual ~AnimationGraphBatch() = default;
+
+private:
+	AnimationGraphBatch(const AnimationGraphBatch& src) = delete;
+	AnimationGraphBatch& operator=(const AnimationGraphBatch& rhs) = delete;
+	AnimationGraphBatch(AnimationGraphBatch&& src) = delete;
+	AnimationGraphBatch& operator=(AnimationGraphBatch&& rhs) = delete;
+
+public:
+	void Add(Game::AnimationGraph* inGraph);
+	void Remove(Game::AnimationGraph* inGraph);
+
+	void Evaluate(float inDeltaTime);
+
+	AnimationGraphStatistics GetStatistics() const;
+
+private:
+	mutable std::mutex mMutex;
+
+	std::vector<Game::AnimationGraph*> mGraphs;
+
+	AnimationGraphStatistics mStatistics;
+};
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Game {
+	class Skeleton;
+	class SkinnedData;
+
+	struct AnimationLodLevel;
+	struct AnimationLodStatistics;
+	class AnimationLod;
+}
+
+struct Game::AnimationLodLevel {
+public:
+	// Smallest screen size(AnimationLod::ComputeScreenSize) drawn at this level.
+	float mMinScreenSize = 0.0f;
+	// The character is updated every mUpdateInterval frames; the shaders play the clip on in between.
+	std::uint32_t mUpdateInterval = 1;
+	// Levels of the skeleton, counted from the leaves, that follow their parent in the CPU pose.
+	std::uint32_t mMaskedLeafLevels = 0;
+};
+
+struct Game::AnimationLodStatistics {
+public:
+	static constexpr std::uint32_t MaxLevels = 4;
+
+public:
+	// Skeletons ticked in the last frame and how many of them were updated.
+	std::uint32_t mNumSkeletons = 0;
+	std::uint32_t mNumUpdated = 0;
+	std::uint32_t mNumSkipped = 0;
+	std::uint32_t mNumPerLevel[MaxLevels] = {};
+};
+
+//* Picks how often and at what detail the characters are animated from their size on the screen.
+//* A level updates a character every few frames, staggered by the slot the character registered with,
+//*  so the updates of a crowd spread over the frames instead of landing on the same one;
+//*  the levels of distant characters also mask the leaf bones(fingers, facial bones) of the CPU pose.
+//* ShouldUpdate may be called from any game thread; BeginFrame must be called while no game thread ticks.
+class Game::AnimationLod {
+public:
+	static constexpr std::uint32_t MaxLevels = AnimationLodStatistics::MaxLevels;
+	// A character refines past its current level once it is this much larger than the threshold,
+	//  so a character at a threshold doesn't flip between two levels every frame.
+	static constexpr float Hysteresis = 0.1f;
+
+public:
+	AnimationLod();
+	virtual ~AnimationLod() = default;
+
+private:
+	AnimationLod(const AnimationLod& src) = delete;
+	AnimationLod(AnimationLod&& src) = delete;
+	AnimationLod& operator=(const AnimationLod& rhs) = delete;
+	AnimationLod& operator=(AnimationLod&& rhs) = delete;
+
+public:
+	//* The levels are sorted from the most detailed one; the last level takes every screen size.
+	void SetLevel(std::uint32_t inLevel, const Game::AnimationLodLevel& inDesc);
+	const Game::AnimationLodLevel& GetLevel(std::uint32_t inLevel) const;
+
+	//* Ratio of the projected radius to the half height of the screen(1 fills the screen).
+	static float ComputeScreenSize(float inRadius, float inDistance, float inFovY);
+	std::uint32_t SelectLevel(float inScreenSize, std::uint32_t inCurrLevel) const;
+
+	//* Returns the stagger slot of a new character.
+	std::uint32_t Register();
+	//* Counts the character to the statistics of the frame and returns whether it is updated this frame.
+	//* A forced update(a clip change) is always taken.
+	bool ShouldUpdate(std::uint32_t inSlot, std::uint32_t inLevel, bool inForced = false);
+
+	//* Bone index -> the bone whose transform it takes in the CPU pose(itself if it isn't masked),
+	//*  or null if the level doesn't mask any bone.
+	//* Built once per skeleton and detail; the mask stays valid as long as this object.
+	const std::vector<std::uint32_t>* GetBoneMask(const Game::SkinnedData* inSkinnedData, std::uint32_t inLevel);
+	//* Masks the bones fewer than inMaskedLeafLevels links above their deepest leaf;
+	//*  a masked bone takes the transform of its nearest kept ancestor and the roots are always kept.
+	//* Returns the number of masked bones.
+	static std::uint32_t BuildBoneMask(const Game::Skeleton& inSkeleton, std::uint32_t inMaskedLeafLevels,
+		std::vector<std::uint32_t>& outRemap);
+
+	//* Publishes the statistics of the last frame and moves on to the next one.
+	void BeginFrame();
+
+	Game::AnimationLodStatistics GetStatistics() const;
+
+private:
+	Game::AnimationLodLevel mLevels[MaxLevels];
+
+	std::atomic<std::uint32_t> mNextSlot{ 0 };
+	std::uint32_t mFrame = 0;
+
+	std::mutex mMaskMutex;
+	// (Skinned data, masked leaf levels) -> remap.
+	std::map<std::pair<const Game::SkinnedData*, std::uint32_t>, std::unique_ptr<std::vector<std::uint32_t>>> mBoneMasks;
+
+	std::atomic<std::uint32_t> mNumUpdated{ 0 };
+	std::atomic<std::uint32_t> mNumSkipped{ 0 };
+	std::atomic<std::uint32_t> mNumPerLevel[MaxLevels];
+
+	Game::AnimationLodStatistics mStatistics;
+};
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace Game {
+	struct AnimationsAtlasRange;
+	struct AnimationsAtlasStatistics;
+	class AnimationsAtlas;
+}
+
+//* Lines [mBegin, mEnd).
+struct Game::AnimationsAtlasRange {
+public:
+	std::uint32_t mBegin = 0;
+	std::uint32_t mEnd = 0;
+};
+
+struct Game::AnimationsAtlasStatistics {
+public:
+	std::uint32_t mNumLines = 0;
+	std::uint32_t mNumUsedLines = 0;
+	std::uint32_t mNumAllocations = 0;
+	// The largest clip(in frames) that can still be added.
+	std::uint32_t mLargestFreeSpan = 0;
+	std::uint32_t mNumDirtyLines = 0;
+};
+
+//* Allocates the lines of the animations map.
+//* A clip takes one line per frame and the shaders address it by its first line,
+//*  so an allocation is a span of consecutive lines; the free spans are kept sorted and
+//*  merged with their neighbours when a clip is removed.
+//* The lines written since the last upload are tracked as sorted, merged dirty ranges.
+//* This class only does the bookkeeping and doesn't touch any device objects.
+class Game::AnimationsAtlas {
+public:
+	using Line = std::uint32_t;
+
+	static constexpr Line InvalidLine = 0xFFFFFFFF;
+
+public:
+	AnimationsAtlas() = default;
+	virtual ~AnimationsAtlas() = default;
+
+private:
+	AnimationsAtlas(const AnimationsAtlas& src) = delete;
+	AnimationsAtlas(AnimationsAtlas&& src) = delete;
+	AnimationsAtlas& operator=(const AnimationsAtlas& rhs) = delete;
+	AnimationsAtlas& operator=(AnimationsAtlas&& rhs) = delete;
+
+public:
+	//* Drops every allocation; all the lines are free and clean.
+	void Initialize(Line inNumLines);
+
+	//* Returns the first line of the span, or InvalidLine if no free span holds inNumLines lines.
+	//* The allocated lines are marked dirty.
+	Line Allocate(Line inNumLines);
+	//* Returns false if inFirstLine isn't the first line of an allocation.
+	bool Free(Line inFirstLine);
+
+	void MarkDirty(Line inBegin, Line inEnd);
+	const std::vector<AnimationsAtlasRange>& GetDirtyRanges() const;
+	void ClearDirty();
+
+	Line GetNumLines() const;
+	//* Number of lines of the allocation starting at inFirstLine(0 if there isn't any).
+	Line GetAllocationSize(Line inFirstLine) const;
+
+	AnimationsAtlasStatistics GetStatistics() const;
+
+private:
+	Line mNumLines = 0;
+	Line mNumUsedLines = 0;
+
+	// First line -> number of lines.
+	std::map<Line, Line> mAllocations;
+	// Sorted by line; adjacent spans are always merged.
+	std::vector<AnimationsAtlasRange> mFreeRanges;
+	std::vector<AnimationsAtlasRange> mDirtyRanges;
+};
\ No newline at end of file
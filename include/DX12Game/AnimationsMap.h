@@ -7,8 +7,13 @@
 #include <wrl.h>
 
 #include "common/d3dx12.h"
+#include "DX12Game/AnimationsAtlas.h"
 #include "DX12Game/GameResult.h"
 
+//* A clip is stored one frame per line of the texture, four texels per track;
+//*  its index is the first texel of its first line.
+//* No CPU copy of the texture is kept: the frames of a clip stay on the CPU only until
+//*  UpdateAnimationsMap records them into an upload buffer, and only their texels are copied.
 class AnimationsMap {
 public:
 	AnimationsMap() = default;
@@ -17,14 +22,21 @@ public:
 public:
 	GameResult Initialize(ID3D12Device* inDevice);
 
-	UINT AddAnimation(const std::string& inClipName, const DirectX::XMFLOAT4* inAnimCurves, 
-					  size_t inNumFrames, size_t inNumCurves);
+	//* Fails if a frame doesn't fit in a line or no free span holds inNumFrames lines.
+	GameResult AddAnimation(const std::string& inClipName, const DirectX::XMFLOAT4* inAnimCurves, 
+					  size_t inNumFrames, size_t inNumCurves, UINT& outClipIndex);
+	//* The lines of the clip are reused by the clips added later.
+	void RemoveAnimation(UINT inClipIndex);
 
 	void BuildDescriptors(
 		CD3DX12_CPU_DESCRIPTOR_HANDLE hCpuSrv,
 		CD3DX12_GPU_DESCRIPTOR_HANDLE hGpuSrv);
 
-	void UpdateAnimationsMap(ID3D12GraphicsCommandList* outCmdList);
+	bool HasPendingUploads() const;
+	//* Records the copies of the clips added since the last update; outUploadBuffer holds their frames
+	//*  and must live until the command list has executed(null if nothing was recorded).
+	GameResult UpdateAnimationsMap(ID3D12GraphicsCommandList* outCmdList,
+		Microsoft::WRL::ComPtr<ID3D12Resource>& outUploadBuffer);
 
 	ID3D12Resource* GetAnimationsMap() const;
 	CD3DX12_GPU_DESCRIPTOR_HANDLE GetAnimationsMapSrv() const;
@@ -32,6 +44,8 @@ public:
 	UINT GetLineSize() const;
 	double GetInvLineSize() const;
 
+	Game::AnimationsAtlasStatistics GetStatistics() const;
+
 private:
 	GameResult BuildResource();
 	void BuildDescriptors();
@@ -39,17 +53,25 @@ private:
 public:
 	static const DXGI_FORMAT AnimationsMapFormat = DXGI_FORMAT_R32G32B32A32_FLOAT;
 
+private:
+	struct PendingClip {
+		UINT mFirstLine;
+		UINT mNumLines;
+		// Texels per line(four per track).
+		UINT mFrameSize;
+		std::vector<DirectX::XMFLOAT4> mTexels;
+	};
+
 private:
 	ID3D12Device* md3dDevice;
 
 	Microsoft::WRL::ComPtr<ID3D12Resource> mAnimsMap;
-	Microsoft::WRL::ComPtr<ID3D12Resource> mAnimsMapUploadBuffer;
 
 	CD3DX12_CPU_DESCRIPTOR_HANDLE mhAnimsMapCpuSrv;
 	CD3DX12_GPU_DESCRIPTOR_HANDLE mhAnimsMapGpuSrv;
 
-	std::vector<DirectX::XMFLOAT4> mAnimations;
+	// Clips added since the last UpdateAnimationsMap.
+	std::vector<PendingClip> mPendingClips;
 
-	UINT mCurrIndex = 0;
-	UINT mNumSubresources;
+	Game::AnimationsAtlas mAtlas;
 };
\ No newline at end of file
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Game {
+	struct AssetRequest;
+	struct AssetLoaderStatistics;
+	class AssetLoader;
+}
+
+//* Describes how an asset is brought in.
+//* mLoad runs on a worker thread(file I/O and decoding) and reports how many bytes
+//*  the upload stage is going to push to the device.
+//* mUpload runs on the thread that calls AssetLoader::Pump, so it may touch device objects.
+struct Game::AssetRequest {
+public:
+	// Identifies the asset; concurrent requests with the same key share one load.
+	std::string mKey;
+	// Higher priorities are loaded and uploaded first.
+	int mPriority = 0;
+
+	std::function<bool(std::uint64_t& outUploadBytes)> mLoad;
+	std::function<bool()> mUpload;
+};
+
+struct Game::AssetLoaderStatistics {
+public:
+	std::uint32_t mNumQueued = 0;
+	std::uint32_t mNumLoading = 0;
+	std::uint32_t mNumReady = 0;
+	// Requests that joined a load already in flight instead of starting a new one.
+	std::uint64_t mNumDeduplicated = 0;
+	std::uint64_t mNumCompleted = 0;
+	std::uint64_t mNumFailed = 0;
+	std::uint64_t mUploadedBytes = 0;
+};
+
+//* Background asset pipeline.
+//* Requests are queued by priority and loaded by the worker threads,
+//*  then uploaded and reported on the owner thread by Pump within a per-call byte budget,
+//*  so a burst of finished assets is spread over several frames.
+//* This class doesn't depend on any device objects.
+class Game::AssetLoader {
+public:
+	using Callback = std::function<void(bool inSucceeded)>;
+
+public:
+	AssetLoader() = default;
+	virtual ~AssetLoader();
+
+private:
+	AssetLoader(const AssetLoader& src) = delete;
+	AssetLoader(AssetLoader&& src) = delete;
+	AssetLoader& operator=(const AssetLoader& rhs) = delete;
+	AssetLoader& operator=(AssetLoader&& rhs) = delete;
+
+public:
+	void Initialize(std::uint32_t inNumWorkers);
+	//* Stops the workers; the requests that haven't been uploaded are dropped without callbacks.
+	void CleanUp();
+
+	//* Queues the request, or attaches the callback to the load in flight for the same key.
+	//* A later request with a higher priority raises the priority of the pending load.
+	//* Returns false if the request joined a load in flight.
+	bool Request(const AssetRequest& inRequest, Callback inCallback);
+
+	//* Uploads the loaded assets in priority order and invokes their callbacks.
+	//* Stops once inUploadBudget bytes are uploaded; at least one asset is uploaded per call
+	//*  so that an asset larger than the budget still makes progress.
+	//* Returns the number of completed assets.
+	std::uint32_t Pump(std::uint64_t inUploadBudget);
+	//* Pumps without a budget until every request is completed.
+	void Flush();
+
+	bool IsIdle() const;
+	AssetLoaderStatistics GetStatistics() const;
+
+private:
+	enum EAssetState {
+		EQueued,
+		ELoading,
+		EReady
+	};
+
+	struct Entry {
+		AssetRequest mRequest;
+		std::vector<Callback> mCallbacks;
+		EAssetState mState = EQueued;
+		bool bLoaded = false;
+		std::uint64_t mUploadBytes = 0;
+	};
+
+	struct QueueNode {
+		int mPriority;
+		// Keeps the requests with the same priority in FIFO order.
+		std::uint64_t mSequence;
+		std::shared_ptr<Entry> mEntry;
+
+		friend bool operator<(const QueueNode& lhs, const QueueNode& rhs) {
+			if (lhs.mPriority != rhs.mPriority)
+				return lhs.mPriority < rhs.mPriority;
+			return lhs.mSequence > rhs.mSequence;
+		}
+	};
+
+	void WorkerFunc();
+
+	//* Pops the next node whose entry is still in the expected state.
+	//* Nodes left behind by priority raises are skipped.
+	static bool PopValid(std::priority_queue<QueueNode>& ioQueue, EAssetState inState, std::shared_ptr<Entry>& outEntry);
+
+private:
+	mutable std::mutex mMutex;
+	std::condition_variable mCondVar;
+	// Signaled whenever an entry becomes ready, for Flush.
+	std::condition_variable mReadyCondVar;
+
+	std::vector<std::thread> mWorkers;
+	bool bTerminated = false;
+
+	std::unordered_map<std::string, std::shared_ptr<Entry>> mEntries;
+	std::priority_queue<QueueNode> mLoadQueue;
+	std::priority_queue<QueueNode> mReadyQueue;
+
+	std::uint64_t mNextSequence = 0;
+
+	std::uint32_t mNumQueued = 0;
+	std::uint32_t mNumLoading = 0;
+	std::uint32_t mNumReady = 0;
+	std::uint64_t mNumDeduplicated = 0;
+	std::uint64_t mNumCompleted = 0;
+	std::uint64_t mNumFailed = 0;
+	std::uint64_t mUploadedBytes = 0;
+};
\ No newline at end of file
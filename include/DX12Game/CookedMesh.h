@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class MappedFile;
+
+namespace Game {
+	struct CookedMeshHeader;
+	struct CookedSection;
+	struct CookedString;
+	struct CookedSubset;
+	struct CookedMaterial;
+	struct CookedBone;
+	struct CookedClip;
+	struct CookedCurve;
+	struct CookedChannel;
+
+	template <typename T>
+	struct CookedSpan;
+
+	class CookedMeshWriter;
+	class CookedMeshView;
+}
+
+//* Cooked mesh container(.cmesh).
+//* The file is a header followed by a section table and the section payloads.
+//* Every payload starts on a SectionAlignment boundary, so the records can be read in place
+//*  from a memory-mapped file.
+//* Only fixed-size types are used so that the format doesn't depend on the FBX SDK or Direct3D.
+namespace Game {
+	namespace CookedMesh {
+		static constexpr std::uint32_t Magic = 0x48534D43; // 'CMSH'
+		static constexpr std::uint32_t Version = 3;
+		static constexpr std::uint32_t SectionAlignment = 16;
+
+		enum Flags : std::uint32_t {
+			ESkinned = 1 << 0
+		};
+
+		enum SectionType : std::uint32_t {
+			EVertices = 0,	// Vertex or SkinnedVertex(element size is the vertex stride)
+			EIndices,		// std::uint32_t
+			ESubsets,		// CookedSubset
+			EMaterials,		// CookedMaterial
+			EBones,			// CookedBone
+			EClips,			// CookedClip
+			ECurves,		// CookedCurve
+			EKeys,			// float[16], row-major 4x4 matrices referenced by the curves
+			EStrings,		// char, referenced by CookedString
+			EChannels,		// CookedChannel of the compressed clips
+			EKeyFrames,		// std::uint16_t, frame index of every key of the compressed clips
+			EKeyData,		// std::uint16_t, three words per key of the compressed clips
+			Count
+		};
+	}
+}
+
+struct Game::CookedMeshHeader {
+	std::uint32_t mMagic;
+	std::uint32_t mVersion;
+	std::uint32_t mFlags;
+	std::uint32_t mNumSections;
+	std::uint64_t mFileSize;
+	// Import cache key the container was cooked from(see ImportCache::ComputeKey).
+	std::uint64_t mSourceKey;
+};
+
+struct Game::CookedSection {
+	std::uint32_t mType;
+	std::uint32_t mElementSize;
+	std::uint64_t mOffset;
+	std::uint64_t mCount;
+	std::uint64_t mPad0;
+};
+
+struct Game::CookedString {
+	std::uint32_t mOffset;
+	std::uint32_t mLength;
+};
+
+struct Game::CookedSubset {
+	std::uint32_t mIndexCount;
+	std::uint32_t mStartIndex;
+	// Draw argument(geometry name) of the subset.
+	CookedString mName;
+};
+
+struct Game::CookedMaterial {
+	// Geometry name the material is bound to.
+	CookedString mGeometryName;
+	CookedString mMaterialName;
+	CookedString mDiffuseMapFileName;
+	CookedString mNormalMapFileName;
+	CookedString mSpecularMapFileName;
+	CookedString mAlphaMapFileName;
+	float mMatTransform[16];
+	float mDiffuseAlbedo[4];
+	float mFresnelR0[3];
+	float mRoughness;
+};
+
+struct Game::CookedBone {
+	CookedString mName;
+	std::int32_t mParentIndex;
+	std::uint32_t mPad0;
+	float mLocalBindPose[16];
+	float mGlobalBindPose[16];
+	float mGlobalInvBindPose[16];
+};
+
+struct Game::CookedClip {
+	CookedString mName;
+	std::uint32_t mNumFrames;
+	float mDuration;
+	float mFrameDuration;
+	// Raw curves of the clip are stored contiguously, one per bone(none if the clip is compressed).
+	std::uint32_t mFirstCurve;
+	std::uint32_t mNumCurves;
+	// Channels of a compressed clip(three per bone, see CompressedAnimation) and the keys they index.
+	std::uint32_t mFirstChannel;
+	std::uint32_t mNumChannels;
+	std::uint32_t mFirstKey;
+	std::uint32_t mNumKeys;
+	// Error measured when the clip was compressed.
+	float mMaxError;
+};
+
+struct Game::CookedCurve {
+	std::uint32_t mFirstKey;
+	std::uint32_t mNumKeys;
+};
+
+struct Game::CookedChannel {
+	// CompressedAnimation::EChannelMode.
+	std::uint32_t mMode;
+	// Keys of an animated channel, relative to the first key of the clip.
+	std::uint32_t mFirstKey;
+	std::uint32_t mNumKeys;
+	float mMin[4];
+	float mStep[4];
+};
+
+template <typename T>
+struct Game::CookedSpan {
+public:
+	const T* mData = nullptr;
+	size_t mSize = 0;
+
+public:
+	const T* begin() const;
+	const T* end() const;
+
+	const T& operator[](size_t inIndex) const;
+
+	bool Empty() const;
+};
+
+//* Collects the sections in memory and writes them out as one aligned container.
+class Game::CookedMeshWriter {
+public:
+	CookedMeshWriter() = default;
+	virtual ~CookedMeshWriter() = default;
+
+private:
+	CookedMeshWriter(const CookedMeshWriter& src) = delete;
+	CookedMeshWriter(CookedMeshWriter&& src) = delete;
+	CookedMeshWriter& operator=(const CookedMeshWriter& rhs) = delete;
+	CookedMeshWriter& operator=(CookedMeshWriter&& rhs) = delete;
+
+public:
+	void SetFlags(std::uint32_t inFlags);
+	void SetSourceKey(std::uint64_t inKey);
+
+	//* Copies inCount elements of inElementSize bytes as the payload of the section.
+	//* Adding the same section type twice replaces the previous payload.
+	void AddSection(CookedMesh::SectionType inType, std::uint32_t inElementSize, const void* inData, size_t inCount);
+	template <typename T>
+	void AddSection(CookedMesh::SectionType inType, const std::vector<T>& inData);
+
+	//* Appends the string to the string table(EStrings section).
+	CookedString AddString(const std::string& inString);
+
+	//* Returns false if the file can't be written.
+	bool Write(const std::string& inFileName) const;
+
+private:
+	struct PendingSection {
+		std::uint32_t mElementSize = 0;
+		size_t mCount = 0;
+		std::vector<std::uint8_t> mData;
+		bool bUsed = false;
+	};
+
+	std::uint32_t mFlags = 0;
+	std::uint64_t mSourceKey = 0;
+	PendingSection mSections[CookedMesh::SectionType::Count];
+
+	std::vector<char> mStrings;
+};
+
+//* Validates a cooked container and exposes its sections in place.
+//* The view doesn't own the memory; the mapped file must outlive it.
+class Game::CookedMeshView {
+public:
+	CookedMeshView() = default;
+	virtual ~CookedMeshView() = default;
+
+public:
+	//* Returns false if the container is truncated, has a different version
+	//*  or any section is out of bounds or misaligned.
+	bool Open(const MappedFile& inFile);
+	bool Open(const void* inData, std::uint64_t inSize);
+
+	std::uint32_t GetFlags() const;
+	std::uint64_t GetSourceKey() const;
+
+	bool HasSection(CookedMesh::SectionType inType) const;
+	std::uint32_t GetElementSize(CookedMesh::SectionType inType) const;
+
+	//* Returns an empty span if the section doesn't exist or its element size isn't sizeof(T).
+	template <typename T>
+	CookedSpan<T> GetSection(CookedMesh::SectionType inType) const;
+
+	std::string GetString(const CookedString& inString) const;
+
+private:
+	const std::uint8_t* mData = nullptr;
+	std::uint64_t mSize = 0;
+
+	std::uint32_t mFlags = 0;
+	std::uint64_t mSourceKey = 0;
+	const CookedSection* mSections[CookedMesh::SectionType::Count] = {};
+};
+
+#include "DX12Game/CookedMesh.inl"
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef __COOKEDMESH_INL__
+#define __COOKEDMESH_INL__
+
+template <typename T>
+const T* Game::CookedSpan<T>::begin() const {
+	return mData;
+}
+
+template <typename T>
+const T* Game::CookedSpan<T>::end() const {
+	return mData + mSize;
+}
+
+template <typename T>
+const T& Game::CookedSpan<T>::operator[](size_t inIndex) const {
+	return mData[inIndex];
+}
+
+template <typename T>
+bool Game::CookedSpan<T>::Empty() const {
+	return mSize == 0;
+}
+
+template <typename T>
+void Game::CookedMeshWriter::AddSection(CookedMesh::SectionType inType, const std::vector<T>& inData) {
+	AddSection(inType, static_cast<std::uint32_t>(sizeof(T)), inData.data(), inData.size());
+}
+
+template <typename T>
+Game::CookedSpan<T> Game::CookedMeshView::GetSection(CookedMesh::SectionType inType) const {
+	CookedSpan<T> span;
+
+	const CookedSection* section = mSections[inType];
+	if (section == nullptr || section->mElementSize != sizeof(T))
+		return span;
+
+	span.mData = reinterpret_cast<const T*>(mData + section->mOffset);
+	span.mSize = static_cast<size_t>(section->mCount);
+
+	return span;
+}
+
+#endif // __COOKEDMESH_INL__
\ No newline at end of file
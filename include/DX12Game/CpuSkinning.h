@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace Game {
+	struct SkinnedVertex;
+
+	struct SkinningJob;
+	struct SkinningResult;
+	class CpuSkinning;
+}
+
+struct Game::SkinningJob {
+public:
+	enum EMethod {
+		// Blends the skinning matrices like the skinning shaders.
+		ELinearBlend,
+		// Blends the rigid parts of the skinning matrices as dual quaternions, so twisted joints keep their volume;
+		//  the scale of the matrices is ignored.
+		EDualQuaternion
+	};
+
+public:
+	EMethod mMethod = ELinearBlend;
+
+	const Game::SkinnedVertex* mVertices = nullptr;
+	size_t mNumVertices = 0;
+
+	// Skinning matrices indexed by bone(PoseJob::mSkinningPalette).
+	const DirectX::XMFLOAT4X4* mSkinningPalette = nullptr;
+	size_t mPaletteSize = 0;
+
+	// Two per bone(CpuSkinning::BuildDualQuaternions) for EDualQuaternion; Skin builds them if null.
+	const DirectX::XMFLOAT4* mDualQuaternions = nullptr;
+
+	// One per vertex; the normals and the tangents may be null and are returned normalized.
+	DirectX::XMFLOAT3* mPositions = nullptr;
+	DirectX::XMFLOAT3* mNormals = nullptr;
+	DirectX::XMFLOAT3* mTangents = nullptr;
+};
+
+struct Game::SkinningResult {
+public:
+	// Mesh-space bounds of the deformed positions.
+	DirectX::XMFLOAT3 mBoundsMin = { 0.0f, 0.0f, 0.0f };
+	DirectX::XMFLOAT3 mBoundsMax = { 0.0f, 0.0f, 0.0f };
+
+	// Milliseconds the job took and the throughput it had.
+	float mTime = 0.0f;
+	float mVerticesPerSecond = 0.0f;
+};
+
+//* Deforms skinned vertices on the CPU the way the skinning shaders do, so gameplay code can query
+//*  the deformed mesh(picking, bounds, attachments) and the output of a mesh can be checked without a device.
+//* The vertices are skinned in chunks as parallel jobs with DirectXMath(SSE) vectors;
+//*  an influence with the bone index -1 ends the influences of a vertex, like in the shaders.
+class Game::CpuSkinning {
+public:
+	// Vertices per parallel job.
+	static const size_t ChunkSize = 2048;
+
+public:
+	CpuSkinning() = default;
+	virtual ~CpuSkinning() = default;
+
+public:
+	//* Skins the vertices as parallel jobs.
+	static SkinningResult Skin(const SkinningJob& inJob);
+	//* Skins the vertices [inBegin, inEnd) on the calling thread and grows the bounds by them.
+	static void SkinRange(const SkinningJob& inJob, size_t inBegin, size_t inEnd,
+		DirectX::XMVECTOR& ioBoundsMin, DirectX::XMVECTOR& ioBoundsMax);
+
+	//* Converts the palette to unit dual quaternions(real part, dual part per bone) for EDualQuaternion.
+	static void BuildDualQuaternions(const DirectX::XMFLOAT4X4* inSkinningPalette, size_t inPaletteSize,
+		DirectX::XMFLOAT4* outDualQuaternions);
+};
\ No newline at end of file
@@ -17,6 +17,7 @@
 #include "common/d3dx12.h"
 #include "common/MathHelper.h"
 #include "common/DDSTextureLoader.h"
+#include "DX12Game/DdsFile.h"
 #include "DX12Game/GameResult.h"
 
 extern const int gNumFrameResources;
@@ -35,6 +36,10 @@ struct SubmeshGeometry {
 	DirectX::BoundingBox AABB;
 	DirectX::BoundingOrientedBox OBB;
 	DirectX::BoundingSphere Sphere;
+
+	// Square root of the UV area per unit of the local surface area, used to estimate
+	//  the mip levels of the textures to stream.
+	float UVDensity = 0.0f;
 };
 
 struct MeshGeometry {
@@ -52,11 +57,19 @@ struct MeshGeometry {
 	Microsoft::WRL::ComPtr<ID3D12Resource> VertexBufferUploader = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12Resource> IndexBufferUploader = nullptr;
 
+	// Quantized skin stream(Game::QuantizedSkin) bound to the second input slot of the compact skinned layouts.
+	Microsoft::WRL::ComPtr<ID3D12Resource> SkinBufferGPU = nullptr;
+	Microsoft::WRL::ComPtr<ID3D12Resource> SkinBufferUploader = nullptr;
+
 	// Data about the buffers.
 	UINT VertexByteStride = 0;
 	UINT VertexBufferByteSize = 0;
 	DXGI_FORMAT IndexFormat = DXGI_FORMAT_R16_UINT;
 	UINT IndexBufferByteSize = 0;
+	UINT SkinByteStride = 0;
+	UINT SkinBufferByteSize = 0;
+	// Bits per bone index of the skin stream(8 or 16), or 0 if the geometry has none.
+	UINT SkinIndexBits = 0;
 
 	// A MeshGeometry may store multiple geometries in one vertex/index buffer.
 	// Use this container to define the Submesh geometries so we can draw
@@ -72,6 +85,15 @@ struct MeshGeometry {
 		return vbv;
 	}
 
+	D3D12_VERTEX_BUFFER_VIEW SkinBufferView() const {
+		D3D12_VERTEX_BUFFER_VIEW vbv;
+		vbv.BufferLocation = SkinBufferGPU->GetGPUVirtualAddress();
+		vbv.StrideInBytes = SkinByteStride;
+		vbv.SizeInBytes = SkinBufferByteSize;
+
+		return vbv;
+	}
+
 	D3D12_INDEX_BUFFER_VIEW IndexBufferView() const {
 		D3D12_INDEX_BUFFER_VIEW ibv;
 		ibv.BufferLocation = IndexBufferGPU->GetGPUVirtualAddress();
@@ -85,6 +107,7 @@ struct MeshGeometry {
 	void DisposeUploaders() {
 		VertexBufferUploader = nullptr;
 		IndexBufferUploader = nullptr;
+		SkinBufferUploader = nullptr;
 	}
 };
 
@@ -259,6 +282,40 @@ public:
 		Microsoft::WRL::ComPtr<ID3D12Resource>& outUploadBuffer,
 		Microsoft::WRL::ComPtr<ID3D12Resource>& outDefaultBuffer);
 
+	//* Creates a texture holding inNumMips levels of the DDS file starting at inFirstMip.
+	//* The pixels are copied from the file mapping straight into the upload heap.
+	static GameResult CreateTextureFromDds(
+		ID3D12Device* inDevice,
+		ID3D12GraphicsCommandList* inCmdList,
+		const Game::DdsFile& inFile,
+		UINT inFirstMip,
+		UINT inNumMips,
+		Microsoft::WRL::ComPtr<ID3D12Resource>& outTexture,
+		Microsoft::WRL::ComPtr<ID3D12Resource>& outUploadHeap);
+	//* Creates a texture holding the levels of the DDS file from inFirstMip to the last one.
+	//* The levels inSrcTexture(holding the levels from inSrcFirstMip) already has are copied on the GPU;
+	//*  only the finer levels are uploaded from the file, so outUploadHeap is null when the residency is lowered.
+	//* inSrcTexture must be in the pixel shader resource state.
+	static GameResult RecreateTextureFromDds(
+		ID3D12Device* inDevice,
+		ID3D12GraphicsCommandList* inCmdList,
+		const Game::DdsFile& inFile,
+		UINT inFirstMip,
+		UINT inNumMips,
+		ID3D12Resource* inSrcTexture,
+		UINT inSrcFirstMip,
+		Microsoft::WRL::ComPtr<ID3D12Resource>& outTexture,
+		Microsoft::WRL::ComPtr<ID3D12Resource>& outUploadHeap);
+
+	//* Loads a DDS file, skipping the mip levels larger than inMaxSize(0 loads all of them).
+	static GameResult LoadDdsTexture(
+		ID3D12Device* inDevice,
+		ID3D12GraphicsCommandList* inCmdList,
+		const std::wstring& inFileName,
+		Microsoft::WRL::ComPtr<ID3D12Resource>& outTexture,
+		Microsoft::WRL::ComPtr<ID3D12Resource>& outUploadHeap,
+		UINT inMaxSize = 0);
+
 	static GameResult CompileShader(
 		const std::wstring& inFilename,
 		const D3D_SHADER_MACRO* inDefines,
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "common/MappedFile.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Game {
+	struct DdsTextureDesc;
+	struct DdsSubresource;
+	class DdsFile;
+}
+
+namespace Game {
+	namespace Dds {
+		// Same values as D3D12_RESOURCE_DIMENSION.
+		enum Dimension : std::uint32_t {
+			EUnknown	= 0,
+			ETexture1D	= 2,
+			ETexture2D	= 3,
+			ETexture3D	= 4
+		};
+
+		// Bounds of the D3D12 hardware requirements; larger metadata is rejected as untrusted.
+		static constexpr std::uint32_t MaxMipLevels = 15;
+		static constexpr std::uint32_t MaxTexture1DDimension = 16384;
+		static constexpr std::uint32_t MaxTexture2DDimension = 16384;
+		static constexpr std::uint32_t MaxTexture3DDimension = 2048;
+		static constexpr std::uint32_t MaxArraySize = 2048;
+	}
+}
+
+struct Game::DdsTextureDesc {
+public:
+	Dds::Dimension mDimension = Dds::EUnknown;
+	// DXGI_FORMAT value.
+	std::uint32_t mFormat = 0;
+
+	std::uint32_t mWidth = 0;
+	std::uint32_t mHeight = 0;
+	std::uint32_t mDepth = 0;
+	// Number of array slices; a cube map counts its six faces.
+	std::uint32_t mArraySize = 0;
+	std::uint32_t mMipCount = 0;
+
+	bool bCubeMap = false;
+};
+
+//* One mip level of one array slice, pointing into the source bytes.
+//* A volume mip holds mDepth slices of mSlicePitch bytes.
+struct Game::DdsSubresource {
+public:
+	const std::uint8_t* mData = nullptr;
+	std::uint64_t mRowPitch = 0;
+	std::uint64_t mSlicePitch = 0;
+
+	std::uint32_t mWidth = 0;
+	std::uint32_t mHeight = 0;
+	std::uint32_t mDepth = 0;
+};
+
+//* DDS container reader that works in place.
+//* Open memory-maps the file; Parse validates the header(including the DX10 extension)
+//*  and the layout of every subresource against the size of the data,
+//*  so the returned subresources never point outside of it.
+//* No pixel data is copied and this class doesn't depend on any device objects.
+class Game::DdsFile {
+public:
+	DdsFile() = default;
+	virtual ~DdsFile() = default;
+
+private:
+	DdsFile(const DdsFile& src) = delete;
+	DdsFile(DdsFile&& src) = delete;
+	DdsFile& operator=(const DdsFile& rhs) = delete;
+	DdsFile& operator=(DdsFile&& rhs) = delete;
+
+public:
+	bool Open(const std::string& inFileName);
+	//* Parses a DDS image held by the caller; the memory must outlive this object.
+	bool Parse(const void* inData, std::uint64_t inSize);
+	void Close();
+
+	bool IsValid() const;
+	const DdsTextureDesc& GetDesc() const;
+
+	//* Returns the subresource of the mip level in the array slice.
+	const DdsSubresource& GetSubresource(std::uint32_t inArraySlice, std::uint32_t inMip) const;
+	//* Collects inNumMips levels starting at inFirstMip for every array slice,
+	//*  in the D3D12 subresource order(slice-major).
+	//* Returns false if the range is out of bounds.
+	bool GetSubresources(std::uint32_t inFirstMip, std::uint32_t inNumMips, std::vector<DdsSubresource>& outSubresources) const;
+
+	//* Returns the first mip level whose dimensions are all within inMaxSize(0 means no limit).
+	//* The last level is returned if none of them fits.
+	std::uint32_t GetFirstMipWithin(std::uint32_t inMaxSize) const;
+	//* Number of bytes of inNumMips levels starting at inFirstMip over all array slices.
+	std::uint64_t GetByteSize(std::uint32_t inFirstMip, std::uint32_t inNumMips) const;
+
+	//* Returns 0 for the formats that can't be stored in a DDS file.
+	static std::uint32_t BitsPerPixel(std::uint32_t inFormat);
+	//* Computes the pitches of a surface; returns false for unknown formats.
+	static bool GetSurfaceInfo(std::uint32_t inWidth, std::uint32_t inHeight, std::uint32_t inFormat,
+		std::uint64_t& outRowPitch, std::uint64_t& outSlicePitch);
+
+private:
+	bool ParseHeader(const std::uint8_t* inData, std::uint64_t inSize, std::uint64_t& outBitOffset);
+	bool BuildSubresources(const std::uint8_t* inBits, std::uint64_t inBitSize);
+
+private:
+	MappedFile mFile;
+
+	DdsTextureDesc mDesc;
+	// mArraySize * mMipCount entries, slice-major.
+	std::vector<DdsSubresource> mSubresources;
+};
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Game {
+	struct DirtyRange;
+	class DirtyRangeTracker;
+}
+
+struct Game::DirtyRange {
+public:
+	std::uint32_t mBegin;
+	// One past the last dirty element.
+	std::uint32_t mEnd;
+};
+
+//* Records which elements of a linear buffer have been modified since the last flush, and
+//*  merges them into as few contiguous ranges as possible so that they can be copied in large blocks.
+//* The tracker only stores indices; the copy itself is done by the callback passed to Flush,
+//*  so it doesn't depend on any device objects and works on plain memory as well.
+//* A tracker is not thread-safe; use one tracker per thread and per destination buffer.
+class Game::DirtyRangeTracker {
+public:
+	DirtyRangeTracker() = default;
+	virtual ~DirtyRangeTracker() = default;
+
+public:
+	void MarkDirty(std::uint32_t inIndex);
+	void MarkDirty(std::uint32_t inBegin, std::uint32_t inCount);
+
+	//* Sorts the recorded ranges and merges the ones that overlap, touch, or are
+	//*  separated by at most inMaxGap clean elements.
+	void Coalesce(std::uint32_t inMaxGap = 0);
+
+	//* Coalesces the recorded ranges, calls inCopyFunc(begin, count) once for each of them and clears the tracker.
+	//* Returns the number of elements passed to inCopyFunc.
+	template <typename CopyFunc>
+	std::uint32_t Flush(CopyFunc&& inCopyFunc, std::uint32_t inMaxGap = 0);
+
+	void Clear();
+
+	const std::vector<DirtyRange>& GetRanges() const;
+	//* Number of MarkDirty calls since the last flush.
+	std::uint32_t GetNumMarked() const;
+
+private:
+	std::vector<DirtyRange> mRanges;
+	std::uint32_t mNumMarked = 0;
+	bool bSorted = true;
+};
+
+#include "DX12Game/DirtyRangeTracker.inl"
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef __DIRTYRANGETRACKER_INL__
+#define __DIRTYRANGETRACKER_INL__
+
+template <typename CopyFunc>
+std::uint32_t Game::DirtyRangeTracker::Flush(CopyFunc&& inCopyFunc, std::uint32_t inMaxGap) {
+	Coalesce(inMaxGap);
+
+	std::uint32_t numCopied = 0;
+
+	for (const auto& range : mRanges) {
+		std::uint32_t count = range.mEnd - range.mBegin;
+
+		inCopyFunc(range.mBegin, count);
+		numCopied += count;
+	}
+
+	Clear();
+
+	return numCopied;
+}
+
+#endif // __DIRTYRANGETRACKER_INL__
\ No newline at end of file
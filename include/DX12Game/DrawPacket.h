@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Game {
+	class DrawSortKey;
+	struct DrawPacket;
+	class DrawPacketSorter;
+	struct DrawStateStatistics;
+	class DrawStateCache;
+}
+
+//* Builds 64-bit keys whose order is the order the draws should be recorded in.
+//* Layout(from the most significant bit):
+//*  pass(4) | pipeline(8) | geometry(16) | material(12) | depth(24)
+//* so the most expensive state changes are grouped first and depth only orders draws sharing all the states.
+class Game::DrawSortKey {
+public:
+	static constexpr std::uint32_t PassBits		= 4;
+	static constexpr std::uint32_t PipelineBits = 8;
+	static constexpr std::uint32_t GeometryBits = 16;
+	static constexpr std::uint32_t MaterialBits = 12;
+	static constexpr std::uint32_t DepthBits	= 24;
+
+	static constexpr std::uint32_t DepthShift		= 0;
+	static constexpr std::uint32_t MaterialShift	= DepthShift + DepthBits;
+	static constexpr std::uint32_t GeometryShift	= MaterialShift + MaterialBits;
+	static constexpr std::uint32_t PipelineShift	= GeometryShift + GeometryBits;
+	static constexpr std::uint32_t PassShift		= PipelineShift + PipelineBits;
+
+public:
+	//* inDepth is the normalized view depth([0, 1]).
+	//* Opaque draws are ordered front-to-back, blended draws(inBackToFront) back-to-front.
+	static std::uint64_t Build(std::uint32_t inPass, std::uint32_t inPipeline, std::uint32_t inGeometry,
+		std::uint32_t inMaterial, float inDepth, bool inBackToFront = false);
+
+	static std::uint32_t GetPass(std::uint64_t inKey);
+	static std::uint32_t GetPipeline(std::uint64_t inKey);
+	static std::uint32_t GetGeometry(std::uint64_t inKey);
+	static std::uint32_t GetMaterial(std::uint64_t inKey);
+};
+
+struct Game::DrawPacket {
+public:
+	std::uint64_t mKey;
+	// Index of the draw in the list the packets are built from.
+	std::uint32_t mIndex;
+};
+
+//* Sorts draw packets by their keys with a stable LSD radix sort(8 bits per pass).
+//* Every thread calls Sort with its own index; the threads meet at inSync between the passes.
+//* Digits that are the same for all the keys are skipped, so the cost depends on how many fields actually vary.
+class Game::DrawPacketSorter {
+public:
+	static constexpr std::uint32_t RadixBits = 8;
+	static constexpr std::uint32_t RadixSize = 1 << RadixBits;
+	// Lists shorter than this are sorted by the first thread alone.
+	static constexpr std::uint32_t DefaultParallelThreshold = 1024;
+
+public:
+	DrawPacketSorter() = default;
+	virtual ~DrawPacketSorter() = default;
+
+private:
+	DrawPacketSorter(const DrawPacketSorter& src) = delete;
+	DrawPacketSorter(DrawPacketSorter&& src) = delete;
+	DrawPacketSorter& operator=(const DrawPacketSorter& rhs) = delete;
+	DrawPacketSorter& operator=(DrawPacketSorter&& rhs) = delete;
+
+public:
+	void Initialize(std::uint32_t inNumThreads, std::uint32_t inParallelThreshold = DefaultParallelThreshold);
+
+	//* inSync must block until all the threads reach it and return true if the work was terminated.
+	//* Returns true if inSync reported termination.
+	template <typename SyncFunc>
+	bool Sort(std::vector<DrawPacket>& ioPackets, std::uint32_t inTid, SyncFunc&& inSync);
+
+	//* Single-threaded version.
+	void Sort(std::vector<DrawPacket>& ioPackets);
+
+private:
+	void GetChunk(std::uint32_t inNumPackets, std::uint32_t inTid, std::uint32_t& outBegin, std::uint32_t& outEnd) const;
+	std::uint64_t ComputeDiffMask(const DrawPacket* inPackets, std::uint32_t inBegin, std::uint32_t inEnd) const;
+	void CountDigits(const DrawPacket* inPackets, std::uint32_t inBegin, std::uint32_t inEnd, std::uint32_t inShift, std::uint32_t inTid);
+	void Scatter(const DrawPacket* inSrc, DrawPacket* outDst, std::uint32_t inBegin, std::uint32_t inEnd, std::uint32_t inShift, std::uint32_t inTid) const;
+
+private:
+	std::uint32_t mNumThreads = 1;
+	std::uint32_t mParallelThreshold = DefaultParallelThreshold;
+
+	std::vector<DrawPacket> mScratch;
+	std::vector<std::array<std::uint32_t, RadixSize>> mHistograms;
+	std::vector<std::uint64_t> mDiffMasks;
+};
+
+struct Game::DrawStateStatistics {
+public:
+	std::uint32_t mNumDraws = 0;
+	std::uint32_t mNumPipelineChanges = 0;
+	std::uint32_t mNumGeometryChanges = 0;
+	std::uint32_t mNumTopologyChanges = 0;
+	std::uint32_t mNumObjectCBChanges = 0;
+	// Binds filtered out because the state was already set.
+	std::uint32_t mNumSkippedBinds = 0;
+};
+
+//* Remembers the last bound states of a command list so that redundant binds can be skipped.
+//* Each Change function returns true if the state differs and must be bound.
+class Game::DrawStateCache {
+public:
+	DrawStateCache() = default;
+	virtual ~DrawStateCache() = default;
+
+public:
+	//* Forgets all the states(e.g. after the command list is reset).
+	void Reset();
+	void ResetStatistics();
+
+	bool ChangePipeline(const void* inPipeline);
+	bool ChangeGeometry(const void* inGeometry);
+	bool ChangeTopology(std::uint32_t inTopology);
+	bool ChangeObjectCB(std::uint64_t inAddress);
+	void CountDraw();
+
+	const DrawStateStatistics& GetStatistics() const;
+
+private:
+	const void* mPipeline = nullptr;
+	const void* mGeometry = nullptr;
+	std::uint32_t mTopology = 0xFFFFFFFF;
+	std::uint64_t mObjectCB = 0xFFFFFFFFFFFFFFFF;
+
+	DrawStateStatistics mStatistics;
+};
+
+#include "DX12Game/DrawPacket.inl"
\ No newline at end of file
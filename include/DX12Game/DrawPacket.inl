@@ -0,0 +1,60 @@
+#ifndef __DRAWPACKET_INL__
+#define __DRAWPACKET_INL__
+
+template <typename SyncFunc>
+bool Game::DrawPacketSorter::Sort(std::vector<DrawPacket>& ioPackets, std::uint32_t inTid, SyncFunc&& inSync) {
+	std::uint32_t numPackets = static_cast<std::uint32_t>(ioPackets.size());
+
+	// Small lists are not worth the extra synchronization.
+	if (mNumThreads == 1 || numPackets < mParallelThreshold) {
+		if (inTid == 0)
+			Sort(ioPackets);
+
+		return inSync();
+	}
+
+	if (inTid == 0 && mScratch.size() < numPackets)
+		mScratch.resize(numPackets);
+
+	std::uint32_t begin, end;
+	GetChunk(numPackets, inTid, begin, end);
+
+	mDiffMasks[inTid] = ComputeDiffMask(ioPackets.data(), begin, end);
+
+	if (inSync())
+		return true;
+
+	std::uint64_t diffMask = 0;
+	for (auto mask : mDiffMasks)
+		diffMask |= mask;
+
+	DrawPacket* src = ioPackets.data();
+	DrawPacket* dst = mScratch.data();
+
+	for (std::uint32_t shift = 0; shift < 64; shift += RadixBits) {
+		if (((diffMask >> shift) & (RadixSize - 1)) == 0)
+			continue;
+
+		CountDigits(src, begin, end, shift, inTid);
+
+		if (inSync())
+			return true;
+
+		Scatter(src, dst, begin, end, shift, inTid);
+
+		if (inSync())
+			return true;
+
+		std::swap(src, dst);
+	}
+
+	// An odd number of passes leaves the result in the scratch buffer.
+	if (src != ioPackets.data()) {
+		for (std::uint32_t i = begin; i < end; ++i)
+			ioPackets[i] = src[i];
+	}
+
+	return inSync();
+}
+
+#endif // __DRAWPACKET_INL__
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Game {
+	class DrawPartitioner;
+}
+
+//* Splits an ordered draw list into contiguous parts, one per recording thread, of about the same estimated cost.
+//* The parts stay contiguous so that the state sorting of the list is kept inside each command list.
+class Game::DrawPartitioner {
+public:
+	// Estimated recording cost of a draw call and of a state change, in units of one drawn index.
+	static constexpr std::uint64_t DefaultDrawCost = 4096;
+	static constexpr std::uint64_t DefaultStateChangeCost = 8192;
+
+public:
+	DrawPartitioner() = default;
+	virtual ~DrawPartitioner() = default;
+
+public:
+	static std::uint64_t EstimateCost(std::uint32_t inIndexCount, std::uint32_t inInstanceCount, std::uint32_t inNumStateChanges,
+		std::uint64_t inDrawCost = DefaultDrawCost, std::uint64_t inStateChangeCost = DefaultStateChangeCost);
+
+	//* Fills outBounds with inNumParts + 1 indices; part i is [outBounds[i], outBounds[i + 1]).
+	//* Each boundary is placed where the prefix sum of the costs is closest to the ideal share.
+	static void Partition(const std::vector<std::uint64_t>& inCosts, std::uint32_t inNumParts, std::vector<std::uint32_t>& outBounds);
+};
\ No newline at end of file
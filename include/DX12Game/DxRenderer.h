@@ -14,6 +14,10 @@
 #include "DX12Game/ShaderManager.h"
 #include "DX12Game/AnimationsMap.h"
 #include "DX12Game/FrameResource.h"
+#include "DX12Game/InstanceAllocator.h"
+#include "DX12Game/TextureResidency.h"
+#include "DX12Game/DrawPacket.h"
+#include "DX12Game/DrawPartitioner.h"
 #include "DX12Game/GameCamera.h"
 #include "DX12Game/DxLowRenderer.h"
 #include "DX12Game/RootSignatureManager.h"
@@ -77,6 +81,8 @@ private:
 		} mBoundingUnion;
 
 		std::vector<Game::InstanceData> mInstances;
+		// Range of the instance buffers reserved for this render item.
+		Game::InstanceAllocator::Handle mInstanceRange = Game::InstanceAllocator::InvalidHandle;
 
 		// DrawIndexedInstanced parameters.
 		UINT mIndexCount = 0;
@@ -84,6 +90,11 @@ private:
 		UINT mBaseVertexLocation = 0;
 
 		UINT mNumInstancesToDraw = 0;
+		// View depth of the nearest visible instance, used to order the draws.
+		float mSortDepth = 0.0f;
+
+		// See SubmeshGeometry::UVDensity.
+		float mUVDensity = 0.0f;
 
 	public:
 		RenderItem() = default;
@@ -95,6 +106,46 @@ private:
 		RenderItem& operator=(RenderItem&& rhs) = delete;
 	};
 
+	struct StreamedTexture {
+		std::unique_ptr<Game::DdsFile> mFile;
+		Texture* mTexture = nullptr;
+		// First level of the file the texture resource holds.
+		UINT mFirstMip = 0;
+		// Descriptors viewing the texture; a replaced resource is viewed by new ones,
+		//  since the frames in flight still read the old ones.
+		std::vector<UINT> mDescriptorIndices;
+
+		// Resource with the new resident levels; it replaces the texture once the upload batch filling it is done.
+		Microsoft::WRL::ComPtr<ID3D12Resource> mPendingResource;
+		UINT mPendingFirstMip = 0;
+		// Fence of the upload batch filling the pending resource(0 until the batch is submitted).
+		UINT64 mPendingFence = 0;
+	};
+
+	// Command allocator of the uploads submitted with a frame.
+	struct UploadBatch {
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> mCmdListAlloc;
+		UINT64 mFence = 0;
+	};
+
+	// Resource kept alive until the GPU has passed the fence.
+	struct RetiredResource {
+		Microsoft::WRL::ComPtr<ID3D12Resource> mResource;
+		UINT64 mFence;
+	};
+
+	// Descriptor of the texture table that isn't rewritten until the GPU has passed the fence.
+	struct RetiredDescriptor {
+		UINT mIndex;
+		UINT64 mFence;
+	};
+
+	struct DrawPacketSource {
+		RenderItem* mRitem;
+		RenderLayers mLayer;
+		UINT mGeometryId;
+	};
+
 	struct DescriptorHeapIndices {
 		UINT mCubeMapIndex;
 		UINT mBlurCubeMapIndex;
@@ -173,6 +224,10 @@ public:
 		const DirectX::XMMATRIX& inTransform, bool inIsSkeletal = false) override;
 	virtual void UpdateInstanceAnimationData(const std::string& inRenderItemName,
 		UINT inAnimClipIdx, float inTimePos, bool inIsSkeletal = false) override;
+	virtual void UpdateInstanceAnimationBlend(const std::string& inRenderItemName,
+		const Game::PoseTerm* inTerms, UINT inNumTerms) override;
+	virtual void UpdateInstanceAnimationPlayback(const std::string& inRenderItemName,
+		UINT inAnimClipIdx, float inTimePos, float inTimeRate, float inTimeBase, float inTimeEnd) override;
 
 	virtual void SetVisible(const std::string& inRenderItemName, bool inState) override;
 	virtual void SetSkeletonVisible(const std::string& inRenderItemName, bool inState) override;
@@ -181,9 +236,13 @@ public:
 	virtual void AddRenderItem(std::string& ioRenderItemName, const Mesh* inMesh) override;
 	virtual GameResult AddMaterials(const std::unordered_map<std::string, MaterialIn>& inMaterials) override;
 
-	virtual UINT AddAnimations(const std::string& inClipName, const Game::Animation& inAnim) override;
+	virtual GameResult AddAnimations(const std::string& inClipName, const Game::Animation& inAnim, UINT& outClipIndex) override;
+	virtual void RemoveAnimations(UINT inClipIndex) override;
 	virtual GameResult UpdateAnimationsMap() override;
 
+	//* Bytes of the streamed texture levels that may be resident at once.
+	void SetTextureStreamingBudget(UINT64 inBytes);
+
 protected:
 	virtual GameResult CreateRtvAndDsvDescriptorHeaps() override;
 
@@ -192,6 +251,18 @@ private:
 	GameResult ClearViews();
 
 	void DrawTexts();
+
+	GameResult BuildUploadCommandList();
+	//* Returns the command list the uploads are recorded on. It is opened by the first upload after a frame
+	//*  and submitted ahead of the passes of the next frame, so loading an asset never waits for the GPU.
+	GameResult GetUploadCommandList(ID3D12GraphicsCommandList*& outCmdList);
+	GameResult SubmitUploads();
+	//* Keeps the resource alive until the GPU is done with the commands submitted so far.
+	void RetireResource(Microsoft::WRL::ComPtr<ID3D12Resource>& ioResource);
+	//* Keeps the upload resource alive until the upload batch that reads from it is done.
+	void RetireUploadResource(Microsoft::WRL::ComPtr<ID3D12Resource>& ioResource);
+	void ReleaseRetiredResources();
+
 	void AddRenderItem(const std::string& inRenderItemName, const Mesh* inMesh, bool inIsNested);
 	GameResult LoadDataFromMesh(const Mesh* inMesh, MeshGeometry* outGeo, DirectX::BoundingBox& inBound);
 	GameResult LoadDataFromSkeletalMesh(const Mesh* inMesh, MeshGeometry* outGeo, DirectX::BoundingBox& inBound);
@@ -202,12 +273,34 @@ private:
 	GameResult AddTextures(const std::unordered_map<std::string, MaterialIn>& inMaterials);
 	GameResult AddDescriptors(const std::unordered_map<std::string, MaterialIn>& inMaterials);
 
+	//* Loads the lower mip levels of the texture and registers it to the residency manager.
+	GameResult LoadStreamedTexture(ID3D12GraphicsCommandList* inCmdList, Texture* ioTexture);
+	void AddStreamedTextureDescriptor(const std::string& inTextureName, UINT inDescriptorIndex);
+	//* Replaces the texture with its pending resource, viewed by new descriptors of the texture table.
+	//* Returns false(and changes nothing) if the table has no descriptor left that the frames in flight don't read.
+	bool SwapStreamedTexture(StreamedTexture& ioStreamed);
+	//* Returns a descriptor of the texture table that no frame in flight reads.
+	bool AllocateTextureDescriptor(UINT& outIndex);
+	//* Points the materials(and the materials added later) at the descriptor that replaces inOldIndex;
+	//*  the old one is reused once the frames reading it are done.
+	void ReplaceTextureDescriptor(UINT inOldIndex, UINT inNewIndex);
+	//* Reports the UV density the material is sampled at(called from the culling threads).
+	void RequestTextureMips(const Material* inMaterial, float inUVPerPixel);
+	//* Starts recreating the streamed textures whose resident levels are changed by the requests of the last frame
+	//*  and swaps in the ones whose uploads are done.
+	GameResult UpdateTextureResidency();
+
 	///
 	// Update helper classes
 	///
 	bool IsContained(BoundTypes inType, const RenderItem::BoundingStruct& inBound,
 		const DirectX::BoundingFrustum& inFrustum, UINT inTid = 0);
-	UINT UpdateEachInstances(RenderItem* inRitem);
+	UINT UpdateEachInstances(RenderItem* inRitem, UINT inTid = 0);
+	//* Makes sure the instance range of the render item can hold all of its instances.
+	void ReserveInstanceRange(RenderItem* ioRitem);
+	//* Grows the instance buffers of the current frame resource and
+	//*  marks all the instances dirty if the instance ranges have been moved.
+	GameResult UpdateInstanceArena();
 	/// Update helper classes
 
 	///
@@ -215,6 +308,8 @@ private:
 	///
 	GameResult AnimateMaterials(const GameTimer& gt, UINT inTid = 0);
 	GameResult UpdateObjectCBsAndInstanceBuffers(const GameTimer& gt, UINT inTid = 0);
+	//* Builds the sort keys of the multi-threaded layers and sorts them in parallel.
+	GameResult UpdateDrawPackets(const GameTimer& gt, UINT inTid = 0);
 	GameResult UpdateMaterialBuffers(const GameTimer& gt, UINT inTid = 0);
 	GameResult UpdateShadowTransform(const GameTimer& gt, UINT inTid = 0);
 	GameResult UpdateMainPassCB(const GameTimer& gt, UINT inTid = 0);
@@ -240,6 +335,13 @@ private:
 
 	void DrawRenderItems(ID3D12GraphicsCommandList* outCmdList, RenderItem*const* inRitems, size_t inNum);
 	void DrawRenderItems(ID3D12GraphicsCommandList* outCmdList, RenderItem*const* inRitems, size_t inBegin, size_t inEnd);
+	//* Picks the shadow pipeline of each skinned geometry by its skin stream(quantized 8/16-bit indices or float).
+	void DrawSkinnedShadowRenderItems(ID3D12GraphicsCommandList* outCmdList, RenderItem*const* inRitems, size_t inBegin, size_t inEnd);
+	//* Returns the part of the sorted layer the thread has to record.
+	void GetDrawRange(RenderLayers inLayer, UINT inTid, UINT& outBegin, UINT& outEnd) const;
+	void PartitionSortedLayer(RenderLayers inLayer);
+	//* Pipeline state the G-buffer pass draws a sorted layer with; the sort keys group the draws by it.
+	ID3D12PipelineState* GetLayerPso(RenderLayers inLayer);
 
 	void BindViews(ID3D12GraphicsCommandList* outCmdList, bool bShadowPass);
 	void BindDescriptorTables(ID3D12GraphicsCommandList* outCmdList, bool bNullMiscTex);
@@ -273,11 +375,32 @@ private:
 
 	std::unordered_map<std::string, std::unique_ptr<MeshGeometry>> mGeometries;
 
+	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> mUploadCommandList;
+	std::array<UploadBatch, gNumFrameResources> mUploadBatches;
+	UINT mCurrUploadBatch = 0;
+	bool bUploadBatchOpened = false;
+	// Upload resources read by the opened batch.
+	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> mUploadBatchResources;
+	// Sorted by the fence.
+	std::vector<RetiredResource> mRetiredResources;
+
 	std::vector<std::unique_ptr<Material>> mMaterials;
 	std::unordered_map<std::string, Material*> mMaterialRefs;
 
 	std::unordered_map<std::string, std::unique_ptr<Texture>> mTextures;
 
+	Game::TextureResidency mTextureResidency;
+	// Indexed by the residency handles.
+	std::vector<StreamedTexture> mStreamedTextures;
+	std::unordered_map<std::string, Game::TextureResidency::Handle> mStreamedTextureHandles;
+	// Streamed textures sampled by each material(indexed by MatCBIndex).
+	std::vector<std::vector<Game::TextureResidency::Handle>> mMaterialStreamedTextures;
+	std::vector<Game::TextureResidencyChange> mResidencyChanges;
+	// Sorted by the fence.
+	std::vector<RetiredDescriptor> mRetiredTextureDescriptors;
+	// Streamed textures with a pending resource.
+	std::vector<Game::TextureResidency::Handle> mPendingTextureSwaps;
+
 	std::vector<D3D12_INPUT_ELEMENT_DESC> mInputLayout;
 	std::vector<D3D12_INPUT_ELEMENT_DESC> mSkinnedInputLayout;
 
@@ -289,6 +412,20 @@ private:
 
 	// Render items divided by PSO.
 	std::vector<RenderItem*> mRitemLayer[RenderLayers::Count];
+	// Visible render items of the sorted layers in draw order(rebuilt every frame).
+	std::vector<RenderItem*> mSortedRitemLayer[RenderLayers::Count];
+
+	std::vector<DrawPacketSource> mDrawPacketSources;
+	std::vector<Game::DrawPacket> mDrawPackets;
+	std::unordered_map<const MeshGeometry*, UINT> mGeometryIds;
+	Game::DrawPacketSorter mDrawPacketSorter;
+	// Cost-balanced thread boundaries of the sorted layers(mNumThreads + 1 for each layer).
+	std::vector<UINT> mLayerPartitions[RenderLayers::Count];
+	std::vector<UINT64> mDrawCosts;
+
+	// Per-thread command list recording times of the multi-threaded passes.
+	std::vector<TaskTimer> mShadowRecordTimers;
+	std::vector<TaskTimer> mGBufferRecordTimers;
 
 	std::unordered_map<std::string, UINT> mDiffuseSrvHeapIndices;
 	std::unordered_map<std::string, UINT> mNormalSrvHeapIndices;
@@ -335,7 +472,24 @@ private:
 	std::unique_ptr<DirectX::SpriteFont> mDefaultFont;
 	std::unique_ptr<DirectX::SpriteBatch> mSpriteBatch;
 
-	const UINT MaxInstanceCount = 128;
+	const UINT InitialInstanceCapacity = 1024;
+	Game::InstanceAllocator mInstanceAllocator;
+	UINT mUploadedInstanceGeneration = 0;
+	// CPU copies of the instance buffers laid out like the instance arena.
+	// Dirty elements are written here first and then copied to the upload buffers in contiguous blocks.
+	std::vector<Game::InstanceData> mInstanceStaging;
+	std::vector<Game::InstanceIdxData> mInstanceIdxStaging;
+	// Per-thread upload counters of the current frame.
+	std::vector<UINT64> mUploadedBytes;
+	std::vector<UINT> mUploadCopies;
+
+	const UINT64 DefaultTextureStreamingBudget = 256 * 1024 * 1024;
+	const UINT64 TextureStreamingBytesPerFrame = 16 * 1024 * 1024;
+	// Mip levels up to this size are loaded with the texture and stay resident.
+	const UINT TextureStreamingTailSize = 128;
+	// Number of descriptors of the texture table(gTextureMaps) the materials index.
+	const UINT TextureTableSize = 64;
+
 	std::array<float, 2> mRootConstants;
 
 	std::vector<DirectX::XMFLOAT4> mBlurWeights5;
@@ -45,19 +45,6 @@ public:
 	friend bool operator==(const Game::FbxVertex& lhs, const Game::FbxVertex& rhs);
 };
 
-namespace std {
-	template<> struct hash<Game::FbxVertex> {
-		size_t operator()(Game::FbxVertex const& vertex) const {
-			size_t pos = static_cast<size_t>(vertex.mPos.x + vertex.mPos.y + vertex.mPos.z);
-			size_t normal = static_cast<size_t>(vertex.mNormal.x + vertex.mNormal.y + vertex.mNormal.z);
-			size_t texC = static_cast<size_t>(vertex.mTexC.x + vertex.mTexC.y);
-			size_t tan = static_cast<size_t>(vertex.mTangentU.x + vertex.mTangentU.y + vertex.mTangentU.z);
-
-			return ((pos ^ normal) << 1) ^ ((texC ^ tan) << 2);
-		}
-	};
-}
-
 struct Game::FbxMaterial {
 public:
 	std::string mMaterialName;
@@ -143,6 +130,22 @@ private:
 		}
 	};
 
+	//* Cluster whose key-frames are baked for every clip once the skeleton is loaded.
+	struct BoneBakeJob {
+		fbxsdk::FbxNode* mNode = nullptr;
+		fbxsdk::FbxCluster* mCluster = nullptr;
+		fbxsdk::FbxAMatrix mGeometryTransform;
+		UINT mClusterIndex = 0;
+		int mParentIndex = -1;
+	};
+
+	struct ClipLayer {
+		fbxsdk::FbxAnimLayer* mAnimLayer = nullptr;
+		fbxsdk::FbxTakeInfo* mTakeInfo = nullptr;
+		fbxsdk::FbxLongLong mStartFrame = 0;
+		fbxsdk::FbxLongLong mEndFrame = 0;
+	};
+
 public:
 	FbxImporter();
 	virtual ~FbxImporter();
@@ -168,9 +171,11 @@ private:
 	//* Initializes fbx sdk(The app crashes when triangulating geometry).
 	bool LoadFbxScene(const std::string& inFileName);
 
-	int LoadDataFromMesh(fbxsdk::FbxNode* inNode, UINT inPrevNumVertices);
-	//* Multi threaded version of the fuction LoadMesh.
-	int MTLoadDataFromMesh(fbxsdk::FbxNode* inNode, UINT inPrevNumVertices);
+	//* Reads the triangle corners of the mesh without welding them(three vertices per triangle).
+	bool LoadDataFromMesh(fbxsdk::FbxNode* inNode, std::vector<Game::FbxVertex>& outVertices);
+	//* Multi threaded version of the fuction LoadDataFromMesh.
+	//* Each mesh node is read by its own job and the results are stored in node order.
+	bool MTLoadDataFromMesh(const std::vector<fbxsdk::FbxNode*>& inNodes, std::vector<std::vector<Game::FbxVertex>>& outVertices);
 
 	void LoadMaterials(fbxsdk::FbxNode* inNode);
 
@@ -197,17 +202,22 @@ private:
 	//* Each cluster has control points that is affected by it.
 	//* So the app need to iterate all the meshes that is existed and extract clusters affecting the mesh.
 	void BuildControlPointsWeigths(fbxsdk::FbxCluster* inCluster, UINT inClusterIndex, const std::string& inMeshName);
-	//* Loads FbxAnimLayer-set in FbxAnimStack-set
-	//   and FbxAnimCurve-set in FbxAnimLayer-set.
-	//* After loads FbxAnimCurve-set, calls the function BuildAnimationKeyFrames
-	//   to build global transform(to-root) matrix at each frame.
-	void BuildAnimations(fbxsdk::FbxNode* inNode, fbxsdk::FbxCluster* inCluster,
-		const fbxsdk::FbxAMatrix& inGeometryTransform, UINT inClusterIndex, int inParentIndex);
-	//* Helper class for the function BuildAnimations.
-	//* Loads TRS-components in FbxAnimCurve at each frame to build global transform(to-root).
-	void BuildAnimationKeyFrames(fbxsdk::FbxAnimLayer* inAnimLayer, fbxsdk::FbxNode* inNode, fbxsdk::FbxCluster* inCluster,
-		const fbxsdk::FbxAMatrix& inGeometryTransform, fbxsdk::FbxTakeInfo* inTakeInfo,
-		Game::FbxAnimation& outAnimation, UINT inClusterIndex, int inParentIndex);
+	//* Loads FbxAnimLayer-set in FbxAnimStack-set and bakes the key-frames of the bones
+	//   registered by LoadBones.
+	//* The mesh global transforms are evaluated once per (layer, mesh node, frame),
+	//   the local poses are evaluated by one job per (layer, bone) and the global transforms
+	//   are accumulated by one job per clip in the same bone order as the serial path,
+	//   so the result doesn't depend on the number of threads.
+	void BuildAnimations();
+	//* Helper function for the function BuildAnimations.
+	//* Loads TRS-components in FbxAnimCurve at each frame to build local transform.
+	void BuildLocalPoses(const ClipLayer& inLayer, const BoneBakeJob& inJob,
+		fbxsdk::FbxTime::EMode inTimeMode, std::vector<fbxsdk::FbxAMatrix>& outPoses) const;
+	//* Helper function for the function BuildAnimations.
+	//* Builds global transform(to-root) matrix at each frame from the local poses.
+	void BuildAnimationKeyFrames(const ClipLayer& inLayer, const BoneBakeJob& inJob,
+		const std::vector<fbxsdk::FbxAMatrix>& inLocalPoses, const std::vector<fbxsdk::FbxAMatrix>& inOffsetInverses,
+		Game::FbxAnimation& outAnimation);
 	//* Deprecated.
 	void BuildAnimationKeyFrames(fbxsdk::FbxTakeInfo* inTakeInfo, fbxsdk::FbxCluster* inCluster, fbxsdk::FbxNode* inNode,
 		fbxsdk::FbxAMatrix inGeometryTransform, Game::FbxAnimation& outAnimation,
@@ -218,7 +228,6 @@ private:
 	fbxsdk::FbxIOSettings* mFbxIos;
 	fbxsdk::FbxScene* mFbxScene;
 
-	std::unordered_map<FbxVertex, std::uint32_t> mUniqueVertices;
 	std::vector<FbxVertex> mVertices;
 	std::vector<std::uint32_t> mIndices;
 
@@ -237,4 +246,6 @@ private:
 
 	std::unordered_map<UINT /* Bone index */, fbxsdk::FbxCluster*> mClusters;
 	std::vector<UINT /* BOne index */> mNestedClusters;
+
+	std::vector<BoneBakeJob> mBoneBakeJobs;
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "DX12Game/GameUploadBuffer.h"
+#include "DX12Game/DirtyRangeTracker.h"
 
 namespace Game {
 	enum EInstanceRenderState : UINT {
@@ -11,7 +12,8 @@ namespace Game {
 	struct ObjectConstants {
 	public:
 		UINT mObjectIndex;
-		UINT mObjectPad0;
+		// Offset of the instance range of the object in the instance buffers.
+		UINT mInstanceOffset;
 		UINT mObjectPad1;
 		UINT mObjectPad2;
 
@@ -38,6 +40,20 @@ namespace Game {
 		UINT mMaterialIndex;
 		int mAnimClipIndex;
 		UINT mRenderState;
+		// Clip samples the shaders blend with (mAnimClipIndex, mTimePos); an unused one has the clip index of -1.
+		// mBlendWeights[0] weighs the primary sample and mBlendWeights[i + 1] the i-th of these.
+		int mBlendAnimClipIndices[3];
+		float mBlendTimePos[3];
+		float mBlendWeights[4];
+		// The shaders play mTimePos on at mTimeRate frames per second since mTimeBase(the total time of the pass),
+		//  wrapped at the frame mTimeEnd, so a character updated every few frames still moves smoothly.
+		// A rate of 0 holds mTimePos.
+		float mTimeRate;
+		float mTimeBase;
+		float mTimeEnd;
+		UINT mInstPad0;
+		UINT mInstPad1;
+		UINT mInstPad2;
 
 	public:
 		InstanceData(
@@ -56,6 +72,11 @@ namespace Game {
 		static bool IsMatched(UINT inRenderState, EInstanceRenderState inTargetState);
 		static bool IsUnmatched(UINT inRenderState, EInstanceRenderState inTargetState);
 
+		//* Plays a single clip sample(drops the blend samples).
+		void SetAnimation(int inAnimClipIndex, float inTimePos);
+		//* Plays the primary sample on between updates(call after SetAnimation).
+		void SetPlayback(float inTimeRate, float inTimeBase, float inTimeEnd);
+
 		bool CheckFrameDirty(UINT inIndex) const;
 		void SetFramesDirty(UINT inNum);
 		void UnsetFrameDirty(UINT inIndex);
@@ -209,7 +230,7 @@ namespace Game {
 	struct FrameResource {
 	public:
 		FrameResource(ID3D12Device* inDevice, UINT inPassCount,
-			UINT inObjectCount, UINT inMaxInstanceCount, UINT inMaterialCount);
+			UINT inObjectCount, UINT inInstanceCapacity, UINT inMaterialCount);
 		virtual ~FrameResource() = default;
 
 	private:
@@ -221,6 +242,9 @@ namespace Game {
 	public:
 		GameResult Initialize(UINT inNumThreads = 1);
 
+		//* Recreates the instance buffers, so it must be called only when the GPU is done with this frame resource.
+		GameResult ResizeInstanceBuffers(UINT inInstanceCapacity);
+
 	public:
 		// We cannot reset the allocator until the GPU is done processing the commands.
 		// So each frame needs their own allocator.
@@ -247,6 +271,8 @@ namespace Game {
 		// we would create a constant buffer with enough room for a 1000 objects.  With instancing, we would just
 		// create a structured buffer large enough to store the instance data for 1000 instances.  
 		GameUploadBuffer<InstanceData> mInstanceDataBuffer;
+		// Instance data elements written to this frame resource's buffer during the update (one tracker per thread).
+		std::vector<DirtyRangeTracker> mInstanceTrackers;
 
 		// Fence value to mark commands up to this fence point.  This lets us
 		// check if these frame resources are still in use by the GPU.
@@ -255,7 +281,7 @@ namespace Game {
 		ID3D12Device* mDevice;
 		UINT mPassCount;
 		UINT mObjectCount;
-		UINT mMaxInstanceCount;
+		UINT mInstanceCapacity;
 		UINT mMaterialCount;
 	};
 }
\ No newline at end of file
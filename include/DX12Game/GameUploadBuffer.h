@@ -20,6 +20,8 @@ public:
 	ID3D12Resource* Resource() const;
 
 	void CopyData(int inElementIndex, const T& inData);
+	//* Copies inCount contiguous elements, with a single memcpy when the elements are tightly packed.
+	void CopyData(int inElementIndex, const T* inData, UINT inCount);
 
 private:
 	Microsoft::WRL::ComPtr<ID3D12Resource> mUploadBuffer;
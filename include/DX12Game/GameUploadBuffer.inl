@@ -11,6 +11,13 @@ GameUploadBuffer<T>::~GameUploadBuffer() {
 
 template <typename T>
 GameResult GameUploadBuffer<T>::Initialize(ID3D12Device* inDevice, UINT inElementCount, bool inIsConstantBuffer) {
+	// Release the previous buffer when the upload buffer is resized.
+	if (mUploadBuffer != nullptr) {
+		mUploadBuffer->Unmap(0, nullptr);
+		mUploadBuffer.Reset();
+		mMappedData = nullptr;
+	}
+
 	mIsConstantBuffer = inIsConstantBuffer;
 
 	mElementByteSize = sizeof(T);
@@ -51,4 +58,15 @@ void GameUploadBuffer<T>::CopyData(int inElementIndex, const T& inData) {
 	std::memcpy(&mMappedData[inElementIndex * mElementByteSize], &inData, sizeof(T));
 }
 
+template <typename T>
+void GameUploadBuffer<T>::CopyData(int inElementIndex, const T* inData, UINT inCount) {
+	if (mElementByteSize == sizeof(T)) {
+		std::memcpy(&mMappedData[inElementIndex * mElementByteSize], inData, sizeof(T) * inCount);
+		return;
+	}
+
+	for (UINT i = 0; i < inCount; ++i)
+		CopyData(inElementIndex + i, inData[i]);
+}
+
 #endif // __GAMEUPLOADBUFFER_INL__
\ No newline at end of file
@@ -20,6 +20,15 @@ class InputSystem;
 class Actor;
 class Mesh;
 
+namespace Game {
+	class AssetLoader;
+	class ImportCache;
+	class LoadGraph;
+	class AnimationGraphBatch;
+	class PoseCache;
+	class AnimationLod;
+}
+
 class GameWorld final {
 public:
 	enum GameState {
@@ -52,11 +61,27 @@ public:
 	void RemoveActor(Actor* inActor);
 
 	GameResult AddMesh(const std::string& inFileName, Mesh*& outMeshPtr, bool inIsSkeletal = false, bool inNeedToBeAligned = false);
+	//* Decodes the mesh on a loader thread and uploads it on the main thread at the start of a later frame.
+	//* inCallback receives the mesh(nullptr if the load failed) on the main thread;
+	//*  it is invoked immediately if the mesh is already loaded.
+	//* Requests for a mesh that is still in flight share its load.
+	void AddMeshAsync(const std::string& inFileName, bool inIsSkeletal, bool inNeedToBeAligned, int inPriority,
+		const std::function<void(Mesh*)>& inCallback);
 	void RemoveMesh(const std::string& inFileName);
 
+	//* Declares a mesh of the level in the load graph before any actor requests it.
+	//* SubmitLoadGraph starts every declared file at once; the requests of AddMeshAsync
+	//*  for a declared file only bind to its load.
+	void DeclareMesh(const std::string& inFileName, bool inIsSkeletal, bool inNeedToBeAligned, int inPriority);
+	GameResult SubmitLoadGraph();
+
 	static GameWorld* GetWorld();
 
 	Renderer* GetRenderer() const;
+	Game::ImportCache* GetImportCache() const;
+	Game::AnimationGraphBatch* GetAnimationGraphBatch() const;
+	Game::PoseCache* GetPoseCache() const;
+	Game::AnimationLod* GetAnimationLod() const;
 	InputSystem* GetInputSystem() const;
 
 	UINT GetPrimaryMonitorWidth() const;
@@ -86,6 +111,21 @@ private:
 	GameResult UpdateGame(const GameTimer& gt, UINT inTid = 0);
 	GameResult Draw(const GameTimer& gt, UINT inTid = 0);
 
+	//* Uploads the assets finished by the loader within the per-frame budget.
+	//* Must be called on the main thread while the other game threads are idle.
+	void PumpAssets();
+	//* Evaluates the animation graphs of every character, samples the poses requested from the pose cache
+	//*  and starts the next frame of the animation LOD.
+	//* Must be called on the main thread while the other game threads are idle.
+	void UpdateAnimations(float inDeltaTime);
+	//* Reports how long the meshes requested by LoadData took, split into cache hits(warm) and imports(cold),
+	//*  and writes the startup timeline of the load graph.
+	void OutputLoadingInfo();
+
+	//* AddMeshAsync without counting a binding in the load graph.
+	void LoadMeshAsync(const std::string& inFileName, bool inIsSkeletal, bool inNeedToBeAligned, int inPriority,
+		const std::function<void(Mesh*)>& inCallback);
+
 	GameResult InitMainWindow();
 	GameResult OnResize();
 
@@ -137,6 +177,18 @@ private:
 	std::unique_ptr<SpinlockBarrier> mSpinlockBarrier;
 
 	std::unordered_map<std::string, std::unique_ptr<Mesh>> mMeshes;
+	// Meshes that are requested but not uploaded yet.
+	std::unordered_map<std::string, std::unique_ptr<Mesh>> mPendingMeshes;
+
+	std::unique_ptr<Game::AssetLoader> mAssetLoader;
+	std::unique_ptr<Game::ImportCache> mImportCache;
+	std::unique_ptr<Game::LoadGraph> mLoadGraph;
+	std::unique_ptr<Game::AnimationGraphBatch> mAnimationGraphBatch;
+	std::unique_ptr<Game::PoseCache> mPoseCache;
+	std::unique_ptr<Game::AnimationLod> mAnimationLod;
+
+	TaskTimer mLoadingTimer;
+	bool bLoadingInfoOutputted = false;
 
 	SoundEvent mMusicEvent;
 	float mPrevBusVolume = 0.0f;
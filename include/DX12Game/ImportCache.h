@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Game {
+	struct ImportCacheStatistics;
+	class ImportCache;
+}
+
+struct Game::ImportCacheStatistics {
+public:
+	// Assets served from the cache(warm) and their total decoding time in seconds.
+	std::uint32_t mNumHits = 0;
+	float mHitTime = 0.0f;
+	// Assets imported from the source files(cold) and their total decoding time in seconds.
+	std::uint32_t mNumMisses = 0;
+	float mMissTime = 0.0f;
+};
+
+//* Content-addressed directory of cooked assets that persists between launches.
+//* An entry is named after the hash of the source file contents and the importer options,
+//*  so renamed or copied sources hit the same entry and edited sources miss it.
+//* Entries are written to a unique temporary file and renamed into place, so several processes
+//*  can share the directory; a reader never sees a partially written entry.
+//* All the methods except Initialize can be called from any thread.
+class Game::ImportCache {
+public:
+	// Bump when the import or the optimization passes change their output,
+	//  every entry cooked by the older code is missed afterwards.
+	static constexpr std::uint32_t ImporterVersion = 2;
+
+public:
+	ImportCache() = default;
+	virtual ~ImportCache() = default;
+
+private:
+	ImportCache(const ImportCache& src) = delete;
+	ImportCache(ImportCache&& src) = delete;
+	ImportCache& operator=(const ImportCache& rhs) = delete;
+	ImportCache& operator=(ImportCache&& rhs) = delete;
+
+public:
+	//* Creates the cache directory if it doesn't exist.
+	bool Initialize(const std::string& inDirectory);
+
+	//* Hashes the whole source file together with inOptions, ImporterVersion and inFormatVersion.
+	//* Returns false if the source file can't be read.
+	bool ComputeKey(const std::string& inSourceFileName, std::uint64_t inOptions, std::uint32_t inFormatVersion,
+		std::uint64_t& outKey) const;
+
+	std::string GetFilePath(std::uint64_t inKey, const std::string& inExt) const;
+	//* Returns a path next to the entry that no other thread or process is going to use.
+	std::string GetTempFilePath(std::uint64_t inKey, const std::string& inExt) const;
+
+	//* Moves the completely written temporary file to the entry path, replacing an existing entry.
+	//* If the entry can't be replaced, the temporary file is discarded.
+	bool Commit(const std::string& inTempFilePath, std::uint64_t inKey, const std::string& inExt) const;
+	//* Removes a temporary file that couldn't be written completely.
+	void Discard(const std::string& inTempFilePath) const;
+
+	void RecordHit(float inSeconds);
+	void RecordMiss(float inSeconds);
+	ImportCacheStatistics GetStatistics() const;
+
+	static std::uint64_t Hash(const void* inData, size_t inSize, std::uint64_t inSeed = 0);
+
+private:
+	std::string mDirectory;
+
+	mutable std::atomic<std::uint32_t> mNextTempId{ 0 };
+
+	std::atomic<std::uint32_t> mNumHits{ 0 };
+	std::atomic<std::uint32_t> mNumMisses{ 0 };
+	// Microseconds, so the times can be accumulated atomically.
+	std::atomic<std::uint64_t> mHitMicroseconds{ 0 };
+	std::atomic<std::uint64_t> mMissMicroseconds{ 0 };
+};
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace Game {
+	struct InstanceAllocatorStatistics;
+	class InstanceAllocator;
+}
+
+struct Game::InstanceAllocatorStatistics {
+public:
+	// Number of instance slots the backing buffers must be able to hold.
+	std::uint32_t mCapacity = 0;
+	// Number of slots handed out to live ranges.
+	std::uint32_t mReserved = 0;
+	std::uint32_t mNumRanges = 0;
+	std::uint32_t mNumFreeBlocks = 0;
+	std::uint32_t mLargestFreeBlock = 0;
+	// 1 - (largest free block / total free slots), 0.0 means all the free slots are contiguous.
+	float mFragmentation = 0.0f;
+};
+
+//* Hands out variable-size instance ranges from one linear buffer.
+//* Ranges are referenced by handles, so they can be moved by growth and compaction
+//*  without the owners noticing; the generation is bumped whenever any offset changes
+//*  or the capacity grows, so the contents of the backing buffers must be re-uploaded.
+//* This class only does the bookkeeping and doesn't touch any device objects.
+class Game::InstanceAllocator {
+public:
+	using Handle = std::uint32_t;
+
+	static constexpr Handle InvalidHandle = 0xFFFFFFFF;
+
+	static constexpr std::uint32_t DefaultGranularity = 8;
+	static constexpr float DefaultFragmentationThreshold = 0.5f;
+
+public:
+	InstanceAllocator() = default;
+	virtual ~InstanceAllocator() = default;
+
+private:
+	InstanceAllocator(const InstanceAllocator& src) = delete;
+	InstanceAllocator(InstanceAllocator&& src) = delete;
+	InstanceAllocator& operator=(const InstanceAllocator& rhs) = delete;
+	InstanceAllocator& operator=(InstanceAllocator&& rhs) = delete;
+
+public:
+	void Initialize(std::uint32_t inInitialCapacity, std::uint32_t inGranularity = DefaultGranularity);
+
+	//* Returns a range that can hold at least inCount instances.
+	//* The capacity is grown when no free block is large enough.
+	Handle Allocate(std::uint32_t inCount);
+	//* Grows the range so that it can hold at least inCount instances.
+	//* The range is extended in place when the following block is free, otherwise it is moved.
+	//* Returns true if the offset of the range is changed.
+	bool Reserve(Handle inHandle, std::uint32_t inCount);
+	void Free(Handle inHandle);
+
+	//* Packs all the live ranges to the front of the buffer(keeping their order).
+	//* Returns true if any range is moved.
+	bool Compact();
+	//* Compacts only if the free slots are scattered more than inThreshold.
+	bool Defragment(float inThreshold = DefaultFragmentationThreshold);
+
+	std::uint32_t GetOffset(Handle inHandle) const;
+	std::uint32_t GetSize(Handle inHandle) const;
+
+	std::uint32_t GetCapacity() const;
+	std::uint32_t GetGeneration() const;
+
+	InstanceAllocatorStatistics GetStatistics() const;
+
+private:
+	std::uint32_t RoundUp(std::uint32_t inCount) const;
+
+	//* Takes inSize slots from the first free block that is large enough.
+	//* Returns false if there is no such block.
+	bool TakeFreeBlock(std::uint32_t inSize, std::uint32_t& outOffset);
+	//* Returns the block to the free list, merging with the neighbouring free blocks.
+	void InsertFreeBlock(std::uint32_t inOffset, std::uint32_t inSize);
+	void Grow(std::uint32_t inRequiredSize);
+
+private:
+	struct Range {
+		std::uint32_t mOffset = 0;
+		std::uint32_t mSize = 0;
+		bool bAlive = false;
+	};
+
+	std::vector<Range> mRanges;
+	std::vector<Handle> mFreeHandles;
+
+	// Free blocks sorted by offset(offset, size).
+	std::map<std::uint32_t, std::uint32_t> mFreeBlocks;
+
+	std::uint32_t mCapacity = 0;
+	std::uint32_t mReserved = 0;
+	std::uint32_t mGranularity = DefaultGranularity;
+	std::uint32_t mGeneration = 0;
+};
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Game {
+	struct LoadTimelineEntry;
+	class LoadGraph;
+}
+
+//* Startup timeline of one asset in seconds since the graph was submitted.
+//* A stage that hasn't happened(or that a failed dependency skipped) is negative.
+struct Game::LoadTimelineEntry {
+public:
+	std::string mName;
+
+	float mIssueTime = -1.0f;
+	float mLoadBeginTime = -1.0f;
+	float mLoadEndTime = -1.0f;
+	float mCompleteTime = -1.0f;
+
+	std::uint64_t mUploadBytes = 0;
+	// Consumers that were bound to the asset.
+	std::uint32_t mNumBindings = 0;
+	bool bSucceeded = false;
+};
+
+//* Explicit graph of the assets a level loads.
+//* The level declares its assets(nodes) and the order constraints between them up front;
+//*  Submit issues every node without pending dependencies at once, so distinct assets load concurrently,
+//*  and the rest are issued as their dependencies complete.
+//* The graph only schedules and records; the issue function of a node starts the actual load
+//*  and reports back through MarkLoadBegin/MarkLoadEnd(any thread) and Complete(owner thread).
+//* This class doesn't depend on any device objects.
+class Game::LoadGraph {
+public:
+	using NodeId = std::uint32_t;
+	using IssueFunc = std::function<void(NodeId inNode)>;
+
+	static constexpr NodeId InvalidNode = 0xFFFFFFFF;
+
+public:
+	LoadGraph();
+	virtual ~LoadGraph() = default;
+
+private:
+	LoadGraph(const LoadGraph& src) = delete;
+	LoadGraph(LoadGraph&& src) = delete;
+	LoadGraph& operator=(const LoadGraph& rhs) = delete;
+	LoadGraph& operator=(LoadGraph&& rhs) = delete;
+
+public:
+	//* Declares an asset; a name that is already declared returns the existing node.
+	//* Returns InvalidNode once the graph is submitted.
+	NodeId AddNode(const std::string& inName, IssueFunc inIssue);
+	NodeId FindNode(const std::string& inName) const;
+	//* inNode isn't issued before inDependency completes; a failed dependency fails inNode as well.
+	//* Must be called before Submit.
+	bool AddDependency(NodeId inNode, NodeId inDependency);
+
+	//* Issues the nodes without dependencies; the timeline starts here.
+	//* Returns false(and issues nothing) if the dependencies form a cycle.
+	bool Submit();
+	bool IsSubmitted() const;
+
+	//* Can be called from any thread.
+	void MarkLoadBegin(NodeId inNode);
+	void MarkLoadEnd(NodeId inNode, std::uint64_t inUploadBytes);
+	//* Records the end of the load and issues the dependents that became ready.
+	void Complete(NodeId inNode, bool inSucceeded);
+	void AddBinding(NodeId inNode);
+
+	//* Every node is completed(or failed).
+	bool IsDone() const;
+
+	void GetTimeline(std::vector<LoadTimelineEntry>& outTimeline) const;
+	//* Writes the timeline as CSV, one asset per row in declaration order.
+	bool WriteTimeline(const std::string& inFileName) const;
+
+private:
+	enum ENodeState {
+		EDeclared,
+		EIssued,
+		ECompleted
+	};
+
+	struct Node {
+		IssueFunc mIssue;
+		std::vector<NodeId> mDependents;
+		std::uint32_t mNumPendingDependencies = 0;
+		ENodeState mState = EDeclared;
+
+		LoadTimelineEntry mTimeline;
+	};
+
+	float GetTime() const;
+	void Issue(NodeId inNode);
+	//* Fails the dependents of a failed node without issuing them.
+	void Fail(NodeId inNode);
+
+private:
+	// Guards the timelines, which the loader threads write to.
+	mutable std::mutex mMutex;
+
+	std::vector<Node> mNodes;
+	std::unordered_map<std::string, NodeId> mNodeIds;
+
+	std::uint32_t mNumCompleted = 0;
+	bool bSubmitted = false;
+
+	std::chrono::steady_clock::time_point mSubmitTime;
+};
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "DX12Game/SkinnedData.h"
+#include "DX12Game/SkinWeights.h"
 
 class Renderer;
 struct MaterialIn;
@@ -8,6 +9,7 @@ struct MaterialIn;
 namespace Game {
 	struct Vertex;
 	struct SkinnedVertex;
+	class ImportCache;
 }
 
 class Mesh {
@@ -16,13 +18,29 @@ public:
 	virtual ~Mesh() = default;
 
 public:
+	//* Decodes and uploads the mesh on the calling thread.
 	virtual GameResult Load(const std::string& inFileName);
 
+	//* CPU half of Load: reads the cooked container from the import cache or imports the FBX file.
+	//* Doesn't touch any device objects, so it can run on a loader thread.
+	GameResult Decode(const std::string& inFileName);
+	//* Device half of Load: uploads the geometry and registers the animations.
+	//* Must be called on the thread that records the renderer's command lists.
+	GameResult Upload();
+	//* Frees the lines the clips of the mesh take in the animations map; their clip indices become invalid.
+	void ReleaseAnimations();
+
+	//* Number of bytes Upload copies to the vertex and index buffers.
+	std::uint64_t GetUploadByteSize() const;
+
 	const std::string& GetMeshName() const;
 	const std::vector<std::string>& GetDrawArgs() const;
 
 	const std::vector<Game::Vertex>& GetVertices() const;
 	const std::vector<Game::SkinnedVertex>& GetSkinnedVertices() const;
+	//* The skinning data of GetSkinnedVertices in the compact layout(four quantized influences);
+	//*  the rest of a vertex is the same as Game::Vertex.
+	const Game::QuantizedSkin& GetQuantizedSkin() const;
 	const std::vector<std::uint32_t>& GetIndices() const;
 
 	const std::vector<std::pair<UINT, UINT>>& GetSubsets() const;
@@ -38,6 +56,31 @@ public:
 	UINT GetClipIndex(const std::string& inClipName) const;
 
 private:
+	//* Imports the mesh from the FBX file through the FBX SDK.
+	GameResult LoadFromFbx(const std::string& inFileName);
+	//* Loads the mesh from the memory-mapped cooked container(.cmesh).
+	//* Returns false if the container is missing, corrupted, cooked from another source(inKey)
+	//*  or doesn't match the vertex type.
+	bool LoadFromCooked(const std::string& inFileName, std::uint64_t inKey);
+	//* Writes the imported and optimized mesh to the cooked container,
+	//*  so the next launch can skip the FBX import and the optimization passes.
+	bool Cook(const std::string& inFileName, std::uint64_t inKey);
+
+	//* Reorders indices and vertices for the post-transform cache, overdraw and vertex fetch.
+	//* Reports ACMR, ATVR and overfetch before and after the optimization to ./log.txt
+	void OptimizeGeometry();
+
+	//* Keeps the four largest influences of every skinned vertex.
+	//* Reports the dropped weights to ./log.txt
+	void PruneSkinWeights();
+	//* Builds the compact skinning data from the pruned influences.
+	//* Reports the memory and the fetched bytes per vertex it saves to ./log.txt
+	void QuantizeSkinWeights();
+
+	//* Replaces the baked curves of every clip with the compressed copy before the mesh is cooked.
+	//* A clip that can't be compressed within the tolerances keeps its curves.
+	void CompressAnimations();
+
 	//* Generates vertices and indices for the skeleton.
 	//* It's organized as line-lists.
 	void GenerateSkeletonData();
@@ -49,12 +92,14 @@ private:
 
 protected:
 	Renderer* mRenderer;
+	Game::ImportCache* mImportCache;
 
 	std::string mMeshName;
 	std::vector<std::string> mDrawArgs;
 
 	std::vector<Game::Vertex> mVertices;
 	std::vector<Game::SkinnedVertex> mSkinnedVertices;
+	Game::QuantizedSkin mQuantizedSkin;
 	std::vector<std::uint32_t> mIndices;
 
 	std::vector<std::pair<UINT /* Index count */, UINT /* Start index */>> mSubsets;
@@ -70,4 +115,7 @@ protected:
 	std::vector<std::uint32_t> mSkeletonIndices;
 
 	std::unordered_map<std::string /* Clip name */, UINT /* Index */> mClipsIndex;
+
+	bool bLoadedFromCooked = false;
+	float mDecodeTime = 0.0f;
 };
\ No newline at end of file
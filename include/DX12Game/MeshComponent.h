@@ -7,6 +7,13 @@ class Mesh;
 class Renderer;
 
 class MeshComponent : public Component {
+public:
+	enum LoadPriority {
+		ELoadLow = 0,
+		ELoadNormal = 1,
+		ELoadHigh = 2
+	};
+
 public:
 	MeshComponent(Actor* inOwnerActor, int inUpdateOrder = 100);
 	virtual ~MeshComponent() = default;
@@ -15,13 +22,25 @@ public:
 	//* Called when world transform changes.
 	virtual void OnUpdateWorldTransform() override;
 
-	virtual GameResult LoadMesh(const std::string& inMeshName, const std::string& inFileName);
+	//* Requests the mesh from the world's asset loader and returns without waiting for it.
+	//* Nothing is drawn for this component until the mesh is uploaded.
+	virtual GameResult LoadMesh(const std::string& inMeshName, const std::string& inFileName, int inPriority = ELoadNormal);
 
 	//* Set visibility for the mesh for this component.
 	virtual void SetVisible(bool inStatus);
 
 	std::string GetMeshName() const;
 
+protected:
+	//* Called on the main thread once the requested mesh is uploaded.
+	virtual void OnMeshLoaded(Mesh* inMesh);
+
+	//* World transform of the mesh(the owner's transform combined with this component's).
+	DirectX::XMMATRIX GetFinalTransform() const;
+
+	//* Issues the asynchronous request; the callback is dropped if this component is destroyed first.
+	void RequestMesh(const std::string& inMeshName, const std::string& inFileName, int inPriority);
+
 protected:
 	Renderer* mRenderer;
 	Mesh* mMesh = nullptr;
@@ -29,4 +48,10 @@ protected:
 	std::string mMeshName;
 
 	bool mIsSkeletal;
+
+	// States set before the mesh is loaded are applied to the render-item once it is added.
+	bool bVisible = true;
+	bool bNeedToUpdateTransform = false;
+
+	std::shared_ptr<bool> mLoadToken;
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace Game {
+	struct VertexCacheStatistics;
+	struct VertexFetchStatistics;
+	class MeshOptimizer;
+}
+
+struct Game::VertexCacheStatistics {
+public:
+	// Number of vertices the simulated post-transform cache had to shade.
+	std::uint32_t mVerticesTransformed = 0;
+	// Average cache miss ratio(transformed vertices per triangle, 0.5 ~ 3.0).
+	float mAcmr = 0.0f;
+	// Average transform to vertex ratio(transformed vertices per unique vertex, 1.0 ~ ).
+	float mAtvr = 0.0f;
+};
+
+struct Game::VertexFetchStatistics {
+public:
+	// Number of bytes the simulated vertex fetch cache had to read from memory.
+	std::uint64_t mBytesFetched = 0;
+	// Fetched bytes over the size of the referenced vertices(1.0 is optimal).
+	float mOverfetch = 0.0f;
+};
+
+//* Pure-CPU index and vertex reordering passes that run once after a mesh is imported.
+//* All the functions work on 32-bit triangle lists and don't touch any device objects.
+class Game::MeshOptimizer {
+public:
+	static constexpr std::uint32_t InvalidIndex = 0xFFFFFFFF;
+
+	static constexpr std::uint32_t DefaultCacheSize = 16;
+	static constexpr std::uint32_t DefaultCacheLineSize = 64;
+	static constexpr std::uint32_t DefaultFetchCacheLineCount = 16;
+
+public:
+	MeshOptimizer() = default;
+	virtual ~MeshOptimizer() = default;
+
+public:
+	//* Reorders triangles to maximize post-transform cache hits(Forsyth's linear-speed algorithm).
+	static void OptimizeVertexCache(std::vector<std::uint32_t>& ioIndices, size_t inVertexCount);
+
+	//* Reorders the clusters produced by OptimizeVertexCache so that outward-facing ones are drawn first.
+	//* The clusters start at triangles that miss the cache with all three vertices, so most of the cache hits are kept;
+	//*  the hits across the cluster boundaries aren't, and AnalyzeVertexCache tells what the reordering cost.
+	static void OptimizeOverdraw(std::vector<std::uint32_t>& ioIndices,
+		const std::vector<DirectX::XMFLOAT3>& inPositions, std::uint32_t inCacheSize = DefaultCacheSize);
+
+	//* Builds a remap table that orders vertices by their first reference in the index buffer.
+	//* Unreferenced vertices are mapped to InvalidIndex.
+	//* Returns the number of vertices that remain after remapping.
+	static size_t BuildVertexFetchRemap(std::vector<std::uint32_t>& outRemap,
+		const std::vector<std::uint32_t>& inIndices, size_t inVertexCount);
+	static void RemapIndices(std::vector<std::uint32_t>& ioIndices, const std::vector<std::uint32_t>& inRemap);
+	template <typename T>
+	static void RemapVertices(std::vector<T>& ioVertices, const std::vector<std::uint32_t>& inRemap, size_t inNewVertexCount);
+
+	//* Simulates a FIFO post-transform cache.
+	static VertexCacheStatistics AnalyzeVertexCache(const std::vector<std::uint32_t>& inIndices,
+		size_t inVertexCount, std::uint32_t inCacheSize = DefaultCacheSize);
+	//* Simulates a small FIFO cache of vertex buffer lines.
+	static VertexFetchStatistics AnalyzeVertexFetch(const std::vector<std::uint32_t>& inIndices,
+		size_t inVertexCount, size_t inVertexByteSize,
+		std::uint32_t inCacheLineSize = DefaultCacheLineSize, std::uint32_t inCacheLineCount = DefaultFetchCacheLineCount);
+};
+
+#include "DX12Game/MeshOptimizer.inl"
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef __MESHOPTIMIZER_INL__
+#define __MESHOPTIMIZER_INL__
+
+template <typename T>
+void Game::MeshOptimizer::RemapVertices(std::vector<T>& ioVertices, const std::vector<std::uint32_t>& inRemap, size_t inNewVertexCount) {
+	std::vector<T> vertices(inNewVertexCount);
+
+	for (size_t i = 0, end = ioVertices.size(); i < end; ++i) {
+		if (inRemap[i] != InvalidIndex)
+			vertices[inRemap[i]] = ioVertices[i];
+	}
+
+	ioVertices.swap(vertices);
+}
+
+#endif // __MESHOPTIMIZER_INL__
\ No newline at end of file
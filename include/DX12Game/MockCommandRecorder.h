@@ -0,0 +1,38 @@
+#pragma once
+
+#include "DX12Game/DrawPacket.h"
+
+namespace Game {
+	class MockCommandRecorder;
+}
+
+//* Stands in for a graphics command list when draw streams are recorded without a device.
+//* It runs the same redundant-bind filter as the renderer's draw loop and counts
+//*  the commands that would have been recorded with and without the filter,
+//*  so the effect of a draw order can be measured headless.
+class Game::MockCommandRecorder {
+public:
+	MockCommandRecorder() = default;
+	virtual ~MockCommandRecorder() = default;
+
+public:
+	void Reset();
+
+	void SetPipelineState(const void* inPipeline);
+	void DrawIndexedInstanced(const void* inGeometry, std::uint32_t inTopology, std::uint64_t inObjectCB,
+		std::uint32_t inIndexCount, std::uint32_t inInstanceCount);
+
+	const DrawStateStatistics& GetStatistics() const;
+
+	//* Number of commands recorded after the redundant binds are skipped.
+	std::uint32_t GetNumCommands() const;
+	//* Number of commands that binding every state for every draw would record.
+	std::uint32_t GetNumNaiveCommands() const;
+	std::uint64_t GetNumIndices() const;
+
+private:
+	DrawStateCache mStateCache;
+
+	std::uint32_t mNumNaiveCommands = 0;
+	std::uint64_t mNumIndices = 0;
+};
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "DX12Game/ThreadUtil.h"
+#include "DX12Game/AnimationGraph.h"
+#include "DX12Game/PoseCache.h"
+#include "DX12Game/AnimationLod.h"
 
 #include <vector>
 #include <minwindef.h>
@@ -22,6 +25,10 @@ public:
 	void WholeLoopBeginTime(UINT tid);
 	void WholeLoopEndTime(UINT tid);
 
+	void SetAnimationGraphStatistics(const Game::AnimationGraphStatistics& inStatistics);
+	void SetPoseCacheStatistics(const Game::PoseCacheStatistics& inStatistics);
+	void SetAnimationLodStatistics(const Game::AnimationLodStatistics& inStatistics);
+
 private:
 	class Renderer* mRenderer;
 
@@ -36,4 +43,8 @@ private:
 	std::vector<TaskTimer> mDrawTimers2;
 	std::vector<TaskTimer> mWholeLoopTimers1;
 	std::vector<TaskTimer> mWholeLoopTimers2;
+
+	Game::AnimationGraphStatistics mAnimationGraphStatistics;
+	Game::PoseCacheStatistics mPoseCacheStatistics;
+	Game::AnimationLodStatistics mAnimationLodStatistics;
 };
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace Game {
+	class Animation;
+	class SkinnedData;
+
+	struct CachedPose;
+	struct PoseCacheStatistics;
+	class PoseCache;
+}
+
+struct Game::CachedPose {
+public:
+	// Time position the pose is sampled at(quantized).
+	float mTimePos = 0.0f;
+	bool bReady = false;
+
+	std::vector<DirectX::XMFLOAT4X4> mSkinningPalette;
+	std::vector<DirectX::XMFLOAT4X4> mBoneTransforms;
+};
+
+struct Game::PoseCacheStatistics {
+public:
+	// Requests of the last frame and how many of them found a pose another character asked for.
+	std::uint32_t mNumRequests = 0;
+	std::uint32_t mNumHits = 0;
+	float mHitRate = 0.0f;
+
+	// Distinct poses sampled in the last update, poses kept alive and poses dropped.
+	std::uint32_t mNumSampled = 0;
+	std::uint32_t mNumEntries = 0;
+	std::uint32_t mNumEvicted = 0;
+};
+
+//* Shares the CPU poses of the characters that play the same clip of the same skeleton at about the same time.
+//* A request quantizes the time position and counts a reference to the pose of its key(skeleton, clip, time);
+//*  Update samples the new poses once each and drops the poses nothing requested in the last two updates.
+//* A pose returned by Request is sampled by the next Update and stays valid until the second Update after it,
+//*  so the characters read what they requested the frame before, and the pose a character still shows
+//*  until its next request isn't dropped under the game threads that read it.
+class Game::PoseCache {
+public:
+	PoseCache() = default;
+	virtual ~PoseCache() = default;
+
+private:
+	PoseCache(const PoseCache& src) = delete;
+	PoseCache& operator=(const PoseCache& rhs) = delete;
+	PoseCache(PoseCache&& src) = delete;
+	PoseCache& operator=(PoseCache&& rhs) = delete;
+
+public:
+	//* Poses closer in time than inTimeStep frames are shared(0.5 frames by default).
+	void SetTimeStep(float inTimeStep);
+	float QuantizeTime(float inTimePos) const;
+
+	//* May be called from any game thread.
+	//* inBoneMask(AnimationLod::GetBoneMask) must outlive the pose; the poses of each mask are shared separately.
+	const Game::CachedPose* Request(const Game::SkinnedData* inSkinnedData, const Game::Animation* inAnimation, float inTimePos,
+		const std::vector<std::uint32_t>* inBoneMask = nullptr);
+
+	//* Must be called while no game thread requests or reads poses.
+	void Update();
+
+	PoseCacheStatistics GetStatistics() const;
+
+private:
+	struct Key {
+		const Game::SkinnedData* mSkinnedData;
+		const Game::Animation* mAnimation;
+		const std::vector<std::uint32_t>* mBoneMask;
+		std::int32_t mTimeIndex;
+
+		bool operator==(const Key& inOther) const;
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key& inKey) const;
+	};
+
+	struct Entry {
+		Key mKey;
+		// Requests since the last update and in the update before it.
+		std::uint32_t mRefCount = 0;
+		std::uint32_t mPrevRefCount = 0;
+		bool bInUse = false;
+		Game::CachedPose mPose;
+	};
+
+	std::int32_t GetTimeIndex(float inTimePos) const;
+
+private:
+	mutable std::mutex mMutex;
+
+	float mTimeStep = 0.5f;
+
+	// Entries are never freed, so the poses handed out don't move; evicted ones are reused.
+	std::vector<std::unique_ptr<Entry>> mEntries;
+	std::vector<std::uint32_t> mFreeEntries;
+	std::unordered_map<Key, std::uint32_t, KeyHash> mEntryIds;
+
+	// Entries created since the last update.
+	std::vector<Entry*> mPendingEntries;
+
+	std::uint32_t mNumRequests = 0;
+	std::uint32_t mNumHits = 0;
+
+	PoseCacheStatistics mStatistics;
+};
\ No newline at end of file
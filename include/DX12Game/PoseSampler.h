@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace Game {
+	class Animation;
+	class SkinnedData;
+
+	struct PoseTerm;
+	struct PoseJob;
+	class PoseSampler;
+}
+
+//* A weighted clip sample; a blended pose is the weighted sum of the skinning matrices of its terms.
+struct Game::PoseTerm {
+public:
+	const Game::Animation* mAnimation = nullptr;
+	// Index of the clip in the animations map(Mesh::GetClipIndex).
+	std::uint32_t mClipIndex = 0;
+	float mTimePos = 0.0f;
+	float mWeight = 0.0f;
+};
+
+struct Game::PoseJob {
+public:
+	const Game::SkinnedData* mSkinnedData = nullptr;
+	const Game::Animation* mAnimation = nullptr;
+	// Fractional frame index(SkinnedData::GetTimePosition).
+	float mTimePos = 0.0f;
+
+	// Blended instead of (mAnimation, mTimePos) if not null.
+	const Game::PoseTerm* mTerms = nullptr;
+	size_t mNumTerms = 0;
+
+	// Bone index -> the bone whose skinning matrix it takes(AnimationLod::GetBoneMask); all bones are sampled if null.
+	const std::uint32_t* mBoneMask = nullptr;
+	size_t mBoneMaskSize = 0;
+
+	// Skinning matrices(bind pose to animated mesh space), one per track of the clip(the largest of the terms).
+	DirectX::XMFLOAT4X4* mSkinningPalette = nullptr;
+	// Mesh-space transforms of the bones, one per bone of the skeleton(may be null).
+	DirectX::XMFLOAT4X4* mBoneTransforms = nullptr;
+};
+
+//* Evaluates the baked clips on the CPU the way the skinning shaders read the animations map;
+//*  the two baked frames around the time position are blended matrix by matrix,
+//*  so the palette matches what the GPU draws and the bone transforms match the skeleton pass.
+//* This class doesn't depend on any device objects.
+class Game::PoseSampler {
+public:
+	PoseSampler() = default;
+	virtual ~PoseSampler() = default;
+
+public:
+	//* Samples a pose on the calling thread.
+	static void Sample(const PoseJob& inJob);
+	//* Samples the poses as parallel jobs; the jobs must not share outputs.
+	static void SampleBatch(const std::vector<PoseJob>& inJobs);
+
+	//* Number of matrices PoseJob::mSkinningPalette must hold for inAnimation.
+	static size_t GetPaletteSize(const Game::Animation& inAnimation);
+
+private:
+	static void SampleClip(const Game::Animation& inAnimation, float inTimePos, DirectX::XMFLOAT4X4* outPalette,
+		const std::uint32_t* inBoneMask = nullptr, size_t inBoneMaskSize = 0);
+	static void SampleTerms(const PoseJob& inJob, size_t inNumTracks);
+	static void ApplyBoneMask(const PoseJob& inJob, size_t inNumTracks);
+};
\ No newline at end of file
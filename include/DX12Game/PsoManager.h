@@ -7,6 +7,10 @@ public:
 	enum InputLayouts {
 		EBasic,
 		ESkinned,
+		// SkinnedVertex in slot 0(only the attributes before the skinning data) and the quantized skin
+		//  stream in slot 1, with 8-bit weights and 8- or 16-bit bone indices.
+		EQuantizedSkinned8,
+		EQuantizedSkinned16,
 		ENone
 	};
 
@@ -68,6 +72,8 @@ private:
 
 	std::vector<D3D12_INPUT_ELEMENT_DESC> mInputLayout;
 	std::vector<D3D12_INPUT_ELEMENT_DESC> mSkinnedInputLayout;
+	std::vector<D3D12_INPUT_ELEMENT_DESC> mQuantizedSkinnedInputLayout8;
+	std::vector<D3D12_INPUT_ELEMENT_DESC> mQuantizedSkinnedInputLayout16;
 
 	std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D12PipelineState>> mPSOs;
 };
\ No newline at end of file
@@ -7,6 +7,7 @@ class Mesh;
 
 namespace Game {
 	class Animation;
+	struct PoseTerm;
 }
 
 const size_t gNumBones = 512;
@@ -61,6 +62,13 @@ public:
 				const DirectX::XMMATRIX& inTransform, bool inIsSkeletal) = 0;
 	virtual void UpdateInstanceAnimationData(const std::string& inRenderItemName,
 				UINT inAnimClipIdx, float inTimePos, bool inIsSkeletal) = 0;
+	//* Blends up to four weighted clip samples(AnimationGraph::GetGpuTerms) instead of a single one.
+	virtual void UpdateInstanceAnimationBlend(const std::string& inRenderItemName,
+				const Game::PoseTerm* inTerms, UINT inNumTerms) = 0;
+	//* UpdateInstanceAnimationData that the shaders play on at inTimeRate frames per second from inTimeBase(the total time),
+	//*  wrapped at the frame inTimeEnd, until the next update.
+	virtual void UpdateInstanceAnimationPlayback(const std::string& inRenderItemName,
+				UINT inAnimClipIdx, float inTimePos, float inTimeRate, float inTimeBase, float inTimeEnd) = 0;
 
 	virtual void SetVisible(const std::string& inRenderItemName, bool inState) = 0;
 	virtual void SetSkeletonVisible(const std::string& inRenderItemName, bool inState) = 0;
@@ -69,7 +77,8 @@ public:
 	virtual void AddRenderItem(std::string& ioRenderItemName, const Mesh* inMesh) = 0;
 	virtual GameResult AddMaterials(const std::unordered_map<std::string, MaterialIn>& inMaterials) = 0;
 
-	virtual UINT AddAnimations(const std::string& inClipName, const Game::Animation& inAnim) = 0;
+	virtual GameResult AddAnimations(const std::string& inClipName, const Game::Animation& inAnim, UINT& outClipIndex) = 0;
+	virtual void RemoveAnimations(UINT inClipIndex) = 0;
 	virtual GameResult UpdateAnimationsMap() = 0;
 
 	void AddOutputText(const std::string& inNameId, const std::wstring& inText,
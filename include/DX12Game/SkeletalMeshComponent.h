@@ -1,30 +1,91 @@
 #pragma once
 
 #include "DX12Game/MeshComponent.h"
+#include "DX12Game/CpuSkinning.h"
 
 class Actor;
 
+namespace Game {
+	class AnimationGraph;
+	class AnimationLod;
+	struct CachedPose;
+}
+
 class SkeletalMeshComponent : public MeshComponent {
 public:
 	SkeletalMeshComponent(Actor* inOwnerActor);
-	virtual ~SkeletalMeshComponent() = default;
+	virtual ~SkeletalMeshComponent();
 
 public:
 	//* Called when world transform changes.
 	virtual void OnUpdateWorldTransform() override;
 	//* Update this component by delta time.
 	virtual void Update(const GameTimer& gt) override;
-	virtual GameResult LoadMesh(const std::string& inMeshName, const std::string& inFileName) override;
+	virtual GameResult LoadMesh(const std::string& inMeshName, const std::string& inFileName, int inPriority = ELoadNormal) override;
 
 	void SetClipName(const std::string& inClipName);
 	virtual void SetVisible(bool inState) override;
 	void SetSkeleletonVisible(bool inState);
 
+	//* Samples the pose on the CPU every frame as well, so gameplay code can read the bones.
+	//* Disabled by default; the shaders don't need it.
+	//* A single clip is shared through the pose cache of the world with the characters at the same pose,
+	//*  so the bones lag a frame behind and snap to its time step.
+	void SetCpuPoseEnabled(bool inState);
+	//* Returns -1 if the mesh isn't loaded or has no such bone.
+	int FindBoneIndex(const std::string& inBoneName) const;
+	//* Mesh-space transform of a bone as of the last pose(the bind pose until the CPU pose is enabled).
+	bool GetBoneTransform(int inBoneIndex, DirectX::XMFLOAT4X4& outTransform) const;
+	//* World-space position of a bone as of the last pose.
+	bool GetBoneWorldPosition(int inBoneIndex, DirectX::XMFLOAT3& outPosition) const;
+	const std::vector<DirectX::XMFLOAT4X4>& GetSkinningPalette() const;
+	//* Deforms the mesh-space vertices by the last CPU pose for picking, bounds and attachment queries.
+	//* Returns false until the CPU pose is enabled and sampled; outNormals may be null.
+	bool SkinVertices(std::vector<DirectX::XMFLOAT3>& outPositions, std::vector<DirectX::XMFLOAT3>* outNormals,
+		Game::SkinningResult& outResult, Game::SkinningJob::EMethod inMethod = Game::SkinningJob::ELinearBlend) const;
+
+	//* Level of the animation LOD(GameWorld::GetAnimationLod) the clip was played at in the last update.
+	//* A graph-driven mesh is always updated at full detail.
+	std::uint32_t GetLodLevel() const;
+
+	//* Drives the mesh by a graph(evaluated with the other characters once a frame) instead of SetClipName.
+	//* The graph is owned by this component and bound to the mesh once it is loaded.
+	Game::AnimationGraph* CreateAnimationGraph();
+	Game::AnimationGraph* GetAnimationGraph() const;
+
+protected:
+	virtual void OnMeshLoaded(Mesh* inMesh) override;
+
+private:
+	void RequestCpuPose(float inTimePos);
+	void UpdateGraphPoseOutput();
+	void UpdateLodLevel(Game::AnimationLod* inAnimationLod);
+
 private:
 	std::vector<DirectX::XMFLOAT4X4> mBoneTransforms;
+	std::vector<DirectX::XMFLOAT4X4> mSkinningPalette;
 
 	std::string mClipName;
+	std::unique_ptr<Game::AnimationGraph> mAnimationGraph;
+
+	// The pose read until the next request and the one requested for the frame after it;
+	//  the cache keeps both alive as long as they are requested every frame.
+	const Game::CachedPose* mCachedPose = nullptr;
+	const Game::CachedPose* mRequestedPose = nullptr;
 
 	float mLastTotalTime;
 	bool mClipIsChanged;
+
+	// Stagger slot and level in the animation LOD, and the bind-pose bounding sphere it measures in mesh space.
+	std::uint32_t mLodSlot = 0;
+	std::uint32_t mLodLevel = 0;
+	DirectX::XMFLOAT3 mLodCenter = { 0.0f, 0.0f, 0.0f };
+	float mLodRadius = 0.0f;
+	// Leaf bones the CPU pose of the level masks(null at full detail).
+	const std::vector<std::uint32_t>* mBoneMask = nullptr;
+	// Time position of the last update, requested again while the LOD skips updates.
+	float mLastTimePos = 0.0f;
+
+	bool bSkeletonVisible = true;
+	bool bCpuPoseEnabled = false;
 };
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Game {
+	struct SkinnedVertex;
+
+	struct SkinWeightPruneStatistics;
+	struct QuantizedSkin;
+	struct SkinWeightQuantizeStatistics;
+	class SkinWeights;
+}
+
+struct Game::SkinWeightPruneStatistics {
+public:
+	std::uint32_t mNumVertices = 0;
+	// Vertices that had more influences than kept.
+	std::uint32_t mNumPrunedVertices = 0;
+	// Weight dropped from a vertex before renormalization(largest and average over the pruned vertices).
+	float mMaxDroppedWeight = 0.0f;
+	float mAverageDroppedWeight = 0.0f;
+};
+
+//* Four weights and four bone indices per vertex, interleaved(weights first) with the stride mStride.
+//* The weights are unorm(DXGI_FORMAT_R8G8B8A8_UNORM or R16G16B16A16_UNORM) and the indices are
+//*  unsigned integers(DXGI_FORMAT_R8G8B8A8_UINT or R16G16B16A16_UINT); an unused influence has the weight 0.
+struct Game::QuantizedSkin {
+public:
+	std::uint32_t mWeightBits = 8;
+	std::uint32_t mIndexBits = 8;
+	std::uint32_t mStride = 0;
+
+	std::vector<std::uint8_t> mData;
+};
+
+struct Game::SkinWeightQuantizeStatistics {
+public:
+	// Largest difference between a source weight and its dequantized value.
+	float mMaxWeightError = 0.0f;
+
+	// Skinning bytes per vertex and for the whole mesh, in the float layout and the quantized one.
+	std::uint32_t mSourceStride = 0;
+	std::uint32_t mQuantizedStride = 0;
+	std::uint64_t mSourceBytes = 0;
+	std::uint64_t mQuantizedBytes = 0;
+};
+
+//* Import-time passes that shrink the skinning data of SkinnedVertex.
+//* The functions don't touch any device objects.
+class Game::SkinWeights {
+public:
+	static constexpr std::uint32_t MaxInfluences = 8;
+	static constexpr std::uint32_t MaxQuantizedInfluences = 4;
+
+public:
+	SkinWeights() = default;
+	virtual ~SkinWeights() = default;
+
+public:
+	//* Keeps the inMaxInfluences largest weights of every vertex and renormalizes them;
+	//*  the freed slots get the weight 0 and the index -1, so the vertex format doesn't change.
+	static SkinWeightPruneStatistics Prune(std::vector<Game::SkinnedVertex>& ioVertices,
+		std::uint32_t inMaxInfluences = MaxQuantizedInfluences);
+
+	//* Quantizes the first four influences of every vertex(call Prune first).
+	//* inWeightBits is 8 or 16; the indices take 8 bits if inNumBones fits, otherwise 16.
+	//* The quantized weights of a vertex always sum up to exactly 1.
+	static SkinWeightQuantizeStatistics Quantize(const std::vector<Game::SkinnedVertex>& inVertices,
+		std::uint32_t inNumBones, std::uint32_t inWeightBits, Game::QuantizedSkin& outSkin);
+
+	static void Dequantize(const Game::QuantizedSkin& inSkin, size_t inVertex,
+		float outWeights[MaxQuantizedInfluences], std::uint32_t outIndices[MaxQuantizedInfluences]);
+};
\ No newline at end of file
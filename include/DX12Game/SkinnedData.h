@@ -1,6 +1,7 @@
 #pragma once
 
 #include "DX12Game/GameCore.h"
+#include "DX12Game/AnimationCompression.h"
 
 namespace Game {
 	struct Bone;
@@ -40,6 +41,12 @@ public:
 	Animation() = default;
 	virtual ~Animation() = default;
 
+public:
+	size_t GetNumTracks() const;
+	//* Writes the transforms of a baked frame(GetNumTracks() elements),
+	//*  decompressed from mCompressed once the raw curves are released.
+	void GetFrame(size_t inFrame, DirectX::XMFLOAT4X4* outTransforms) const;
+
 public:
 	// Number of bones for the animation.
 	//size_t mNumBones;
@@ -51,6 +58,8 @@ public:
 	float mFrameDuration;
 
 	std::vector<std::vector<DirectX::XMFLOAT4X4>> mCurves;
+	// Built from mCurves when the mesh is imported and stored in the cooked container.
+	Game::CompressedAnimation mCompressed;
 };
 
 class Game::SkinnedData {
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace Game {
+	struct TextureResidencyChange;
+	struct TextureResidencyStatistics;
+	class TextureResidency;
+}
+
+struct Game::TextureResidencyChange {
+public:
+	std::uint32_t mHandle = 0;
+	// The texture has to hold the mip levels [mFirstMip, number of mips) from now on.
+	std::uint32_t mFirstMip = 0;
+	std::uint32_t mPrevFirstMip = 0;
+};
+
+struct Game::TextureResidencyStatistics {
+public:
+	std::uint32_t mNumTextures = 0;
+	// Textures that are not at their requested mip level.
+	std::uint32_t mNumPending = 0;
+	std::uint64_t mResidentBytes = 0;
+	std::uint64_t mBudgetBytes = 0;
+	// Changes of the last Update.
+	std::uint32_t mNumLoads = 0;
+	std::uint32_t mNumEvictions = 0;
+	std::uint64_t mLoadedBytes = 0;
+};
+
+//* Decides which mip levels of the streamed textures are resident.
+//* Every texture keeps a tail of its coarsest levels resident, so it always has something to sample.
+//* The renderer reports the screen-space UV density of what it draws(Request) and, once per frame,
+//*  Update raises the residency of the requested textures one level at a time, so the lower mips
+//*  arrive first; when the budget is exceeded, the least recently requested textures are lowered.
+//* This class only does the bookkeeping and doesn't touch any device objects.
+class Game::TextureResidency {
+public:
+	using Handle = std::uint32_t;
+
+	static constexpr Handle InvalidHandle = 0xFFFFFFFF;
+
+public:
+	TextureResidency() = default;
+	virtual ~TextureResidency() = default;
+
+private:
+	TextureResidency(const TextureResidency& src) = delete;
+	TextureResidency(TextureResidency&& src) = delete;
+	TextureResidency& operator=(const TextureResidency& rhs) = delete;
+	TextureResidency& operator=(TextureResidency&& rhs) = delete;
+
+public:
+	//* Limit of the bytes of all the resident levels; the tails are always counted
+	//*  even if they exceed it.
+	void SetBudget(std::uint64_t inBytes);
+	std::uint64_t GetBudget() const;
+
+	//* inMipByteSizes holds the bytes of each mip level(finest first) over all array slices.
+	//* The levels from inTailMip on stay resident and are assumed to be loaded already.
+	Handle Register(std::uint32_t inWidth, const std::vector<std::uint64_t>& inMipByteSizes, std::uint32_t inTailMip);
+
+	//* Reports that the texture is sampled at inUVPerPixel(UV units per screen pixel) this frame.
+	//* Can be called from any thread between the calls of Update.
+	void Request(Handle inHandle, float inUVPerPixel);
+
+	//* Applies the requests of the frame and returns the textures whose resident levels are changed.
+	//* At most inMaxLoadBytes of new levels are made resident per call(at least one level).
+	void Update(std::uint64_t inMaxLoadBytes, std::vector<TextureResidencyChange>& outChanges);
+
+	std::uint32_t GetFirstResidentMip(Handle inHandle) const;
+	std::uint32_t GetNumMips(Handle inHandle) const;
+
+	TextureResidencyStatistics GetStatistics() const;
+
+	//* The finest mip level that isn't magnified at inTexelsPerPixel texels of the top level per pixel.
+	static std::uint32_t ComputeMip(float inTexelsPerPixel, std::uint32_t inNumMips);
+
+private:
+	struct Entry {
+		std::uint32_t mWidth = 0;
+		std::uint32_t mTailMip = 0;
+		std::uint32_t mFirstResidentMip = 0;
+		std::uint32_t mDesiredMip = 0;
+		std::uint64_t mLastRequestedFrame = 0;
+		// mSuffixBytes[i] is the bytes of the levels [i, number of mips).
+		std::vector<std::uint64_t> mSuffixBytes;
+
+		// The finest level requested since the last Update, NoRequest if none.
+		std::atomic<std::uint32_t> mRequestedMip;
+
+		Entry();
+	};
+
+	static constexpr std::uint32_t NoRequest = 0xFFFFFFFF;
+
+	std::uint64_t GetResidentBytes(const Entry& inEntry, std::uint32_t inFirstMip) const;
+	//* Lowers the residency of other textures until inRequiredBytes fit in the budget.
+	//* The textures requested this frame are only lowered to their desired levels.
+	bool MakeRoom(std::uint64_t inRequiredBytes, Handle inExcept, std::vector<std::uint32_t>& ioFirstMips);
+
+private:
+	// std::deque doesn't move the entries(and their atomics) on growth.
+	std::deque<Entry> mEntries;
+
+	std::uint64_t mBudget = 0;
+	std::uint64_t mResidentBytes = 0;
+	std::uint64_t mFrame = 0;
+
+	TextureResidencyStatistics mLastStats;
+};
\ No newline at end of file
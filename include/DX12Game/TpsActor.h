@@ -1,6 +1,7 @@
 #pragma once
 
 #include "DX12Game/Actor.h"
+#include "DX12Game/AnimationGraph.h"
 
 class SkeletalMeshComponent;
 class CameraComponent;
@@ -26,6 +27,11 @@ private:
 	const float mRunningSpeed;
 	float mCurrSpeed;
 
+	// Drives the locomotion blend space; eases towards the moving speed so the clips don't pop.
+	Game::AnimationGraph::ParameterId mSpeedParameter;
+	float mAnimationSpeed;
+	const float mAnimationSpeedRate;
+
 	float mAzimuth;
 	float mYAngularSpeed;
 
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Game {
+	class VertexWelder;
+}
+
+//* Welds identical vertices with an open-addressing hash table.
+//* A vertex is seen as a run of 32-bit words: the leading float words are quantized
+//*  by rounding off the low mantissa bits(and flushing tiny values and -0.0 to +0.0),
+//*  the remaining words(e.g. bone indices) are compared bit by bit.
+//* Two vertices are welded if all their quantized words are equal, so the weld is
+//*  transitive and the hash is consistent with the comparison.
+//* This class doesn't depend on the FBX SDK or any device objects.
+class Game::VertexWelder {
+public:
+	static constexpr std::uint32_t InvalidIndex = 0xFFFFFFFF;
+
+	// Number of low mantissa bits rounded off before hashing(0 keeps the exact bit patterns).
+	static constexpr std::uint32_t DefaultQuantizationBits = 4;
+	// Float words with a smaller magnitude are treated as zero.
+	static constexpr float DefaultZeroThreshold = 1e-8f;
+
+public:
+	VertexWelder() = default;
+	virtual ~VertexWelder() = default;
+
+public:
+	void Initialize(std::uint32_t inNumWords, std::uint32_t inNumFloatWords, size_t inExpectedVertexCount = 0,
+		std::uint32_t inQuantizationBits = DefaultQuantizationBits, float inZeroThreshold = DefaultZeroThreshold);
+
+	//* Returns the index of the unique vertex the words are welded to.
+	//* If no such vertex exists, the vertex is added and outInserted is set to true.
+	std::uint32_t Weld(const std::uint32_t* inWords, bool& outInserted);
+
+	std::uint32_t GetNumUniqueVertices() const;
+
+	void Clear();
+
+	//* Welds the vertex stream into unique vertices and indices(first occurrence order).
+	//* T must be trivially copyable and consist of 32-bit words whose first inNumFloatWords are floats.
+	template <typename T>
+	static void WeldVertices(const std::vector<T>& inVertices, std::uint32_t inNumFloatWords,
+		std::vector<T>& outVertices, std::vector<std::uint32_t>& outIndices);
+
+	//* Welds each submesh on its own thread, then merges the local results in submesh order.
+	//* The result is the same as welding all the submeshes in sequence with WeldVertices,
+	//*  and the indices of each submesh stay contiguous in submesh order.
+	template <typename T>
+	static void WeldSubmeshes(const std::vector<std::vector<T>>& inSubmeshVertices, std::uint32_t inNumFloatWords,
+		std::uint32_t inNumThreads, std::vector<T>& outVertices, std::vector<std::uint32_t>& outIndices);
+
+private:
+	void Quantize(const std::uint32_t* inWords, std::uint32_t* outWords) const;
+	std::uint64_t Hash(const std::uint32_t* inWords) const;
+
+	//* Resizes the table and re-inserts the unique vertices with their stored hashes.
+	void Rehash(size_t inCapacity);
+
+private:
+	std::uint32_t mNumWords = 0;
+	std::uint32_t mNumFloatWords = 0;
+	std::uint32_t mRoundBias = 0;
+	std::uint32_t mRoundMask = 0xFFFFFFFF;
+	float mZeroThreshold = DefaultZeroThreshold;
+
+	// Slots hold the upper 32 bits of the hash and (unique vertex index + 1) in the lower 32 bits,
+	//  zero marks an empty slot. The hash bits reject mismatches without touching the keys.
+	std::vector<std::uint64_t> mSlots;
+	// Hash of each unique vertex, used for rehashing.
+	std::vector<std::uint64_t> mHashes;
+	// Quantized words of the unique vertices(mNumWords per vertex).
+	std::vector<std::uint32_t> mKeys;
+
+	std::vector<std::uint32_t> mScratch;
+};
+
+#include "DX12Game/VertexWelder.inl"
\ No newline at end of file
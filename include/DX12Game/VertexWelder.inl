@@ -0,0 +1,94 @@
+#ifndef __VERTEXWELDER_INL__
+#define __VERTEXWELDER_INL__
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <type_traits>
+
+template <typename T>
+void Game::VertexWelder::WeldVertices(const std::vector<T>& inVertices, std::uint32_t inNumFloatWords,
+		std::vector<T>& outVertices, std::vector<std::uint32_t>& outIndices) {
+	static_assert(std::is_trivially_copyable<T>::value && sizeof(T) % sizeof(std::uint32_t) == 0,
+		"Welded vertices must be trivially copyable 32-bit words");
+
+	VertexWelder welder;
+	welder.Initialize(static_cast<std::uint32_t>(sizeof(T) / sizeof(std::uint32_t)), inNumFloatWords, inVertices.size());
+
+	outVertices.clear();
+	outIndices.resize(inVertices.size());
+
+	for (size_t i = 0, end = inVertices.size(); i < end; ++i) {
+		bool inserted;
+		outIndices[i] = welder.Weld(reinterpret_cast<const std::uint32_t*>(&inVertices[i]), inserted);
+		if (inserted)
+			outVertices.push_back(inVertices[i]);
+	}
+}
+
+template <typename T>
+void Game::VertexWelder::WeldSubmeshes(const std::vector<std::vector<T>>& inSubmeshVertices, std::uint32_t inNumFloatWords,
+		std::uint32_t inNumThreads, std::vector<T>& outVertices, std::vector<std::uint32_t>& outIndices) {
+	const size_t numSubmeshes = inSubmeshVertices.size();
+
+	std::vector<std::vector<T>> localVertices(numSubmeshes);
+	std::vector<std::vector<std::uint32_t>> localIndices(numSubmeshes);
+
+	// Submeshes are handed out one by one, so a large submesh doesn't hold back the others.
+	std::atomic<size_t> nextSubmesh(0);
+	auto weldFunc = [&]() -> void {
+		for (size_t i = nextSubmesh++; i < numSubmeshes; i = nextSubmesh++)
+			WeldVertices(inSubmeshVertices[i], inNumFloatWords, localVertices[i], localIndices[i]);
+	};
+
+	size_t numThreads = std::min(static_cast<size_t>(std::max(inNumThreads, 1u)), numSubmeshes);
+	if (numThreads > 1) {
+		std::vector<std::thread> threads;
+		for (size_t i = 1; i < numThreads; ++i)
+			threads.emplace_back(weldFunc);
+
+		weldFunc();
+
+		for (auto& thread : threads)
+			thread.join();
+	}
+	else {
+		weldFunc();
+	}
+
+	// Local unique vertices keep their first occurrence order, so welding them in submesh order
+	//  visits the global unique vertices in the same order as a sequential weld does.
+	// Quantization is idempotent, so the local representatives weld exactly like the originals.
+	size_t numLocalVertices = 0;
+	size_t numIndices = 0;
+	for (size_t i = 0; i < numSubmeshes; ++i) {
+		numLocalVertices += localVertices[i].size();
+		numIndices += localIndices[i].size();
+	}
+
+	VertexWelder welder;
+	welder.Initialize(static_cast<std::uint32_t>(sizeof(T) / sizeof(std::uint32_t)), inNumFloatWords, numLocalVertices);
+
+	outVertices.clear();
+	outVertices.reserve(numLocalVertices);
+	outIndices.clear();
+	outIndices.reserve(numIndices);
+
+	std::vector<std::uint32_t> remap;
+	for (size_t i = 0; i < numSubmeshes; ++i) {
+		const auto& vertices = localVertices[i];
+
+		remap.resize(vertices.size());
+		for (size_t j = 0, end = vertices.size(); j < end; ++j) {
+			bool inserted;
+			remap[j] = welder.Weld(reinterpret_cast<const std::uint32_t*>(&vertices[j]), inserted);
+			if (inserted)
+				outVertices.push_back(vertices[j]);
+		}
+
+		for (auto index : localIndices[i])
+			outIndices.push_back(remap[index]);
+	}
+}
+
+#endif // __VERTEXWELDER_INL__
\ No newline at end of file
@@ -65,6 +65,10 @@ public:
 		const DirectX::XMMATRIX& inTransform, bool inIsSkeletal) override;
 	virtual void UpdateInstanceAnimationData(const std::string& inRenderItemName,
 		UINT inAnimClipIdx, float inTimePos, bool inIsSkeletal) override;
+	virtual void UpdateInstanceAnimationBlend(const std::string& inRenderItemName,
+		const Game::PoseTerm* inTerms, UINT inNumTerms) override;
+	virtual void UpdateInstanceAnimationPlayback(const std::string& inRenderItemName,
+		UINT inAnimClipIdx, float inTimePos, float inTimeRate, float inTimeBase, float inTimeEnd) override;
 
 	virtual void SetVisible(const std::string& inRenderItemName, bool inState) override;
 	virtual void SetSkeletonVisible(const std::string& inRenderItemName, bool inState) override;
@@ -73,7 +77,8 @@ public:
 	virtual void AddRenderItem(std::string& ioRenderItemName, const Mesh* inMesh) override;
 	virtual GameResult AddMaterials(const std::unordered_map<std::string, MaterialIn>& inMaterials) override;
 
-	virtual UINT AddAnimations(const std::string& inClipName, const Game::Animation& inAnim) override;
+	virtual GameResult AddAnimations(const std::string& inClipName, const Game::Animation& inAnim, UINT& outClipIndex) override;
+	virtual void RemoveAnimations(UINT inClipIndex) override;
 	virtual GameResult UpdateAnimationsMap() override;
 
 protected:
@@ -4,6 +4,7 @@
 #include "common/MathHelper.h"
 #include "common/UploadBuffer.h"
 #include "common/GeometryGenerator.h"
+#include "common/TextModelLoader.h"
 #include "FrameResource.h"
 
 //#define Ex1
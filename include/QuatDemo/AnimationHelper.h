@@ -9,36 +9,36 @@
 
 #include "common/d3dUtil.h"
 
-///<summary>
-/// A Keyframe defines the bone transformation at an instant in time.
-///</summary>
-struct Keyframe
-{
-	Keyframe();
-	~Keyframe();
-
-    float TimePos;
-	DirectX::XMFLOAT3 Translation;
-    DirectX::XMFLOAT3 Scale;
-    DirectX::XMFLOAT4 RotationQuat;
-};
-
 ///<summary>
 /// A BoneAnimation is defined by a list of keyframes.  For time
 /// values inbetween two keyframes, we interpolate between the
 /// two nearest keyframes that bound the time.  
 ///
 /// We assume an animation always has two keyframes.
+///
+/// The keyframes are stored as separate streams, so the key search
+/// only walks the times and the interpolation only touches the two
+/// keys it blends.
 ///</summary>
 struct BoneAnimation
 {
 	float GetStartTime()const;
 	float GetEndTime()const;
 
-    void Interpolate(float t, DirectX::XMFLOAT4X4& M)const;
-
-	std::vector<Keyframe> Keyframes; 	
+	UINT GetNumKeyframes()const;
+	// Resizes every stream; new keys are identity transforms at time 0.
+	void Resize(UINT numKeyframes);
 
+	// Searches the keys from the start.
+    void Interpolate(float t, DirectX::XMFLOAT4X4& M)const;
+	// keyIndex is the key the last call started from and is updated for the next one;
+	// playing forward only checks the next keys, a seek falls back to a binary search.
+	void Interpolate(float t, DirectX::XMFLOAT4X4& M, UINT& keyIndex)const;
+
+	std::vector<float> TimePositions;
+	std::vector<DirectX::XMFLOAT3> Translations;
+	std::vector<DirectX::XMFLOAT3> Scales;
+	std::vector<DirectX::XMFLOAT4> RotationQuats;
 };
 
 #endif // ANIMATION_HELPER_H
\ No newline at end of file
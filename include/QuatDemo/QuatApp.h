@@ -6,6 +6,7 @@
 #include "common/MathHelper.h"
 #include "common/UploadBuffer.h"
 #include "common/GeometryGenerator.h"
+#include "common/TextModelLoader.h"
 #include "common/Camera.h"
 #include "FrameResource.h"
 #include "AnimationHelper.h"
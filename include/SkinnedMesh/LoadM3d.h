@@ -42,6 +42,8 @@ public:
         std::string NormalMapName;
     };
 
+	// Both overloads accept the text format and the binary format written by ConvertM3dToBinary;
+	// the format is detected from the file contents.
 	bool LoadM3d(const std::string& filename, 
 		std::vector<Vertex>& vertices,
 		std::vector<USHORT>& indices,
@@ -54,16 +56,39 @@ public:
 		std::vector<M3dMaterial>& mats,
 		SkinnedData& skinInfo);
 
+	// Writes the binary variant of a text m3d file.
+	// Every value of the text file is kept, so loading either file gives the same result.
+	bool ConvertM3dToBinary(const std::string& srcFilename, const std::string& dstFilename);
+
 private:
-	void ReadMaterials(std::ifstream& fin, UINT numMaterials, std::vector<M3dMaterial>& mats);
-	void ReadSubsetTable(std::ifstream& fin, UINT numSubsets, std::vector<Subset>& subsets);
-	void ReadVertices(std::ifstream& fin, UINT numVertices, std::vector<Vertex>& vertices);
-	void ReadSkinnedVertices(std::ifstream& fin, UINT numVertices, std::vector<SkinnedVertex>& vertices);
-	void ReadTriangles(std::ifstream& fin, UINT numTriangles, std::vector<USHORT>& indices);
-	void ReadBoneOffsets(std::ifstream& fin, UINT numBones, std::vector<DirectX::XMFLOAT4X4>& boneOffsets);
-	void ReadBoneHierarchy(std::ifstream& fin, UINT numBones, std::vector<int>& boneIndexToParentIndex);
-	void ReadAnimationClips(std::ifstream& fin, UINT numBones, UINT numAnimationClips, std::unordered_map<std::string, AnimationClip>& animations);
-	void ReadBoneKeyframes(std::ifstream& fin, UINT numBones, BoneAnimation& boneAnimation);
+	// Superset of Vertex and SkinnedVertex holding every vertex value of the file.
+	struct M3dVertex {
+		DirectX::XMFLOAT3 Pos;
+		DirectX::XMFLOAT4 TangentU;
+		DirectX::XMFLOAT3 Normal;
+		DirectX::XMFLOAT2 TexC;
+		float BoneWeights[4];
+		int BoneIndices[4];
+	};
+
+	struct M3dFile {
+		bool Skinned = false;
+
+		std::vector<M3dMaterial> Materials;
+		std::vector<Subset> Subsets;
+		std::vector<M3dVertex> Vertices;
+		std::vector<UINT> Indices;
+		std::vector<DirectX::XMFLOAT4X4> BoneOffsets;
+		std::vector<int> BoneHierarchy;
+		std::unordered_map<std::string, AnimationClip> Animations;
+	};
+
+	bool ReadM3d(const std::string& filename, M3dFile& file);
+	bool ParseText(const char* data, size_t size, M3dFile& file);
+	bool ParseBinary(const char* data, size_t size, M3dFile& file);
+	// Checks the values that index other parts of the file, so a damaged file is rejected instead of read out of bounds.
+	bool Validate(const M3dFile& file);
+	void CopyIndices(const M3dFile& file, std::vector<USHORT>& indices);
 };
 
 #endif // LOADM3D_H
\ No newline at end of file
@@ -4,33 +4,59 @@
 #include "common/d3dUtil.h"
 #include "common/MathHelper.h"
 
-///<summary>
-/// A Keyframe defines the bone transformation at an instant in time.
-///</summary>
-struct Keyframe {
-	Keyframe();
-	virtual ~Keyframe();
-
-    float TimePos;
-	DirectX::XMFLOAT3 Translation;
-    DirectX::XMFLOAT3 Scale;
-    DirectX::XMFLOAT4 RotationQuat;
-};
-
 ///<summary>
 /// A BoneAnimation is defined by a list of keyframes.  For time
 /// values inbetween two keyframes, we interpolate between the
 /// two nearest keyframes that bound the time.  
 ///
 /// We assume an animation always has two keyframes.
+///
+/// The keyframes are stored as separate streams, so the key search
+/// only walks the times and the interpolation only touches the two
+/// keys it blends.
 ///</summary>
 struct BoneAnimation {
 	float GetStartTime() const;
 	float GetEndTime() const;
 
-    void Interpolate(float t, DirectX::XMFLOAT4X4& M)const;
+	UINT GetNumKeyframes() const;
+	// Resizes every stream; new keys are identity transforms at time 0.
+	void Resize(UINT numKeyframes);
+
+	// Searches the keys from the start.
+	void Interpolate(float t, DirectX::XMFLOAT4X4& M) const;
+	// keyIndex is the key the last call started from and is updated for the next one;
+	// playing forward only checks the next keys, a seek falls back to a binary search.
+	void Interpolate(float t, DirectX::XMFLOAT4X4& M, UINT& keyIndex) const;
+
+	std::vector<float> TimePositions;
+	std::vector<DirectX::XMFLOAT3> Translations;
+	std::vector<DirectX::XMFLOAT3> Scales;
+	std::vector<DirectX::XMFLOAT4> RotationQuats;
+};
+
+///<summary>
+/// Where an instance is in each BoneAnimation of the clip it plays.
+/// A stale cursor(e.g. after a clip change) only costs a search.
+///</summary>
+struct AnimationCursor {
+	std::vector<UINT> KeyIndices;
+};
+
+// Index of a clip in SkinnedData, resolved once by name instead of on every update.
+typedef UINT ClipHandle;
+const ClipHandle InvalidClipHandle = 0xFFFFFFFF;
 
-	std::vector<Keyframe> Keyframes; 	
+///<summary>
+/// Poses a character for SkinnedData::GetFinalTransforms; the jobs
+/// of a batch must not share cursors or outputs.
+///</summary>
+struct SkinnedPoseJob {
+	ClipHandle Clip = InvalidClipHandle;
+	float TimePos = 0.0f;
+	AnimationCursor* Cursor = nullptr;
+	// BoneCount() matrices.
+	DirectX::XMFLOAT4X4* FinalTransforms = nullptr;
 };
 
 ///<summary>
@@ -43,6 +69,7 @@ struct AnimationClip {
 	float GetClipEndTime() const;
 
     void Interpolate(float t, std::vector<DirectX::XMFLOAT4X4>& boneTransforms)const;
+	void Interpolate(float t, DirectX::XMFLOAT4X4* boneTransforms, AnimationCursor& cursor) const;
 
     std::vector<BoneAnimation> BoneAnimations; 	
 };
@@ -53,17 +80,35 @@ public:
 
 	float GetClipStartTime(const std::string& clipName) const;
 	float GetClipEndTime(const std::string& clipName) const;
+	float GetClipEndTime(ClipHandle clip) const;
+
+	// Returns InvalidClipHandle if there is no such clip.
+	ClipHandle FindClip(const std::string& clipName) const;
 
 	void Set(
 		std::vector<int>& boneHierarchy, 
 		std::vector<DirectX::XMFLOAT4X4>& boneOffsets,
 		std::unordered_map<std::string, AnimationClip>& animations);
+	// Takes over the loaded data instead of copying the keyframes.
+	void Set(
+		std::vector<int>&& boneHierarchy,
+		std::vector<DirectX::XMFLOAT4X4>&& boneOffsets,
+		std::unordered_map<std::string, AnimationClip>&& animations);
 
 	 // In a real project, you'd want to cache the result if there was a chance
 	 // that you were calling this several times with the same clipName at 
 	 // the same timePos.
     void GetFinalTransforms(const std::string& clipName, float timePos, 
 		 std::vector<DirectX::XMFLOAT4X4>& finalTransforms)const;
+	// Continues from the keys the instance's last update used and doesn't allocate
+	// once the scratch of the calling thread has grown to BoneCount().
+	void GetFinalTransforms(ClipHandle clip, float timePos,
+		DirectX::XMFLOAT4X4* finalTransforms, AnimationCursor& cursor) const;
+	// Poses the characters as parallel jobs.
+	void GetFinalTransforms(const std::vector<SkinnedPoseJob>& jobs) const;
+
+private:
+	void BuildClipHandles();
 
 private:
     // Gives parentIndex of ith bone.
@@ -72,6 +117,10 @@ private:
 	std::vector<DirectX::XMFLOAT4X4> mBoneOffsets;
    
 	std::unordered_map<std::string, AnimationClip> mAnimations;
+
+	// Point into mAnimations, whose nodes don't move once it is set.
+	std::vector<const AnimationClip*> mClips;
+	std::unordered_map<std::string, ClipHandle> mClipHandles;
 };
  
 #endif // SKINNEDDATA_H
\ No newline at end of file
@@ -18,8 +18,9 @@ const int gNumFrameResources = 3;
 struct SkinnedModelInstance {
 	SkinnedData* SkinnedInfo = nullptr;
 	std::vector<DirectX::XMFLOAT4X4> FinalTransforms;
-	std::string ClipName;
+	ClipHandle Clip = InvalidClipHandle;
 	float TimePos = 0.0f;
+	AnimationCursor Cursor;
 
 	// Called every frame and increments the time position, interpolates the 
 	// animations for each bone based on the current animation clip, and 
@@ -29,11 +30,11 @@ struct SkinnedModelInstance {
 		TimePos += dt;
 
 		// Loop animation
-		if (TimePos > SkinnedInfo->GetClipEndTime(ClipName))
+		if (TimePos > SkinnedInfo->GetClipEndTime(Clip))
 			TimePos = 0.0f;
 
 		// Compute the final transforms for this time position.
-		SkinnedInfo->GetFinalTransforms(ClipName, TimePos, FinalTransforms);
+		SkinnedInfo->GetFinalTransforms(Clip, TimePos, FinalTransforms.data(), Cursor);
 	}
 };
 
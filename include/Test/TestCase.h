@@ -0,0 +1,61 @@
+#pragma once
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Test {
+	using TestFunc = void(*)();
+
+	struct TestCase;
+	class TestFailure;
+	class TestRegistrar;
+
+	//* Every test registered by TEST_CASE, in the order the translation units were initialized.
+	std::vector<TestCase>& GetTestCases();
+
+	//* Runs the tests whose name contains inFilter(all of them if it's empty).
+	//* Returns the number of failed tests.
+	int RunTestCases(const std::string& inFilter);
+}
+
+struct Test::TestCase {
+public:
+	const char* mName;
+	Test::TestFunc mFunc;
+};
+
+class Test::TestFailure : public std::runtime_error {
+public:
+	TestFailure(const std::string& inMessage) : std::runtime_error(inMessage) {}
+};
+
+class Test::TestRegistrar {
+public:
+	TestRegistrar(const char* inName, Test::TestFunc inFunc) {
+		GetTestCases().push_back({ inName, inFunc });
+	}
+};
+
+#ifndef TEST_CASE
+	#define TEST_CASE(__name)													\
+		static void __name();													\
+		static Test::TestRegistrar __name##_Registrar(#__name, __name);			\
+		static void __name()
+#endif
+
+#ifndef TEST_CHECK
+	#define TEST_CHECK(__expr)													\
+		{																		\
+			if (!(__expr)) {													\
+				std::stringstream __sstream_TC;									\
+				__sstream_TC << __FILE__ << "; line: " << __LINE__ << "; " << #__expr;	\
+				throw Test::TestFailure(__sstream_TC.str());					\
+			}																	\
+		}
+#endif
+
+#ifndef TEST_CHECK_NEAR
+	#define TEST_CHECK_NEAR(__a, __b, __epsilon) TEST_CHECK(std::abs((__a) - (__b)) <= (__epsilon))
+#endif
\ No newline at end of file
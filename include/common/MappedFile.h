@@ -0,0 +1,42 @@
+//***************************************************************************************
+// MappedFile.h
+//
+// Read-only memory mapping of a whole file, shared by the loaders of the demos and the game.
+// The mapped bytes stay valid until Close is called or the object is destroyed.
+//***************************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class MappedFile {
+public:
+	MappedFile() = default;
+	virtual ~MappedFile();
+
+private:
+	MappedFile(const MappedFile& src) = delete;
+	MappedFile(MappedFile&& src) = delete;
+	MappedFile& operator=(const MappedFile& rhs) = delete;
+	MappedFile& operator=(MappedFile&& rhs) = delete;
+
+public:
+	bool Open(const std::string& inFileName);
+	void Close();
+
+	bool IsOpen() const;
+	const std::uint8_t* GetData() const;
+	std::uint64_t GetSize() const;
+
+private:
+#ifdef _WIN32
+	void* mFile = nullptr;
+	void* mMapping = nullptr;
+#else
+	int mFile = -1;
+#endif
+
+	const std::uint8_t* mData = nullptr;
+	std::uint64_t mSize = 0;
+};
\ No newline at end of file
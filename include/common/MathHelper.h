@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 #include <DirectXMath.h>
 #include <DirectXPackedVector.h>
 
@@ -154,6 +155,11 @@ public:
         return I;
     }
 
+	// Index i of the sorted key times with times[i] <= t < times[i + 1]; t must be within the keys
+	// and there must be at least two of them.  hint is the index the last search of the same
+	// keys returned: playing forward only checks the next keys, a seek falls back to a binary search.
+	static std::uint32_t FindKeyframe(const float* times, std::uint32_t numKeys, float t, std::uint32_t hint);
+
     static DirectX::XMVECTOR RandUnitVec3();
     static DirectX::XMVECTOR RandHemisphereUnitVec3(DirectX::XMVECTOR n);
 
@@ -0,0 +1,48 @@
+//***************************************************************************************
+// TextModelLoader.h
+//
+// Loads the text models of the demos(Models/skull.txt) shared by the apps.
+//   -The text file is parsed in place through a memory-mapped view.
+//   -A binary copy of the parsed geometry is cached beside the text file and used
+//    as long as it is newer than the text file.
+//   -The bounds and the per-vertex texture coordinates and tangents are computed in parallel.
+//***************************************************************************************
+
+#pragma once
+
+#include "GeometryGenerator.h"
+
+#include <DirectXCollision.h>
+#include <string>
+
+class TextModelLoader {
+public:
+	enum class TexCoordMode {
+		Zero,
+		// Coordinates of the vertex position projected onto the unit sphere.
+		Spherical
+	};
+
+public:
+	///<summary>
+	/// Loads a model of the form "VertexCount/TriangleCount/VertexList (pos, normal)/TriangleList".
+	/// Every vertex also gets a tangent vector that is perpendicular to its normal,
+	/// so that normal mapping gives back the interpolated vertex normal.
+	/// Returns false if the file is missing or malformed; meshData and bounds are left untouched then.
+	///</summary>
+	static bool Load(const std::string& filename, TexCoordMode texCoordMode,
+		GeometryGenerator::MeshData& meshData, DirectX::BoundingBox& bounds);
+
+	///<summary>
+	/// Returns the path of the binary cache of a text model.
+	///</summary>
+	static std::string GetCacheFilename(const std::string& filename);
+
+private:
+	static bool ParseText(const char* data, size_t size, GeometryGenerator::MeshData& meshData);
+	static bool ParseBinary(const char* data, size_t size, GeometryGenerator::MeshData& meshData);
+	static bool SaveBinary(const std::string& filename, const GeometryGenerator::MeshData& meshData);
+
+	static void BuildVertexAttributes(TexCoordMode texCoordMode, GeometryGenerator::MeshData& meshData);
+	static DirectX::BoundingBox ComputeBounds(const GeometryGenerator::MeshData& meshData);
+};
\ No newline at end of file
@@ -0,0 +1,70 @@
+//***************************************************************************************
+// TextReader.h
+//
+// Whitespace separated tokens of a text file held in memory(usually a MappedFile view),
+// shared by the text model loaders of the demos.
+//   -The numbers are parsed with std::from_chars, so the results don't depend on the locale.
+//   -Nothing is copied out of the text but the strings that are read.
+//   -A read past the end or of a malformed number fails the reader, so a loader can check
+//    Failed once after a group of reads.
+//***************************************************************************************
+
+#pragma once
+
+#include <charconv>
+#include <cstring>
+#include <string>
+
+class TextReader {
+public:
+	TextReader(const char* inBegin, const char* inEnd);
+	virtual ~TextReader() = default;
+
+public:
+	bool Failed() const;
+
+	// Skips labels or header texts.
+	void Skip(int inCount = 1);
+	// Returns true if the next token starts with inPrefix, without consuming it.
+	bool PeekStartsWith(const char* inPrefix);
+
+	void Read(std::string& outValue);
+	// Reads an integer; any value but 0 is true.
+	void Read(bool& outValue);
+
+	template <typename T>
+	void Read(T& outValue);
+	template <typename T, typename... Rest>
+	void Read(T& outValue, Rest&... outRest);
+
+private:
+	void SkipSpaces();
+	bool NextToken(const char*& outBegin, const char*& outEnd);
+
+private:
+	const char* mCurr;
+	const char* mEnd;
+	bool bFailed = false;
+};
+
+template <typename T>
+void TextReader::Read(T& outValue) {
+	const char* begin;
+	const char* end;
+	if (!NextToken(begin, end))
+		return;
+
+	// from_chars doesn't accept a leading plus sign.
+	if (*begin == '+' && end - begin > 1)
+		++begin;
+
+	auto result = std::from_chars(begin, end, outValue);
+	if (result.ec != std::errc() || result.ptr != end)
+		bFailed = true;
+}
+
+template <typename T, typename... Rest>
+void TextReader::Read(T& outValue, Rest&... outRest) {
+	Read(outValue);
+	Read(outRest...);
+}
\ No newline at end of file
@@ -1914,44 +1914,29 @@ void BlurApp::DrawFullscreenQuad(ID3D12GraphicsCommandList* cmdList) {
 }
 
 void BlurApp::BuildSkullGeometry() {
-	std::ifstream fin("Models/skull.txt");
+	GeometryGenerator::MeshData skull;
+	BoundingBox aabb;
 
-	if (!fin) {
+	if (!TextModelLoader::Load("Models/skull.txt", TextModelLoader::TexCoordMode::Zero, skull, aabb)) {
 		MessageBox(0, L"Models/skull.txt not found.", 0, 0);
 		return;
 	}
 
-	UINT vcount = 0;
-	UINT tcount = 0;
-	std::string ignore;
-
-	fin >> ignore >> vcount;
-	fin >> ignore >> tcount;
-	fin >> ignore >> ignore >> ignore >> ignore;
-
-	std::vector<Vertex> vertices(vcount);
-	for (UINT i = 0; i < vcount; i++) {
-		fin >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
-		fin >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
-	}
-
-	fin >> ignore;
-	fin >> ignore;
-	fin >> ignore;
-
-	std::vector<std::int32_t> indices(3 * tcount);
-	for (UINT i = 0; i < tcount; i++) {
-		fin >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
+	std::vector<Vertex> vertices(skull.Vertices.size());
+	for (size_t i = 0; i < skull.Vertices.size(); ++i) {
+		vertices[i].Pos = skull.Vertices[i].Position;
+		vertices[i].Normal = skull.Vertices[i].Normal;
+		vertices[i].TexC = skull.Vertices[i].TexC;
 	}
 
-	fin.close();
+	const std::vector<std::uint32_t>& indices = skull.Indices32;
 
 	//
 	// Pack the indices of all the meshes into one index buffer.
 	//
 
 	const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
-	const UINT ibByteSize = (UINT)indices.size() * sizeof(std::int32_t);
+	const UINT ibByteSize = (UINT)indices.size() * sizeof(std::uint32_t);
 
 	auto geo = std::make_unique<MeshGeometry>();
 	geo->Name = "skullGeo";
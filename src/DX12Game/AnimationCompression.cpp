@@ -0,0 +1,484 @@
+#include "DX12Game/AnimationCompression.h"
+#include "DX12Game/SkinnedData.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+using namespace Game;
+
+namespace {
+	// Key frames are stored as 16-bit indices.
+	const size_t MaxFrames = 0x10000;
+
+	// All but the largest component of a unit quaternion lie in [-1/sqrt(2), 1/sqrt(2)].
+	const float QuaternionRange = 0.707106781f;
+	const float QuaternionQuantMax = 32767.0f;
+	const float VectorQuantMax = 65535.0f;
+
+	// Moves the reconstructed component(w lane) back to the position of the dropped largest one.
+	const std::uint32_t QuaternionSwizzles[4][4] = {
+		{ 3, 0, 1, 2 },
+		{ 0, 3, 1, 2 },
+		{ 0, 1, 3, 2 },
+		{ 0, 1, 2, 3 }
+	};
+
+	// Smallest-three: the index of the largest component(2 bits) and the other three as 15-bit values,
+	//  the largest one is made positive and reconstructed from the unit length.
+	void EncodeQuaternion(FXMVECTOR inQuat, std::uint16_t* outWords) {
+		XMFLOAT4 q;
+		XMStoreFloat4(&q, XMQuaternionNormalize(inQuat));
+
+		const float components[4] = { q.x, q.y, q.z, q.w };
+
+		std::uint32_t largest = 0;
+		for (std::uint32_t i = 1; i < 4; ++i) {
+			if (std::fabs(components[i]) > std::fabs(components[largest]))
+				largest = i;
+		}
+
+		float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+		std::uint16_t quantized[3];
+		for (std::uint32_t i = 0, j = 0; i < 4; ++i) {
+			if (i == largest)
+				continue;
+
+			float normalized = (components[i] * sign + QuaternionRange) / (2.0f * QuaternionRange);
+			normalized = std::min(std::max(normalized, 0.0f), 1.0f);
+			quantized[j++] = static_cast<std::uint16_t>(normalized * QuaternionQuantMax + 0.5f);
+		}
+
+		outWords[0] = static_cast<std::uint16_t>(quantized[0] | ((largest >> 1) << 15));
+		outWords[1] = static_cast<std::uint16_t>(quantized[1] | ((largest & 1) << 15));
+		outWords[2] = quantized[2];
+	}
+
+	XMVECTOR DecodeQuaternion(const std::uint16_t* inWords) {
+		std::uint32_t largest = ((inWords[0] >> 15) << 1) | (inWords[1] >> 15);
+
+		XMVECTOR v = XMConvertVectorUIntToFloat(
+			XMVectorSetInt(inWords[0] & 0x7FFF, inWords[1] & 0x7FFF, inWords[2] & 0x7FFF, 0), 0);
+		v = XMVectorMultiplyAdd(v,
+			XMVectorReplicate(2.0f * QuaternionRange / QuaternionQuantMax), XMVectorReplicate(-QuaternionRange));
+
+		XMVECTOR missing = XMVectorSqrt(XMVectorMax(
+			XMVectorSubtract(XMVectorSplatOne(), XMVector3Dot(v, v)), XMVectorZero()));
+		v = XMVectorSelect(v, missing, g_XMSelect0001);
+
+		const auto& swizzle = QuaternionSwizzles[largest];
+		return XMVectorSwizzle(v, swizzle[0], swizzle[1], swizzle[2], swizzle[3]);
+	}
+
+	void EncodeVector(FXMVECTOR inValue, FXMVECTOR inMin, FXMVECTOR inInvStep, std::uint16_t* outWords) {
+		XMVECTOR q = XMVectorRound(XMVectorMultiply(XMVectorSubtract(inValue, inMin), inInvStep));
+		q = XMVectorClamp(q, XMVectorZero(), XMVectorReplicate(VectorQuantMax));
+
+		XMFLOAT4 quantized;
+		XMStoreFloat4(&quantized, q);
+
+		outWords[0] = static_cast<std::uint16_t>(quantized.x);
+		outWords[1] = static_cast<std::uint16_t>(quantized.y);
+		outWords[2] = static_cast<std::uint16_t>(quantized.z);
+	}
+
+	XMVECTOR DecodeVector(const std::uint16_t* inWords, FXMVECTOR inMin, FXMVECTOR inStep) {
+		XMVECTOR v = XMConvertVectorUIntToFloat(XMVectorSetInt(inWords[0], inWords[1], inWords[2], 0), 0);
+		return XMVectorMultiplyAdd(v, inStep, inMin);
+	}
+
+	// Normalized lerp along the shorter arc; the encoding may flip the sign of a key.
+	XMVECTOR InterpolateRotation(FXMVECTOR inQuat0, FXMVECTOR inQuat1, float inT) {
+		XMVECTOR q1 = XMVectorSelect(inQuat1, XMVectorNegate(inQuat1),
+			XMVectorLess(XMVector4Dot(inQuat0, inQuat1), XMVectorZero()));
+		return XMQuaternionNormalize(XMVectorLerp(inQuat0, q1, inT));
+	}
+
+	float RotationError(FXMVECTOR inQuat0, FXMVECTOR inQuat1) {
+		float dot = std::fabs(XMVectorGetX(XMVector4Dot(inQuat0, inQuat1)));
+		return 2.0f * std::acos(std::min(dot, 1.0f));
+	}
+
+	float VectorError(FXMVECTOR inValue0, FXMVECTOR inValue1) {
+		return XMVectorGetX(XMVector3Length(XMVectorSubtract(inValue0, inValue1)));
+	}
+}
+
+bool CompressedAnimation::Compress(const Animation& inAnimation, const AnimationCompressionSettings& inSettings) {
+	Clear();
+
+	size_t numTracks = inAnimation.mCurves.size();
+	size_t numFrames = inAnimation.mNumFrames;
+	if (numTracks == 0 || numFrames == 0 || numFrames > MaxFrames)
+		return false;
+
+	for (const auto& curve : inAnimation.mCurves) {
+		if (curve.size() != numFrames)
+			return false;
+	}
+
+	std::vector<Channel> channels(numTracks * ENumChannelTypes);
+
+	std::vector<XMFLOAT4> translations(numFrames);
+	std::vector<XMFLOAT4> rotations(numFrames);
+	std::vector<XMFLOAT4> scales(numFrames);
+
+	for (size_t track = 0; track < numTracks; ++track) {
+		const auto& curve = inAnimation.mCurves[track];
+
+		XMVECTOR prevRotation = XMQuaternionIdentity();
+		for (size_t frame = 0; frame < numFrames; ++frame) {
+			XMVECTOR scale;
+			XMVECTOR rotation;
+			XMVECTOR translation;
+			if (!XMMatrixDecompose(&scale, &rotation, &translation, XMLoadFloat4x4(&curve[frame]))) {
+				mKeyFrames.clear();
+				mKeyData.clear();
+				return false;
+			}
+
+			// Keeps the neighbouring source keys on one hemisphere, so the tolerance checks see the shorter arc.
+			if (frame > 0 && XMVectorGetX(XMVector4Dot(rotation, prevRotation)) < 0.0f)
+				rotation = XMVectorNegate(rotation);
+			prevRotation = rotation;
+
+			XMStoreFloat4(&translations[frame], translation);
+			XMStoreFloat4(&rotations[frame], rotation);
+			XMStoreFloat4(&scales[frame], scale);
+		}
+
+		Channel* trackChannels = &channels[track * ENumChannelTypes];
+		BuildVectorChannel(trackChannels[ETranslation], translations, { 0.0f, 0.0f, 0.0f, 0.0f }, inSettings.mTranslationTolerance);
+		BuildRotationChannel(trackChannels[ERotation], rotations, inSettings.mRotationTolerance);
+		BuildVectorChannel(trackChannels[EScale], scales, { 1.0f, 1.0f, 1.0f, 0.0f }, inSettings.mScaleTolerance);
+	}
+
+	mNumTracks = static_cast<std::uint32_t>(numTracks);
+	mNumFrames = static_cast<std::uint32_t>(numFrames);
+	mChannels = std::move(channels);
+
+	BuildStatistics();
+	MeasureError(inAnimation, inSettings.mErrorDistance);
+
+	// The tolerances only bound the key reduction; what the decomposition loses(shear) shows up here.
+	if (mStatistics.mMaxError > inSettings.mMaxError) {
+		auto stats = mStatistics;
+		Clear();
+		mStatistics = stats;
+		return false;
+	}
+
+	return true;
+}
+
+bool CompressedAnimation::Assign(std::uint32_t inNumTracks, std::uint32_t inNumFrames, std::vector<Channel> inChannels,
+		std::vector<std::uint16_t> inKeyFrames, std::vector<std::uint16_t> inKeyData, float inMaxError) {
+	Clear();
+
+	if (inNumTracks == 0 || inNumFrames == 0 || inNumFrames > MaxFrames ||
+			inChannels.size() != static_cast<size_t>(inNumTracks) * ENumChannelTypes || inKeyData.size() != inKeyFrames.size() * 3)
+		return false;
+
+	// The sampling reads the keys of a channel without checks, so they must start at frame 0 and increase within the clip.
+	for (const auto& channel : inChannels) {
+		if (channel.mMode > EAnimated)
+			return false;
+		if (channel.mMode != EAnimated)
+			continue;
+
+		if (channel.mNumKeys == 0 || channel.mFirstKey > inKeyFrames.size() ||
+				channel.mNumKeys > inKeyFrames.size() - channel.mFirstKey)
+			return false;
+
+		const std::uint16_t* frames = inKeyFrames.data() + channel.mFirstKey;
+		if (frames[0] != 0 || frames[channel.mNumKeys - 1] >= inNumFrames)
+			return false;
+		for (std::uint32_t i = 1; i < channel.mNumKeys; ++i) {
+			if (frames[i] <= frames[i - 1])
+				return false;
+		}
+	}
+
+	mNumTracks = inNumTracks;
+	mNumFrames = inNumFrames;
+	mChannels = std::move(inChannels);
+	mKeyFrames = std::move(inKeyFrames);
+	mKeyData = std::move(inKeyData);
+
+	BuildStatistics();
+	mStatistics.mMaxError = inMaxError;
+
+	return true;
+}
+
+void CompressedAnimation::SamplePose(float inFrame, XMFLOAT4X4* outTransforms) const {
+	float frame = std::min(std::max(inFrame, 0.0f), static_cast<float>(mNumFrames - 1));
+
+	const Channel* channel = mChannels.data();
+	for (std::uint32_t track = 0; track < mNumTracks; ++track, channel += ENumChannelTypes) {
+		XMVECTOR translation = SampleChannel(channel[ETranslation], ETranslation, frame);
+		XMVECTOR rotation = SampleChannel(channel[ERotation], ERotation, frame);
+		XMVECTOR scale = SampleChannel(channel[EScale], EScale, frame);
+
+		XMStoreFloat4x4(&outTransforms[track], XMMatrixAffineTransformation(scale, XMVectorZero(), rotation, translation));
+	}
+}
+
+bool CompressedAnimation::IsEmpty() const {
+	return mNumTracks == 0;
+}
+
+size_t CompressedAnimation::GetNumTracks() const {
+	return mNumTracks;
+}
+
+size_t CompressedAnimation::GetNumFrames() const {
+	return mNumFrames;
+}
+
+size_t CompressedAnimation::GetByteSize() const {
+	return mChannels.size() * sizeof(Channel) +
+		(mKeyFrames.size() + mKeyData.size()) * sizeof(std::uint16_t);
+}
+
+const AnimationCompressionStatistics& CompressedAnimation::GetStatistics() const {
+	return mStatistics;
+}
+
+const std::vector<CompressedAnimation::Channel>& CompressedAnimation::GetChannels() const {
+	return mChannels;
+}
+
+const std::vector<std::uint16_t>& CompressedAnimation::GetKeyFrames() const {
+	return mKeyFrames;
+}
+
+const std::vector<std::uint16_t>& CompressedAnimation::GetKeyData() const {
+	return mKeyData;
+}
+
+void CompressedAnimation::BuildVectorChannel(Channel& outChannel, const std::vector<XMFLOAT4>& inValues,
+		const XMFLOAT4& inDefault, float inTolerance) {
+	XMVECTOR defaultValue = XMLoadFloat4(&inDefault);
+	XMVECTOR firstValue = XMLoadFloat4(&inValues.front());
+
+	bool isDefault = true;
+	bool isConstant = true;
+	XMVECTOR minValue = firstValue;
+	XMVECTOR maxValue = firstValue;
+
+	for (const auto& value : inValues) {
+		XMVECTOR v = XMLoadFloat4(&value);
+		isDefault = isDefault && VectorError(v, defaultValue) <= inTolerance;
+		isConstant = isConstant && VectorError(v, firstValue) <= inTolerance;
+		minValue = XMVectorMin(minValue, v);
+		maxValue = XMVectorMax(maxValue, v);
+	}
+
+	if (isDefault) {
+		outChannel.mMode = EDefault;
+		return;
+	}
+	if (isConstant) {
+		outChannel.mMode = EConstant;
+		outChannel.mMin = inValues.front();
+		return;
+	}
+
+	XMVECTOR step = XMVectorDivide(XMVectorSubtract(maxValue, minValue), XMVectorReplicate(VectorQuantMax));
+	// A component that doesn't move keeps the step of zero and quantizes to zero.
+	XMVECTOR invStep = XMVectorSelect(XMVectorZero(), XMVectorReciprocal(step), XMVectorGreater(step, XMVectorZero()));
+
+	XMStoreFloat4(&outChannel.mMin, minValue);
+	XMStoreFloat4(&outChannel.mStep, step);
+
+	std::vector<std::uint16_t> encoded(inValues.size() * 3);
+	for (size_t i = 0, end = inValues.size(); i < end; ++i)
+		EncodeVector(XMLoadFloat4(&inValues[i]), minValue, invStep, &encoded[i * 3]);
+
+	AddReducedKeys(outChannel, inValues, encoded, false, inTolerance);
+}
+
+void CompressedAnimation::BuildRotationChannel(Channel& outChannel, const std::vector<XMFLOAT4>& inValues, float inTolerance) {
+	XMVECTOR identity = XMQuaternionIdentity();
+	XMVECTOR firstValue = XMLoadFloat4(&inValues.front());
+
+	bool isDefault = true;
+	bool isConstant = true;
+
+	for (const auto& value : inValues) {
+		XMVECTOR q = XMLoadFloat4(&value);
+		isDefault = isDefault && RotationError(q, identity) <= inTolerance;
+		isConstant = isConstant && RotationError(q, firstValue) <= inTolerance;
+	}
+
+	if (isDefault) {
+		outChannel.mMode = EDefault;
+		return;
+	}
+	if (isConstant) {
+		outChannel.mMode = EConstant;
+		XMStoreFloat4(&outChannel.mMin, XMQuaternionNormalize(firstValue));
+		return;
+	}
+
+	std::vector<std::uint16_t> encoded(inValues.size() * 3);
+	for (size_t i = 0, end = inValues.size(); i < end; ++i)
+		EncodeQuaternion(XMLoadFloat4(&inValues[i]), &encoded[i * 3]);
+
+	AddReducedKeys(outChannel, inValues, encoded, true, inTolerance);
+}
+
+void CompressedAnimation::AddReducedKeys(Channel& outChannel, const std::vector<XMFLOAT4>& inValues,
+		const std::vector<std::uint16_t>& inEncoded, bool inIsRotation, float inTolerance) {
+	size_t numFrames = inValues.size();
+	XMVECTOR minValue = XMLoadFloat4(&outChannel.mMin);
+	XMVECTOR step = XMLoadFloat4(&outChannel.mStep);
+
+	// The segments are tested against the quantized keys, which is what the decompressor interpolates.
+	std::vector<XMFLOAT4> decoded(numFrames);
+	for (size_t i = 0; i < numFrames; ++i) {
+		XMVECTOR v = inIsRotation ? DecodeQuaternion(&inEncoded[i * 3]) : DecodeVector(&inEncoded[i * 3], minValue, step);
+		XMStoreFloat4(&decoded[i], v);
+	}
+
+	auto segmentFits = [&](size_t inBegin, size_t inEnd) {
+		XMVECTOR v0 = XMLoadFloat4(&decoded[inBegin]);
+		XMVECTOR v1 = XMLoadFloat4(&decoded[inEnd]);
+		float invLength = 1.0f / static_cast<float>(inEnd - inBegin);
+
+		for (size_t i = inBegin + 1; i < inEnd; ++i) {
+			float t = static_cast<float>(i - inBegin) * invLength;
+			XMVECTOR source = XMLoadFloat4(&inValues[i]);
+
+			float error = inIsRotation ?
+				RotationError(InterpolateRotation(v0, v1, t), source) : VectorError(XMVectorLerp(v0, v1, t), source);
+			if (error > inTolerance)
+				return false;
+		}
+
+		return true;
+	};
+
+	auto addKey = [&](size_t inFrame) {
+		mKeyFrames.push_back(static_cast<std::uint16_t>(inFrame));
+		mKeyData.insert(mKeyData.end(), inEncoded.begin() + inFrame * 3, inEncoded.begin() + inFrame * 3 + 3);
+	};
+
+	outChannel.mMode = EAnimated;
+	outChannel.mFirstKey = static_cast<std::uint32_t>(mKeyFrames.size());
+
+	addKey(0);
+	for (size_t begin = 0; begin + 1 < numFrames;) {
+		size_t end = begin + 1;
+		while (end + 1 < numFrames && segmentFits(begin, end + 1))
+			++end;
+
+		addKey(end);
+		begin = end;
+	}
+
+	outChannel.mNumKeys = static_cast<std::uint32_t>(mKeyFrames.size()) - outChannel.mFirstKey;
+}
+
+XMVECTOR CompressedAnimation::SampleChannel(const Channel& inChannel, EChannelType inType, float inFrame) const {
+	switch (inChannel.mMode) {
+	case EDefault:
+		if (inType == ERotation)
+			return XMQuaternionIdentity();
+		return inType == EScale ? XMVectorSplatOne() : XMVectorZero();
+	case EConstant:
+		return XMLoadFloat4(&inChannel.mMin);
+	default:
+		break;
+	}
+
+	const std::uint16_t* frames = mKeyFrames.data() + inChannel.mFirstKey;
+	const std::uint16_t* framesEnd = frames + inChannel.mNumKeys;
+
+	// The first key is always at frame 0, so only the end needs clamping.
+	const std::uint16_t* next = std::upper_bound(frames, framesEnd, inFrame,
+		[](float inValue, std::uint16_t inKeyFrame) {
+			return inValue < static_cast<float>(inKeyFrame);
+		});
+	if (next == framesEnd)
+		return DecodeKey(inChannel, inType, inChannel.mFirstKey + inChannel.mNumKeys - 1);
+
+	std::uint32_t key1 = inChannel.mFirstKey + static_cast<std::uint32_t>(next - frames);
+	std::uint32_t key0 = key1 - 1;
+
+	float frame0 = static_cast<float>(mKeyFrames[key0]);
+	float t = (inFrame - frame0) / (static_cast<float>(mKeyFrames[key1]) - frame0);
+
+	XMVECTOR v0 = DecodeKey(inChannel, inType, key0);
+	XMVECTOR v1 = DecodeKey(inChannel, inType, key1);
+
+	return inType == ERotation ? InterpolateRotation(v0, v1, t) : XMVectorLerp(v0, v1, t);
+}
+
+XMVECTOR CompressedAnimation::DecodeKey(const Channel& inChannel, EChannelType inType, std::uint32_t inKey) const {
+	const std::uint16_t* words = &mKeyData[static_cast<size_t>(inKey) * 3];
+	if (inType == ERotation)
+		return DecodeQuaternion(words);
+
+	return DecodeVector(words, XMLoadFloat4(&inChannel.mMin), XMLoadFloat4(&inChannel.mStep));
+}
+
+void CompressedAnimation::Clear() {
+	mNumTracks = 0;
+	mNumFrames = 0;
+	mChannels.clear();
+	mKeyFrames.clear();
+	mKeyData.clear();
+	mStatistics = AnimationCompressionStatistics();
+}
+
+void CompressedAnimation::BuildStatistics() {
+	mStatistics.mRawBytes = static_cast<std::uint64_t>(mNumTracks) * mNumFrames * sizeof(XMFLOAT4X4);
+	mStatistics.mCompressedBytes = GetByteSize();
+	for (const auto& channel : mChannels) {
+		switch (channel.mMode) {
+		case EDefault:
+			++mStatistics.mNumDefaultChannels;
+			break;
+		case EConstant:
+			++mStatistics.mNumConstantChannels;
+			break;
+		case EAnimated:
+			++mStatistics.mNumAnimatedChannels;
+			mStatistics.mNumSourceKeys += mNumFrames;
+			mStatistics.mNumKeys += channel.mNumKeys;
+			break;
+		}
+	}
+}
+
+void CompressedAnimation::MeasureError(const Animation& inAnimation, float inErrorDistance) {
+	std::vector<XMFLOAT4X4> pose(mNumTracks);
+	XMVECTOR distance = XMVectorReplicate(inErrorDistance);
+
+	for (std::uint32_t frame = 0; frame < mNumFrames; ++frame) {
+		SamplePose(static_cast<float>(frame), pose.data());
+
+		for (std::uint32_t track = 0; track < mNumTracks; ++track) {
+			XMMATRIX source = XMLoadFloat4x4(&inAnimation.mCurves[track][frame]);
+			XMMATRIX decompressed = XMLoadFloat4x4(&pose[track]);
+
+			// Row vectors: the bone origin maps to r[3], and a point on an axis adds the scaled axis row.
+			XMVECTOR originDiff = XMVectorSubtract(source.r[3], decompressed.r[3]);
+			float error = XMVectorGetX(XMVector3Length(originDiff));
+			for (size_t axis = 0; axis < 3; ++axis) {
+				XMVECTOR axisDiff = XMVectorMultiplyAdd(
+					XMVectorSubtract(source.r[axis], decompressed.r[axis]), distance, originDiff);
+				error = std::max(error, XMVectorGetX(XMVector3Length(axisDiff)));
+			}
+
+			if (error > mStatistics.mMaxError) {
+				mStatistics.mMaxError = error;
+				mStatistics.mMaxErrorTrack = track;
+				mStatistics.mMaxErrorFrame = frame;
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,503 @@
+#include "DX12Game/AnimationGraph.h"
+#include "DX12Game/SkinnedData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+
+using namespace DirectX;
+using namespace Game;
+
+namespace {
+	float GetMilliseconds(std::chrono::steady_clock::time_point inBegin, std::chrono::steady_clock::time_point inEnd) {
+		return std::chrono::duration<float, std::milli>(inEnd - inBegin).count();
+	}
+}
+
+AnimationGraph::ParameterId AnimationGraph::AddParameter(const std::string& inName, float inValue) {
+	auto iter = mParameterIds.find(inName);
+	if (iter != mParameterIds.end())
+		return iter->second;
+
+	ParameterId id = static_cast<ParameterId>(mParameters.size());
+	mParameters.push_back(inValue);
+	mParameterIds.emplace(inName, id);
+
+	return id;
+}
+
+AnimationGraph::ParameterId AnimationGraph::FindParameter(const std::string& inName) const {
+	auto iter = mParameterIds.find(inName);
+	return iter != mParameterIds.end() ? iter->second : InvalidParameter;
+}
+
+void AnimationGraph::SetParameter(ParameterId inParameter, float inValue) {
+	if (inParameter < mParameters.size())
+		mParameters[inParameter] = inValue;
+}
+
+float AnimationGraph::GetParameter(ParameterId inParameter) const {
+	return inParameter < mParameters.size() ? mParameters[inParameter] : 0.0f;
+}
+
+AnimationGraph::NodeId AnimationGraph::AddClip(const std::string& inClipName, float inRate) {
+	Node node;
+	node.mType = EClip;
+	node.mClipName = inClipName;
+	node.mRate = inRate;
+
+	mNodes.push_back(std::move(node));
+
+	return static_cast<NodeId>(mNodes.size() - 1);
+}
+
+AnimationGraph::NodeId AnimationGraph::AddBlendSpace1D(ParameterId inParameter) {
+	Node node;
+	node.mType = EBlendSpace1D;
+	node.mParameterX = inParameter;
+
+	mNodes.push_back(std::move(node));
+
+	return static_cast<NodeId>(mNodes.size() - 1);
+}
+
+bool AnimationGraph::AddBlendSpace1DSample(NodeId inBlendSpace, NodeId inChild, float inThreshold) {
+	if (inBlendSpace >= mNodes.size() || inChild >= mNodes.size() || IsReachable(inChild, inBlendSpace))
+		return false;
+
+	auto& node = mNodes[inBlendSpace];
+	if (node.mType != EBlendSpace1D)
+		return false;
+
+	// Kept sorted by threshold, so the evaluation only looks for the segment the parameter is in.
+	auto iter = std::upper_bound(node.mPositions.begin(), node.mPositions.end(), inThreshold,
+		[](float inValue, const XMFLOAT2& inPosition) {
+			return inValue < inPosition.x;
+		});
+	size_t index = static_cast<size_t>(iter - node.mPositions.begin());
+
+	node.mPositions.insert(iter, XMFLOAT2(inThreshold, 0.0f));
+	node.mChildren.insert(node.mChildren.begin() + index, inChild);
+	node.mWeights.push_back(0.0f);
+
+	return true;
+}
+
+AnimationGraph::NodeId AnimationGraph::AddBlendSpace2D(ParameterId inParameterX, ParameterId inParameterY) {
+	Node node;
+	node.mType = EBlendSpace2D;
+	node.mParameterX = inParameterX;
+	node.mParameterY = inParameterY;
+
+	mNodes.push_back(std::move(node));
+
+	return static_cast<NodeId>(mNodes.size() - 1);
+}
+
+bool AnimationGraph::AddBlendSpace2DSample(NodeId inBlendSpace, NodeId inChild, float inX, float inY) {
+	if (inBlendSpace >= mNodes.size() || inChild >= mNodes.size() || IsReachable(inChild, inBlendSpace))
+		return false;
+
+	auto& node = mNodes[inBlendSpace];
+	if (node.mType != EBlendSpace2D)
+		return false;
+
+	node.mPositions.emplace_back(inX, inY);
+	node.mChildren.push_back(inChild);
+	node.mWeights.push_back(0.0f);
+
+	return true;
+}
+
+void AnimationGraph::Play(NodeId inNode, float inFadeDuration) {
+	if (inNode >= mNodes.size() || inNode == mCurrMotion.mNode)
+		return;
+
+	if (mCurrMotion.mNode != InvalidNode && inFadeDuration > 0.0f) {
+		mPrevMotion = mCurrMotion;
+		mFadeDuration = inFadeDuration;
+		mFadeTime = 0.0f;
+	}
+	else {
+		mPrevMotion = Motion();
+	}
+
+	mCurrMotion.mNode = inNode;
+	mCurrMotion.mPhase = 0.0f;
+}
+
+AnimationGraph::NodeId AnimationGraph::GetCurrentMotion() const {
+	return mCurrMotion.mNode;
+}
+
+size_t AnimationGraph::AddAdditiveLayer(NodeId inNode, float inWeight) {
+	Layer layer;
+	layer.mMotion.mNode = inNode;
+	layer.mWeight = inWeight;
+
+	mLayers.push_back(layer);
+
+	return mLayers.size() - 1;
+}
+
+void AnimationGraph::SetLayerWeight(size_t inLayer, float inWeight) {
+	if (inLayer < mLayers.size())
+		mLayers[inLayer].mWeight = inWeight;
+}
+
+void AnimationGraph::Bind(const SkinnedData* inSkinnedData, const std::function<std::uint32_t(const std::string&)>& inGetClipIndex) {
+	for (auto& node : mNodes) {
+		if (node.mType != EClip)
+			continue;
+
+		node.mAnimation = nullptr;
+		node.mClipIndex = 0;
+
+		if (inSkinnedData == nullptr)
+			continue;
+
+		const auto& animations = inSkinnedData->mAnimations;
+		auto iter = animations.find(node.mClipName);
+		if (iter == animations.cend())
+			continue;
+
+		node.mAnimation = &iter->second;
+		node.mClipIndex = inGetClipIndex(node.mClipName);
+	}
+}
+
+void AnimationGraph::SetCpuPoseOutput(const SkinnedData* inSkinnedData,
+		XMFLOAT4X4* outSkinningPalette, XMFLOAT4X4* outBoneTransforms) {
+	mSkinnedData = inSkinnedData;
+	mSkinningPalette = outSkinningPalette;
+	mBoneTransforms = outBoneTransforms;
+}
+
+void AnimationGraph::Evaluate(float inDeltaTime) {
+	auto beginTime = std::chrono::steady_clock::now();
+
+	for (auto& node : mNodes)
+		UpdateWeights(node);
+
+	mTerms.clear();
+
+	float fadeAlpha = 1.0f;
+	if (mPrevMotion.mNode != InvalidNode) {
+		mFadeTime += inDeltaTime;
+		if (mFadeTime >= mFadeDuration)
+			mPrevMotion = Motion();
+		else
+			fadeAlpha = mFadeTime / mFadeDuration;
+	}
+
+	if (mCurrMotion.mNode != InvalidNode) {
+		mLeaves.clear();
+		CollectLeaves(mCurrMotion.mNode, 1.0f);
+		AddMotionTerms(mCurrMotion, fadeAlpha, inDeltaTime, false);
+	}
+
+	if (mPrevMotion.mNode != InvalidNode) {
+		mLeaves.clear();
+		CollectLeaves(mPrevMotion.mNode, 1.0f);
+		AddMotionTerms(mPrevMotion, 1.0f - fadeAlpha, inDeltaTime, false);
+	}
+
+	mNumMotionTerms = mTerms.size();
+
+	for (auto& layer : mLayers) {
+		if (layer.mMotion.mNode >= mNodes.size())
+			continue;
+
+		mLeaves.clear();
+		CollectLeaves(layer.mMotion.mNode, 1.0f);
+		AddMotionTerms(layer.mMotion, layer.mWeight, inDeltaTime, true);
+	}
+
+	// A motion without any bound clip(e.g. fading in from nothing) would otherwise shrink the pose;
+	//  the layers keep their own weights.
+	float sum = 0.0f;
+	for (size_t i = 0; i < mNumMotionTerms; ++i)
+		sum += mTerms[i].mWeight;
+
+	if (sum > 0.0f && sum != 1.0f) {
+		for (size_t i = 0; i < mNumMotionTerms; ++i)
+			mTerms[i].mWeight /= sum;
+	}
+
+	BuildGpuTerms();
+
+	if (mSkinningPalette != nullptr && !mTerms.empty()) {
+		PoseJob job;
+		job.mSkinnedData = mSkinnedData;
+		job.mTerms = mTerms.data();
+		job.mNumTerms = mTerms.size();
+		job.mSkinningPalette = mSkinningPalette;
+		job.mBoneTransforms = mBoneTransforms;
+
+		PoseSampler::Sample(job);
+	}
+
+	mEvaluationTime = GetMilliseconds(beginTime, std::chrono::steady_clock::now());
+}
+
+const std::vector<PoseTerm>& AnimationGraph::GetTerms() const {
+	return mTerms;
+}
+
+const std::vector<PoseTerm>& AnimationGraph::GetGpuTerms() const {
+	return mGpuTerms;
+}
+
+float AnimationGraph::GetEvaluationTime() const {
+	return mEvaluationTime;
+}
+
+bool AnimationGraph::IsReachable(NodeId inFrom, NodeId inTo) const {
+	std::vector<bool> visited(mNodes.size(), false);
+	std::vector<NodeId> stack = { inFrom };
+
+	while (!stack.empty()) {
+		NodeId id = stack.back();
+		stack.pop_back();
+
+		if (id == inTo)
+			return true;
+		if (visited[id])
+			continue;
+		visited[id] = true;
+
+		for (NodeId child : mNodes[id].mChildren)
+			stack.push_back(child);
+	}
+
+	return false;
+}
+
+void AnimationGraph::UpdateWeights(Node& ioNode) {
+	size_t numChildren = ioNode.mChildren.size();
+	if (numChildren == 0)
+		return;
+
+	std::fill(ioNode.mWeights.begin(), ioNode.mWeights.end(), 0.0f);
+
+	if (ioNode.mType == EBlendSpace1D) {
+		float value = GetParameter(ioNode.mParameterX);
+
+		if (numChildren == 1 || value <= ioNode.mPositions.front().x) {
+			ioNode.mWeights.front() = 1.0f;
+			return;
+		}
+		if (value >= ioNode.mPositions.back().x) {
+			ioNode.mWeights.back() = 1.0f;
+			return;
+		}
+
+		for (size_t i = 1; i < numChildren; ++i) {
+			float upper = ioNode.mPositions[i].x;
+			if (value > upper)
+				continue;
+
+			float lower = ioNode.mPositions[i - 1].x;
+			float pct = upper > lower ? (value - lower) / (upper - lower) : 1.0f;
+
+			ioNode.mWeights[i - 1] = 1.0f - pct;
+			ioNode.mWeights[i] = pct;
+			return;
+		}
+	}
+	else if (ioNode.mType == EBlendSpace2D) {
+		XMVECTOR value = XMVectorSet(GetParameter(ioNode.mParameterX), GetParameter(ioNode.mParameterY), 0.0f, 0.0f);
+
+		// Gradient band interpolation: a sample loses weight as the value moves towards any other sample.
+		float sum = 0.0f;
+		for (size_t i = 0; i < numChildren; ++i) {
+			XMVECTOR pi = XMLoadFloat2(&ioNode.mPositions[i]);
+			XMVECTOR toValue = XMVectorSubtract(value, pi);
+
+			float weight = 1.0f;
+			for (size_t j = 0; j < numChildren; ++j) {
+				if (j == i)
+					continue;
+
+				XMVECTOR toSample = XMVectorSubtract(XMLoadFloat2(&ioNode.mPositions[j]), pi);
+				float lengthSq = XMVectorGetX(XMVector2LengthSq(toSample));
+				if (lengthSq <= 0.0f)
+					continue;
+
+				float band = 1.0f - XMVectorGetX(XMVector2Dot(toValue, toSample)) / lengthSq;
+				weight = std::min(weight, std::max(band, 0.0f));
+			}
+
+			ioNode.mWeights[i] = weight;
+			sum += weight;
+		}
+
+		if (sum > 0.0f) {
+			for (auto& weight : ioNode.mWeights)
+				weight /= sum;
+		}
+		else {
+			ioNode.mWeights.front() = 1.0f;
+		}
+	}
+}
+
+void AnimationGraph::CollectLeaves(NodeId inNode, float inWeight) {
+	const auto& node = mNodes[inNode];
+
+	if (node.mType == EClip) {
+		if (node.mAnimation != nullptr)
+			mLeaves.push_back({ inNode, inWeight });
+		return;
+	}
+
+	for (size_t i = 0, end = node.mChildren.size(); i < end; ++i) {
+		float weight = node.mWeights[i] * inWeight;
+		if (weight > 0.0f)
+			CollectLeaves(node.mChildren[i], weight);
+	}
+}
+
+void AnimationGraph::AddMotionTerms(Motion& ioMotion, float inWeight, float inDeltaTime, bool inIsAdditive) {
+	// The clips the mesh doesn't have are already left out; the others take their weight.
+	float sum = 0.0f;
+	for (const auto& leaf : mLeaves)
+		sum += leaf.mWeight;
+
+	if (sum <= 0.0f)
+		return;
+
+	// The motion lasts as long as the weighted durations of its clips, so the blend keeps a plausible pace.
+	float duration = 0.0f;
+	for (auto& leaf : mLeaves) {
+		leaf.mWeight /= sum;
+
+		const auto& node = mNodes[leaf.mNode];
+		duration += leaf.mWeight * node.mAnimation->mDuration / node.mRate;
+	}
+
+	if (duration > 0.0f) {
+		ioMotion.mPhase += inDeltaTime / duration;
+		ioMotion.mPhase -= std::floor(ioMotion.mPhase);
+	}
+
+	if (inWeight == 0.0f)
+		return;
+
+	for (const auto& leaf : mLeaves) {
+		const auto& node = mNodes[leaf.mNode];
+		const auto& anim = *node.mAnimation;
+
+		PoseTerm term;
+		term.mAnimation = &anim;
+		term.mClipIndex = node.mClipIndex;
+		term.mTimePos = anim.mFrameDuration > 0.0f ? ioMotion.mPhase * anim.mDuration / anim.mFrameDuration : 0.0f;
+		term.mWeight = leaf.mWeight * inWeight;
+		mTerms.push_back(term);
+
+		if (inIsAdditive) {
+			term.mTimePos = 0.0f;
+			term.mWeight = -term.mWeight;
+			mTerms.push_back(term);
+		}
+	}
+}
+
+void AnimationGraph::BuildGpuTerms() {
+	if (mTerms.size() <= MaxGpuTerms) {
+		mGpuTerms.assign(mTerms.cbegin(), mTerms.cend());
+		return;
+	}
+
+	// Splitting an additive term from its reference term would add the whole pose of the clip.
+	mTermGroups.clear();
+	for (size_t i = 0; i < mNumMotionTerms; ++i)
+		mTermGroups.push_back({ i, 1, mTerms[i].mWeight });
+	for (size_t i = mNumMotionTerms; i + 1 < mTerms.size(); i += 2)
+		mTermGroups.push_back({ i, 2, mTerms[i].mWeight });
+
+	std::sort(mTermGroups.begin(), mTermGroups.end(), [](const TermGroup& inLhs, const TermGroup& inRhs) {
+		return std::abs(inLhs.mWeight) > std::abs(inRhs.mWeight);
+	});
+
+	// The heaviest groups that fit; a pair that doesn't fit may still leave room for a lighter motion term.
+	size_t numKept = 0;
+	size_t numTerms = 0;
+	for (const auto& group : mTermGroups) {
+		if (numTerms + group.mNumTerms > MaxGpuTerms)
+			continue;
+
+		mTermGroups[numKept++] = group;
+		numTerms += group.mNumTerms;
+	}
+	mTermGroups.resize(numKept);
+
+	std::sort(mTermGroups.begin(), mTermGroups.end(), [](const TermGroup& inLhs, const TermGroup& inRhs) {
+		return inLhs.mFirstTerm < inRhs.mFirstTerm;
+	});
+
+	mGpuTerms.clear();
+	for (const auto& group : mTermGroups)
+		mGpuTerms.insert(mGpuTerms.end(), mTerms.cbegin() + group.mFirstTerm, mTerms.cbegin() + group.mFirstTerm + group.mNumTerms);
+
+	// A dropped motion term would otherwise scale the whole pose; the layers keep their weights.
+	size_t numMotionTerms = 0;
+	for (const auto& group : mTermGroups) {
+		if (group.mFirstTerm < mNumMotionTerms)
+			++numMotionTerms;
+	}
+
+	float sum = 0.0f;
+	for (size_t i = 0; i < numMotionTerms; ++i)
+		sum += mGpuTerms[i].mWeight;
+
+	if (sum > 0.0f) {
+		for (size_t i = 0; i < numMotionTerms; ++i)
+			mGpuTerms[i].mWeight /= sum;
+	}
+}
+
+void AnimationGraphBatch::Add(AnimationGraph* inGraph) {
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	if (std::find(mGraphs.cbegin(), mGraphs.cend(), inGraph) == mGraphs.cend())
+		mGraphs.push_back(inGraph);
+}
+
+void AnimationGraphBatch::Remove(AnimationGraph* inGraph) {
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	auto iter = std::find(mGraphs.begin(), mGraphs.end(), inGraph);
+	if (iter != mGraphs.end()) {
+		std::iter_swap(iter, mGraphs.end() - 1);
+		mGraphs.pop_back();
+	}
+}
+
+void AnimationGraphBatch::Evaluate(float inDeltaTime) {
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	auto beginTime = std::chrono::steady_clock::now();
+
+	std::for_each(std::execution::par, mGraphs.begin(), mGraphs.end(), [inDeltaTime](AnimationGraph* inGraph) {
+		inGraph->Evaluate(inDeltaTime);
+	});
+
+	mStatistics.mNumGraphs = static_cast<std::uint32_t>(mGraphs.size());
+	mStatistics.mBatchTime = GetMilliseconds(beginTime, std::chrono::steady_clock::now());
+	mStatistics.mMaxGraphTime = 0.0f;
+	mStatistics.mAverageGraphTime = 0.0f;
+
+	for (auto graph : mGraphs) {
+		mStatistics.mMaxGraphTime = std::max(mStatistics.mMaxGraphTime, graph->GetEvaluationTime());
+		mStatistics.mAverageGraphTime += graph->GetEvaluationTime();
+	}
+
+	if (!mGraphs.empty())
+		mStatistics.mAverageGraphTime /= static_cast<float>(mGraphs.size());
+}
+
+AnimationGraphStatistics AnimationGraphBatch::GetStatistics() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mStatistics;
+}
\ No newline at end of file
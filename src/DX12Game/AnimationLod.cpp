@@ -0,0 +1,145 @@
+#include "DX12Game/AnimationLod.h"
+#include "DX12Game/SkinnedData.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Game;
+
+AnimationLod::AnimationLod() {
+	// Full detail close up; the farther levels halve the update rate and drop the leaf bones.
+	mLevels[0] = { 0.25f, 1, 0 };
+	mLevels[1] = { 0.1f, 2, 0 };
+	mLevels[2] = { 0.04f, 4, 1 };
+	mLevels[3] = { 0.0f, 8, 2 };
+
+	for (auto& num : mNumPerLevel)
+		num.store(0);
+}
+
+void AnimationLod::SetLevel(std::uint32_t inLevel, const AnimationLodLevel& inDesc) {
+	if (inLevel >= MaxLevels)
+		return;
+
+	mLevels[inLevel] = inDesc;
+	mLevels[inLevel].mUpdateInterval = std::max(inDesc.mUpdateInterval, 1u);
+}
+
+const AnimationLodLevel& AnimationLod::GetLevel(std::uint32_t inLevel) const {
+	return mLevels[std::min(inLevel, MaxLevels - 1)];
+}
+
+float AnimationLod::ComputeScreenSize(float inRadius, float inDistance, float inFovY) {
+	if (inDistance <= inRadius)
+		return 1.0f;
+
+	return std::min(inRadius / (inDistance * std::tan(inFovY * 0.5f)), 1.0f);
+}
+
+std::uint32_t AnimationLod::SelectLevel(float inScreenSize, std::uint32_t inCurrLevel) const {
+	std::uint32_t level = 0;
+	for (; level < MaxLevels - 1; ++level) {
+		float threshold = mLevels[level].mMinScreenSize;
+		if (level < inCurrLevel)
+			threshold *= 1.0f + Hysteresis;
+
+		if (inScreenSize >= threshold)
+			break;
+	}
+
+	return level;
+}
+
+std::uint32_t AnimationLod::Register() {
+	return mNextSlot.fetch_add(1);
+}
+
+bool AnimationLod::ShouldUpdate(std::uint32_t inSlot, std::uint32_t inLevel, bool inForced) {
+	inLevel = std::min(inLevel, MaxLevels - 1);
+	mNumPerLevel[inLevel].fetch_add(1, std::memory_order_relaxed);
+
+	// Consecutive slots land on consecutive frames of the interval.
+	std::uint32_t interval = mLevels[inLevel].mUpdateInterval;
+	bool update = inForced || interval <= 1 || (mFrame + inSlot) % interval == 0;
+
+	if (update)
+		mNumUpdated.fetch_add(1, std::memory_order_relaxed);
+	else
+		mNumSkipped.fetch_add(1, std::memory_order_relaxed);
+
+	return update;
+}
+
+const std::vector<std::uint32_t>* AnimationLod::GetBoneMask(const SkinnedData* inSkinnedData, std::uint32_t inLevel) {
+	std::uint32_t maskedLeafLevels = GetLevel(inLevel).mMaskedLeafLevels;
+	if (inSkinnedData == nullptr || maskedLeafLevels == 0)
+		return nullptr;
+
+	std::lock_guard<std::mutex> lock(mMaskMutex);
+
+	auto& mask = mBoneMasks[std::make_pair(inSkinnedData, maskedLeafLevels)];
+	if (mask == nullptr) {
+		mask = std::make_unique<std::vector<std::uint32_t>>();
+		BuildBoneMask(inSkinnedData->mSkeleton, maskedLeafLevels, *mask);
+	}
+
+	return mask.get();
+}
+
+std::uint32_t AnimationLod::BuildBoneMask(const Skeleton& inSkeleton, std::uint32_t inMaskedLeafLevels,
+		std::vector<std::uint32_t>& outRemap) {
+	const auto& bones = inSkeleton.mBones;
+	const int numBones = static_cast<int>(bones.size());
+
+	auto getParent = [&bones, numBones](int inBone) {
+		int parent = bones[inBone].ParentIndex;
+		return parent >= 0 && parent < numBones ? parent : -1;
+	};
+
+	// Links from a bone to its deepest leaf; the walks are bounded, so a broken hierarchy can't loop.
+	std::vector<std::uint32_t> heights(numBones, 0);
+	for (int i = 0; i < numBones; ++i) {
+		std::uint32_t height = 0;
+		for (int p = getParent(i), steps = 0; p != -1 && steps < numBones; p = getParent(p), ++steps) {
+			++height;
+			if (heights[p] >= height)
+				break;
+			heights[p] = height;
+		}
+	}
+
+	outRemap.resize(numBones);
+
+	std::uint32_t numMasked = 0;
+	for (int i = 0; i < numBones; ++i) {
+		int kept = i;
+		for (int steps = 0; steps < numBones; ++steps) {
+			int parent = getParent(kept);
+			if (heights[kept] >= inMaskedLeafLevels || parent == -1)
+				break;
+			kept = parent;
+		}
+
+		outRemap[i] = static_cast<std::uint32_t>(kept);
+		if (kept != i)
+			++numMasked;
+	}
+
+	return numMasked;
+}
+
+void AnimationLod::BeginFrame() {
+	mStatistics.mNumUpdated = mNumUpdated.exchange(0);
+	mStatistics.mNumSkipped = mNumSkipped.exchange(0);
+	mStatistics.mNumSkeletons = 0;
+	for (std::uint32_t i = 0; i < MaxLevels; ++i) {
+		mStatistics.mNumPerLevel[i] = mNumPerLevel[i].exchange(0);
+		mStatistics.mNumSkeletons += mStatistics.mNumPerLevel[i];
+	}
+
+	++mFrame;
+}
+
+AnimationLodStatistics AnimationLod::GetStatistics() const {
+	return mStatistics;
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "DX12Game/AnimationsAtlas.h"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace Game;
+
+void AnimationsAtlas::Initialize(Line inNumLines) {
+	mNumLines = inNumLines;
+	mNumUsedLines = 0;
+
+	mAllocations.clear();
+	mFreeRanges.clear();
+	mDirtyRanges.clear();
+
+	if (inNumLines > 0)
+		mFreeRanges.push_back({ 0, inNumLines });
+}
+
+AnimationsAtlas::Line AnimationsAtlas::Allocate(Line inNumLines) {
+	if (inNumLines == 0)
+		return InvalidLine;
+
+	// Best fit, so the small clips fill the holes the removed ones leave
+	//  and the large spans stay available for the large clips.
+	auto best = mFreeRanges.end();
+	for (auto iter = mFreeRanges.begin(), end = mFreeRanges.end(); iter != end; ++iter) {
+		Line size = iter->mEnd - iter->mBegin;
+		if (size < inNumLines)
+			continue;
+
+		if (best == mFreeRanges.end() || size < best->mEnd - best->mBegin) {
+			best = iter;
+			if (size == inNumLines)
+				break;
+		}
+	}
+
+	if (best == mFreeRanges.end())
+		return InvalidLine;
+
+	Line first = best->mBegin;
+	best->mBegin += inNumLines;
+	if (best->mBegin == best->mEnd)
+		mFreeRanges.erase(best);
+
+	mAllocations.emplace(first, inNumLines);
+	mNumUsedLines += inNumLines;
+
+	MarkDirty(first, first + inNumLines);
+
+	return first;
+}
+
+bool AnimationsAtlas::Free(Line inFirstLine) {
+	auto iter = mAllocations.find(inFirstLine);
+	if (iter == mAllocations.end())
+		return false;
+
+	AnimationsAtlasRange range = { iter->first, iter->first + iter->second };
+	mNumUsedLines -= iter->second;
+	mAllocations.erase(iter);
+
+	auto next = std::lower_bound(mFreeRanges.begin(), mFreeRanges.end(), range.mBegin,
+		[](const AnimationsAtlasRange& inRange, Line inLine) { return inRange.mBegin < inLine; });
+
+	bool mergesPrev = next != mFreeRanges.begin() && std::prev(next)->mEnd == range.mBegin;
+	bool mergesNext = next != mFreeRanges.end() && next->mBegin == range.mEnd;
+
+	if (mergesPrev && mergesNext) {
+		std::prev(next)->mEnd = next->mEnd;
+		mFreeRanges.erase(next);
+	}
+	else if (mergesPrev) {
+		std::prev(next)->mEnd = range.mEnd;
+	}
+	else if (mergesNext) {
+		next->mBegin = range.mBegin;
+	}
+	else {
+		mFreeRanges.insert(next, range);
+	}
+
+	return true;
+}
+
+void AnimationsAtlas::MarkDirty(Line inBegin, Line inEnd) {
+	inEnd = std::min(inEnd, mNumLines);
+	if (inBegin >= inEnd)
+		return;
+
+	// The first range that ends at or after inBegin; it and the ones after it that start
+	//  at or before inEnd are merged with the new range.
+	auto first = std::lower_bound(mDirtyRanges.begin(), mDirtyRanges.end(), inBegin,
+		[](const AnimationsAtlasRange& inRange, Line inLine) { return inRange.mEnd < inLine; });
+	auto last = first;
+	while (last != mDirtyRanges.end() && last->mBegin <= inEnd)
+		++last;
+
+	if (first == last) {
+		mDirtyRanges.insert(first, { inBegin, inEnd });
+		return;
+	}
+
+	first->mBegin = std::min(first->mBegin, inBegin);
+	first->mEnd = std::max(std::prev(last)->mEnd, inEnd);
+	mDirtyRanges.erase(std::next(first), last);
+}
+
+const std::vector<AnimationsAtlasRange>& AnimationsAtlas::GetDirtyRanges() const {
+	return mDirtyRanges;
+}
+
+void AnimationsAtlas::ClearDirty() {
+	mDirtyRanges.clear();
+}
+
+AnimationsAtlas::Line AnimationsAtlas::GetNumLines() const {
+	return mNumLines;
+}
+
+AnimationsAtlas::Line AnimationsAtlas::GetAllocationSize(Line inFirstLine) const {
+	auto iter = mAllocations.find(inFirstLine);
+	return iter != mAllocations.end() ? iter->second : 0;
+}
+
+AnimationsAtlasStatistics AnimationsAtlas::GetStatistics() const {
+	AnimationsAtlasStatistics stats;
+	stats.mNumLines = mNumLines;
+	stats.mNumUsedLines = mNumUsedLines;
+	stats.mNumAllocations = static_cast<std::uint32_t>(mAllocations.size());
+
+	for (const auto& range : mFreeRanges)
+		stats.mLargestFreeSpan = std::max(stats.mLargestFreeSpan, range.mEnd - range.mBegin);
+
+	for (const auto& range : mDirtyRanges)
+		stats.mNumDirtyLines += range.mEnd - range.mBegin;
+
+	return stats;
+}
\ No newline at end of file
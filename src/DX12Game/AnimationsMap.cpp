@@ -1,5 +1,8 @@
 #include "DX12Game/AnimationsMap.h"
 
+#include <algorithm>
+#include <cstring>
+
 using namespace DirectX;
 using namespace DirectX::PackedVector;
 using namespace Microsoft::WRL;
@@ -7,35 +10,69 @@ using namespace Microsoft::WRL;
 namespace {
 	const size_t LineSize = 2048;
 	const double InvLineSize = static_cast<double>(1.0 / LineSize);
+
+	UINT64 AlignUp(UINT64 inValue, UINT64 inAlignment) {
+		return (inValue + inAlignment - 1) / inAlignment * inAlignment;
+	}
 }
 
 GameResult AnimationsMap::Initialize(ID3D12Device* inDevice) {
 	md3dDevice = inDevice;
 
-	mAnimations.resize(LineSize * LineSize);
+	mPendingClips.clear();
+	mAtlas.Initialize(static_cast<UINT>(LineSize));
 
 	CheckGameResult(BuildResource());
 
 	return GameResult(S_OK);
 }
 
-UINT AnimationsMap::AddAnimation(const std::string& inClipName, const DirectX::XMFLOAT4* inAnimCurves, 
-								 size_t inNumFrames, size_t inNumCurves) {
-	UINT ret = mCurrIndex;
-	UINT paddingSize = static_cast<UINT>(LineSize - inNumCurves * 4);
+GameResult AnimationsMap::AddAnimation(const std::string& inClipName, const DirectX::XMFLOAT4* inAnimCurves, 
+								 size_t inNumFrames, size_t inNumCurves, UINT& outClipIndex) {
+	size_t frameSize = inNumCurves * 4;
+	if (frameSize > LineSize) {
+		std::wstringstream wsstream;
+		wsstream << L"A frame of the clip(" << inClipName.c_str() << L") doesn't fit in a line of the animations map; "
+			<< inNumCurves << L" tracks > " << LineSize / 4;
+		ReturnGameResult(E_INVALIDARG, wsstream.str());
+	}
 
-	for (size_t frame = 0; frame < inNumFrames; ++frame) {
-		size_t idx = frame * inNumCurves * 4;		
+	UINT line = inNumFrames <= LineSize ? mAtlas.Allocate(static_cast<UINT>(inNumFrames)) : Game::AnimationsAtlas::InvalidLine;
+	if (line == Game::AnimationsAtlas::InvalidLine) {
+		auto stats = mAtlas.GetStatistics();
 
-		for (size_t curve = 0; curve < inNumCurves; ++curve) {
-			for (size_t row = 0; row < 4; ++row)
-				mAnimations[mCurrIndex++] = inAnimCurves[idx + (curve * 4) + row];
-		}
+		std::wstringstream wsstream;
+		wsstream << L"The animations map is full; clip(" << inClipName.c_str() << L") needs " << inNumFrames
+			<< L" lines, the largest free span is " << stats.mLargestFreeSpan << L" lines";
+		ReturnGameResult(E_OUTOFMEMORY, wsstream.str());
+	}
+
+	// The shaders only read the texels of the clip's tracks, so what a removed clip left
+	//  in the rest of the lines doesn't need clearing.
+	if (frameSize > 0) {
+		PendingClip clip;
+		clip.mFirstLine = line;
+		clip.mNumLines = static_cast<UINT>(inNumFrames);
+		clip.mFrameSize = static_cast<UINT>(frameSize);
+		clip.mTexels.assign(inAnimCurves, inAnimCurves + inNumFrames * frameSize);
 
-		mCurrIndex += paddingSize;
+		mPendingClips.push_back(std::move(clip));
 	}
 
-	return ret;
+	outClipIndex = static_cast<UINT>(line * LineSize);
+
+	return GameResultOk;
+}
+
+void AnimationsMap::RemoveAnimation(UINT inClipIndex) {
+	UINT line = static_cast<UINT>(inClipIndex / LineSize);
+
+	// A clip removed before its upload would otherwise overwrite the clip that takes its lines.
+	mPendingClips.erase(std::remove_if(mPendingClips.begin(), mPendingClips.end(), [line](const PendingClip& inClip) {
+		return inClip.mFirstLine == line;
+	}), mPendingClips.end());
+
+	mAtlas.Free(line);
 }
 
 void AnimationsMap::BuildDescriptors(
@@ -49,24 +86,85 @@ void AnimationsMap::BuildDescriptors(
 	BuildDescriptors();
 }
 
-void AnimationsMap::UpdateAnimationsMap(ID3D12GraphicsCommandList* outCmdList) {
-	D3D12_SUBRESOURCE_DATA subResourceData = {};
-	subResourceData.pData = mAnimations.data();
-	subResourceData.RowPitch = LineSize * sizeof(XMFLOAT4);
-	subResourceData.SlicePitch = subResourceData.RowPitch * LineSize;
+bool AnimationsMap::HasPendingUploads() const {
+	return !mPendingClips.empty();
+}
+
+GameResult AnimationsMap::UpdateAnimationsMap(ID3D12GraphicsCommandList* outCmdList, ComPtr<ID3D12Resource>& outUploadBuffer) {
+	outUploadBuffer = nullptr;
+
+	if (mPendingClips.empty()) {
+		mAtlas.ClearDirty();
+		return GameResultOk;
+	}
 
 	//
-	// Schedule to copy the data to the default resource, and change states.
-	// Note that mCurrSol is put in the GENERIC_READ state so it can be 
-	// read by a shader.
+	// Lay the frames of every pending clip out in one upload buffer, a footprint per clip
+	//  that only spans the texels of its tracks.
 	//
+	std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints(mPendingClips.size());
+
+	UINT64 uploadBufferSize = 0;
+	for (size_t i = 0, end = mPendingClips.size(); i < end; ++i) {
+		const auto& clip = mPendingClips[i];
+		auto& footprint = footprints[i];
+
+		footprint.Offset = AlignUp(uploadBufferSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+		footprint.Footprint.Format = AnimationsMap::AnimationsMapFormat;
+		footprint.Footprint.Width = clip.mFrameSize;
+		footprint.Footprint.Height = clip.mNumLines;
+		footprint.Footprint.Depth = 1;
+		footprint.Footprint.RowPitch = static_cast<UINT>(
+			AlignUp(clip.mFrameSize * sizeof(XMFLOAT4), D3D12_TEXTURE_DATA_PITCH_ALIGNMENT));
+
+		uploadBufferSize = footprint.Offset + static_cast<UINT64>(footprint.Footprint.RowPitch) * clip.mNumLines;
+	}
+
+	ReturnIfFailed(md3dDevice->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize),
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(outUploadBuffer.GetAddressOf()))
+	);
+
+	BYTE* mappedData = nullptr;
+	ReturnIfFailed(outUploadBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mappedData)));
 
+	for (size_t i = 0, end = mPendingClips.size(); i < end; ++i) {
+		const auto& clip = mPendingClips[i];
+		const auto& footprint = footprints[i];
+
+		for (UINT line = 0; line < clip.mNumLines; ++line) {
+			std::memcpy(mappedData + footprint.Offset + static_cast<UINT64>(line) * footprint.Footprint.RowPitch,
+				clip.mTexels.data() + static_cast<size_t>(line) * clip.mFrameSize, clip.mFrameSize * sizeof(XMFLOAT4));
+		}
+	}
+
+	outUploadBuffer->Unmap(0, nullptr);
+
+	//
+	// Copy the clips to their lines of the default resource.
+	// Note that the texture is put back in the GENERIC_READ state so it can be 
+	//  read by a shader.
+	//
 	outCmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mAnimsMap.Get(),
 		D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_STATE_COPY_DEST));
-	UpdateSubresources(outCmdList, mAnimsMap.Get(), mAnimsMapUploadBuffer.Get(),
-		0, 0, mNumSubresources, &subResourceData);
+
+	CD3DX12_TEXTURE_COPY_LOCATION dst(mAnimsMap.Get(), 0);
+	for (size_t i = 0, end = mPendingClips.size(); i < end; ++i) {
+		CD3DX12_TEXTURE_COPY_LOCATION src(outUploadBuffer.Get(), footprints[i]);
+		outCmdList->CopyTextureRegion(&dst, 0, mPendingClips[i].mFirstLine, 0, &src, nullptr);
+	}
+
 	outCmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mAnimsMap.Get(),
 		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ));
+
+	mPendingClips.clear();
+	mAtlas.ClearDirty();
+
+	return GameResultOk;
 }
 
 ID3D12Resource* AnimationsMap::GetAnimationsMap() const {
@@ -85,6 +183,10 @@ double AnimationsMap::GetInvLineSize() const {
 	return InvLineSize;
 }
 
+Game::AnimationsAtlasStatistics AnimationsMap::GetStatistics() const {
+	return mAtlas.GetStatistics();
+}
+
 GameResult AnimationsMap::BuildResource() {
 	// Free the old resources if they exist.
 	mAnimsMap = nullptr;
@@ -112,23 +214,6 @@ GameResult AnimationsMap::BuildResource() {
 		IID_PPV_ARGS(&mAnimsMap)
 	));
 
-	//
-	// In order to copy CPU memory data into our default buffer,
-	//  we need to create an intermediate upload heap. 
-	//
-
-	mNumSubresources = texDesc.DepthOrArraySize * texDesc.MipLevels;
-	const UINT64 uploadBufferSize = GetRequiredIntermediateSize(mAnimsMap.Get(), 0, mNumSubresources);
-
-	ReturnIfFailed(md3dDevice->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(mAnimsMapUploadBuffer.GetAddressOf()))
-	);
-
 	return GameResult(S_OK);
 }
 
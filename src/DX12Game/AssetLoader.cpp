@@ -0,0 +1,220 @@
+#include "DX12Game/AssetLoader.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace Game;
+
+AssetLoader::~AssetLoader() {
+	CleanUp();
+}
+
+void AssetLoader::Initialize(std::uint32_t inNumWorkers) {
+	CleanUp();
+
+	bTerminated = false;
+
+	for (std::uint32_t i = 0, end = std::max(inNumWorkers, 1u); i < end; ++i)
+		mWorkers.emplace_back(&AssetLoader::WorkerFunc, this);
+}
+
+void AssetLoader::CleanUp() {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		bTerminated = true;
+	}
+	mCondVar.notify_all();
+	mReadyCondVar.notify_all();
+
+	for (auto& worker : mWorkers)
+		worker.join();
+	mWorkers.clear();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mEntries.clear();
+	mLoadQueue = std::priority_queue<QueueNode>();
+	mReadyQueue = std::priority_queue<QueueNode>();
+	mNumQueued = 0;
+	mNumLoading = 0;
+	mNumReady = 0;
+}
+
+bool AssetLoader::Request(const AssetRequest& inRequest, Callback inCallback) {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		auto iter = mEntries.find(inRequest.mKey);
+		if (iter != mEntries.end()) {
+			auto& entry = iter->second;
+			if (inCallback)
+				entry->mCallbacks.push_back(std::move(inCallback));
+
+			++mNumDeduplicated;
+
+			if (inRequest.mPriority > entry->mRequest.mPriority) {
+				entry->mRequest.mPriority = inRequest.mPriority;
+
+				// The node with the old priority stays in the queue and is skipped once the entry leaves the state.
+				if (entry->mState == EQueued)
+					mLoadQueue.push({ inRequest.mPriority, mNextSequence++, entry });
+				else if (entry->mState == EReady)
+					mReadyQueue.push({ inRequest.mPriority, mNextSequence++, entry });
+			}
+
+			return false;
+		}
+
+		auto entry = std::make_shared<Entry>();
+		entry->mRequest = inRequest;
+		if (inCallback)
+			entry->mCallbacks.push_back(std::move(inCallback));
+
+		mEntries.emplace(inRequest.mKey, entry);
+		mLoadQueue.push({ inRequest.mPriority, mNextSequence++, entry });
+		++mNumQueued;
+	}
+
+	mCondVar.notify_one();
+
+	return true;
+}
+
+std::uint32_t AssetLoader::Pump(std::uint64_t inUploadBudget) {
+	std::uint32_t numCompleted = 0;
+	std::uint64_t uploadedBytes = 0;
+
+	while (uploadedBytes < inUploadBudget || numCompleted == 0) {
+		std::shared_ptr<Entry> entry;
+		std::vector<Callback> callbacks;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (!PopValid(mReadyQueue, EReady, entry))
+				break;
+
+			// Requests made from now on start a new load; the owner is expected to cache the result.
+			mEntries.erase(entry->mRequest.mKey);
+			--mNumReady;
+
+			callbacks.swap(entry->mCallbacks);
+		}
+
+		bool succeeded = entry->bLoaded;
+		if (succeeded && entry->mRequest.mUpload) {
+			try {
+				succeeded = entry->mRequest.mUpload();
+			}
+			catch (...) {
+				succeeded = false;
+			}
+		}
+
+		for (auto& callback : callbacks)
+			callback(succeeded);
+
+		uploadedBytes += entry->mUploadBytes;
+		++numCompleted;
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		++mNumCompleted;
+		if (!succeeded)
+			++mNumFailed;
+		else
+			mUploadedBytes += entry->mUploadBytes;
+	}
+
+	return numCompleted;
+}
+
+void AssetLoader::Flush() {
+	while (true) {
+		Pump(std::numeric_limits<std::uint64_t>::max());
+
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (mEntries.empty() || bTerminated)
+			return;
+
+		mReadyCondVar.wait(lock, [&]() -> bool {
+			return !mReadyQueue.empty() || bTerminated;
+		});
+	}
+}
+
+bool AssetLoader::IsIdle() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mEntries.empty();
+}
+
+AssetLoaderStatistics AssetLoader::GetStatistics() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	AssetLoaderStatistics stats;
+	stats.mNumQueued = mNumQueued;
+	stats.mNumLoading = mNumLoading;
+	stats.mNumReady = mNumReady;
+	stats.mNumDeduplicated = mNumDeduplicated;
+	stats.mNumCompleted = mNumCompleted;
+	stats.mNumFailed = mNumFailed;
+	stats.mUploadedBytes = mUploadedBytes;
+
+	return stats;
+}
+
+void AssetLoader::WorkerFunc() {
+	while (true) {
+		std::shared_ptr<Entry> entry;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCondVar.wait(lock, [&]() -> bool {
+				return bTerminated || !mLoadQueue.empty();
+			});
+
+			if (bTerminated)
+				return;
+
+			if (!PopValid(mLoadQueue, EQueued, entry))
+				continue;
+
+			entry->mState = ELoading;
+			--mNumQueued;
+			++mNumLoading;
+		}
+
+		std::uint64_t uploadBytes = 0;
+		bool loaded = false;
+		try {
+			loaded = entry->mRequest.mLoad ? entry->mRequest.mLoad(uploadBytes) : true;
+		}
+		catch (...) {
+			loaded = false;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			entry->bLoaded = loaded;
+			entry->mUploadBytes = uploadBytes;
+			entry->mState = EReady;
+			--mNumLoading;
+			++mNumReady;
+
+			mReadyQueue.push({ entry->mRequest.mPriority, mNextSequence++, entry });
+		}
+
+		mReadyCondVar.notify_all();
+	}
+}
+
+bool AssetLoader::PopValid(std::priority_queue<QueueNode>& ioQueue, EAssetState inState, std::shared_ptr<Entry>& outEntry) {
+	while (!ioQueue.empty()) {
+		QueueNode node = ioQueue.top();
+		ioQueue.pop();
+
+		// A raised priority leaves an older node behind; only the first node of each state counts.
+		if (node.mEntry->mState == inState && node.mPriority == node.mEntry->mRequest.mPriority) {
+			outEntry = std::move(node.mEntry);
+			return true;
+		}
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "DX12Game/CookedMesh.h"
+#include "common/MappedFile.h"
+
+#include <cstring>
+#include <fstream>
+
+using namespace Game;
+
+namespace {
+	std::uint64_t AlignUp(std::uint64_t inValue, std::uint64_t inAlignment) {
+		return (inValue + inAlignment - 1) / inAlignment * inAlignment;
+	}
+}
+
+void CookedMeshWriter::SetFlags(std::uint32_t inFlags) {
+	mFlags = inFlags;
+}
+
+void CookedMeshWriter::SetSourceKey(std::uint64_t inKey) {
+	mSourceKey = inKey;
+}
+
+void CookedMeshWriter::AddSection(CookedMesh::SectionType inType, std::uint32_t inElementSize, const void* inData, size_t inCount) {
+	auto& section = mSections[inType];
+	section.mElementSize = inElementSize;
+	section.mCount = inCount;
+	section.mData.resize(static_cast<size_t>(inElementSize) * inCount);
+	if (!section.mData.empty())
+		std::memcpy(section.mData.data(), inData, section.mData.size());
+	section.bUsed = true;
+}
+
+CookedString CookedMeshWriter::AddString(const std::string& inString) {
+	CookedString str;
+	str.mOffset = static_cast<std::uint32_t>(mStrings.size());
+	str.mLength = static_cast<std::uint32_t>(inString.length());
+
+	mStrings.insert(mStrings.end(), inString.begin(), inString.end());
+
+	return str;
+}
+
+bool CookedMeshWriter::Write(const std::string& inFileName) const {
+	std::vector<CookedSection> table;
+	std::vector<const void*> payloads;
+
+	for (std::uint32_t type = 0; type < CookedMesh::SectionType::Count; ++type) {
+		const auto& pending = mSections[type];
+		if (type == CookedMesh::SectionType::EStrings) {
+			if (mStrings.empty())
+				continue;
+
+			CookedSection section = {};
+			section.mType = type;
+			section.mElementSize = 1;
+			section.mCount = mStrings.size();
+			table.push_back(section);
+			payloads.push_back(mStrings.data());
+		}
+		else if (pending.bUsed) {
+			CookedSection section = {};
+			section.mType = type;
+			section.mElementSize = pending.mElementSize;
+			section.mCount = pending.mCount;
+			table.push_back(section);
+			payloads.push_back(pending.mData.data());
+		}
+	}
+
+	std::uint64_t offset = AlignUp(sizeof(CookedMeshHeader) + sizeof(CookedSection) * table.size(), CookedMesh::SectionAlignment);
+	for (auto& section : table) {
+		section.mOffset = offset;
+		offset = AlignUp(offset + section.mElementSize * section.mCount, CookedMesh::SectionAlignment);
+	}
+
+	CookedMeshHeader header = {};
+	header.mMagic = CookedMesh::Magic;
+	header.mVersion = CookedMesh::Version;
+	header.mFlags = mFlags;
+	header.mNumSections = static_cast<std::uint32_t>(table.size());
+	header.mFileSize = offset;
+	header.mSourceKey = mSourceKey;
+
+	std::vector<std::uint8_t> buffer(static_cast<size_t>(offset), 0);
+	std::memcpy(buffer.data(), &header, sizeof(CookedMeshHeader));
+	if (!table.empty())
+		std::memcpy(buffer.data() + sizeof(CookedMeshHeader), table.data(), sizeof(CookedSection) * table.size());
+
+	for (size_t i = 0, end = table.size(); i < end; ++i) {
+		size_t size = static_cast<size_t>(table[i].mElementSize * table[i].mCount);
+		if (size > 0)
+			std::memcpy(buffer.data() + table[i].mOffset, payloads[i], size);
+	}
+
+	std::ofstream file(inFileName, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+	return file.good();
+}
+
+bool CookedMeshView::Open(const MappedFile& inFile) {
+	return Open(inFile.GetData(), inFile.GetSize());
+}
+
+bool CookedMeshView::Open(const void* inData, std::uint64_t inSize) {
+	mData = nullptr;
+	mSize = 0;
+	mFlags = 0;
+	mSourceKey = 0;
+	for (auto& section : mSections)
+		section = nullptr;
+
+	if (inData == nullptr || inSize < sizeof(CookedMeshHeader))
+		return false;
+
+	const auto* data = static_cast<const std::uint8_t*>(inData);
+	const auto* header = reinterpret_cast<const CookedMeshHeader*>(data);
+	if (header->mMagic != CookedMesh::Magic || header->mVersion != CookedMesh::Version || header->mFileSize != inSize)
+		return false;
+
+	std::uint64_t tableEnd = sizeof(CookedMeshHeader) + sizeof(CookedSection) * static_cast<std::uint64_t>(header->mNumSections);
+	if (tableEnd > inSize)
+		return false;
+
+	const auto* table = reinterpret_cast<const CookedSection*>(data + sizeof(CookedMeshHeader));
+	for (std::uint32_t i = 0; i < header->mNumSections; ++i) {
+		const auto& section = table[i];
+		if (section.mType >= CookedMesh::SectionType::Count || section.mElementSize == 0)
+			return false;
+		if (section.mOffset % CookedMesh::SectionAlignment != 0 || section.mOffset < tableEnd || section.mOffset > inSize)
+			return false;
+		// Guards the multiplication below against overflow.
+		if (section.mCount > (inSize - section.mOffset) / section.mElementSize)
+			return false;
+
+		mSections[section.mType] = &section;
+	}
+
+	mData = data;
+	mSize = inSize;
+	mFlags = header->mFlags;
+	mSourceKey = header->mSourceKey;
+
+	return true;
+}
+
+std::uint32_t CookedMeshView::GetFlags() const {
+	return mFlags;
+}
+
+std::uint64_t CookedMeshView::GetSourceKey() const {
+	return mSourceKey;
+}
+
+bool CookedMeshView::HasSection(CookedMesh::SectionType inType) const {
+	return mSections[inType] != nullptr;
+}
+
+std::uint32_t CookedMeshView::GetElementSize(CookedMesh::SectionType inType) const {
+	return mSections[inType] != nullptr ? mSections[inType]->mElementSize : 0;
+}
+
+std::string CookedMeshView::GetString(const CookedString& inString) const {
+	auto strings = GetSection<char>(CookedMesh::SectionType::EStrings);
+	if (static_cast<std::uint64_t>(inString.mOffset) + inString.mLength > strings.mSize)
+		return std::string();
+
+	return std::string(strings.mData + inString.mOffset, inString.mLength);
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "DX12Game/CpuSkinning.h"
+#include "DX12Game/FrameResource.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <execution>
+#include <numeric>
+
+using namespace DirectX;
+using namespace Game;
+
+namespace {
+	// The dual quaternions Skin builds and the bounds of its chunks;
+	//  kept per thread so skinning doesn't allocate once they have grown.
+	thread_local std::vector<XMFLOAT4> tDualQuaternions;
+	thread_local std::vector<size_t> tChunks;
+	thread_local std::vector<XMFLOAT3> tChunkBounds;
+
+	// Influences in the shader order; the first bone index of -1 ends them.
+	struct VertexInfluences {
+		float mWeights[8];
+		int mIndices[8];
+	};
+
+	void LoadInfluences(const SkinnedVertex& inVertex, VertexInfluences& outInfluences) {
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(outInfluences.mWeights), XMLoadFloat4(&inVertex.mBoneWeights0));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(outInfluences.mWeights + 4), XMLoadFloat4(&inVertex.mBoneWeights1));
+		std::copy(inVertex.mBoneIndices0, inVertex.mBoneIndices0 + 4, outInfluences.mIndices);
+		std::copy(inVertex.mBoneIndices1, inVertex.mBoneIndices1 + 4, outInfluences.mIndices + 4);
+	}
+
+	void StoreNormalized(XMFLOAT3* outVector, FXMVECTOR inVector) {
+		XMVECTOR lengthSq = XMVector3LengthSq(inVector);
+		XMStoreFloat3(outVector, XMVector3LessOrEqual(lengthSq, g_XMEpsilon) ? inVector : XMVector3Normalize(inVector));
+	}
+
+	//* Weighted sum of the skinning matrices(rows r0 ~ r3).
+	void BlendMatrices(const SkinningJob& inJob, const VertexInfluences& inInfluences, XMMATRIX& outMatrix) {
+		XMVECTOR r0 = XMVectorZero();
+		XMVECTOR r1 = XMVectorZero();
+		XMVECTOR r2 = XMVectorZero();
+		XMVECTOR r3 = XMVectorZero();
+
+		for (int i = 0; i < 8; ++i) {
+			int index = inInfluences.mIndices[i];
+			if (index == -1)
+				break;
+			if (index < 0 || static_cast<size_t>(index) >= inJob.mPaletteSize)
+				continue;
+
+			const XMFLOAT4X4& m = inJob.mSkinningPalette[index];
+			XMVECTOR w = XMVectorReplicate(inInfluences.mWeights[i]);
+			r0 = XMVectorMultiplyAdd(w, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(m.m[0])), r0);
+			r1 = XMVectorMultiplyAdd(w, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(m.m[1])), r1);
+			r2 = XMVectorMultiplyAdd(w, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(m.m[2])), r2);
+			r3 = XMVectorMultiplyAdd(w, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(m.m[3])), r3);
+		}
+
+		outMatrix.r[0] = r0;
+		outMatrix.r[1] = r1;
+		outMatrix.r[2] = r2;
+		outMatrix.r[3] = r3;
+	}
+
+	//* Weighted sum of the dual quaternions, each flipped to the hemisphere of the first one, normalized.
+	void BlendDualQuaternions(const SkinningJob& inJob, const VertexInfluences& inInfluences,
+			XMVECTOR& outReal, XMVECTOR& outDual) {
+		XMVECTOR real = XMVectorZero();
+		XMVECTOR dual = XMVectorZero();
+		XMVECTOR pivot = XMVectorZero();
+		bool hasPivot = false;
+
+		for (int i = 0; i < 8; ++i) {
+			int index = inInfluences.mIndices[i];
+			if (index == -1)
+				break;
+			if (index < 0 || static_cast<size_t>(index) >= inJob.mPaletteSize)
+				continue;
+
+			XMVECTOR q = XMLoadFloat4(&inJob.mDualQuaternions[index * 2]);
+			XMVECTOR d = XMLoadFloat4(&inJob.mDualQuaternions[index * 2 + 1]);
+			if (!hasPivot) {
+				pivot = q;
+				hasPivot = true;
+			}
+
+			float weight = inInfluences.mWeights[i];
+			if (XMVectorGetX(XMVector4Dot(pivot, q)) < 0.0f)
+				weight = -weight;
+
+			XMVECTOR w = XMVectorReplicate(weight);
+			real = XMVectorMultiplyAdd(w, q, real);
+			dual = XMVectorMultiplyAdd(w, d, dual);
+		}
+
+		XMVECTOR length = XMVector4Length(real);
+		if (XMVectorGetX(length) <= 1e-6f) {
+			outReal = XMQuaternionIdentity();
+			outDual = XMVectorZero();
+			return;
+		}
+
+		outReal = XMVectorDivide(real, length);
+		outDual = XMVectorDivide(dual, length);
+	}
+}
+
+SkinningResult CpuSkinning::Skin(const SkinningJob& inJob) {
+	auto beginTime = std::chrono::steady_clock::now();
+
+	SkinningResult result;
+	if (inJob.mNumVertices == 0)
+		return result;
+
+	SkinningJob job = inJob;
+	if (job.mMethod == SkinningJob::EDualQuaternion && job.mDualQuaternions == nullptr) {
+		if (tDualQuaternions.size() < job.mPaletteSize * 2)
+			tDualQuaternions.resize(job.mPaletteSize * 2);
+
+		BuildDualQuaternions(job.mSkinningPalette, job.mPaletteSize, tDualQuaternions.data());
+		job.mDualQuaternions = tDualQuaternions.data();
+	}
+
+	size_t numChunks = (job.mNumVertices + ChunkSize - 1) / ChunkSize;
+	tChunks.resize(numChunks);
+	std::iota(tChunks.begin(), tChunks.end(), static_cast<size_t>(0));
+	// Min and max per chunk.
+	tChunkBounds.resize(numChunks * 2);
+
+	XMFLOAT3* chunkBounds = tChunkBounds.data();
+	std::for_each(std::execution::par, tChunks.begin(), tChunks.end(), [&job, chunkBounds](size_t inChunk) {
+		size_t begin = inChunk * ChunkSize;
+		size_t end = std::min(begin + ChunkSize, job.mNumVertices);
+
+		XMVECTOR boundsMin = XMVectorReplicate(FLT_MAX);
+		XMVECTOR boundsMax = XMVectorReplicate(-FLT_MAX);
+		SkinRange(job, begin, end, boundsMin, boundsMax);
+
+		XMStoreFloat3(&chunkBounds[inChunk * 2], boundsMin);
+		XMStoreFloat3(&chunkBounds[inChunk * 2 + 1], boundsMax);
+	});
+
+	XMVECTOR boundsMin = XMVectorReplicate(FLT_MAX);
+	XMVECTOR boundsMax = XMVectorReplicate(-FLT_MAX);
+	for (size_t i = 0; i < numChunks; ++i) {
+		boundsMin = XMVectorMin(boundsMin, XMLoadFloat3(&chunkBounds[i * 2]));
+		boundsMax = XMVectorMax(boundsMax, XMLoadFloat3(&chunkBounds[i * 2 + 1]));
+	}
+
+	XMStoreFloat3(&result.mBoundsMin, boundsMin);
+	XMStoreFloat3(&result.mBoundsMax, boundsMax);
+
+	result.mTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - beginTime).count();
+	if (result.mTime > 0.0f)
+		result.mVerticesPerSecond = static_cast<float>(job.mNumVertices) / (result.mTime * 0.001f);
+
+	return result;
+}
+
+void CpuSkinning::SkinRange(const SkinningJob& inJob, size_t inBegin, size_t inEnd,
+		XMVECTOR& ioBoundsMin, XMVECTOR& ioBoundsMax) {
+	VertexInfluences influences;
+
+	for (size_t v = inBegin; v < inEnd; ++v) {
+		const SkinnedVertex& vertex = inJob.mVertices[v];
+		LoadInfluences(vertex, influences);
+
+		XMVECTOR pos = XMLoadFloat3(&vertex.mPos);
+		XMVECTOR normal;
+		XMVECTOR tangent;
+
+		if (inJob.mMethod == SkinningJob::EDualQuaternion) {
+			XMVECTOR real;
+			XMVECTOR dual;
+			BlendDualQuaternions(inJob, influences, real, dual);
+
+			// t = 2 * dual * conjugate(real)
+			XMVECTOR trans = XMVectorScale(XMQuaternionMultiply(XMQuaternionConjugate(real), dual), 2.0f);
+
+			pos = XMVectorAdd(XMVector3Rotate(pos, real), trans);
+			normal = XMVector3Rotate(XMLoadFloat3(&vertex.mNormal), real);
+			tangent = XMVector3Rotate(XMLoadFloat3(&vertex.mTangentU), real);
+		}
+		else {
+			// Assume no nonuniform scaling when transforming normals, like the shaders.
+			XMMATRIX m;
+			BlendMatrices(inJob, influences, m);
+
+			pos = XMVector3Transform(pos, m);
+			normal = XMVector3TransformNormal(XMLoadFloat3(&vertex.mNormal), m);
+			tangent = XMVector3TransformNormal(XMLoadFloat3(&vertex.mTangentU), m);
+		}
+
+		XMStoreFloat3(&inJob.mPositions[v], pos);
+		if (inJob.mNormals != nullptr)
+			StoreNormalized(&inJob.mNormals[v], normal);
+		if (inJob.mTangents != nullptr)
+			StoreNormalized(&inJob.mTangents[v], tangent);
+
+		ioBoundsMin = XMVectorMin(ioBoundsMin, pos);
+		ioBoundsMax = XMVectorMax(ioBoundsMax, pos);
+	}
+}
+
+void CpuSkinning::BuildDualQuaternions(const XMFLOAT4X4* inSkinningPalette, size_t inPaletteSize,
+		XMFLOAT4* outDualQuaternions) {
+	for (size_t i = 0; i < inPaletteSize; ++i) {
+		XMVECTOR scale;
+		XMVECTOR real;
+		XMVECTOR trans;
+		if (!XMMatrixDecompose(&scale, &real, &trans, XMLoadFloat4x4(&inSkinningPalette[i]))) {
+			real = XMQuaternionIdentity();
+			trans = XMVectorZero();
+		}
+
+		real = XMQuaternionNormalize(real);
+		// dual = 0.5 * (t, 0) * real; XMQuaternionMultiply(a, b) is b * a.
+		XMVECTOR dual = XMVectorScale(XMQuaternionMultiply(real, XMVectorSetW(trans, 0.0f)), 0.5f);
+
+		XMStoreFloat4(&outDualQuaternions[i * 2], real);
+		XMStoreFloat4(&outDualQuaternions[i * 2 + 1], dual);
+	}
+}
\ No newline at end of file
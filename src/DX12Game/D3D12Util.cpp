@@ -1,10 +1,36 @@
 #include "DX12Game/D3D12Util.h"
 
+#include <filesystem>
 #include <fstream>
 #include <atlcomcli.h>
 
 using namespace Microsoft::WRL;
 
+// DdsFile keeps the formats as plain DXGI_FORMAT values.
+static_assert(DXGI_FORMAT_BC7_UNORM_SRGB == 99 && DXGI_FORMAT_B4G4R4A4_UNORM == 115, "Unexpected DXGI_FORMAT values");
+static_assert(D3D12_REQ_MIP_LEVELS == Game::Dds::MaxMipLevels, "Unexpected mip level limit");
+
+namespace {
+	bool BuildTextureDesc(const Game::DdsTextureDesc& inDds, const Game::DdsSubresource& inTop, UINT inNumMips,
+			D3D12_RESOURCE_DESC& outDesc) {
+		DXGI_FORMAT format = static_cast<DXGI_FORMAT>(inDds.mFormat);
+
+		switch (inDds.mDimension) {
+		case Game::Dds::ETexture1D:
+			outDesc = CD3DX12_RESOURCE_DESC::Tex1D(format, inTop.mWidth, static_cast<UINT16>(inDds.mArraySize), static_cast<UINT16>(inNumMips));
+			return true;
+		case Game::Dds::ETexture2D:
+			outDesc = CD3DX12_RESOURCE_DESC::Tex2D(format, inTop.mWidth, inTop.mHeight, static_cast<UINT16>(inDds.mArraySize), static_cast<UINT16>(inNumMips));
+			return true;
+		case Game::Dds::ETexture3D:
+			outDesc = CD3DX12_RESOURCE_DESC::Tex3D(format, inTop.mWidth, inTop.mHeight, static_cast<UINT16>(inTop.mDepth), static_cast<UINT16>(inNumMips));
+			return true;
+		default:
+			return false;
+		}
+	}
+}
+
 GameResult D3D12Util::LoadBinary(const std::wstring& inFilename, ComPtr<ID3DBlob>& outBlob) {
 	std::ifstream fin(inFilename, std::ios::binary);
 
@@ -70,6 +96,174 @@ GameResult D3D12Util::CreateDefaultBuffer(
 	return GameResult(S_OK);
 }
 
+GameResult D3D12Util::CreateTextureFromDds(
+		ID3D12Device* inDevice,
+		ID3D12GraphicsCommandList* inCmdList,
+		const Game::DdsFile& inFile,
+		UINT inFirstMip,
+		UINT inNumMips,
+		ComPtr<ID3D12Resource>& outTexture,
+		ComPtr<ID3D12Resource>& outUploadHeap) {
+	std::vector<Game::DdsSubresource> subresources;
+	if (!inFile.IsValid() || !inFile.GetSubresources(inFirstMip, inNumMips, subresources))
+		ReturnGameResult(E_INVALIDARG, L"Invalid mip range of the DDS texture");
+
+	D3D12_RESOURCE_DESC texDesc;
+	if (!BuildTextureDesc(inFile.GetDesc(), subresources.front(), inNumMips, texDesc))
+		ReturnGameResult(E_INVALIDARG, L"Unknown dimension of the DDS texture");
+
+	ReturnIfFailed(inDevice->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+		D3D12_HEAP_FLAG_NONE,
+		&texDesc,
+		D3D12_RESOURCE_STATE_COPY_DEST,
+		nullptr,
+		IID_PPV_ARGS(outTexture.ReleaseAndGetAddressOf()))
+	);
+
+	UINT numSubresources = static_cast<UINT>(subresources.size());
+	UINT64 uploadSize = GetRequiredIntermediateSize(outTexture.Get(), 0, numSubresources);
+
+	ReturnIfFailed(inDevice->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(uploadSize),
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(outUploadHeap.ReleaseAndGetAddressOf()))
+	);
+
+	// The source rows are read in place from the DDS file; UpdateSubresources copies them
+	//  into the upload heap on the CPU, so the file may be closed after this call.
+	std::vector<D3D12_SUBRESOURCE_DATA> initData(numSubresources);
+	for (UINT i = 0; i < numSubresources; ++i) {
+		initData[i].pData = subresources[i].mData;
+		initData[i].RowPitch = static_cast<LONG_PTR>(subresources[i].mRowPitch);
+		initData[i].SlicePitch = static_cast<LONG_PTR>(subresources[i].mSlicePitch);
+	}
+
+	UpdateSubresources(inCmdList, outTexture.Get(), outUploadHeap.Get(), 0, 0, numSubresources, initData.data());
+	inCmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(outTexture.Get(),
+		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+
+	return GameResultOk;
+}
+
+GameResult D3D12Util::RecreateTextureFromDds(
+		ID3D12Device* inDevice,
+		ID3D12GraphicsCommandList* inCmdList,
+		const Game::DdsFile& inFile,
+		UINT inFirstMip,
+		UINT inNumMips,
+		ID3D12Resource* inSrcTexture,
+		UINT inSrcFirstMip,
+		ComPtr<ID3D12Resource>& outTexture,
+		ComPtr<ID3D12Resource>& outUploadHeap) {
+	std::vector<Game::DdsSubresource> subresources;
+	if (!inFile.IsValid() || !inFile.GetSubresources(inFirstMip, inNumMips, subresources))
+		ReturnGameResult(E_INVALIDARG, L"Invalid mip range of the DDS texture");
+
+	const auto& dds = inFile.GetDesc();
+	const UINT srcNumMips = inSrcTexture->GetDesc().MipLevels;
+	// Both textures hold the levels down to the last one of the file.
+	if (inFirstMip + inNumMips != dds.mMipCount || inSrcFirstMip + srcNumMips != dds.mMipCount)
+		ReturnGameResult(E_INVALIDARG, L"Invalid mip range of the source texture");
+
+	D3D12_RESOURCE_DESC texDesc;
+	if (!BuildTextureDesc(dds, subresources.front(), inNumMips, texDesc))
+		ReturnGameResult(E_INVALIDARG, L"Unknown dimension of the DDS texture");
+
+	ReturnIfFailed(inDevice->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+		D3D12_HEAP_FLAG_NONE,
+		&texDesc,
+		D3D12_RESOURCE_STATE_COPY_DEST,
+		nullptr,
+		IID_PPV_ARGS(outTexture.ReleaseAndGetAddressOf()))
+	);
+
+	const UINT arraySize = dds.mArraySize;
+	// Only the finer levels the source doesn't hold are read from the file.
+	const UINT numUploadedMips = inSrcFirstMip > inFirstMip ? inSrcFirstMip - inFirstMip : 0;
+
+	outUploadHeap.Reset();
+	if (numUploadedMips > 0) {
+		// The levels of each array slice are contiguous subresources, uploaded from an aligned offset of the heap.
+		std::vector<UINT64> offsets(arraySize);
+		UINT64 uploadSize = 0;
+		for (UINT slice = 0; slice < arraySize; ++slice) {
+			const UINT64 alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+			offsets[slice] = uploadSize;
+			uploadSize += GetRequiredIntermediateSize(
+				outTexture.Get(), D3D12CalcSubresource(0, slice, 0, inNumMips, arraySize), numUploadedMips);
+			uploadSize = (uploadSize + alignment - 1) & ~(alignment - 1);
+		}
+
+		ReturnIfFailed(inDevice->CreateCommittedResource(
+			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+			D3D12_HEAP_FLAG_NONE,
+			&CD3DX12_RESOURCE_DESC::Buffer(uploadSize),
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(outUploadHeap.ReleaseAndGetAddressOf()))
+		);
+
+		std::vector<D3D12_SUBRESOURCE_DATA> initData(numUploadedMips);
+		for (UINT slice = 0; slice < arraySize; ++slice) {
+			for (UINT mip = 0; mip < numUploadedMips; ++mip) {
+				const auto& sub = subresources[static_cast<size_t>(slice) * inNumMips + mip];
+				initData[mip].pData = sub.mData;
+				initData[mip].RowPitch = static_cast<LONG_PTR>(sub.mRowPitch);
+				initData[mip].SlicePitch = static_cast<LONG_PTR>(sub.mSlicePitch);
+			}
+
+			UpdateSubresources(inCmdList, outTexture.Get(), outUploadHeap.Get(), offsets[slice],
+				D3D12CalcSubresource(0, slice, 0, inNumMips, arraySize), numUploadedMips, initData.data());
+		}
+	}
+
+	// The levels the source already holds are copied on the GPU.
+	if (numUploadedMips < inNumMips) {
+		inCmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(inSrcTexture,
+			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_SOURCE));
+
+		for (UINT slice = 0; slice < arraySize; ++slice) {
+			for (UINT mip = numUploadedMips; mip < inNumMips; ++mip) {
+				UINT srcMip = inFirstMip + mip - inSrcFirstMip;
+
+				CD3DX12_TEXTURE_COPY_LOCATION dst(outTexture.Get(), D3D12CalcSubresource(mip, slice, 0, inNumMips, arraySize));
+				CD3DX12_TEXTURE_COPY_LOCATION src(inSrcTexture, D3D12CalcSubresource(srcMip, slice, 0, srcNumMips, arraySize));
+				inCmdList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+			}
+		}
+
+		inCmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(inSrcTexture,
+			D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+	}
+
+	inCmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(outTexture.Get(),
+		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+
+	return GameResultOk;
+}
+
+GameResult D3D12Util::LoadDdsTexture(
+		ID3D12Device* inDevice,
+		ID3D12GraphicsCommandList* inCmdList,
+		const std::wstring& inFileName,
+		ComPtr<ID3D12Resource>& outTexture,
+		ComPtr<ID3D12Resource>& outUploadHeap,
+		UINT inMaxSize) {
+	Game::DdsFile file;
+	if (!file.Open(std::filesystem::path(inFileName).string()))
+		ReturnGameResult(E_FAIL, L"Failed to load the DDS file: " << inFileName);
+
+	UINT firstMip = file.GetFirstMipWithin(inMaxSize);
+	UINT numMips = file.GetDesc().mMipCount - firstMip;
+
+	return CreateTextureFromDds(inDevice, inCmdList, file, firstMip, numMips, outTexture, outUploadHeap);
+}
+
 GameResult D3D12Util::CompileShader(
 		const std::wstring& inFilename,
 		const D3D_SHADER_MACRO* inDefines,
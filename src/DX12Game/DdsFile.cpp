@@ -0,0 +1,525 @@
+#include "DX12Game/DdsFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Game;
+
+namespace {
+	constexpr std::uint32_t MakeFourCC(char inC0, char inC1, char inC2, char inC3) {
+		return static_cast<std::uint32_t>(static_cast<std::uint8_t>(inC0)) |
+			(static_cast<std::uint32_t>(static_cast<std::uint8_t>(inC1)) << 8) |
+			(static_cast<std::uint32_t>(static_cast<std::uint8_t>(inC2)) << 16) |
+			(static_cast<std::uint32_t>(static_cast<std::uint8_t>(inC3)) << 24);
+	}
+
+	const std::uint32_t DdsMagic = MakeFourCC('D', 'D', 'S', ' ');
+
+	const std::uint32_t DdsFourCC		= 0x00000004;
+	const std::uint32_t DdsRgb			= 0x00000040;
+	const std::uint32_t DdsLuminance	= 0x00020000;
+	const std::uint32_t DdsAlpha		= 0x00000002;
+
+	const std::uint32_t DdsHeaderFlagsVolume	= 0x00800000;
+	const std::uint32_t DdsHeight				= 0x00000002;
+
+	const std::uint32_t DdsCubeMap			= 0x00000200;
+	const std::uint32_t DdsCubeMapAllFaces	= 0x0000FE00;
+
+	// D3D11_RESOURCE_MISC_TEXTURECUBE
+	const std::uint32_t DdsMiscTextureCube = 0x00000004;
+
+	// The on-disk layout of the headers; the values are read with memcpy,
+	//  so the mapping doesn't have to be aligned.
+	struct DdsPixelFormat {
+		std::uint32_t mSize;
+		std::uint32_t mFlags;
+		std::uint32_t mFourCC;
+		std::uint32_t mRGBBitCount;
+		std::uint32_t mRBitMask;
+		std::uint32_t mGBitMask;
+		std::uint32_t mBBitMask;
+		std::uint32_t mABitMask;
+	};
+
+	struct DdsHeader {
+		std::uint32_t mSize;
+		std::uint32_t mFlags;
+		std::uint32_t mHeight;
+		std::uint32_t mWidth;
+		std::uint32_t mPitchOrLinearSize;
+		std::uint32_t mDepth;
+		std::uint32_t mMipMapCount;
+		std::uint32_t mReserved1[11];
+		DdsPixelFormat mPixelFormat;
+		std::uint32_t mCaps;
+		std::uint32_t mCaps2;
+		std::uint32_t mCaps3;
+		std::uint32_t mCaps4;
+		std::uint32_t mReserved2;
+	};
+
+	struct DdsHeaderDxt10 {
+		std::uint32_t mDxgiFormat;
+		std::uint32_t mResourceDimension;
+		std::uint32_t mMiscFlag;
+		std::uint32_t mArraySize;
+		std::uint32_t mMiscFlags2;
+	};
+
+	static_assert(sizeof(DdsPixelFormat) == 32, "DDS_PIXELFORMAT must be 32 bytes");
+	static_assert(sizeof(DdsHeader) == 124, "DDS_HEADER must be 124 bytes");
+	static_assert(sizeof(DdsHeaderDxt10) == 20, "DDS_HEADER_DXT10 must be 20 bytes");
+
+	// DXGI_FORMAT values used by the container.
+	namespace Format {
+		const std::uint32_t Unknown				= 0;
+		const std::uint32_t R32G32B32A32Float	= 2;
+		const std::uint32_t R16G16B16A16Float	= 10;
+		const std::uint32_t R16G16B16A16Unorm	= 11;
+		const std::uint32_t R16G16B16A16Snorm	= 13;
+		const std::uint32_t R32G32Float			= 16;
+		const std::uint32_t R10G10B10A2Unorm	= 24;
+		const std::uint32_t R8G8B8A8Unorm		= 28;
+		const std::uint32_t R16G16Float			= 34;
+		const std::uint32_t R16G16Unorm			= 35;
+		const std::uint32_t R32Float			= 41;
+		const std::uint32_t R8G8Unorm			= 49;
+		const std::uint32_t R16Float			= 54;
+		const std::uint32_t R16Unorm			= 56;
+		const std::uint32_t R8Unorm				= 61;
+		const std::uint32_t A8Unorm				= 65;
+		const std::uint32_t R8G8B8G8Unorm		= 68;
+		const std::uint32_t G8R8G8B8Unorm		= 69;
+		const std::uint32_t BC1Typeless			= 70;
+		const std::uint32_t BC1Unorm			= 71;
+		const std::uint32_t BC2Unorm			= 74;
+		const std::uint32_t BC3Unorm			= 77;
+		const std::uint32_t BC4Typeless			= 79;
+		const std::uint32_t BC4Unorm			= 80;
+		const std::uint32_t BC4Snorm			= 81;
+		const std::uint32_t BC5Typeless			= 82;
+		const std::uint32_t BC5Unorm			= 83;
+		const std::uint32_t BC5Snorm			= 84;
+		const std::uint32_t B5G6R5Unorm			= 85;
+		const std::uint32_t B5G5R5A1Unorm		= 86;
+		const std::uint32_t B8G8R8A8Unorm		= 87;
+		const std::uint32_t B8G8R8X8Unorm		= 88;
+		const std::uint32_t BC6HTypeless		= 94;
+		const std::uint32_t BC7UnormSrgb		= 99;
+		const std::uint32_t NV12				= 103;
+		const std::uint32_t P010				= 104;
+		const std::uint32_t P016				= 105;
+		const std::uint32_t Opaque420			= 106;
+		const std::uint32_t YUY2				= 107;
+		const std::uint32_t Y210				= 108;
+		const std::uint32_t Y216				= 109;
+		const std::uint32_t NV11				= 110;
+		const std::uint32_t AI44				= 111;
+		const std::uint32_t IA44				= 112;
+		const std::uint32_t P8					= 113;
+		const std::uint32_t A8P8				= 114;
+		const std::uint32_t B4G4R4A4Unorm		= 115;
+	}
+
+	template <typename T>
+	T ReadStruct(const std::uint8_t* inPtr) {
+		T value;
+		std::memcpy(&value, inPtr, sizeof(T));
+		return value;
+	}
+
+	bool IsBitMask(const DdsPixelFormat& inFormat, std::uint32_t inR, std::uint32_t inG, std::uint32_t inB, std::uint32_t inA) {
+		return inFormat.mRBitMask == inR && inFormat.mGBitMask == inG && inFormat.mBBitMask == inB && inFormat.mABitMask == inA;
+	}
+
+	std::uint32_t GetFormatFromPixelFormat(const DdsPixelFormat& inFormat) {
+		if (inFormat.mFlags & DdsRgb) {
+			switch (inFormat.mRGBBitCount) {
+			case 32:
+				if (IsBitMask(inFormat, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000)) return Format::R8G8B8A8Unorm;
+				if (IsBitMask(inFormat, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000)) return Format::B8G8R8A8Unorm;
+				if (IsBitMask(inFormat, 0x00FF0000, 0x0000FF00, 0x000000FF, 0x00000000)) return Format::B8G8R8X8Unorm;
+				// D3DX writes 10:10:10:2 with the red and blue masks swapped.
+				if (IsBitMask(inFormat, 0x3FF00000, 0x000FFC00, 0x000003FF, 0xC0000000)) return Format::R10G10B10A2Unorm;
+				if (IsBitMask(inFormat, 0x0000FFFF, 0xFFFF0000, 0x00000000, 0x00000000)) return Format::R16G16Unorm;
+				if (IsBitMask(inFormat, 0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000)) return Format::R32Float;
+				break;
+
+			case 16:
+				if (IsBitMask(inFormat, 0x7C00, 0x03E0, 0x001F, 0x8000)) return Format::B5G5R5A1Unorm;
+				if (IsBitMask(inFormat, 0xF800, 0x07E0, 0x001F, 0x0000)) return Format::B5G6R5Unorm;
+				if (IsBitMask(inFormat, 0x0F00, 0x00F0, 0x000F, 0xF000)) return Format::B4G4R4A4Unorm;
+				break;
+			}
+		}
+		else if (inFormat.mFlags & DdsLuminance) {
+			if (inFormat.mRGBBitCount == 8 && IsBitMask(inFormat, 0x000000FF, 0x00000000, 0x00000000, 0x00000000))
+				return Format::R8Unorm;
+			if (inFormat.mRGBBitCount == 16) {
+				if (IsBitMask(inFormat, 0x0000FFFF, 0x00000000, 0x00000000, 0x00000000)) return Format::R16Unorm;
+				if (IsBitMask(inFormat, 0x000000FF, 0x00000000, 0x00000000, 0x0000FF00)) return Format::R8G8Unorm;
+			}
+		}
+		else if (inFormat.mFlags & DdsAlpha) {
+			if (inFormat.mRGBBitCount == 8)
+				return Format::A8Unorm;
+		}
+		else if (inFormat.mFlags & DdsFourCC) {
+			switch (inFormat.mFourCC) {
+			case MakeFourCC('D', 'X', 'T', '1'): return Format::BC1Unorm;
+			// Pre-multiplied alpha isn't a DXGI concept, but the blocks are the same.
+			case MakeFourCC('D', 'X', 'T', '2'):
+			case MakeFourCC('D', 'X', 'T', '3'): return Format::BC2Unorm;
+			case MakeFourCC('D', 'X', 'T', '4'):
+			case MakeFourCC('D', 'X', 'T', '5'): return Format::BC3Unorm;
+			case MakeFourCC('A', 'T', 'I', '1'):
+			case MakeFourCC('B', 'C', '4', 'U'): return Format::BC4Unorm;
+			case MakeFourCC('B', 'C', '4', 'S'): return Format::BC4Snorm;
+			case MakeFourCC('A', 'T', 'I', '2'):
+			case MakeFourCC('B', 'C', '5', 'U'): return Format::BC5Unorm;
+			case MakeFourCC('B', 'C', '5', 'S'): return Format::BC5Snorm;
+			case MakeFourCC('R', 'G', 'B', 'G'): return Format::R8G8B8G8Unorm;
+			case MakeFourCC('G', 'R', 'G', 'B'): return Format::G8R8G8B8Unorm;
+			case MakeFourCC('Y', 'U', 'Y', '2'): return Format::YUY2;
+			// D3DFORMAT enums written as FourCC.
+			case 36:  return Format::R16G16B16A16Unorm;
+			case 110: return Format::R16G16B16A16Snorm;
+			case 111: return Format::R16Float;
+			case 112: return Format::R16G16Float;
+			case 113: return Format::R16G16B16A16Float;
+			case 114: return Format::R32Float;
+			case 115: return Format::R32G32Float;
+			case 116: return Format::R32G32B32A32Float;
+			}
+		}
+
+		return Format::Unknown;
+	}
+}
+
+bool DdsFile::Open(const std::string& inFileName) {
+	Close();
+
+	if (!mFile.Open(inFileName))
+		return false;
+
+	if (!Parse(mFile.GetData(), mFile.GetSize())) {
+		mFile.Close();
+		return false;
+	}
+
+	return true;
+}
+
+bool DdsFile::Parse(const void* inData, std::uint64_t inSize) {
+	mDesc = DdsTextureDesc();
+	mSubresources.clear();
+
+	if (inData == nullptr)
+		return false;
+
+	const auto* data = static_cast<const std::uint8_t*>(inData);
+
+	std::uint64_t bitOffset;
+	if (!ParseHeader(data, inSize, bitOffset) || !BuildSubresources(data + bitOffset, inSize - bitOffset)) {
+		mDesc = DdsTextureDesc();
+		mSubresources.clear();
+		return false;
+	}
+
+	return true;
+}
+
+void DdsFile::Close() {
+	mDesc = DdsTextureDesc();
+	mSubresources.clear();
+	mFile.Close();
+}
+
+bool DdsFile::IsValid() const {
+	return !mSubresources.empty();
+}
+
+const DdsTextureDesc& DdsFile::GetDesc() const {
+	return mDesc;
+}
+
+const DdsSubresource& DdsFile::GetSubresource(std::uint32_t inArraySlice, std::uint32_t inMip) const {
+	return mSubresources[static_cast<size_t>(inArraySlice) * mDesc.mMipCount + inMip];
+}
+
+bool DdsFile::GetSubresources(std::uint32_t inFirstMip, std::uint32_t inNumMips, std::vector<DdsSubresource>& outSubresources) const {
+	outSubresources.clear();
+
+	if (inNumMips == 0 || inFirstMip >= mDesc.mMipCount || inNumMips > mDesc.mMipCount - inFirstMip)
+		return false;
+
+	outSubresources.reserve(static_cast<size_t>(mDesc.mArraySize) * inNumMips);
+	for (std::uint32_t slice = 0; slice < mDesc.mArraySize; ++slice) {
+		auto begin = mSubresources.begin() + static_cast<size_t>(slice) * mDesc.mMipCount + inFirstMip;
+		outSubresources.insert(outSubresources.end(), begin, begin + inNumMips);
+	}
+
+	return true;
+}
+
+std::uint32_t DdsFile::GetFirstMipWithin(std::uint32_t inMaxSize) const {
+	if (inMaxSize == 0 || mDesc.mMipCount == 0)
+		return 0;
+
+	for (std::uint32_t mip = 0; mip < mDesc.mMipCount; ++mip) {
+		const auto& sub = mSubresources[mip];
+		if (sub.mWidth <= inMaxSize && sub.mHeight <= inMaxSize && sub.mDepth <= inMaxSize)
+			return mip;
+	}
+
+	return mDesc.mMipCount - 1;
+}
+
+std::uint64_t DdsFile::GetByteSize(std::uint32_t inFirstMip, std::uint32_t inNumMips) const {
+	if (inFirstMip >= mDesc.mMipCount)
+		return 0;
+
+	std::uint32_t endMip = inFirstMip + std::min(inNumMips, mDesc.mMipCount - inFirstMip);
+
+	std::uint64_t size = 0;
+	for (std::uint32_t mip = inFirstMip; mip < endMip; ++mip) {
+		const auto& sub = mSubresources[mip];
+		size += sub.mSlicePitch * sub.mDepth;
+	}
+
+	return size * mDesc.mArraySize;
+}
+
+std::uint32_t DdsFile::BitsPerPixel(std::uint32_t inFormat) {
+	// DXGI_FORMAT values are grouped by their sizes.
+	if (inFormat >= 1 && inFormat <= 4) return 128;
+	if (inFormat >= 5 && inFormat <= 8) return 96;
+	if (inFormat >= 9 && inFormat <= 22) return 64;
+	if (inFormat >= 23 && inFormat <= 47) return 32;
+	if (inFormat >= 48 && inFormat <= 59) return 16;
+	if (inFormat >= 60 && inFormat <= 65) return 8;
+	if (inFormat == 66) return 1;
+	if (inFormat >= 67 && inFormat <= 69) return 32;
+	if (inFormat >= 70 && inFormat <= 72) return 4;
+	if (inFormat >= 73 && inFormat <= 78) return 8;
+	if (inFormat >= 79 && inFormat <= 81) return 4;
+	if (inFormat >= 82 && inFormat <= 84) return 8;
+	if (inFormat >= 85 && inFormat <= 86) return 16;
+	if (inFormat >= 87 && inFormat <= 93) return 32;
+	if (inFormat >= 94 && inFormat <= 99) return 8;
+	if (inFormat >= 100 && inFormat <= 101) return 32;
+	if (inFormat == 102) return 64;
+	if (inFormat == Format::NV12) return 12;
+	if (inFormat == Format::P010 || inFormat == Format::P016) return 24;
+	if (inFormat == Format::Opaque420) return 12;
+	if (inFormat == Format::YUY2) return 32;
+	if (inFormat == Format::Y210 || inFormat == Format::Y216) return 64;
+	if (inFormat == Format::NV11) return 12;
+	if (inFormat >= Format::AI44 && inFormat <= Format::P8) return 8;
+	if (inFormat == Format::A8P8 || inFormat == Format::B4G4R4A4Unorm) return 16;
+
+	return 0;
+}
+
+bool DdsFile::GetSurfaceInfo(std::uint32_t inWidth, std::uint32_t inHeight, std::uint32_t inFormat,
+		std::uint64_t& outRowPitch, std::uint64_t& outSlicePitch) {
+	const std::uint64_t width = inWidth;
+	const std::uint64_t height = inHeight;
+
+	bool bc = (inFormat >= Format::BC1Typeless && inFormat <= Format::BC5Snorm) ||
+		(inFormat >= Format::BC6HTypeless && inFormat <= Format::BC7UnormSrgb);
+	if (bc) {
+		// BC1 and BC4 use 8 bytes per 4x4 block, the others 16.
+		std::uint64_t blockBytes = BitsPerPixel(inFormat) * 2;
+		std::uint64_t numBlocksWide = width > 0 ? std::max<std::uint64_t>(1, (width + 3) / 4) : 0;
+		std::uint64_t numBlocksHigh = height > 0 ? std::max<std::uint64_t>(1, (height + 3) / 4) : 0;
+
+		outRowPitch = numBlocksWide * blockBytes;
+		outSlicePitch = outRowPitch * numBlocksHigh;
+		return true;
+	}
+
+	switch (inFormat) {
+	case Format::R8G8B8G8Unorm:
+	case Format::G8R8G8B8Unorm:
+	case Format::YUY2:
+		outRowPitch = ((width + 1) >> 1) * 4;
+		outSlicePitch = outRowPitch * height;
+		return true;
+
+	case Format::Y210:
+	case Format::Y216:
+		outRowPitch = ((width + 1) >> 1) * 8;
+		outSlicePitch = outRowPitch * height;
+		return true;
+
+	case Format::NV11:
+		// Direct3D assumes twice the rows, although it is larger than the 4:1:1 data.
+		outRowPitch = ((width + 3) >> 2) * 4;
+		outSlicePitch = outRowPitch * height * 2;
+		return true;
+
+	case Format::NV12:
+	case Format::Opaque420:
+	case Format::P010:
+	case Format::P016: {
+		std::uint64_t bytesPerElement = (inFormat == Format::P010 || inFormat == Format::P016) ? 4 : 2;
+		outRowPitch = ((width + 1) >> 1) * bytesPerElement;
+		outSlicePitch = outRowPitch * height + ((outRowPitch * height + 1) >> 1);
+		return true;
+	}
+	}
+
+	std::uint64_t bpp = BitsPerPixel(inFormat);
+	if (bpp == 0)
+		return false;
+
+	outRowPitch = (width * bpp + 7) / 8;
+	outSlicePitch = outRowPitch * height;
+	return true;
+}
+
+bool DdsFile::ParseHeader(const std::uint8_t* inData, std::uint64_t inSize, std::uint64_t& outBitOffset) {
+	if (inSize < sizeof(std::uint32_t) + sizeof(DdsHeader))
+		return false;
+
+	if (ReadStruct<std::uint32_t>(inData) != DdsMagic)
+		return false;
+
+	auto header = ReadStruct<DdsHeader>(inData + sizeof(std::uint32_t));
+	if (header.mSize != sizeof(DdsHeader) || header.mPixelFormat.mSize != sizeof(DdsPixelFormat))
+		return false;
+
+	auto& desc = mDesc;
+	desc.mWidth = header.mWidth;
+	desc.mHeight = header.mHeight;
+	desc.mDepth = header.mDepth;
+	desc.mArraySize = 1;
+	desc.mMipCount = std::max(header.mMipMapCount, 1u);
+
+	outBitOffset = sizeof(std::uint32_t) + sizeof(DdsHeader);
+
+	if ((header.mPixelFormat.mFlags & DdsFourCC) && header.mPixelFormat.mFourCC == MakeFourCC('D', 'X', '1', '0')) {
+		if (inSize < outBitOffset + sizeof(DdsHeaderDxt10))
+			return false;
+
+		auto ext = ReadStruct<DdsHeaderDxt10>(inData + outBitOffset);
+		outBitOffset += sizeof(DdsHeaderDxt10);
+
+		// Palettized formats can't be created as textures.
+		if (ext.mDxgiFormat == Format::AI44 || ext.mDxgiFormat == Format::IA44 ||
+				ext.mDxgiFormat == Format::P8 || ext.mDxgiFormat == Format::A8P8)
+			return false;
+		if (BitsPerPixel(ext.mDxgiFormat) == 0)
+			return false;
+
+		desc.mFormat = ext.mDxgiFormat;
+		desc.mArraySize = ext.mArraySize;
+		if (desc.mArraySize == 0)
+			return false;
+
+		switch (ext.mResourceDimension) {
+		case Dds::ETexture1D:
+			if ((header.mFlags & DdsHeight) && desc.mHeight != 1)
+				return false;
+			desc.mHeight = 1;
+			desc.mDepth = 1;
+			break;
+
+		case Dds::ETexture2D:
+			if (ext.mMiscFlag & DdsMiscTextureCube) {
+				if (desc.mArraySize > Dds::MaxArraySize / 6)
+					return false;
+				desc.mArraySize *= 6;
+				desc.bCubeMap = true;
+			}
+			desc.mDepth = 1;
+			break;
+
+		case Dds::ETexture3D:
+			if (!(header.mFlags & DdsHeaderFlagsVolume) || desc.mArraySize > 1)
+				return false;
+			break;
+
+		default:
+			return false;
+		}
+
+		desc.mDimension = static_cast<Dds::Dimension>(ext.mResourceDimension);
+	}
+	else {
+		desc.mFormat = GetFormatFromPixelFormat(header.mPixelFormat);
+		if (desc.mFormat == Format::Unknown)
+			return false;
+
+		if (header.mFlags & DdsHeaderFlagsVolume) {
+			desc.mDimension = Dds::ETexture3D;
+		}
+		else {
+			if (header.mCaps2 & DdsCubeMap) {
+				// Partial cube maps aren't supported by Direct3D 10 and later.
+				if ((header.mCaps2 & DdsCubeMapAllFaces) != DdsCubeMapAllFaces)
+					return false;
+				desc.mArraySize = 6;
+				desc.bCubeMap = true;
+			}
+
+			desc.mDepth = 1;
+			desc.mDimension = Dds::ETexture2D;
+		}
+	}
+
+	if (desc.mWidth == 0 || desc.mHeight == 0 || desc.mDepth == 0)
+		return false;
+	if (desc.mMipCount > Dds::MaxMipLevels || desc.mArraySize > Dds::MaxArraySize)
+		return false;
+
+	switch (desc.mDimension) {
+	case Dds::ETexture1D:
+		return desc.mWidth <= Dds::MaxTexture1DDimension;
+	case Dds::ETexture2D:
+		return desc.mWidth <= Dds::MaxTexture2DDimension && desc.mHeight <= Dds::MaxTexture2DDimension;
+	case Dds::ETexture3D:
+		return desc.mWidth <= Dds::MaxTexture3DDimension && desc.mHeight <= Dds::MaxTexture3DDimension &&
+			desc.mDepth <= Dds::MaxTexture3DDimension;
+	default:
+		return false;
+	}
+}
+
+bool DdsFile::BuildSubresources(const std::uint8_t* inBits, std::uint64_t inBitSize) {
+	mSubresources.resize(static_cast<size_t>(mDesc.mArraySize) * mDesc.mMipCount);
+
+	// The dimensions are bounded by ParseHeader, so the offsets can't overflow.
+	std::uint64_t offset = 0;
+	for (std::uint32_t slice = 0; slice < mDesc.mArraySize; ++slice) {
+		std::uint32_t width = mDesc.mWidth;
+		std::uint32_t height = mDesc.mHeight;
+		std::uint32_t depth = mDesc.mDepth;
+
+		for (std::uint32_t mip = 0; mip < mDesc.mMipCount; ++mip) {
+			auto& sub = mSubresources[static_cast<size_t>(slice) * mDesc.mMipCount + mip];
+			if (!GetSurfaceInfo(width, height, mDesc.mFormat, sub.mRowPitch, sub.mSlicePitch))
+				return false;
+
+			std::uint64_t size = sub.mSlicePitch * depth;
+			if (size > inBitSize - offset)
+				return false;
+
+			sub.mData = inBits + offset;
+			sub.mWidth = width;
+			sub.mHeight = height;
+			sub.mDepth = depth;
+
+			offset += size;
+
+			width = std::max(width >> 1, 1u);
+			height = std::max(height >> 1, 1u);
+			depth = std::max(depth >> 1, 1u);
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
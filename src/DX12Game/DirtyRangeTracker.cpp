@@ -0,0 +1,73 @@
+#include "DX12Game/DirtyRangeTracker.h"
+
+#include <algorithm>
+
+using namespace Game;
+
+void DirtyRangeTracker::MarkDirty(std::uint32_t inIndex) {
+	MarkDirty(inIndex, 1);
+}
+
+void DirtyRangeTracker::MarkDirty(std::uint32_t inBegin, std::uint32_t inCount) {
+	if (inCount == 0)
+		return;
+
+	++mNumMarked;
+
+	std::uint32_t end = inBegin + inCount;
+
+	// Elements are usually marked in ascending order, so most of them just extend the last range.
+	if (!mRanges.empty()) {
+		auto& last = mRanges.back();
+
+		if (inBegin >= last.mBegin && inBegin <= last.mEnd) {
+			last.mEnd = std::max(last.mEnd, end);
+			return;
+		}
+
+		if (inBegin < last.mBegin)
+			bSorted = false;
+	}
+
+	mRanges.push_back({ inBegin, end });
+}
+
+void DirtyRangeTracker::Coalesce(std::uint32_t inMaxGap) {
+	if (mRanges.size() < 2)
+		return;
+
+	if (!bSorted) {
+		std::sort(mRanges.begin(), mRanges.end(), [](const DirtyRange& lhs, const DirtyRange& rhs) {
+			return lhs.mBegin < rhs.mBegin;
+		});
+		bSorted = true;
+	}
+
+	size_t last = 0;
+
+	for (size_t i = 1, end = mRanges.size(); i < end; ++i) {
+		auto& prev = mRanges[last];
+		const auto& curr = mRanges[i];
+
+		if (curr.mBegin <= prev.mEnd + inMaxGap)
+			prev.mEnd = std::max(prev.mEnd, curr.mEnd);
+		else
+			mRanges[++last] = curr;
+	}
+
+	mRanges.resize(last + 1);
+}
+
+void DirtyRangeTracker::Clear() {
+	mRanges.clear();
+	mNumMarked = 0;
+	bSorted = true;
+}
+
+const std::vector<DirtyRange>& DirtyRangeTracker::GetRanges() const {
+	return mRanges;
+}
+
+std::uint32_t DirtyRangeTracker::GetNumMarked() const {
+	return mNumMarked;
+}
\ No newline at end of file
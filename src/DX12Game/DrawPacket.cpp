@@ -0,0 +1,211 @@
+#include "DX12Game/DrawPacket.h"
+
+#include <algorithm>
+
+using namespace Game;
+
+namespace {
+	std::uint64_t Field(std::uint32_t inValue, std::uint32_t inBits, std::uint32_t inShift) {
+		return (static_cast<std::uint64_t>(inValue) & ((1ull << inBits) - 1)) << inShift;
+	}
+
+	std::uint32_t Extract(std::uint64_t inKey, std::uint32_t inBits, std::uint32_t inShift) {
+		return static_cast<std::uint32_t>((inKey >> inShift) & ((1ull << inBits) - 1));
+	}
+}
+
+std::uint64_t DrawSortKey::Build(std::uint32_t inPass, std::uint32_t inPipeline, std::uint32_t inGeometry,
+		std::uint32_t inMaterial, float inDepth, bool inBackToFront) {
+	const std::uint32_t maxDepth = (1u << DepthBits) - 1;
+
+	float depth = std::min(std::max(inDepth, 0.0f), 1.0f);
+	std::uint32_t quantized = static_cast<std::uint32_t>(depth * static_cast<float>(maxDepth));
+	if (inBackToFront)
+		quantized = maxDepth - quantized;
+
+	return Field(inPass, PassBits, PassShift) |
+		Field(inPipeline, PipelineBits, PipelineShift) |
+		Field(inGeometry, GeometryBits, GeometryShift) |
+		Field(inMaterial, MaterialBits, MaterialShift) |
+		Field(quantized, DepthBits, DepthShift);
+}
+
+std::uint32_t DrawSortKey::GetPass(std::uint64_t inKey) {
+	return Extract(inKey, PassBits, PassShift);
+}
+
+std::uint32_t DrawSortKey::GetPipeline(std::uint64_t inKey) {
+	return Extract(inKey, PipelineBits, PipelineShift);
+}
+
+std::uint32_t DrawSortKey::GetGeometry(std::uint64_t inKey) {
+	return Extract(inKey, GeometryBits, GeometryShift);
+}
+
+std::uint32_t DrawSortKey::GetMaterial(std::uint64_t inKey) {
+	return Extract(inKey, MaterialBits, MaterialShift);
+}
+
+void DrawPacketSorter::Initialize(std::uint32_t inNumThreads, std::uint32_t inParallelThreshold) {
+	mNumThreads = std::max(inNumThreads, 1u);
+	mParallelThreshold = inParallelThreshold;
+
+	mHistograms.resize(mNumThreads);
+	mDiffMasks.resize(mNumThreads);
+}
+
+void DrawPacketSorter::Sort(std::vector<DrawPacket>& ioPackets) {
+	std::uint32_t numPackets = static_cast<std::uint32_t>(ioPackets.size());
+	if (numPackets < 2)
+		return;
+
+	if (mScratch.size() < numPackets)
+		mScratch.resize(numPackets);
+
+	if (mHistograms.empty())
+		Initialize(1, mParallelThreshold);
+
+	std::uint64_t diffMask = ComputeDiffMask(ioPackets.data(), 0, numPackets);
+
+	DrawPacket* src = ioPackets.data();
+	DrawPacket* dst = mScratch.data();
+
+	for (std::uint32_t shift = 0; shift < 64; shift += RadixBits) {
+		if (((diffMask >> shift) & (RadixSize - 1)) == 0)
+			continue;
+
+		// Offsets are computed from the first histogram only, so pretend to be the only thread.
+		auto& histogram = mHistograms[0];
+		histogram.fill(0);
+
+		for (std::uint32_t i = 0; i < numPackets; ++i)
+			++histogram[(src[i].mKey >> shift) & (RadixSize - 1)];
+
+		std::uint32_t sum = 0;
+		for (auto& count : histogram) {
+			std::uint32_t offset = sum;
+			sum += count;
+			count = offset;
+		}
+
+		for (std::uint32_t i = 0; i < numPackets; ++i)
+			dst[histogram[(src[i].mKey >> shift) & (RadixSize - 1)]++] = src[i];
+
+		std::swap(src, dst);
+	}
+
+	if (src != ioPackets.data())
+		std::copy(src, src + numPackets, ioPackets.data());
+}
+
+void DrawPacketSorter::GetChunk(std::uint32_t inNumPackets, std::uint32_t inTid, std::uint32_t& outBegin, std::uint32_t& outEnd) const {
+	std::uint32_t eachNumPackets = inNumPackets / mNumThreads;
+	std::uint32_t remaining = inNumPackets % mNumThreads;
+
+	outBegin = inTid * eachNumPackets + (inTid < remaining ? inTid : remaining);
+	outEnd = outBegin + eachNumPackets + (inTid < remaining ? 1 : 0);
+}
+
+std::uint64_t DrawPacketSorter::ComputeDiffMask(const DrawPacket* inPackets, std::uint32_t inBegin, std::uint32_t inEnd) const {
+	// Every chunk compares against the first key of the whole list, so the masks can be OR-ed together.
+	std::uint64_t first = inPackets[0].mKey;
+	std::uint64_t mask = 0;
+
+	for (std::uint32_t i = inBegin; i < inEnd; ++i)
+		mask |= inPackets[i].mKey ^ first;
+
+	return mask;
+}
+
+void DrawPacketSorter::CountDigits(const DrawPacket* inPackets, std::uint32_t inBegin, std::uint32_t inEnd, std::uint32_t inShift, std::uint32_t inTid) {
+	auto& histogram = mHistograms[inTid];
+	histogram.fill(0);
+
+	for (std::uint32_t i = inBegin; i < inEnd; ++i)
+		++histogram[(inPackets[i].mKey >> inShift) & (RadixSize - 1)];
+}
+
+void DrawPacketSorter::Scatter(const DrawPacket* inSrc, DrawPacket* outDst, std::uint32_t inBegin, std::uint32_t inEnd, std::uint32_t inShift, std::uint32_t inTid) const {
+	// Elements of a digit go after the same digit of all the preceding chunks,
+	//  which keeps the sort stable across the threads.
+	std::array<std::uint32_t, RadixSize> offsets;
+	std::uint32_t sum = 0;
+
+	for (std::uint32_t digit = 0; digit < RadixSize; ++digit) {
+		for (std::uint32_t tid = 0; tid < mNumThreads; ++tid) {
+			if (tid == inTid)
+				offsets[digit] = sum;
+			sum += mHistograms[tid][digit];
+		}
+	}
+
+	for (std::uint32_t i = inBegin; i < inEnd; ++i)
+		outDst[offsets[(inSrc[i].mKey >> inShift) & (RadixSize - 1)]++] = inSrc[i];
+}
+
+void DrawStateCache::Reset() {
+	mPipeline = nullptr;
+	mGeometry = nullptr;
+	mTopology = 0xFFFFFFFF;
+	mObjectCB = 0xFFFFFFFFFFFFFFFF;
+}
+
+void DrawStateCache::ResetStatistics() {
+	mStatistics = DrawStateStatistics();
+}
+
+bool DrawStateCache::ChangePipeline(const void* inPipeline) {
+	if (mPipeline == inPipeline) {
+		++mStatistics.mNumSkippedBinds;
+		return false;
+	}
+
+	mPipeline = inPipeline;
+	++mStatistics.mNumPipelineChanges;
+
+	return true;
+}
+
+bool DrawStateCache::ChangeGeometry(const void* inGeometry) {
+	if (mGeometry == inGeometry) {
+		++mStatistics.mNumSkippedBinds;
+		return false;
+	}
+
+	mGeometry = inGeometry;
+	++mStatistics.mNumGeometryChanges;
+
+	return true;
+}
+
+bool DrawStateCache::ChangeTopology(std::uint32_t inTopology) {
+	if (mTopology == inTopology) {
+		++mStatistics.mNumSkippedBinds;
+		return false;
+	}
+
+	mTopology = inTopology;
+	++mStatistics.mNumTopologyChanges;
+
+	return true;
+}
+
+bool DrawStateCache::ChangeObjectCB(std::uint64_t inAddress) {
+	if (mObjectCB == inAddress) {
+		++mStatistics.mNumSkippedBinds;
+		return false;
+	}
+
+	mObjectCB = inAddress;
+	++mStatistics.mNumObjectCBChanges;
+
+	return true;
+}
+
+void DrawStateCache::CountDraw() {
+	++mStatistics.mNumDraws;
+}
+
+const DrawStateStatistics& DrawStateCache::GetStatistics() const {
+	return mStatistics;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "DX12Game/DrawPartitioner.h"
+
+#include <algorithm>
+
+using namespace Game;
+
+std::uint64_t DrawPartitioner::EstimateCost(std::uint32_t inIndexCount, std::uint32_t inInstanceCount, std::uint32_t inNumStateChanges,
+		std::uint64_t inDrawCost, std::uint64_t inStateChangeCost) {
+	return static_cast<std::uint64_t>(inIndexCount) * inInstanceCount + inDrawCost + inStateChangeCost * inNumStateChanges;
+}
+
+void DrawPartitioner::Partition(const std::vector<std::uint64_t>& inCosts, std::uint32_t inNumParts, std::vector<std::uint32_t>& outBounds) {
+	std::uint32_t numParts = std::max(inNumParts, 1u);
+	std::uint32_t numItems = static_cast<std::uint32_t>(inCosts.size());
+
+	// prefix[i] is the total cost of the items before i.
+	std::vector<std::uint64_t> prefix(numItems + 1);
+	prefix[0] = 0;
+	for (std::uint32_t i = 0; i < numItems; ++i)
+		prefix[i + 1] = prefix[i] + inCosts[i];
+
+	std::uint64_t total = prefix[numItems];
+
+	outBounds.resize(numParts + 1);
+	outBounds[0] = 0;
+	outBounds[numParts] = numItems;
+
+	for (std::uint32_t part = 1; part < numParts; ++part) {
+		std::uint64_t target = total * part / numParts;
+
+		auto iter = std::lower_bound(prefix.begin(), prefix.end(), target);
+		std::uint32_t bound = static_cast<std::uint32_t>(iter - prefix.begin());
+
+		// The preceding boundary may be closer to the ideal share.
+		if (bound > 0 && target - prefix[bound - 1] < prefix[bound] - target)
+			--bound;
+
+		outBounds[part] = std::min(std::max(bound, outBounds[part - 1]), numItems);
+	}
+}
\ No newline at end of file
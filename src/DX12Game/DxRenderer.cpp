@@ -5,9 +5,11 @@
 #include "DX12Game/GameWorld.h"
 #include "DX12Game/GameCamera.h"
 #include "DX12Game/Mesh.h"
+#include "DX12Game/PoseSampler.h"
 #include "DX12Game/BlurHelper.h"
 #include "common/GeometryGenerator.h"
 
+#include <filesystem>
 #include <ResourceUploadBatch.h>
 
 using Microsoft::WRL::ComPtr;
@@ -21,6 +23,33 @@ namespace {
 
 	const float SceneBoundsRadius = 64.0f;
 	const float SceneBoundQuarterRadius = SceneBoundsRadius * 0.75f;
+
+	template <typename VertexType>
+	float ComputeUVDensity(const std::vector<VertexType>& inVertices, const std::vector<std::uint32_t>& inIndices,
+			UINT inIndexCount, UINT inStartIndex) {
+		float surfaceArea = 0.0f;
+		float uvArea = 0.0f;
+
+		size_t end = std::min(static_cast<size_t>(inStartIndex) + inIndexCount, inIndices.size());
+		for (size_t i = inStartIndex; i + 3 <= end; i += 3) {
+			const auto& v0 = inVertices[inIndices[i]];
+			const auto& v1 = inVertices[inIndices[i + 1]];
+			const auto& v2 = inVertices[inIndices[i + 2]];
+
+			XMVECTOR p0 = XMLoadFloat3(&v0.mPos);
+			XMVECTOR e0 = XMVectorSubtract(XMLoadFloat3(&v1.mPos), p0);
+			XMVECTOR e1 = XMVectorSubtract(XMLoadFloat3(&v2.mPos), p0);
+			surfaceArea += 0.5f * XMVectorGetX(XMVector3Length(XMVector3Cross(e0, e1)));
+
+			float du0 = v1.mTexC.x - v0.mTexC.x;
+			float dv0 = v1.mTexC.y - v0.mTexC.y;
+			float du1 = v2.mTexC.x - v0.mTexC.x;
+			float dv1 = v2.mTexC.y - v0.mTexC.y;
+			uvArea += 0.5f * std::abs(du0 * dv1 - du1 * dv0);
+		}
+
+		return surfaceArea > 0.0f ? std::sqrt(uvArea / surfaceArea) : 0.0f;
+	}
 }
 
 DxRenderer::DxRenderer()
@@ -56,7 +85,14 @@ GameResult DxRenderer::Initialize(
 	mSpinlockBarrier = inSpinlock;
 
 	mNumInstances.resize(mNumThreads);
+	mUploadedBytes.resize(mNumThreads);
+	mUploadCopies.resize(mNumThreads);
+	mDrawPacketSorter.Initialize(mNumThreads);
+	mShadowRecordTimers.resize(mNumThreads);
+	mGBufferRecordTimers.resize(mNumThreads);
 	mEachUpdateFunctions.resize(mNumThreads);
+
+	mTextureResidency.SetBudget(DefaultTextureStreamingBudget);
 	
 	{
 		UINT i = 1;
@@ -113,12 +149,15 @@ GameResult DxRenderer::Initialize(
 	CheckGameResult(mSsao.Initialize(md3dDevice.Get(), cmdList, mClientWidth / 2, mClientHeight / 2, DXGI_FORMAT_R16_UNORM, DXGI_FORMAT_R16G16B16A16_FLOAT));
 
 	CheckGameResult(mRSManager.Initialize(md3dDevice.Get()));
+	CheckGameResult(BuildUploadCommandList());
 	CheckGameResult(LoadBasicTextures());
 	CheckGameResult(mRSManager.BuildRootSignatures());
 	CheckGameResult(BuildDescriptorHeaps());
 	CheckGameResult(BuildShaders());
 	CheckGameResult(BuildBasicGeometry());
 	CheckGameResult(BuildBasicMaterials());
+
+	mInstanceAllocator.Initialize(InitialInstanceCapacity);
 	CheckGameResult(BuildBasicRenderItems());
 	CheckGameResult(BuildFrameResources());
 	CheckGameResult(BuildPSOs());
@@ -245,12 +284,18 @@ GameResult DxRenderer::Update(const GameTimer& gt, UINT inTid) {
 			WaitForSingleObject(eventHandle, INFINITE);
 			CloseHandle(eventHandle);
 		}
+
+		ReleaseRetiredResources();
+
+		CheckGameResult(UpdateTextureResidency());
+		CheckGameResult(UpdateInstanceArena());
 	}
 
 	SyncHost(mCVBarrier);
 
 	CheckGameResult(AnimateMaterials(gt, inTid));
 	CheckGameResult(UpdateObjectCBsAndInstanceBuffers(gt, inTid));
+	CheckGameResult(UpdateDrawPackets(gt, inTid));
 	CheckGameResult(UpdateMaterialBuffers(gt, inTid));
 
 	if (inTid == 0) {
@@ -285,6 +330,8 @@ GameResult DxRenderer::Update(const GameTimer& gt, UINT inTid) {
 
 GameResult DxRenderer::Draw(const GameTimer& gt, UINT inTid) {
 	if (inTid == 0) {
+		// The uploads go ahead of every pass that may read them.
+		CheckGameResult(SubmitUploads());
 		CheckGameResult(ResetFrameResourceCmdListAlloc());
 		CheckGameResult(ClearViews());
 	}
@@ -381,9 +428,8 @@ void DxRenderer::UpdateInstanceAnimationData(
 				for (auto ritem : ritems) {
 					auto& inst = ritem->mInstances[mInstancesIndex[inRenderItemName]];
 
-					inst.mAnimClipIndex = inAnimClipIdx == -1 ?
-						-1 : static_cast<UINT>(inAnimClipIdx * mAnimsMap.GetInvLineSize());
-					inst.mTimePos = inTimePos;
+					inst.SetAnimation(inAnimClipIdx == -1 ?
+						-1 : static_cast<UINT>(inAnimClipIdx * mAnimsMap.GetInvLineSize()), inTimePos);
 					inst.SetFramesDirty(gNumFrameResources);
 				}
 			}
@@ -396,15 +442,70 @@ void DxRenderer::UpdateInstanceAnimationData(
 				for (auto ritem : ritems) {
 					auto& inst = ritem->mInstances[mInstancesIndex[name]];
 
-					inst.mAnimClipIndex = inAnimClipIdx == -1 ?
-						-1 : static_cast<UINT>(inAnimClipIdx * mAnimsMap.GetInvLineSize());
-					inst.mTimePos = inTimePos;
+					inst.SetAnimation(inAnimClipIdx == -1 ?
+						-1 : static_cast<UINT>(inAnimClipIdx * mAnimsMap.GetInvLineSize()), inTimePos);
 					inst.SetFramesDirty(gNumFrameResources);
 				}
 			}
 		}
 }
 
+void DxRenderer::UpdateInstanceAnimationBlend(
+	const std::string&		inRenderItemName,
+	const Game::PoseTerm*	inTerms,
+	UINT					inNumTerms) {
+	UINT numTerms = std::min(inNumTerms, 4u);
+
+	for (const auto& name : { inRenderItemName, inRenderItemName + "_skeleton" }) {
+		auto iter = mRefRitems.find(name);
+		if (iter == mRefRitems.end())
+			continue;
+
+		for (auto ritem : iter->second) {
+			auto& inst = ritem->mInstances[mInstancesIndex[name]];
+
+			if (numTerms == 0) {
+				inst.SetAnimation(-1, 0.0f);
+			}
+			else {
+				inst.SetAnimation(static_cast<UINT>(inTerms[0].mClipIndex * mAnimsMap.GetInvLineSize()), inTerms[0].mTimePos);
+				inst.mBlendWeights[0] = inTerms[0].mWeight;
+
+				for (UINT i = 1; i < numTerms; ++i) {
+					inst.mBlendAnimClipIndices[i - 1] = static_cast<UINT>(inTerms[i].mClipIndex * mAnimsMap.GetInvLineSize());
+					inst.mBlendTimePos[i - 1] = inTerms[i].mTimePos;
+					inst.mBlendWeights[i] = inTerms[i].mWeight;
+				}
+			}
+
+			inst.SetFramesDirty(gNumFrameResources);
+		}
+	}
+}
+
+void DxRenderer::UpdateInstanceAnimationPlayback(
+	const std::string&	inRenderItemName,
+	UINT				inAnimClipIdx,
+	float				inTimePos,
+	float				inTimeRate,
+	float				inTimeBase,
+	float				inTimeEnd) {
+	for (const auto& name : { inRenderItemName, inRenderItemName + "_skeleton" }) {
+		auto iter = mRefRitems.find(name);
+		if (iter == mRefRitems.end())
+			continue;
+
+		for (auto ritem : iter->second) {
+			auto& inst = ritem->mInstances[mInstancesIndex[name]];
+
+			inst.SetAnimation(inAnimClipIdx == -1 ?
+				-1 : static_cast<UINT>(inAnimClipIdx * mAnimsMap.GetInvLineSize()), inTimePos);
+			inst.SetPlayback(inTimeRate, inTimeBase, inTimeEnd);
+			inst.SetFramesDirty(gNumFrameResources);
+		}
+	}
+}
+
 void DxRenderer::SetVisible(const std::string& inRenderItemName, bool inState) {
 	auto iter = mRefRitems.find(inRenderItemName);
 	if (iter != mRefRitems.cend()) {
@@ -443,11 +544,6 @@ GameResult DxRenderer::AddGeometry(const Mesh* inMesh) {
 	if (iter != mGeometries.cend())
 		return GameResult(S_OK);
 
-	CheckGameResult(FlushCommandQueue());
-
-	// Reset the command list to prep for initialization commands.
-	ReturnIfFailed(mCommandLists[0]->Reset(mCommandAllocators[0].Get(), nullptr));
-
 	auto geo = std::make_unique<MeshGeometry>();
 	geo->Name = meshName;
 
@@ -470,6 +566,11 @@ GameResult DxRenderer::AddGeometry(const Mesh* inMesh) {
 		submesh.BaseVertexLocation = 0;
 		submesh.AABB = bound;
 
+		if (inMesh->GetIsSkeletal())
+			submesh.UVDensity = ComputeUVDensity(inMesh->GetSkinnedVertices(), inMesh->GetIndices(), subsets[i].first, subsets[i].second);
+		else
+			submesh.UVDensity = ComputeUVDensity(inMesh->GetVertices(), inMesh->GetIndices(), subsets[i].first, subsets[i].second);
+
 		geo->DrawArgs[drawArgs[i]] = submesh;
 	}
 
@@ -478,17 +579,8 @@ GameResult DxRenderer::AddGeometry(const Mesh* inMesh) {
 	if (inMesh->GetIsSkeletal())
 		CheckGameResult(AddSkeletonGeometry(inMesh));
 
-	// Execute the initialization commands.
-	ReturnIfFailed(mCommandLists[0]->Close());
-	ID3D12CommandList* cmdsLists[] = { mCommandLists[0].Get() };
-
-	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
-
-	// Wait until initialization is complete.
-	CheckGameResult(FlushCommandQueue());
-
 	if (!inMesh->GetMaterials().empty())
-		AddMaterials(inMesh->GetMaterials());
+		CheckGameResult(AddMaterials(inMesh->GetMaterials()));
 
 	return GameResultOk;
 }
@@ -558,6 +650,105 @@ void DxRenderer::DrawTexts() {
 	mSpriteBatch->End();
 }
 
+GameResult DxRenderer::BuildUploadCommandList() {
+	for (auto& batch : mUploadBatches) {
+		ReturnIfFailed(
+			md3dDevice->CreateCommandAllocator(
+				D3D12_COMMAND_LIST_TYPE_DIRECT,
+				IID_PPV_ARGS(batch.mCmdListAlloc.GetAddressOf())
+			)
+		);
+	}
+
+	ReturnIfFailed(
+		md3dDevice->CreateCommandList(
+			0,
+			D3D12_COMMAND_LIST_TYPE_DIRECT,
+			mUploadBatches[0].mCmdListAlloc.Get(),
+			nullptr,
+			IID_PPV_ARGS(mUploadCommandList.GetAddressOf())
+		)
+	);
+
+	// It is reset by the first upload.
+	ReturnIfFailed(mUploadCommandList->Close());
+
+	return GameResultOk;
+}
+
+GameResult DxRenderer::GetUploadCommandList(ID3D12GraphicsCommandList*& outCmdList) {
+	if (!bUploadBatchOpened) {
+		mCurrUploadBatch = (mCurrUploadBatch + 1) % static_cast<UINT>(mUploadBatches.size());
+		auto& batch = mUploadBatches[mCurrUploadBatch];
+
+		// The allocator is reused once the batch submitted with it a few frames ago is done.
+		if (batch.mFence != 0 && mFence->GetCompletedValue() < batch.mFence) {
+			HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
+			ReturnIfFailed(mFence->SetEventOnCompletion(batch.mFence, eventHandle));
+			WaitForSingleObject(eventHandle, INFINITE);
+			CloseHandle(eventHandle);
+		}
+
+		ReturnIfFailed(batch.mCmdListAlloc->Reset());
+		ReturnIfFailed(mUploadCommandList->Reset(batch.mCmdListAlloc.Get(), nullptr));
+
+		bUploadBatchOpened = true;
+	}
+
+	outCmdList = mUploadCommandList.Get();
+
+	return GameResultOk;
+}
+
+GameResult DxRenderer::SubmitUploads() {
+	if (!bUploadBatchOpened)
+		return GameResultOk;
+
+	ReturnIfFailed(mUploadCommandList->Close());
+	ID3D12CommandList* cmdsLists[] = { mUploadCommandList.Get() };
+	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+
+	bUploadBatchOpened = false;
+
+	// Every signal from now on is behind the uploads on the queue.
+	mUploadBatches[mCurrUploadBatch].mFence = mCurrentFence + 1;
+	for (auto& resource : mUploadBatchResources)
+		RetireResource(resource);
+	mUploadBatchResources.clear();
+
+	for (auto handle : mPendingTextureSwaps) {
+		auto& streamed = mStreamedTextures[handle];
+		if (streamed.mPendingFence == 0)
+			streamed.mPendingFence = mUploadBatches[mCurrUploadBatch].mFence;
+	}
+
+	return GameResultOk;
+}
+
+void DxRenderer::RetireResource(ComPtr<ID3D12Resource>& ioResource) {
+	if (ioResource == nullptr)
+		return;
+
+	RetiredResource retired;
+	retired.mResource = std::move(ioResource);
+	retired.mFence = mCurrentFence + 1;
+	mRetiredResources.push_back(std::move(retired));
+}
+
+void DxRenderer::RetireUploadResource(ComPtr<ID3D12Resource>& ioResource) {
+	if (ioResource != nullptr)
+		mUploadBatchResources.push_back(std::move(ioResource));
+}
+
+void DxRenderer::ReleaseRetiredResources() {
+	UINT64 completed = mFence->GetCompletedValue();
+
+	auto end = std::find_if(mRetiredResources.begin(), mRetiredResources.end(), [completed](const RetiredResource& inRetired) {
+		return inRetired.mFence > completed;
+	});
+	mRetiredResources.erase(mRetiredResources.begin(), end);
+}
+
 void DxRenderer::AddRenderItem(std::string& ioRenderItemName, const Mesh* inMesh) {
 	auto iter = mRefRitems.find(ioRenderItemName);
 	if (iter != mRefRitems.cend()) {
@@ -614,6 +805,18 @@ GameResult DxRenderer::AddMaterials(const std::unordered_map<std::string, Materi
 		material->FresnelR0 = materialIn.FresnelR0;
 		material->Roughness = materialIn.Roughness;
 
+		std::vector<TextureResidency::Handle> streamedTextures;
+		for (const auto* texName : { &materialIn.DiffuseMapFileName, &materialIn.NormalMapFileName,
+				&materialIn.SpecularMapFileName, &materialIn.AlphaMapFileName }) {
+			auto texIter = mStreamedTextureHandles.find(*texName);
+			if (texIter != mStreamedTextureHandles.cend())
+				streamedTextures.push_back(texIter->second);
+		}
+
+		if (mMaterialStreamedTextures.size() <= static_cast<size_t>(material->MatCBIndex))
+			mMaterialStreamedTextures.resize(material->MatCBIndex + 1);
+		mMaterialStreamedTextures[material->MatCBIndex] = std::move(streamedTextures);
+
 		mMaterialRefs[materialIn.MaterialName] = material.get();
 		mMaterials.push_back(std::move(material));
 	}
@@ -621,46 +824,55 @@ GameResult DxRenderer::AddMaterials(const std::unordered_map<std::string, Materi
 	return GameResultOk;
 }
 
-UINT DxRenderer::AddAnimations(const std::string& inClipName, const Animation& inAnim) {
+GameResult DxRenderer::AddAnimations(const std::string& inClipName, const Animation& inAnim, UINT& outClipIndex) {
+	size_t numTracks = inAnim.GetNumTracks();
+
+	std::vector<XMFLOAT4X4> transforms(numTracks);
 	std::vector<XMFLOAT4> curves;
+	curves.reserve(inAnim.mNumFrames * numTracks * 4);
 
 	for (size_t frame = 0; frame < inAnim.mNumFrames; ++frame) {
-		for (const auto& curve : inAnim.mCurves) {
+		inAnim.GetFrame(frame, transforms.data());
+
+		for (const auto& transform : transforms) {
 			for (size_t row = 0; row < 4; ++row) {
 				curves.emplace_back(
-					curve[frame].m[row][0],
-					curve[frame].m[row][1],
-					curve[frame].m[row][2],
-					curve[frame].m[row][3]
+					transform.m[row][0],
+					transform.m[row][1],
+					transform.m[row][2],
+					transform.m[row][3]
 				);
 			}
 		}
 	}
 
-	return mAnimsMap.AddAnimation(inClipName, curves.data(), inAnim.mNumFrames, inAnim.mCurves.size());
+	return mAnimsMap.AddAnimation(inClipName, curves.data(), inAnim.mNumFrames, numTracks, outClipIndex);
+}
+
+void DxRenderer::RemoveAnimations(UINT inClipIndex) {
+	mAnimsMap.RemoveAnimation(inClipIndex);
 }
 
 GameResult DxRenderer::UpdateAnimationsMap() {
-	ID3D12GraphicsCommandList* cmdList = mCommandLists[0].Get();
-	ID3D12CommandAllocator* alloc = mCommandAllocators[0].Get();
+	if (!mAnimsMap.HasPendingUploads())
+		return GameResultOk;
 
-	// Reset the command list to prep for initialization commands.
-	ReturnIfFailed(cmdList->Reset(alloc, nullptr));
+	// Recorded with the geometry of the mesh, so the clips are in the texture before the frame that plays them.
+	ID3D12GraphicsCommandList* cmdList;
+	CheckGameResult(GetUploadCommandList(cmdList));
 
-	mAnimsMap.UpdateAnimationsMap(cmdList);
+	ComPtr<ID3D12Resource> uploadBuffer;
+	CheckGameResult(mAnimsMap.UpdateAnimationsMap(cmdList, uploadBuffer));
 
-	// Execute the initialization commands.
-	ReturnIfFailed(cmdList->Close());
-	ID3D12CommandList* cmdsLists[] = { cmdList };
-
-	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
-
-	// Wait until initialization is complete.
-	CheckGameResult(FlushCommandQueue());
+	RetireUploadResource(uploadBuffer);
 
 	return GameResultOk;
 }
 
+void DxRenderer::SetTextureStreamingBudget(UINT64 inBytes) {
+	mTextureResidency.SetBudget(inBytes);
+}
+
 GameResult DxRenderer::CreateRtvAndDsvDescriptorHeaps() {
 	D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc;
 	// Add + 1 for diffuse map, +1 for screen normal map, +1 for specular map, +2 for ambient maps.
@@ -754,6 +966,7 @@ void DxRenderer::AddRenderItem(const std::string& inRenderItemName, const Mesh*
 					0.0f,
 					static_cast<UINT>(ritem->mMat->MatCBIndex)
 				);
+				ReserveInstanceRange(ritem);
 
 				mRefRitems[inRenderItemName].push_back(ritem);
 			}
@@ -783,6 +996,7 @@ void DxRenderer::AddRenderItem(const std::string& inRenderItemName, const Mesh*
 				0.0f,
 				static_cast<UINT>(ritem->mMat->MatCBIndex)
 			);
+			ReserveInstanceRange(ritem.get());
 			ritem->mGeo = mGeometries[inMesh->GetMeshName()].get();
 			ritem->mPrimitiveType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 			ritem->mIndexCount = ritem->mGeo->DrawArgs[drawArgs[i]].IndexCount;
@@ -790,6 +1004,7 @@ void DxRenderer::AddRenderItem(const std::string& inRenderItemName, const Mesh*
 			ritem->mBaseVertexLocation = ritem->mGeo->DrawArgs[drawArgs[i]].BaseVertexLocation;
 			ritem->mBoundType = BoundTypes::EAABB;
 			ritem->mBoundingUnion.mAABB = ritem->mGeo->DrawArgs[drawArgs[i]].AABB;
+			ritem->mUVDensity = ritem->mGeo->DrawArgs[drawArgs[i]].UVDensity;
 
 			if (inMesh->GetIsSkeletal())
 				mRitemLayer[RenderLayers::ESkinnedOpaque].push_back(ritem.get());
@@ -834,7 +1049,8 @@ GameResult DxRenderer::LoadDataFromMesh(const Mesh* inMesh, MeshGeometry* outGeo
 	ReturnIfFailed(D3DCreateBlob(ibByteSize, &outGeo->IndexBufferCPU));
 	CopyMemory(outGeo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	ID3D12GraphicsCommandList* cmdList = mCommandLists[0].Get();
+	ID3D12GraphicsCommandList* cmdList;
+	CheckGameResult(GetUploadCommandList(cmdList));
 
 	CheckGameResult(D3D12Util::CreateDefaultBuffer(
 		md3dDevice.Get(),
@@ -854,6 +1070,9 @@ GameResult DxRenderer::LoadDataFromMesh(const Mesh* inMesh, MeshGeometry* outGeo
 		outGeo->IndexBufferGPU)
 	);
 
+	RetireUploadResource(outGeo->VertexBufferUploader);
+	RetireUploadResource(outGeo->IndexBufferUploader);
+
 	outGeo->VertexByteStride = static_cast<UINT>(vertexSize);
 	outGeo->VertexBufferByteSize = vbByteSize;
 	outGeo->IndexFormat = DXGI_FORMAT_R32_UINT;
@@ -892,7 +1111,8 @@ GameResult DxRenderer::LoadDataFromSkeletalMesh(const Mesh* mesh, MeshGeometry*
 	ReturnIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	ID3D12GraphicsCommandList* cmdList = mCommandLists[0].Get();
+	ID3D12GraphicsCommandList* cmdList;
+	CheckGameResult(GetUploadCommandList(cmdList));
 
 	CheckGameResult(D3D12Util::CreateDefaultBuffer(
 		md3dDevice.Get(),
@@ -912,11 +1132,35 @@ GameResult DxRenderer::LoadDataFromSkeletalMesh(const Mesh* mesh, MeshGeometry*
 		geo->IndexBufferGPU)
 	);
 
+	RetireUploadResource(geo->VertexBufferUploader);
+	RetireUploadResource(geo->IndexBufferUploader);
+
 	geo->VertexByteStride = static_cast<UINT>(vertexSize);
 	geo->VertexBufferByteSize = vbByteSize;
 	geo->IndexFormat = DXGI_FORMAT_R32_UINT;
 	geo->IndexBufferByteSize = ibByteSize;
 
+	// The compact skinned layouts take 8-bit weights; other streams stay with the float layout.
+	const auto& skin = mesh->GetQuantizedSkin();
+	if (skin.mWeightBits == 8 && !skin.mData.empty() && skin.mData.size() == vertices.size() * skin.mStride) {
+		const UINT skinByteSize = static_cast<UINT>(skin.mData.size());
+
+		CheckGameResult(D3D12Util::CreateDefaultBuffer(
+			md3dDevice.Get(),
+			cmdList,
+			skin.mData.data(),
+			skinByteSize,
+			geo->SkinBufferUploader,
+			geo->SkinBufferGPU)
+		);
+
+		RetireUploadResource(geo->SkinBufferUploader);
+
+		geo->SkinByteStride = skin.mStride;
+		geo->SkinBufferByteSize = skinByteSize;
+		geo->SkinIndexBits = skin.mIndexBits;
+	}
+
 	return GameResultOk;
 }
 
@@ -955,7 +1199,8 @@ GameResult DxRenderer::AddSkeletonGeometry(const Mesh* inMesh) {
 	ReturnIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	ID3D12GraphicsCommandList* cmdList = mCommandLists[0].Get();
+	ID3D12GraphicsCommandList* cmdList;
+	CheckGameResult(GetUploadCommandList(cmdList));
 
 	CheckGameResult(D3D12Util::CreateDefaultBuffer(
 		md3dDevice.Get(),
@@ -975,6 +1220,9 @@ GameResult DxRenderer::AddSkeletonGeometry(const Mesh* inMesh) {
 		geo->IndexBufferGPU)
 	);
 
+	RetireUploadResource(geo->VertexBufferUploader);
+	RetireUploadResource(geo->IndexBufferUploader);
+
 	geo->VertexByteStride = static_cast<UINT>(vertexSize);
 	geo->VertexBufferByteSize = vbByteSize;
 	geo->IndexFormat = DXGI_FORMAT_R32_UINT;
@@ -1009,6 +1257,7 @@ GameResult DxRenderer::AddSkeletonRenderItem(const std::string& inRenderItemName
 					static_cast<UINT>(ritem->mMat->MatCBIndex),
 					0
 					});
+				ReserveInstanceRange(ritem);
 
 				mRefRitems[name].push_back(ritem);
 			}
@@ -1028,6 +1277,7 @@ GameResult DxRenderer::AddSkeletonRenderItem(const std::string& inRenderItemName
 			static_cast<UINT>(ritem->mMat->MatCBIndex),
 			0
 			});
+		ReserveInstanceRange(ritem.get());
 		ritem->mStartIndexLocation = ritem->mGeo->DrawArgs["skeleton"].StartIndexLocation;
 		ritem->mBaseVertexLocation = ritem->mGeo->DrawArgs["skeleton"].BaseVertexLocation;
 
@@ -1044,10 +1294,8 @@ GameResult DxRenderer::AddSkeletonRenderItem(const std::string& inRenderItemName
 }
 
 GameResult DxRenderer::AddTextures(const std::unordered_map<std::string, MaterialIn>& inMaterials) {
-	CheckGameResult(FlushCommandQueue());
-
-	ID3D12GraphicsCommandList* cmdList = mCommandLists[0].Get();
-	ReturnIfFailed(cmdList->Reset(mCommandAllocators[0].Get(), nullptr));
+	ID3D12GraphicsCommandList* cmdList;
+	CheckGameResult(GetUploadCommandList(cmdList));
 
 	mDiffuseSrvHeapIndices[""] = 0;
 	for (const auto& matList : inMaterials) {
@@ -1068,15 +1316,9 @@ GameResult DxRenderer::AddTextures(const std::unordered_map<std::string, Materia
 		wsstream << TextureFilePathW << material.DiffuseMapFileName.c_str();
 		texMap->Filename = wsstream.str();
 
-		HRESULT status = DirectX::CreateDDSTextureFromFile12(
-			md3dDevice.Get(),
-			cmdList,
-			texMap->Filename.c_str(),
-			texMap->Resource,
-			texMap->UploadHeap
-		);
+		GameResult status = LoadStreamedTexture(cmdList, texMap.get());
 
-		if (FAILED(status)) {
+		if (FAILED(status.hr)) {
 			mDiffuseSrvHeapIndices[material.DiffuseMapFileName] = 0;
 		}
 		else {
@@ -1104,15 +1346,9 @@ GameResult DxRenderer::AddTextures(const std::unordered_map<std::string, Materia
 		wsstream << TextureFilePathW << material.NormalMapFileName.c_str();
 		texMap->Filename = wsstream.str();
 
-		HRESULT status = DirectX::CreateDDSTextureFromFile12(
-			md3dDevice.Get(),
-			cmdList,
-			texMap->Filename.c_str(),
-			texMap->Resource,
-			texMap->UploadHeap
-		);
+		GameResult status = LoadStreamedTexture(cmdList, texMap.get());
 
-		if (FAILED(status)) {
+		if (FAILED(status.hr)) {
 			mNormalSrvHeapIndices[material.NormalMapFileName] = 1;
 		}
 		else {
@@ -1139,15 +1375,9 @@ GameResult DxRenderer::AddTextures(const std::unordered_map<std::string, Materia
 		wsstream << TextureFilePathW << material.SpecularMapFileName.c_str();
 		texMap->Filename = wsstream.str();
 
-		HRESULT status = DirectX::CreateDDSTextureFromFile12(
-			md3dDevice.Get(),
-			cmdList,
-			texMap->Filename.c_str(),
-			texMap->Resource,
-			texMap->UploadHeap
-		);
+		GameResult status = LoadStreamedTexture(cmdList, texMap.get());
 
-		if (FAILED(status)) {
+		if (FAILED(status.hr)) {
 			mSpecularSrvHeapIndices[material.SpecularMapFileName] = -1;
 		}
 		else {
@@ -1174,15 +1404,9 @@ GameResult DxRenderer::AddTextures(const std::unordered_map<std::string, Materia
 		wsstream << TextureFilePathW << material.AlphaMapFileName.c_str();
 		texMap->Filename = wsstream.str();
 
-		HRESULT status = CreateDDSTextureFromFile12(
-			md3dDevice.Get(),
-			cmdList,
-			texMap->Filename.c_str(),
-			texMap->Resource,
-			texMap->UploadHeap
-		);
+		GameResult status = LoadStreamedTexture(cmdList, texMap.get());
 
-		if (FAILED(status)) {
+		if (FAILED(status.hr)) {
 			mAlphaSrvHeapIndices[material.AlphaMapFileName] = -1;
 		}
 		else {
@@ -1191,25 +1415,11 @@ GameResult DxRenderer::AddTextures(const std::unordered_map<std::string, Materia
 		}
 	}
 
-	// Execute the initialization commands.
-	ReturnIfFailed(cmdList->Close());
-	ID3D12CommandList* cmdsLists[] = { cmdList };
-	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
-
-	// Wait until initialization is complete.
-	CheckGameResult(FlushCommandQueue());
-
 	return GameResultOk;
 }
 
 GameResult DxRenderer::AddDescriptors(const std::unordered_map<std::string, MaterialIn>& inMaterials) {
-	CheckGameResult(FlushCommandQueue());
-
-	ID3D12GraphicsCommandList* cmdList = mCommandLists[0].Get();
-
-	// Reset the command list to prep for initialization commands.
-	ReturnIfFailed(cmdList->Reset(mCommandAllocators[0].Get(), nullptr));
-
+	// The views are written to unused descriptors, so the frames in flight aren't affected.
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
 	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
@@ -1240,6 +1450,7 @@ GameResult DxRenderer::AddDescriptors(const std::unordered_map<std::string, Mate
 		srvDesc.Texture2D.MipLevels = tex->GetDesc().MipLevels;
 
 		md3dDevice->CreateShaderResourceView(tex.Get(), &srvDesc, hDescriptor);
+		AddStreamedTextureDescriptor(material.DiffuseMapFileName, mNumDescriptor);
 
 		hDescriptor.Offset(1, mCbvSrvUavDescriptorSize);
 		++mNumDescriptor;
@@ -1268,6 +1479,7 @@ GameResult DxRenderer::AddDescriptors(const std::unordered_map<std::string, Mate
 		srvDesc.Texture2D.MipLevels = tex->GetDesc().MipLevels;
 
 		md3dDevice->CreateShaderResourceView(tex.Get(), &srvDesc, hDescriptor);
+		AddStreamedTextureDescriptor(material.NormalMapFileName, mNumDescriptor);
 
 		hDescriptor.Offset(1, mCbvSrvUavDescriptorSize);
 		++mNumDescriptor;
@@ -1296,6 +1508,7 @@ GameResult DxRenderer::AddDescriptors(const std::unordered_map<std::string, Mate
 		srvDesc.Texture2D.MipLevels = tex->GetDesc().MipLevels;
 
 		md3dDevice->CreateShaderResourceView(tex.Get(), &srvDesc, hDescriptor);
+		AddStreamedTextureDescriptor(material.SpecularMapFileName, mNumDescriptor);
 
 		hDescriptor.Offset(1, mCbvSrvUavDescriptorSize);
 		++mNumDescriptor;
@@ -1324,6 +1537,7 @@ GameResult DxRenderer::AddDescriptors(const std::unordered_map<std::string, Mate
 		srvDesc.Texture2D.MipLevels = tex->GetDesc().MipLevels;
 
 		md3dDevice->CreateShaderResourceView(tex.Get(), &srvDesc, hDescriptor);
+		AddStreamedTextureDescriptor(material.AlphaMapFileName, mNumDescriptor);
 
 		hDescriptor.Offset(1, mCbvSrvUavDescriptorSize);
 		++mNumDescriptor;
@@ -1331,14 +1545,212 @@ GameResult DxRenderer::AddDescriptors(const std::unordered_map<std::string, Mate
 		mBuiltAlphaTexDescriptors.push_back(material.AlphaMapFileName);
 	}
 
-	// Execute the initialization commands.
-	ReturnIfFailed(cmdList->Close());
-	ID3D12CommandList* cmdsLists[] = { cmdList };
+	return GameResultOk;
+}
 
-	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+GameResult DxRenderer::LoadStreamedTexture(ID3D12GraphicsCommandList* inCmdList, Texture* ioTexture) {
+	auto file = std::make_unique<DdsFile>();
+	if (!file->Open(std::filesystem::path(ioTexture->Filename).string()))
+		ReturnGameResult(E_FAIL, L"Failed to load the DDS file: " << ioTexture->Filename);
 
-	// Wait until initialization is complete.
-	CheckGameResult(FlushCommandQueue());
+	const auto& desc = file->GetDesc();
+
+	std::vector<std::uint64_t> mipByteSizes(desc.mMipCount);
+	for (UINT mip = 0; mip < desc.mMipCount; ++mip)
+		mipByteSizes[mip] = file->GetByteSize(mip, 1);
+
+	// The finer levels are streamed in when the texture is seen closely enough.
+	UINT tailMip = file->GetFirstMipWithin(TextureStreamingTailSize);
+
+	CheckGameResult(D3D12Util::CreateTextureFromDds(
+		md3dDevice.Get(),
+		inCmdList,
+		*file,
+		tailMip,
+		desc.mMipCount - tailMip,
+		ioTexture->Resource,
+		ioTexture->UploadHeap)
+	);
+
+	RetireUploadResource(ioTexture->UploadHeap);
+
+	// The file stays mapped, so the streamed levels are copied straight from it.
+	mStreamedTextureHandles[ioTexture->Name] = mTextureResidency.Register(desc.mWidth, mipByteSizes, tailMip);
+
+	StreamedTexture streamed;
+	streamed.mFile = std::move(file);
+	streamed.mTexture = ioTexture;
+	streamed.mFirstMip = tailMip;
+	mStreamedTextures.push_back(std::move(streamed));
+
+	return GameResultOk;
+}
+
+void DxRenderer::AddStreamedTextureDescriptor(const std::string& inTextureName, UINT inDescriptorIndex) {
+	auto iter = mStreamedTextureHandles.find(inTextureName);
+	if (iter != mStreamedTextureHandles.cend())
+		mStreamedTextures[iter->second].mDescriptorIndices.push_back(inDescriptorIndex);
+}
+
+bool DxRenderer::SwapStreamedTexture(StreamedTexture& ioStreamed) {
+	// The frames in flight may still read the current descriptors and resource,
+	//  so the views are written to unused descriptors and the old ones are kept until the frames are done.
+	std::vector<UINT> indices(ioStreamed.mDescriptorIndices.size());
+	for (size_t i = 0, end = indices.size(); i < end; ++i) {
+		if (!AllocateTextureDescriptor(indices[i])) {
+			for (size_t j = 0; j < i; ++j)
+				mRetiredTextureDescriptors.insert(mRetiredTextureDescriptors.begin(), { indices[j], 0 });
+			return false;
+		}
+	}
+
+	auto texture = ioStreamed.mTexture;
+	RetireResource(texture->Resource);
+	texture->Resource = std::move(ioStreamed.mPendingResource);
+	ioStreamed.mFirstMip = ioStreamed.mPendingFirstMip;
+	ioStreamed.mPendingFence = 0;
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Format = texture->Resource->GetDesc().Format;
+	srvDesc.Texture2D.MostDetailedMip = 0;
+	srvDesc.Texture2D.MipLevels = texture->Resource->GetDesc().MipLevels;
+	srvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
+
+	for (size_t i = 0, end = indices.size(); i < end; ++i) {
+		md3dDevice->CreateShaderResourceView(texture->Resource.Get(), &srvDesc, GetCpuSrv(indices[i]));
+		ReplaceTextureDescriptor(ioStreamed.mDescriptorIndices[i], indices[i]);
+	}
+	ioStreamed.mDescriptorIndices = std::move(indices);
+
+	return true;
+}
+
+bool DxRenderer::AllocateTextureDescriptor(UINT& outIndex) {
+	if (!mRetiredTextureDescriptors.empty() && mRetiredTextureDescriptors.front().mFence <= mFence->GetCompletedValue()) {
+		outIndex = mRetiredTextureDescriptors.front().mIndex;
+		mRetiredTextureDescriptors.erase(mRetiredTextureDescriptors.begin());
+		return true;
+	}
+
+	if (mNumDescriptor >= TextureTableSize)
+		return false;
+
+	// The heap indices of the materials are the descriptors, so both counters move together.
+	outIndex = mNumDescriptor++;
+	mDescHeapIdx.mCurrSrvHeapIndex = mNumDescriptor;
+
+	return true;
+}
+
+void DxRenderer::ReplaceTextureDescriptor(UINT inOldIndex, UINT inNewIndex) {
+	const int oldIndex = static_cast<int>(inOldIndex);
+	const int newIndex = static_cast<int>(inNewIndex);
+
+	for (auto& material : mMaterials) {
+		bool replaced = false;
+		for (int* index : { &material->DiffuseSrvHeapIndex, &material->NormalSrvHeapIndex,
+				&material->SpecularSrvHeapIndex, &material->AlphaSrvHeapIndex }) {
+			if (*index == oldIndex) {
+				*index = newIndex;
+				replaced = true;
+			}
+		}
+
+		// Each frame resource gets the new index; the ones in flight keep reading the old descriptor.
+		if (replaced)
+			material->NumFramesDirty = gNumFrameResources;
+	}
+
+	for (auto& entry : mDiffuseSrvHeapIndices) {
+		if (entry.second == inOldIndex)
+			entry.second = inNewIndex;
+	}
+	for (auto& entry : mNormalSrvHeapIndices) {
+		if (entry.second == inOldIndex)
+			entry.second = inNewIndex;
+	}
+	for (auto& entry : mSpecularSrvHeapIndices) {
+		if (entry.second == oldIndex)
+			entry.second = newIndex;
+	}
+	for (auto& entry : mAlphaSrvHeapIndices) {
+		if (entry.second == oldIndex)
+			entry.second = newIndex;
+	}
+
+	// The material buffers of the frame recorded next already hold the new index.
+	RetiredDescriptor retired;
+	retired.mIndex = inOldIndex;
+	retired.mFence = mCurrentFence + 1;
+	mRetiredTextureDescriptors.push_back(retired);
+}
+
+void DxRenderer::RequestTextureMips(const Material* inMaterial, float inUVPerPixel) {
+	if (inMaterial == nullptr || static_cast<size_t>(inMaterial->MatCBIndex) >= mMaterialStreamedTextures.size())
+		return;
+
+	for (auto handle : mMaterialStreamedTextures[inMaterial->MatCBIndex])
+		mTextureResidency.Request(handle, inUVPerPixel);
+}
+
+GameResult DxRenderer::UpdateTextureResidency() {
+	// The textures whose new levels are on the GPU are swapped in; the ones that find no free descriptor
+	//  wait for the frames reading the retired descriptors.
+	UINT64 completed = mFence->GetCompletedValue();
+	size_t numPending = 0;
+	for (auto handle : mPendingTextureSwaps) {
+		auto& streamed = mStreamedTextures[handle];
+		bool uploaded = streamed.mPendingFence != 0 && streamed.mPendingFence <= completed;
+		if (!uploaded || !SwapStreamedTexture(streamed))
+			mPendingTextureSwaps[numPending++] = handle;
+	}
+	mPendingTextureSwaps.resize(numPending);
+
+	mTextureResidency.Update(TextureStreamingBytesPerFrame, mResidencyChanges);
+	if (mResidencyChanges.empty())
+		return GameResultOk;
+
+	ID3D12GraphicsCommandList* cmdList;
+	CheckGameResult(GetUploadCommandList(cmdList));
+
+	for (const auto& change : mResidencyChanges) {
+		auto& streamed = mStreamedTextures[change.mHandle];
+
+		// A change on top of a pending one starts from the pending resource; the copies are ordered on the queue.
+		bool hasPending = streamed.mPendingResource != nullptr;
+		if (!hasPending)
+			mPendingTextureSwaps.push_back(change.mHandle);
+
+		ComPtr<ID3D12Resource> src = hasPending ? streamed.mPendingResource : streamed.mTexture->Resource;
+		UINT srcFirstMip = hasPending ? streamed.mPendingFirstMip : streamed.mFirstMip;
+
+		// The size and the level count of a committed texture are fixed at creation, so a level can't be added
+		//  to(or dropped from) the current resource; a new one is created and the levels both hold are copied
+		//  on the GPU. Keeping the resource would need reserved resources with the levels mapped on tiles.
+
+		ComPtr<ID3D12Resource> uploadHeap;
+		CheckGameResult(D3D12Util::RecreateTextureFromDds(
+			md3dDevice.Get(),
+			cmdList,
+			*streamed.mFile,
+			change.mFirstMip,
+			mTextureResidency.GetNumMips(change.mHandle) - change.mFirstMip,
+			src.Get(),
+			srcFirstMip,
+			streamed.mPendingResource,
+			uploadHeap)
+		);
+
+		// A replaced pending resource is still read by the copies just recorded.
+		if (hasPending)
+			RetireUploadResource(src);
+		RetireUploadResource(uploadHeap);
+
+		streamed.mPendingFirstMip = change.mFirstMip;
+		streamed.mPendingFence = 0;
+	}
 
 	return GameResultOk;
 }
@@ -1358,17 +1770,25 @@ bool DxRenderer::IsContained(BoundTypes inType, const RenderItem::BoundingStruct
 		return false;
 }
 
-UINT DxRenderer::UpdateEachInstances(RenderItem* inRitem) {
-	auto& currInstDataBuffer = mCurrFrameResource->mInstanceDataBuffer;
+UINT DxRenderer::UpdateEachInstances(RenderItem* inRitem, UINT inTid) {
 	auto& currInstIdxBuffer = mCurrFrameResource->mInstanceIdxBuffer;
+	auto& currInstTracker = mCurrFrameResource->mInstanceTrackers[inTid];
 
 	XMMATRIX view = mMainCamera->GetView();
 	XMMATRIX invView = XMMatrixInverse(&XMMatrixDeterminant(view), view);
 
-	UINT offset = inRitem->mObjCBIndex * MaxInstanceCount;
+	UINT offset = mInstanceAllocator.GetOffset(inRitem->mInstanceRange);
 	UINT accum = 0;
 	UINT cnt = 0;
 
+	float nearestDepth = MathHelper::Infinity;
+
+	// Screen pixels per unit of the view space at depth 1.
+	float pixelsPerUnit = XMVectorGetY(mMainCamera->GetProj().r[1]) * mClientHeight * 0.5f;
+	float nearZ = mMainCamera->GetNearZ();
+	// The smallest local-space length a pixel covers on the visible instances, scaled by the UV tiling.
+	float minFootprint = MathHelper::Infinity;
+
 	for (auto& i : inRitem->mInstances) {
 		XMMATRIX world = XMLoadFloat4x4(&i.mWorld);
 		XMMATRIX texTransform = XMLoadFloat4x4(&i.mTexTransform);
@@ -1388,22 +1808,36 @@ UINT DxRenderer::UpdateEachInstances(RenderItem* inRitem) {
 
 			UINT instDataIdx = offset + cnt;
 
-			InstanceIdxData instIdxData;
-			instIdxData.mInstanceIdx = instDataIdx;
+			mInstanceIdxStaging[offset + accum].mInstanceIdx = instDataIdx;
+
+			float depth = XMVectorGetZ(XMVector3TransformCoord(world.r[3], view));
+			nearestDepth = std::min(nearestDepth, depth);
 
-			currInstIdxBuffer.CopyData(offset + accum, instIdxData);
+			if (inRitem->mUVDensity > 0.0f) {
+				float scale = std::max(XMVectorGetX(XMVector3Length(world.r[0])),
+					std::max(XMVectorGetX(XMVector3Length(world.r[1])), XMVectorGetX(XMVector3Length(world.r[2]))));
+				float uvScale = std::max(XMVectorGetX(XMVector2Length(texTransform.r[0])), XMVectorGetX(XMVector2Length(texTransform.r[1])));
+				minFootprint = std::min(minFootprint, std::max(depth, nearZ) * uvScale / (scale * pixelsPerUnit));
+			}
 
 			// Only update the cbuffer data if the constants have changed.
 			// This needs to be tracked per frame resource.
+			// Dirty elements are copied to the upload buffer later in coalesced blocks.
 			if (i.CheckFrameDirty(mCurrFrameResourceIndex)) {
-				InstanceData instData;
+				auto& instData = mInstanceStaging[instDataIdx];
 				XMStoreFloat4x4(&instData.mWorld, XMMatrixTranspose(world));
 				XMStoreFloat4x4(&instData.mTexTransform, XMMatrixTranspose(texTransform));
 				instData.mTimePos = i.mTimePos;
 				instData.mAnimClipIndex = i.mAnimClipIndex;
+				std::copy(std::begin(i.mBlendAnimClipIndices), std::end(i.mBlendAnimClipIndices), instData.mBlendAnimClipIndices);
+				std::copy(std::begin(i.mBlendTimePos), std::end(i.mBlendTimePos), instData.mBlendTimePos);
+				std::copy(std::begin(i.mBlendWeights), std::end(i.mBlendWeights), instData.mBlendWeights);
+				instData.mTimeRate = i.mTimeRate;
+				instData.mTimeBase = i.mTimeBase;
+				instData.mTimeEnd = i.mTimeEnd;
 				instData.mMaterialIndex = i.mMaterialIndex;
 
-				currInstDataBuffer.CopyData(instDataIdx, instData);
+				currInstTracker.MarkDirty(instDataIdx);
 
 				// Next FrameResource need to be updated too.
 				i.UnsetFrameDirty(mCurrFrameResourceIndex);
@@ -1415,8 +1849,57 @@ UINT DxRenderer::UpdateEachInstances(RenderItem* inRitem) {
 		++cnt;
 	}
 
+	inRitem->mSortDepth = accum > 0 ? nearestDepth : 0.0f;
+
+	if (accum > 0 && minFootprint < MathHelper::Infinity)
+		RequestTextureMips(inRitem->mMat, inRitem->mUVDensity * minFootprint);
+
+	// Indices of the visible instances are packed at the front of the range, so one copy is enough.
+	if (accum > 0) {
+		currInstIdxBuffer.CopyData(offset, &mInstanceIdxStaging[offset], accum);
+
+		mUploadedBytes[inTid] += accum * sizeof(InstanceIdxData);
+		++mUploadCopies[inTid];
+	}
+
 	return accum;
 }
+
+void DxRenderer::ReserveInstanceRange(RenderItem* ioRitem) {
+	UINT numInstances = static_cast<UINT>(ioRitem->mInstances.size());
+
+	if (ioRitem->mInstanceRange == InstanceAllocator::InvalidHandle)
+		ioRitem->mInstanceRange = mInstanceAllocator.Allocate(numInstances);
+	else
+		mInstanceAllocator.Reserve(ioRitem->mInstanceRange, numInstances);
+}
+
+GameResult DxRenderer::UpdateInstanceArena() {
+	mInstanceAllocator.Defragment();
+
+	UINT capacity = mInstanceAllocator.GetCapacity();
+	if (mInstanceStaging.size() < capacity) {
+		mInstanceStaging.resize(capacity);
+		mInstanceIdxStaging.resize(capacity);
+	}
+
+	if (mCurrFrameResource->mInstanceCapacity < capacity)
+		CheckGameResult(mCurrFrameResource->ResizeInstanceBuffers(capacity));
+
+	// Instances have been moved or the instance buffers have been recreated,
+	//  so every frame resource has to upload all the instances again.
+	UINT generation = mInstanceAllocator.GetGeneration();
+	if (mUploadedInstanceGeneration != generation) {
+		for (auto& ritem : mAllRitems) {
+			for (auto& inst : ritem->mInstances)
+				inst.SetFramesDirty(gNumFrameResources);
+		}
+
+		mUploadedInstanceGeneration = generation;
+	}
+
+	return GameResultOk;
+}
 /// Update helper classes
 
 ///
@@ -1431,6 +1914,10 @@ GameResult DxRenderer::UpdateObjectCBsAndInstanceBuffers(const GameTimer& gt, UI
 		ReturnGameResult(E_POINTER, L"Main camera does not exist");
 
 	auto& currObjectCB = mCurrFrameResource->mObjectCB;
+	auto& currInstDataBuffer = mCurrFrameResource->mInstanceDataBuffer;
+
+	mUploadedBytes[inTid] = 0;
+	mUploadCopies[inTid] = 0;
 
 	UINT numRitems = static_cast<UINT>(mAllRitems.size());
 	UINT eachNumRitems = numRitems / mNumThreads;
@@ -1442,15 +1929,22 @@ GameResult DxRenderer::UpdateObjectCBsAndInstanceBuffers(const GameTimer& gt, UI
 	for (UINT i = begin; i < end; ++i) {
 		auto ritem = mAllRitems[i].get();
 
-		mNumInstances[inTid] = UpdateEachInstances(ritem);
+		mNumInstances[inTid] = UpdateEachInstances(ritem, inTid);
 		ritem->mNumInstancesToDraw = mNumInstances[inTid];
 
 		ObjectConstants objConstants;
 		objConstants.mObjectIndex = ritem->mObjCBIndex;
+		objConstants.mInstanceOffset = mInstanceAllocator.GetOffset(ritem->mInstanceRange);
 
 		currObjectCB.CopyData(ritem->mObjCBIndex, objConstants);
 	}
 
+	UINT numCopied = mCurrFrameResource->mInstanceTrackers[inTid].Flush([&](UINT inBegin, UINT inCount) {
+		currInstDataBuffer.CopyData(inBegin, &mInstanceStaging[inBegin], inCount);
+		++mUploadCopies[inTid];
+	});
+	mUploadedBytes[inTid] += numCopied * sizeof(InstanceData);
+
 	SyncHost(mSpinlockBarrier);
 
 	if (inTid == 0) {
@@ -1466,6 +1960,130 @@ GameResult DxRenderer::UpdateObjectCBsAndInstanceBuffers(const GameTimer& gt, UI
 			10.0f,
 			16.0f
 		);
+
+		auto instStats = mInstanceAllocator.GetStatistics();
+		UINT64 instBytes = static_cast<UINT64>(instStats.mCapacity) * (sizeof(InstanceData) + sizeof(InstanceIdxData)) * gNumFrameResources;
+
+		AddOutputText(
+			"TEXT_INST",
+			L"inst: " + std::to_wstring(instStats.mReserved) + L" / " + std::to_wstring(instStats.mCapacity) +
+				L" (" + std::to_wstring(instBytes / 1024) + L" KB, frag " +
+				std::to_wstring(static_cast<UINT>(instStats.mFragmentation * 100.0f)) + L"%)",
+			300.0f,
+			10.0f,
+			16.0f
+		);
+
+		UINT64 uploadedBytes = 0;
+		UINT uploadCopies = 0;
+
+		for (UINT i = 0; i < mNumThreads; ++i) {
+			uploadedBytes += mUploadedBytes[i];
+			uploadCopies += mUploadCopies[i];
+		}
+
+		AddOutputText(
+			"TEXT_UPLOAD",
+			L"upload: " + std::to_wstring(uploadedBytes) + L" B / " + std::to_wstring(uploadCopies) + L" copies",
+			300.0f,
+			40.0f,
+			16.0f
+		);
+
+		auto texStats = mTextureResidency.GetStatistics();
+
+		AddOutputText(
+			"TEXT_TEX",
+			L"tex: " + std::to_wstring(texStats.mResidentBytes / (1024 * 1024)) + L" / " +
+				std::to_wstring(texStats.mBudgetBytes / (1024 * 1024)) + L" MB (pending " + std::to_wstring(texStats.mNumPending) +
+				L", +" + std::to_wstring(texStats.mNumLoads) + L" -" + std::to_wstring(texStats.mNumEvictions) + L")",
+			300.0f,
+			70.0f,
+			16.0f
+		);
+	}
+
+	return GameResultOk;
+}
+
+GameResult DxRenderer::UpdateDrawPackets(const GameTimer& gt, UINT inTid) {
+	// Layers recorded by all the threads.
+	// The others are drawn by one thread with a few render items, so they are kept in insertion order.
+	const RenderLayers sortedLayers[] = {
+		RenderLayers::EOpaque,
+		RenderLayers::ESkinnedOpaque,
+		RenderLayers::EOpaqueSsr
+	};
+
+	if (inTid == 0) {
+		size_t numRitems = 0;
+		for (auto layer : sortedLayers)
+			numRitems += mRitemLayer[layer].size();
+
+		// Render items are only added, so the sources are rebuilt when the count changes.
+		if (numRitems != mDrawPacketSources.size()) {
+			mDrawPacketSources.clear();
+
+			for (auto layer : sortedLayers) {
+				for (auto ritem : mRitemLayer[layer]) {
+					auto geoIter = mGeometryIds.emplace(ritem->mGeo, static_cast<UINT>(mGeometryIds.size())).first;
+					mDrawPacketSources.push_back({ ritem, layer, geoIter->second });
+				}
+			}
+
+			mDrawPackets.resize(numRitems);
+			for (size_t i = 0; i < numRitems; ++i)
+				mDrawPackets[i].mIndex = static_cast<UINT>(i);
+		}
+	}
+
+	SyncHost(mSpinlockBarrier);
+
+	UINT numPackets = static_cast<UINT>(mDrawPackets.size());
+	UINT eachNumPackets = numPackets / mNumThreads;
+	UINT remaining = numPackets % mNumThreads;
+
+	UINT begin = inTid * eachNumPackets + (inTid < remaining ? inTid : remaining);
+	UINT end = begin + eachNumPackets + (inTid < remaining ? 1 : 0);
+
+	float invFarZ = 1.0f / mMainCamera->GetFarZ();
+
+	for (UINT i = begin; i < end; ++i) {
+		auto& packet = mDrawPackets[i];
+		const auto& source = mDrawPacketSources[packet.mIndex];
+		const auto ritem = source.mRitem;
+
+		// Opaque layers only, so the draws are ordered front-to-back.
+		// The pipeline state is bound once per layer(GetLayerPso), so the pass already groups it and the pipeline field stays 0.
+		packet.mKey = DrawSortKey::Build(
+			static_cast<UINT>(source.mLayer),
+			0,
+			source.mGeometryId,
+			static_cast<UINT>(ritem->mMat->MatCBIndex),
+			ritem->mSortDepth * invFarZ);
+	}
+
+	SyncHost(mSpinlockBarrier);
+
+	bool terminated = mDrawPacketSorter.Sort(mDrawPackets, inTid, [&]() {
+		return mSpinlockBarrier->Wait();
+	});
+	if (terminated)
+		return GameResultFail;
+
+	if (inTid == 0) {
+		for (auto layer : sortedLayers)
+			mSortedRitemLayer[layer].clear();
+
+		// Render items that have no visible instance are not recorded at all.
+		for (const auto& packet : mDrawPackets) {
+			const auto& source = mDrawPacketSources[packet.mIndex];
+			if (source.mRitem->mNumInstancesToDraw > 0)
+				mSortedRitemLayer[source.mLayer].push_back(source.mRitem);
+		}
+
+		for (auto layer : sortedLayers)
+			PartitionSortedLayer(layer);
 	}
 
 	return GameResultOk;
@@ -1641,6 +2259,9 @@ GameResult DxRenderer::UpdateShadowPassCB(const GameTimer& gt, UINT inTid) {
 	mShadowPassCB.mInvRenderTargetSize = XMFLOAT2(1.0f / w, 1.0f / h);
 	mShadowPassCB.mNearZ = mLightingVars.mLightNearZ;
 	mShadowPassCB.mFarZ = mLightingVars.mLightFarZ;
+	// The skinning shaders play the clips on from the total time.
+	mShadowPassCB.mTotalTime = gt.TotalTime();
+	mShadowPassCB.mDeltaTime = gt.DeltaTime();
 
 	auto& currPassCB = mCurrFrameResource->mPassCB;
 	currPassCB.CopyData(1, mShadowPassCB);
@@ -1781,11 +2402,11 @@ GameResult DxRenderer::LoadBasicTextures() {
 		auto texMap = std::make_unique<Texture>();
 		texMap->Name = texNames[i];
 		texMap->Filename = texFileNames[i];
-		ReturnIfFailed(
-			DirectX::CreateDDSTextureFromFile12(
+		CheckGameResult(
+			D3D12Util::LoadDdsTexture(
 				md3dDevice.Get(),
 				cmdList,
-				texMap->Filename.c_str(),
+				texMap->Filename,
 				texMap->Resource,
 				texMap->UploadHeap
 			)
@@ -2048,6 +2669,12 @@ GameResult DxRenderer::BuildShaders() {
 		NULL, NULL
 	};
 
+	const D3D_SHADER_MACRO QuantizedSkinDefines[] = {
+		"SKINNED", "1",
+		"QUANTIZED_SKIN", "1",
+		NULL, NULL
+	};
+
 	{
 		const std::wstring filePath = ShaderFilePathW + L"Skeleton.hlsl";
 		CheckGameResult(mShaderManager.CompileShader(filePath, nullptr, "VS", "vs_5_1", "skeletonVS"));
@@ -2058,6 +2685,7 @@ GameResult DxRenderer::BuildShaders() {
 		const std::wstring filePath = ShaderFilePathW + L"Shadows.hlsl";
 		CheckGameResult(mShaderManager.CompileShader(filePath, nullptr, "VS", "vs_5_1", "shadowsVS"));
 		CheckGameResult(mShaderManager.CompileShader(filePath, SkinnedDefines, "VS", "vs_5_1", "skinnedShadowsVS"));
+		CheckGameResult(mShaderManager.CompileShader(filePath, QuantizedSkinDefines, "VS", "vs_5_1", "quantizedSkinShadowsVS"));
 		CheckGameResult(mShaderManager.CompileShader(filePath, AlphaTestDefines, "PS", "ps_5_1", "shadowsPS"));
 	}
 	{
@@ -2396,6 +3024,7 @@ GameResult DxRenderer::BuildBasicRenderItems() {
 		0.0f,
 		static_cast<UINT>(skyRitem->mMat->MatCBIndex)
 	);
+	ReserveInstanceRange(skyRitem.get());
 	mRitemLayer[RenderLayers::ESky].push_back(skyRitem.get());
 	mAllRitems.push_back(std::move(skyRitem));
 
@@ -2416,6 +3045,7 @@ GameResult DxRenderer::BuildBasicRenderItems() {
 		0.0f,
 		static_cast<UINT>(boxRitem->mMat->MatCBIndex)
 	);
+	ReserveInstanceRange(boxRitem.get());
 	mRitemLayer[RenderLayers::EOpaque].push_back(boxRitem.get());
 	mAllRitems.push_back(std::move(boxRitem));
 
@@ -2437,6 +3067,7 @@ GameResult DxRenderer::BuildBasicRenderItems() {
 		-1,
 		EInstanceRenderState::EID_DrawAlways
 	);
+	ReserveInstanceRange(quadRitem.get());
 	mRitemLayer[RenderLayers::EScreen].push_back(quadRitem.get());
 	mAllRitems.push_back(std::move(quadRitem));
 
@@ -2457,6 +3088,7 @@ GameResult DxRenderer::BuildBasicRenderItems() {
 		0.0f,
 		static_cast<UINT>(gridRitem->mMat->MatCBIndex)
 	);
+	ReserveInstanceRange(gridRitem.get());
 	mRitemLayer[RenderLayers::EOpaqueSsr].push_back(gridRitem.get());
 	mAllRitems.push_back(std::move(gridRitem));
 
@@ -2516,6 +3148,32 @@ GameResult DxRenderer::BuildPSOs() {
 			mDepthStencilFormat,
 			"skinnedShadow"
 		));
+		CheckGameResult(mPsoManager.BuildPso(
+			PsoManager::InputLayouts::EQuantizedSkinned8,
+			mRSManager.GetBasicRootSignature(),
+			mShaderManager.GetShader("quantizedSkinShadowsVS"),
+			mShaderManager.GetShader("shadowsPS"),
+			rasterizerDesc,
+			defaultDepthStencilDesc,
+			defaultBlendDesc,
+			D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
+			{},
+			mDepthStencilFormat,
+			"quantizedSkinShadow8"
+		));
+		CheckGameResult(mPsoManager.BuildPso(
+			PsoManager::InputLayouts::EQuantizedSkinned16,
+			mRSManager.GetBasicRootSignature(),
+			mShaderManager.GetShader("quantizedSkinShadowsVS"),
+			mShaderManager.GetShader("shadowsPS"),
+			rasterizerDesc,
+			defaultDepthStencilDesc,
+			defaultBlendDesc,
+			D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
+			{},
+			mDepthStencilFormat,
+			"quantizedSkinShadow16"
+		));
 	}
 	CheckGameResult(mPsoManager.BuildPso(
 		PsoManager::InputLayouts::ENone,
@@ -2718,7 +3376,7 @@ GameResult DxRenderer::BuildPSOs() {
 GameResult DxRenderer::BuildFrameResources() {
 	for (UINT i = 0; i < gNumFrameResources; ++i) {
 		mFrameResources.push_back(std::make_unique<FrameResource>(
-			md3dDevice.Get(), 2, 256, MaxInstanceCount, 256));
+			md3dDevice.Get(), 2, 256, mInstanceAllocator.GetCapacity(), 256));
 
 		CheckGameResult(mFrameResources.back()->Initialize(mNumThreads));
 	}
@@ -2734,19 +3392,30 @@ void DxRenderer::DrawRenderItems(
 
 	auto objectCB = mCurrFrameResource->mObjectCB.Resource();
 
+	// Skip the binds of the states that are already set by the previous render item.
+	DrawStateCache stateCache;
+
 	// For each render item...
 	for (size_t i = 0; i < inNum; ++i) {
 		auto ri = inRitems[i];
+		if (ri->mNumInstancesToDraw == 0)
+			continue;
 
-		outCmdList->IASetVertexBuffers(0, 1, &ri->mGeo->VertexBufferView());
-		outCmdList->IASetIndexBuffer(&ri->mGeo->IndexBufferView());
-		outCmdList->IASetPrimitiveTopology(ri->mPrimitiveType);
+		if (stateCache.ChangeGeometry(ri->mGeo)) {
+			outCmdList->IASetVertexBuffers(0, 1, &ri->mGeo->VertexBufferView());
+			outCmdList->IASetIndexBuffer(&ri->mGeo->IndexBufferView());
+		}
+
+		if (stateCache.ChangeTopology(static_cast<std::uint32_t>(ri->mPrimitiveType)))
+			outCmdList->IASetPrimitiveTopology(ri->mPrimitiveType);
 
 		D3D12_GPU_VIRTUAL_ADDRESS objCBAddress = objectCB->GetGPUVirtualAddress() + ri->mObjCBIndex * objCBByteSize;
-		outCmdList->SetGraphicsRootConstantBufferView(mRSManager.GetObjectCBIndex(), objCBAddress);
+		if (stateCache.ChangeObjectCB(objCBAddress))
+			outCmdList->SetGraphicsRootConstantBufferView(mRSManager.GetObjectCBIndex(), objCBAddress);
 
 		outCmdList->DrawIndexedInstanced(ri->mIndexCount, ri->mNumInstancesToDraw,
 			ri->mStartIndexLocation, ri->mBaseVertexLocation, 0);
+		stateCache.CountDraw();
 	}
 }
 
@@ -2759,22 +3428,135 @@ void DxRenderer::DrawRenderItems(
 
 	auto objectCB = mCurrFrameResource->mObjectCB.Resource();
 
+	// Skip the binds of the states that are already set by the previous render item.
+	DrawStateCache stateCache;
+
 	// For each render item...
 	for (size_t i = inBegin; i < inEnd; ++i) {
 		auto ri = inRitems[i];
+		if (ri->mNumInstancesToDraw == 0)
+			continue;
+
+		if (stateCache.ChangeGeometry(ri->mGeo)) {
+			outCmdList->IASetVertexBuffers(0, 1, &ri->mGeo->VertexBufferView());
+			outCmdList->IASetIndexBuffer(&ri->mGeo->IndexBufferView());
+		}
+
+		if (stateCache.ChangeTopology(static_cast<std::uint32_t>(ri->mPrimitiveType)))
+			outCmdList->IASetPrimitiveTopology(ri->mPrimitiveType);
+
+		D3D12_GPU_VIRTUAL_ADDRESS objCBAddress = objectCB->GetGPUVirtualAddress() + ri->mObjCBIndex * objCBByteSize;
+		if (stateCache.ChangeObjectCB(objCBAddress))
+			outCmdList->SetGraphicsRootConstantBufferView(mRSManager.GetObjectCBIndex(), objCBAddress);
+
+		outCmdList->DrawIndexedInstanced(ri->mIndexCount, ri->mNumInstancesToDraw,
+			ri->mStartIndexLocation, ri->mBaseVertexLocation, 0);
+		stateCache.CountDraw();
+	}
+}
+
+void DxRenderer::DrawSkinnedShadowRenderItems(
+	ID3D12GraphicsCommandList*	outCmdList,
+	RenderItem* const*			inRitems,
+	size_t						inBegin,
+	size_t						inEnd) {
+	UINT objCBByteSize = D3D12Util::CalcConstantBufferByteSize(sizeof(ObjectConstants));
+
+	auto objectCB = mCurrFrameResource->mObjectCB.Resource();
+
+	DrawStateCache stateCache;
+
+	for (size_t i = inBegin; i < inEnd; ++i) {
+		auto ri = inRitems[i];
+		if (ri->mNumInstancesToDraw == 0)
+			continue;
 
-		outCmdList->IASetVertexBuffers(0, 1, &ri->mGeo->VertexBufferView());
-		outCmdList->IASetIndexBuffer(&ri->mGeo->IndexBufferView());
-		outCmdList->IASetPrimitiveTopology(ri->mPrimitiveType);
+		// The geometries with a quantized skin stream fetch 8 or 12 bytes of skinning data per vertex instead of 64.
+		ID3D12PipelineState* pso;
+		if (ri->mGeo->SkinIndexBits == 8)
+			pso = mPsoManager.GetPsoPtr("quantizedSkinShadow8");
+		else if (ri->mGeo->SkinIndexBits == 16)
+			pso = mPsoManager.GetPsoPtr("quantizedSkinShadow16");
+		else
+			pso = mPsoManager.GetPsoPtr("skinnedShadow");
+
+		if (stateCache.ChangePipeline(pso))
+			outCmdList->SetPipelineState(pso);
+
+		if (stateCache.ChangeGeometry(ri->mGeo)) {
+			if (ri->mGeo->SkinIndexBits != 0) {
+				D3D12_VERTEX_BUFFER_VIEW views[] = { ri->mGeo->VertexBufferView(), ri->mGeo->SkinBufferView() };
+				outCmdList->IASetVertexBuffers(0, _countof(views), views);
+			}
+			else {
+				outCmdList->IASetVertexBuffers(0, 1, &ri->mGeo->VertexBufferView());
+			}
+			outCmdList->IASetIndexBuffer(&ri->mGeo->IndexBufferView());
+		}
+
+		if (stateCache.ChangeTopology(static_cast<std::uint32_t>(ri->mPrimitiveType)))
+			outCmdList->IASetPrimitiveTopology(ri->mPrimitiveType);
 
 		D3D12_GPU_VIRTUAL_ADDRESS objCBAddress = objectCB->GetGPUVirtualAddress() + ri->mObjCBIndex * objCBByteSize;
-		outCmdList->SetGraphicsRootConstantBufferView(mRSManager.GetObjectCBIndex(), objCBAddress);
+		if (stateCache.ChangeObjectCB(objCBAddress))
+			outCmdList->SetGraphicsRootConstantBufferView(mRSManager.GetObjectCBIndex(), objCBAddress);
 
 		outCmdList->DrawIndexedInstanced(ri->mIndexCount, ri->mNumInstancesToDraw,
 			ri->mStartIndexLocation, ri->mBaseVertexLocation, 0);
+		stateCache.CountDraw();
+	}
+}
+
+void DxRenderer::GetDrawRange(RenderLayers inLayer, UINT inTid, UINT& outBegin, UINT& outEnd) const {
+	const auto& bounds = mLayerPartitions[inLayer];
+	if (bounds.empty()) {
+		outBegin = 0;
+		outEnd = 0;
+		return;
+	}
+
+	outBegin = bounds[inTid];
+	outEnd = bounds[inTid + 1];
+}
+
+ID3D12PipelineState* DxRenderer::GetLayerPso(RenderLayers inLayer) {
+	switch (inLayer) {
+	case RenderLayers::ESkinnedOpaque:
+		return mPsoManager.GetPsoPtr("skinnedGbuffer");
+	case RenderLayers::EOpaqueSsr:
+		return mPsoManager.GetPsoPtr("gbufferSsr");
+	default:
+		return mPsoManager.GetPsoPtr("gbuffer");
 	}
 }
 
+void DxRenderer::PartitionSortedLayer(RenderLayers inLayer) {
+	const auto& ritems = mSortedRitemLayer[inLayer];
+
+	mDrawCosts.resize(ritems.size());
+
+	const MeshGeometry* prevGeo = nullptr;
+	D3D12_PRIMITIVE_TOPOLOGY prevTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+
+	for (size_t i = 0, end = ritems.size(); i < end; ++i) {
+		auto ritem = ritems[i];
+
+		// The draws are sorted, so only the binds DrawRenderItems can't skip are counted.
+		UINT numStateChanges = 0;
+		if (ritem->mGeo != prevGeo)
+			++numStateChanges;
+		if (ritem->mPrimitiveType != prevTopology)
+			++numStateChanges;
+
+		mDrawCosts[i] = DrawPartitioner::EstimateCost(ritem->mIndexCount, ritem->mNumInstancesToDraw, numStateChanges);
+
+		prevGeo = ritem->mGeo;
+		prevTopology = ritem->mPrimitiveType;
+	}
+
+	DrawPartitioner::Partition(mDrawCosts, mNumThreads, mLayerPartitions[inLayer]);
+}
+
 void DxRenderer::BindViews(ID3D12GraphicsCommandList* outCmdList, bool bShadowPass) {
 	auto passCB = mCurrFrameResource->mPassCB.Resource();
 	if (bShadowPass) {
@@ -2827,13 +3609,6 @@ void DxRenderer::BindDescriptorTables(ID3D12GraphicsCommandList* outCmdList, boo
 }
 
 void DxRenderer::BindRootConstants(ID3D12GraphicsCommandList* outCmdList) {
-	outCmdList->SetGraphicsRoot32BitConstants(
-		mRSManager.GetConstSettingsIndex(),
-		1,
-		&MaxInstanceCount,
-		0
-	);
-
 	outCmdList->SetGraphicsRoot32BitConstants(
 		mRSManager.GetConstSettingsIndex(),
 		1,
@@ -2846,6 +3621,8 @@ GameResult DxRenderer::DrawShadowMap(UINT inTid) {
 	ID3D12CommandAllocator* cmdListAlloc = mCurrFrameResource->mCmdListAllocs[inTid].Get();
 	ID3D12GraphicsCommandList* cmdList = mCommandLists[inTid].Get();
 
+	mShadowRecordTimers[inTid].SetBeginTime();
+
 	ReturnIfFailed(cmdList->Reset(cmdListAlloc, mPsoManager.GetPsoPtr("shadow")));
 	cmdList->SetGraphicsRootSignature(mRSManager.GetBasicRootSignature());
 
@@ -2873,31 +3650,21 @@ GameResult DxRenderer::DrawShadowMap(UINT inTid) {
 	//
 	// Draw shador for opaque. 
 	//
-	const auto& opaque = mRitemLayer[RenderLayers::EOpaque];
+	const auto& opaque = mSortedRitemLayer[RenderLayers::EOpaque];
 
-	UINT numRitems = static_cast<UINT>(opaque.size());
-	UINT eachNumRitems = numRitems / mNumThreads;
-	UINT remaining = numRitems % mNumThreads;
-
-	UINT begin = inTid * eachNumRitems + (inTid < remaining ? inTid : remaining);
-	UINT end = begin + eachNumRitems + (inTid < remaining ? 1 : 0);
+	UINT begin, end;
+	GetDrawRange(RenderLayers::EOpaque, inTid, begin, end);
 
 	DrawRenderItems(cmdList, opaque.data(), begin, end);
 
-	cmdList->SetPipelineState(mPsoManager.GetPsoPtr("skinnedShadow"));
 	//
 	// Draw shadow for skinned opaque.
 	//
-	const auto& skinnedOpaque = mRitemLayer[RenderLayers::ESkinnedOpaque];
-
-	numRitems = static_cast<UINT>(skinnedOpaque.size());
-	eachNumRitems = numRitems / mNumThreads;
-	remaining = numRitems % mNumThreads;
+	const auto& skinnedOpaque = mSortedRitemLayer[RenderLayers::ESkinnedOpaque];
 
-	begin = inTid * eachNumRitems + (inTid < remaining ? inTid : remaining);
-	end = begin + eachNumRitems + (inTid < remaining ? 1 : 0);
+	GetDrawRange(RenderLayers::ESkinnedOpaque, inTid, begin, end);
 
-	DrawRenderItems(cmdList, skinnedOpaque.data(), begin, end);
+	DrawSkinnedShadowRenderItems(cmdList, skinnedOpaque.data(), begin, end);
 
 	if (inTid == mNumThreads - 1) {
 		// Change back to PIXEL_SHADER_RESOURCE so we can read the texture in a shader.
@@ -2908,6 +3675,8 @@ GameResult DxRenderer::DrawShadowMap(UINT inTid) {
 	// Done recording commands.
 	ReturnIfFailed(cmdList->Close());
 
+	mShadowRecordTimers[inTid].SetEndTime();
+
 	SyncHost(mSpinlockBarrier);
 
 	if (inTid == 0) {
@@ -2931,7 +3700,9 @@ GameResult DxRenderer::DrawGBuffer(UINT inTid) {
 
 	// A command list can be reset after it has been added to the command queue via ExecuteCommandList.
 	// Reusing the command list reuses memory.
-	ReturnIfFailed(cmdList->Reset(cmdListAlloc, mPsoManager.GetPsoPtr("gbuffer")));
+	mGBufferRecordTimers[inTid].SetBeginTime();
+
+	ReturnIfFailed(cmdList->Reset(cmdListAlloc, GetLayerPso(RenderLayers::EOpaque)));
 	cmdList->SetGraphicsRootSignature(mRSManager.GetBasicRootSignature());
 
 	if (inTid == 0) {
@@ -2966,30 +3737,21 @@ GameResult DxRenderer::DrawGBuffer(UINT inTid) {
 	//
 	// Draw gbuffer for opaque.
 	//
-	const auto& opaque = mRitemLayer[RenderLayers::EOpaque];
+	const auto& opaque = mSortedRitemLayer[RenderLayers::EOpaque];
 
-	UINT numRitems = static_cast<UINT>(opaque.size());
-	UINT eachNumRitems = numRitems / mNumThreads;
-	UINT remaining = numRitems % mNumThreads;
-
-	UINT begin = inTid * eachNumRitems + (inTid < remaining ? inTid : remaining);
-	UINT end = begin + eachNumRitems + (inTid < remaining ? 1 : 0);
+	UINT begin, end;
+	GetDrawRange(RenderLayers::EOpaque, inTid, begin, end);
 
 	DrawRenderItems(cmdList, opaque.data(), begin, end);
 
 	//
 	// Draw gbuffer for skinned opaque.
 	//
-	cmdList->SetPipelineState(mPsoManager.GetPsoPtr("skinnedGbuffer"));
-
-	const auto& skinnedOpaque = mRitemLayer[RenderLayers::ESkinnedOpaque];
+	cmdList->SetPipelineState(GetLayerPso(RenderLayers::ESkinnedOpaque));
 
-	numRitems = static_cast<UINT>(skinnedOpaque.size());
-	eachNumRitems = numRitems / mNumThreads;
-	remaining = numRitems % mNumThreads;
+	const auto& skinnedOpaque = mSortedRitemLayer[RenderLayers::ESkinnedOpaque];
 
-	begin = inTid * eachNumRitems + (inTid < remaining ? inTid : remaining);
-	end = begin + eachNumRitems + (inTid < remaining ? 1 : 0);
+	GetDrawRange(RenderLayers::ESkinnedOpaque, inTid, begin, end);
 
 	DrawRenderItems(cmdList, skinnedOpaque.data(), begin, end);
 
@@ -2997,16 +3759,11 @@ GameResult DxRenderer::DrawGBuffer(UINT inTid) {
 	// Draw gbuffer for opaque onto which to project the reflected object.
 	//
 	cmdList->OMSetStencilRef(StencilMasks::ESsr);
-	cmdList->SetPipelineState(mPsoManager.GetPsoPtr("gbufferSsr"));
+	cmdList->SetPipelineState(GetLayerPso(RenderLayers::EOpaqueSsr));
 
-	const auto& opaqueSsr = mRitemLayer[RenderLayers::EOpaqueSsr];
+	const auto& opaqueSsr = mSortedRitemLayer[RenderLayers::EOpaqueSsr];
 
-	numRitems = static_cast<UINT>(opaqueSsr.size());
-	eachNumRitems = numRitems / mNumThreads;
-	remaining = numRitems % mNumThreads;
-
-	begin = inTid * eachNumRitems + (inTid < remaining ? inTid : remaining);
-	end = begin + eachNumRitems + (inTid < remaining ? 1 : 0);
+	GetDrawRange(RenderLayers::EOpaqueSsr, inTid, begin, end);
 
 	DrawRenderItems(cmdList, opaqueSsr.data(), begin, end);
 	cmdList->OMSetStencilRef(0);
@@ -3030,6 +3787,8 @@ GameResult DxRenderer::DrawGBuffer(UINT inTid) {
 	// Done recording commands.
 	ReturnIfFailed(cmdList->Close());
 
+	mGBufferRecordTimers[inTid].SetEndTime();
+
 	SyncHost(mSpinlockBarrier);
 
 	if (inTid == 0) {
@@ -3038,6 +3797,19 @@ GameResult DxRenderer::DrawGBuffer(UINT inTid) {
 			cmdsLists.push_back(mCommandLists[i].Get());
 
 		mCommandQueue->ExecuteCommandLists(static_cast<UINT>(cmdsLists.size()), cmdsLists.data());
+
+		// The recording times should be about the same if the draws are well balanced.
+		for (UINT i = 0; i < mNumThreads; ++i) {
+			AddOutputText(
+				"TEXT_RECORD_" + std::to_string(i),
+				L"record[" + std::to_wstring(i) + L"]: " +
+					std::to_wstring(mShadowRecordTimers[i].GetElapsedTime()) + L" / " +
+					std::to_wstring(mGBufferRecordTimers[i].GetElapsedTime()),
+				300.0f,
+				static_cast<float>(100 + 30.0f * i),
+				16.0f
+			);
+		}
 	}
 
 	return GameResultOk;
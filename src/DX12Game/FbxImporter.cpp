@@ -1,6 +1,7 @@
 #include "DX12Game/FbxImporter.h"
 #include "DX12Game/StringUtil.h"
 #include "DX12Game/ThreadUtil.h"
+#include "DX12Game/VertexWelder.h"
 
 #include <string>
 
@@ -10,6 +11,59 @@ using namespace fbxsdk;
 
 namespace {
 	const UINT InvalidBoneIndex = std::numeric_limits<UINT>::max();
+
+	// Attributes up to the bone weights are floats and quantized for welding, the bone indices are compared exactly.
+	const std::uint32_t NumFbxVertexFloatWords = static_cast<std::uint32_t>(offsetof(Game::FbxVertex, mBoneIndices) / sizeof(float));
+
+	//* Helper threads left for the imports in flight.
+	//* The imports run on the workers of the asset loader, so every import spawning a thread per processor
+	//*  would start workers times processors threads; the imports share one thread per processor instead
+	//*  (the calling threads take one each).
+	std::atomic<int>& GetFreeHelperThreads() {
+		static std::atomic<int> sFreeHelperThreads(static_cast<int>(ThreadUtil::GetProcessorCount(true)) - 1);
+		return sFreeHelperThreads;
+	}
+
+	//* Takes up to inNumWanted helper threads; the returned count must be given back through ReleaseHelperThreads.
+	UINT AcquireHelperThreads(size_t inNumWanted) {
+		auto& freeThreads = GetFreeHelperThreads();
+
+		int available = freeThreads.load();
+		int taken = 0;
+		do {
+			taken = static_cast<int>(std::min(inNumWanted, static_cast<size_t>(std::max(available, 0))));
+		} while (taken > 0 && !freeThreads.compare_exchange_weak(available, available - taken));
+
+		return static_cast<UINT>(taken);
+	}
+
+	void ReleaseHelperThreads(UINT inCount) {
+		GetFreeHelperThreads() += static_cast<int>(inCount);
+	}
+
+	//* Runs inFunc(job index) for each job on the calling thread and the helper threads it can acquire.
+	//* Jobs are handed out one by one, so the results must be stored by the job index.
+	template <typename Func>
+	void RunJobs(size_t inNumJobs, Func&& inFunc) {
+		std::atomic<size_t> nextJob(0);
+		auto jobFunc = [&]() -> void {
+			for (size_t i = nextJob++; i < inNumJobs; i = nextJob++)
+				inFunc(i);
+		};
+
+		UINT numHelpers = inNumJobs > 1 ? AcquireHelperThreads(inNumJobs - 1) : 0;
+
+		std::vector<std::thread> threads;
+		for (UINT i = 0; i < numHelpers; ++i)
+			threads.emplace_back(jobFunc);
+
+		jobFunc();
+
+		for (auto& thread : threads)
+			thread.join();
+
+		ReleaseHelperThreads(numHelpers);
+	}
 }
 
 Game::FbxVertex::FbxVertex(
@@ -143,19 +197,44 @@ bool Game::FbxImporter::LoadDataFromFile(const std::string& inFileName) {
 	MoveDataFromFbxAMatrixToDirectXMath();
 	NormalizeWeigths();
 
-	UINT prevNumVertices = 0;
+	BuildAnimations();
+
+	std::vector<FbxNode*> meshNodes;
 	for (size_t i = 0; i < fbxRootNode->GetChildCount(); ++i) {
 		FbxNode* childNode = fbxRootNode->GetChild((int)i);
 		if (childNode->GetNodeAttribute() && childNode->GetNodeAttribute()->GetAttributeType() == FbxNodeAttribute::eMesh) {
 			mSubsetNames.push_back(childNode->GetName());
+			meshNodes.push_back(childNode);
+		}
+	}
 
-			prevNumVertices = LoadDataFromMesh(childNode, prevNumVertices);
+	std::vector<std::vector<FbxVertex>> submeshVertices;
+	if (!MTLoadDataFromMesh(meshNodes, submeshVertices))
+		return false;
 
-			if (prevNumVertices < 0)
-				return false;
-		}
+	TaskTimer timer;
+	timer.SetBeginTime();
+
+	// Each submesh is welded on its own thread and the results are merged in submesh order,
+	//  so vertices shared between submeshes are still welded into one.
+	UINT numHelpers = submeshVertices.size() > 1 ? AcquireHelperThreads(submeshVertices.size() - 1) : 0;
+	VertexWelder::WeldSubmeshes(submeshVertices, NumFbxVertexFloatWords, numHelpers + 1, mVertices, mIndices);
+	ReleaseHelperThreads(numHelpers);
+
+	UINT startIndex = 0;
+	size_t numCorners = 0;
+	for (const auto& vertices : submeshVertices) {
+		UINT indexCount = static_cast<UINT>(vertices.size());
+		mSubsets.emplace_back(indexCount, startIndex);
+
+		startIndex += indexCount;
+		numCorners += vertices.size();
 	}
 
+	timer.SetEndTime();
+	WLogln(L"  Vertex Welding: ", std::to_wstring(numCorners), L" -> ", std::to_wstring(mVertices.size()),
+		L" vertices(", std::to_wstring(timer.GetElapsedTime()), L" seconds)");
+
 	return true;
 }
 
@@ -366,7 +445,7 @@ namespace {
 	}
 }
 
-int Game::FbxImporter::LoadDataFromMesh(FbxNode* inNode, UINT inPrevNumVertices) {
+bool Game::FbxImporter::LoadDataFromMesh(FbxNode* inNode, std::vector<FbxVertex>& outVertices) {
 	auto fbxMesh = inNode->GetMesh();
 	std::string meshName = fbxMesh->GetName();
 
@@ -382,12 +461,19 @@ int Game::FbxImporter::LoadDataFromMesh(FbxNode* inNode, UINT inPrevNumVertices)
 	const UINT polygonCount = fbxMesh->GetPolygonCount();
 	UINT vertexCounter = 0;
 
+	// Looked up without inserting, since the meshes are read concurrently.
+	auto meshWeightsIter = mControlPointsWeights.find(meshName);
+	const auto* controlPointsWeights = meshWeightsIter != mControlPointsWeights.end() ? &meshWeightsIter->second : nullptr;
+
+	outVertices.clear();
+	outVertices.reserve(static_cast<size_t>(polygonCount) * 3);
+
 	for (UINT polygonIdx = 0; polygonIdx < polygonCount; ++polygonIdx) {
 		const UINT numPolygonVertices = fbxMesh->GetPolygonSize(polygonIdx);
 
 		if (numPolygonVertices != 3) {
 			WErrln(L"Polygon vertex size for Fbx mesh is not matched 3");
-			return -1;
+			return false;
 		}
 
 		for (int vertIdx = 0; vertIdx < 3; ++vertIdx) {
@@ -399,25 +485,36 @@ int Game::FbxImporter::LoadDataFromMesh(FbxNode* inNode, UINT inPrevNumVertices)
 			const XMFLOAT3 tangent = ReadTangent(fbxMesh, controlPointIndex, vertexCounter);
 
 			FbxVertex vertex = { pos, normal, texC, tangent };
-			const auto& boneIdxWeights = mControlPointsWeights[meshName][controlPointIndex];
-			for (size_t i = 0, end = boneIdxWeights.size(); i < end; ++i) {
-				vertex.mBoneIndices[i] = boneIdxWeights[i].mBoneIndex;
-				vertex.mBoneWeights[i] = boneIdxWeights[i].mWeight;
+			if (controlPointsWeights != nullptr) {
+				auto weightsIter = controlPointsWeights->find(controlPointIndex);
+				if (weightsIter != controlPointsWeights->end()) {
+					const auto& boneIdxWeights = weightsIter->second;
+					for (size_t i = 0, end = boneIdxWeights.size(); i < end; ++i) {
+						vertex.mBoneIndices[i] = boneIdxWeights[i].mBoneIndex;
+						vertex.mBoneWeights[i] = boneIdxWeights[i].mWeight;
+					}
+				}
 			}
 
-			if (mUniqueVertices.count(vertex) == 0) {
-				mUniqueVertices[vertex] = static_cast<std::uint32_t>(mVertices.size());
-				mVertices.push_back(vertex);
-			}
-			
-			mIndices.push_back(mUniqueVertices[vertex]);
+			outVertices.push_back(vertex);
 			++vertexCounter;
 		}
 	}
 
-	mSubsets.emplace_back(static_cast<UINT>(vertexCounter), inPrevNumVertices);
+	return true;
+}
+
+bool Game::FbxImporter::MTLoadDataFromMesh(const std::vector<FbxNode*>& inNodes, std::vector<std::vector<FbxVertex>>& outVertices) {
+	outVertices.clear();
+	outVertices.resize(inNodes.size());
 
-	return vertexCounter + inPrevNumVertices;
+	std::atomic<bool> status(true);
+	RunJobs(inNodes.size(), [&](size_t inIndex) -> void {
+		if (!LoadDataFromMesh(inNodes[inIndex], outVertices[inIndex]))
+			status = false;
+	});
+
+	return status;
 }
 
 void Game::FbxImporter::LoadMaterials(FbxNode* inNode) {
@@ -600,7 +697,14 @@ bool Game::FbxImporter::LoadBones(FbxNode* inNode) {
 			int parentIndex = currBone.mParentIndex;
 
 			BuildBindPoseData(currCluster, geometryTransform, clusterIndex, parentIndex, mSkeleton, currBone);
-			BuildAnimations(inNode, currCluster, geometryTransform, clusterIndex, parentIndex);
+
+			BoneBakeJob job;
+			job.mNode = inNode;
+			job.mCluster = currCluster;
+			job.mGeometryTransform = geometryTransform;
+			job.mClusterIndex = clusterIndex;
+			job.mParentIndex = parentIndex;
+			mBoneBakeJobs.push_back(job);
 		}
 	}
 
@@ -794,119 +898,210 @@ void Game::FbxImporter::BuildControlPointsWeigths(FbxCluster* inCluster, UINT in
 	}
 }
 
-void Game::FbxImporter::BuildAnimations(FbxNode* inNode,
-									FbxCluster* inCluster,
-									const FbxAMatrix& inGeometryTransform, 		
-									UINT inClusterIndex,
-									int inParentIndex) {
+void Game::FbxImporter::BuildAnimations() {
+	if (mBoneBakeJobs.empty())
+		return;
+
+	TaskTimer timer;
+	timer.SetBeginTime();
+
+	auto timeMode = mFbxScene->GetGlobalSettings().GetTimeMode();
+
+	// Layers are grouped by clip name in the order the stacks and layers are visited,
+	//  so layers sharing a name are appended to the same clip.
+	std::vector<ClipLayer> layers;
+	std::vector<std::string> clipNames;
+	std::vector<std::vector<size_t>> clipLayers;
+
 	int stackCount = mFbxScene->GetSrcObjectCount<FbxAnimStack>();
 	for (int stackIdx = 0; stackIdx < stackCount; ++stackIdx) {
-		auto animStack = mFbxScene->GetSrcObject<FbxAnimStack>(stackIdx);	
+		auto animStack = mFbxScene->GetSrcObject<FbxAnimStack>(stackIdx);
 		int layerCount = animStack->GetMemberCount<FbxAnimLayer>();
 		for (int layerIdx = 0; layerIdx < layerCount; ++layerIdx) {
 			auto animLayer = FbxCast<FbxAnimLayer>(animStack->GetMember(layerIdx));
 			auto layerName = animLayer->GetName();
-			
+
 			auto takeInfo = mFbxScene->GetTakeInfo(layerName);
+			if (takeInfo == nullptr)
+				continue;
 
 			std::string layerNameStr(layerName);
 			size_t markOfIndex = layerNameStr.find_first_of('|');
 			std::string animationName = layerNameStr.substr(markOfIndex + 1);
 
-			auto iter = mAnimations.find(animationName);
-			if (iter != mAnimations.cend()) {
-				auto& animation = iter->second;
-				BuildAnimationKeyFrames(animLayer, inNode, inCluster, 
-					inGeometryTransform, takeInfo, animation, inClusterIndex, inParentIndex);
-				//BuildAnimationKeyFrames(takeInfo, inCluster, inNode, 
-				//	inGeometryTransform, animation, inClusterIndex, inParentIndex);
-			}
-			else {
-				FbxAnimation animation;				
-				BuildAnimationKeyFrames(animLayer, inNode, inCluster,
-					inGeometryTransform, takeInfo, animation, inClusterIndex, inParentIndex);
-				//BuildAnimationKeyFrames(takeInfo, inCluster, inNode,
-				//	inGeometryTransform, animation, inClusterIndex, inParentIndex);
-				
-				mAnimations[animationName] = animation;
+			ClipLayer layer;
+			layer.mAnimLayer = animLayer;
+			layer.mTakeInfo = takeInfo;
+			layer.mStartFrame = takeInfo->mLocalTimeSpan.GetStart().GetFrameCount(timeMode);
+			layer.mEndFrame = takeInfo->mLocalTimeSpan.GetStop().GetFrameCount(timeMode);
+
+			auto clipIter = std::find(clipNames.begin(), clipNames.end(), animationName);
+			size_t clipIndex = static_cast<size_t>(clipIter - clipNames.begin());
+			if (clipIter == clipNames.end()) {
+				clipNames.push_back(animationName);
+				clipLayers.emplace_back();
 			}
+
+			clipLayers[clipIndex].push_back(layers.size());
+			layers.push_back(layer);
 		}
 	}
-}
 
-void Game::FbxImporter::BuildAnimationKeyFrames(FbxAnimLayer*		inAnimLayer,
-											FbxNode*			inNode, 
-											FbxCluster*			inCluster, 
-											const FbxAMatrix&	inGeometryTransform, 
-											FbxTakeInfo*		inTakeInfo, 
-											FbxAnimation&		outAnimation, 
-											UINT				inClusterIndex, 
-											int					inParentIndex) {
-	auto timeMode = mFbxScene->GetGlobalSettings().GetTimeMode();
+	if (layers.empty())
+		return;
 
-	FbxTime startTime = inTakeInfo->mLocalTimeSpan.GetStart();
-	FbxTime endTime = inTakeInfo->mLocalTimeSpan.GetStop();
+	// The clips are created up front, so the jobs below never insert into mAnimations.
+	std::vector<FbxAnimation*> clipAnimations;
+	for (const auto& clipName : clipNames)
+		clipAnimations.push_back(&mAnimations[clipName]);
 
-	auto startFrameCount = startTime.GetFrameCount(timeMode);
-	auto endFrameCount = endTime.GetFrameCount(timeMode);
+	const size_t numJobs = mBoneBakeJobs.size();
 
-	if (inClusterIndex == 0) {
-		outAnimation.mNumFrames = endFrameCount - startFrameCount;
-		outAnimation.mDuration = static_cast<float>(endTime.GetSecondDouble() - startTime.GetSecondDouble());
-		outAnimation.mFrameDuration = outAnimation.mDuration / (outAnimation.mNumFrames++);
+	std::vector<FbxNode*> meshNodes;
+	std::vector<size_t> jobMeshNodes(numJobs);
+	for (size_t i = 0; i < numJobs; ++i) {
+		auto iter = std::find(meshNodes.begin(), meshNodes.end(), mBoneBakeJobs[i].mNode);
+		jobMeshNodes[i] = static_cast<size_t>(iter - meshNodes.begin());
+		if (iter == meshNodes.end())
+			meshNodes.push_back(mBoneBakeJobs[i].mNode);
 	}
-	
-	const auto& animCurveTransX = inCluster->GetLink()->LclTranslation.GetCurve(inAnimLayer, FBXSDK_CURVENODE_COMPONENT_X);
-	const auto& animCurveTransY = inCluster->GetLink()->LclTranslation.GetCurve(inAnimLayer, FBXSDK_CURVENODE_COMPONENT_Y);
-	const auto& animCurveTransZ = inCluster->GetLink()->LclTranslation.GetCurve(inAnimLayer, FBXSDK_CURVENODE_COMPONENT_Z);
-	const auto& animCurveRotX	= inCluster->GetLink()->LclRotation.GetCurve(inAnimLayer,	 FBXSDK_CURVENODE_COMPONENT_X);
-	const auto& animCurveRotY	= inCluster->GetLink()->LclRotation.GetCurve(inAnimLayer,	 FBXSDK_CURVENODE_COMPONENT_Y);
-	const auto& animCurveRotZ	= inCluster->GetLink()->LclRotation.GetCurve(inAnimLayer,	 FBXSDK_CURVENODE_COMPONENT_Z);
-	const auto& animCurveScaleX = inCluster->GetLink()->LclScaling.GetCurve(inAnimLayer,	 FBXSDK_CURVENODE_COMPONENT_X);
-	const auto& animCurveScaleY = inCluster->GetLink()->LclScaling.GetCurve(inAnimLayer,	 FBXSDK_CURVENODE_COMPONENT_Y);
-	const auto& animCurveScaleZ = inCluster->GetLink()->LclScaling.GetCurve(inAnimLayer,	 FBXSDK_CURVENODE_COMPONENT_Z);
-	
-	for (auto currFrame = startFrameCount; currFrame <= endFrameCount; ++currFrame) {
+
+	const size_t numMeshNodes = meshNodes.size();
+
+	// The mesh global transform is the same for every bone of the mesh, so it is evaluated
+	//  once per frame instead of once per bone and frame.
+	// The scene evaluator isn't thread-safe, so this part stays on the calling thread.
+	std::vector<std::vector<FbxAMatrix>> offsetInverses(layers.size() * numMeshNodes);
+	for (size_t layerIdx = 0, numLayers = layers.size(); layerIdx < numLayers; ++layerIdx) {
+		const auto& layer = layers[layerIdx];
+
+		for (size_t nodeIdx = 0; nodeIdx < numMeshNodes; ++nodeIdx) {
+			size_t jobIdx = static_cast<size_t>(std::find(jobMeshNodes.begin(), jobMeshNodes.end(), nodeIdx) - jobMeshNodes.begin());
+			const auto& geometryTransform = mBoneBakeJobs[jobIdx].mGeometryTransform;
+
+			auto& inverses = offsetInverses[layerIdx * numMeshNodes + nodeIdx];
+			inverses.reserve(static_cast<size_t>(layer.mEndFrame - layer.mStartFrame + 1));
+
+			for (auto currFrame = layer.mStartFrame; currFrame <= layer.mEndFrame; ++currFrame) {
+				FbxTime currTime;
+				currTime.SetFrame(currFrame, timeMode);
+
+				FbxAMatrix currTransformOffset =
+					UnifyCoordinates(std::as_const(meshNodes[nodeIdx]->EvaluateGlobalTransform(currTime))) * geometryTransform;
+
+				inverses.push_back(currTransformOffset.Inverse());
+			}
+		}
+	}
+
+	// Each (layer, bone) job only reads its own bone's curves.
+	std::vector<std::vector<FbxAMatrix>> localPoses(layers.size() * numJobs);
+	RunJobs(localPoses.size(), [&](size_t inIndex) -> void {
+		size_t layerIdx = inIndex / numJobs;
+		size_t jobIdx = inIndex % numJobs;
+
+		BuildLocalPoses(layers[layerIdx], mBoneBakeJobs[jobIdx], timeMode, localPoses[inIndex]);
+	});
+
+	// A bone needs the global transforms of its parent, so the bones of a clip are accumulated in order.
+	RunJobs(clipNames.size(), [&](size_t inIndex) -> void {
+		for (size_t jobIdx = 0; jobIdx < numJobs; ++jobIdx) {
+			for (auto layerIdx : clipLayers[inIndex]) {
+				BuildAnimationKeyFrames(layers[layerIdx], mBoneBakeJobs[jobIdx],
+					localPoses[layerIdx * numJobs + jobIdx],
+					offsetInverses[layerIdx * numMeshNodes + jobMeshNodes[jobIdx]],
+					*clipAnimations[inIndex]);
+			}
+		}
+	});
+
+	timer.SetEndTime();
+	WLogln(L"  Animation Baking: ", std::to_wstring(clipNames.size()), L" clips, ", std::to_wstring(numJobs),
+		L" bones(", std::to_wstring(timer.GetElapsedTime()), L" seconds)");
+}
+
+void Game::FbxImporter::BuildLocalPoses(const ClipLayer&		inLayer,
+										const BoneBakeJob&		inJob,
+										FbxTime::EMode			inTimeMode,
+										std::vector<FbxAMatrix>& outPoses) const {
+	auto animLayer = inLayer.mAnimLayer;
+	auto link = inJob.mCluster->GetLink();
+
+	const auto& animCurveTransX = link->LclTranslation.GetCurve(animLayer, FBXSDK_CURVENODE_COMPONENT_X);
+	const auto& animCurveTransY = link->LclTranslation.GetCurve(animLayer, FBXSDK_CURVENODE_COMPONENT_Y);
+	const auto& animCurveTransZ = link->LclTranslation.GetCurve(animLayer, FBXSDK_CURVENODE_COMPONENT_Z);
+	const auto& animCurveRotX	= link->LclRotation.GetCurve(animLayer,	FBXSDK_CURVENODE_COMPONENT_X);
+	const auto& animCurveRotY	= link->LclRotation.GetCurve(animLayer,	FBXSDK_CURVENODE_COMPONENT_Y);
+	const auto& animCurveRotZ	= link->LclRotation.GetCurve(animLayer,	FBXSDK_CURVENODE_COMPONENT_Z);
+	const auto& animCurveScaleX = link->LclScaling.GetCurve(animLayer,	FBXSDK_CURVENODE_COMPONENT_X);
+	const auto& animCurveScaleY = link->LclScaling.GetCurve(animLayer,	FBXSDK_CURVENODE_COMPONENT_Y);
+	const auto& animCurveScaleZ = link->LclScaling.GetCurve(animLayer,	FBXSDK_CURVENODE_COMPONENT_Z);
+
+	// Key search hints for each curve; the frames are visited in order,
+	//  so the search resumes from the previous key instead of starting over.
+	int lastKeys[9] = {};
+
+	const FbxAMatrix& localTransform = mSkeleton.mBones[inJob.mClusterIndex].mFbxLocalBindPose;
+	const auto& T = localTransform.GetT();
+	const auto& R = localTransform.GetR();
+	const auto& S = localTransform.GetS();
+
+	outPoses.clear();
+	outPoses.reserve(static_cast<size_t>(inLayer.mEndFrame - inLayer.mStartFrame + 1));
+
+	for (auto currFrame = inLayer.mStartFrame; currFrame <= inLayer.mEndFrame; ++currFrame) {
 		FbxTime currTime;
-		currTime.SetFrame(currFrame, timeMode);
-		
-		FbxAMatrix localTransform = mSkeleton.mBones[inClusterIndex].mFbxLocalBindPose;
-		const auto& T = localTransform.GetT();
-		const auto& R = localTransform.GetR();
-		const auto& S = localTransform.GetS();
-
-		float transX = (animCurveTransX != NULL) ? -animCurveTransX->Evaluate(currTime) : static_cast<float>(T.mData[0]);
-		float transY = (animCurveTransY != NULL) ? animCurveTransY->Evaluate(currTime)  : static_cast<float>(T.mData[1]);
-		float transZ = (animCurveTransZ != NULL) ? animCurveTransZ->Evaluate(currTime)  : static_cast<float>(T.mData[2]);
+		currTime.SetFrame(currFrame, inTimeMode);
+
+		float transX = (animCurveTransX != NULL) ? -animCurveTransX->Evaluate(currTime, &lastKeys[0]) : static_cast<float>(T.mData[0]);
+		float transY = (animCurveTransY != NULL) ? animCurveTransY->Evaluate(currTime, &lastKeys[1])  : static_cast<float>(T.mData[1]);
+		float transZ = (animCurveTransZ != NULL) ? animCurveTransZ->Evaluate(currTime, &lastKeys[2])  : static_cast<float>(T.mData[2]);
 		FbxVector4 transVector4(transX, transY, transZ, 1.0);
 
-		float rotX = (animCurveRotX != NULL) ? animCurveRotX->Evaluate(currTime)  : static_cast<float>(R.mData[0]);
-		float rotY = (animCurveRotY != NULL) ? -animCurveRotY->Evaluate(currTime) : static_cast<float>(R.mData[1]);
-		float rotZ = (animCurveRotZ != NULL) ? -animCurveRotZ->Evaluate(currTime) : static_cast<float>(R.mData[2]);
+		float rotX = (animCurveRotX != NULL) ? animCurveRotX->Evaluate(currTime, &lastKeys[3])  : static_cast<float>(R.mData[0]);
+		float rotY = (animCurveRotY != NULL) ? -animCurveRotY->Evaluate(currTime, &lastKeys[4]) : static_cast<float>(R.mData[1]);
+		float rotZ = (animCurveRotZ != NULL) ? -animCurveRotZ->Evaluate(currTime, &lastKeys[5]) : static_cast<float>(R.mData[2]);
 		FbxVector4 rotVector4(rotX, rotY, rotZ, 0.0);
 
-		float scaleX = (animCurveScaleX != NULL) ? animCurveScaleX->Evaluate(currTime) : static_cast<float>(S.mData[0]);
-		float scaleY = (animCurveScaleY != NULL) ? animCurveScaleY->Evaluate(currTime) : static_cast<float>(S.mData[1]);
-		float scaleZ = (animCurveScaleZ != NULL) ? animCurveScaleZ->Evaluate(currTime) : static_cast<float>(S.mData[2]);
+		float scaleX = (animCurveScaleX != NULL) ? animCurveScaleX->Evaluate(currTime, &lastKeys[6]) : static_cast<float>(S.mData[0]);
+		float scaleY = (animCurveScaleY != NULL) ? animCurveScaleY->Evaluate(currTime, &lastKeys[7]) : static_cast<float>(S.mData[1]);
+		float scaleZ = (animCurveScaleZ != NULL) ? animCurveScaleZ->Evaluate(currTime, &lastKeys[8]) : static_cast<float>(S.mData[2]);
 		FbxVector4 scaleVector4(scaleX, scaleY, scaleZ, 0.0);
 
-		FbxAMatrix currentPoseTransform(transVector4, rotVector4, scaleVector4);
+		outPoses.emplace_back(transVector4, rotVector4, scaleVector4);
+	}
+}
+
+void Game::FbxImporter::BuildAnimationKeyFrames(const ClipLayer&				inLayer,
+												const BoneBakeJob&				inJob,
+												const std::vector<FbxAMatrix>&	inLocalPoses,
+												const std::vector<FbxAMatrix>&	inOffsetInverses,
+												FbxAnimation&					outAnimation) {
+	if (inJob.mClusterIndex == 0) {
+		FbxTime startTime = inLayer.mTakeInfo->mLocalTimeSpan.GetStart();
+		FbxTime endTime = inLayer.mTakeInfo->mLocalTimeSpan.GetStop();
+
+		outAnimation.mNumFrames = inLayer.mEndFrame - inLayer.mStartFrame;
+		outAnimation.mDuration = static_cast<float>(endTime.GetSecondDouble() - startTime.GetSecondDouble());
+		outAnimation.mFrameDuration = outAnimation.mDuration / (outAnimation.mNumFrames++);
+	}
+
+	const auto& globalInvTransform = mSkeleton.mBones[inJob.mClusterIndex].mFbxGlobalInvBindPose;
+
+	for (auto currFrame = inLayer.mStartFrame; currFrame <= inLayer.mEndFrame; ++currFrame) {
+		size_t poseIndex = static_cast<size_t>(currFrame - inLayer.mStartFrame);
+		const auto& currentPoseTransform = inLocalPoses[poseIndex];
 
 		FbxAMatrix globalTransform;
-		if (inParentIndex != -1)
+		if (inJob.mParentIndex != -1)
 			globalTransform = 
-			outAnimation.mParentGlobalTransforms[inParentIndex][static_cast<size_t>(currFrame)] * currentPoseTransform;
+			outAnimation.mParentGlobalTransforms[inJob.mParentIndex][static_cast<size_t>(currFrame)] * currentPoseTransform;
 		else 
 			globalTransform = currentPoseTransform;
 
-		FbxAMatrix currTransformOffset =
-			UnifyCoordinates(std::as_const(inNode->EvaluateGlobalTransform(currTime))) * inGeometryTransform;
-
-		const auto& globalInvTransform = mSkeleton.mBones[inClusterIndex].mFbxGlobalInvBindPose;
-
-		outAnimation.mParentGlobalTransforms[inClusterIndex].push_back(globalTransform);
-		outAnimation.mCurves[inClusterIndex].push_back(FbxAMatrixToXMFloat4x4(
-			currTransformOffset.Inverse() * globalTransform * globalInvTransform));
+		outAnimation.mParentGlobalTransforms[inJob.mClusterIndex].push_back(globalTransform);
+		outAnimation.mCurves[inJob.mClusterIndex].push_back(FbxAMatrixToXMFloat4x4(
+			inOffsetInverses[poseIndex] * globalTransform * globalInvTransform));
 	}
 }
 
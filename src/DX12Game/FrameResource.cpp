@@ -5,7 +5,7 @@ using namespace DirectX;
 
 Game::ObjectConstants::ObjectConstants(UINT inObjectIndex /* = 0 */) {
 	mObjectIndex = inObjectIndex;
-	mObjectPad0 = 0;
+	mInstanceOffset = 0;
 	mObjectPad1 = 0;
 	mObjectPad2 = 0;
 }
@@ -27,10 +27,13 @@ Game::InstanceData::InstanceData(
 
 	mWorld = inWorld;
 	mTexTransform = inTexTransform;
-	mTimePos = inTimePos;
 	mMaterialIndex = inMaterialIndex;
-	mAnimClipIndex = inAnimClipIndex;
 	mRenderState = inRenderState;
+	mInstPad0 = 0;
+	mInstPad1 = 0;
+	mInstPad2 = 0;
+
+	SetAnimation(inAnimClipIndex, inTimePos);
 
 	SetFramesDirty(gNumFrameResources);
 }
@@ -56,6 +59,28 @@ namespace {
 	const UINT DecreaseOne = (1 << BitShift);
 }
 
+void Game::InstanceData::SetAnimation(int inAnimClipIndex, float inTimePos) {
+	mAnimClipIndex = inAnimClipIndex;
+	mTimePos = inTimePos;
+
+	for (size_t i = 0; i < 3; ++i) {
+		mBlendAnimClipIndices[i] = -1;
+		mBlendTimePos[i] = 0.0f;
+	}
+
+	mBlendWeights[0] = 1.0f;
+	for (size_t i = 1; i < 4; ++i)
+		mBlendWeights[i] = 0.0f;
+
+	SetPlayback(0.0f, 0.0f, 0.0f);
+}
+
+void Game::InstanceData::SetPlayback(float inTimeRate, float inTimeBase, float inTimeEnd) {
+	mTimeRate = inTimeRate;
+	mTimeBase = inTimeBase;
+	mTimeEnd = inTimeEnd;
+}
+
 bool Game::InstanceData::CheckFrameDirty(UINT inIndex) const {
 	return ((mRenderState >> BitShift) & (1 << inIndex)) != 0;
 }
@@ -166,10 +191,10 @@ bool Game::operator==(const SkinnedVertex& lhs, const SkinnedVertex& rhs) {
 }
 
 Game::FrameResource::FrameResource(ID3D12Device* inDevice,
-	UINT inPassCount, UINT inObjectCount, UINT inMaxInstanceCount, UINT inMaterialCount) 
+	UINT inPassCount, UINT inObjectCount, UINT inInstanceCapacity, UINT inMaterialCount) 
 	: mPassCount(inPassCount), 
 	  mObjectCount(inObjectCount), 
-	  mMaxInstanceCount(inMaxInstanceCount), 
+	  mInstanceCapacity(inInstanceCapacity), 
 	  mMaterialCount(inMaterialCount) {
 
 	mDevice = inDevice;
@@ -177,6 +202,7 @@ Game::FrameResource::FrameResource(ID3D12Device* inDevice,
 
 GameResult Game::FrameResource::Initialize(UINT inNumThreads) {
 	mCmdListAllocs.resize(inNumThreads);
+	mInstanceTrackers.resize(inNumThreads);
 
 	for (UINT i = 0; i < inNumThreads; ++i) {
 		ReturnIfFailed(
@@ -194,8 +220,17 @@ GameResult Game::FrameResource::Initialize(UINT inNumThreads) {
 	mSsrCB.Initialize(mDevice, 1, true);
 	mBloomCB.Initialize(mDevice, 1, true);
 	mMaterialBuffer.Initialize(mDevice, mMaterialCount, false);
-	mInstanceIdxBuffer.Initialize(mDevice, mObjectCount * mMaxInstanceCount, false);
-	mInstanceDataBuffer.Initialize(mDevice, mObjectCount * mMaxInstanceCount, false);
+	mInstanceIdxBuffer.Initialize(mDevice, mInstanceCapacity, false);
+	mInstanceDataBuffer.Initialize(mDevice, mInstanceCapacity, false);
+
+	return GameResult(S_OK);
+}
+
+GameResult Game::FrameResource::ResizeInstanceBuffers(UINT inInstanceCapacity) {
+	mInstanceCapacity = inInstanceCapacity;
+
+	CheckGameResult(mInstanceIdxBuffer.Initialize(mDevice, mInstanceCapacity, false));
+	CheckGameResult(mInstanceDataBuffer.Initialize(mDevice, mInstanceCapacity, false));
 
 	return GameResult(S_OK);
 }
\ No newline at end of file
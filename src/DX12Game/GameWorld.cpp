@@ -8,6 +8,12 @@
 #include "DX12Game/InputSystem.h"
 #include "DX12Game/GameCamera.h"
 #include "DX12Game/Mesh.h"
+#include "DX12Game/AssetLoader.h"
+#include "DX12Game/ImportCache.h"
+#include "DX12Game/LoadGraph.h"
+#include "DX12Game/AnimationGraph.h"
+#include "DX12Game/PoseCache.h"
+#include "DX12Game/AnimationLod.h"
 #include "DX12Game/SkeletalMeshComponent.h"
 #include "DX12Game/FpsActor.h"
 #include "DX12Game/TpsActor.h"
@@ -15,6 +21,17 @@
 using namespace DirectX;
 using namespace DirectX::PackedVector;
 
+namespace {
+	// Vertex and index bytes uploaded per frame at most by the asset loader,
+	//  so meshes that finish loading together don't stall a single frame.
+	const std::uint64_t UploadBudgetBytesPerFrame = 16 * 1024 * 1024;
+
+	const std::string ImportCacheDirectory = "./../../../../Assets/Cache/";
+
+	// Written next to the log once every asset of the load graph is completed.
+	const std::string LoadTimelineFileName = "./load_timeline.csv";
+}
+
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance, PSTR cmdLine, int showCmd) {
 	// Enable run-time memory check for debug builds
 #ifdef _DEBUG
@@ -134,6 +151,20 @@ GameResult GameWorld::Initialize(INT inWidth /* = 800 */, UINT inHeight /* = 600
 
 	mPerfAnalyzer.Initialize(mRenderer.get(), mNumProcessors);
 
+	// Every logical processor runs a game thread, so the loader keeps one less to share them.
+	mImportCache = std::make_unique<Game::ImportCache>();
+	if (!mImportCache->Initialize(ImportCacheDirectory))
+		Logln("Failed to create the import cache directory: ", ImportCacheDirectory);
+
+	mAssetLoader = std::make_unique<Game::AssetLoader>();
+	mAssetLoader->Initialize(std::max(mNumProcessors, 2u) - 1);
+
+	mLoadGraph = std::make_unique<Game::LoadGraph>();
+
+	mAnimationGraphBatch = std::make_unique<Game::AnimationGraphBatch>();
+	mPoseCache = std::make_unique<Game::PoseCache>();
+	mAnimationLod = std::make_unique<Game::AnimationLod>();
+
 	mLimitFrameRate = GameTimer::LimitFrameRate::ELimitFrameRateNone;
 	mTimer.SetLimitFrameRate(mLimitFrameRate);
 
@@ -142,6 +173,10 @@ GameResult GameWorld::Initialize(INT inWidth /* = 800 */, UINT inHeight /* = 600
 }
 
 void GameWorld::CleanUp() {
+	if (mAssetLoader != nullptr)
+		mAssetLoader->CleanUp();
+	mPendingMeshes.clear();
+
 	if (mInputSystem != nullptr)
 		mInputSystem->CleanUp();
 	if (mAudioSystem != nullptr)
@@ -159,12 +194,17 @@ void GameWorld::CleanUp() {
 }
 
 GameResult GameWorld::LoadData() {
+	mLoadingTimer.SetBeginTime();
+
 	mMusicEvent = mAudioSystem->PlayEvent("event:/Over the Waves");
 
 #ifdef UsingVulkan
 	//TpsActor* tpsActor = new TpsActor();
 	//tpsActor->SetPosition(0.0f, 0.0f, -5.0f);
 
+	DeclareMesh("monkey.fbx", false, false, MeshComponent::ELoadNormal);
+	CheckGameResult(SubmitLoadGraph());
+
 	XMVECTOR rotateYPi = XMQuaternionRotationAxis(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), XM_PI);
 
 	//Actor* leoniActor = new Actor();
@@ -188,6 +228,17 @@ GameResult GameWorld::LoadData() {
 #endif
 
 #ifndef UsingVulkan	
+	// Every distinct file of the level starts loading here;
+	//  the actors below only bind to the loads and receive the meshes as each completes.
+	DeclareMesh("monkey.fbx", false, false, MeshComponent::ELoadNormal);
+	DeclareMesh("leoni.fbx", true, false, MeshComponent::ELoadHigh);
+	DeclareMesh("tree_a.fbx", false, false, MeshComponent::ELoadNormal);
+	DeclareMesh("grass_variant_1.fbx", false, false, MeshComponent::ELoadLow);
+	DeclareMesh("grass_variant_2.fbx", false, false, MeshComponent::ELoadLow);
+	DeclareMesh("grass_variant_3.fbx", false, false, MeshComponent::ELoadLow);
+	DeclareMesh("grass_variant_4.fbx", false, false, MeshComponent::ELoadLow);
+	CheckGameResult(SubmitLoadGraph());
+
 	TpsActor* tpsActor = new TpsActor();
 	tpsActor->SetPosition(0.0f, 0.0f, -5.0f);
 
@@ -228,7 +279,7 @@ GameResult GameWorld::LoadData() {
 	leoniActor->SetPosition(0.0f, 0.0f, -2.0f);
 	leoniActor->SetQuaternion(rotateYPi);
 	SkeletalMeshComponent* leoniMeshComp = new SkeletalMeshComponent(leoniActor);
-	CheckGameResult(leoniMeshComp->LoadMesh("leoni", "leoni.fbx"));
+	CheckGameResult(leoniMeshComp->LoadMesh("leoni", "leoni.fbx", MeshComponent::ELoadHigh));
 	leoniMeshComp->SetClipName("Idle");
 	leoniMeshComp->SetSkeleletonVisible(false);
 
@@ -250,7 +301,7 @@ GameResult GameWorld::LoadData() {
 				XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), 2.0f * MathHelper::RandF() * MathHelper::Pi - MathHelper::Pi));
 	
 			treeMeshComp = new MeshComponent(treeActor);
-			CheckGameResult(treeMeshComp->LoadMesh("tree", "tree_a.fbx"));
+			CheckGameResult(treeMeshComp->LoadMesh("tree", "tree_a.fbx", MeshComponent::ELoadNormal));
 		}
 	}
 
@@ -282,7 +333,7 @@ GameResult GameWorld::LoadData() {
 			);
 
 			grassoneMeshComp = new MeshComponent(grassoneActor);
-			CheckGameResult(grassoneMeshComp->LoadMesh("grassone", "grass_variant_1.fbx"));
+			CheckGameResult(grassoneMeshComp->LoadMesh("grassone", "grass_variant_1.fbx", MeshComponent::ELoadLow));
 		}
 	}
 
@@ -313,7 +364,7 @@ GameResult GameWorld::LoadData() {
 			);
 
 			grasstwoMeshComp = new MeshComponent(grasstwoActor);
-			CheckGameResult(grasstwoMeshComp->LoadMesh("grasstwo", "grass_variant_2.fbx"));
+			CheckGameResult(grasstwoMeshComp->LoadMesh("grasstwo", "grass_variant_2.fbx", MeshComponent::ELoadLow));
 		}
 	}
 
@@ -344,7 +395,7 @@ GameResult GameWorld::LoadData() {
 			);
 
 			grassthreeMeshComp = new MeshComponent(grassthreeActor);
-			CheckGameResult(grassthreeMeshComp->LoadMesh("grassthree", "grass_variant_3.fbx"));
+			CheckGameResult(grassthreeMeshComp->LoadMesh("grassthree", "grass_variant_3.fbx", MeshComponent::ELoadLow));
 		}
 	}
 
@@ -375,7 +426,7 @@ GameResult GameWorld::LoadData() {
 			);
 
 			grassfourMeshComp = new MeshComponent(grassfourActor);
-			CheckGameResult(grassfourMeshComp->LoadMesh("grassfour", "grass_variant_4.fbx"));
+			CheckGameResult(grassfourMeshComp->LoadMesh("grassfour", "grass_variant_4.fbx", MeshComponent::ELoadLow));
 		}
 	}
 #endif // UsingVulkan
@@ -405,6 +456,10 @@ GameResult GameWorld::RunLoop() {
 
 	GameResult result = GameLoop();
 
+	// The loader threads may still refer to the pending meshes.
+	mAssetLoader->CleanUp();
+	mPendingMeshes.clear();
+
 	UnloadData();
 
 	return result;
@@ -430,6 +485,9 @@ GameResult GameWorld::GameLoop() {
 		if (elapsedTime > mTimer.GetLimitFrameRate()) {
 			beginTime = endTime;
 
+			PumpAssets();
+			UpdateAnimations(elapsedTime);
+
 			if (!mAppPaused) {
 				ProcessInput(mTimer);
 			}
@@ -492,6 +550,13 @@ GameResult GameWorld::GameLoop() {
 
 				if (elapsedTime > mTimer.GetLimitFrameRate()) {
 					mPerfAnalyzer.WholeLoopBeginTime(0);
+
+					// Uploads and completion callbacks run while the other game threads are parked at the barrier,
+					//  so the render-items and components they add are never seen half-built.
+					PumpAssets();
+					// The parameters and the poses the actors requested during the last update drive this frame.
+					UpdateAnimations(elapsedTime);
+
 					barrier.Wait();
 
 					if (mGameState == GameState::ETerminated)
@@ -575,10 +640,96 @@ GameResult GameWorld::AddMesh(const std::string& inFileName, Mesh*& outMeshPtr,
 	return GameResultOk;
 }
 
+void GameWorld::AddMeshAsync(const std::string& inFileName, bool inIsSkeletal, bool inNeedToBeAligned, int inPriority,
+		const std::function<void(Mesh*)>& inCallback) {
+	Game::LoadGraph::NodeId node = mLoadGraph->FindNode(inFileName);
+	if (node != Game::LoadGraph::InvalidNode)
+		mLoadGraph->AddBinding(node);
+
+	LoadMeshAsync(inFileName, inIsSkeletal, inNeedToBeAligned, inPriority, inCallback);
+}
+
+void GameWorld::DeclareMesh(const std::string& inFileName, bool inIsSkeletal, bool inNeedToBeAligned, int inPriority) {
+	Game::LoadGraph::NodeId node = mLoadGraph->AddNode(inFileName, [this, inFileName, inIsSkeletal, inNeedToBeAligned, inPriority](Game::LoadGraph::NodeId) -> void {
+		LoadMeshAsync(inFileName, inIsSkeletal, inNeedToBeAligned, inPriority, [](Mesh*) -> void {});
+	});
+
+	if (node == Game::LoadGraph::InvalidNode)
+		Logln("The load graph is already submitted; the mesh is loaded on request: ", inFileName);
+}
+
+GameResult GameWorld::SubmitLoadGraph() {
+	if (!mLoadGraph->Submit())
+		ReturnGameResult(E_INVALIDARG, L"The dependencies of the load graph form a cycle");
+
+	return GameResultOk;
+}
+
+void GameWorld::LoadMeshAsync(const std::string& inFileName, bool inIsSkeletal, bool inNeedToBeAligned, int inPriority,
+		const std::function<void(Mesh*)>& inCallback) {
+	// The nodes are fixed once the graph is submitted, so the loader threads may record into them.
+	Game::LoadGraph::NodeId node = mLoadGraph->IsSubmitted() ? mLoadGraph->FindNode(inFileName) : Game::LoadGraph::InvalidNode;
+	Game::LoadGraph* graph = mLoadGraph.get();
+
+	auto iter = mMeshes.find(inFileName);
+	if (iter != mMeshes.end()) {
+		inCallback(iter->second.get());
+		return;
+	}
+
+	// Requests that join a load in flight share the pending mesh.
+	auto pendingIter = mPendingMeshes.find(inFileName);
+	if (pendingIter == mPendingMeshes.end())
+		pendingIter = mPendingMeshes.emplace(inFileName, std::make_unique<Mesh>(inIsSkeletal, inNeedToBeAligned)).first;
+	Mesh* mesh = pendingIter->second.get();
+
+	Game::AssetRequest request;
+	request.mKey = inFileName;
+	request.mPriority = inPriority;
+	request.mLoad = [mesh, inFileName, graph, node](std::uint64_t& outUploadBytes) -> bool {
+		if (node != Game::LoadGraph::InvalidNode)
+			graph->MarkLoadBegin(node);
+
+		if (FAILED(mesh->Decode(inFileName).hr))
+			return false;
+
+		outUploadBytes = mesh->GetUploadByteSize();
+
+		if (node != Game::LoadGraph::InvalidNode)
+			graph->MarkLoadEnd(node, outUploadBytes);
+		return true;
+	};
+	request.mUpload = [mesh]() -> bool {
+		return SUCCEEDED(mesh->Upload().hr);
+	};
+
+	mAssetLoader->Request(request, [this, inFileName, inCallback, node](bool inSucceeded) -> void {
+		auto pendingIter = mPendingMeshes.find(inFileName);
+		if (pendingIter != mPendingMeshes.end()) {
+			if (inSucceeded)
+				mMeshes.emplace(inFileName, std::move(pendingIter->second));
+			else
+				Logln("Failed to load mesh: ", inFileName);
+
+			mPendingMeshes.erase(pendingIter);
+		}
+
+		if (node != Game::LoadGraph::InvalidNode)
+			mLoadGraph->Complete(node, inSucceeded);
+
+		auto iter = mMeshes.find(inFileName);
+		inCallback(iter != mMeshes.end() ? iter->second.get() : nullptr);
+	});
+}
+
 void GameWorld::RemoveMesh(const std::string& fileName) {
 	auto iter = mMeshes.find(fileName);
-	if (iter != mMeshes.end())
-		mMeshes.erase(iter);
+	if (iter == mMeshes.end())
+		return;
+
+	// The lines of the clips are reused by the meshes loaded later.
+	iter->second->ReleaseAnimations();
+	mMeshes.erase(iter);
 }
 
 GameWorld* GameWorld::GetWorld() {
@@ -589,6 +740,22 @@ Renderer* GameWorld::GetRenderer() const {
 	return mRenderer.get();
 }
 
+Game::ImportCache* GameWorld::GetImportCache() const {
+	return mImportCache.get();
+}
+
+Game::AnimationGraphBatch* GameWorld::GetAnimationGraphBatch() const {
+	return mAnimationGraphBatch.get();
+}
+
+Game::PoseCache* GameWorld::GetPoseCache() const {
+	return mPoseCache.get();
+}
+
+Game::AnimationLod* GameWorld::GetAnimationLod() const {
+	return mAnimationLod.get();
+}
+
 InputSystem* GameWorld::GetInputSystem() const {
 	return mInputSystem.get();
 }
@@ -928,6 +1095,50 @@ GameResult GameWorld::Draw(const GameTimer& gt, UINT inTid) {
 	return GameResult(S_OK);
 }
 
+void GameWorld::PumpAssets() {
+	mAssetLoader->Pump(UploadBudgetBytesPerFrame);
+
+	if (!bLoadingInfoOutputted && mAssetLoader->IsIdle()) {
+		OutputLoadingInfo();
+		bLoadingInfoOutputted = true;
+	}
+}
+
+void GameWorld::UpdateAnimations(float inDeltaTime) {
+	mAnimationGraphBatch->Evaluate(inDeltaTime);
+	mPerfAnalyzer.SetAnimationGraphStatistics(mAnimationGraphBatch->GetStatistics());
+
+	mPoseCache->Update();
+	mPerfAnalyzer.SetPoseCacheStatistics(mPoseCache->GetStatistics());
+
+	mAnimationLod->BeginFrame();
+	mPerfAnalyzer.SetAnimationLodStatistics(mAnimationLod->GetStatistics());
+}
+
+void GameWorld::OutputLoadingInfo() {
+	mLoadingTimer.SetEndTime();
+
+	auto stats = mImportCache->GetStatistics();
+	WLogln(L"Loading Time: ", std::to_wstring(mLoadingTimer.GetElapsedTime()), L" seconds");
+	WLogln(L"  Warm(Import Cache): ", std::to_wstring(stats.mNumHits), L" meshes, ",
+		std::to_wstring(stats.mHitTime), L" seconds");
+	WLogln(L"  Cold(FBX): ", std::to_wstring(stats.mNumMisses), L" meshes, ",
+		std::to_wstring(stats.mMissTime), L" seconds");
+
+	std::vector<Game::LoadTimelineEntry> timeline;
+	mLoadGraph->GetTimeline(timeline);
+	for (const auto& entry : timeline) {
+		std::stringstream sstream;
+		sstream << "  " << entry.mName << ": issued " << entry.mIssueTime
+			<< ", loaded " << entry.mLoadBeginTime << " - " << entry.mLoadEndTime
+			<< ", completed " << entry.mCompleteTime << ", " << entry.mNumBindings << " bindings";
+		Logln(sstream.str());
+	}
+
+	if (!mLoadGraph->WriteTimeline(LoadTimelineFileName))
+		Logln("Failed to write the load timeline: ", LoadTimelineFileName);
+}
+
 GameResult GameWorld::InitMainWindow() {
 #ifdef UsingVulkan
 	glfwInit();
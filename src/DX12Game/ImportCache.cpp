@@ -0,0 +1,200 @@
+#include "DX12Game/ImportCache.h"
+#include "common/MappedFile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+
+#ifdef _WIN32
+	#define NOMINMAX
+	#include <Windows.h>
+#else
+	#include <unistd.h>
+#endif
+
+using namespace Game;
+
+namespace {
+	const std::uint64_t Prime0 = 0x9E3779B185EBCA87ULL;
+	const std::uint64_t Prime1 = 0xC2B2AE3D27D4EB4FULL;
+	const std::uint64_t Prime2 = 0x165667B19E3779F9ULL;
+	const std::uint64_t Prime3 = 0x85EBCA77C2B2AE63ULL;
+	const std::uint64_t Prime4 = 0x27D4EB2F165667C5ULL;
+
+	inline std::uint64_t Rotl(std::uint64_t inValue, int inBits) {
+		return (inValue << inBits) | (inValue >> (64 - inBits));
+	}
+
+	inline std::uint64_t Read64(const std::uint8_t* inPtr) {
+		std::uint64_t value;
+		std::memcpy(&value, inPtr, sizeof(value));
+		return value;
+	}
+
+	inline std::uint32_t Read32(const std::uint8_t* inPtr) {
+		std::uint32_t value;
+		std::memcpy(&value, inPtr, sizeof(value));
+		return value;
+	}
+
+	inline std::uint64_t Round(std::uint64_t inAcc, std::uint64_t inInput) {
+		inAcc += inInput * Prime1;
+		inAcc = Rotl(inAcc, 31);
+		return inAcc * Prime0;
+	}
+
+	inline std::uint64_t MergeRound(std::uint64_t inAcc, std::uint64_t inValue) {
+		inAcc ^= Round(0, inValue);
+		return inAcc * Prime0 + Prime3;
+	}
+
+	std::string ToHex(std::uint64_t inValue) {
+		std::stringstream sstream;
+		sstream << std::hex << std::setw(16) << std::setfill('0') << inValue;
+		return sstream.str();
+	}
+
+	std::uint32_t GetCurrentProcessIdentifier() {
+#ifdef _WIN32
+		return static_cast<std::uint32_t>(GetCurrentProcessId());
+#else
+		return static_cast<std::uint32_t>(getpid());
+#endif
+	}
+}
+
+bool ImportCache::Initialize(const std::string& inDirectory) {
+	mDirectory = inDirectory;
+	if (!mDirectory.empty() && mDirectory.back() != '/' && mDirectory.back() != '\\')
+		mDirectory.push_back('/');
+
+	std::error_code error;
+	std::filesystem::create_directories(mDirectory, error);
+
+	return std::filesystem::is_directory(mDirectory, error);
+}
+
+bool ImportCache::ComputeKey(const std::string& inSourceFileName, std::uint64_t inOptions, std::uint32_t inFormatVersion,
+		std::uint64_t& outKey) const {
+	MappedFile file;
+	if (!file.Open(inSourceFileName))
+		return false;
+
+	const std::uint64_t header[] = { inOptions, ImporterVersion, inFormatVersion, file.GetSize() };
+	std::uint64_t seed = Hash(header, sizeof(header));
+
+	outKey = Hash(file.GetData(), static_cast<size_t>(file.GetSize()), seed);
+
+	return true;
+}
+
+std::string ImportCache::GetFilePath(std::uint64_t inKey, const std::string& inExt) const {
+	return mDirectory + ToHex(inKey) + inExt;
+}
+
+std::string ImportCache::GetTempFilePath(std::uint64_t inKey, const std::string& inExt) const {
+	std::stringstream sstream;
+	sstream << mDirectory << ToHex(inKey) << inExt << '.' << GetCurrentProcessIdentifier() << '.' << mNextTempId++ << ".tmp";
+
+	return sstream.str();
+}
+
+bool ImportCache::Commit(const std::string& inTempFilePath, std::uint64_t inKey, const std::string& inExt) const {
+	std::string filePath = GetFilePath(inKey, inExt);
+
+	// The entry is replaced in one step, so a rejected container(a damaged file or an older layout under
+	//  the same key) is overwritten and a reader never sees a partially written file.
+	std::error_code error;
+	std::filesystem::rename(inTempFilePath, filePath, error);
+	if (!error)
+		return true;
+
+	// The entry may be mapped by another process at the moment; it is replaced by a later import.
+	std::filesystem::remove(inTempFilePath, error);
+
+	return false;
+}
+
+void ImportCache::Discard(const std::string& inTempFilePath) const {
+	std::error_code error;
+	std::filesystem::remove(inTempFilePath, error);
+}
+
+void ImportCache::RecordHit(float inSeconds) {
+	++mNumHits;
+	mHitMicroseconds += static_cast<std::uint64_t>(inSeconds * 1000000.0f);
+}
+
+void ImportCache::RecordMiss(float inSeconds) {
+	++mNumMisses;
+	mMissMicroseconds += static_cast<std::uint64_t>(inSeconds * 1000000.0f);
+}
+
+ImportCacheStatistics ImportCache::GetStatistics() const {
+	ImportCacheStatistics stats;
+	stats.mNumHits = mNumHits;
+	stats.mHitTime = static_cast<float>(mHitMicroseconds) / 1000000.0f;
+	stats.mNumMisses = mNumMisses;
+	stats.mMissTime = static_cast<float>(mMissMicroseconds) / 1000000.0f;
+
+	return stats;
+}
+
+std::uint64_t ImportCache::Hash(const void* inData, size_t inSize, std::uint64_t inSeed) {
+	// xxHash64; four independent lanes keep the multipliers busy on large source files.
+	const auto* ptr = static_cast<const std::uint8_t*>(inData);
+	const auto* end = ptr + inSize;
+
+	std::uint64_t hash;
+	if (inSize >= 32) {
+		std::uint64_t v0 = inSeed + Prime0 + Prime1;
+		std::uint64_t v1 = inSeed + Prime1;
+		std::uint64_t v2 = inSeed;
+		std::uint64_t v3 = inSeed - Prime0;
+
+		const auto* limit = end - 32;
+		do {
+			v0 = Round(v0, Read64(ptr));
+			v1 = Round(v1, Read64(ptr + 8));
+			v2 = Round(v2, Read64(ptr + 16));
+			v3 = Round(v3, Read64(ptr + 24));
+			ptr += 32;
+		} while (ptr <= limit);
+
+		hash = Rotl(v0, 1) + Rotl(v1, 7) + Rotl(v2, 12) + Rotl(v3, 18);
+		hash = MergeRound(hash, v0);
+		hash = MergeRound(hash, v1);
+		hash = MergeRound(hash, v2);
+		hash = MergeRound(hash, v3);
+	}
+	else {
+		hash = inSeed + Prime4;
+	}
+
+	hash += static_cast<std::uint64_t>(inSize);
+
+	for (; ptr + 8 <= end; ptr += 8) {
+		hash ^= Round(0, Read64(ptr));
+		hash = Rotl(hash, 27) * Prime0 + Prime3;
+	}
+
+	if (ptr + 4 <= end) {
+		hash ^= static_cast<std::uint64_t>(Read32(ptr)) * Prime0;
+		hash = Rotl(hash, 23) * Prime1 + Prime2;
+		ptr += 4;
+	}
+
+	for (; ptr < end; ++ptr) {
+		hash ^= static_cast<std::uint64_t>(*ptr) * Prime4;
+		hash = Rotl(hash, 11) * Prime0;
+	}
+
+	hash ^= hash >> 33;
+	hash *= Prime1;
+	hash ^= hash >> 29;
+	hash *= Prime2;
+	hash ^= hash >> 32;
+
+	return hash;
+}
\ No newline at end of file
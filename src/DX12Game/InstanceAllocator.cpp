@@ -0,0 +1,244 @@
+#include "DX12Game/InstanceAllocator.h"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace Game;
+
+void InstanceAllocator::Initialize(std::uint32_t inInitialCapacity, std::uint32_t inGranularity) {
+	mRanges.clear();
+	mFreeHandles.clear();
+	mFreeBlocks.clear();
+
+	mGranularity = std::max(inGranularity, 1u);
+	mCapacity = RoundUp(inInitialCapacity);
+	mReserved = 0;
+
+	if (mCapacity > 0)
+		mFreeBlocks.emplace(0, mCapacity);
+
+	++mGeneration;
+}
+
+InstanceAllocator::Handle InstanceAllocator::Allocate(std::uint32_t inCount) {
+	std::uint32_t size = RoundUp(std::max(inCount, 1u));
+
+	std::uint32_t offset;
+	if (!TakeFreeBlock(size, offset)) {
+		Grow(size);
+		TakeFreeBlock(size, offset);
+	}
+
+	Handle handle;
+	if (mFreeHandles.empty()) {
+		handle = static_cast<Handle>(mRanges.size());
+		mRanges.emplace_back();
+	}
+	else {
+		handle = mFreeHandles.back();
+		mFreeHandles.pop_back();
+	}
+
+	auto& range = mRanges[handle];
+	range.mOffset = offset;
+	range.mSize = size;
+	range.bAlive = true;
+
+	mReserved += size;
+
+	return handle;
+}
+
+bool InstanceAllocator::Reserve(Handle inHandle, std::uint32_t inCount) {
+	auto& range = mRanges[inHandle];
+	if (inCount <= range.mSize)
+		return false;
+
+	// Double the range to amortize repeated growth of the same render-item.
+	std::uint32_t newSize = RoundUp(std::max(inCount, range.mSize * 2));
+	std::uint32_t extra = newSize - range.mSize;
+
+	auto next = mFreeBlocks.find(range.mOffset + range.mSize);
+	if (next != mFreeBlocks.end() && next->second >= extra) {
+		std::uint32_t remaining = next->second - extra;
+		std::uint32_t remainingOffset = next->first + extra;
+
+		mFreeBlocks.erase(next);
+		if (remaining > 0)
+			mFreeBlocks.emplace(remainingOffset, remaining);
+
+		range.mSize = newSize;
+		mReserved += extra;
+
+		return false;
+	}
+
+	InsertFreeBlock(range.mOffset, range.mSize);
+	mReserved -= range.mSize;
+
+	std::uint32_t offset;
+	if (!TakeFreeBlock(newSize, offset)) {
+		Grow(newSize);
+		TakeFreeBlock(newSize, offset);
+	}
+
+	auto& moved = mRanges[inHandle];
+	moved.mOffset = offset;
+	moved.mSize = newSize;
+	mReserved += newSize;
+
+	++mGeneration;
+
+	return true;
+}
+
+void InstanceAllocator::Free(Handle inHandle) {
+	auto& range = mRanges[inHandle];
+	if (!range.bAlive)
+		return;
+
+	InsertFreeBlock(range.mOffset, range.mSize);
+	mReserved -= range.mSize;
+
+	range.bAlive = false;
+	mFreeHandles.push_back(inHandle);
+}
+
+bool InstanceAllocator::Compact() {
+	std::vector<Handle> order;
+	order.reserve(mRanges.size());
+
+	for (Handle i = 0, end = static_cast<Handle>(mRanges.size()); i < end; ++i) {
+		if (mRanges[i].bAlive)
+			order.push_back(i);
+	}
+
+	std::sort(order.begin(), order.end(), [&](Handle lhs, Handle rhs) {
+		return mRanges[lhs].mOffset < mRanges[rhs].mOffset;
+	});
+
+	bool moved = false;
+	std::uint32_t offset = 0;
+
+	for (auto handle : order) {
+		auto& range = mRanges[handle];
+		if (range.mOffset != offset) {
+			range.mOffset = offset;
+			moved = true;
+		}
+		offset += range.mSize;
+	}
+
+	mFreeBlocks.clear();
+	if (offset < mCapacity)
+		mFreeBlocks.emplace(offset, mCapacity - offset);
+
+	if (moved)
+		++mGeneration;
+
+	return moved;
+}
+
+bool InstanceAllocator::Defragment(float inThreshold) {
+	if (mFreeBlocks.size() < 2)
+		return false;
+
+	if (GetStatistics().mFragmentation <= inThreshold)
+		return false;
+
+	return Compact();
+}
+
+std::uint32_t InstanceAllocator::GetOffset(Handle inHandle) const {
+	return mRanges[inHandle].mOffset;
+}
+
+std::uint32_t InstanceAllocator::GetSize(Handle inHandle) const {
+	return mRanges[inHandle].mSize;
+}
+
+std::uint32_t InstanceAllocator::GetCapacity() const {
+	return mCapacity;
+}
+
+std::uint32_t InstanceAllocator::GetGeneration() const {
+	return mGeneration;
+}
+
+InstanceAllocatorStatistics InstanceAllocator::GetStatistics() const {
+	InstanceAllocatorStatistics stats;
+	stats.mCapacity = mCapacity;
+	stats.mReserved = mReserved;
+	stats.mNumRanges = static_cast<std::uint32_t>(mRanges.size() - mFreeHandles.size());
+	stats.mNumFreeBlocks = static_cast<std::uint32_t>(mFreeBlocks.size());
+
+	std::uint32_t totalFree = 0;
+	for (const auto& block : mFreeBlocks) {
+		totalFree += block.second;
+		stats.mLargestFreeBlock = std::max(stats.mLargestFreeBlock, block.second);
+	}
+
+	if (totalFree > 0)
+		stats.mFragmentation = 1.0f - static_cast<float>(stats.mLargestFreeBlock) / static_cast<float>(totalFree);
+
+	return stats;
+}
+
+std::uint32_t InstanceAllocator::RoundUp(std::uint32_t inCount) const {
+	return (inCount + mGranularity - 1) / mGranularity * mGranularity;
+}
+
+bool InstanceAllocator::TakeFreeBlock(std::uint32_t inSize, std::uint32_t& outOffset) {
+	for (auto iter = mFreeBlocks.begin(), end = mFreeBlocks.end(); iter != end; ++iter) {
+		if (iter->second < inSize)
+			continue;
+
+		outOffset = iter->first;
+
+		std::uint32_t remaining = iter->second - inSize;
+		mFreeBlocks.erase(iter);
+
+		if (remaining > 0)
+			mFreeBlocks.emplace(outOffset + inSize, remaining);
+
+		return true;
+	}
+
+	return false;
+}
+
+void InstanceAllocator::InsertFreeBlock(std::uint32_t inOffset, std::uint32_t inSize) {
+	auto iter = mFreeBlocks.emplace(inOffset, inSize).first;
+
+	auto next = std::next(iter);
+	if (next != mFreeBlocks.end() && iter->first + iter->second == next->first) {
+		iter->second += next->second;
+		mFreeBlocks.erase(next);
+	}
+
+	if (iter != mFreeBlocks.begin()) {
+		auto prev = std::prev(iter);
+		if (prev->first + prev->second == iter->first) {
+			prev->second += iter->second;
+			mFreeBlocks.erase(iter);
+		}
+	}
+}
+
+void InstanceAllocator::Grow(std::uint32_t inRequiredSize) {
+	// The free block at the tail of the buffer is extended by the growth.
+	std::uint32_t tailSize = 0;
+	if (!mFreeBlocks.empty()) {
+		const auto& tail = *mFreeBlocks.rbegin();
+		if (tail.first + tail.second == mCapacity)
+			tailSize = tail.second;
+	}
+
+	std::uint32_t newCapacity = std::max(mCapacity * 2, mCapacity + inRequiredSize - tailSize);
+	newCapacity = RoundUp(newCapacity);
+
+	InsertFreeBlock(mCapacity, newCapacity - mCapacity);
+	mCapacity = newCapacity;
+
+	++mGeneration;
+}
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "DX12Game/LoadGraph.h"
+
+#include <fstream>
+#include <iomanip>
+
+using namespace Game;
+
+LoadGraph::LoadGraph() : mSubmitTime(std::chrono::steady_clock::now()) {}
+
+LoadGraph::NodeId LoadGraph::AddNode(const std::string& inName, IssueFunc inIssue) {
+	if (bSubmitted)
+		return InvalidNode;
+
+	auto iter = mNodeIds.find(inName);
+	if (iter != mNodeIds.end())
+		return iter->second;
+
+	NodeId id = static_cast<NodeId>(mNodes.size());
+
+	Node node;
+	node.mIssue = std::move(inIssue);
+	node.mTimeline.mName = inName;
+
+	mNodes.push_back(std::move(node));
+	mNodeIds.emplace(inName, id);
+
+	return id;
+}
+
+LoadGraph::NodeId LoadGraph::FindNode(const std::string& inName) const {
+	auto iter = mNodeIds.find(inName);
+	return iter != mNodeIds.end() ? iter->second : InvalidNode;
+}
+
+bool LoadGraph::AddDependency(NodeId inNode, NodeId inDependency) {
+	if (bSubmitted || inNode >= mNodes.size() || inDependency >= mNodes.size() || inNode == inDependency)
+		return false;
+
+	mNodes[inDependency].mDependents.push_back(inNode);
+	++mNodes[inNode].mNumPendingDependencies;
+
+	return true;
+}
+
+bool LoadGraph::Submit() {
+	if (bSubmitted)
+		return true;
+
+	// Kahn's algorithm over a copy of the counts; nodes left unvisited are on a cycle.
+	std::vector<std::uint32_t> numPending(mNodes.size());
+	std::vector<NodeId> ready;
+
+	for (NodeId i = 0, end = static_cast<NodeId>(mNodes.size()); i < end; ++i) {
+		numPending[i] = mNodes[i].mNumPendingDependencies;
+		if (numPending[i] == 0)
+			ready.push_back(i);
+	}
+
+	std::vector<NodeId> roots = ready;
+
+	std::size_t numVisited = 0;
+	while (!ready.empty()) {
+		NodeId id = ready.back();
+		ready.pop_back();
+		++numVisited;
+
+		for (NodeId dependent : mNodes[id].mDependents) {
+			if (--numPending[dependent] == 0)
+				ready.push_back(dependent);
+		}
+	}
+
+	if (numVisited != mNodes.size())
+		return false;
+
+	bSubmitted = true;
+	mSubmitTime = std::chrono::steady_clock::now();
+
+	for (NodeId id : roots)
+		Issue(id);
+
+	return true;
+}
+
+bool LoadGraph::IsSubmitted() const {
+	return bSubmitted;
+}
+
+void LoadGraph::MarkLoadBegin(NodeId inNode) {
+	float time = GetTime();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mNodes[inNode].mTimeline.mLoadBeginTime = time;
+}
+
+void LoadGraph::MarkLoadEnd(NodeId inNode, std::uint64_t inUploadBytes) {
+	float time = GetTime();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mNodes[inNode].mTimeline.mLoadEndTime = time;
+	mNodes[inNode].mTimeline.mUploadBytes = inUploadBytes;
+}
+
+void LoadGraph::Complete(NodeId inNode, bool inSucceeded) {
+	auto& node = mNodes[inNode];
+	if (node.mState == ECompleted)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		node.mTimeline.mCompleteTime = GetTime();
+		node.mTimeline.bSucceeded = inSucceeded;
+	}
+
+	node.mState = ECompleted;
+	++mNumCompleted;
+
+	if (!inSucceeded) {
+		Fail(inNode);
+		return;
+	}
+
+	// Issuing may complete other nodes synchronously, so the list is copied first.
+	std::vector<NodeId> dependents = node.mDependents;
+	for (NodeId dependent : dependents) {
+		auto& next = mNodes[dependent];
+		if (next.mState == EDeclared && --next.mNumPendingDependencies == 0)
+			Issue(dependent);
+	}
+}
+
+void LoadGraph::AddBinding(NodeId inNode) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	++mNodes[inNode].mTimeline.mNumBindings;
+}
+
+bool LoadGraph::IsDone() const {
+	return bSubmitted && mNumCompleted == mNodes.size();
+}
+
+void LoadGraph::GetTimeline(std::vector<LoadTimelineEntry>& outTimeline) const {
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	outTimeline.clear();
+	outTimeline.reserve(mNodes.size());
+	for (const auto& node : mNodes)
+		outTimeline.push_back(node.mTimeline);
+}
+
+bool LoadGraph::WriteTimeline(const std::string& inFileName) const {
+	std::vector<LoadTimelineEntry> timeline;
+	GetTimeline(timeline);
+
+	std::ofstream file(inFileName, std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	file << "asset,issue,load_begin,load_end,complete,upload_bytes,bindings,succeeded\n";
+	file << std::fixed << std::setprecision(4);
+
+	for (const auto& entry : timeline) {
+		file << entry.mName << ','
+			<< entry.mIssueTime << ','
+			<< entry.mLoadBeginTime << ','
+			<< entry.mLoadEndTime << ','
+			<< entry.mCompleteTime << ','
+			<< entry.mUploadBytes << ','
+			<< entry.mNumBindings << ','
+			<< (entry.bSucceeded ? 1 : 0) << '\n';
+	}
+
+	return static_cast<bool>(file);
+}
+
+float LoadGraph::GetTime() const {
+	return std::chrono::duration<float>(std::chrono::steady_clock::now() - mSubmitTime).count();
+}
+
+void LoadGraph::Issue(NodeId inNode) {
+	auto& node = mNodes[inNode];
+	if (node.mState != EDeclared)
+		return;
+
+	node.mState = EIssued;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		node.mTimeline.mIssueTime = GetTime();
+	}
+
+	// A node without an issue function only orders the others.
+	if (node.mIssue)
+		node.mIssue(inNode);
+	else
+		Complete(inNode, true);
+}
+
+void LoadGraph::Fail(NodeId inNode) {
+	std::vector<NodeId> stack = mNodes[inNode].mDependents;
+
+	while (!stack.empty()) {
+		NodeId id = stack.back();
+		stack.pop_back();
+
+		auto& node = mNodes[id];
+		if (node.mState == ECompleted)
+			continue;
+
+		node.mState = ECompleted;
+		++mNumCompleted;
+
+		stack.insert(stack.end(), node.mDependents.begin(), node.mDependents.end());
+	}
+}
\ No newline at end of file
@@ -3,12 +3,17 @@
 #include "DX12Game/Renderer.h"
 #include "DX12Game/FrameResource.h"
 #include "DX12Game/FBXImporter.h"
+#include "DX12Game/MeshOptimizer.h"
+#include "common/MappedFile.h"
+#include "DX12Game/CookedMesh.h"
+#include "DX12Game/ImportCache.h"
 
 using namespace DirectX;
 using namespace DirectX::PackedVector;
 
 namespace {
 	const std::string fileNamePrefix = "./../../../../Assets/Models/";
+	const std::string cookedFileNameExt = ".cmesh";
 
 	void LoadVertices(const Game::FbxImporter& inImporter, std::vector<Game::Vertex>& outVertices) {
 		const auto& fbxVertices = inImporter.GetVertices();
@@ -192,60 +197,113 @@ Mesh::Mesh(bool inIsSkeletal, bool inNeedToBeAligned)
 	: bIsSkeletal(inIsSkeletal), 
 	  bNeedToBeAligned(inNeedToBeAligned) {
 	mRenderer = GameWorld::GetWorld()->GetRenderer();
+	mImportCache = GameWorld::GetWorld()->GetImportCache();
 }
 
 GameResult Mesh::Load(const std::string& inFileName) {
+	CheckGameResult(Decode(inFileName));
+	CheckGameResult(Upload());
+
+	return GameResultOk;
+}
+
+GameResult Mesh::Decode(const std::string& inFileName) {
 	size_t extIndex = inFileName.find_last_of('.', inFileName.length());
 	mMeshName = inFileName.substr(0, extIndex);
+
+	std::string fileName = fileNamePrefix + inFileName;
 	
 	TaskTimer timer;
 	timer.SetBeginTime();
-	Game::FbxImporter importer;
-	{
-		std::stringstream fileNameSstream;
-		fileNameSstream << fileNamePrefix << inFileName;
-	
-		if (!importer.LoadDataFromFile(fileNameSstream.str())) {
-			std::wstring wstr;
-			wstr.assign(inFileName.begin(), inFileName.end());
-			ReturnGameResult(E_FAIL, L"Failed to load data from file: " + wstr);
+
+	// Static and skinned imports of the same file produce different containers.
+	std::uint64_t key = 0;
+	bool hasKey = mImportCache != nullptr &&
+		mImportCache->ComputeKey(fileName, bIsSkeletal ? 1 : 0, Game::CookedMesh::Version, key);
+
+	bLoadedFromCooked = hasKey && LoadFromCooked(mImportCache->GetFilePath(key, cookedFileNameExt), key);
+	if (!bLoadedFromCooked) {
+		// Drops whatever a rejected container left behind.
+		mVertices.clear();
+		mSkinnedVertices.clear();
+		mIndices.clear();
+		mDrawArgs.clear();
+		mSubsets.clear();
+		mMaterials.clear();
+		mSkinnedData.mSkeleton.mBones.clear();
+		mSkinnedData.mAnimations.clear();
+
+		CheckGameResult(LoadFromFbx(fileName));
+		if (bIsSkeletal)
+			PruneSkinWeights();
+		OptimizeGeometry();
+		// The container stores the compressed clips, so a warm load doesn't compress them again.
+		CompressAnimations();
+
+		if (hasKey) {
+			std::string tempFileName = mImportCache->GetTempFilePath(key, cookedFileNameExt);
+			if (!Cook(tempFileName, key)) {
+				mImportCache->Discard(tempFileName);
+				Logln("  Failed to write cooked mesh: ", tempFileName);
+			}
+			else if (!mImportCache->Commit(tempFileName, key, cookedFileNameExt)) {
+				Logln("  Failed to commit cooked mesh: ", mImportCache->GetFilePath(key, cookedFileNameExt));
+			}
 		}
 	}
-	
+
 	if (bIsSkeletal) {
-		LoadSkinnedVertices(std::ref(importer), std::ref(mSkinnedVertices));
-		LoadSkeletons(std::ref(importer), std::ref(mSkinnedData.mSkeleton));
+		QuantizeSkinWeights();
 		GenerateSkeletonData();
 	}
-	else {
-		LoadVertices(importer, std::ref(mVertices));
+
+	timer.SetEndTime();
+	mDecodeTime = timer.GetElapsedTime();
+
+	if (mImportCache != nullptr) {
+		if (bLoadedFromCooked)
+			mImportCache->RecordHit(mDecodeTime);
+		else
+			mImportCache->RecordMiss(mDecodeTime);
 	}
-	
-	LoadIndices(std::ref(importer), std::ref(mIndices));
-	LoadDrawArgs(std::ref(importer), mMeshName, std::ref(mDrawArgs));
-	LoadSubsets(std::ref(importer), std::ref(mSubsets));
-	LoadAnimations(std::ref(importer), std::ref(mSkinnedData.mAnimations));
-	LoadMaterials(std::ref(importer), mMeshName, std::ref(mMaterials), std::ref(mRenderer));
+
+	return GameResultOk;
+}
+
+GameResult Mesh::Upload() {
+	TaskTimer timer;
+	timer.SetBeginTime();
+
 	mRenderer->AddGeometry(this);
 	
 	const auto& anims = mSkinnedData.mAnimations;
 	if (!anims.empty()) {
 		for (const auto& anim : anims) {
-			UINT idx = mRenderer->AddAnimations(anim.first, anim.second);
+			UINT idx;
+			CheckGameResult(mRenderer->AddAnimations(anim.first, anim.second, idx));
 	
 			mClipsIndex[anim.first] = idx;
 		}
-		mRenderer->UpdateAnimationsMap();
+		CheckGameResult(mRenderer->UpdateAnimationsMap());
 	}
 	
 	timer.SetEndTime();
 	Logln("Mesh Name: ", mMeshName);
-	Logln("  Loading Time: ", std::to_string(timer.GetElapsedTime()), " seconds");
+	Logln("  Source: ", bLoadedFromCooked ? "Import Cache" : "FBX");
+	Logln("  Decoding Time: ", std::to_string(mDecodeTime), " seconds");
+	Logln("  Uploading Time: ", std::to_string(timer.GetElapsedTime()), " seconds");
 	if (bIsSkeletal) OutputSkinnedDataInfo();
 
 	return GameResultOk;
 }
 
+std::uint64_t Mesh::GetUploadByteSize() const {
+	std::uint64_t vertexBytes = bIsSkeletal ?
+		mSkinnedVertices.size() * sizeof(Game::SkinnedVertex) : mVertices.size() * sizeof(Game::Vertex);
+
+	return vertexBytes + mIndices.size() * sizeof(std::uint32_t);
+}
+
 const std::string& Mesh::GetMeshName() const {
 	return mMeshName;
 }
@@ -262,6 +320,10 @@ const std::vector<Game::SkinnedVertex>& Mesh::GetSkinnedVertices() const {
 	return mSkinnedVertices;
 }
 
+const Game::QuantizedSkin& Mesh::GetQuantizedSkin() const {
+	return mQuantizedSkin;
+}
+
 const std::vector<std::uint32_t>& Mesh::GetIndices() const {
 	return mIndices;
 }
@@ -290,11 +352,392 @@ const std::vector<std::uint32_t> Mesh::GetSkeletonIndices() const {
 	return mSkeletonIndices;
 }
 
+void Mesh::ReleaseAnimations() {
+	for (const auto& clip : mClipsIndex)
+		mRenderer->RemoveAnimations(clip.second);
+
+	mClipsIndex.clear();
+}
+
 UINT Mesh::GetClipIndex(const std::string& inClipName) const {
 	auto iter = mClipsIndex.find(inClipName);
 	return iter != mClipsIndex.end() ? iter->second : std::numeric_limits<UINT>::infinity();
 }
 
+GameResult Mesh::LoadFromFbx(const std::string& inFileName) {
+	Game::FbxImporter importer;
+	if (!importer.LoadDataFromFile(inFileName)) {
+		std::wstring wstr;
+		wstr.assign(inFileName.begin(), inFileName.end());
+		ReturnGameResult(E_FAIL, L"Failed to load data from file: " + wstr);
+	}
+
+	if (bIsSkeletal) {
+		LoadSkinnedVertices(std::ref(importer), std::ref(mSkinnedVertices));
+		LoadSkeletons(std::ref(importer), std::ref(mSkinnedData.mSkeleton));
+	}
+	else {
+		LoadVertices(importer, std::ref(mVertices));
+	}
+
+	LoadIndices(std::ref(importer), std::ref(mIndices));
+	LoadDrawArgs(std::ref(importer), mMeshName, std::ref(mDrawArgs));
+	LoadSubsets(std::ref(importer), std::ref(mSubsets));
+	LoadAnimations(std::ref(importer), std::ref(mSkinnedData.mAnimations));
+	LoadMaterials(std::ref(importer), mMeshName, std::ref(mMaterials), std::ref(mRenderer));
+
+	return GameResultOk;
+}
+
+bool Mesh::LoadFromCooked(const std::string& inFileName, std::uint64_t inKey) {
+	MappedFile file;
+	if (!file.Open(inFileName))
+		return false;
+
+	Game::CookedMeshView view;
+	if (!view.Open(file))
+		return false;
+
+	// Guards against a key collision in the file name.
+	if (view.GetSourceKey() != inKey)
+		return false;
+
+	// A container cooked for the other vertex type or an older vertex layout is rejected,
+	//  then the mesh is imported again and the container is overwritten.
+	if (((view.GetFlags() & Game::CookedMesh::ESkinned) != 0) != bIsSkeletal)
+		return false;
+
+	// The sections are in bounds of the file(CookedMeshView::Open), but the values that index other sections
+	//  are checked here, so a stale or damaged container is imported again instead of read out of bounds.
+	auto bones = view.GetSection<Game::CookedBone>(Game::CookedMesh::EBones);
+	for (size_t i = 0; i < bones.mSize; ++i) {
+		std::int32_t parent = bones[i].mParentIndex;
+		if (parent < -1 || parent >= static_cast<std::int32_t>(bones.mSize) || parent == static_cast<std::int32_t>(i))
+			return false;
+	}
+
+	size_t numVertices = 0;
+	if (bIsSkeletal) {
+		auto vertices = view.GetSection<Game::SkinnedVertex>(Game::CookedMesh::EVertices);
+		if (vertices.Empty())
+			return false;
+
+		auto isValidBone = [&bones](int inIndex) {
+			return inIndex >= -1 && inIndex < static_cast<int>(bones.mSize);
+		};
+		for (const auto& vertex : vertices) {
+			if (!std::all_of(std::begin(vertex.mBoneIndices0), std::end(vertex.mBoneIndices0), isValidBone) ||
+					!std::all_of(std::begin(vertex.mBoneIndices1), std::end(vertex.mBoneIndices1), isValidBone))
+				return false;
+		}
+
+		numVertices = vertices.mSize;
+		mSkinnedVertices.assign(vertices.begin(), vertices.end());
+	}
+	else {
+		auto vertices = view.GetSection<Game::Vertex>(Game::CookedMesh::EVertices);
+		if (vertices.Empty())
+			return false;
+
+		numVertices = vertices.mSize;
+		mVertices.assign(vertices.begin(), vertices.end());
+	}
+
+	auto indices = view.GetSection<std::uint32_t>(Game::CookedMesh::EIndices);
+	if (std::any_of(indices.begin(), indices.end(), [numVertices](std::uint32_t inIndex) { return inIndex >= numVertices; }))
+		return false;
+
+	mIndices.assign(indices.begin(), indices.end());
+
+	for (const auto& subset : view.GetSection<Game::CookedSubset>(Game::CookedMesh::ESubsets)) {
+		if (static_cast<size_t>(subset.mStartIndex) + subset.mIndexCount > indices.mSize)
+			return false;
+
+		mSubsets.emplace_back(subset.mIndexCount, subset.mStartIndex);
+		mDrawArgs.push_back(view.GetString(subset.mName));
+	}
+
+	for (const auto& material : view.GetSection<Game::CookedMaterial>(Game::CookedMesh::EMaterials)) {
+		MaterialIn matIn;
+		matIn.MaterialName = view.GetString(material.mMaterialName);
+		matIn.DiffuseMapFileName = view.GetString(material.mDiffuseMapFileName);
+		matIn.NormalMapFileName = view.GetString(material.mNormalMapFileName);
+		matIn.SpecularMapFileName = view.GetString(material.mSpecularMapFileName);
+		matIn.AlphaMapFileName = view.GetString(material.mAlphaMapFileName);
+		std::memcpy(&matIn.MatTransform, material.mMatTransform, sizeof(XMFLOAT4X4));
+		std::memcpy(&matIn.DiffuseAlbedo, material.mDiffuseAlbedo, sizeof(XMFLOAT4));
+		std::memcpy(&matIn.FresnelR0, material.mFresnelR0, sizeof(XMFLOAT3));
+		matIn.Roughness = material.mRoughness;
+
+		mMaterials[view.GetString(material.mGeometryName)] = matIn;
+	}
+
+	for (const auto& bone : bones) {
+		XMFLOAT4X4 local;
+		XMFLOAT4X4 global;
+		XMFLOAT4X4 globalInv;
+		std::memcpy(&local, bone.mLocalBindPose, sizeof(XMFLOAT4X4));
+		std::memcpy(&global, bone.mGlobalBindPose, sizeof(XMFLOAT4X4));
+		std::memcpy(&globalInv, bone.mGlobalInvBindPose, sizeof(XMFLOAT4X4));
+
+		mSkinnedData.mSkeleton.mBones.emplace_back(view.GetString(bone.mName), bone.mParentIndex, local, global, globalInv);
+	}
+
+	auto curves = view.GetSection<Game::CookedCurve>(Game::CookedMesh::ECurves);
+	auto keys = view.GetSection<XMFLOAT4X4>(Game::CookedMesh::EKeys);
+	auto channels = view.GetSection<Game::CookedChannel>(Game::CookedMesh::EChannels);
+	auto keyFrames = view.GetSection<std::uint16_t>(Game::CookedMesh::EKeyFrames);
+	auto keyData = view.GetSection<std::uint16_t>(Game::CookedMesh::EKeyData);
+	for (const auto& clip : view.GetSection<Game::CookedClip>(Game::CookedMesh::EClips)) {
+		if (static_cast<size_t>(clip.mFirstCurve) + clip.mNumCurves > curves.mSize)
+			return false;
+
+		auto& anim = mSkinnedData.mAnimations[view.GetString(clip.mName)];
+		anim.mNumFrames = clip.mNumFrames;
+		anim.mDuration = clip.mDuration;
+		anim.mFrameDuration = clip.mFrameDuration;
+
+		if (clip.mNumChannels > 0) {
+			if (static_cast<size_t>(clip.mFirstChannel) + clip.mNumChannels > channels.mSize ||
+					static_cast<size_t>(clip.mFirstKey) + clip.mNumKeys > keyFrames.mSize ||
+					(static_cast<size_t>(clip.mFirstKey) + clip.mNumKeys) * 3 > keyData.mSize)
+				return false;
+
+			std::vector<Game::CompressedAnimation::Channel> clipChannels(clip.mNumChannels);
+			for (std::uint32_t i = 0; i < clip.mNumChannels; ++i) {
+				const auto& cooked = channels[clip.mFirstChannel + i];
+				if (cooked.mMode > Game::CompressedAnimation::EAnimated)
+					return false;
+
+				auto& channel = clipChannels[i];
+				channel.mMode = static_cast<Game::CompressedAnimation::EChannelMode>(cooked.mMode);
+				channel.mFirstKey = cooked.mFirstKey;
+				channel.mNumKeys = cooked.mNumKeys;
+				std::memcpy(&channel.mMin, cooked.mMin, sizeof(XMFLOAT4));
+				std::memcpy(&channel.mStep, cooked.mStep, sizeof(XMFLOAT4));
+			}
+
+			// Assign checks the channels against the keys of the clip.
+			if (!anim.mCompressed.Assign(clip.mNumChannels / 3, clip.mNumFrames, std::move(clipChannels),
+					std::vector<std::uint16_t>(keyFrames.begin() + clip.mFirstKey, keyFrames.begin() + clip.mFirstKey + clip.mNumKeys),
+					std::vector<std::uint16_t>(keyData.begin() + static_cast<size_t>(clip.mFirstKey) * 3,
+						keyData.begin() + (static_cast<size_t>(clip.mFirstKey) + clip.mNumKeys) * 3),
+					clip.mMaxError))
+				return false;
+			continue;
+		}
+
+		anim.mCurves.resize(clip.mNumCurves);
+
+		for (std::uint32_t i = 0; i < clip.mNumCurves; ++i) {
+			const auto& curve = curves[clip.mFirstCurve + i];
+			// Every frame of the clip is read from every curve.
+			if (static_cast<size_t>(curve.mFirstKey) + curve.mNumKeys > keys.mSize || curve.mNumKeys < clip.mNumFrames)
+				return false;
+
+			anim.mCurves[i].assign(keys.begin() + curve.mFirstKey, keys.begin() + curve.mFirstKey + curve.mNumKeys);
+		}
+	}
+
+	return true;
+}
+
+bool Mesh::Cook(const std::string& inFileName, std::uint64_t inKey) {
+	Game::CookedMeshWriter writer;
+	writer.SetFlags(bIsSkeletal ? Game::CookedMesh::ESkinned : 0);
+	writer.SetSourceKey(inKey);
+
+	if (bIsSkeletal)
+		writer.AddSection(Game::CookedMesh::EVertices, mSkinnedVertices);
+	else
+		writer.AddSection(Game::CookedMesh::EVertices, mVertices);
+
+	writer.AddSection(Game::CookedMesh::EIndices, mIndices);
+
+	std::vector<Game::CookedSubset> subsets(mSubsets.size());
+	for (size_t i = 0, end = mSubsets.size(); i < end; ++i) {
+		subsets[i].mIndexCount = mSubsets[i].first;
+		subsets[i].mStartIndex = mSubsets[i].second;
+		subsets[i].mName = writer.AddString(i < mDrawArgs.size() ? mDrawArgs[i] : std::string());
+	}
+	writer.AddSection(Game::CookedMesh::ESubsets, subsets);
+
+	std::vector<Game::CookedMaterial> materials;
+	materials.reserve(mMaterials.size());
+	for (const auto& material : mMaterials) {
+		const auto& matIn = material.second;
+
+		Game::CookedMaterial cooked = {};
+		cooked.mGeometryName = writer.AddString(material.first);
+		cooked.mMaterialName = writer.AddString(matIn.MaterialName);
+		cooked.mDiffuseMapFileName = writer.AddString(matIn.DiffuseMapFileName);
+		cooked.mNormalMapFileName = writer.AddString(matIn.NormalMapFileName);
+		cooked.mSpecularMapFileName = writer.AddString(matIn.SpecularMapFileName);
+		cooked.mAlphaMapFileName = writer.AddString(matIn.AlphaMapFileName);
+		std::memcpy(cooked.mMatTransform, &matIn.MatTransform, sizeof(XMFLOAT4X4));
+		std::memcpy(cooked.mDiffuseAlbedo, &matIn.DiffuseAlbedo, sizeof(XMFLOAT4));
+		std::memcpy(cooked.mFresnelR0, &matIn.FresnelR0, sizeof(XMFLOAT3));
+		cooked.mRoughness = matIn.Roughness;
+
+		materials.push_back(cooked);
+	}
+	writer.AddSection(Game::CookedMesh::EMaterials, materials);
+
+	if (bIsSkeletal) {
+		const auto& bones = mSkinnedData.mSkeleton.mBones;
+
+		std::vector<Game::CookedBone> cookedBones(bones.size());
+		for (size_t i = 0, end = bones.size(); i < end; ++i) {
+			auto& cooked = cookedBones[i];
+			cooked = {};
+			cooked.mName = writer.AddString(bones[i].Name);
+			cooked.mParentIndex = bones[i].ParentIndex;
+			std::memcpy(cooked.mLocalBindPose, &bones[i].LocalBindPose, sizeof(XMFLOAT4X4));
+			std::memcpy(cooked.mGlobalBindPose, &bones[i].GlobalBindPose, sizeof(XMFLOAT4X4));
+			std::memcpy(cooked.mGlobalInvBindPose, &bones[i].GlobalInvBindPose, sizeof(XMFLOAT4X4));
+		}
+		writer.AddSection(Game::CookedMesh::EBones, cookedBones);
+	}
+
+	std::vector<Game::CookedClip> clips;
+	std::vector<Game::CookedCurve> curves;
+	std::vector<XMFLOAT4X4> keys;
+	std::vector<Game::CookedChannel> channels;
+	std::vector<std::uint16_t> keyFrames;
+	std::vector<std::uint16_t> keyData;
+	for (const auto& anim : mSkinnedData.mAnimations) {
+		const auto& compressed = anim.second.mCompressed;
+
+		Game::CookedClip clip = {};
+		clip.mName = writer.AddString(anim.first);
+		clip.mNumFrames = static_cast<std::uint32_t>(anim.second.mNumFrames);
+		clip.mDuration = anim.second.mDuration;
+		clip.mFrameDuration = anim.second.mFrameDuration;
+		clip.mFirstCurve = static_cast<std::uint32_t>(curves.size());
+		clip.mNumCurves = static_cast<std::uint32_t>(anim.second.mCurves.size());
+		clip.mFirstChannel = static_cast<std::uint32_t>(channels.size());
+		clip.mNumChannels = static_cast<std::uint32_t>(compressed.GetChannels().size());
+		clip.mFirstKey = static_cast<std::uint32_t>(keyFrames.size());
+		clip.mNumKeys = static_cast<std::uint32_t>(compressed.GetKeyFrames().size());
+		clip.mMaxError = compressed.GetStatistics().mMaxError;
+
+		for (const auto& curve : anim.second.mCurves) {
+			curves.push_back({ static_cast<std::uint32_t>(keys.size()), static_cast<std::uint32_t>(curve.size()) });
+			keys.insert(keys.end(), curve.begin(), curve.end());
+		}
+
+		for (const auto& channel : compressed.GetChannels()) {
+			Game::CookedChannel cooked = {};
+			cooked.mMode = channel.mMode;
+			cooked.mFirstKey = channel.mFirstKey;
+			cooked.mNumKeys = channel.mNumKeys;
+			std::memcpy(cooked.mMin, &channel.mMin, sizeof(XMFLOAT4));
+			std::memcpy(cooked.mStep, &channel.mStep, sizeof(XMFLOAT4));
+			channels.push_back(cooked);
+		}
+		keyFrames.insert(keyFrames.end(), compressed.GetKeyFrames().begin(), compressed.GetKeyFrames().end());
+		keyData.insert(keyData.end(), compressed.GetKeyData().begin(), compressed.GetKeyData().end());
+
+		clips.push_back(clip);
+	}
+	writer.AddSection(Game::CookedMesh::EClips, clips);
+	writer.AddSection(Game::CookedMesh::ECurves, curves);
+	writer.AddSection(Game::CookedMesh::EKeys, keys);
+	writer.AddSection(Game::CookedMesh::EChannels, channels);
+	writer.AddSection(Game::CookedMesh::EKeyFrames, keyFrames);
+	writer.AddSection(Game::CookedMesh::EKeyData, keyData);
+
+	return writer.Write(inFileName);
+}
+
+void Mesh::OptimizeGeometry() {
+	const size_t numVertices = bIsSkeletal ? mSkinnedVertices.size() : mVertices.size();
+	const size_t vertexByteSize = bIsSkeletal ? sizeof(Game::SkinnedVertex) : sizeof(Game::Vertex);
+	if (numVertices == 0 || mIndices.empty())
+		return;
+
+	TaskTimer timer;
+	timer.SetBeginTime();
+
+	auto cacheStatsBefore = Game::MeshOptimizer::AnalyzeVertexCache(mIndices, numVertices);
+	auto fetchStatsBefore = Game::MeshOptimizer::AnalyzeVertexFetch(mIndices, numVertices, vertexByteSize);
+
+	std::vector<XMFLOAT3> positions(numVertices);
+	for (size_t i = 0; i < numVertices; ++i)
+		positions[i] = bIsSkeletal ? mSkinnedVertices[i].mPos : mVertices[i].mPos;
+
+	// Triangles can't cross subset boundaries, so each subset is reordered on its own.
+	for (const auto& subset : mSubsets) {
+		auto begin = mIndices.begin() + subset.second;
+		auto end = begin + subset.first;
+
+		std::vector<std::uint32_t> indices(begin, end);
+		Game::MeshOptimizer::OptimizeVertexCache(indices, numVertices);
+		Game::MeshOptimizer::OptimizeOverdraw(indices, positions);
+
+		std::copy(indices.begin(), indices.end(), begin);
+	}
+
+	// The vertex buffer is shared by all subsets(base vertex location is always zero),
+	//  so the vertices are remapped once over the whole index buffer.
+	std::vector<std::uint32_t> remap;
+	size_t numRemapped = Game::MeshOptimizer::BuildVertexFetchRemap(remap, mIndices, numVertices);
+	Game::MeshOptimizer::RemapIndices(mIndices, remap);
+	if (bIsSkeletal)
+		Game::MeshOptimizer::RemapVertices(mSkinnedVertices, remap, numRemapped);
+	else
+		Game::MeshOptimizer::RemapVertices(mVertices, remap, numRemapped);
+
+	auto cacheStatsAfter = Game::MeshOptimizer::AnalyzeVertexCache(mIndices, numRemapped);
+	auto fetchStatsAfter = Game::MeshOptimizer::AnalyzeVertexFetch(mIndices, numRemapped, vertexByteSize);
+
+	timer.SetEndTime();
+
+	Logln("  Mesh Optimization(", mMeshName, ")");
+	WLogln(L"    Optimization Time: ", std::to_wstring(timer.GetElapsedTime()), L" seconds");
+	WLogln(L"    ACMR: ", std::to_wstring(cacheStatsBefore.mAcmr), L" -> ", std::to_wstring(cacheStatsAfter.mAcmr));
+	WLogln(L"    ATVR: ", std::to_wstring(cacheStatsBefore.mAtvr), L" -> ", std::to_wstring(cacheStatsAfter.mAtvr));
+	WLogln(L"    Overfetch: ", std::to_wstring(fetchStatsBefore.mOverfetch), L" -> ", std::to_wstring(fetchStatsAfter.mOverfetch));
+}
+
+void Mesh::PruneSkinWeights() {
+	auto stats = Game::SkinWeights::Prune(mSkinnedVertices);
+
+	Logln("  Skin Weight Pruning(", mMeshName, ")");
+	WLogln(L"    Pruned Vertices: ", std::to_wstring(stats.mNumPrunedVertices), L" / ", std::to_wstring(stats.mNumVertices));
+	WLogln(L"    Dropped Weight: ", std::to_wstring(stats.mAverageDroppedWeight), L" (average), ",
+		std::to_wstring(stats.mMaxDroppedWeight), L" (max)");
+}
+
+void Mesh::QuantizeSkinWeights() {
+	auto numBones = static_cast<std::uint32_t>(mSkinnedData.mSkeleton.mBones.size());
+	auto stats = Game::SkinWeights::Quantize(mSkinnedVertices, numBones, 8, mQuantizedSkin);
+
+	const std::uint32_t sourceVertexStride = static_cast<std::uint32_t>(sizeof(Game::SkinnedVertex));
+	const std::uint32_t compactVertexStride = static_cast<std::uint32_t>(sizeof(Game::Vertex)) + stats.mQuantizedStride;
+
+	Logln("  Skin Weight Quantization(", mMeshName, ")");
+	WLogln(L"    Format: ", std::to_wstring(mQuantizedSkin.mWeightBits), L"-bit weights, ",
+		std::to_wstring(mQuantizedSkin.mIndexBits), L"-bit indices, max error ", std::to_wstring(stats.mMaxWeightError));
+	WLogln(L"    Skinning Data: ", std::to_wstring(stats.mSourceBytes), L" -> ", std::to_wstring(stats.mQuantizedBytes), L" bytes");
+	WLogln(L"    Vertex Fetch: ", std::to_wstring(sourceVertexStride), L" -> ", std::to_wstring(compactVertexStride), L" bytes per vertex");
+}
+
+void Mesh::CompressAnimations() {
+	Game::AnimationCompressionSettings settings;
+
+	for (auto& anim : mSkinnedData.mAnimations) {
+		auto& clip = anim.second;
+		if (!clip.mCompressed.Compress(clip, settings)) {
+			Logln("  Failed to compress the clip(the raw curves are kept): ", anim.first);
+			WLogln(L"    Max Error: ", std::to_wstring(clip.mCompressed.GetStatistics().mMaxError));
+			continue;
+		}
+
+		std::vector<std::vector<XMFLOAT4X4>>().swap(clip.mCurves);
+	}
+}
+
 void Mesh::GenerateSkeletonData() {
 	const auto& bones = mSkinnedData.mSkeleton.mBones;
 	for (auto boneIter = bones.begin(), boneEnd = bones.end(); boneIter != boneEnd; ++boneIter) {
@@ -369,6 +812,19 @@ void Mesh::OutputSkinnedDataInfo() {
 		WLogln(L"        Num Frames: ", std::to_wstring(anim.mNumFrames));
 		WLogln(L"        Duration: ", std::to_wstring(anim.mDuration));
 		WLogln(L"        Frame Duration: ", std::to_wstring(anim.mFrameDuration));
-		WLogln(L"        Curves Size: ", std::to_wstring(anim.mCurves.size()));
+		WLogln(L"        Curves Size: ", std::to_wstring(anim.GetNumTracks()));
+
+		if (!anim.mCompressed.IsEmpty()) {
+			const auto& stats = anim.mCompressed.GetStatistics();
+			std::int64_t savedBytes = static_cast<std::int64_t>(stats.mRawBytes) - static_cast<std::int64_t>(stats.mCompressedBytes);
+
+			WLogln(L"        Compressed Size: ", std::to_wstring(stats.mRawBytes), L" -> ",
+				std::to_wstring(stats.mCompressedBytes), L" bytes(", std::to_wstring(savedBytes), L" saved)");
+			WLogln(L"        Channels(default/constant/animated): ", std::to_wstring(stats.mNumDefaultChannels), L"/",
+				std::to_wstring(stats.mNumConstantChannels), L"/", std::to_wstring(stats.mNumAnimatedChannels));
+			WLogln(L"        Animated Keys: ", std::to_wstring(stats.mNumSourceKeys), L" -> ", std::to_wstring(stats.mNumKeys));
+			WLogln(L"        Max Error: ", std::to_wstring(stats.mMaxError), L"(track ",
+				std::to_wstring(stats.mMaxErrorTrack), L", frame ", std::to_wstring(stats.mMaxErrorFrame), L")");
+		}
 	}
 }
\ No newline at end of file
@@ -16,36 +16,71 @@ MeshComponent::MeshComponent(Actor* inOwnerActor, int inUpdateOrder)
 }
 
 void MeshComponent::OnUpdateWorldTransform() {
-	if (mOwner->GetIsDirty()) {
-		XMVECTOR actorScale = GetOwner()->GetScale();
-		XMVECTOR actorQuat = GetOwner()->GetQuaternion();
-		XMVECTOR actorPos = GetOwner()->GetPosition();
+	if (mMesh == nullptr)
+		return;
 
-		XMVECTOR finalScale = XMVectorMultiply(actorScale, XMLoadFloat3(&mScale));
-		XMVECTOR finalQuat = XMQuaternionMultiply(actorQuat, XMLoadFloat4(&mQuaternion));
-		XMVECTOR finalPos = XMVectorAdd(actorPos, XMLoadFloat3(&mPosition));
-
-		XMVECTOR RotationOrigin = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
-		XMMATRIX finalTransform = XMMatrixAffineTransformation(finalScale, RotationOrigin, finalQuat, finalPos);
-
-		mRenderer->UpdateWorldTransform(mMeshName, finalTransform, mIsSkeletal);
+	if (mOwner->GetIsDirty() || bNeedToUpdateTransform) {
+		mRenderer->UpdateWorldTransform(mMeshName, GetFinalTransform(), mIsSkeletal);
 		mOwner->SetActorClean();
+		bNeedToUpdateTransform = false;
 	}
 }
 
-GameResult MeshComponent::LoadMesh(const std::string& inMeshName, const std::string& inFileName) {
-	CheckGameResult(GameWorld::GetWorld()->AddMesh(inFileName, mMesh, false, false));
-	
-	mMeshName = inMeshName;
-	mRenderer->AddRenderItem(mMeshName, mMesh);
+XMMATRIX MeshComponent::GetFinalTransform() const {
+	XMVECTOR actorScale = GetOwner()->GetScale();
+	XMVECTOR actorQuat = GetOwner()->GetQuaternion();
+	XMVECTOR actorPos = GetOwner()->GetPosition();
+
+	XMVECTOR finalScale = XMVectorMultiply(actorScale, XMLoadFloat3(&mScale));
+	XMVECTOR finalQuat = XMQuaternionMultiply(actorQuat, XMLoadFloat4(&mQuaternion));
+	XMVECTOR finalPos = XMVectorAdd(actorPos, XMLoadFloat3(&mPosition));
+
+	XMVECTOR RotationOrigin = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+	return XMMatrixAffineTransformation(finalScale, RotationOrigin, finalQuat, finalPos);
+}
+
+GameResult MeshComponent::LoadMesh(const std::string& inMeshName, const std::string& inFileName, int inPriority) {
+	RequestMesh(inMeshName, inFileName, inPriority);
 
 	return GameResultOk;
 }
 
 void MeshComponent::SetVisible(bool inStatus) {
+	bVisible = inStatus;
+
+	// The render item doesn't exist until the mesh is loaded, and the name may still match another one's;
+	//  OnMeshLoaded applies the stored state.
+	if (mMesh == nullptr)
+		return;
+
 	mRenderer->SetVisible(mMeshName, inStatus);
 }
 
 std::string MeshComponent::GetMeshName() const {
 	return mMeshName;
+}
+
+void MeshComponent::OnMeshLoaded(Mesh* inMesh) {
+	mMesh = inMesh;
+	mRenderer->AddRenderItem(mMeshName, mMesh);
+
+	if (!bVisible)
+		mRenderer->SetVisible(mMeshName, false);
+
+	// The actor may have been cleaned while the mesh was in flight.
+	bNeedToUpdateTransform = true;
+}
+
+void MeshComponent::RequestMesh(const std::string& inMeshName, const std::string& inFileName, int inPriority) {
+	mMeshName = inMeshName;
+
+	mLoadToken = std::make_shared<bool>(true);
+	std::weak_ptr<bool> token = mLoadToken;
+
+	GameWorld::GetWorld()->AddMeshAsync(inFileName, mIsSkeletal, false, inPriority, [this, token](Mesh* inMesh) -> void {
+		if (token.expired() || inMesh == nullptr)
+			return;
+
+		OnMeshLoaded(inMesh);
+	});
 }
\ No newline at end of file
@@ -0,0 +1,372 @@
+#include "DX12Game/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace DirectX;
+
+namespace {
+	// Tuning values from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+	const std::uint32_t MaxScoreCacheSize = 32;
+	const float CacheDecayPower = 1.5f;
+	const float LastTriangleScore = 0.75f;
+	const float ValenceBoostScale = 2.0f;
+	const float ValenceBoostPower = 0.5f;
+
+	float ComputeVertexScore(int inCachePosition, std::uint32_t inNumLiveTriangles) {
+		// No triangles left to draw with this vertex, so it can't contribute anymore.
+		if (inNumLiveTriangles == 0)
+			return -1.0f;
+
+		float score = 0.0f;
+		if (inCachePosition >= 0) {
+			// The vertices used by the last triangle get a fixed score
+			//  so the algorithm doesn't prefer triangles that re-use the same edge.
+			if (inCachePosition < 3) {
+				score = LastTriangleScore;
+			}
+			else {
+				const float scaler = 1.0f / static_cast<float>(MaxScoreCacheSize - 3);
+				score = 1.0f - static_cast<float>(inCachePosition - 3) * scaler;
+				score = std::pow(score, CacheDecayPower);
+			}
+		}
+
+		// Boosts vertices that have only a few triangles left
+		//  so lone triangles aren't left behind.
+		score += ValenceBoostScale * std::pow(static_cast<float>(inNumLiveTriangles), -ValenceBoostPower);
+
+		return score;
+	}
+
+	//* Simple FIFO post-transform cache using insertion timestamps.
+	//* A vertex is in the cache while fewer than inCacheSize vertices have been inserted after it.
+	class FifoVertexCache {
+	public:
+		FifoVertexCache(size_t inVertexCount, std::uint32_t inCacheSize)
+			: mTimestamps(inVertexCount, 0), mCacheSize(inCacheSize), mTime(inCacheSize + 1) {}
+
+	public:
+		//* Returns true if the vertex had to be transformed.
+		bool Access(std::uint32_t inIndex) {
+			if (mTime - mTimestamps[inIndex] > mCacheSize) {
+				mTimestamps[inIndex] = mTime++;
+				return true;
+			}
+			return false;
+		}
+
+	private:
+		std::vector<std::uint32_t> mTimestamps;
+		std::uint32_t mCacheSize;
+		std::uint32_t mTime;
+	};
+}
+
+void Game::MeshOptimizer::OptimizeVertexCache(std::vector<std::uint32_t>& ioIndices, size_t inVertexCount) {
+	const size_t numTriangles = ioIndices.size() / 3;
+	if (numTriangles == 0)
+		return;
+
+	// Builds vertex-triangle adjacency.
+	std::vector<std::uint32_t> liveTriangles(inVertexCount, 0);
+	for (auto index : ioIndices)
+		++liveTriangles[index];
+
+	std::vector<std::uint32_t> adjOffsets(inVertexCount + 1, 0);
+	for (size_t i = 0; i < inVertexCount; ++i)
+		adjOffsets[i + 1] = adjOffsets[i] + liveTriangles[i];
+
+	std::vector<std::uint32_t> adjTriangles(ioIndices.size());
+	{
+		std::vector<std::uint32_t> fillOffsets(adjOffsets.begin(), adjOffsets.end() - 1);
+		for (size_t tri = 0; tri < numTriangles; ++tri) {
+			for (size_t k = 0; k < 3; ++k)
+				adjTriangles[fillOffsets[ioIndices[tri * 3 + k]]++] = static_cast<std::uint32_t>(tri);
+		}
+	}
+
+	std::vector<float> vertexScores(inVertexCount);
+	for (size_t i = 0; i < inVertexCount; ++i)
+		vertexScores[i] = ComputeVertexScore(-1, liveTriangles[i]);
+
+	std::vector<float> triangleScores(numTriangles);
+	for (size_t tri = 0; tri < numTriangles; ++tri) {
+		triangleScores[tri] =
+			vertexScores[ioIndices[tri * 3]] +
+			vertexScores[ioIndices[tri * 3 + 1]] +
+			vertexScores[ioIndices[tri * 3 + 2]];
+	}
+
+	std::vector<bool> emitted(numTriangles, false);
+
+	std::uint32_t cache[MaxScoreCacheSize + 3];
+	size_t cacheCount = 0;
+
+	std::vector<std::uint32_t> newIndices;
+	newIndices.reserve(numTriangles * 3);
+
+	size_t inputCursor = 0;
+	std::uint32_t bestTriangle = InvalidIndex;
+
+	for (size_t emittedCount = 0; emittedCount < numTriangles; ++emittedCount) {
+		if (bestTriangle == InvalidIndex) {
+			// The cache didn't provide any candidate,
+			//  so falls back to the next triangle in input order.
+			while (emitted[inputCursor])
+				++inputCursor;
+
+			bestTriangle = static_cast<std::uint32_t>(inputCursor);
+		}
+
+		const std::uint32_t tri = bestTriangle;
+		const std::uint32_t verts[3] = { ioIndices[tri * 3], ioIndices[tri * 3 + 1], ioIndices[tri * 3 + 2] };
+
+		emitted[tri] = true;
+		newIndices.insert(newIndices.end(), verts, verts + 3);
+
+		// Removes the triangle from the live list of each vertex.
+		for (auto v : verts) {
+			auto begin = adjTriangles.begin() + adjOffsets[v];
+			auto end = begin + liveTriangles[v];
+			auto iter = std::find(begin, end, tri);
+			if (iter != end) {
+				std::iter_swap(iter, end - 1);
+				--liveTriangles[v];
+			}
+		}
+
+		// Moves the vertices of the emitted triangle to the front of the cache.
+		std::uint32_t newCache[MaxScoreCacheSize + 3];
+		size_t newCount = 0;
+		for (auto v : verts) {
+			if (std::find(newCache, newCache + newCount, v) == newCache + newCount)
+				newCache[newCount++] = v;
+		}
+		for (size_t i = 0; i < cacheCount; ++i) {
+			std::uint32_t v = cache[i];
+			if (v != verts[0] && v != verts[1] && v != verts[2])
+				newCache[newCount++] = v;
+		}
+
+		// Vertices pushed out of the cache lose their cache score.
+		for (size_t i = MaxScoreCacheSize; i < newCount; ++i) {
+			std::uint32_t v = newCache[i];
+			float score = ComputeVertexScore(-1, liveTriangles[v]);
+			float diff = score - vertexScores[v];
+			vertexScores[v] = score;
+
+			for (std::uint32_t j = adjOffsets[v], end = adjOffsets[v] + liveTriangles[v]; j < end; ++j)
+				triangleScores[adjTriangles[j]] += diff;
+		}
+
+		cacheCount = std::min<size_t>(newCount, MaxScoreCacheSize);
+		std::copy(newCache, newCache + cacheCount, cache);
+
+		for (size_t i = 0; i < cacheCount; ++i) {
+			std::uint32_t v = cache[i];
+			float score = ComputeVertexScore(static_cast<int>(i), liveTriangles[v]);
+			float diff = score - vertexScores[v];
+			vertexScores[v] = score;
+
+			for (std::uint32_t j = adjOffsets[v], end = adjOffsets[v] + liveTriangles[v]; j < end; ++j)
+				triangleScores[adjTriangles[j]] += diff;
+		}
+
+		// Picks the next triangle among the ones touching the cache.
+		bestTriangle = InvalidIndex;
+		float bestScore = -1.0f;
+		for (size_t i = 0; i < cacheCount; ++i) {
+			std::uint32_t v = cache[i];
+			for (std::uint32_t j = adjOffsets[v], end = adjOffsets[v] + liveTriangles[v]; j < end; ++j) {
+				std::uint32_t adjTri = adjTriangles[j];
+				if (triangleScores[adjTri] > bestScore) {
+					bestScore = triangleScores[adjTri];
+					bestTriangle = adjTri;
+				}
+			}
+		}
+	}
+
+	ioIndices.swap(newIndices);
+}
+
+void Game::MeshOptimizer::OptimizeOverdraw(std::vector<std::uint32_t>& ioIndices,
+		const std::vector<XMFLOAT3>& inPositions, std::uint32_t inCacheSize) {
+	const size_t numTriangles = ioIndices.size() / 3;
+	if (numTriangles < 2)
+		return;
+
+	// Splits the triangle list where a triangle misses the cache with all three vertices.
+	// A cluster mostly hits on its own vertices, but the hits on the vertices it shares with the cluster
+	//  drawn before it change with the order, so the number of transformed vertices can go up(or down) a little.
+	std::vector<std::uint32_t> clusters;
+	{
+		FifoVertexCache cache(inPositions.size(), inCacheSize);
+		for (size_t tri = 0; tri < numTriangles; ++tri) {
+			std::uint32_t misses = 0;
+			for (size_t k = 0; k < 3; ++k)
+				misses += cache.Access(ioIndices[tri * 3 + k]) ? 1 : 0;
+
+			if (misses == 3 || tri == 0)
+				clusters.push_back(static_cast<std::uint32_t>(tri));
+		}
+		clusters.push_back(static_cast<std::uint32_t>(numTriangles));
+	}
+
+	const size_t numClusters = clusters.size() - 1;
+	if (numClusters < 2)
+		return;
+
+	std::vector<XMFLOAT3> clusterCentroids(numClusters);
+	std::vector<XMFLOAT3> clusterNormals(numClusters);
+
+	XMVECTOR meshCentroid = XMVectorZero();
+	float meshArea = 0.0f;
+
+	for (size_t c = 0; c < numClusters; ++c) {
+		XMVECTOR centroid = XMVectorZero();
+		XMVECTOR normal = XMVectorZero();
+		float area = 0.0f;
+
+		for (std::uint32_t tri = clusters[c]; tri < clusters[c + 1]; ++tri) {
+			XMVECTOR p0 = XMLoadFloat3(&inPositions[ioIndices[tri * 3]]);
+			XMVECTOR p1 = XMLoadFloat3(&inPositions[ioIndices[tri * 3 + 1]]);
+			XMVECTOR p2 = XMLoadFloat3(&inPositions[ioIndices[tri * 3 + 2]]);
+
+			// Length of the cross product is twice the area of the triangle,
+			//  so the normals are area-weighted as they are summed up.
+			XMVECTOR n = XMVector3Cross(p1 - p0, p2 - p0);
+			float triArea = XMVectorGetX(XMVector3Length(n)) * 0.5f;
+
+			centroid += (p0 + p1 + p2) * (triArea / 3.0f);
+			normal += n;
+			area += triArea;
+		}
+
+		meshCentroid += centroid;
+		meshArea += area;
+
+		XMStoreFloat3(&clusterCentroids[c], area > 0.0f ? centroid / area : centroid);
+		XMStoreFloat3(&clusterNormals[c], XMVector3Normalize(normal));
+	}
+
+	if (meshArea > 0.0f)
+		meshCentroid /= meshArea;
+
+	// Clusters facing away from the center of the mesh are likely to occlude the others,
+	//  so they are drawn first.
+	std::vector<float> sortKeys(numClusters);
+	for (size_t c = 0; c < numClusters; ++c) {
+		XMVECTOR toCluster = XMLoadFloat3(&clusterCentroids[c]) - meshCentroid;
+		sortKeys[c] = XMVectorGetX(XMVector3Dot(toCluster, XMLoadFloat3(&clusterNormals[c])));
+	}
+
+	std::vector<std::uint32_t> order(numClusters);
+	for (size_t c = 0; c < numClusters; ++c)
+		order[c] = static_cast<std::uint32_t>(c);
+
+	std::stable_sort(order.begin(), order.end(), [&sortKeys](std::uint32_t lhs, std::uint32_t rhs) -> bool {
+		return sortKeys[lhs] > sortKeys[rhs];
+	});
+
+	std::vector<std::uint32_t> newIndices;
+	newIndices.reserve(ioIndices.size());
+
+	for (auto c : order) {
+		newIndices.insert(newIndices.end(),
+			ioIndices.begin() + clusters[c] * 3, ioIndices.begin() + clusters[c + 1] * 3);
+	}
+
+	ioIndices.swap(newIndices);
+}
+
+size_t Game::MeshOptimizer::BuildVertexFetchRemap(std::vector<std::uint32_t>& outRemap,
+		const std::vector<std::uint32_t>& inIndices, size_t inVertexCount) {
+	outRemap.assign(inVertexCount, InvalidIndex);
+
+	std::uint32_t nextVertex = 0;
+	for (auto index : inIndices) {
+		if (outRemap[index] == InvalidIndex)
+			outRemap[index] = nextVertex++;
+	}
+
+	return nextVertex;
+}
+
+void Game::MeshOptimizer::RemapIndices(std::vector<std::uint32_t>& ioIndices, const std::vector<std::uint32_t>& inRemap) {
+	for (auto& index : ioIndices)
+		index = inRemap[index];
+}
+
+Game::VertexCacheStatistics Game::MeshOptimizer::AnalyzeVertexCache(const std::vector<std::uint32_t>& inIndices,
+		size_t inVertexCount, std::uint32_t inCacheSize) {
+	VertexCacheStatistics stats;
+
+	const size_t numTriangles = inIndices.size() / 3;
+	if (numTriangles == 0)
+		return stats;
+
+	FifoVertexCache cache(inVertexCount, inCacheSize);
+	std::vector<bool> referenced(inVertexCount, false);
+	size_t numReferenced = 0;
+
+	for (auto index : inIndices) {
+		if (cache.Access(index))
+			++stats.mVerticesTransformed;
+
+		if (!referenced[index]) {
+			referenced[index] = true;
+			++numReferenced;
+		}
+	}
+
+	stats.mAcmr = static_cast<float>(stats.mVerticesTransformed) / static_cast<float>(numTriangles);
+	stats.mAtvr = static_cast<float>(stats.mVerticesTransformed) / static_cast<float>(numReferenced);
+
+	return stats;
+}
+
+Game::VertexFetchStatistics Game::MeshOptimizer::AnalyzeVertexFetch(const std::vector<std::uint32_t>& inIndices,
+		size_t inVertexCount, size_t inVertexByteSize, std::uint32_t inCacheLineSize, std::uint32_t inCacheLineCount) {
+	VertexFetchStatistics stats;
+
+	if (inIndices.empty() || inVertexByteSize == 0)
+		return stats;
+
+	// Vertices are only fetched when they miss the post-transform cache.
+	FifoVertexCache vertexCache(inVertexCount, DefaultCacheSize);
+	std::vector<bool> referenced(inVertexCount, false);
+	size_t numReferenced = 0;
+
+	std::vector<std::uint64_t> lines(inCacheLineCount, std::numeric_limits<std::uint64_t>::max());
+	size_t nextLine = 0;
+
+	for (auto index : inIndices) {
+		if (!referenced[index]) {
+			referenced[index] = true;
+			++numReferenced;
+		}
+
+		if (!vertexCache.Access(index))
+			continue;
+
+		const std::uint64_t beginLine = (static_cast<std::uint64_t>(index) * inVertexByteSize) / inCacheLineSize;
+		const std::uint64_t endLine = (static_cast<std::uint64_t>(index + 1) * inVertexByteSize - 1) / inCacheLineSize;
+
+		for (std::uint64_t line = beginLine; line <= endLine; ++line) {
+			if (std::find(lines.begin(), lines.end(), line) != lines.end())
+				continue;
+
+			lines[nextLine] = line;
+			nextLine = (nextLine + 1) % inCacheLineCount;
+
+			stats.mBytesFetched += inCacheLineSize;
+		}
+	}
+
+	stats.mOverfetch = static_cast<float>(stats.mBytesFetched) / static_cast<float>(numReferenced * inVertexByteSize);
+
+	return stats;
+}
\ No newline at end of file
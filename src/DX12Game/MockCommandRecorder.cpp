@@ -0,0 +1,48 @@
+#include "DX12Game/MockCommandRecorder.h"
+
+using namespace Game;
+
+void MockCommandRecorder::Reset() {
+	mStateCache.Reset();
+	mStateCache.ResetStatistics();
+
+	mNumNaiveCommands = 0;
+	mNumIndices = 0;
+}
+
+void MockCommandRecorder::SetPipelineState(const void* inPipeline) {
+	mStateCache.ChangePipeline(inPipeline);
+	++mNumNaiveCommands;
+}
+
+void MockCommandRecorder::DrawIndexedInstanced(const void* inGeometry, std::uint32_t inTopology, std::uint64_t inObjectCB,
+		std::uint32_t inIndexCount, std::uint32_t inInstanceCount) {
+	mStateCache.ChangeGeometry(inGeometry);
+	mStateCache.ChangeTopology(inTopology);
+	mStateCache.ChangeObjectCB(inObjectCB);
+	mStateCache.CountDraw();
+
+	// Vertex buffer, index buffer, topology, object cbuffer and the draw itself.
+	mNumNaiveCommands += 5;
+	mNumIndices += static_cast<std::uint64_t>(inIndexCount) * inInstanceCount;
+}
+
+const DrawStateStatistics& MockCommandRecorder::GetStatistics() const {
+	return mStateCache.GetStatistics();
+}
+
+std::uint32_t MockCommandRecorder::GetNumCommands() const {
+	const auto& stats = mStateCache.GetStatistics();
+
+	// A geometry change binds both the vertex and the index buffer.
+	return stats.mNumPipelineChanges + stats.mNumGeometryChanges * 2 +
+		stats.mNumTopologyChanges + stats.mNumObjectCBChanges + stats.mNumDraws;
+}
+
+std::uint32_t MockCommandRecorder::GetNumNaiveCommands() const {
+	return mNumNaiveCommands;
+}
+
+std::uint64_t MockCommandRecorder::GetNumIndices() const {
+	return mNumIndices;
+}
\ No newline at end of file
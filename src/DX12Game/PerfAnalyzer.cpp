@@ -112,6 +112,53 @@ void PerfAnalyzer::WholeLoopEndTime(UINT tid) {
 					);
 				}
 			}
+
+			mRenderer->AddOutputText(
+				"ANIM_GRAPHS",
+				L"anim graphs: " + std::to_wstring(mAnimationGraphStatistics.mNumGraphs) +
+				L", batch(ms): " + std::to_wstring(mAnimationGraphStatistics.mBatchTime) +
+				L", max(ms): " + std::to_wstring(mAnimationGraphStatistics.mMaxGraphTime) +
+				L", avg(ms): " + std::to_wstring(mAnimationGraphStatistics.mAverageGraphTime),
+				10.0f,
+				static_cast<float>(40 + 30.0f * (mNumThreads + mNumThreads + mNumThreads)),
+				16.0f
+			);
+
+			mRenderer->AddOutputText(
+				"POSE_CACHE",
+				L"pose cache: " + std::to_wstring(mPoseCacheStatistics.mNumRequests) +
+				L" requests, hit rate: " + std::to_wstring(mPoseCacheStatistics.mHitRate) +
+				L", sampled: " + std::to_wstring(mPoseCacheStatistics.mNumSampled) +
+				L", poses: " + std::to_wstring(mPoseCacheStatistics.mNumEntries),
+				10.0f,
+				static_cast<float>(40 + 30.0f * (mNumThreads + mNumThreads + mNumThreads + 1)),
+				16.0f
+			);
+
+			mRenderer->AddOutputText(
+				"ANIM_LOD",
+				L"anim lod: " + std::to_wstring(mAnimationLodStatistics.mNumUpdated) +
+				L"/" + std::to_wstring(mAnimationLodStatistics.mNumSkeletons) +
+				L" skeletons updated, levels: " + std::to_wstring(mAnimationLodStatistics.mNumPerLevel[0]) +
+				L"/" + std::to_wstring(mAnimationLodStatistics.mNumPerLevel[1]) +
+				L"/" + std::to_wstring(mAnimationLodStatistics.mNumPerLevel[2]) +
+				L"/" + std::to_wstring(mAnimationLodStatistics.mNumPerLevel[3]),
+				10.0f,
+				static_cast<float>(40 + 30.0f * (mNumThreads + mNumThreads + mNumThreads + 2)),
+				16.0f
+			);
 		}
 	}	
+}
+
+void PerfAnalyzer::SetAnimationGraphStatistics(const Game::AnimationGraphStatistics& inStatistics) {
+	mAnimationGraphStatistics = inStatistics;
+}
+
+void PerfAnalyzer::SetPoseCacheStatistics(const Game::PoseCacheStatistics& inStatistics) {
+	mPoseCacheStatistics = inStatistics;
+}
+
+void PerfAnalyzer::SetAnimationLodStatistics(const Game::AnimationLodStatistics& inStatistics) {
+	mAnimationLodStatistics = inStatistics;
 }
\ No newline at end of file
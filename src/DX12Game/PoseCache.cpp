@@ -0,0 +1,143 @@
+#include "DX12Game/PoseCache.h"
+#include "DX12Game/PoseSampler.h"
+#include "DX12Game/SkinnedData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <functional>
+
+using namespace DirectX;
+using namespace Game;
+
+bool PoseCache::Key::operator==(const Key& inOther) const {
+	return mSkinnedData == inOther.mSkinnedData && mAnimation == inOther.mAnimation &&
+		mBoneMask == inOther.mBoneMask && mTimeIndex == inOther.mTimeIndex;
+}
+
+size_t PoseCache::KeyHash::operator()(const Key& inKey) const {
+	size_t hash = std::hash<const void*>()(inKey.mSkinnedData);
+	hash ^= std::hash<const void*>()(inKey.mAnimation) + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+	hash ^= std::hash<const void*>()(inKey.mBoneMask) + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+	hash ^= std::hash<std::int32_t>()(inKey.mTimeIndex) + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+	return hash;
+}
+
+void PoseCache::SetTimeStep(float inTimeStep) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	mTimeStep = std::max(inTimeStep, 0.0001f);
+}
+
+float PoseCache::QuantizeTime(float inTimePos) const {
+	return static_cast<float>(GetTimeIndex(inTimePos)) * mTimeStep;
+}
+
+const CachedPose* PoseCache::Request(const SkinnedData* inSkinnedData, const Animation* inAnimation, float inTimePos,
+		const std::vector<std::uint32_t>* inBoneMask) {
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	Key key = { inSkinnedData, inAnimation, inBoneMask, GetTimeIndex(inTimePos) };
+
+	++mNumRequests;
+
+	auto iter = mEntryIds.find(key);
+	if (iter != mEntryIds.end()) {
+		++mNumHits;
+
+		auto& entry = *mEntries[iter->second];
+		++entry.mRefCount;
+		return &entry.mPose;
+	}
+
+	std::uint32_t id;
+	if (!mFreeEntries.empty()) {
+		id = mFreeEntries.back();
+		mFreeEntries.pop_back();
+	}
+	else {
+		id = static_cast<std::uint32_t>(mEntries.size());
+		mEntries.push_back(std::make_unique<Entry>());
+	}
+
+	auto& entry = *mEntries[id];
+	entry.mKey = key;
+	entry.mRefCount = 1;
+	entry.mPrevRefCount = 0;
+	entry.bInUse = true;
+	entry.mPose.mTimePos = static_cast<float>(key.mTimeIndex) * mTimeStep;
+	entry.mPose.bReady = false;
+
+	mEntryIds.emplace(key, id);
+	mPendingEntries.push_back(&entry);
+
+	return &entry.mPose;
+}
+
+void PoseCache::Update() {
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	std::uint32_t numEvicted = 0;
+	for (std::uint32_t id = 0, end = static_cast<std::uint32_t>(mEntries.size()); id < end; ++id) {
+		auto& entry = *mEntries[id];
+		if (!entry.bInUse)
+			continue;
+
+		if (entry.mRefCount == 0 && entry.mPrevRefCount == 0) {
+			mEntryIds.erase(entry.mKey);
+			mFreeEntries.push_back(id);
+			entry.bInUse = false;
+			entry.mPose.bReady = false;
+			++numEvicted;
+		}
+
+		entry.mPrevRefCount = entry.mRefCount;
+		entry.mRefCount = 0;
+	}
+
+	// Sized on first use of a slot; a reused slot only grows.
+	std::for_each(std::execution::par, mPendingEntries.begin(), mPendingEntries.end(), [](Entry* inEntry) {
+		const auto& anim = *inEntry->mKey.mAnimation;
+		const auto& skinnedData = *inEntry->mKey.mSkinnedData;
+		auto& pose = inEntry->mPose;
+
+		size_t paletteSize = PoseSampler::GetPaletteSize(anim);
+		if (pose.mSkinningPalette.size() < paletteSize)
+			pose.mSkinningPalette.resize(paletteSize);
+		if (pose.mBoneTransforms.size() < skinnedData.mSkeleton.mBones.size())
+			pose.mBoneTransforms.resize(skinnedData.mSkeleton.mBones.size());
+
+		PoseJob job;
+		job.mSkinnedData = &skinnedData;
+		job.mAnimation = &anim;
+		job.mTimePos = pose.mTimePos;
+		if (inEntry->mKey.mBoneMask != nullptr) {
+			job.mBoneMask = inEntry->mKey.mBoneMask->data();
+			job.mBoneMaskSize = inEntry->mKey.mBoneMask->size();
+		}
+		job.mSkinningPalette = pose.mSkinningPalette.data();
+		job.mBoneTransforms = pose.mBoneTransforms.data();
+
+		PoseSampler::Sample(job);
+		pose.bReady = true;
+	});
+
+	mStatistics.mNumRequests = mNumRequests;
+	mStatistics.mNumHits = mNumHits;
+	mStatistics.mHitRate = mNumRequests > 0 ? static_cast<float>(mNumHits) / static_cast<float>(mNumRequests) : 0.0f;
+	mStatistics.mNumSampled = static_cast<std::uint32_t>(mPendingEntries.size());
+	mStatistics.mNumEntries = static_cast<std::uint32_t>(mEntryIds.size());
+	mStatistics.mNumEvicted = numEvicted;
+
+	mPendingEntries.clear();
+	mNumRequests = 0;
+	mNumHits = 0;
+}
+
+std::int32_t PoseCache::GetTimeIndex(float inTimePos) const {
+	return static_cast<std::int32_t>(std::floor(inTimePos / mTimeStep + 0.5f));
+}
+
+PoseCacheStatistics PoseCache::GetStatistics() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mStatistics;
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "DX12Game/PoseSampler.h"
+#include "DX12Game/SkinnedData.h"
+
+#include <algorithm>
+#include <execution>
+
+using namespace DirectX;
+using namespace Game;
+
+namespace {
+	// The second frame of the blend and the pose of the current term;
+	//  kept per thread so sampling doesn't allocate once they have grown.
+	thread_local std::vector<XMFLOAT4X4> tNextFrame;
+	thread_local std::vector<XMFLOAT4X4> tTermPose;
+}
+
+void PoseSampler::Sample(const PoseJob& inJob) {
+	size_t numTracks = 0;
+
+	if (inJob.mTerms != nullptr) {
+		for (size_t i = 0; i < inJob.mNumTerms; ++i) {
+			if (inJob.mTerms[i].mAnimation != nullptr)
+				numTracks = std::max(numTracks, inJob.mTerms[i].mAnimation->GetNumTracks());
+		}
+		if (numTracks == 0)
+			return;
+
+		SampleTerms(inJob, numTracks);
+	}
+	else {
+		const auto& anim = *inJob.mAnimation;
+		numTracks = anim.GetNumTracks();
+		if (numTracks == 0 || anim.mNumFrames == 0)
+			return;
+
+		SampleClip(anim, inJob.mTimePos, inJob.mSkinningPalette, inJob.mBoneMask, inJob.mBoneMaskSize);
+	}
+
+	if (inJob.mBoneMask != nullptr)
+		ApplyBoneMask(inJob, numTracks);
+
+	if (inJob.mBoneTransforms == nullptr || inJob.mSkinnedData == nullptr)
+		return;
+
+	// The skeleton pass places every bone at its bind pose and moves it with its skinning matrix.
+	const auto& bones = inJob.mSkinnedData->mSkeleton.mBones;
+	for (size_t i = 0, end = bones.size(); i < end; ++i) {
+		if (i < numTracks) {
+			XMStoreFloat4x4(&inJob.mBoneTransforms[i], XMMatrixMultiply(
+				XMLoadFloat4x4(&bones[i].GlobalBindPose), XMLoadFloat4x4(&inJob.mSkinningPalette[i])));
+		}
+		else {
+			inJob.mBoneTransforms[i] = bones[i].GlobalBindPose;
+		}
+	}
+}
+
+void PoseSampler::SampleBatch(const std::vector<PoseJob>& inJobs) {
+	std::for_each(std::execution::par, inJobs.begin(), inJobs.end(), [](const PoseJob& inJob) {
+		Sample(inJob);
+	});
+}
+
+size_t PoseSampler::GetPaletteSize(const Animation& inAnimation) {
+	return inAnimation.GetNumTracks();
+}
+
+void PoseSampler::SampleClip(const Animation& inAnimation, float inTimePos, XMFLOAT4X4* outPalette,
+		const std::uint32_t* inBoneMask, size_t inBoneMaskSize) {
+	size_t numTracks = inAnimation.GetNumTracks();
+	size_t lastFrame = inAnimation.mNumFrames - 1;
+	float timePos = std::min(std::max(inTimePos, 0.0f), static_cast<float>(lastFrame));
+
+	size_t frame = static_cast<size_t>(timePos);
+	size_t nextFrame = std::min(frame + 1, lastFrame);
+	XMVECTOR pct = XMVectorReplicate(timePos - static_cast<float>(frame));
+
+	inAnimation.GetFrame(frame, outPalette);
+
+	if (nextFrame == frame)
+		return;
+
+	if (tNextFrame.size() < numTracks)
+		tNextFrame.resize(numTracks);
+	inAnimation.GetFrame(nextFrame, tNextFrame.data());
+
+	for (size_t track = 0; track < numTracks; ++track) {
+		// A masked track is overwritten by ApplyBoneMask.
+		if (track < inBoneMaskSize && inBoneMask[track] != track && inBoneMask[track] < numTracks)
+			continue;
+
+		XMMATRIX m0 = XMLoadFloat4x4(&outPalette[track]);
+		XMMATRIX m1 = XMLoadFloat4x4(&tNextFrame[track]);
+
+		for (size_t row = 0; row < 4; ++row)
+			m0.r[row] = XMVectorLerpV(m0.r[row], m1.r[row], pct);
+
+		XMStoreFloat4x4(&outPalette[track], m0);
+	}
+}
+
+void PoseSampler::SampleTerms(const PoseJob& inJob, size_t inNumTracks) {
+	if (tTermPose.size() < inNumTracks)
+		tTermPose.resize(inNumTracks);
+
+	const XMFLOAT4X4 zero(
+		0.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 0.0f);
+	std::fill(inJob.mSkinningPalette, inJob.mSkinningPalette + inNumTracks, zero);
+
+	// Same sum as GetBoneTransform in the shaders; a track a term's clip doesn't have reads as zero there too.
+	for (size_t i = 0; i < inJob.mNumTerms; ++i) {
+		const auto& term = inJob.mTerms[i];
+		if (term.mAnimation == nullptr || term.mWeight == 0.0f || term.mAnimation->mNumFrames == 0)
+			continue;
+
+		size_t termTracks = term.mAnimation->GetNumTracks();
+		SampleClip(*term.mAnimation, term.mTimePos, tTermPose.data());
+
+		XMVECTOR weight = XMVectorReplicate(term.mWeight);
+		for (size_t track = 0; track < termTracks; ++track) {
+			XMMATRIX sum = XMLoadFloat4x4(&inJob.mSkinningPalette[track]);
+			XMMATRIX pose = XMLoadFloat4x4(&tTermPose[track]);
+
+			for (size_t row = 0; row < 4; ++row)
+				sum.r[row] = XMVectorMultiplyAdd(pose.r[row], weight, sum.r[row]);
+
+			XMStoreFloat4x4(&inJob.mSkinningPalette[track], sum);
+		}
+	}
+}
+
+void PoseSampler::ApplyBoneMask(const PoseJob& inJob, size_t inNumTracks) {
+	// The kept bones are never masked, so the order of the copies doesn't matter.
+	for (size_t track = 0, end = std::min(inNumTracks, inJob.mBoneMaskSize); track < end; ++track) {
+		std::uint32_t kept = inJob.mBoneMask[track];
+		if (kept != track && kept < inNumTracks)
+			inJob.mSkinningPalette[track] = inJob.mSkinningPalette[kept];
+	}
+}
\ No newline at end of file
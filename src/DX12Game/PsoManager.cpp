@@ -23,6 +23,18 @@ GameResult PsoManager::Initialize(ID3D12Device* inDevice) {
 		{ "BONEINDICES",	1, DXGI_FORMAT_R32G32B32A32_SINT,	0, 92,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
 	};
 
+	mQuantizedSkinnedInputLayout8 = {
+		{ "POSITION",		0, DXGI_FORMAT_R32G32B32_FLOAT,		0, 0,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "NORMAL",			0, DXGI_FORMAT_R32G32B32_FLOAT,		0, 12,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD",		0, DXGI_FORMAT_R32G32_FLOAT,		0, 24,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "TANGENT",		0, DXGI_FORMAT_R32G32B32_FLOAT,		0, 32,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "BONEWEIGHTS",	0, DXGI_FORMAT_R8G8B8A8_UNORM,		1, 0,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "BONEINDICES",	0, DXGI_FORMAT_R8G8B8A8_UINT,		1, 4,	D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+	};
+
+	mQuantizedSkinnedInputLayout16 = mQuantizedSkinnedInputLayout8;
+	mQuantizedSkinnedInputLayout16.back().Format = DXGI_FORMAT_R16G16B16A16_UINT;
+
 	return GameResultOk;
 }
 
@@ -48,6 +60,8 @@ GameResult PsoManager::BuildPso(
 	ZeroMemory(&psoDesc, sizeof(D3D12_GRAPHICS_PIPELINE_STATE_DESC));
 	if (inType == InputLayouts::EBasic) psoDesc.InputLayout = { mInputLayout.data(), (UINT)mInputLayout.size() };
 	else if (inType == InputLayouts::ESkinned) psoDesc.InputLayout = { mSkinnedInputLayout.data(), (UINT)mSkinnedInputLayout.size() };
+	else if (inType == InputLayouts::EQuantizedSkinned8) psoDesc.InputLayout = { mQuantizedSkinnedInputLayout8.data(), (UINT)mQuantizedSkinnedInputLayout8.size() };
+	else if (inType == InputLayouts::EQuantizedSkinned16) psoDesc.InputLayout = { mQuantizedSkinnedInputLayout16.data(), (UINT)mQuantizedSkinnedInputLayout16.size() };
 	else psoDesc.InputLayout = { nullptr, 0 };
 	psoDesc.pRootSignature = inRootSignature;
 	psoDesc.VS = {
@@ -97,6 +111,8 @@ GameResult PsoManager::BuildPso(
 	ZeroMemory(&psoDesc, sizeof(D3D12_GRAPHICS_PIPELINE_STATE_DESC));
 	if (inType == InputLayouts::EBasic) psoDesc.InputLayout = { mInputLayout.data(), (UINT)mInputLayout.size() };
 	else if (inType == InputLayouts::ESkinned) psoDesc.InputLayout = { mSkinnedInputLayout.data(), (UINT)mSkinnedInputLayout.size() };
+	else if (inType == InputLayouts::EQuantizedSkinned8) psoDesc.InputLayout = { mQuantizedSkinnedInputLayout8.data(), (UINT)mQuantizedSkinnedInputLayout8.size() };
+	else if (inType == InputLayouts::EQuantizedSkinned16) psoDesc.InputLayout = { mQuantizedSkinnedInputLayout16.data(), (UINT)mQuantizedSkinnedInputLayout16.size() };
 	else psoDesc.InputLayout = { nullptr, 0 };
 	psoDesc.pRootSignature = inRootSignature;
 	psoDesc.VS = {
@@ -3,6 +3,12 @@
 #include "DX12Game/Renderer.h"
 #include "DX12Game/Actor.h"
 #include "DX12Game/Mesh.h"
+#include "DX12Game/FrameResource.h"
+#include "DX12Game/PoseSampler.h"
+#include "DX12Game/AnimationGraph.h"
+#include "DX12Game/PoseCache.h"
+#include "DX12Game/AnimationLod.h"
+#include "DX12Game/GameCamera.h"
 
 using namespace DirectX;
 
@@ -15,6 +21,13 @@ SkeletalMeshComponent::SkeletalMeshComponent(Actor* inOwnerActor)
 	
 	mLastTotalTime = 0.0f;
 	mClipIsChanged = false;
+
+	mLodSlot = GameWorld::GetWorld()->GetAnimationLod()->Register();
+}
+
+SkeletalMeshComponent::~SkeletalMeshComponent() {
+	if (mAnimationGraph != nullptr)
+		GameWorld::GetWorld()->GetAnimationGraphBatch()->Remove(mAnimationGraph.get());
 }
 
 void SkeletalMeshComponent::OnUpdateWorldTransform() {
@@ -22,20 +35,57 @@ void SkeletalMeshComponent::OnUpdateWorldTransform() {
 }
 
 void SkeletalMeshComponent::Update(const GameTimer& gt) {
+	if (mMesh == nullptr)
+		return;
+
+	// The graph is evaluated(and samples the CPU pose) before the actors are updated.
+	if (mAnimationGraph != nullptr) {
+		const auto& terms = mAnimationGraph->GetGpuTerms();
+		mRenderer->UpdateInstanceAnimationBlend(mMeshName, terms.data(), static_cast<UINT>(terms.size()));
+		return;
+	}
+
+	bool clipChanged = mClipIsChanged;
 	if (mClipIsChanged) {
 		mLastTotalTime = gt.TotalTime();
 		mClipIsChanged = false;
 	}
-	
-	float timePos = mMesh->GetSkinnedData().GetTimePosition(mClipName, gt.TotalTime() - mLastTotalTime);
-	mRenderer->UpdateInstanceAnimationData(mMeshName, mMesh->GetClipIndex(mClipName), timePos, true);
-}
 
-GameResult SkeletalMeshComponent::LoadMesh(const std::string& inMeshName, const std::string& inFileName) {
-	CheckGameResult(GameWorld::GetWorld()->AddMesh(inFileName, mMesh, true, false));
+	auto animLod = GameWorld::GetWorld()->GetAnimationLod();
+	UpdateLodLevel(animLod);
 
-	mMeshName = inMeshName;
-	mRenderer->AddRenderItem(mMeshName, mMesh);
+	// The shaders play the clip on until the next update; the CPU pose holds the last one.
+	if (!animLod->ShouldUpdate(mLodSlot, mLodLevel, clipChanged)) {
+		if (bCpuPoseEnabled)
+			RequestCpuPose(mLastTimePos);
+		return;
+	}
+
+	const auto& skinnedData = mMesh->GetSkinnedData();
+	float timePos = skinnedData.GetTimePosition(mClipName, gt.TotalTime() - mLastTotalTime);
+	UINT clipIndex = mMesh->GetClipIndex(mClipName);
+
+	auto animIter = skinnedData.mAnimations.find(mClipName);
+	bool playback = animLod->GetLevel(mLodLevel).mUpdateInterval > 1 && animIter != skinnedData.mAnimations.cend() &&
+		animIter->second.mFrameDuration > 0.0f && animIter->second.mDuration > 0.0f;
+
+	if (playback) {
+		const auto& anim = animIter->second;
+		mRenderer->UpdateInstanceAnimationPlayback(mMeshName, clipIndex, timePos,
+			1.0f / anim.mFrameDuration, gt.TotalTime(), anim.mDuration / anim.mFrameDuration);
+	}
+	else {
+		mRenderer->UpdateInstanceAnimationData(mMeshName, clipIndex, timePos, true);
+	}
+
+	mLastTimePos = timePos;
+
+	if (bCpuPoseEnabled)
+		RequestCpuPose(timePos);
+}
+
+GameResult SkeletalMeshComponent::LoadMesh(const std::string& inMeshName, const std::string& inFileName, int inPriority) {
+	RequestMesh(inMeshName, inFileName, inPriority);
 
 	return GameResultOk;
 }
@@ -49,10 +99,205 @@ void SkeletalMeshComponent::SetClipName(const std::string& inClipName) {
 }
 
 void SkeletalMeshComponent::SetVisible(bool inState) {
+	bVisible = inState;
+
+	if (mMesh == nullptr)
+		return;
+
 	mRenderer->SetVisible(mMeshName, inState);
 	mRenderer->SetSkeletonVisible(mMeshName, inState);
 }
 
 void SkeletalMeshComponent::SetSkeleletonVisible(bool inState) {
+	bSkeletonVisible = inState;
+
+	if (mMesh == nullptr)
+		return;
+
 	mRenderer->SetSkeletonVisible(mMeshName, inState);
+}
+
+void SkeletalMeshComponent::SetCpuPoseEnabled(bool inState) {
+	bCpuPoseEnabled = inState;
+	UpdateGraphPoseOutput();
+
+	if (!inState) {
+		mCachedPose = nullptr;
+		mRequestedPose = nullptr;
+	}
+}
+
+int SkeletalMeshComponent::FindBoneIndex(const std::string& inBoneName) const {
+	if (mMesh == nullptr)
+		return -1;
+
+	const auto& bones = mMesh->GetSkinnedData().mSkeleton.mBones;
+	auto iter = std::find_if(bones.cbegin(), bones.cend(), [&inBoneName](const Game::Bone& inBone) {
+		return inBone.Name == inBoneName;
+	});
+
+	return iter != bones.cend() ? static_cast<int>(iter - bones.cbegin()) : -1;
+}
+
+bool SkeletalMeshComponent::GetBoneTransform(int inBoneIndex, XMFLOAT4X4& outTransform) const {
+	if (mMesh == nullptr || inBoneIndex < 0 || static_cast<size_t>(inBoneIndex) >= mMesh->GetSkinnedData().mSkeleton.mBones.size())
+		return false;
+
+	if (mCachedPose != nullptr && mCachedPose->bReady && static_cast<size_t>(inBoneIndex) < mCachedPose->mBoneTransforms.size())
+		outTransform = mCachedPose->mBoneTransforms[inBoneIndex];
+	else
+		outTransform = mBoneTransforms[inBoneIndex];
+
+	return true;
+}
+
+bool SkeletalMeshComponent::GetBoneWorldPosition(int inBoneIndex, XMFLOAT3& outPosition) const {
+	XMFLOAT4X4 boneTransform;
+	if (!GetBoneTransform(inBoneIndex, boneTransform))
+		return false;
+
+	XMVECTOR bonePos = XMVectorSet(boneTransform._41, boneTransform._42, boneTransform._43, 1.0f);
+	XMStoreFloat3(&outPosition, XMVector3TransformCoord(bonePos, GetFinalTransform()));
+
+	return true;
+}
+
+const std::vector<XMFLOAT4X4>& SkeletalMeshComponent::GetSkinningPalette() const {
+	if (mCachedPose != nullptr && mCachedPose->bReady)
+		return mCachedPose->mSkinningPalette;
+
+	return mSkinningPalette;
+}
+
+bool SkeletalMeshComponent::SkinVertices(std::vector<XMFLOAT3>& outPositions, std::vector<XMFLOAT3>* outNormals,
+		Game::SkinningResult& outResult, Game::SkinningJob::EMethod inMethod) const {
+	const auto& palette = GetSkinningPalette();
+	if (mMesh == nullptr || palette.empty())
+		return false;
+
+	const auto& vertices = mMesh->GetSkinnedVertices();
+	outPositions.resize(vertices.size());
+	if (outNormals != nullptr)
+		outNormals->resize(vertices.size());
+
+	Game::SkinningJob job;
+	job.mMethod = inMethod;
+	job.mVertices = vertices.data();
+	job.mNumVertices = vertices.size();
+	job.mSkinningPalette = palette.data();
+	job.mPaletteSize = palette.size();
+	job.mPositions = outPositions.data();
+	job.mNormals = outNormals != nullptr ? outNormals->data() : nullptr;
+
+	outResult = Game::CpuSkinning::Skin(job);
+
+	return true;
+}
+
+std::uint32_t SkeletalMeshComponent::GetLodLevel() const {
+	return mLodLevel;
+}
+
+Game::AnimationGraph* SkeletalMeshComponent::CreateAnimationGraph() {
+	if (mAnimationGraph == nullptr) {
+		mAnimationGraph = std::make_unique<Game::AnimationGraph>();
+		GameWorld::GetWorld()->GetAnimationGraphBatch()->Add(mAnimationGraph.get());
+	}
+
+	return mAnimationGraph.get();
+}
+
+Game::AnimationGraph* SkeletalMeshComponent::GetAnimationGraph() const {
+	return mAnimationGraph.get();
+}
+
+void SkeletalMeshComponent::RequestCpuPose(float inTimePos) {
+	const auto& skinnedData = mMesh->GetSkinnedData();
+	auto animIter = skinnedData.mAnimations.find(mClipName);
+	if (animIter == skinnedData.mAnimations.cend()) {
+		// A pose nothing requests any more is dropped two updates later.
+		mCachedPose = nullptr;
+		mRequestedPose = nullptr;
+		return;
+	}
+
+	// The cache sampled the last request while the game threads were parked.
+	mCachedPose = mRequestedPose;
+	mRequestedPose = GameWorld::GetWorld()->GetPoseCache()->Request(&skinnedData, &animIter->second, inTimePos, mBoneMask);
+}
+
+void SkeletalMeshComponent::UpdateGraphPoseOutput() {
+	if (mAnimationGraph == nullptr)
+		return;
+
+	if (bCpuPoseEnabled && mMesh != nullptr && !mSkinningPalette.empty())
+		mAnimationGraph->SetCpuPoseOutput(&mMesh->GetSkinnedData(), mSkinningPalette.data(), mBoneTransforms.data());
+	else
+		mAnimationGraph->SetCpuPoseOutput(nullptr, nullptr, nullptr);
+}
+
+void SkeletalMeshComponent::UpdateLodLevel(Game::AnimationLod* inAnimationLod) {
+	auto camera = mRenderer->GetMainCamera();
+	if (camera == nullptr || mLodRadius <= 0.0f)
+		return;
+
+	XMMATRIX world = GetFinalTransform();
+	float scale = std::max(XMVectorGetX(XMVector3Length(world.r[0])),
+		std::max(XMVectorGetX(XMVector3Length(world.r[1])), XMVectorGetX(XMVector3Length(world.r[2]))));
+
+	XMVECTOR center = XMVector3TransformCoord(XMLoadFloat3(&mLodCenter), world);
+	float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(center, camera->GetPosition())));
+
+	float screenSize = Game::AnimationLod::ComputeScreenSize(mLodRadius * scale, distance, camera->GetFovY());
+	std::uint32_t level = inAnimationLod->SelectLevel(screenSize, mLodLevel);
+	if (level == mLodLevel)
+		return;
+
+	mLodLevel = level;
+	mBoneMask = inAnimationLod->GetBoneMask(&mMesh->GetSkinnedData(), level);
+}
+
+void SkeletalMeshComponent::OnMeshLoaded(Mesh* inMesh) {
+	MeshComponent::OnMeshLoaded(inMesh);
+
+	// Sized once here, so sampling doesn't allocate per update.
+	const auto& skinnedData = inMesh->GetSkinnedData();
+	const auto& bones = skinnedData.mSkeleton.mBones;
+	mBoneTransforms.resize(std::max(bones.size(), mBoneTransforms.size()));
+	for (size_t i = 0, end = bones.size(); i < end; ++i)
+		mBoneTransforms[i] = bones[i].GlobalBindPose;
+
+	size_t paletteSize = 0;
+	for (const auto& anim : skinnedData.mAnimations)
+		paletteSize = std::max(paletteSize, Game::PoseSampler::GetPaletteSize(anim.second));
+	mSkinningPalette.assign(paletteSize, MathHelper::Identity4x4());
+
+	// The animation LOD measures the bind pose; the clips rarely leave its bounding sphere by much.
+	const auto& vertices = inMesh->GetSkinnedVertices();
+	if (!vertices.empty()) {
+		XMVECTOR boundsMin = XMLoadFloat3(&vertices.front().mPos);
+		XMVECTOR boundsMax = boundsMin;
+		for (const auto& vertex : vertices) {
+			XMVECTOR pos = XMLoadFloat3(&vertex.mPos);
+			boundsMin = XMVectorMin(boundsMin, pos);
+			boundsMax = XMVectorMax(boundsMax, pos);
+		}
+
+		XMStoreFloat3(&mLodCenter, XMVectorScale(XMVectorAdd(boundsMin, boundsMax), 0.5f));
+		mLodRadius = XMVectorGetX(XMVector3Length(XMVectorSubtract(boundsMax, boundsMin))) * 0.5f;
+	}
+	mBoneMask = GameWorld::GetWorld()->GetAnimationLod()->GetBoneMask(&skinnedData, mLodLevel);
+
+	if (mAnimationGraph != nullptr) {
+		mAnimationGraph->Bind(&skinnedData, [inMesh](const std::string& inClipName) {
+			return inMesh->GetClipIndex(inClipName);
+		});
+		UpdateGraphPoseOutput();
+	}
+
+	if (!bVisible || !bSkeletonVisible)
+		mRenderer->SetSkeletonVisible(mMeshName, false);
+
+	// Restarts the clip from the frame the character appears.
+	mClipIsChanged = true;
 }
\ No newline at end of file
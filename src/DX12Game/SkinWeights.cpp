@@ -0,0 +1,202 @@
+#include "DX12Game/SkinWeights.h"
+#include "DX12Game/FrameResource.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+using namespace Game;
+
+namespace {
+	struct Influence {
+		float mWeight;
+		int mIndex;
+	};
+
+	std::uint32_t GatherInfluences(const SkinnedVertex& inVertex, Influence outInfluences[SkinWeights::MaxInfluences]) {
+		const float weights[SkinWeights::MaxInfluences] = {
+			inVertex.mBoneWeights0.x, inVertex.mBoneWeights0.y, inVertex.mBoneWeights0.z, inVertex.mBoneWeights0.w,
+			inVertex.mBoneWeights1.x, inVertex.mBoneWeights1.y, inVertex.mBoneWeights1.z, inVertex.mBoneWeights1.w
+		};
+
+		std::uint32_t count = 0;
+		for (std::uint32_t i = 0; i < SkinWeights::MaxInfluences; ++i) {
+			// The skinning shaders stop at the first free slot, so nothing after it counts.
+			int index = i < 4 ? inVertex.mBoneIndices0[i] : inVertex.mBoneIndices1[i - 4];
+			if (index < 0)
+				break;
+			if (weights[i] <= 0.0f)
+				continue;
+
+			outInfluences[count++] = { weights[i], index };
+		}
+
+		return count;
+	}
+
+	void ScatterInfluences(const Influence* inInfluences, std::uint32_t inCount, SkinnedVertex& outVertex) {
+		float weights[SkinWeights::MaxInfluences] = {};
+		int indices[SkinWeights::MaxInfluences];
+		std::fill(std::begin(indices), std::end(indices), -1);
+
+		for (std::uint32_t i = 0; i < inCount; ++i) {
+			weights[i] = inInfluences[i].mWeight;
+			indices[i] = inInfluences[i].mIndex;
+		}
+
+		outVertex.mBoneWeights0 = { weights[0], weights[1], weights[2], weights[3] };
+		outVertex.mBoneWeights1 = { weights[4], weights[5], weights[6], weights[7] };
+		std::copy(indices, indices + 4, outVertex.mBoneIndices0);
+		std::copy(indices + 4, indices + 8, outVertex.mBoneIndices1);
+	}
+
+	void StoreUnsigned(std::uint8_t* outData, std::uint32_t inBits, std::uint32_t inValue) {
+		if (inBits == 8) {
+			*outData = static_cast<std::uint8_t>(inValue);
+		}
+		else {
+			std::uint16_t value = static_cast<std::uint16_t>(inValue);
+			std::memcpy(outData, &value, sizeof(value));
+		}
+	}
+
+	std::uint32_t LoadUnsigned(const std::uint8_t* inData, std::uint32_t inBits) {
+		if (inBits == 8)
+			return *inData;
+
+		std::uint16_t value;
+		std::memcpy(&value, inData, sizeof(value));
+		return value;
+	}
+}
+
+SkinWeightPruneStatistics SkinWeights::Prune(std::vector<SkinnedVertex>& ioVertices, std::uint32_t inMaxInfluences) {
+	SkinWeightPruneStatistics stats;
+	stats.mNumVertices = static_cast<std::uint32_t>(ioVertices.size());
+
+	inMaxInfluences = std::min(std::max(inMaxInfluences, 1u), MaxInfluences);
+
+	double droppedSum = 0.0;
+	Influence influences[MaxInfluences];
+
+	for (auto& vertex : ioVertices) {
+		std::uint32_t count = GatherInfluences(vertex, influences);
+
+		// Ties keep the lower bone index, so the result doesn't depend on the slot order.
+		std::sort(influences, influences + count, [](const Influence& lhs, const Influence& rhs) {
+			return lhs.mWeight != rhs.mWeight ? lhs.mWeight > rhs.mWeight : lhs.mIndex < rhs.mIndex;
+		});
+
+		if (count > inMaxInfluences) {
+			float total = 0.0f;
+			for (std::uint32_t i = 0; i < count; ++i)
+				total += influences[i].mWeight;
+
+			float kept = 0.0f;
+			for (std::uint32_t i = 0; i < inMaxInfluences; ++i)
+				kept += influences[i].mWeight;
+
+			float dropped = (total - kept) / total;
+			stats.mMaxDroppedWeight = std::max(stats.mMaxDroppedWeight, dropped);
+			droppedSum += dropped;
+			++stats.mNumPrunedVertices;
+
+			float invKept = 1.0f / kept;
+			for (std::uint32_t i = 0; i < inMaxInfluences; ++i)
+				influences[i].mWeight *= invKept;
+
+			count = inMaxInfluences;
+		}
+
+		ScatterInfluences(influences, count, vertex);
+	}
+
+	if (stats.mNumPrunedVertices > 0)
+		stats.mAverageDroppedWeight = static_cast<float>(droppedSum / stats.mNumPrunedVertices);
+
+	return stats;
+}
+
+SkinWeightQuantizeStatistics SkinWeights::Quantize(const std::vector<SkinnedVertex>& inVertices,
+		std::uint32_t inNumBones, std::uint32_t inWeightBits, QuantizedSkin& outSkin) {
+	outSkin.mWeightBits = inWeightBits == 16 ? 16 : 8;
+	outSkin.mIndexBits = inNumBones <= 256 ? 8 : 16;
+	outSkin.mStride = MaxQuantizedInfluences * (outSkin.mWeightBits + outSkin.mIndexBits) / 8;
+	outSkin.mData.assign(inVertices.size() * outSkin.mStride, 0);
+
+	const std::uint32_t weightSize = outSkin.mWeightBits / 8;
+	const std::uint32_t indexSize = outSkin.mIndexBits / 8;
+	const std::uint32_t maxValue = (1u << outSkin.mWeightBits) - 1;
+	const float invMaxValue = 1.0f / static_cast<float>(maxValue);
+
+	SkinWeightQuantizeStatistics stats;
+	stats.mSourceStride = static_cast<std::uint32_t>(
+		sizeof(SkinnedVertex::mBoneWeights0) + sizeof(SkinnedVertex::mBoneWeights1) +
+		sizeof(SkinnedVertex::mBoneIndices0) + sizeof(SkinnedVertex::mBoneIndices1));
+	stats.mQuantizedStride = outSkin.mStride;
+	stats.mSourceBytes = static_cast<std::uint64_t>(stats.mSourceStride) * inVertices.size();
+	stats.mQuantizedBytes = outSkin.mData.size();
+
+	Influence influences[MaxInfluences];
+
+	for (size_t v = 0, end = inVertices.size(); v < end; ++v) {
+		std::uint32_t count = std::min(GatherInfluences(inVertices[v], influences), MaxQuantizedInfluences);
+
+		float sum = 0.0f;
+		for (std::uint32_t i = 0; i < count; ++i)
+			sum += influences[i].mWeight;
+
+		// A vertex bound to no bone keeps all zero weights, like the float layout.
+		std::uint32_t quantized[MaxQuantizedInfluences] = {};
+		if (sum > 0.0f) {
+			// Rounds down and hands the remaining steps to the largest remainders,
+			//  so the weights sum up to exactly maxValue.
+			float remainders[MaxQuantizedInfluences] = {};
+			std::uint32_t total = 0;
+			for (std::uint32_t i = 0; i < count; ++i) {
+				float scaled = influences[i].mWeight / sum * static_cast<float>(maxValue);
+				quantized[i] = std::min(static_cast<std::uint32_t>(scaled), maxValue);
+				remainders[i] = scaled - static_cast<float>(quantized[i]);
+				total += quantized[i];
+			}
+
+			while (total < maxValue) {
+				std::uint32_t best = 0;
+				for (std::uint32_t i = 1; i < count; ++i) {
+					if (remainders[i] > remainders[best])
+						best = i;
+				}
+
+				++quantized[best];
+				remainders[best] -= 1.0f;
+				++total;
+			}
+		}
+
+		std::uint8_t* dst = outSkin.mData.data() + v * outSkin.mStride;
+		for (std::uint32_t i = 0; i < count; ++i) {
+			StoreUnsigned(dst + i * weightSize, outSkin.mWeightBits, quantized[i]);
+			StoreUnsigned(dst + MaxQuantizedInfluences * weightSize + i * indexSize, outSkin.mIndexBits,
+				static_cast<std::uint32_t>(influences[i].mIndex));
+
+			float error = std::abs(static_cast<float>(quantized[i]) * invMaxValue - influences[i].mWeight / sum);
+			stats.mMaxWeightError = std::max(stats.mMaxWeightError, error);
+		}
+	}
+
+	return stats;
+}
+
+void SkinWeights::Dequantize(const QuantizedSkin& inSkin, size_t inVertex,
+		float outWeights[MaxQuantizedInfluences], std::uint32_t outIndices[MaxQuantizedInfluences]) {
+	const std::uint32_t weightSize = inSkin.mWeightBits / 8;
+	const std::uint32_t indexSize = inSkin.mIndexBits / 8;
+	const float invMaxValue = 1.0f / static_cast<float>((1u << inSkin.mWeightBits) - 1);
+
+	const std::uint8_t* src = inSkin.mData.data() + inVertex * inSkin.mStride;
+	for (std::uint32_t i = 0; i < MaxQuantizedInfluences; ++i) {
+		outWeights[i] = static_cast<float>(LoadUnsigned(src + i * weightSize, inSkin.mWeightBits)) * invMaxValue;
+		outIndices[i] = LoadUnsigned(src + MaxQuantizedInfluences * weightSize + i * indexSize, inSkin.mIndexBits);
+	}
+}
\ No newline at end of file
@@ -14,6 +14,20 @@ Game::Bone::Bone(const std::string inName, int inParentIndex,
 	GlobalInvBindPose = inGlobalInvBindPose;
 }
 
+size_t Game::Animation::GetNumTracks() const {
+	return mCompressed.IsEmpty() ? mCurves.size() : mCompressed.GetNumTracks();
+}
+
+void Game::Animation::GetFrame(size_t inFrame, DirectX::XMFLOAT4X4* outTransforms) const {
+	if (!mCompressed.IsEmpty()) {
+		mCompressed.SamplePose(static_cast<float>(inFrame), outTransforms);
+		return;
+	}
+
+	for (size_t track = 0, end = mCurves.size(); track < end; ++track)
+		outTransforms[track] = mCurves[track][inFrame];
+}
+
 float Game::SkinnedData::GetTimePosition(const std::string& inClipName, float inTime) const{
 	auto animtIter = mAnimations.find(inClipName);
 	if (animtIter == mAnimations.cend())
@@ -0,0 +1,234 @@
+#include "DX12Game/TextureResidency.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Game;
+
+TextureResidency::Entry::Entry() : mRequestedMip(NoRequest) {}
+
+void TextureResidency::SetBudget(std::uint64_t inBytes) {
+	mBudget = inBytes;
+}
+
+std::uint64_t TextureResidency::GetBudget() const {
+	return mBudget;
+}
+
+TextureResidency::Handle TextureResidency::Register(
+		std::uint32_t inWidth, const std::vector<std::uint64_t>& inMipByteSizes, std::uint32_t inTailMip) {
+	if (inMipByteSizes.empty())
+		return InvalidHandle;
+
+	Handle handle = static_cast<Handle>(mEntries.size());
+	auto& entry = mEntries.emplace_back();
+
+	std::uint32_t numMips = static_cast<std::uint32_t>(inMipByteSizes.size());
+
+	entry.mWidth = inWidth;
+	entry.mTailMip = std::min(inTailMip, numMips - 1);
+	entry.mFirstResidentMip = entry.mTailMip;
+	entry.mDesiredMip = entry.mTailMip;
+
+	entry.mSuffixBytes.resize(numMips + 1);
+	entry.mSuffixBytes[numMips] = 0;
+	for (std::uint32_t mip = numMips; mip > 0; --mip)
+		entry.mSuffixBytes[mip - 1] = entry.mSuffixBytes[mip] + inMipByteSizes[mip - 1];
+
+	mResidentBytes += GetResidentBytes(entry, entry.mFirstResidentMip);
+
+	return handle;
+}
+
+void TextureResidency::Request(Handle inHandle, float inUVPerPixel) {
+	auto& entry = mEntries[inHandle];
+
+	std::uint32_t numMips = static_cast<std::uint32_t>(entry.mSuffixBytes.size() - 1);
+	std::uint32_t mip = ComputeMip(inUVPerPixel * static_cast<float>(entry.mWidth), numMips);
+
+	std::uint32_t prev = entry.mRequestedMip.load(std::memory_order_relaxed);
+	while (mip < prev && !entry.mRequestedMip.compare_exchange_weak(prev, mip, std::memory_order_relaxed));
+}
+
+void TextureResidency::Update(std::uint64_t inMaxLoadBytes, std::vector<TextureResidencyChange>& outChanges) {
+	outChanges.clear();
+	++mFrame;
+
+	Handle numEntries = static_cast<Handle>(mEntries.size());
+
+	std::vector<std::uint32_t> firstMips(numEntries);
+	std::vector<Handle> candidates;
+
+	for (Handle i = 0; i < numEntries; ++i) {
+		auto& entry = mEntries[i];
+		firstMips[i] = entry.mFirstResidentMip;
+
+		std::uint32_t requested = entry.mRequestedMip.exchange(NoRequest, std::memory_order_relaxed);
+		if (requested == NoRequest)
+			continue;
+
+		entry.mDesiredMip = std::min(requested, entry.mTailMip);
+		entry.mLastRequestedFrame = mFrame;
+
+		if (entry.mDesiredMip < entry.mFirstResidentMip)
+			candidates.push_back(i);
+	}
+
+	// The budget may have been lowered since the last update.
+	if (mResidentBytes > mBudget)
+		MakeRoom(0, InvalidHandle, firstMips);
+
+	// The textures furthest from their desired levels are raised first.
+	std::sort(candidates.begin(), candidates.end(), [&](Handle lhs, Handle rhs) {
+		std::uint32_t lhsGap = firstMips[lhs] - mEntries[lhs].mDesiredMip;
+		std::uint32_t rhsGap = firstMips[rhs] - mEntries[rhs].mDesiredMip;
+		if (lhsGap != rhsGap)
+			return lhsGap > rhsGap;
+		return lhs < rhs;
+	});
+
+	std::uint64_t loadedBytes = 0;
+	std::uint32_t numLoads = 0;
+
+	for (Handle handle : candidates) {
+		auto& entry = mEntries[handle];
+
+		// Only one level per update, so a texture goes through its lower levels first.
+		std::uint32_t nextMip = firstMips[handle] - 1;
+		std::uint64_t cost = entry.mSuffixBytes[nextMip] - entry.mSuffixBytes[nextMip + 1];
+
+		if (numLoads > 0 && loadedBytes + cost > inMaxLoadBytes)
+			break;
+
+		if (mResidentBytes + cost > mBudget && !MakeRoom(cost, handle, firstMips))
+			continue;
+
+		firstMips[handle] = nextMip;
+		mResidentBytes += cost;
+		loadedBytes += cost;
+		++numLoads;
+	}
+
+	TextureResidencyStatistics stats;
+	stats.mLoadedBytes = loadedBytes;
+
+	for (Handle i = 0; i < numEntries; ++i) {
+		auto& entry = mEntries[i];
+
+		if (firstMips[i] != entry.mFirstResidentMip) {
+			TextureResidencyChange change;
+			change.mHandle = i;
+			change.mFirstMip = firstMips[i];
+			change.mPrevFirstMip = entry.mFirstResidentMip;
+			outChanges.push_back(change);
+
+			if (change.mFirstMip < change.mPrevFirstMip)
+				++stats.mNumLoads;
+			else
+				++stats.mNumEvictions;
+
+			entry.mFirstResidentMip = firstMips[i];
+		}
+
+		if (entry.mLastRequestedFrame == mFrame && entry.mFirstResidentMip != entry.mDesiredMip)
+			++stats.mNumPending;
+	}
+
+	stats.mNumTextures = numEntries;
+	stats.mResidentBytes = mResidentBytes;
+	stats.mBudgetBytes = mBudget;
+
+	mLastStats = stats;
+}
+
+std::uint32_t TextureResidency::GetFirstResidentMip(Handle inHandle) const {
+	return mEntries[inHandle].mFirstResidentMip;
+}
+
+std::uint32_t TextureResidency::GetNumMips(Handle inHandle) const {
+	return static_cast<std::uint32_t>(mEntries[inHandle].mSuffixBytes.size() - 1);
+}
+
+TextureResidencyStatistics TextureResidency::GetStatistics() const {
+	return mLastStats;
+}
+
+std::uint32_t TextureResidency::ComputeMip(float inTexelsPerPixel, std::uint32_t inNumMips) {
+	// Also rejects NaN.
+	if (!(inTexelsPerPixel > 1.0f) || inNumMips == 0)
+		return 0;
+
+	float mip = std::floor(std::log2(inTexelsPerPixel));
+	if (mip >= static_cast<float>(inNumMips - 1))
+		return inNumMips - 1;
+
+	return static_cast<std::uint32_t>(mip);
+}
+
+std::uint64_t TextureResidency::GetResidentBytes(const Entry& inEntry, std::uint32_t inFirstMip) const {
+	return inEntry.mSuffixBytes[inFirstMip];
+}
+
+bool TextureResidency::MakeRoom(std::uint64_t inRequiredBytes, Handle inExcept, std::vector<std::uint32_t>& ioFirstMips) {
+	std::uint64_t needed = mResidentBytes + inRequiredBytes - std::min(mResidentBytes + inRequiredBytes, mBudget);
+	if (needed == 0)
+		return true;
+
+	struct Victim {
+		Handle mHandle;
+		std::uint32_t mLowestMip;
+	};
+	std::vector<Victim> victims;
+
+	// Levels finer than what the visible textures need go first,
+	//  then the textures that haven't been requested for the longest time.
+	std::vector<Handle> unused;
+	for (Handle i = 0, end = static_cast<Handle>(mEntries.size()); i < end; ++i) {
+		if (i == inExcept)
+			continue;
+
+		const auto& entry = mEntries[i];
+		if (entry.mLastRequestedFrame == mFrame) {
+			if (ioFirstMips[i] < entry.mDesiredMip)
+				victims.push_back({ i, entry.mDesiredMip });
+		}
+		else if (ioFirstMips[i] < entry.mTailMip) {
+			unused.push_back(i);
+		}
+	}
+
+	std::sort(unused.begin(), unused.end(), [&](Handle lhs, Handle rhs) {
+		return mEntries[lhs].mLastRequestedFrame < mEntries[rhs].mLastRequestedFrame;
+	});
+	for (Handle handle : unused)
+		victims.push_back({ handle, mEntries[handle].mTailMip });
+
+	std::uint64_t reclaimable = 0;
+	for (const auto& victim : victims) {
+		const auto& entry = mEntries[victim.mHandle];
+		reclaimable += GetResidentBytes(entry, ioFirstMips[victim.mHandle]) - GetResidentBytes(entry, victim.mLowestMip);
+	}
+
+	// Nothing is evicted for a load that can't fit anyway;
+	//  an over-budget state without a load is reduced as much as possible.
+	if (reclaimable < needed && inRequiredBytes > 0)
+		return false;
+
+	for (const auto& victim : victims) {
+		const auto& entry = mEntries[victim.mHandle];
+		auto& firstMip = ioFirstMips[victim.mHandle];
+
+		// The finest levels of a victim are dropped first.
+		while (firstMip < victim.mLowestMip && needed > 0) {
+			std::uint64_t bytes = entry.mSuffixBytes[firstMip] - entry.mSuffixBytes[firstMip + 1];
+			mResidentBytes -= bytes;
+			needed -= std::min(needed, bytes);
+			++firstMip;
+		}
+
+		if (needed == 0)
+			break;
+	}
+
+	return needed == 0;
+}
\ No newline at end of file
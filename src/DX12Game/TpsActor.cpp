@@ -11,6 +11,7 @@ TpsActor::TpsActor()
 	: Actor(),
 	mWalkingSpeed(2.0f),
 	mRunningSpeed(8.0f),
+	mAnimationSpeedRate(8.0f),
 	mMaxElevation(0.85f),
 	mMinElevation(-0.85f),	
 	mCameraMaxDistance(5.0f),
@@ -26,6 +27,15 @@ TpsActor::TpsActor()
 
 	mSkeletalMeshComponent = new SkeletalMeshComponent(this);
 
+	// Idle at rest, then the walk played faster up to the running speed.
+	auto graph = mSkeletalMeshComponent->CreateAnimationGraph();
+	mSpeedParameter = graph->AddParameter("Speed");
+	auto locomotion = graph->AddBlendSpace1D(mSpeedParameter);
+	graph->AddBlendSpace1DSample(locomotion, graph->AddClip("Idle"), 0.0f);
+	graph->AddBlendSpace1DSample(locomotion, graph->AddClip("Walk"), mWalkingSpeed);
+	graph->AddBlendSpace1DSample(locomotion, graph->AddClip("Walk", mRunningSpeed / mWalkingSpeed), mRunningSpeed);
+	graph->Play(locomotion, 0.0f);
+
 	mForwardSpeed = 0;
 	mStrafeSpeed = 0;
 
@@ -34,6 +44,9 @@ TpsActor::TpsActor()
 
 	mElevation = 0.0f;
 	mPitchRotationSpeed = 0.0f;
+
+	mCurrSpeed = mWalkingSpeed;
+	mAnimationSpeed = 0.0f;
 }
 
 void TpsActor::UpdateActor(const GameTimer& gt) {
@@ -97,6 +110,13 @@ void TpsActor::UpdateActor(const GameTimer& gt) {
 	
 		mSkeletalMeshComponent->SetQuaternion(XMQuaternionRotationAxis(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), theta));
 	}
+
+	//----------------------------------------------------------------------------------------------------------------
+	// Blend the locomotion clips by the moving speed.
+	//----------------------------------------------------------------------------------------------------------------
+	float targetSpeed = (mForwardSpeed != 0 || mStrafeSpeed != 0) ? mCurrSpeed : 0.0f;
+	mAnimationSpeed += (targetSpeed - mAnimationSpeed) * std::min(mAnimationSpeedRate * gt.DeltaTime(), 1.0f);
+	mSkeletalMeshComponent->GetAnimationGraph()->SetParameter(mSpeedParameter, mAnimationSpeed);
 }
 
 void TpsActor::ProcessActorInput(const InputState& input) {
@@ -129,15 +149,10 @@ void TpsActor::ProcessActorInput(const InputState& input) {
 	// Make each pixel correspond to a quarter of a degree.
 	mYAngularSpeed = XMConvertToRadians(input.Mouse.GetPosition().x * -0.25f);
 	mPitchRotationSpeed = XMConvertToRadians(input.Mouse.GetPosition().y * 0.25f);
-	
-	if (mForwardSpeed != 0 || mStrafeSpeed != 0)
-		mSkeletalMeshComponent->SetClipName("Walk");
-	else
-		mSkeletalMeshComponent->SetClipName("Idle");
 }
 
 GameResult TpsActor::OnLoadingData() {
-	CheckGameResult(mSkeletalMeshComponent->LoadMesh("leoni", "leoni.fbx"));
+	CheckGameResult(mSkeletalMeshComponent->LoadMesh("leoni", "leoni.fbx", MeshComponent::ELoadHigh));
 	
 	mSkeletalMeshComponent->SetSkeleletonVisible(true);
 
@@ -0,0 +1,126 @@
+#include "DX12Game/VertexWelder.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Game;
+
+namespace {
+	const float MaxLoadFactor = 0.5f;
+	const size_t MinTableCapacity = 64;
+	// The upper half of a slot caches the upper half of the hash.
+	const std::uint64_t TagMask = 0xFFFFFFFF00000000ull;
+
+	size_t NextPowerOfTwo(size_t inValue) {
+		size_t value = 1;
+		while (value < inValue)
+			value <<= 1;
+		return value;
+	}
+}
+
+void VertexWelder::Initialize(std::uint32_t inNumWords, std::uint32_t inNumFloatWords, size_t inExpectedVertexCount,
+		std::uint32_t inQuantizationBits, float inZeroThreshold) {
+	mNumWords = inNumWords;
+	mNumFloatWords = std::min(inNumFloatWords, inNumWords);
+	mZeroThreshold = inZeroThreshold;
+
+	inQuantizationBits = std::min(inQuantizationBits, 22u);
+	mRoundBias = inQuantizationBits > 0 ? 1u << (inQuantizationBits - 1) : 0;
+	mRoundMask = ~((1u << inQuantizationBits) - 1);
+
+	mScratch.resize(mNumWords);
+
+	Clear();
+	Rehash(NextPowerOfTwo(std::max(static_cast<size_t>(inExpectedVertexCount / MaxLoadFactor), MinTableCapacity)));
+}
+
+std::uint32_t VertexWelder::Weld(const std::uint32_t* inWords, bool& outInserted) {
+	std::uint32_t* key = mScratch.data();
+	Quantize(inWords, key);
+
+	const std::uint64_t hash = Hash(key);
+	const size_t mask = mSlots.size() - 1;
+
+	const std::uint64_t tag = hash & TagMask;
+
+	size_t slot = static_cast<size_t>(hash) & mask;
+	while (mSlots[slot] != 0) {
+		std::uint32_t index = static_cast<std::uint32_t>(mSlots[slot]) - 1;
+		if ((mSlots[slot] & TagMask) == tag &&
+				std::memcmp(&mKeys[static_cast<size_t>(index) * mNumWords], key, mNumWords * sizeof(std::uint32_t)) == 0) {
+			outInserted = false;
+			return index;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	std::uint32_t index = static_cast<std::uint32_t>(mHashes.size());
+	mSlots[slot] = tag | (index + 1);
+	mHashes.push_back(hash);
+	mKeys.insert(mKeys.end(), key, key + mNumWords);
+
+	if (mHashes.size() > mSlots.size() * MaxLoadFactor)
+		Rehash(mSlots.size() * 2);
+
+	outInserted = true;
+	return index;
+}
+
+std::uint32_t VertexWelder::GetNumUniqueVertices() const {
+	return static_cast<std::uint32_t>(mHashes.size());
+}
+
+void VertexWelder::Clear() {
+	std::fill(mSlots.begin(), mSlots.end(), 0);
+	mHashes.clear();
+	mKeys.clear();
+}
+
+void VertexWelder::Quantize(const std::uint32_t* inWords, std::uint32_t* outWords) const {
+	for (std::uint32_t i = 0; i < mNumFloatWords; ++i) {
+		float value;
+		std::memcpy(&value, &inWords[i], sizeof(float));
+
+		// Also folds -0.0 into +0.0.
+		if (!(value > mZeroThreshold || value < -mZeroThreshold)) {
+			outWords[i] = 0;
+			continue;
+		}
+
+		// Rounds to the nearest representable value with the low mantissa bits cleared,
+		//  a carry into the exponent still yields the correctly rounded float.
+		outWords[i] = (inWords[i] + mRoundBias) & mRoundMask;
+	}
+
+	for (std::uint32_t i = mNumFloatWords; i < mNumWords; ++i)
+		outWords[i] = inWords[i];
+}
+
+std::uint64_t VertexWelder::Hash(const std::uint32_t* inWords) const {
+	std::uint64_t hash = 0x9E3779B97F4A7C15ull ^ mNumWords;
+	for (std::uint32_t i = 0; i < mNumWords; ++i) {
+		hash ^= inWords[i];
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 32;
+	}
+
+	// Final avalanche(MurmurHash3 fmix64), the low bits pick the slot.
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ull;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+void VertexWelder::Rehash(size_t inCapacity) {
+	mSlots.assign(inCapacity, 0);
+
+	const size_t mask = inCapacity - 1;
+	for (std::uint32_t i = 0, end = static_cast<std::uint32_t>(mHashes.size()); i < end; ++i) {
+		size_t slot = static_cast<size_t>(mHashes[i]) & mask;
+		while (mSlots[slot] != 0)
+			slot = (slot + 1) & mask;
+		mSlots[slot] = (mHashes[i] & TagMask) | (i + 1);
+	}
+}
\ No newline at end of file
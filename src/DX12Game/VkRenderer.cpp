@@ -646,6 +646,16 @@ void VkRenderer::UpdateInstanceAnimationData(const std::string& inRenderItemName
 
 }
 
+void VkRenderer::UpdateInstanceAnimationBlend(const std::string& inRenderItemName,
+	const Game::PoseTerm* inTerms, UINT inNumTerms) {
+
+}
+
+void VkRenderer::UpdateInstanceAnimationPlayback(const std::string& inRenderItemName,
+	UINT inAnimClipIdx, float inTimePos, float inTimeRate, float inTimeBase, float inTimeEnd) {
+
+}
+
 void VkRenderer::SetVisible(const std::string& inRenderItemName, bool inState) {
 
 }
@@ -670,9 +680,14 @@ GameResult VkRenderer::AddMaterials(const std::unordered_map<std::string, Materi
 	return GameResultOk;
 }
 
-UINT VkRenderer::AddAnimations(const std::string& inClipName, const Game::Animation& inAnim) {
+GameResult VkRenderer::AddAnimations(const std::string& inClipName, const Game::Animation& inAnim, UINT& outClipIndex) {
+	outClipIndex = 0;
+
+	return GameResultOk;
+}
+
+void VkRenderer::RemoveAnimations(UINT inClipIndex) {
 
-	return 0;
 }
 
 GameResult VkRenderer::UpdateAnimationsMap() {
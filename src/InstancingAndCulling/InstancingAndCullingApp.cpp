@@ -533,79 +533,30 @@ void InstancingAndCullingApp::BuildShadersAndInputLayout() {
 }
 
 void InstancingAndCullingApp::BuildSkullGeometry() {
-	std::ifstream fin("Models/skull.txt");
+	GeometryGenerator::MeshData skull;
+	BoundingBox aabb;
 
-	if (!fin) {
+	if (!TextModelLoader::Load("Models/skull.txt", TextModelLoader::TexCoordMode::Spherical, skull, aabb)) {
 		MessageBox(0, L"Models/skull.txt not found.", 0, 0);
 		return;
 	}
 
-	UINT vcount = 0;
-	UINT tcount = 0;
-	std::string ignore;
-
-	fin >> ignore >> vcount;
-	fin >> ignore >> tcount;
-	fin >> ignore >> ignore >> ignore >> ignore;
-
-	XMFLOAT3 vMinf3(+MathHelper::Infinity, +MathHelper::Infinity, +MathHelper::Infinity);
-	XMFLOAT3 vMaxf3(-MathHelper::Infinity, -MathHelper::Infinity, -MathHelper::Infinity);
-
-	XMVECTOR vMin = XMLoadFloat3(&vMinf3);
-	XMVECTOR vMax = XMLoadFloat3(&vMaxf3);
-
-	std::vector<Vertex> vertices(vcount);
-	for (UINT i = 0; i < vcount; ++i) {
-		fin >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
-		fin >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
-
-		XMVECTOR P = XMLoadFloat3(&vertices[i].Pos);
-
-		// Project point onto unit sphere and generate spherical texture coordinates.
-		XMFLOAT3 spherePos;
-		XMStoreFloat3(&spherePos, XMVector3Normalize(P));
-
-		float theta = atan2f(spherePos.z, spherePos.x);
-
-		// Put in [0, 2pi].
-		if (theta < 0.0f)
-			theta += XM_2PI;
-
-		float phi = acosf(spherePos.y);
-
-		float u = theta / (2.0f*XM_PI);
-		float v = phi / XM_PI;
-
-		vertices[i].TexC = { u, v };
-
-		vMin = XMVectorMin(vMin, P);
-		vMax = XMVectorMax(vMax, P);
-	}
-
 #if defined(Ex1)
 	BoundingSphere bounds;
-	XMVECTOR vCenter = 0.5f * (vMin + vMax);
-	XMStoreFloat3(&bounds.Center, vCenter);
-
-	XMVECTOR vRadius = XMVectorMax(vCenter - vMin, vCenter - vMax);
-	vRadius = XMVector4Length(vRadius);
-
-	bounds.Radius = vRadius.m128_f32[0];
+	bounds.Center = aabb.Center;
+	bounds.Radius = XMVectorGetX(XMVector3Length(XMLoadFloat3(&aabb.Extents)));
 #else
-	BoundingBox bounds;
-	XMStoreFloat3(&bounds.Center, 0.5f*(vMin + vMax));
-	XMStoreFloat3(&bounds.Extents, 0.5f*(vMax - vMin));
+	BoundingBox bounds = aabb;
 #endif
 
-	fin >> ignore;
-	fin >> ignore;
-	fin >> ignore;
-
-	std::vector<std::int32_t> indices(3 * tcount);
-	for (UINT i = 0; i < tcount; ++i)
-		fin >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
+	std::vector<Vertex> vertices(skull.Vertices.size());
+	for (size_t i = 0; i < skull.Vertices.size(); ++i) {
+		vertices[i].Pos = skull.Vertices[i].Position;
+		vertices[i].Normal = skull.Vertices[i].Normal;
+		vertices[i].TexC = skull.Vertices[i].TexC;
+	}
 
-	fin.close();
+	const std::vector<std::uint32_t>& indices = skull.Indices32;
 
 	//
 	// Pack the indices of all the meshes into one index buffer.
@@ -613,7 +564,7 @@ void InstancingAndCullingApp::BuildSkullGeometry() {
 
 	const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
 
-	const UINT ibByteSize = (UINT)indices.size() * sizeof(std::int32_t);
+	const UINT ibByteSize = (UINT)indices.size() * sizeof(std::uint32_t);
 
 	auto geo = std::make_unique<MeshGeometry>();
 	geo->Name = "skullGeo";
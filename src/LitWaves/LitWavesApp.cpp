@@ -959,35 +959,21 @@ void LitWavesApp::BuildShapeGeometry() {
 }
 
 void LitWavesApp::BuildSkullGeometry() {
-	std::wstring fileName = L"Models/Skull.txt";
-	std::ifstream file(fileName);
+	GeometryGenerator::MeshData skull;
+	BoundingBox aabb;
 
-	if (!file.is_open()) {
-		MessageBox(0, fileName.c_str(), 0, 0);
+	if (!TextModelLoader::Load("Models/Skull.txt", TextModelLoader::TexCoordMode::Zero, skull, aabb)) {
+		MessageBox(0, L"Models/Skull.txt", 0, 0);
 		return;
 	}
 
-	UINT vcount = 0;
-	UINT tcount = 0;
-	std::string ignore;
-
-	file >> ignore >> vcount;
-	file >> ignore >> tcount;
-	file >> ignore >> ignore >> ignore >> ignore;
-
-	std::vector<Vertex> vertices(vcount);
-	for (UINT i = 0; i < vcount; i++) {
-		file >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
-		file >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
+	std::vector<Vertex> vertices(skull.Vertices.size());
+	for (size_t i = 0; i < skull.Vertices.size(); ++i) {
+		vertices[i].Pos = skull.Vertices[i].Position;
+		vertices[i].Normal = skull.Vertices[i].Normal;
 	}
 
-	file >> ignore >> ignore >> ignore;
-
-	std::vector<std::int32_t> indices(3 * tcount);
-	for (UINT i = 0; i < tcount; i++)
-		file >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
-
-	file.close();
+	const std::vector<std::uint32_t>& indices = skull.Indices32;
 
 	//
 	// Pack the indices of all the meshes into one index buffer.
@@ -419,64 +419,30 @@ void PickingApp::BuildShadersAndInputLayout() {
 }
 
 void PickingApp::BuildCarGeometry() {
-	std::ifstream fin("Models/car.txt");
+	GeometryGenerator::MeshData car;
+	BoundingBox aabb;
 
-	if (!fin) {
+	if (!TextModelLoader::Load("Models/car.txt", TextModelLoader::TexCoordMode::Zero, car, aabb)) {
 		MessageBox(0, L"Models/car.txt not found.", 0, 0);
 		return;
 	}
 
-	UINT vcount = 0;
-	UINT tcount = 0;
-	std::string ignore;
-
-	fin >> ignore >> vcount;
-	fin >> ignore >> tcount;
-	fin >> ignore >> ignore >> ignore >> ignore;
-
-	XMFLOAT3 vMinf3(+MathHelper::Infinity, +MathHelper::Infinity, +MathHelper::Infinity);
-	XMFLOAT3 vMaxf3(-MathHelper::Infinity, -MathHelper::Infinity, -MathHelper::Infinity);
-
-	XMVECTOR vMin = XMLoadFloat3(&vMinf3);
-	XMVECTOR vMax = XMLoadFloat3(&vMaxf3);
-
-	std::vector<Vertex> vertices(vcount);
-	for (UINT i = 0; i < vcount; ++i) {
-		fin >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
-		fin >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
-
-		XMVECTOR P = XMLoadFloat3(&vertices[i].Pos);
-
-		vertices[i].TexC = { 0.0f, 0.0f };
-
-		vMin = XMVectorMin(vMin, P);
-		vMax = XMVectorMax(vMax, P);
-	}
-
 #if defined(Ex1)
 	BoundingSphere bounds;
-	XMVECTOR vCenter = 0.5f * (vMin + vMax);
-	XMStoreFloat3(&bounds.Center, vCenter);
-
-	XMVECTOR vRadius = XMVectorMax(vCenter - vMin, vCenter - vMax);
-	vRadius = XMVector4Length(vRadius);
-	bounds.Radius = vRadius.m128_f32[0];
+	bounds.Center = aabb.Center;
+	bounds.Radius = XMVectorGetX(XMVector3Length(XMLoadFloat3(&aabb.Extents)));
 #else
-	BoundingBox bounds;
-	XMStoreFloat3(&bounds.Center, 0.5f*(vMin + vMax));
-	XMStoreFloat3(&bounds.Extents, 0.5f*(vMax - vMin));
+	BoundingBox bounds = aabb;
 #endif
 
-	fin >> ignore;
-	fin >> ignore;
-	fin >> ignore;
-
-	std::vector<std::int32_t> indices(3 * tcount);
-	for (UINT i = 0; i < tcount; ++i) {
-		fin >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
+	std::vector<Vertex> vertices(car.Vertices.size());
+	for (size_t i = 0; i < car.Vertices.size(); ++i) {
+		vertices[i].Pos = car.Vertices[i].Position;
+		vertices[i].Normal = car.Vertices[i].Normal;
+		vertices[i].TexC = car.Vertices[i].TexC;
 	}
 
-	fin.close();
+	const std::vector<std::uint32_t>& indices = car.Indices32;
 
 	//
 	// Pack the indices of all the meshes into one index buffer.
@@ -484,7 +450,7 @@ void PickingApp::BuildCarGeometry() {
 
 	const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
 
-	const UINT ibByteSize = (UINT)indices.size() * sizeof(std::int32_t);
+	const UINT ibByteSize = (UINT)indices.size() * sizeof(std::uint32_t);
 
 	auto geo = std::make_unique<MeshGeometry>();
 	geo->Name = "carGeo";
@@ -6,78 +6,87 @@
 
 using namespace DirectX;
 
-Keyframe::Keyframe()
-	: TimePos(0.0f),
-	Translation(0.0f, 0.0f, 0.0f),
-	Scale(1.0f, 1.0f, 1.0f),
-	RotationQuat(0.0f, 0.0f, 0.0f, 1.0f)
-{
-}
-
-Keyframe::~Keyframe()
+namespace
 {
+	XMMATRIX ComposeKey(XMVECTOR S, XMVECTOR Q, XMVECTOR P)
+	{
+		XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+		return XMMatrixAffineTransformation(S, zero, Q, P);
+	}
 }
  
 float BoneAnimation::GetStartTime()const
 {
 	// Keyframes are sorted by time, so first keyframe gives start time.
-	return Keyframes.front().TimePos;
+	return TimePositions.front();
 }
 
 float BoneAnimation::GetEndTime()const
 {
 	// Keyframes are sorted by time, so last keyframe gives end time.
-	float f = Keyframes.back().TimePos;
+	float f = TimePositions.back();
 
 	return f;
 }
 
+UINT BoneAnimation::GetNumKeyframes()const
+{
+	return (UINT)TimePositions.size();
+}
+
+void BoneAnimation::Resize(UINT numKeyframes)
+{
+	TimePositions.resize(numKeyframes, 0.0f);
+	Translations.resize(numKeyframes, XMFLOAT3(0.0f, 0.0f, 0.0f));
+	Scales.resize(numKeyframes, XMFLOAT3(1.0f, 1.0f, 1.0f));
+	RotationQuats.resize(numKeyframes, XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+}
+
 void BoneAnimation::Interpolate(float t, XMFLOAT4X4& M)const
 {
-	if( t <= Keyframes.front().TimePos )
+	UINT keyIndex = 0;
+	Interpolate(t, M, keyIndex);
+}
+
+void BoneAnimation::Interpolate(float t, XMFLOAT4X4& M, UINT& keyIndex)const
+{
+	if( t <= TimePositions.front() )
 	{
-		XMVECTOR S = XMLoadFloat3(&Keyframes.front().Scale);
-		XMVECTOR P = XMLoadFloat3(&Keyframes.front().Translation);
-		XMVECTOR Q = XMLoadFloat4(&Keyframes.front().RotationQuat);
+		XMVECTOR S = XMLoadFloat3(&Scales.front());
+		XMVECTOR P = XMLoadFloat3(&Translations.front());
+		XMVECTOR Q = XMLoadFloat4(&RotationQuats.front());
 
-		XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
-		XMStoreFloat4x4(&M, XMMatrixAffineTransformation(S, zero, Q, P));
+		XMStoreFloat4x4(&M, ComposeKey(S, Q, P));
+		keyIndex = 0;
 	}
-	else if( t >= Keyframes.back().TimePos )
+	else if( t >= TimePositions.back() )
 	{
-		XMVECTOR S = XMLoadFloat3(&Keyframes.back().Scale);
-		XMVECTOR P = XMLoadFloat3(&Keyframes.back().Translation);
-		XMVECTOR Q = XMLoadFloat4(&Keyframes.back().RotationQuat);
+		XMVECTOR S = XMLoadFloat3(&Scales.back());
+		XMVECTOR P = XMLoadFloat3(&Translations.back());
+		XMVECTOR Q = XMLoadFloat4(&RotationQuats.back());
 
-		XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
-		XMStoreFloat4x4(&M, XMMatrixAffineTransformation(S, zero, Q, P));
+		XMStoreFloat4x4(&M, ComposeKey(S, Q, P));
 	}
 	else
 	{
-		for(UINT i = 0; i < Keyframes.size()-1; ++i)
-		{
-			if( t >= Keyframes[i].TimePos && t <= Keyframes[i+1].TimePos )
-			{
-				float lerpPercent = (t - Keyframes[i].TimePos) / (Keyframes[i+1].TimePos - Keyframes[i].TimePos);
+		UINT i = MathHelper::FindKeyframe(TimePositions.data(), GetNumKeyframes(), t, keyIndex);
+		keyIndex = i;
 
-				XMVECTOR s0 = XMLoadFloat3(&Keyframes[i].Scale);
-				XMVECTOR s1 = XMLoadFloat3(&Keyframes[i+1].Scale);
+		float lerpPercent = (t - TimePositions[i]) / (TimePositions[i+1] - TimePositions[i]);
 
-				XMVECTOR p0 = XMLoadFloat3(&Keyframes[i].Translation);
-				XMVECTOR p1 = XMLoadFloat3(&Keyframes[i+1].Translation);
+		XMVECTOR s0 = XMLoadFloat3(&Scales[i]);
+		XMVECTOR s1 = XMLoadFloat3(&Scales[i+1]);
 
-				XMVECTOR q0 = XMLoadFloat4(&Keyframes[i].RotationQuat);
-				XMVECTOR q1 = XMLoadFloat4(&Keyframes[i+1].RotationQuat);
+		XMVECTOR p0 = XMLoadFloat3(&Translations[i]);
+		XMVECTOR p1 = XMLoadFloat3(&Translations[i+1]);
 
-				XMVECTOR S = XMVectorLerp(s0, s1, lerpPercent);
-				XMVECTOR P = XMVectorLerp(p0, p1, lerpPercent);
-				XMVECTOR Q = XMQuaternionSlerp(q0, q1, lerpPercent);
+		XMVECTOR q0 = XMLoadFloat4(&RotationQuats[i]);
+		XMVECTOR q1 = XMLoadFloat4(&RotationQuats[i+1]);
 
-				XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
-				XMStoreFloat4x4(&M, XMMatrixAffineTransformation(S, zero, Q, P));
+		XMVECTOR S = XMVectorLerp(s0, s1, lerpPercent);
+		XMVECTOR P = XMVectorLerp(p0, p1, lerpPercent);
+		XMVECTOR Q = XMQuaternionSlerp(q0, q1, lerpPercent);
 
-				break;
-			}
-		}
+		XMStoreFloat4x4(&M, ComposeKey(S, Q, P));
 	}
 }
\ No newline at end of file
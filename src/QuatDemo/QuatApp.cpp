@@ -570,31 +570,31 @@ void QuatApp::DefineSkullAnimation() {
 	XMVECTOR q2 = XMQuaternionRotationAxis(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), XMConvertToRadians(135.0f));
 	XMVECTOR q3 = XMQuaternionRotationAxis(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), XMConvertToRadians(179.0f));
 
-	mSkullAnimation.Keyframes.resize(5);
-	mSkullAnimation.Keyframes[0].TimePos = 0.0f;
-	mSkullAnimation.Keyframes[0].Translation = XMFLOAT3(-7.0f, 0.0f, 0.0f);
-	mSkullAnimation.Keyframes[0].Scale = XMFLOAT3(0.25f, 0.25f, 0.25f);
-	XMStoreFloat4(&mSkullAnimation.Keyframes[0].RotationQuat, q0);
-
-	mSkullAnimation.Keyframes[1].TimePos = 2.0f;
-	mSkullAnimation.Keyframes[1].Translation = XMFLOAT3(0.0f, 2.0f, 10.0f);
-	mSkullAnimation.Keyframes[1].Scale = XMFLOAT3(0.5f, 0.5f, 0.5f);
-	XMStoreFloat4(&mSkullAnimation.Keyframes[1].RotationQuat, q1);
-
-	mSkullAnimation.Keyframes[2].TimePos = 4.0f;
-	mSkullAnimation.Keyframes[2].Translation = XMFLOAT3(7.0f, 0.0f, 0.0f);
-	mSkullAnimation.Keyframes[2].Scale = XMFLOAT3(0.25f, 0.25f, 0.25f);
-	XMStoreFloat4(&mSkullAnimation.Keyframes[2].RotationQuat, q2);
-
-	mSkullAnimation.Keyframes[3].TimePos = 6.0f;
-	mSkullAnimation.Keyframes[3].Translation = XMFLOAT3(0.0f, 1.0f, -10.0f);
-	mSkullAnimation.Keyframes[3].Scale = XMFLOAT3(0.5f, 0.5f, 0.5f);
-	XMStoreFloat4(&mSkullAnimation.Keyframes[3].RotationQuat, q3);
-
-	mSkullAnimation.Keyframes[4].TimePos = 8.0f;
-	mSkullAnimation.Keyframes[4].Translation = XMFLOAT3(-7.0f, 0.0f, 0.0f);
-	mSkullAnimation.Keyframes[4].Scale = XMFLOAT3(0.25f, 0.25f, 0.25f);
-	XMStoreFloat4(&mSkullAnimation.Keyframes[4].RotationQuat, q0);
+	mSkullAnimation.Resize(5);
+	mSkullAnimation.TimePositions[0] = 0.0f;
+	mSkullAnimation.Translations[0] = XMFLOAT3(-7.0f, 0.0f, 0.0f);
+	mSkullAnimation.Scales[0] = XMFLOAT3(0.25f, 0.25f, 0.25f);
+	XMStoreFloat4(&mSkullAnimation.RotationQuats[0], q0);
+
+	mSkullAnimation.TimePositions[1] = 2.0f;
+	mSkullAnimation.Translations[1] = XMFLOAT3(0.0f, 2.0f, 10.0f);
+	mSkullAnimation.Scales[1] = XMFLOAT3(0.5f, 0.5f, 0.5f);
+	XMStoreFloat4(&mSkullAnimation.RotationQuats[1], q1);
+
+	mSkullAnimation.TimePositions[2] = 4.0f;
+	mSkullAnimation.Translations[2] = XMFLOAT3(7.0f, 0.0f, 0.0f);
+	mSkullAnimation.Scales[2] = XMFLOAT3(0.25f, 0.25f, 0.25f);
+	XMStoreFloat4(&mSkullAnimation.RotationQuats[2], q2);
+
+	mSkullAnimation.TimePositions[3] = 6.0f;
+	mSkullAnimation.Translations[3] = XMFLOAT3(0.0f, 1.0f, -10.0f);
+	mSkullAnimation.Scales[3] = XMFLOAT3(0.5f, 0.5f, 0.5f);
+	XMStoreFloat4(&mSkullAnimation.RotationQuats[3], q3);
+
+	mSkullAnimation.TimePositions[4] = 8.0f;
+	mSkullAnimation.Translations[4] = XMFLOAT3(-7.0f, 0.0f, 0.0f);
+	mSkullAnimation.Scales[4] = XMFLOAT3(0.25f, 0.25f, 0.25f);
+	XMStoreFloat4(&mSkullAnimation.RotationQuats[4], q0);
 }
 
 void QuatApp::LoadTextures() {
@@ -1004,69 +1004,22 @@ void QuatApp::BuildShapeGeometry() {
 }
 
 void QuatApp::BuildSkullGeometry() {
-	std::ifstream fin("Models/skull.txt");
+	GeometryGenerator::MeshData skull;
+	BoundingBox bounds;
 
-	if (!fin) {
+	if (!TextModelLoader::Load("Models/skull.txt", TextModelLoader::TexCoordMode::Spherical, skull, bounds)) {
 		MessageBox(0, L"Models/skull.txt not found.", 0, 0);
 		return;
 	}
 
-	UINT vcount = 0;
-	UINT tcount = 0;
-	std::string ignore;
-
-	fin >> ignore >> vcount;
-	fin >> ignore >> tcount;
-	fin >> ignore >> ignore >> ignore >> ignore;
-
-	XMFLOAT3 vMinf3(+MathHelper::Infinity, +MathHelper::Infinity, +MathHelper::Infinity);
-	XMFLOAT3 vMaxf3(-MathHelper::Infinity, -MathHelper::Infinity, -MathHelper::Infinity);
-
-	XMVECTOR vMin = XMLoadFloat3(&vMinf3);
-	XMVECTOR vMax = XMLoadFloat3(&vMaxf3);
-
-	std::vector<Vertex> vertices(vcount);
-	for (UINT i = 0; i < vcount; ++i) {
-		fin >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
-		fin >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
-
-		XMVECTOR P = XMLoadFloat3(&vertices[i].Pos);
-
-		// Project point onto unit sphere and generate spherical texture coordinates.
-		XMFLOAT3 spherePos;
-		XMStoreFloat3(&spherePos, XMVector3Normalize(P));
-
-		float theta = atan2f(spherePos.z, spherePos.x);
-
-		// Put in [0, 2pi].
-		if (theta < 0.0f)
-			theta += XM_2PI;
-
-		float phi = acosf(spherePos.y);
-
-		float u = theta / (2.0f*XM_PI);
-		float v = phi / XM_PI;
-
-		vertices[i].TexC = { u, v };
-
-		vMin = XMVectorMin(vMin, P);
-		vMax = XMVectorMax(vMax, P);
-	}
-
-	BoundingBox bounds;
-	XMStoreFloat3(&bounds.Center, 0.5f*(vMin + vMax));
-	XMStoreFloat3(&bounds.Extents, 0.5f*(vMax - vMin));
-
-	fin >> ignore;
-	fin >> ignore;
-	fin >> ignore;
-
-	std::vector<std::int32_t> indices(3 * tcount);
-	for (UINT i = 0; i < tcount; ++i) {
-		fin >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
+	std::vector<Vertex> vertices(skull.Vertices.size());
+	for (size_t i = 0; i < skull.Vertices.size(); ++i) {
+		vertices[i].Pos = skull.Vertices[i].Position;
+		vertices[i].Normal = skull.Vertices[i].Normal;
+		vertices[i].TexC = skull.Vertices[i].TexC;
 	}
 
-	fin.close();
+	const std::vector<std::uint32_t>& indices = skull.Indices32;
 
 	//
 	// Pack the indices of all the meshes into one index buffer.
@@ -1074,7 +1027,7 @@ void QuatApp::BuildSkullGeometry() {
 
 	const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
 
-	const UINT ibByteSize = (UINT)indices.size() * sizeof(std::int32_t);
+	const UINT ibByteSize = (UINT)indices.size() * sizeof(std::uint32_t);
 
 	auto geo = std::make_unique<MeshGeometry>();
 	geo->Name = "skullGeo";
@@ -1,47 +1,249 @@
 #include "SkinnedMesh/LoadM3d.h"
- 
+#include "common/MappedFile.h"
+#include "common/TextReader.h"
+
+#include <cstring>
+#include <fstream>
+
 using namespace DirectX;
 
-bool M3DLoader::LoadM3d(const std::string& filename, 
+namespace {
+	const char BinaryMagic[4] = { 'M', '3', 'D', 'B' };
+	const UINT BinaryVersion = 1;
+
+	enum BinaryFlags : UINT {
+		ESkinned = 1 << 0
+	};
+
+	class BinaryReader {
+	public:
+		BinaryReader(const char* begin, const char* end) : mCurr(begin), mEnd(end) {}
+
+	public:
+		bool Failed() const {
+			return bFailed;
+		}
+
+		template <typename T>
+		void Read(T& value) {
+			ReadBytes(&value, sizeof(T));
+		}
+
+		void Read(std::string& value) {
+			UINT length = 0;
+			Read(length);
+			if (!CanRead(length, 1))
+				return;
+
+			value.assign(mCurr, mCurr + length);
+			mCurr += length;
+		}
+
+		template <typename T>
+		void ReadArray(std::vector<T>& values, UINT count) {
+			if (!CanRead(count, sizeof(T)))
+				return;
+
+			values.resize(count);
+			ReadBytes(values.data(), static_cast<size_t>(count) * sizeof(T));
+		}
+
+		// Fails if the rest of the data can't hold count elements of elementSize bytes,
+		// so corrupted counts don't cause huge allocations.
+		bool CanRead(UINT count, size_t elementSize) {
+			if (static_cast<size_t>(mEnd - mCurr) / elementSize < count)
+				bFailed = true;
+			return !bFailed;
+		}
+
+	private:
+		void ReadBytes(void* dst, size_t size) {
+			if (bFailed || static_cast<size_t>(mEnd - mCurr) < size) {
+				bFailed = true;
+				return;
+			}
+
+			std::memcpy(dst, mCurr, size);
+			mCurr += size;
+		}
+
+	private:
+		const char* mCurr;
+		const char* mEnd;
+		bool bFailed = false;
+	};
+
+	class BinaryWriter {
+	public:
+		template <typename T>
+		void Write(const T& value) {
+			WriteBytes(&value, sizeof(T));
+		}
+
+		void Write(const std::string& value) {
+			Write(static_cast<UINT>(value.size()));
+			WriteBytes(value.data(), value.size());
+		}
+
+		template <typename T>
+		void WriteArray(const std::vector<T>& values) {
+			WriteBytes(values.data(), values.size() * sizeof(T));
+		}
+
+		bool Save(const std::string& filename) const {
+			std::ofstream fout(filename, std::ios::binary | std::ios::trunc);
+			fout.write(mBuffer.data(), static_cast<std::streamsize>(mBuffer.size()));
+			return static_cast<bool>(fout);
+		}
+
+	private:
+		void WriteBytes(const void* src, size_t size) {
+			const char* bytes = static_cast<const char*>(src);
+			mBuffer.insert(mBuffer.end(), bytes, bytes + size);
+		}
+
+	private:
+		std::vector<char> mBuffer;
+	};
+
+	// On-disk layout of a keyframe; BoneAnimation keeps the members in separate streams.
+	struct BinaryKeyframe {
+		float TimePos;
+		XMFLOAT3 Translation;
+		XMFLOAT3 Scale;
+		XMFLOAT4 RotationQuat;
+	};
+}
+
+bool M3DLoader::LoadM3d(const std::string& filename,
 						std::vector<Vertex>& vertices,
 						std::vector<USHORT>& indices,
 						std::vector<Subset>& subsets,
 						std::vector<M3dMaterial>& mats) {
-	std::ifstream fin(filename);
+	M3dFile file;
+	if (!ReadM3d(filename, file))
+		return false;
+
+	vertices.resize(file.Vertices.size());
+	for (size_t i = 0, end = file.Vertices.size(); i < end; ++i) {
+		const auto& src = file.Vertices[i];
+		auto& dst = vertices[i];
+
+		dst.Pos = src.Pos;
+		dst.Normal = src.Normal;
+		dst.TexC = src.TexC;
+		dst.TangentU = src.TangentU;
+	}
 
-	UINT numMaterials = 0;
-	UINT numVertices  = 0;
-	UINT numTriangles = 0;
-	UINT numBones     = 0;
-	UINT numAnimationClips = 0;
+	CopyIndices(file, indices);
+	subsets = std::move(file.Subsets);
+	mats = std::move(file.Materials);
 
-	std::string ignore;
-
-	if (fin) {
-		fin >> ignore; // file header text
-		fin >> ignore >> numMaterials;
-		fin >> ignore >> numVertices;
-		fin >> ignore >> numTriangles;
-		fin >> ignore >> numBones;
-		fin >> ignore >> numAnimationClips;
- 
-		ReadMaterials(fin, numMaterials, mats);
-		ReadSubsetTable(fin, numMaterials, subsets);
-	    ReadVertices(fin, numVertices, vertices);
-	    ReadTriangles(fin, numTriangles, indices);
- 
-		return true;
-	 }
-    return false;
+	return true;
 }
 
-bool M3DLoader::LoadM3d(const std::string& filename, 
+bool M3DLoader::LoadM3d(const std::string& filename,
 						std::vector<SkinnedVertex>& vertices,
 						std::vector<USHORT>& indices,
 						std::vector<Subset>& subsets,
 						std::vector<M3dMaterial>& mats,
 						SkinnedData& skinInfo) {
-    std::ifstream fin(filename);
+	M3dFile file;
+	if (!ReadM3d(filename, file))
+		return false;
+
+	vertices.resize(file.Vertices.size());
+	for (size_t i = 0, end = file.Vertices.size(); i < end; ++i) {
+		const auto& src = file.Vertices[i];
+		auto& dst = vertices[i];
+
+		dst.Pos = src.Pos;
+		dst.Normal = src.Normal;
+		dst.TexC = src.TexC;
+		dst.TangentU = XMFLOAT3(src.TangentU.x, src.TangentU.y, src.TangentU.z);
+		dst.BoneWeights = XMFLOAT3(src.BoneWeights[0], src.BoneWeights[1], src.BoneWeights[2]);
+
+		for (int j = 0; j < 4; ++j)
+			dst.BoneIndices[j] = (BYTE)src.BoneIndices[j];
+	}
+
+	CopyIndices(file, indices);
+	subsets = std::move(file.Subsets);
+	mats = std::move(file.Materials);
+
+	skinInfo.Set(std::move(file.BoneHierarchy), std::move(file.BoneOffsets), std::move(file.Animations));
+
+	return true;
+}
+
+bool M3DLoader::ConvertM3dToBinary(const std::string& srcFilename, const std::string& dstFilename) {
+	M3dFile file;
+	if (!ReadM3d(srcFilename, file))
+		return false;
+
+	BinaryWriter writer;
+	writer.Write(BinaryMagic);
+	writer.Write(BinaryVersion);
+	writer.Write(file.Skinned ? (UINT)ESkinned : 0u);
+
+	writer.Write((UINT)file.Materials.size());
+	writer.Write((UINT)file.Vertices.size());
+	writer.Write((UINT)file.Indices.size());
+	writer.Write((UINT)file.BoneOffsets.size());
+	writer.Write((UINT)file.Animations.size());
+
+	for (const auto& mat : file.Materials) {
+		writer.Write(mat.Name);
+		writer.Write(mat.DiffuseAlbedo);
+		writer.Write(mat.FresnelR0);
+		writer.Write(mat.Roughness);
+		writer.Write(mat.AlphaClip ? 1u : 0u);
+		writer.Write(mat.MaterialTypeName);
+		writer.Write(mat.DiffuseMapName);
+		writer.Write(mat.NormalMapName);
+	}
+
+	writer.WriteArray(file.Subsets);
+	writer.WriteArray(file.Vertices);
+	writer.WriteArray(file.Indices);
+	writer.WriteArray(file.BoneOffsets);
+	writer.WriteArray(file.BoneHierarchy);
+
+	std::vector<BinaryKeyframe> keyframes;
+	for (const auto& anim : file.Animations) {
+		writer.Write(anim.first);
+
+		for (const auto& boneAnim : anim.second.BoneAnimations) {
+			keyframes.resize(boneAnim.GetNumKeyframes());
+			for (size_t i = 0, end = keyframes.size(); i < end; ++i) {
+				keyframes[i] = { boneAnim.TimePositions[i], boneAnim.Translations[i],
+					boneAnim.Scales[i], boneAnim.RotationQuats[i] };
+			}
+
+			writer.Write((UINT)keyframes.size());
+			writer.WriteArray(keyframes);
+		}
+	}
+
+	return writer.Save(dstFilename);
+}
+
+bool M3DLoader::ReadM3d(const std::string& filename, M3dFile& file) {
+	MappedFile mapped;
+	if (!mapped.Open(filename))
+		return false;
+
+	const char* data = reinterpret_cast<const char*>(mapped.GetData());
+	size_t size = static_cast<size_t>(mapped.GetSize());
+
+	if (size >= sizeof(BinaryMagic) && std::memcmp(data, BinaryMagic, sizeof(BinaryMagic)) == 0)
+		return ParseBinary(data, size, file);
+
+	return ParseText(data, size, file);
+}
+
+bool M3DLoader::ParseText(const char* data, size_t size, M3dFile& file) {
+	TextReader reader(data, data + size);
 
 	UINT numMaterials = 0;
 	UINT numVertices  = 0;
@@ -49,186 +251,243 @@ bool M3DLoader::LoadM3d(const std::string& filename,
 	UINT numBones     = 0;
 	UINT numAnimationClips = 0;
 
-	std::string ignore;
-
-	if (fin) {
-		fin >> ignore; // file header text
-		fin >> ignore >> numMaterials;
-		fin >> ignore >> numVertices;
-		fin >> ignore >> numTriangles;
-		fin >> ignore >> numBones;
-		fin >> ignore >> numAnimationClips;
- 
-		std::vector<XMFLOAT4X4> boneOffsets;
-		std::vector<int> boneIndexToParentIndex;
-		std::unordered_map<std::string, AnimationClip> animations;
-
-		ReadMaterials(fin, numMaterials, mats);
-		ReadSubsetTable(fin, numMaterials, subsets);
-	    ReadSkinnedVertices(fin, numVertices, vertices);
-	    ReadTriangles(fin, numTriangles, indices);
-		ReadBoneOffsets(fin, numBones, boneOffsets);
-	    ReadBoneHierarchy(fin, numBones, boneIndexToParentIndex);
-	    ReadAnimationClips(fin, numBones, numAnimationClips, animations);
- 
-		skinInfo.Set(boneIndexToParentIndex, boneOffsets, animations);
-
-	    return true;
+	reader.Skip(); // file header text
+	reader.Skip(); reader.Read(numMaterials);
+	reader.Skip(); reader.Read(numVertices);
+	reader.Skip(); reader.Read(numTriangles);
+	reader.Skip(); reader.Read(numBones);
+	reader.Skip(); reader.Read(numAnimationClips);
+
+	// Every entry takes at least a few bytes, so corrupted counts fail before allocating.
+	auto fits = [&](UINT count) { return count <= size; };
+	if (reader.Failed() || !fits(numMaterials) || !fits(numVertices) || !fits(numTriangles) ||
+			!fits(numBones) || !fits(numAnimationClips))
+		return false;
+
+	reader.Skip(); // materials header text
+	file.Materials.resize(numMaterials);
+	for (auto& mat : file.Materials) {
+		reader.Skip(); reader.Read(mat.Name);
+		reader.Skip(); reader.Read(mat.DiffuseAlbedo.x, mat.DiffuseAlbedo.y, mat.DiffuseAlbedo.z);
+		reader.Skip(); reader.Read(mat.FresnelR0.x, mat.FresnelR0.y, mat.FresnelR0.z);
+		reader.Skip(); reader.Read(mat.Roughness);
+		reader.Skip(); reader.Read(mat.AlphaClip);
+		reader.Skip(); reader.Read(mat.MaterialTypeName);
+		reader.Skip(); reader.Read(mat.DiffuseMapName);
+		reader.Skip(); reader.Read(mat.NormalMapName);
+	}
+
+	reader.Skip(); // subset header text
+	file.Subsets.resize(numMaterials);
+	for (auto& subset : file.Subsets) {
+		reader.Skip(); reader.Read(subset.Id);
+		reader.Skip(); reader.Read(subset.VertexStart);
+		reader.Skip(); reader.Read(subset.VertexCount);
+		reader.Skip(); reader.Read(subset.FaceStart);
+		reader.Skip(); reader.Read(subset.FaceCount);
 	}
-    return false;
-}
 
-void M3DLoader::ReadMaterials(std::ifstream& fin, UINT numMaterials, std::vector<M3dMaterial>& mats) {
-	 std::string ignore;
-     mats.resize(numMaterials);
+	reader.Skip(); // vertices header text
+	file.Vertices.resize(numVertices);
+	for (UINT i = 0; i < numVertices && !reader.Failed(); ++i) {
+		auto& v = file.Vertices[i];
+		reader.Skip(); reader.Read(v.Pos.x, v.Pos.y, v.Pos.z);
+		reader.Skip(); reader.Read(v.TangentU.x, v.TangentU.y, v.TangentU.z, v.TangentU.w);
+		reader.Skip(); reader.Read(v.Normal.x, v.Normal.y, v.Normal.z);
+		reader.Skip(); reader.Read(v.TexC.x, v.TexC.y);
+
+		// Skinned files carry the blend weights and indices after the texture coordinates.
+		if (i == 0)
+			file.Skinned = reader.PeekStartsWith("BlendWeights");
+
+		if (file.Skinned) {
+			reader.Skip(); reader.Read(v.BoneWeights[0], v.BoneWeights[1], v.BoneWeights[2], v.BoneWeights[3]);
+			reader.Skip(); reader.Read(v.BoneIndices[0], v.BoneIndices[1], v.BoneIndices[2], v.BoneIndices[3]);
+		}
+		else {
+			std::fill(std::begin(v.BoneWeights), std::end(v.BoneWeights), 0.0f);
+			std::fill(std::begin(v.BoneIndices), std::end(v.BoneIndices), 0);
+		}
+	}
 
-	 std::string diffuseMapName;
-	 std::string normalMapName;
+	reader.Skip(); // triangles header text
+	file.Indices.resize(static_cast<size_t>(numTriangles) * 3);
+	for (size_t i = 0, end = file.Indices.size(); i < end && !reader.Failed(); ++i)
+		reader.Read(file.Indices[i]);
+
+	if (numBones > 0 || numAnimationClips > 0) {
+		reader.Skip(); // BoneOffsets header text
+		file.BoneOffsets.resize(numBones);
+		for (auto& m : file.BoneOffsets) {
+			reader.Skip();
+			reader.Read(m(0, 0), m(0, 1), m(0, 2), m(0, 3),
+				m(1, 0), m(1, 1), m(1, 2), m(1, 3),
+				m(2, 0), m(2, 1), m(2, 2), m(2, 3),
+				m(3, 0), m(3, 1), m(3, 2), m(3, 3));
+		}
 
-     fin >> ignore; // materials header text
-	 for(UINT i = 0; i < numMaterials; ++i) {
-         fin >> ignore >> mats[i].Name;
-		 fin >> ignore >> mats[i].DiffuseAlbedo.x  >> mats[i].DiffuseAlbedo.y  >> mats[i].DiffuseAlbedo.z;
-		 fin >> ignore >> mats[i].FresnelR0.x >> mats[i].FresnelR0.y >> mats[i].FresnelR0.z;
-         fin >> ignore >> mats[i].Roughness;
-		 fin >> ignore >> mats[i].AlphaClip;
-		 fin >> ignore >> mats[i].MaterialTypeName;
-		 fin >> ignore >> mats[i].DiffuseMapName;
-		 fin >> ignore >> mats[i].NormalMapName;
+		reader.Skip(); // BoneHierarchy header text
+		file.BoneHierarchy.resize(numBones);
+		for (auto& parent : file.BoneHierarchy) {
+			reader.Skip(); reader.Read(parent);
 		}
-}
 
-void M3DLoader::ReadSubsetTable(std::ifstream& fin, UINT numSubsets, std::vector<Subset>& subsets) {
-    std::string ignore;
-	subsets.resize(numSubsets);
-
-	fin >> ignore; // subset header text
-	for(UINT i = 0; i < numSubsets; ++i) {
-        fin >> ignore >> subsets[i].Id;
-		fin >> ignore >> subsets[i].VertexStart;
-		fin >> ignore >> subsets[i].VertexCount;
-		fin >> ignore >> subsets[i].FaceStart;
-		fin >> ignore >> subsets[i].FaceCount;
-    }
-}
+		reader.Skip(); // AnimationClips header text
+		for (UINT clipIndex = 0; clipIndex < numAnimationClips && !reader.Failed(); ++clipIndex) {
+			std::string clipName;
+			reader.Skip(); reader.Read(clipName);
+			reader.Skip(); // {
 
-void M3DLoader::ReadVertices(std::ifstream& fin, UINT numVertices, std::vector<Vertex>& vertices) {
-	std::string ignore;
-    vertices.resize(numVertices);
-
-    fin >> ignore; // vertices header text
-    for(UINT i = 0; i < numVertices; ++i) {
-	    fin >> ignore >> vertices[i].Pos.x      >> vertices[i].Pos.y      >> vertices[i].Pos.z;
-		fin >> ignore >> vertices[i].TangentU.x >> vertices[i].TangentU.y >> vertices[i].TangentU.z >> vertices[i].TangentU.w;
-	    fin >> ignore >> vertices[i].Normal.x   >> vertices[i].Normal.y   >> vertices[i].Normal.z;
-	    fin >> ignore >> vertices[i].TexC.x     >> vertices[i].TexC.y;
-    }
-}
+			// Filled in place, the clips are moved into SkinnedData as they are.
+			auto& clip = file.Animations[clipName];
+			clip.BoneAnimations.resize(numBones);
 
-void M3DLoader::ReadSkinnedVertices(std::ifstream& fin, UINT numVertices, std::vector<SkinnedVertex>& vertices) {
-	std::string ignore;
-    vertices.resize(numVertices);
-
-    fin >> ignore; // vertices header text
-	int boneIndices[4];
-	float weights[4];
-    for(UINT i = 0; i < numVertices; ++i) {
-        float blah;
-	    fin >> ignore >> vertices[i].Pos.x        >> vertices[i].Pos.y          >> vertices[i].Pos.z;
-		fin >> ignore >> vertices[i].TangentU.x   >> vertices[i].TangentU.y     >> vertices[i].TangentU.z >> blah /*vertices[i].TangentU.w*/;
-	    fin >> ignore >> vertices[i].Normal.x     >> vertices[i].Normal.y       >> vertices[i].Normal.z;
-	    fin >> ignore >> vertices[i].TexC.x       >> vertices[i].TexC.y;
-		fin >> ignore >> weights[0]     >> weights[1]     >> weights[2]     >> weights[3];
-		fin >> ignore >> boneIndices[0] >> boneIndices[1] >> boneIndices[2] >> boneIndices[3];
-
-		vertices[i].BoneWeights.x = weights[0];
-		vertices[i].BoneWeights.y = weights[1];
-		vertices[i].BoneWeights.z = weights[2];
-
-		vertices[i].BoneIndices[0] = (BYTE)boneIndices[0]; 
-		vertices[i].BoneIndices[1] = (BYTE)boneIndices[1]; 
-		vertices[i].BoneIndices[2] = (BYTE)boneIndices[2]; 
-		vertices[i].BoneIndices[3] = (BYTE)boneIndices[3]; 
-    }
-}
+			for (auto& boneAnim : clip.BoneAnimations) {
+				UINT numKeyframes = 0;
+				reader.Skip(); reader.Skip(); reader.Read(numKeyframes);
+				reader.Skip(); // {
 
-void M3DLoader::ReadTriangles(std::ifstream& fin, UINT numTriangles, std::vector<USHORT>& indices) {
-	std::string ignore;
-    indices.resize(numTriangles*3);
+				if (reader.Failed() || !fits(numKeyframes))
+					return false;
 
-    fin >> ignore; // triangles header text
-    for(UINT i = 0; i < numTriangles; ++i) {
-        fin >> indices[i*3+0] >> indices[i*3+1] >> indices[i*3+2];
-    }
-}
- 
-void M3DLoader::ReadBoneOffsets(std::ifstream& fin, UINT numBones, std::vector<XMFLOAT4X4>& boneOffsets) {
-	std::string ignore;
-    boneOffsets.resize(numBones);
-
-    fin >> ignore; // BoneOffsets header text
-    for(UINT i = 0; i < numBones; ++i) {
-        fin >> ignore >> 
-            boneOffsets[i](0,0) >> boneOffsets[i](0,1) >> boneOffsets[i](0,2) >> boneOffsets[i](0,3) >>
-            boneOffsets[i](1,0) >> boneOffsets[i](1,1) >> boneOffsets[i](1,2) >> boneOffsets[i](1,3) >>
-            boneOffsets[i](2,0) >> boneOffsets[i](2,1) >> boneOffsets[i](2,2) >> boneOffsets[i](2,3) >>
-            boneOffsets[i](3,0) >> boneOffsets[i](3,1) >> boneOffsets[i](3,2) >> boneOffsets[i](3,3);
-    }
-}
+				boneAnim.Resize(numKeyframes);
+				for (UINT i = 0; i < numKeyframes; ++i) {
+					auto& translation = boneAnim.Translations[i];
+					auto& scale = boneAnim.Scales[i];
+					auto& rotationQuat = boneAnim.RotationQuats[i];
+
+					reader.Skip(); reader.Read(boneAnim.TimePositions[i]);
+					reader.Skip(); reader.Read(translation.x, translation.y, translation.z);
+					reader.Skip(); reader.Read(scale.x, scale.y, scale.z);
+					reader.Skip(); reader.Read(rotationQuat.x, rotationQuat.y, rotationQuat.z, rotationQuat.w);
+				}
 
-void M3DLoader::ReadBoneHierarchy(std::ifstream& fin, UINT numBones, std::vector<int>& boneIndexToParentIndex) {
-	std::string ignore;
-    boneIndexToParentIndex.resize(numBones);
+				reader.Skip(); // }
+			}
 
-    fin >> ignore; // BoneHierarchy header text
-	for(UINT i = 0; i < numBones; ++i) {
-	    fin >> ignore >> boneIndexToParentIndex[i];
+			reader.Skip(); // }
+		}
 	}
+
+	return !reader.Failed() && Validate(file);
 }
 
-void M3DLoader::ReadAnimationClips(std::ifstream& fin, UINT numBones, UINT numAnimationClips, 
-								   std::unordered_map<std::string, AnimationClip>& animations) {
-	std::string ignore;
-    fin >> ignore; // AnimationClips header text
-    for(UINT clipIndex = 0; clipIndex < numAnimationClips; ++clipIndex) {
-        std::string clipName;
-        fin >> ignore >> clipName;
-        fin >> ignore; // {
+bool M3DLoader::ParseBinary(const char* data, size_t size, M3dFile& file) {
+	BinaryReader reader(data, data + size);
+
+	char magic[4];
+	UINT version = 0;
+	UINT flags = 0;
+	reader.Read(magic);
+	reader.Read(version);
+	reader.Read(flags);
+
+	if (reader.Failed() || version != BinaryVersion)
+		return false;
+
+	UINT numMaterials = 0;
+	UINT numVertices = 0;
+	UINT numIndices = 0;
+	UINT numBones = 0;
+	UINT numAnimationClips = 0;
+	reader.Read(numMaterials);
+	reader.Read(numVertices);
+	reader.Read(numIndices);
+	reader.Read(numBones);
+	reader.Read(numAnimationClips);
+
+	file.Skinned = (flags & ESkinned) != 0;
+
+	if (!reader.CanRead(numMaterials, sizeof(UINT)))
+		return false;
+
+	file.Materials.resize(numMaterials);
+	for (auto& mat : file.Materials) {
+		UINT alphaClip = 0;
+		reader.Read(mat.Name);
+		reader.Read(mat.DiffuseAlbedo);
+		reader.Read(mat.FresnelR0);
+		reader.Read(mat.Roughness);
+		reader.Read(alphaClip);
+		reader.Read(mat.MaterialTypeName);
+		reader.Read(mat.DiffuseMapName);
+		reader.Read(mat.NormalMapName);
+		mat.AlphaClip = alphaClip != 0;
+	}
+
+	reader.ReadArray(file.Subsets, numMaterials);
+	reader.ReadArray(file.Vertices, numVertices);
+	reader.ReadArray(file.Indices, numIndices);
+	reader.ReadArray(file.BoneOffsets, numBones);
+	reader.ReadArray(file.BoneHierarchy, numBones);
+
+	std::vector<BinaryKeyframe> keyframes;
+	for (UINT clipIndex = 0; clipIndex < numAnimationClips && !reader.Failed(); ++clipIndex) {
+		std::string clipName;
+		reader.Read(clipName);
 
-		AnimationClip clip;
+		auto& clip = file.Animations[clipName];
 		clip.BoneAnimations.resize(numBones);
 
-        for(UINT boneIndex = 0; boneIndex < numBones; ++boneIndex) {
-            ReadBoneKeyframes(fin, numBones, clip.BoneAnimations[boneIndex]);
-        }
-        fin >> ignore; // }
+		for (auto& boneAnim : clip.BoneAnimations) {
+			UINT numKeyframes = 0;
+			reader.Read(numKeyframes);
+			reader.ReadArray(keyframes, numKeyframes);
+			if (reader.Failed())
+				return false;
+
+			boneAnim.Resize(numKeyframes);
+			for (UINT i = 0; i < numKeyframes; ++i) {
+				boneAnim.TimePositions[i] = keyframes[i].TimePos;
+				boneAnim.Translations[i] = keyframes[i].Translation;
+				boneAnim.Scales[i] = keyframes[i].Scale;
+				boneAnim.RotationQuats[i] = keyframes[i].RotationQuat;
+			}
+		}
+	}
+
+	return !reader.Failed() && Validate(file);
+}
+
+bool M3DLoader::Validate(const M3dFile& file) {
+	const size_t numVertices = file.Vertices.size();
+	const size_t numTriangles = file.Indices.size() / 3;
+	const size_t numBones = file.BoneHierarchy.size();
+
+	// The indices are copied to 16 bits.
+	for (auto index : file.Indices) {
+		if (index >= numVertices || index > 0xffff)
+			return false;
+	}
+
+	for (const auto& subset : file.Subsets) {
+		if (static_cast<size_t>(subset.VertexStart) + subset.VertexCount > numVertices ||
+				static_cast<size_t>(subset.FaceStart) + subset.FaceCount > numTriangles)
+			return false;
+	}
+
+	// The bone indices are copied to 8 bits.
+	if (file.Skinned) {
+		for (const auto& v : file.Vertices) {
+			for (int index : v.BoneIndices) {
+				if (index < 0 || static_cast<size_t>(index) >= numBones || index > 0xff)
+					return false;
+			}
+		}
+	}
+
+	// The bones are transformed to the root space in order, so a parent has to come before its children.
+	for (size_t i = 1; i < numBones; ++i) {
+		int parent = file.BoneHierarchy[i];
+		if (parent < 0 || static_cast<size_t>(parent) >= i)
+			return false;
+	}
 
-        animations[clipName] = clip;
-    }
+	return true;
 }
 
-void M3DLoader::ReadBoneKeyframes(std::ifstream& fin, UINT numBones, BoneAnimation& boneAnimation) {
-	std::string ignore;
-    UINT numKeyframes = 0;
-    fin >> ignore >> ignore >> numKeyframes;
-    fin >> ignore; // {
-
-    boneAnimation.Keyframes.resize(numKeyframes);
-    for(UINT i = 0; i < numKeyframes; ++i) {
-        float t    = 0.0f;
-        XMFLOAT3 p(0.0f, 0.0f, 0.0f);
-        XMFLOAT3 s(1.0f, 1.0f, 1.0f);
-        XMFLOAT4 q(0.0f, 0.0f, 0.0f, 1.0f);
-        fin >> ignore >> t;
-        fin >> ignore >> p.x >> p.y >> p.z;
-        fin >> ignore >> s.x >> s.y >> s.z;
-        fin >> ignore >> q.x >> q.y >> q.z >> q.w;
-
-	    boneAnimation.Keyframes[i].TimePos      = t;
-        boneAnimation.Keyframes[i].Translation  = p;
-	    boneAnimation.Keyframes[i].Scale        = s;
-	    boneAnimation.Keyframes[i].RotationQuat = q;
-    }
-
-    fin >> ignore; // }
+void M3DLoader::CopyIndices(const M3dFile& file, std::vector<USHORT>& indices) {
+	indices.resize(file.Indices.size());
+	for (size_t i = 0, end = file.Indices.size(); i < end; ++i)
+		indices[i] = (USHORT)file.Indices[i];
 }
\ No newline at end of file
@@ -1,71 +1,83 @@
 #include "SkinnedMesh/SkinnedData.h"
 
-using namespace DirectX;
+#include <execution>
 
-Keyframe::Keyframe()
-	: TimePos(0.0f),
-	Translation(0.0f, 0.0f, 0.0f),
-	Scale(1.0f, 1.0f, 1.0f),
-	RotationQuat(0.0f, 0.0f, 0.0f, 1.0f) {
+using namespace DirectX;
 
-}
+namespace {
+	// Local and then root-space bone transforms of the pose being built, per thread so the batches don't allocate.
+	thread_local std::vector<XMFLOAT4X4> tBoneTransforms;
 
-Keyframe::~Keyframe() {
+	XMMATRIX ComposeKey(XMVECTOR S, XMVECTOR Q, XMVECTOR P) {
+		XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+		return XMMatrixAffineTransformation(S, zero, Q, P);
+	}
 }
  
 float BoneAnimation::GetStartTime() const {
 	// Keyframes are sorted by time, so first keyframe gives start time.
-	return Keyframes.front().TimePos;
+	return TimePositions.front();
 }
 
 float BoneAnimation::GetEndTime() const {
 	// Keyframes are sorted by time, so last keyframe gives end time.
-	float f = Keyframes.back().TimePos;
+	float f = TimePositions.back();
 
 	return f;
 }
 
+UINT BoneAnimation::GetNumKeyframes() const {
+	return (UINT)TimePositions.size();
+}
+
+void BoneAnimation::Resize(UINT numKeyframes) {
+	TimePositions.resize(numKeyframes, 0.0f);
+	Translations.resize(numKeyframes, XMFLOAT3(0.0f, 0.0f, 0.0f));
+	Scales.resize(numKeyframes, XMFLOAT3(1.0f, 1.0f, 1.0f));
+	RotationQuats.resize(numKeyframes, XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+}
+
 void BoneAnimation::Interpolate(float t, XMFLOAT4X4& M) const {
-	if( t <= Keyframes.front().TimePos ) {
-		XMVECTOR S = XMLoadFloat3(&Keyframes.front().Scale);
-		XMVECTOR P = XMLoadFloat3(&Keyframes.front().Translation);
-		XMVECTOR Q = XMLoadFloat4(&Keyframes.front().RotationQuat);
+	UINT keyIndex = 0;
+	Interpolate(t, M, keyIndex);
+}
 
-		XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
-		XMStoreFloat4x4(&M, XMMatrixAffineTransformation(S, zero, Q, P));
+void BoneAnimation::Interpolate(float t, XMFLOAT4X4& M, UINT& keyIndex) const {
+	if( t <= TimePositions.front() ) {
+		XMVECTOR S = XMLoadFloat3(&Scales.front());
+		XMVECTOR P = XMLoadFloat3(&Translations.front());
+		XMVECTOR Q = XMLoadFloat4(&RotationQuats.front());
+
+		XMStoreFloat4x4(&M, ComposeKey(S, Q, P));
+		keyIndex = 0;
 	}
-	else if( t >= Keyframes.back().TimePos ) {
-		XMVECTOR S = XMLoadFloat3(&Keyframes.back().Scale);
-		XMVECTOR P = XMLoadFloat3(&Keyframes.back().Translation);
-		XMVECTOR Q = XMLoadFloat4(&Keyframes.back().RotationQuat);
+	else if( t >= TimePositions.back() ) {
+		XMVECTOR S = XMLoadFloat3(&Scales.back());
+		XMVECTOR P = XMLoadFloat3(&Translations.back());
+		XMVECTOR Q = XMLoadFloat4(&RotationQuats.back());
 
-		XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
-		XMStoreFloat4x4(&M, XMMatrixAffineTransformation(S, zero, Q, P));
+		XMStoreFloat4x4(&M, ComposeKey(S, Q, P));
 	}
 	else {
-		for(UINT i = 0; i < Keyframes.size()-1; ++i) {
-			if( t >= Keyframes[i].TimePos && t <= Keyframes[i+1].TimePos ) {
-				float lerpPercent = (t - Keyframes[i].TimePos) / (Keyframes[i+1].TimePos - Keyframes[i].TimePos);
+		UINT i = MathHelper::FindKeyframe(TimePositions.data(), GetNumKeyframes(), t, keyIndex);
+		keyIndex = i;
 
-				XMVECTOR s0 = XMLoadFloat3(&Keyframes[i].Scale);
-				XMVECTOR s1 = XMLoadFloat3(&Keyframes[i+1].Scale);
+		float lerpPercent = (t - TimePositions[i]) / (TimePositions[i+1] - TimePositions[i]);
 
-				XMVECTOR p0 = XMLoadFloat3(&Keyframes[i].Translation);
-				XMVECTOR p1 = XMLoadFloat3(&Keyframes[i+1].Translation);
+		XMVECTOR s0 = XMLoadFloat3(&Scales[i]);
+		XMVECTOR s1 = XMLoadFloat3(&Scales[i+1]);
 
-				XMVECTOR q0 = XMLoadFloat4(&Keyframes[i].RotationQuat);
-				XMVECTOR q1 = XMLoadFloat4(&Keyframes[i+1].RotationQuat);
+		XMVECTOR p0 = XMLoadFloat3(&Translations[i]);
+		XMVECTOR p1 = XMLoadFloat3(&Translations[i+1]);
 
-				XMVECTOR S = XMVectorLerp(s0, s1, lerpPercent);
-				XMVECTOR P = XMVectorLerp(p0, p1, lerpPercent);
-				XMVECTOR Q = XMQuaternionSlerp(q0, q1, lerpPercent);
+		XMVECTOR q0 = XMLoadFloat4(&RotationQuats[i]);
+		XMVECTOR q1 = XMLoadFloat4(&RotationQuats[i+1]);
 
-				XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
-				XMStoreFloat4x4(&M, XMMatrixAffineTransformation(S, zero, Q, P));
+		XMVECTOR S = XMVectorLerp(s0, s1, lerpPercent);
+		XMVECTOR P = XMVectorLerp(p0, p1, lerpPercent);
+		XMVECTOR Q = XMQuaternionSlerp(q0, q1, lerpPercent);
 
-				break;
-			}
-		}
+		XMStoreFloat4x4(&M, ComposeKey(S, Q, P));
 	}
 }
 
@@ -95,6 +107,15 @@ void AnimationClip::Interpolate(float t, std::vector<XMFLOAT4X4>& boneTransforms
 	}
 }
 
+void AnimationClip::Interpolate(float t, XMFLOAT4X4* boneTransforms, AnimationCursor& cursor) const {
+	if (cursor.KeyIndices.size() < BoneAnimations.size())
+		cursor.KeyIndices.resize(BoneAnimations.size(), 0);
+
+	for(UINT i = 0; i < BoneAnimations.size(); ++i) {
+		BoneAnimations[i].Interpolate(t, boneTransforms[i], cursor.KeyIndices[i]);
+	}
+}
+
 float SkinnedData::GetClipStartTime(const std::string& clipName) const {
 	auto clip = mAnimations.find(clipName);
 	return clip->second.GetClipStartTime();
@@ -105,6 +126,15 @@ float SkinnedData::GetClipEndTime(const std::string& clipName) const {
 	return clip->second.GetClipEndTime();
 }
 
+float SkinnedData::GetClipEndTime(ClipHandle clip) const {
+	return mClips[clip]->GetClipEndTime();
+}
+
+ClipHandle SkinnedData::FindClip(const std::string& clipName) const {
+	auto iter = mClipHandles.find(clipName);
+	return iter != mClipHandles.cend() ? iter->second : InvalidClipHandle;
+}
+
 UINT SkinnedData::BoneCount() const {
 	return (UINT)mBoneHierarchy.size();
 }
@@ -115,44 +145,78 @@ void SkinnedData::Set(std::vector<int>& boneHierarchy,
 	mBoneHierarchy = boneHierarchy;
 	mBoneOffsets   = boneOffsets;
 	mAnimations    = animations;
+
+	BuildClipHandles();
+}
+
+void SkinnedData::Set(std::vector<int>&& boneHierarchy,
+		              std::vector<XMFLOAT4X4>&& boneOffsets,
+		              std::unordered_map<std::string, AnimationClip>&& animations) {
+	mBoneHierarchy = std::move(boneHierarchy);
+	mBoneOffsets   = std::move(boneOffsets);
+	mAnimations    = std::move(animations);
+
+	BuildClipHandles();
 }
  
 void SkinnedData::GetFinalTransforms(const std::string& clipName, float timePos,  std::vector<XMFLOAT4X4>& finalTransforms) const {
+	AnimationCursor cursor;
+	GetFinalTransforms(FindClip(clipName), timePos, finalTransforms.data(), cursor);
+}
+
+void SkinnedData::GetFinalTransforms(ClipHandle clip, float timePos,
+		XMFLOAT4X4* finalTransforms, AnimationCursor& cursor) const {
+	if (clip >= mClips.size())
+		return;
+
 	UINT numBones = (UINT)mBoneOffsets.size();
 
-	std::vector<XMFLOAT4X4> toParentTransforms(numBones);
+	if (tBoneTransforms.size() < numBones)
+		tBoneTransforms.resize(numBones);
+	XMFLOAT4X4* boneTransforms = tBoneTransforms.data();
 
 	// Interpolate all the bones of this clip at the given time instance.
-	auto clip = mAnimations.find(clipName);
-	clip->second.Interpolate(timePos, toParentTransforms);
+	mClips[clip]->Interpolate(timePos, boneTransforms, cursor);
 
 	//
 	// Traverse the hierarchy and transform all the bones to the root space.
+	// A parent comes before its children, so the to-parent transforms are replaced in place.
 	//
 
-	std::vector<XMFLOAT4X4> toRootTransforms(numBones);
-
 	// The root bone has index 0.  The root bone has no parent, so its toRootTransform
 	// is just its local bone transform.
-	toRootTransforms[0] = toParentTransforms[0];
-
-	// Now find the toRootTransform of the children.
 	for(UINT i = 1; i < numBones; ++i) {
-		XMMATRIX toParent = XMLoadFloat4x4(&toParentTransforms[i]);
+		XMMATRIX toParent = XMLoadFloat4x4(&boneTransforms[i]);
 
 		int parentIndex = mBoneHierarchy[i];
-		XMMATRIX parentToRoot = XMLoadFloat4x4(&toRootTransforms[parentIndex]);
+		XMMATRIX parentToRoot = XMLoadFloat4x4(&boneTransforms[parentIndex]);
 
 		XMMATRIX toRoot = XMMatrixMultiply(toParent, parentToRoot);
 
-		XMStoreFloat4x4(&toRootTransforms[i], toRoot);
+		XMStoreFloat4x4(&boneTransforms[i], toRoot);
 	}
 
 	// Premultiply by the bone offset transform to get the final transform.
 	for(UINT i = 0; i < numBones; ++i) {
 		XMMATRIX offset = XMLoadFloat4x4(&mBoneOffsets[i]);
-		XMMATRIX toRoot = XMLoadFloat4x4(&toRootTransforms[i]);
+		XMMATRIX toRoot = XMLoadFloat4x4(&boneTransforms[i]);
         XMMATRIX finalTransform = XMMatrixMultiply(offset, toRoot);
 		XMStoreFloat4x4(&finalTransforms[i], XMMatrixTranspose(finalTransform));
 	}
+}
+
+void SkinnedData::GetFinalTransforms(const std::vector<SkinnedPoseJob>& jobs) const {
+	std::for_each(std::execution::par, jobs.cbegin(), jobs.cend(), [this](const SkinnedPoseJob& job) {
+		GetFinalTransforms(job.Clip, job.TimePos, job.FinalTransforms, *job.Cursor);
+	});
+}
+
+void SkinnedData::BuildClipHandles() {
+	mClips.clear();
+	mClipHandles.clear();
+
+	for (const auto& anim : mAnimations) {
+		mClipHandles.emplace(anim.first, (ClipHandle)mClips.size());
+		mClips.push_back(&anim.second);
+	}
 }
\ No newline at end of file
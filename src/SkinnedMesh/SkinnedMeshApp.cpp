@@ -1,5 +1,7 @@
 #include "SkinnedMesh/SkinnedMeshApp.h"
 
+#include <filesystem>
+
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 using namespace DirectX::PackedVector;
@@ -1026,13 +1028,27 @@ void SkinnedMeshApp::LoadSkinnedModel() {
 	std::vector<std::uint16_t> indices;
 
 	M3DLoader m3dLoader;
-	m3dLoader.LoadM3d(mSkinnedModelFilename, vertices, indices,
-		mSkinnedSubsets, mSkinnedMats, mSkinnedInfo);
+
+	// The text model is converted once into a binary file next to it,
+	//  which is loaded instead as long as it is newer than the text one.
+	std::string binaryFilename = mSkinnedModelFilename + "b";
+	std::error_code textError;
+	std::error_code binaryError;
+	auto textTime = std::filesystem::last_write_time(mSkinnedModelFilename, textError);
+	auto binaryTime = std::filesystem::last_write_time(binaryFilename, binaryError);
+	if (!textError && (binaryError || binaryTime < textTime))
+		m3dLoader.ConvertM3dToBinary(mSkinnedModelFilename, binaryFilename);
+
+	if (!m3dLoader.LoadM3d(binaryFilename, vertices, indices,
+			mSkinnedSubsets, mSkinnedMats, mSkinnedInfo)) {
+		m3dLoader.LoadM3d(mSkinnedModelFilename, vertices, indices,
+			mSkinnedSubsets, mSkinnedMats, mSkinnedInfo);
+	}
 
 	mSkinnedModelInst = std::make_unique<SkinnedModelInstance>();
 	mSkinnedModelInst->SkinnedInfo = &mSkinnedInfo;
 	mSkinnedModelInst->FinalTransforms.resize(mSkinnedInfo.BoneCount());
-	mSkinnedModelInst->ClipName = "Take1";
+	mSkinnedModelInst->Clip = mSkinnedInfo.FindClip("Take1");
 	mSkinnedModelInst->TimePos = 0.0f;
 
 	const UINT vbByteSize = (UINT)vertices.size() * sizeof(SkinnedVertex);
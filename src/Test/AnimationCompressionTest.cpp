@@ -0,0 +1,218 @@
+#include "Test/TestCase.h"
+#include "DX12Game/AnimationCompression.h"
+#include "DX12Game/SkinnedData.h"
+
+#include <cmath>
+
+using namespace DirectX;
+using namespace Game;
+
+namespace {
+	const size_t NumFrames = 120;
+
+	XMFLOAT4X4 BuildTransform(FXMVECTOR inRotation, FXMVECTOR inTranslation) {
+		XMFLOAT4X4 transform;
+		XMStoreFloat4x4(&transform,
+			XMMatrixMultiply(XMMatrixRotationQuaternion(inRotation), XMMatrixTranslationFromVector(inTranslation)));
+		return transform;
+	}
+
+	//* Track 0 stays at the identity, track 1 is a constant offset, track 2 turns about the y axis
+	//*  while it slides along x, and track 3 bobs along y.
+	void BuildClip(Animation& outAnimation) {
+		outAnimation.mNumFrames = NumFrames;
+		outAnimation.mDuration = static_cast<float>(NumFrames - 1) / 30.0f;
+		outAnimation.mFrameDuration = 1.0f / 30.0f;
+		outAnimation.mCurves.assign(4, std::vector<XMFLOAT4X4>(NumFrames));
+
+		XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+		for (size_t frame = 0; frame < NumFrames; ++frame) {
+			float f = static_cast<float>(frame);
+
+			outAnimation.mCurves[0][frame] = MathHelper::Identity4x4();
+			outAnimation.mCurves[1][frame] = BuildTransform(XMQuaternionIdentity(), XMVectorSet(1.0f, 2.0f, 3.0f, 1.0f));
+			outAnimation.mCurves[2][frame] = BuildTransform(
+				XMQuaternionRotationAxis(up, 0.02f * f), XMVectorSet(0.05f * f, 0.0f, 0.0f, 1.0f));
+			outAnimation.mCurves[3][frame] = BuildTransform(
+				XMQuaternionIdentity(), XMVectorSet(0.0f, 0.5f * std::sin(0.2f * f), 0.0f, 1.0f));
+		}
+	}
+
+	float MaxDifference(const XMFLOAT4X4& inA, const XMFLOAT4X4& inB) {
+		float diff = 0.0f;
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col)
+				diff = std::max(diff, std::abs(inA.m[row][col] - inB.m[row][col]));
+		}
+		return diff;
+	}
+}
+
+TEST_CASE(AnimationCompression_ClassifiesChannels) {
+	Animation anim;
+	BuildClip(anim);
+
+	AnimationCompressionSettings settings;
+	CompressedAnimation compressed;
+	TEST_CHECK(compressed.Compress(anim, settings));
+	TEST_CHECK(!compressed.IsEmpty());
+	TEST_CHECK(compressed.GetNumTracks() == 4 && compressed.GetNumFrames() == NumFrames);
+
+	const auto& stats = compressed.GetStatistics();
+	TEST_CHECK(stats.mNumDefaultChannels == 8);
+	TEST_CHECK(stats.mNumConstantChannels == 1);
+	TEST_CHECK(stats.mNumAnimatedChannels == 3);
+
+	// The key reduction drops most of the keys of the linear slide and the steady turn.
+	TEST_CHECK(stats.mNumSourceKeys == 3 * NumFrames);
+	TEST_CHECK(stats.mNumKeys < stats.mNumSourceKeys / 2);
+
+	TEST_CHECK(stats.mRawBytes == 4 * NumFrames * sizeof(XMFLOAT4X4));
+	TEST_CHECK(stats.mCompressedBytes == compressed.GetByteSize());
+	TEST_CHECK(stats.mCompressedBytes * 10 < stats.mRawBytes);
+}
+
+TEST_CASE(AnimationCompression_StaysWithinTolerance) {
+	Animation anim;
+	BuildClip(anim);
+
+	AnimationCompressionSettings settings;
+	CompressedAnimation compressed;
+	TEST_CHECK(compressed.Compress(anim, settings));
+
+	// Tolerance of the key reduction plus the quantization step.
+	const float maxError = 0.005f;
+	TEST_CHECK(compressed.GetStatistics().mMaxError <= maxError);
+
+	std::vector<XMFLOAT4X4> pose(compressed.GetNumTracks());
+	for (size_t frame = 0; frame < NumFrames; ++frame) {
+		compressed.SamplePose(static_cast<float>(frame), pose.data());
+		for (size_t track = 0; track < pose.size(); ++track)
+			TEST_CHECK(MaxDifference(pose[track], anim.mCurves[track][frame]) <= maxError);
+	}
+
+	// Between the baked frames the slide keeps going; past the end the pose is clamped.
+	compressed.SamplePose(10.5f, pose.data());
+	TEST_CHECK_NEAR(pose[2]._41, 0.05f * 10.5f, maxError);
+
+	compressed.SamplePose(static_cast<float>(NumFrames + 10), pose.data());
+	TEST_CHECK(MaxDifference(pose[2], anim.mCurves[2][NumFrames - 1]) <= maxError);
+}
+
+TEST_CASE(AnimationCompression_ReplacesReleasedCurves) {
+	Animation anim;
+	BuildClip(anim);
+
+	Animation released;
+	released.mNumFrames = anim.mNumFrames;
+	TEST_CHECK(released.mCompressed.Compress(anim, AnimationCompressionSettings()));
+	TEST_CHECK(released.GetNumTracks() == anim.GetNumTracks());
+
+	std::vector<XMFLOAT4X4> source(anim.GetNumTracks());
+	std::vector<XMFLOAT4X4> decompressed(released.GetNumTracks());
+	for (size_t frame = 0; frame < NumFrames; frame += 7) {
+		anim.GetFrame(frame, source.data());
+		released.GetFrame(frame, decompressed.data());
+		for (size_t track = 0; track < source.size(); ++track)
+			TEST_CHECK(MaxDifference(source[track], decompressed[track]) <= 0.005f);
+	}
+}
+
+TEST_CASE(AnimationCompression_RejectsBrokenClips) {
+	Animation anim;
+	BuildClip(anim);
+
+	CompressedAnimation compressed;
+	TEST_CHECK(compressed.Compress(anim, AnimationCompressionSettings()));
+
+	// A failed compression also drops the previous result.
+	anim.mCurves[3].pop_back();
+	TEST_CHECK(!compressed.Compress(anim, AnimationCompressionSettings()));
+	TEST_CHECK(compressed.IsEmpty());
+
+	Animation empty;
+	empty.mNumFrames = 0;
+	TEST_CHECK(!compressed.Compress(empty, AnimationCompressionSettings()));
+
+	// Key frames are 16-bit indices.
+	Animation tooLong;
+	tooLong.mNumFrames = 0x10001;
+	tooLong.mCurves.assign(1, std::vector<XMFLOAT4X4>(tooLong.mNumFrames, MathHelper::Identity4x4()));
+	TEST_CHECK(!compressed.Compress(tooLong, AnimationCompressionSettings()));
+	TEST_CHECK(compressed.IsEmpty());
+}
+
+TEST_CASE(AnimationCompression_RejectsShear) {
+	Animation anim;
+	BuildClip(anim);
+
+	// The decomposition drops the shear, so the measured error exceeds the limit and the raw curves stay.
+	for (size_t frame = 0; frame < NumFrames; ++frame)
+		anim.mCurves[2][frame]._21 = 0.3f;
+
+	AnimationCompressionSettings settings;
+	CompressedAnimation compressed;
+	TEST_CHECK(!compressed.Compress(anim, settings));
+	TEST_CHECK(compressed.IsEmpty());
+	TEST_CHECK(compressed.GetStatistics().mMaxError > settings.mMaxError);
+	TEST_CHECK(compressed.GetStatistics().mMaxErrorTrack == 2);
+
+	// A looser limit accepts the same clip.
+	settings.mMaxError = 1.0f;
+	TEST_CHECK(compressed.Compress(anim, settings));
+}
+
+TEST_CASE(AnimationCompression_AssignsStoredClip) {
+	Animation anim;
+	BuildClip(anim);
+
+	CompressedAnimation compressed;
+	TEST_CHECK(compressed.Compress(anim, AnimationCompressionSettings()));
+
+	// The arrays the cooked container stores restore the same clip.
+	CompressedAnimation restored;
+	TEST_CHECK(restored.Assign(static_cast<std::uint32_t>(compressed.GetNumTracks()), static_cast<std::uint32_t>(compressed.GetNumFrames()),
+		compressed.GetChannels(), compressed.GetKeyFrames(), compressed.GetKeyData(), compressed.GetStatistics().mMaxError));
+	TEST_CHECK(restored.GetByteSize() == compressed.GetByteSize());
+	TEST_CHECK(restored.GetStatistics().mNumKeys == compressed.GetStatistics().mNumKeys);
+	TEST_CHECK(restored.GetStatistics().mMaxError == compressed.GetStatistics().mMaxError);
+
+	std::vector<XMFLOAT4X4> expected(compressed.GetNumTracks());
+	std::vector<XMFLOAT4X4> pose(restored.GetNumTracks());
+	for (float frame = 0.0f; frame < static_cast<float>(NumFrames); frame += 2.5f) {
+		compressed.SamplePose(frame, expected.data());
+		restored.SamplePose(frame, pose.data());
+		for (size_t track = 0; track < pose.size(); ++track)
+			TEST_CHECK(MaxDifference(pose[track], expected[track]) == 0.0f);
+	}
+
+	auto assignBroken = [&](std::vector<CompressedAnimation::Channel> inChannels, std::vector<std::uint16_t> inKeyFrames) {
+		std::vector<std::uint16_t> keyData(inKeyFrames.size() * 3);
+		return restored.Assign(static_cast<std::uint32_t>(compressed.GetNumTracks()), static_cast<std::uint32_t>(NumFrames),
+			std::move(inChannels), std::move(inKeyFrames), std::move(keyData), 0.0f);
+	};
+
+	// The bobbing track has keys in between its ends.
+	size_t animated = 0;
+	while (compressed.GetChannels()[animated].mMode != CompressedAnimation::EAnimated || compressed.GetChannels()[animated].mNumKeys < 3)
+		++animated;
+
+	// Keys past the array, a key past the clip and keys out of order are rejected.
+	auto channels = compressed.GetChannels();
+	channels[animated].mNumKeys = static_cast<std::uint32_t>(compressed.GetKeyFrames().size()) + 1;
+	TEST_CHECK(!assignBroken(channels, compressed.GetKeyFrames()));
+	TEST_CHECK(restored.IsEmpty());
+
+	auto keyFrames = compressed.GetKeyFrames();
+	keyFrames[compressed.GetChannels()[animated].mFirstKey + compressed.GetChannels()[animated].mNumKeys - 1] = NumFrames;
+	TEST_CHECK(!assignBroken(compressed.GetChannels(), keyFrames));
+
+	keyFrames = compressed.GetKeyFrames();
+	std::swap(keyFrames[compressed.GetChannels()[animated].mFirstKey + 1], keyFrames[compressed.GetChannels()[animated].mFirstKey + 2]);
+	TEST_CHECK(!assignBroken(compressed.GetChannels(), keyFrames));
+
+	// The channel count must match the tracks.
+	channels = compressed.GetChannels();
+	channels.pop_back();
+	TEST_CHECK(!assignBroken(channels, compressed.GetKeyFrames()));
+}
\ No newline at end of file
@@ -0,0 +1,417 @@
+#include "Test/TestCase.h"
+#include "DX12Game/AnimationGraph.h"
+#include "DX12Game/SkinnedData.h"
+
+#include <cmath>
+#include <memory>
+
+using namespace Game;
+
+namespace {
+	const float FrameDuration = 1.0f / 30.0f;
+
+	//* The graph only reads the durations of the clips; nothing is sampled without a CPU pose output.
+	void AddClip(SkinnedData& outSkinnedData, const std::string& inName, float inDuration) {
+		auto& anim = outSkinnedData.mAnimations[inName];
+		anim.mFrameDuration = FrameDuration;
+		anim.mDuration = inDuration;
+		anim.mNumFrames = static_cast<size_t>(inDuration / FrameDuration + 0.5f);
+	}
+
+	//* idle 2s, walk 1s, run 0.5s, sprint 0.25s, wave 1s and nod 1s; the clip indices follow that order.
+	void BuildClips(SkinnedData& outSkinnedData) {
+		AddClip(outSkinnedData, "idle", 2.0f);
+		AddClip(outSkinnedData, "walk", 1.0f);
+		AddClip(outSkinnedData, "run", 0.5f);
+		AddClip(outSkinnedData, "sprint", 0.25f);
+		AddClip(outSkinnedData, "wave", 1.0f);
+		AddClip(outSkinnedData, "nod", 1.0f);
+	}
+
+	std::uint32_t GetClipIndex(const std::string& inClipName) {
+		const char* names[] = { "idle", "walk", "run", "sprint", "wave", "nod" };
+		for (std::uint32_t i = 0; i < 6; ++i) {
+			if (inClipName == names[i])
+				return i;
+		}
+		return 0xFFFFFFFF;
+	}
+
+	void Bind(AnimationGraph& ioGraph, const SkinnedData& inSkinnedData) {
+		ioGraph.Bind(&inSkinnedData, GetClipIndex);
+	}
+
+	//* Weight of the clip in the terms; 0 if none of them samples it.
+	float GetWeight(const std::vector<PoseTerm>& inTerms, std::uint32_t inClipIndex) {
+		float weight = 0.0f;
+		for (const auto& term : inTerms) {
+			if (term.mClipIndex == inClipIndex)
+				weight += term.mWeight;
+		}
+		return weight;
+	}
+
+	//* The additive terms come in pairs summing to 0, so the weights of a pose always sum up to 1.
+	float SumWeights(const std::vector<PoseTerm>& inTerms) {
+		float sum = 0.0f;
+		for (const auto& term : inTerms)
+			sum += term.mWeight;
+		return sum;
+	}
+}
+
+TEST_CASE(AnimationGraph_CrossfadeWeightsSumToOne) {
+	SkinnedData skinnedData;
+	BuildClips(skinnedData);
+
+	AnimationGraph graph;
+	auto walk = graph.AddClip("walk");
+	auto run = graph.AddClip("run");
+	Bind(graph, skinnedData);
+
+	graph.Play(walk);
+	graph.Evaluate(0.1f);
+	TEST_CHECK(graph.GetTerms().size() == 1);
+	TEST_CHECK(graph.GetTerms()[0].mClipIndex == 1 && graph.GetTerms()[0].mWeight == 1.0f);
+
+	graph.Play(run, 0.4f);
+	TEST_CHECK(graph.GetCurrentMotion() == run);
+
+	for (int frame = 1; frame <= 3; ++frame) {
+		graph.Evaluate(0.1f);
+
+		const auto& terms = graph.GetTerms();
+		TEST_CHECK(terms.size() == 2);
+		TEST_CHECK_NEAR(GetWeight(terms, 2), frame * 0.25f, 1e-5f);
+		TEST_CHECK_NEAR(GetWeight(terms, 1), 1.0f - frame * 0.25f, 1e-5f);
+		TEST_CHECK_NEAR(SumWeights(terms), 1.0f, 1e-5f);
+	}
+
+	// The fade is over; only the new motion is left.
+	graph.Evaluate(0.2f);
+	TEST_CHECK(graph.GetTerms().size() == 1 && graph.GetTerms()[0].mClipIndex == 2);
+	TEST_CHECK(graph.GetTerms()[0].mWeight == 1.0f);
+
+	// Without a fade the switch is immediate, and playing the current motion again doesn't restart it.
+	graph.Play(walk, 0.0f);
+	graph.Evaluate(0.1f);
+	TEST_CHECK(graph.GetTerms().size() == 1 && graph.GetTerms()[0].mClipIndex == 1);
+
+	graph.Play(walk, 0.5f);
+	graph.Evaluate(0.1f);
+	TEST_CHECK(graph.GetTerms().size() == 1);
+	TEST_CHECK_NEAR(graph.GetTerms()[0].mTimePos, 0.2f / FrameDuration, 1e-3f);
+}
+
+TEST_CASE(AnimationGraph_BlendSpace1DWeights) {
+	SkinnedData skinnedData;
+	BuildClips(skinnedData);
+
+	AnimationGraph graph;
+	auto speed = graph.AddParameter("speed");
+	TEST_CHECK(graph.AddParameter("speed", 5.0f) == speed);
+	TEST_CHECK(graph.FindParameter("speed") == speed && graph.FindParameter("turn") == AnimationGraph::InvalidParameter);
+
+	// Added out of order; the samples are kept sorted by threshold.
+	auto locomotion = graph.AddBlendSpace1D(speed);
+	TEST_CHECK(graph.AddBlendSpace1DSample(locomotion, graph.AddClip("sprint"), 3.0f));
+	TEST_CHECK(graph.AddBlendSpace1DSample(locomotion, graph.AddClip("walk"), 0.0f));
+	TEST_CHECK(graph.AddBlendSpace1DSample(locomotion, graph.AddClip("run"), 1.0f));
+	Bind(graph, skinnedData);
+	graph.Play(locomotion);
+
+	struct Expected {
+		float mSpeed;
+		float mWeights[3];
+	};
+	const Expected cases[] = {
+		{ -1.0f, { 1.0f, 0.0f, 0.0f } },
+		{ 0.0f, { 1.0f, 0.0f, 0.0f } },
+		{ 0.25f, { 0.75f, 0.25f, 0.0f } },
+		{ 1.0f, { 0.0f, 1.0f, 0.0f } },
+		{ 2.5f, { 0.0f, 0.25f, 0.75f } },
+		{ 5.0f, { 0.0f, 0.0f, 1.0f } }
+	};
+
+	for (const auto& expected : cases) {
+		graph.SetParameter(speed, expected.mSpeed);
+		TEST_CHECK(graph.GetParameter(speed) == expected.mSpeed);
+		graph.Evaluate(0.0f);
+
+		const auto& terms = graph.GetTerms();
+		for (std::uint32_t i = 0; i < 3; ++i)
+			TEST_CHECK_NEAR(GetWeight(terms, i + 1), expected.mWeights[i], 1e-5f);
+		TEST_CHECK_NEAR(SumWeights(terms), 1.0f, 1e-5f);
+	}
+}
+
+TEST_CASE(AnimationGraph_BlendedClipsStayInPhase) {
+	SkinnedData skinnedData;
+	BuildClips(skinnedData);
+
+	AnimationGraph graph;
+	auto speed = graph.AddParameter("speed", 0.5f);
+	auto locomotion = graph.AddBlendSpace1D(speed);
+	graph.AddBlendSpace1DSample(locomotion, graph.AddClip("walk"), 0.0f);
+	graph.AddBlendSpace1DSample(locomotion, graph.AddClip("run"), 1.0f);
+	Bind(graph, skinnedData);
+	graph.Play(locomotion);
+
+	// The blend lasts 0.5 * 1s + 0.5 * 0.5s; both clips are half way through after 0.375s.
+	graph.Evaluate(0.375f);
+	TEST_CHECK_NEAR(graph.GetTerms()[0].mTimePos * FrameDuration, 0.5f, 1e-4f);
+	TEST_CHECK_NEAR(graph.GetTerms()[1].mTimePos * FrameDuration, 0.25f, 1e-4f);
+
+	// The phase wraps around.
+	graph.Evaluate(0.75f);
+	TEST_CHECK_NEAR(graph.GetTerms()[0].mTimePos * FrameDuration, 0.5f, 1e-4f);
+}
+
+TEST_CASE(AnimationGraph_BlendSpace2DWeights) {
+	SkinnedData skinnedData;
+	BuildClips(skinnedData);
+
+	AnimationGraph graph;
+	auto x = graph.AddParameter("x");
+	auto y = graph.AddParameter("y");
+
+	auto directions = graph.AddBlendSpace2D(x, y);
+	graph.AddBlendSpace2DSample(directions, graph.AddClip("idle"), 1.0f, 0.0f);
+	graph.AddBlendSpace2DSample(directions, graph.AddClip("walk"), -1.0f, 0.0f);
+	graph.AddBlendSpace2DSample(directions, graph.AddClip("run"), 0.0f, 1.0f);
+	graph.AddBlendSpace2DSample(directions, graph.AddClip("sprint"), 0.0f, -1.0f);
+	Bind(graph, skinnedData);
+	graph.Play(directions);
+
+	// The centre is as far from every sample.
+	graph.Evaluate(0.0f);
+	for (std::uint32_t i = 0; i < 4; ++i)
+		TEST_CHECK_NEAR(GetWeight(graph.GetTerms(), i), 0.25f, 1e-5f);
+
+	// On a sample, it takes the whole weight.
+	graph.SetParameter(y, 1.0f);
+	graph.Evaluate(0.0f);
+	TEST_CHECK(graph.GetTerms().size() == 1);
+	TEST_CHECK_NEAR(GetWeight(graph.GetTerms(), 2), 1.0f, 1e-5f);
+
+	// Off the samples; the bands give 0.7, 0.1, 0.3 and 0.1 before the weights are normalized.
+	graph.SetParameter(x, 0.6f);
+	graph.SetParameter(y, 0.2f);
+	graph.Evaluate(0.0f);
+	const auto& terms = graph.GetTerms();
+	TEST_CHECK_NEAR(GetWeight(terms, 0), 0.7f / 1.2f, 1e-5f);
+	TEST_CHECK_NEAR(GetWeight(terms, 1), 0.1f / 1.2f, 1e-5f);
+	TEST_CHECK_NEAR(GetWeight(terms, 2), 0.3f / 1.2f, 1e-5f);
+	TEST_CHECK_NEAR(GetWeight(terms, 3), 0.1f / 1.2f, 1e-5f);
+	TEST_CHECK_NEAR(SumWeights(terms), 1.0f, 1e-5f);
+}
+
+TEST_CASE(AnimationGraph_UnboundClipsContributeNothing) {
+	SkinnedData skinnedData;
+	BuildClips(skinnedData);
+
+	AnimationGraph graph;
+	auto speed = graph.AddParameter("speed", 0.5f);
+	auto locomotion = graph.AddBlendSpace1D(speed);
+	graph.AddBlendSpace1DSample(locomotion, graph.AddClip("walk"), 0.0f);
+	graph.AddBlendSpace1DSample(locomotion, graph.AddClip("crawl"), 1.0f);
+	Bind(graph, skinnedData);
+	graph.Play(locomotion);
+
+	// The missing clip's weight goes to the other one.
+	graph.Evaluate(0.0f);
+	TEST_CHECK(graph.GetTerms().size() == 1);
+	TEST_CHECK(graph.GetTerms()[0].mClipIndex == 1 && graph.GetTerms()[0].mWeight == 1.0f);
+
+	// Unbound, the graph has nothing to sample.
+	graph.Bind(nullptr, nullptr);
+	graph.Evaluate(0.0f);
+	TEST_CHECK(graph.GetTerms().empty() && graph.GetGpuTerms().empty());
+}
+
+TEST_CASE(AnimationGraph_AddsAdditivePairs) {
+	SkinnedData skinnedData;
+	BuildClips(skinnedData);
+
+	AnimationGraph graph;
+	auto walk = graph.AddClip("walk");
+	auto wave = graph.AddClip("wave");
+	Bind(graph, skinnedData);
+	graph.Play(walk);
+
+	auto layer = graph.AddAdditiveLayer(wave, 0.5f);
+	TEST_CHECK(layer == 0);
+
+	graph.Evaluate(0.25f);
+	const auto& terms = graph.GetTerms();
+	TEST_CHECK(terms.size() == 3);
+
+	// The motion keeps its whole weight; the layer is its clip less the first frame of it.
+	TEST_CHECK(terms[0].mClipIndex == 1 && terms[0].mWeight == 1.0f);
+	TEST_CHECK(terms[1].mClipIndex == 4 && terms[1].mWeight == 0.5f);
+	TEST_CHECK_NEAR(terms[1].mTimePos * FrameDuration, 0.25f, 1e-4f);
+	TEST_CHECK(terms[2].mClipIndex == 4 && terms[2].mWeight == -0.5f && terms[2].mTimePos == 0.0f);
+	TEST_CHECK_NEAR(SumWeights(terms), 1.0f, 1e-5f);
+
+	// A layer without weight adds nothing, but keeps its phase going.
+	graph.SetLayerWeight(layer, 0.0f);
+	graph.Evaluate(0.25f);
+	TEST_CHECK(graph.GetTerms().size() == 1);
+
+	graph.SetLayerWeight(layer, 1.0f);
+	graph.Evaluate(0.25f);
+	TEST_CHECK(graph.GetTerms().size() == 3);
+	TEST_CHECK_NEAR(graph.GetTerms()[1].mTimePos * FrameDuration, 0.75f, 1e-4f);
+}
+
+TEST_CASE(AnimationGraph_CapsGpuTerms) {
+	SkinnedData skinnedData;
+	BuildClips(skinnedData);
+
+	AnimationGraph graph;
+	auto speed = graph.AddParameter("speed", 0.5f);
+	auto locomotion = graph.AddBlendSpace1D(speed);
+	graph.AddBlendSpace1DSample(locomotion, graph.AddClip("walk"), 0.0f);
+	graph.AddBlendSpace1DSample(locomotion, graph.AddClip("run"), 1.0f);
+	auto idle = graph.AddClip("idle");
+	auto layer = graph.AddAdditiveLayer(graph.AddClip("wave"), 0.3f);
+	Bind(graph, skinnedData);
+
+	// A quarter into the fade: idle 0.25, walk 0.375, run 0.375 and the pair of the layer.
+	graph.Play(locomotion);
+	graph.Play(idle, 0.4f);
+	graph.Evaluate(0.1f);
+	TEST_CHECK(graph.GetTerms().size() == 5);
+	TEST_CHECK_NEAR(SumWeights(graph.GetTerms()), 1.0f, 1e-5f);
+
+	// The pair outweighs idle, so idle is dropped and the pair is kept whole.
+	{
+		const auto& gpuTerms = graph.GetGpuTerms();
+		TEST_CHECK(gpuTerms.size() == AnimationGraph::MaxGpuTerms);
+		TEST_CHECK(GetWeight(gpuTerms, 0) == 0.0f);
+		TEST_CHECK_NEAR(GetWeight(gpuTerms, 1), 0.5f, 1e-5f);
+		TEST_CHECK_NEAR(GetWeight(gpuTerms, 2), 0.5f, 1e-5f);
+		TEST_CHECK(gpuTerms[2].mClipIndex == 4 && gpuTerms[2].mWeight == 0.3f);
+		TEST_CHECK(gpuTerms[3].mClipIndex == 4 && gpuTerms[3].mWeight == -0.3f);
+		TEST_CHECK_NEAR(SumWeights(gpuTerms), 1.0f, 1e-5f);
+	}
+
+	// A lighter pair doesn't fit next to the three motion terms; neither of its terms is kept alone.
+	graph.SetLayerWeight(layer, 0.2f);
+	graph.Play(locomotion, 0.0f);
+	graph.Play(idle, 0.4f);
+	graph.Evaluate(0.1f);
+	{
+		const auto& gpuTerms = graph.GetGpuTerms();
+		TEST_CHECK(gpuTerms.size() == 3);
+		TEST_CHECK(GetWeight(gpuTerms, 4) == 0.0f);
+		TEST_CHECK_NEAR(GetWeight(gpuTerms, 0), 0.25f, 1e-5f);
+		TEST_CHECK_NEAR(SumWeights(gpuTerms), 1.0f, 1e-5f);
+	}
+
+	// Within the cap, the GPU takes the terms as they are.
+	graph.SetLayerWeight(layer, 0.0f);
+	graph.Evaluate(0.1f);
+	TEST_CHECK(graph.GetTerms().size() == 3);
+	TEST_CHECK(graph.GetGpuTerms().size() == 3);
+}
+
+TEST_CASE(AnimationGraph_RejectsCycles) {
+	AnimationGraph graph;
+	auto speed = graph.AddParameter("speed");
+	auto walk = graph.AddClip("walk");
+	auto outer = graph.AddBlendSpace1D(speed);
+	auto inner = graph.AddBlendSpace2D(speed, speed);
+	auto innermost = graph.AddBlendSpace1D(speed);
+
+	TEST_CHECK(graph.AddBlendSpace1DSample(outer, inner, 0.0f));
+	TEST_CHECK(graph.AddBlendSpace2DSample(inner, innermost, 0.0f, 0.0f));
+	TEST_CHECK(graph.AddBlendSpace1DSample(innermost, walk, 0.0f));
+
+	// A node can't be its own descendant, directly or through others.
+	TEST_CHECK(!graph.AddBlendSpace1DSample(outer, outer, 1.0f));
+	TEST_CHECK(!graph.AddBlendSpace2DSample(inner, outer, 1.0f, 1.0f));
+	TEST_CHECK(!graph.AddBlendSpace1DSample(innermost, outer, 1.0f));
+
+	// Shared children are fine.
+	TEST_CHECK(graph.AddBlendSpace1DSample(outer, innermost, 1.0f));
+	TEST_CHECK(graph.AddBlendSpace1DSample(outer, walk, 2.0f));
+
+	// Wrong node types and unknown nodes.
+	TEST_CHECK(!graph.AddBlendSpace1DSample(walk, innermost, 0.0f));
+	TEST_CHECK(!graph.AddBlendSpace2DSample(outer, walk, 0.0f, 0.0f));
+	TEST_CHECK(!graph.AddBlendSpace1DSample(outer, 100, 0.0f));
+	TEST_CHECK(!graph.AddBlendSpace1DSample(AnimationGraph::InvalidNode, walk, 0.0f));
+
+	// The accepted graph still evaluates to its only clip.
+	SkinnedData skinnedData;
+	BuildClips(skinnedData);
+	Bind(graph, skinnedData);
+	graph.Play(outer);
+	graph.Evaluate(0.1f);
+	TEST_CHECK(graph.GetTerms().size() == 1 && graph.GetTerms()[0].mWeight == 1.0f);
+}
+
+TEST_CASE(AnimationGraphBatch_MatchesSerialEvaluation) {
+	SkinnedData skinnedData;
+	BuildClips(skinnedData);
+
+	const size_t numGraphs = 200;
+
+	std::unique_ptr<AnimationGraph> batched[numGraphs];
+	std::unique_ptr<AnimationGraph> serial[numGraphs];
+	for (auto graphs : { batched, serial }) {
+		for (size_t i = 0; i < numGraphs; ++i) {
+			graphs[i] = std::make_unique<AnimationGraph>();
+			auto& graph = *graphs[i];
+
+			auto speed = graph.AddParameter("speed", static_cast<float>(i % 7) * 0.5f);
+			auto locomotion = graph.AddBlendSpace1D(speed);
+			graph.AddBlendSpace1DSample(locomotion, graph.AddClip("walk"), 0.0f);
+			graph.AddBlendSpace1DSample(locomotion, graph.AddClip("run"), 1.0f);
+			graph.AddBlendSpace1DSample(locomotion, graph.AddClip("sprint"), 3.0f);
+			graph.AddAdditiveLayer(graph.AddClip("nod"), static_cast<float>(i % 3) * 0.25f);
+			auto idle = graph.AddClip("idle");
+			Bind(graph, skinnedData);
+
+			graph.Play(idle);
+			graph.Evaluate(0.0f);
+			graph.Play(locomotion, 0.1f * static_cast<float>(1 + i % 5));
+		}
+	}
+
+	AnimationGraphBatch batch;
+	for (auto& graph : batched)
+		batch.Add(graph.get());
+	// Adding a graph twice doesn't evaluate it twice.
+	batch.Add(batched[0].get());
+
+	for (int frame = 0; frame < 10; ++frame) {
+		batch.Evaluate(1.0f / 60.0f);
+		for (auto& graph : serial)
+			graph->Evaluate(1.0f / 60.0f);
+
+		for (size_t i = 0; i < numGraphs; ++i) {
+			const auto& lhs = batched[i]->GetTerms();
+			const auto& rhs = serial[i]->GetTerms();
+			TEST_CHECK(lhs.size() == rhs.size());
+			for (size_t t = 0; t < lhs.size() && t < rhs.size(); ++t) {
+				TEST_CHECK(lhs[t].mClipIndex == rhs[t].mClipIndex);
+				TEST_CHECK(lhs[t].mWeight == rhs[t].mWeight && lhs[t].mTimePos == rhs[t].mTimePos);
+			}
+			TEST_CHECK(batched[i]->GetGpuTerms().size() <= AnimationGraph::MaxGpuTerms);
+		}
+	}
+
+	auto stats = batch.GetStatistics();
+	TEST_CHECK(stats.mNumGraphs == numGraphs);
+	TEST_CHECK(stats.mMaxGraphTime >= stats.mAverageGraphTime && stats.mAverageGraphTime >= 0.0f);
+
+	// A removed graph is left as it was.
+	batch.Remove(batched[5].get());
+	batch.Remove(batched[5].get());
+	auto timePos = batched[5]->GetTerms()[0].mTimePos;
+	batch.Evaluate(0.1f);
+	TEST_CHECK(batch.GetStatistics().mNumGraphs == numGraphs - 1);
+	TEST_CHECK(batched[5]->GetTerms()[0].mTimePos == timePos);
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "Test/TestCase.h"
+#include "DX12Game/AnimationLod.h"
+#include "DX12Game/SkinnedData.h"
+
+#include <cmath>
+
+using namespace Game;
+
+namespace {
+	//* 0 root, 1 spine, 2 hand, 3 finger, 4 thumb, 5 fingertip, 6 head:
+	//*  0 - 1 - 2 - 3 - 5
+	//*       \   \- 4
+	//*        \- 6
+	void BuildSkeleton(Skeleton& outSkeleton) {
+		const int parents[] = { -1, 0, 1, 2, 2, 3, 1 };
+		for (int parent : parents) {
+			Bone bone;
+			bone.ParentIndex = parent;
+			outSkeleton.mBones.push_back(bone);
+		}
+	}
+}
+
+TEST_CASE(AnimationLod_BuildsBoneMasks) {
+	Skeleton skeleton;
+	BuildSkeleton(skeleton);
+
+	std::vector<std::uint32_t> remap;
+	TEST_CHECK(AnimationLod::BuildBoneMask(skeleton, 0, remap) == 0);
+	TEST_CHECK((remap == std::vector<std::uint32_t>{ 0, 1, 2, 3, 4, 5, 6 }));
+
+	// The leaves follow their parents.
+	TEST_CHECK(AnimationLod::BuildBoneMask(skeleton, 1, remap) == 3);
+	TEST_CHECK((remap == std::vector<std::uint32_t>{ 0, 1, 2, 3, 2, 3, 1 }));
+
+	// A masked bone takes its nearest kept ancestor, not its parent.
+	TEST_CHECK(AnimationLod::BuildBoneMask(skeleton, 2, remap) == 4);
+	TEST_CHECK((remap == std::vector<std::uint32_t>{ 0, 1, 2, 2, 2, 2, 1 }));
+
+	TEST_CHECK(AnimationLod::BuildBoneMask(skeleton, 3, remap) == 5);
+	TEST_CHECK((remap == std::vector<std::uint32_t>{ 0, 1, 1, 1, 1, 1, 1 }));
+
+	// The root is always kept.
+	TEST_CHECK(AnimationLod::BuildBoneMask(skeleton, 100, remap) == 6);
+	TEST_CHECK((remap == std::vector<std::uint32_t>{ 0, 0, 0, 0, 0, 0, 0 }));
+}
+
+TEST_CASE(AnimationLod_BoneMaskSurvivesBrokenHierarchy) {
+	// A cycle and a parent index past the bones; the walks are bounded and every bone maps to a bone.
+	Skeleton skeleton;
+	for (int parent : { 1, 0, 42 }) {
+		Bone bone;
+		bone.ParentIndex = parent;
+		skeleton.mBones.push_back(bone);
+	}
+
+	std::vector<std::uint32_t> remap;
+	AnimationLod::BuildBoneMask(skeleton, 2, remap);
+	TEST_CHECK(remap.size() == 3);
+	for (auto bone : remap)
+		TEST_CHECK(bone < 3);
+	TEST_CHECK(remap[2] == 2);
+}
+
+TEST_CASE(AnimationLod_SharesBoneMasks) {
+	SkinnedData skinnedData;
+	BuildSkeleton(skinnedData.mSkeleton);
+
+	AnimationLod lod;
+
+	// The first two default levels don't mask any bone.
+	TEST_CHECK(lod.GetBoneMask(&skinnedData, 0) == nullptr);
+	TEST_CHECK(lod.GetBoneMask(&skinnedData, 1) == nullptr);
+	TEST_CHECK(lod.GetBoneMask(nullptr, 3) == nullptr);
+
+	auto mask = lod.GetBoneMask(&skinnedData, 2);
+	TEST_CHECK(mask != nullptr && mask->size() == skinnedData.mSkeleton.mBones.size());
+	TEST_CHECK(lod.GetBoneMask(&skinnedData, 2) == mask);
+
+	auto coarser = lod.GetBoneMask(&skinnedData, 3);
+	TEST_CHECK(coarser != nullptr && coarser != mask);
+	TEST_CHECK((*coarser)[3] == 2);
+}
+
+TEST_CASE(AnimationLod_SelectsLevelWithHysteresis) {
+	AnimationLod lod;
+
+	TEST_CHECK(AnimationLod::ComputeScreenSize(1.0f, 0.5f, 1.0f) == 1.0f);
+	TEST_CHECK_NEAR(AnimationLod::ComputeScreenSize(1.0f, 10.0f, 2.0f * std::atan(0.5f)), 0.2f, 1e-5f);
+
+	TEST_CHECK(lod.SelectLevel(1.0f, 3) == 0);
+	TEST_CHECK(lod.SelectLevel(0.2f, 0) == 1);
+	TEST_CHECK(lod.SelectLevel(0.05f, 0) == 2);
+	TEST_CHECK(lod.SelectLevel(0.0f, 0) == 3);
+
+	// Coarsening is immediate; refining needs the screen size past the threshold by the hysteresis.
+	TEST_CHECK(lod.SelectLevel(0.26f, 1) == 1);
+	TEST_CHECK(lod.SelectLevel(0.28f, 1) == 0);
+	TEST_CHECK(lod.SelectLevel(0.105f, 2) == 2);
+	TEST_CHECK(lod.SelectLevel(0.115f, 2) == 1);
+	TEST_CHECK(lod.SelectLevel(0.24f, 0) == 1);
+}
+
+TEST_CASE(AnimationLod_StaggersUpdates) {
+	AnimationLod lod;
+
+	std::uint32_t slots[8];
+	for (auto& slot : slots)
+		slot = lod.Register();
+	TEST_CHECK(slots[0] == 0 && slots[7] == 7);
+
+	// The third level updates every four frames; the crowd spreads evenly over them.
+	const std::uint32_t interval = lod.GetLevel(2).mUpdateInterval;
+	TEST_CHECK(interval == 4);
+
+	std::uint32_t numUpdates[8] = {};
+	for (std::uint32_t frame = 0; frame < 2 * interval; ++frame) {
+		std::uint32_t numUpdated = 0;
+		for (std::uint32_t i = 0; i < 8; ++i) {
+			if (lod.ShouldUpdate(slots[i], 2)) {
+				++numUpdated;
+				++numUpdates[i];
+			}
+		}
+		TEST_CHECK(numUpdated == 2);
+
+		// A full detail character and a forced update are always taken.
+		TEST_CHECK(lod.ShouldUpdate(slots[0], 0));
+		TEST_CHECK(lod.ShouldUpdate(slots[1], 3, true));
+
+		lod.BeginFrame();
+
+		auto stats = lod.GetStatistics();
+		TEST_CHECK(stats.mNumSkeletons == 10);
+		TEST_CHECK(stats.mNumUpdated == 4 && stats.mNumSkipped == 6);
+		TEST_CHECK(stats.mNumPerLevel[0] == 1 && stats.mNumPerLevel[2] == 8 && stats.mNumPerLevel[3] == 1);
+	}
+
+	for (auto num : numUpdates)
+		TEST_CHECK(num == 2);
+
+	// Nothing ticked since the last frame.
+	lod.BeginFrame();
+	TEST_CHECK(lod.GetStatistics().mNumSkeletons == 0);
+}
+
+TEST_CASE(AnimationLod_ClampsLevels) {
+	AnimationLod lod;
+
+	lod.SetLevel(1, { 0.2f, 0, 1 });
+	TEST_CHECK(lod.GetLevel(1).mUpdateInterval == 1);
+	TEST_CHECK(lod.GetLevel(1).mMaskedLeafLevels == 1);
+
+	// Out-of-range levels are ignored on write and clamped to the last one on read.
+	lod.SetLevel(AnimationLod::MaxLevels, { 1.0f, 16, 0 });
+	TEST_CHECK(lod.GetLevel(AnimationLod::MaxLevels).mUpdateInterval == lod.GetLevel(AnimationLod::MaxLevels - 1).mUpdateInterval);
+	TEST_CHECK(lod.GetLevel(AnimationLod::MaxLevels - 1).mUpdateInterval == 8);
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "Test/TestCase.h"
+#include "DX12Game/AnimationsAtlas.h"
+
+#include <random>
+#include <utility>
+
+using namespace Game;
+
+namespace {
+	//* The dirty ranges must be sorted, non-empty and separated by at least one clean line.
+	bool AreDirtyRangesMerged(const AnimationsAtlas& inAtlas) {
+		const auto& ranges = inAtlas.GetDirtyRanges();
+		for (size_t i = 0; i < ranges.size(); ++i) {
+			if (ranges[i].mBegin >= ranges[i].mEnd || ranges[i].mEnd > inAtlas.GetNumLines())
+				return false;
+			if (i > 0 && ranges[i - 1].mEnd >= ranges[i].mBegin)
+				return false;
+		}
+		return true;
+	}
+}
+
+TEST_CASE(AnimationsAtlas_AllocatesAndReusesLines) {
+	AnimationsAtlas atlas;
+	atlas.Initialize(100);
+
+	auto walk = atlas.Allocate(30);
+	auto run = atlas.Allocate(30);
+	auto idle = atlas.Allocate(30);
+	TEST_CHECK(walk == 0 && run == 30 && idle == 60);
+	TEST_CHECK(atlas.GetAllocationSize(run) == 30);
+
+	// Out of lines; the map isn't overrun.
+	TEST_CHECK(atlas.Allocate(11) == AnimationsAtlas::InvalidLine);
+	TEST_CHECK(atlas.Allocate(0) == AnimationsAtlas::InvalidLine);
+
+	TEST_CHECK(atlas.Free(run));
+	TEST_CHECK(!atlas.Free(run));
+	TEST_CHECK(!atlas.Free(walk + 1));
+	TEST_CHECK(atlas.GetAllocationSize(run) == 0);
+
+	// The hole left by the removed clip can't hold a longer one.
+	TEST_CHECK(atlas.Allocate(31) == AnimationsAtlas::InvalidLine);
+
+	// Best fit: a short clip takes the tail, so the hole stays whole.
+	TEST_CHECK(atlas.Allocate(5) == 90);
+	TEST_CHECK(atlas.Allocate(30) == 30);
+
+	auto stats = atlas.GetStatistics();
+	TEST_CHECK(stats.mNumLines == 100);
+	TEST_CHECK(stats.mNumUsedLines == 95);
+	TEST_CHECK(stats.mNumAllocations == 4);
+	TEST_CHECK(stats.mLargestFreeSpan == 5);
+}
+
+TEST_CASE(AnimationsAtlas_MergesFreeSpans) {
+	AnimationsAtlas atlas;
+	atlas.Initialize(40);
+
+	AnimationsAtlas::Line lines[4];
+	for (auto& line : lines)
+		line = atlas.Allocate(10);
+
+	// Freed out of order; the neighbouring spans merge on both sides.
+	TEST_CHECK(atlas.Free(lines[0]));
+	TEST_CHECK(atlas.Free(lines[2]));
+	TEST_CHECK(atlas.GetStatistics().mLargestFreeSpan == 10);
+
+	TEST_CHECK(atlas.Free(lines[1]));
+	TEST_CHECK(atlas.GetStatistics().mLargestFreeSpan == 30);
+
+	TEST_CHECK(atlas.Free(lines[3]));
+	TEST_CHECK(atlas.GetStatistics().mLargestFreeSpan == 40);
+	TEST_CHECK(atlas.GetStatistics().mNumUsedLines == 0);
+
+	TEST_CHECK(atlas.Allocate(40) == 0);
+}
+
+TEST_CASE(AnimationsAtlas_TracksDirtyRanges) {
+	AnimationsAtlas atlas;
+	atlas.Initialize(100);
+
+	atlas.Allocate(10);
+	atlas.Allocate(20);
+	TEST_CHECK(atlas.GetDirtyRanges().size() == 1);
+	TEST_CHECK(atlas.GetDirtyRanges()[0].mBegin == 0 && atlas.GetDirtyRanges()[0].mEnd == 30);
+
+	atlas.ClearDirty();
+	TEST_CHECK(atlas.GetDirtyRanges().empty());
+	TEST_CHECK(atlas.GetStatistics().mNumDirtyLines == 0);
+
+	atlas.MarkDirty(50, 60);
+	atlas.MarkDirty(10, 20);
+	atlas.MarkDirty(70, 80);
+	TEST_CHECK(atlas.GetDirtyRanges().size() == 3);
+	TEST_CHECK(atlas.GetDirtyRanges()[0].mBegin == 10);
+
+	// Touching and overlapping ranges merge; a range spanning several swallows them.
+	atlas.MarkDirty(60, 65);
+	TEST_CHECK(atlas.GetDirtyRanges().size() == 3 && atlas.GetDirtyRanges()[1].mEnd == 65);
+
+	atlas.MarkDirty(15, 75);
+	TEST_CHECK(atlas.GetDirtyRanges().size() == 1);
+	TEST_CHECK(atlas.GetDirtyRanges()[0].mBegin == 10 && atlas.GetDirtyRanges()[0].mEnd == 80);
+
+	// Empty ranges are ignored and the end is clamped to the map.
+	atlas.MarkDirty(90, 90);
+	atlas.MarkDirty(95, 200);
+	TEST_CHECK(atlas.GetDirtyRanges().size() == 2 && atlas.GetDirtyRanges()[1].mEnd == 100);
+	TEST_CHECK(atlas.GetStatistics().mNumDirtyLines == 75);
+}
+
+TEST_CASE(AnimationsAtlas_RandomClipsNeverOverlap) {
+	const AnimationsAtlas::Line numLines = 2048;
+
+	AnimationsAtlas atlas;
+	atlas.Initialize(numLines);
+
+	// Line -> index of the live clip holding it, or -1.
+	std::vector<int> owners(numLines, -1);
+	std::vector<std::pair<AnimationsAtlas::Line, AnimationsAtlas::Line>> clips;
+
+	std::mt19937 rng(1);
+	for (int i = 0; i < 20000; ++i) {
+		if (rng() % 3 != 0) {
+			AnimationsAtlas::Line numFrames = 1 + rng() % 120;
+			auto first = atlas.Allocate(numFrames);
+			if (first != AnimationsAtlas::InvalidLine) {
+				TEST_CHECK(first + numFrames <= numLines);
+				for (auto line = first; line < first + numFrames; ++line) {
+					TEST_CHECK(owners[line] == -1);
+					owners[line] = i;
+				}
+				clips.emplace_back(first, numFrames);
+			}
+		}
+		else if (!clips.empty()) {
+			size_t index = rng() % clips.size();
+			auto clip = clips[index];
+			TEST_CHECK(atlas.Free(clip.first));
+			for (auto line = clip.first; line < clip.first + clip.second; ++line)
+				owners[line] = -1;
+			clips.erase(clips.begin() + index);
+		}
+
+		if (i % 50 == 0) {
+			TEST_CHECK(AreDirtyRangesMerged(atlas));
+			atlas.ClearDirty();
+			atlas.MarkDirty(rng() % numLines, rng() % numLines);
+		}
+	}
+
+	AnimationsAtlas::Line numUsed = 0;
+	for (const auto& clip : clips)
+		numUsed += clip.second;
+
+	auto stats = atlas.GetStatistics();
+	TEST_CHECK(stats.mNumUsedLines == numUsed);
+	TEST_CHECK(stats.mNumAllocations == clips.size());
+}
\ No newline at end of file
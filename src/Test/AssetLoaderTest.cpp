@@ -0,0 +1,197 @@
+#include "Test/TestCase.h"
+#include "DX12Game/AssetLoader.h"
+#include "common/MappedFile.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+using namespace Game;
+
+namespace {
+	const std::uint32_t NumFiles = 8;
+
+	std::string GetAssetFileName(std::uint32_t inIndex) {
+		return (std::filesystem::temp_directory_path() / ("AssetLoaderTest_" + std::to_string(inIndex) + ".bin")).string();
+	}
+
+	std::uint8_t GetAssetByte(std::uint32_t inIndex, size_t inOffset) {
+		return static_cast<std::uint8_t>(inIndex * 31 + inOffset * 7);
+	}
+
+	size_t GetAssetSize(std::uint32_t inIndex) {
+		return 4096 * (inIndex + 1);
+	}
+
+	void WriteAssetFiles() {
+		for (std::uint32_t i = 0; i < NumFiles; ++i) {
+			std::vector<char> bytes(GetAssetSize(i));
+			for (size_t j = 0, end = bytes.size(); j < end; ++j)
+				bytes[j] = static_cast<char>(GetAssetByte(i, j));
+
+			std::ofstream file(GetAssetFileName(i), std::ios::binary | std::ios::trunc);
+			file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+		}
+	}
+
+	void RemoveAssetFiles() {
+		for (std::uint32_t i = 0; i < NumFiles; ++i)
+			std::filesystem::remove(GetAssetFileName(i));
+	}
+
+	//* Stands in for a mesh: decoded on a worker, then "uploaded" on the owner thread.
+	struct FileAsset {
+		std::uint32_t mIndex = 0;
+		std::vector<std::uint8_t> mDecoded;
+		bool bUploaded = false;
+	};
+
+	AssetRequest BuildFileRequest(FileAsset& ioAsset, const std::string& inFileName, int inPriority,
+			std::vector<std::uint32_t>& outUploadOrder) {
+		AssetRequest request;
+		request.mKey = inFileName;
+		request.mPriority = inPriority;
+		request.mLoad = [&ioAsset, inFileName](std::uint64_t& outUploadBytes) -> bool {
+			MappedFile file;
+			if (!file.Open(inFileName))
+				return false;
+
+			ioAsset.mDecoded.assign(file.GetData(), file.GetData() + file.GetSize());
+			for (size_t i = 0, end = ioAsset.mDecoded.size(); i < end; ++i) {
+				if (ioAsset.mDecoded[i] != GetAssetByte(ioAsset.mIndex, i))
+					return false;
+			}
+
+			outUploadBytes = ioAsset.mDecoded.size();
+			return true;
+		};
+		request.mUpload = [&ioAsset, &outUploadOrder]() -> bool {
+			ioAsset.bUploaded = true;
+			outUploadOrder.push_back(ioAsset.mIndex);
+			return true;
+		};
+
+		return request;
+	}
+
+	bool WaitForReady(const AssetLoader& inLoader, std::uint32_t inNumReady) {
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (inLoader.GetStatistics().mNumReady < inNumReady) {
+			if (std::chrono::steady_clock::now() > deadline)
+				return false;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		return true;
+	}
+}
+
+TEST_CASE(AssetLoader_LoadsFilesAndUploadsByPriority) {
+	WriteAssetFiles();
+
+	AssetLoader loader;
+	loader.Initialize(3);
+
+	std::vector<FileAsset> assets(NumFiles + 1);
+	std::vector<std::uint32_t> uploadOrder;
+	std::vector<int> results(NumFiles + 1, -1);
+
+	for (std::uint32_t i = 0; i < NumFiles; ++i) {
+		assets[i].mIndex = i;
+		loader.Request(BuildFileRequest(assets[i], GetAssetFileName(i), static_cast<int>(i), uploadOrder),
+			[&results, i](bool inSucceeded) { results[i] = inSucceeded ? 1 : 0; });
+	}
+
+	// A file that doesn't exist fails its callback instead of stalling the queue.
+	assets[NumFiles].mIndex = NumFiles;
+	loader.Request(BuildFileRequest(assets[NumFiles], GetAssetFileName(NumFiles), -1, uploadOrder),
+		[&results](bool inSucceeded) { results[NumFiles] = inSucceeded ? 1 : 0; });
+
+	// Joins the load of the first file and raises it over the others.
+	int numJoined = 0;
+	TEST_CHECK(!loader.Request(BuildFileRequest(assets[0], GetAssetFileName(0), 100, uploadOrder),
+		[&numJoined](bool inSucceeded) { if (inSucceeded) ++numJoined; }));
+
+	TEST_CHECK(WaitForReady(loader, NumFiles + 1));
+
+	// The budget is smaller than any file, so each pump completes exactly one asset.
+	std::uint64_t totalBytes = 0;
+	for (std::uint32_t i = 0; i < NumFiles; ++i) {
+		TEST_CHECK(loader.Pump(1) == 1);
+		totalBytes += GetAssetSize(i);
+	}
+	TEST_CHECK(loader.Pump(1) == 1);
+	TEST_CHECK(loader.Pump(1) == 0);
+	TEST_CHECK(loader.IsIdle());
+
+	std::vector<std::uint32_t> expectedOrder = { 0 };
+	for (std::uint32_t i = NumFiles - 1; i > 0; --i)
+		expectedOrder.push_back(i);
+	TEST_CHECK(uploadOrder == expectedOrder);
+
+	for (std::uint32_t i = 0; i < NumFiles; ++i) {
+		TEST_CHECK(results[i] == 1);
+		TEST_CHECK(assets[i].bUploaded && assets[i].mDecoded.size() == GetAssetSize(i));
+	}
+	TEST_CHECK(results[NumFiles] == 0 && !assets[NumFiles].bUploaded);
+	TEST_CHECK(numJoined == 1);
+
+	auto stats = loader.GetStatistics();
+	TEST_CHECK(stats.mNumDeduplicated == 1);
+	TEST_CHECK(stats.mNumCompleted == NumFiles + 1);
+	TEST_CHECK(stats.mNumFailed == 1);
+	TEST_CHECK(stats.mUploadedBytes == totalBytes);
+
+	loader.CleanUp();
+	RemoveAssetFiles();
+}
+
+TEST_CASE(AssetLoader_PumpSpreadsUploadsOverTheBudget) {
+	AssetLoader loader;
+	loader.Initialize(2);
+
+	const std::uint32_t numAssets = 10;
+	std::uint32_t numUploaded = 0;
+	for (std::uint32_t i = 0; i < numAssets; ++i) {
+		AssetRequest request;
+		request.mKey = "asset" + std::to_string(i);
+		request.mLoad = [](std::uint64_t& outUploadBytes) -> bool {
+			outUploadBytes = 1000;
+			return true;
+		};
+		request.mUpload = [&numUploaded]() -> bool {
+			++numUploaded;
+			return true;
+		};
+		loader.Request(request, nullptr);
+	}
+
+	AssetRequest throwing;
+	throwing.mKey = "throwing";
+	// Uploaded after the others, so it doesn't count against the budget below.
+	throwing.mPriority = -1;
+	throwing.mLoad = [](std::uint64_t&) -> bool { throw std::runtime_error("decode failed"); };
+	bool throwingSucceeded = true;
+	loader.Request(throwing, [&throwingSucceeded](bool inSucceeded) { throwingSucceeded = inSucceeded; });
+
+	TEST_CHECK(WaitForReady(loader, numAssets + 1));
+
+	// 2500 bytes take three assets of 1000 bytes(the last one crosses the budget).
+	TEST_CHECK(loader.Pump(2500) == 3);
+
+	auto callerThread = std::this_thread::get_id();
+	std::thread::id callbackThread;
+	loader.Request({ "late", 0, nullptr, nullptr }, [&callbackThread](bool) { callbackThread = std::this_thread::get_id(); });
+
+	loader.Flush();
+	TEST_CHECK(loader.IsIdle());
+	TEST_CHECK(numUploaded == numAssets);
+	TEST_CHECK(!throwingSucceeded);
+	TEST_CHECK(callbackThread == callerThread);
+
+	auto stats = loader.GetStatistics();
+	TEST_CHECK(stats.mNumCompleted == numAssets + 2);
+	TEST_CHECK(stats.mNumFailed == 1);
+	TEST_CHECK(stats.mUploadedBytes == numAssets * 1000);
+}
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "Test/TestCase.h"
+#include "DX12Game/CookedMesh.h"
+#include "DX12Game/VertexWelder.h"
+#include "common/MappedFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+using namespace Game;
+
+namespace {
+	std::string GetTempFileName(const std::string& inName) {
+		return (std::filesystem::temp_directory_path() / inName).string();
+	}
+
+	bool WriteSampleMesh(const std::string& inFileName) {
+		CookedMeshWriter writer;
+		writer.SetFlags(CookedMesh::Flags::ESkinned);
+		writer.SetSourceKey(0x0123456789ABCDEFull);
+
+		std::vector<float> vertices = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f };
+		writer.AddSection(CookedMesh::SectionType::EVertices, 3 * sizeof(float), vertices.data(), 3);
+
+		std::vector<std::uint32_t> indices = { 0, 1, 2 };
+		writer.AddSection(CookedMesh::SectionType::EIndices, indices);
+
+		CookedSubset subset = {};
+		subset.mIndexCount = 3;
+		subset.mStartIndex = 0;
+		subset.mName = writer.AddString("body");
+		writer.AddSection(CookedMesh::SectionType::ESubsets, std::vector<CookedSubset>{ subset });
+
+		return writer.Write(inFileName);
+	}
+
+	std::vector<std::uint8_t> ReadFile(const std::string& inFileName) {
+		MappedFile file;
+		if (!file.Open(inFileName))
+			return {};
+
+		return std::vector<std::uint8_t>(file.GetData(), file.GetData() + file.GetSize());
+	}
+
+	//* The layout of Game::Vertex: position, normal, texture coordinates and tangent.
+	struct BenchmarkVertex {
+		float mPos[3];
+		float mNormal[3];
+		float mTexC[2];
+		float mTangentU[3];
+	};
+
+	//* Triangle corners of an inGridSize x inGridSize grid of quads, as the FBX importer hands them to the welder.
+	std::vector<BenchmarkVertex> BuildTriangleSoup(std::uint32_t inGridSize) {
+		auto corner = [inGridSize](std::uint32_t inX, std::uint32_t inY) {
+			const float u = static_cast<float>(inX) / inGridSize;
+			const float v = static_cast<float>(inY) / inGridSize;
+			return BenchmarkVertex{ { u * 100.0f, 0.0f, v * 100.0f }, { 0.0f, 1.0f, 0.0f }, { u, v }, { 1.0f, 0.0f, 0.0f } };
+		};
+
+		std::vector<BenchmarkVertex> corners;
+		corners.reserve(static_cast<size_t>(inGridSize) * inGridSize * 6);
+		for (std::uint32_t y = 0; y < inGridSize; ++y) {
+			for (std::uint32_t x = 0; x < inGridSize; ++x) {
+				corners.push_back(corner(x, y));
+				corners.push_back(corner(x, y + 1));
+				corners.push_back(corner(x + 1, y));
+				corners.push_back(corner(x + 1, y));
+				corners.push_back(corner(x, y + 1));
+				corners.push_back(corner(x + 1, y + 1));
+			}
+		}
+		return corners;
+	}
+
+	//* The device-free half of the import: welding the corners and cooking the container(Mesh::Cook).
+	bool ImportAndCook(const std::vector<BenchmarkVertex>& inCorners, const std::string& inFileName,
+			std::vector<BenchmarkVertex>& outVertices, std::vector<std::uint32_t>& outIndices) {
+		VertexWelder::WeldVertices(inCorners, sizeof(BenchmarkVertex) / 4, outVertices, outIndices);
+
+		CookedMeshWriter writer;
+		writer.SetSourceKey(1);
+		writer.AddSection(CookedMesh::SectionType::EVertices, outVertices);
+		writer.AddSection(CookedMesh::SectionType::EIndices, outIndices);
+
+		CookedSubset subset = {};
+		subset.mIndexCount = static_cast<std::uint32_t>(outIndices.size());
+		subset.mName = writer.AddString("terrain");
+		writer.AddSection(CookedMesh::SectionType::ESubsets, std::vector<CookedSubset>{ subset });
+
+		return writer.Write(inFileName);
+	}
+
+	//* What Mesh::LoadFromCooked does with the sections: maps the file, checks the indices and copies the spans.
+	bool LoadCooked(const std::string& inFileName,
+			std::vector<BenchmarkVertex>& outVertices, std::vector<std::uint32_t>& outIndices) {
+		MappedFile file;
+		CookedMeshView view;
+		if (!file.Open(inFileName) || !view.Open(file) || view.GetSourceKey() != 1)
+			return false;
+
+		auto vertices = view.GetSection<BenchmarkVertex>(CookedMesh::SectionType::EVertices);
+		auto indices = view.GetSection<std::uint32_t>(CookedMesh::SectionType::EIndices);
+		const size_t numVertices = vertices.mSize;
+		if (std::any_of(indices.begin(), indices.end(), [numVertices](std::uint32_t inIndex) { return inIndex >= numVertices; }))
+			return false;
+
+		outVertices.assign(vertices.begin(), vertices.end());
+		outIndices.assign(indices.begin(), indices.end());
+		return true;
+	}
+
+	template <typename Func>
+	double MeasureMilliseconds(Func&& inFunc) {
+		auto begin = std::chrono::steady_clock::now();
+		inFunc();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+}
+
+TEST_CASE(CookedMesh_WrittenContainerReadsInPlace) {
+	std::string fileName = GetTempFileName("CookedMeshTest.cmesh");
+	TEST_CHECK(WriteSampleMesh(fileName));
+
+	{
+		MappedFile file;
+		TEST_CHECK(file.Open(fileName));
+
+		CookedMeshView view;
+		TEST_CHECK(view.Open(file));
+		TEST_CHECK(view.GetFlags() == CookedMesh::Flags::ESkinned);
+		TEST_CHECK(view.GetSourceKey() == 0x0123456789ABCDEFull);
+
+		TEST_CHECK(view.GetElementSize(CookedMesh::SectionType::EVertices) == 3 * sizeof(float));
+		TEST_CHECK(!view.HasSection(CookedMesh::SectionType::EBones));
+
+		auto indices = view.GetSection<std::uint32_t>(CookedMesh::SectionType::EIndices);
+		TEST_CHECK(indices.mSize == 3 && indices[2] == 2);
+		TEST_CHECK(reinterpret_cast<std::uintptr_t>(indices.mData) % CookedMesh::SectionAlignment == 0);
+
+		// A span of the wrong element size is empty instead of misread.
+		TEST_CHECK(view.GetSection<std::uint16_t>(CookedMesh::SectionType::EIndices).Empty());
+
+		auto subsets = view.GetSection<CookedSubset>(CookedMesh::SectionType::ESubsets);
+		TEST_CHECK(subsets.mSize == 1);
+		TEST_CHECK(view.GetString(subsets[0].mName) == "body");
+
+		CookedString outOfRange = { 2, 100 };
+		TEST_CHECK(view.GetString(outOfRange).empty());
+	}
+
+	std::filesystem::remove(fileName);
+}
+
+TEST_CASE(CookedMesh_RejectsBrokenContainers) {
+	std::string fileName = GetTempFileName("CookedMeshTest_Broken.cmesh");
+	TEST_CHECK(WriteSampleMesh(fileName));
+
+	auto data = ReadFile(fileName);
+	std::filesystem::remove(fileName);
+	TEST_CHECK(!data.empty());
+
+	CookedMeshView view;
+	TEST_CHECK(view.Open(data.data(), data.size()));
+
+	// Truncated.
+	TEST_CHECK(!view.Open(data.data(), data.size() - 1));
+	TEST_CHECK(!view.Open(data.data(), sizeof(CookedMeshHeader) - 1));
+
+	{
+		auto broken = data;
+		reinterpret_cast<CookedMeshHeader*>(broken.data())->mVersion = CookedMesh::Version + 1;
+		TEST_CHECK(!view.Open(broken.data(), broken.size()));
+	}
+	{
+		auto broken = data;
+		reinterpret_cast<CookedMeshHeader*>(broken.data())->mNumSections = 0xFFFF;
+		TEST_CHECK(!view.Open(broken.data(), broken.size()));
+	}
+
+	auto firstSection = [](std::vector<std::uint8_t>& inData) {
+		return reinterpret_cast<CookedSection*>(inData.data() + sizeof(CookedMeshHeader));
+	};
+	{
+		auto broken = data;
+		firstSection(broken)->mOffset += 4;
+		TEST_CHECK(!view.Open(broken.data(), broken.size()));
+	}
+	{
+		auto broken = data;
+		firstSection(broken)->mCount = 0xFFFFFFFFFFFFull;
+		TEST_CHECK(!view.Open(broken.data(), broken.size()));
+	}
+	{
+		auto broken = data;
+		firstSection(broken)->mType = CookedMesh::SectionType::Count;
+		TEST_CHECK(!view.Open(broken.data(), broken.size()));
+	}
+
+	// A failed open doesn't leave the sections of the last container behind.
+	TEST_CHECK(!view.HasSection(CookedMesh::SectionType::EIndices));
+}
+
+TEST_CASE(CookedMesh_LoadBenchmark) {
+	// There is no FBX SDK here, so the import side only times what follows the SDK's parse and bake:
+	//  welding the triangle corners and cooking the container. The real cold load is slower still.
+	std::string fileName = GetTempFileName("CookedMeshTest_Benchmark.cmesh");
+	auto corners = BuildTriangleSoup(400);
+
+	std::vector<BenchmarkVertex> importedVertices;
+	std::vector<std::uint32_t> importedIndices;
+	bool cooked = false;
+	double import = MeasureMilliseconds([&] {
+		cooked = ImportAndCook(corners, fileName, importedVertices, importedIndices);
+	});
+	TEST_CHECK(cooked);
+
+	std::vector<BenchmarkVertex> loadedVertices;
+	std::vector<std::uint32_t> loadedIndices;
+	bool loaded = true;
+	const int numLoads = 5;
+	double load = MeasureMilliseconds([&] {
+		for (int i = 0; i < numLoads; ++i)
+			loaded &= LoadCooked(fileName, loadedVertices, loadedIndices);
+	}) / numLoads;
+	TEST_CHECK(loaded);
+
+	std::cout << "  " << importedIndices.size() / 3 << " triangles, " << importedVertices.size() << " vertices, weld and cook "
+		<< import << " ms, cooked load " << load << " ms" << std::endl;
+
+	TEST_CHECK(loadedIndices == importedIndices);
+	TEST_CHECK(loadedVertices.size() == importedVertices.size() &&
+		std::memcmp(loadedVertices.data(), importedVertices.data(), loadedVertices.size() * sizeof(BenchmarkVertex)) == 0);
+	TEST_CHECK(load < import);
+
+	std::filesystem::remove(fileName);
+}
\ No newline at end of file
@@ -0,0 +1,290 @@
+#include "Test/TestCase.h"
+#include "DX12Game/CpuSkinning.h"
+#include "DX12Game/FrameResource.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace DirectX;
+using namespace Game;
+
+namespace {
+	//* Rigid transforms; the dual quaternion path ignores scale, so the palette has none.
+	std::vector<XMFLOAT4X4> BuildPalette(size_t inNumBones, std::mt19937& ioRng) {
+		std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+		std::vector<XMFLOAT4X4> palette(inNumBones);
+		for (auto& transform : palette) {
+			XMVECTOR rotation = XMQuaternionNormalize(XMVectorSet(value(ioRng), value(ioRng), value(ioRng), value(ioRng)));
+			XMVECTOR translation = XMVectorSet(5.0f * value(ioRng), 5.0f * value(ioRng), 5.0f * value(ioRng), 1.0f);
+			XMStoreFloat4x4(&transform,
+				XMMatrixMultiply(XMMatrixRotationQuaternion(rotation), XMMatrixTranslationFromVector(translation)));
+		}
+		return palette;
+	}
+
+	//* Vertices with one to four normalized influences.
+	std::vector<SkinnedVertex> BuildVertices(size_t inNumVertices, size_t inNumBones, std::mt19937& ioRng) {
+		std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+		std::vector<SkinnedVertex> vertices(inNumVertices);
+		for (auto& vertex : vertices) {
+			vertex.mPos = { value(ioRng), value(ioRng), value(ioRng) };
+			vertex.mNormal = { 0.0f, 1.0f, 0.0f };
+			vertex.mTangentU = { 1.0f, 0.0f, 0.0f };
+
+			float weights[4] = {};
+			float sum = 0.0f;
+			size_t count = 1 + ioRng() % 4;
+			for (size_t i = 0; i < count; ++i) {
+				weights[i] = std::abs(value(ioRng)) + 0.01f;
+				sum += weights[i];
+				vertex.mBoneIndices0[i] = static_cast<int>(ioRng() % inNumBones);
+			}
+			vertex.mBoneWeights0 = { weights[0] / sum, weights[1] / sum, weights[2] / sum, weights[3] / sum };
+		}
+		return vertices;
+	}
+
+	//* The vertex shader's sum, one component at a time.
+	XMFLOAT3 SkinPosition(const SkinnedVertex& inVertex, const std::vector<XMFLOAT4X4>& inPalette) {
+		const float* weights = &inVertex.mBoneWeights0.x;
+		const float* pos = &inVertex.mPos.x;
+
+		float result[3] = {};
+		for (size_t i = 0; i < 4 && inVertex.mBoneIndices0[i] != -1; ++i) {
+			const auto& m = inPalette[inVertex.mBoneIndices0[i]];
+			for (int c = 0; c < 3; ++c)
+				result[c] += weights[i] * (pos[0] * m.m[0][c] + pos[1] * m.m[1][c] + pos[2] * m.m[2][c] + m.m[3][c]);
+		}
+		return { result[0], result[1], result[2] };
+	}
+
+	float Distance(const XMFLOAT3& inA, const XMFLOAT3& inB) {
+		return XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&inA), XMLoadFloat3(&inB))));
+	}
+
+	float Length(const XMFLOAT3& inVector) {
+		return XMVectorGetX(XMVector3Length(XMLoadFloat3(&inVector)));
+	}
+
+	template <typename Func>
+	double MeasureMilliseconds(Func&& inFunc) {
+		auto begin = std::chrono::steady_clock::now();
+		inFunc();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+}
+
+TEST_CASE(CpuSkinning_LinearBlendMatchesShader) {
+	std::mt19937 rng(5);
+	auto palette = BuildPalette(60, rng);
+	// A few chunks and a partial one.
+	auto vertices = BuildVertices(3 * CpuSkinning::ChunkSize + 100, palette.size(), rng);
+
+	std::vector<XMFLOAT3> positions(vertices.size());
+	std::vector<XMFLOAT3> normals(vertices.size());
+	std::vector<XMFLOAT3> tangents(vertices.size());
+
+	SkinningJob job;
+	job.mVertices = vertices.data();
+	job.mNumVertices = vertices.size();
+	job.mSkinningPalette = palette.data();
+	job.mPaletteSize = palette.size();
+	job.mPositions = positions.data();
+	job.mNormals = normals.data();
+	job.mTangents = tangents.data();
+	auto result = CpuSkinning::Skin(job);
+
+	XMFLOAT3 boundsMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+	XMFLOAT3 boundsMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		TEST_CHECK(Distance(positions[i], SkinPosition(vertices[i], palette)) <= 1e-4f);
+		TEST_CHECK(std::abs(Length(normals[i]) - 1.0f) <= 1e-4f);
+		TEST_CHECK(std::abs(Length(tangents[i]) - 1.0f) <= 1e-4f);
+
+		boundsMin = { std::min(boundsMin.x, positions[i].x), std::min(boundsMin.y, positions[i].y), std::min(boundsMin.z, positions[i].z) };
+		boundsMax = { std::max(boundsMax.x, positions[i].x), std::max(boundsMax.y, positions[i].y), std::max(boundsMax.z, positions[i].z) };
+	}
+
+	TEST_CHECK(result.mBoundsMin.x == boundsMin.x && result.mBoundsMin.y == boundsMin.y && result.mBoundsMin.z == boundsMin.z);
+	TEST_CHECK(result.mBoundsMax.x == boundsMax.x && result.mBoundsMax.y == boundsMax.y && result.mBoundsMax.z == boundsMax.z);
+	TEST_CHECK(result.mTime >= 0.0f);
+}
+
+TEST_CASE(CpuSkinning_DualQuaternionMatchesRigidVertices) {
+	std::mt19937 rng(7);
+	auto palette = BuildPalette(40, rng);
+	auto vertices = BuildVertices(5000, palette.size(), rng);
+
+	std::vector<XMFLOAT3> linear(vertices.size());
+	std::vector<XMFLOAT3> linearNormals(vertices.size());
+	std::vector<XMFLOAT3> dual(vertices.size());
+	std::vector<XMFLOAT3> dualNormals(vertices.size());
+	std::vector<XMFLOAT3> prebuilt(vertices.size());
+
+	SkinningJob job;
+	job.mVertices = vertices.data();
+	job.mNumVertices = vertices.size();
+	job.mSkinningPalette = palette.data();
+	job.mPaletteSize = palette.size();
+	job.mPositions = linear.data();
+	job.mNormals = linearNormals.data();
+	CpuSkinning::Skin(job);
+
+	job.mMethod = SkinningJob::EDualQuaternion;
+	job.mPositions = dual.data();
+	job.mNormals = dualNormals.data();
+	CpuSkinning::Skin(job);
+
+	// The quaternions Skin builds are the ones BuildDualQuaternions returns.
+	std::vector<XMFLOAT4> dualQuaternions(palette.size() * 2);
+	CpuSkinning::BuildDualQuaternions(palette.data(), palette.size(), dualQuaternions.data());
+	job.mDualQuaternions = dualQuaternions.data();
+	job.mPositions = prebuilt.data();
+	job.mNormals = nullptr;
+	CpuSkinning::Skin(job);
+
+	size_t numRigid = 0;
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		TEST_CHECK(Distance(dual[i], prebuilt[i]) <= 1e-5f);
+
+		// A vertex on a single bone is moved rigidly by both methods.
+		if (vertices[i].mBoneIndices0[1] != -1)
+			continue;
+
+		++numRigid;
+		TEST_CHECK(Distance(dual[i], linear[i]) <= 1e-3f);
+		TEST_CHECK(Distance(dualNormals[i], linearNormals[i]) <= 1e-3f);
+	}
+	TEST_CHECK(numRigid > 0);
+}
+
+TEST_CASE(CpuSkinning_DualQuaternionKeepsVolume) {
+	// Two bones twisted 160 degrees apart about x; a vertex between them is the candy-wrapper case.
+	std::vector<XMFLOAT4X4> palette(2);
+	XMStoreFloat4x4(&palette[0], XMMatrixIdentity());
+	XMStoreFloat4x4(&palette[1], XMMatrixRotationQuaternion(
+		XMQuaternionRotationAxis(XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), XMConvertToRadians(160.0f))));
+
+	SkinnedVertex vertex;
+	vertex.mPos = { 0.0f, 1.0f, 0.0f };
+	vertex.mNormal = { 0.0f, 1.0f, 0.0f };
+	vertex.mBoneWeights0 = { 0.5f, 0.5f, 0.0f, 0.0f };
+	vertex.mBoneIndices0[0] = 0;
+	vertex.mBoneIndices0[1] = 1;
+
+	XMFLOAT3 linear;
+	XMFLOAT3 dual;
+
+	SkinningJob job;
+	job.mVertices = &vertex;
+	job.mNumVertices = 1;
+	job.mSkinningPalette = palette.data();
+	job.mPaletteSize = palette.size();
+	job.mPositions = &linear;
+	CpuSkinning::Skin(job);
+
+	job.mMethod = SkinningJob::EDualQuaternion;
+	job.mPositions = &dual;
+	CpuSkinning::Skin(job);
+
+	// The blended matrices shrink the vertex towards the axis; the dual quaternions keep its distance.
+	TEST_CHECK(Length(linear) < 0.2f);
+	TEST_CHECK(std::abs(Length(dual) - 1.0f) <= 1e-3f);
+}
+
+TEST_CASE(CpuSkinning_SkipsMissingBones) {
+	std::vector<XMFLOAT4X4> palette(1);
+	XMStoreFloat4x4(&palette[0], XMMatrixTranslationFromVector(XMVectorSet(0.0f, 2.0f, 0.0f, 1.0f)));
+
+	// The second influence points past the palette and is ignored; the vertex stays on the first bone.
+	SkinnedVertex vertex;
+	vertex.mPos = { 1.0f, 0.0f, 0.0f };
+	vertex.mBoneWeights0 = { 1.0f, 0.0f, 0.0f, 0.0f };
+	vertex.mBoneIndices0[0] = 0;
+	vertex.mBoneIndices0[1] = 5;
+
+	XMFLOAT3 position;
+
+	SkinningJob job;
+	job.mVertices = &vertex;
+	job.mNumVertices = 1;
+	job.mSkinningPalette = palette.data();
+	job.mPaletteSize = palette.size();
+	job.mPositions = &position;
+	auto result = CpuSkinning::Skin(job);
+	TEST_CHECK(Distance(position, { 1.0f, 2.0f, 0.0f }) <= 1e-5f);
+	TEST_CHECK(Distance(result.mBoundsMin, position) == 0.0f && Distance(result.mBoundsMax, position) == 0.0f);
+
+	// Nothing to skin.
+	job.mNumVertices = 0;
+	result = CpuSkinning::Skin(job);
+	TEST_CHECK(result.mVerticesPerSecond == 0.0f);
+}
+
+TEST_CASE(CpuSkinning_ThroughputBenchmark) {
+	// A crowd's worth of vertices on a full skeleton.
+	std::mt19937 rng(11);
+	auto palette = BuildPalette(100, rng);
+	auto vertices = BuildVertices(200000, palette.size(), rng);
+
+	std::vector<XMFLOAT3> positions(vertices.size());
+	std::vector<XMFLOAT3> normals(vertices.size());
+	std::vector<XMFLOAT3> tangents(vertices.size());
+	std::vector<XMFLOAT3> dualPositions(vertices.size());
+	std::vector<XMFLOAT3> serialPositions(vertices.size());
+
+	SkinningJob job;
+	job.mVertices = vertices.data();
+	job.mNumVertices = vertices.size();
+	job.mSkinningPalette = palette.data();
+	job.mPaletteSize = palette.size();
+	job.mPositions = positions.data();
+
+	auto perSecond = [&vertices](double inMilliseconds) {
+		return static_cast<double>(vertices.size()) / (inMilliseconds * 0.001);
+	};
+
+	auto positionsOnly = CpuSkinning::Skin(job);
+
+	job.mNormals = normals.data();
+	job.mTangents = tangents.data();
+	auto linear = CpuSkinning::Skin(job);
+
+	job.mMethod = SkinningJob::EDualQuaternion;
+	job.mPositions = dualPositions.data();
+	auto dual = CpuSkinning::Skin(job);
+
+	// The same linear blend on the calling thread.
+	job.mMethod = SkinningJob::ELinearBlend;
+	job.mPositions = serialPositions.data();
+	job.mNormals = nullptr;
+	job.mTangents = nullptr;
+	XMVECTOR boundsMin = XMVectorReplicate(FLT_MAX);
+	XMVECTOR boundsMax = XMVectorReplicate(-FLT_MAX);
+	double serial = MeasureMilliseconds([&] {
+		CpuSkinning::SkinRange(job, 0, vertices.size(), boundsMin, boundsMax);
+	});
+
+	std::cout << "  " << vertices.size() << " vertices, positions " << positionsOnly.mVerticesPerSecond
+		<< " /s, with normals and tangents " << linear.mVerticesPerSecond << " /s, dual quaternions "
+		<< dual.mVerticesPerSecond << " /s, positions on one thread " << perSecond(serial) << " /s" << std::endl;
+
+	TEST_CHECK(positionsOnly.mVerticesPerSecond > 0.0f);
+	TEST_CHECK(linear.mVerticesPerSecond > 0.0f && dual.mVerticesPerSecond > 0.0f);
+	TEST_CHECK(std::equal(positions.begin(), positions.end(), serialPositions.begin(), [](const XMFLOAT3& inA, const XMFLOAT3& inB) {
+		return inA.x == inB.x && inA.y == inB.y && inA.z == inB.z;
+	}));
+
+	XMFLOAT3 serialMin;
+	XMFLOAT3 serialMax;
+	XMStoreFloat3(&serialMin, boundsMin);
+	XMStoreFloat3(&serialMax, boundsMax);
+	TEST_CHECK(Distance(serialMin, linear.mBoundsMin) == 0.0f && Distance(serialMax, linear.mBoundsMax) == 0.0f);
+}
\ No newline at end of file
@@ -0,0 +1,342 @@
+#include "Test/TestCase.h"
+#include "DX12Game/DdsFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+
+using namespace Game;
+
+namespace {
+	const std::uint32_t FormatR8G8B8A8Unorm = 28;
+	const std::uint32_t FormatBC1Unorm = 71;
+
+	void Put(std::vector<std::uint8_t>& ioData, size_t inOffset, std::uint32_t inValue) {
+		std::memcpy(ioData.data() + inOffset, &inValue, sizeof(std::uint32_t));
+	}
+
+	//* Magic and DDS_HEADER(offsets are relative to the start of the file).
+	std::vector<std::uint8_t> BuildHeader(std::uint32_t inWidth, std::uint32_t inHeight, std::uint32_t inMipCount,
+			std::uint32_t inFourCC) {
+		std::vector<std::uint8_t> data(4 + 124, 0);
+		Put(data, 0, 0x20534444);				// 'DDS '
+		Put(data, 4, 124);						// mSize
+		Put(data, 8, 0x00001007 | 0x00020000);	// caps, height, width, pixel format, mip count
+		Put(data, 12, inHeight);
+		Put(data, 16, inWidth);
+		Put(data, 28, inMipCount);
+		Put(data, 76, 32);						// mPixelFormat.mSize
+		Put(data, 80, 0x00000004);				// DDPF_FOURCC
+		Put(data, 84, inFourCC);
+		return data;
+	}
+
+	std::uint32_t FourCC(const char* inCode) {
+		std::uint32_t code;
+		std::memcpy(&code, inCode, sizeof(std::uint32_t));
+		return code;
+	}
+
+	//* 64x32 BC1 texture with a full chain of 7 mips.
+	std::vector<std::uint8_t> BuildBC1() {
+		auto data = BuildHeader(64, 32, 7, FourCC("DXT1"));
+
+		// 16x8 blocks of 8 bytes, then 8x4, 4x2, 2x1, and a single block for the 2 smallest mips.
+		size_t bitSize = (16 * 8 + 8 * 4 + 4 * 2 + 2 * 1 + 1 + 1 + 1) * 8;
+		for (size_t i = 0; i < bitSize; ++i)
+			data.push_back(static_cast<std::uint8_t>(i));
+
+		return data;
+	}
+
+	//* 16x16 RGBA8 cube map with 2 mips, through the DX10 extension.
+	std::vector<std::uint8_t> BuildCubeMap() {
+		auto data = BuildHeader(16, 16, 2, FourCC("DX10"));
+
+		std::vector<std::uint8_t> ext(20, 0);
+		Put(ext, 0, FormatR8G8B8A8Unorm);
+		Put(ext, 4, Dds::ETexture2D);
+		Put(ext, 8, 0x4);						// D3D11_RESOURCE_MISC_TEXTURECUBE
+		Put(ext, 12, 1);
+		data.insert(data.end(), ext.begin(), ext.end());
+
+		data.resize(data.size() + 6 * (16 * 16 + 8 * 8) * 4, 0xAB);
+		return data;
+	}
+
+	//* Every subresource of a parsed image must lie inside the parsed bytes.
+	bool AreSubresourcesInBounds(const DdsFile& inDds, const std::vector<std::uint8_t>& inData, std::uint64_t inSize) {
+		const auto& desc = inDds.GetDesc();
+		const std::uint8_t* begin = inData.data();
+		const std::uint8_t* end = begin + inSize;
+
+		for (std::uint32_t slice = 0; slice < desc.mArraySize; ++slice) {
+			for (std::uint32_t mip = 0; mip < desc.mMipCount; ++mip) {
+				const auto& sub = inDds.GetSubresource(slice, mip);
+				if (sub.mData < begin || sub.mData > end)
+					return false;
+				if (sub.mSlicePitch * sub.mDepth > static_cast<std::uint64_t>(end - sub.mData))
+					return false;
+				if (sub.mRowPitch > sub.mSlicePitch)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	std::uint64_t SumSubresources(const DdsFile& inDds) {
+		std::vector<DdsSubresource> subresources;
+		inDds.GetSubresources(0, inDds.GetDesc().mMipCount, subresources);
+
+		std::uint64_t sum = 0;
+		for (const auto& sub : subresources) {
+			for (std::uint64_t i = 0, size = sub.mSlicePitch * sub.mDepth; i < size; i += 64)
+				sum += sub.mData[i];
+		}
+		return sum;
+	}
+
+	template <typename Func>
+	double MeasureMilliseconds(Func&& inFunc) {
+		auto begin = std::chrono::steady_clock::now();
+		inFunc();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+}
+
+TEST_CASE(DdsFile_ParsesBC1MipChain) {
+	auto data = BuildBC1();
+
+	DdsFile dds;
+	TEST_CHECK(dds.Parse(data.data(), data.size()));
+
+	const auto& desc = dds.GetDesc();
+	TEST_CHECK(desc.mDimension == Dds::ETexture2D);
+	TEST_CHECK(desc.mFormat == FormatBC1Unorm);
+	TEST_CHECK(desc.mWidth == 64 && desc.mHeight == 32 && desc.mArraySize == 1 && desc.mMipCount == 7);
+
+	// The mips are laid out back to back after the header, in place.
+	const std::uint8_t* expected = data.data() + 4 + 124;
+	const std::uint32_t expectedRowBlocks[] = { 16, 8, 4, 2, 1, 1, 1 };
+	for (std::uint32_t mip = 0; mip < desc.mMipCount; ++mip) {
+		const auto& sub = dds.GetSubresource(0, mip);
+		TEST_CHECK(sub.mData == expected);
+		TEST_CHECK(sub.mWidth == std::max(64u >> mip, 1u) && sub.mHeight == std::max(32u >> mip, 1u));
+		TEST_CHECK(sub.mRowPitch == expectedRowBlocks[mip] * 8);
+		expected += sub.mSlicePitch;
+	}
+	TEST_CHECK(expected == data.data() + data.size());
+
+	TEST_CHECK(dds.GetFirstMipWithin(0) == 0);
+	TEST_CHECK(dds.GetFirstMipWithin(16) == 2);
+	TEST_CHECK(dds.GetFirstMipWithin(1) == 6);
+	TEST_CHECK(dds.GetByteSize(0, 7) == data.size() - 4 - 124);
+	TEST_CHECK(dds.GetByteSize(5, 100) == 16);
+
+	std::vector<DdsSubresource> subresources;
+	TEST_CHECK(!dds.GetSubresources(5, 3, subresources));
+	TEST_CHECK(dds.GetSubresources(5, 2, subresources) && subresources.size() == 2);
+}
+
+TEST_CASE(DdsFile_ParsesCubeMapSliceMajor) {
+	auto data = BuildCubeMap();
+
+	DdsFile dds;
+	TEST_CHECK(dds.Parse(data.data(), data.size()));
+
+	const auto& desc = dds.GetDesc();
+	TEST_CHECK(desc.bCubeMap && desc.mArraySize == 6 && desc.mMipCount == 2);
+	TEST_CHECK(dds.GetByteSize(0, 2) == 6 * (16 * 16 + 8 * 8) * 4);
+
+	std::vector<DdsSubresource> subresources;
+	TEST_CHECK(dds.GetSubresources(1, 1, subresources) && subresources.size() == 6);
+	for (std::uint32_t face = 0; face < 6; ++face) {
+		TEST_CHECK(subresources[face].mData == dds.GetSubresource(face, 1).mData);
+		TEST_CHECK(subresources[face].mRowPitch == 8 * 4);
+	}
+	TEST_CHECK(dds.GetSubresource(1, 0).mData == dds.GetSubresource(0, 1).mData + 8 * 8 * 4);
+}
+
+TEST_CASE(DdsFile_RejectsBrokenHeaders) {
+	DdsFile dds;
+
+	auto data = BuildBC1();
+	TEST_CHECK(!dds.Parse(data.data(), data.size() - 1));
+	TEST_CHECK(!dds.IsValid());
+	TEST_CHECK(!dds.Parse(data.data(), 64));
+	TEST_CHECK(!dds.Parse(nullptr, data.size()));
+
+	{
+		auto broken = data;
+		broken[0] = 'X';
+		TEST_CHECK(!dds.Parse(broken.data(), broken.size()));
+	}
+	{
+		auto broken = data;
+		Put(broken, 28, 16);	// More mips than Direct3D allows.
+		TEST_CHECK(!dds.Parse(broken.data(), broken.size()));
+	}
+	{
+		auto broken = data;
+		Put(broken, 16, 128);	// The mip chain no longer fits in the file.
+		TEST_CHECK(!dds.Parse(broken.data(), broken.size()));
+	}
+	{
+		auto broken = data;
+		Put(broken, 16, 32768);	// Wider than Direct3D allows.
+		TEST_CHECK(!dds.Parse(broken.data(), broken.size()));
+	}
+	{
+		auto broken = data;
+		Put(broken, 84, FourCC("ABCD"));
+		TEST_CHECK(!dds.Parse(broken.data(), broken.size()));
+	}
+
+	auto cube = BuildCubeMap();
+	{
+		auto broken = cube;
+		Put(broken, 128, 113);	// DXGI_FORMAT_P8
+		TEST_CHECK(!dds.Parse(broken.data(), broken.size()));
+	}
+	{
+		auto broken = cube;
+		Put(broken, 140, 0);	// No array slices.
+		TEST_CHECK(!dds.Parse(broken.data(), broken.size()));
+	}
+}
+
+TEST_CASE(DdsFile_OpensMappedFile) {
+	auto data = BuildBC1();
+
+	std::string fileName = (std::filesystem::temp_directory_path() / "DdsFileTest.dds").string();
+	{
+		std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	}
+
+	{
+		DdsFile dds;
+		TEST_CHECK(dds.Open(fileName));
+		TEST_CHECK(dds.GetDesc().mMipCount == 7);
+		TEST_CHECK(std::memcmp(dds.GetSubresource(0, 0).mData, data.data() + 4 + 124, 16 * 8 * 8) == 0);
+
+		dds.Close();
+		TEST_CHECK(!dds.IsValid());
+	}
+
+	std::filesystem::remove(fileName);
+
+	DdsFile missing;
+	TEST_CHECK(!missing.Open(fileName));
+}
+
+TEST_CASE(DdsFile_SurvivesMutatedImages) {
+	// Random bytes of the headers are overwritten and the images are truncated; a parse either fails
+	//  or returns subresources inside the data. Run under the address sanitizer to catch stray reads.
+	const std::vector<std::uint8_t> seeds[] = { BuildBC1(), BuildCubeMap() };
+	const std::uint32_t interesting[] = { 0, 1, 6, 7, 15, 16, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF, 16384, 16385 };
+
+	std::mt19937 rng(11);
+	std::uint32_t numParsed = 0;
+	for (int i = 0; i < 20000; ++i) {
+		auto data = seeds[i % 2];
+		const size_t headerSize = i % 2 == 0 ? 4 + 124 : 4 + 124 + 20;
+
+		for (std::uint32_t m = 0, count = 1 + rng() % 4; m < count; ++m) {
+			size_t offset = rng() % headerSize;
+			if (rng() % 2 == 0 && offset + 4 <= headerSize)
+				Put(data, offset & ~size_t(3), interesting[rng() % std::size(interesting)]);
+			else
+				data[offset] = static_cast<std::uint8_t>(rng());
+		}
+
+		std::uint64_t size = data.size();
+		if (rng() % 4 == 0)
+			size = rng() % (size + 1);
+
+		DdsFile dds;
+		if (!dds.Parse(data.data(), size))
+			continue;
+
+		++numParsed;
+		TEST_CHECK(AreSubresourcesInBounds(dds, data, size));
+		TEST_CHECK(dds.GetByteSize(0, dds.GetDesc().mMipCount) <= size);
+		TEST_CHECK(dds.GetFirstMipWithin(4) < dds.GetDesc().mMipCount);
+	}
+
+	// Mutations of the unused fields leave valid images, so both outcomes are exercised.
+	TEST_CHECK(numParsed > 0);
+}
+
+TEST_CASE(DdsFile_LoadBenchmark) {
+	// 2048x2048 RGBA8 with a full mip chain, about 22 MB.
+	const std::uint32_t size = 2048;
+	const std::uint32_t numMips = 12;
+
+	auto data = BuildHeader(size, size, numMips, FourCC("DX10"));
+	std::vector<std::uint8_t> ext(20, 0);
+	Put(ext, 0, FormatR8G8B8A8Unorm);
+	Put(ext, 4, Dds::ETexture2D);
+	Put(ext, 12, 1);
+	data.insert(data.end(), ext.begin(), ext.end());
+
+	std::uint64_t bitSize = 0;
+	for (std::uint32_t mip = 0; mip < numMips; ++mip)
+		bitSize += static_cast<std::uint64_t>(std::max(size >> mip, 1u)) * std::max(size >> mip, 1u) * 4;
+
+	size_t headerSize = data.size();
+	data.resize(headerSize + static_cast<size_t>(bitSize));
+	for (size_t i = headerSize; i < data.size(); i += 64)
+		data[i] = static_cast<std::uint8_t>(i >> 6);
+
+	std::string fileName = (std::filesystem::temp_directory_path() / "DdsFileTest_Large.dds").string();
+	{
+		std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	}
+
+	const int numLoads = 5;
+	std::uint64_t sums[2] = {};
+
+	// The loader before DdsFile: the whole file read into the heap, then parsed.
+	double readTime = MeasureMilliseconds([&] {
+		for (int i = 0; i < numLoads; ++i) {
+			std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+			auto fileSize = static_cast<size_t>(file.tellg());
+			std::unique_ptr<std::uint8_t[]> bytes(new std::uint8_t[fileSize]);
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(bytes.get()), static_cast<std::streamsize>(fileSize));
+
+			DdsFile dds;
+			TEST_CHECK(dds.Parse(bytes.get(), fileSize));
+			sums[0] += SumSubresources(dds);
+		}
+	});
+
+	double mapTime = 0.0;
+	double mapOpenTime = 0.0;
+	for (int i = 0; i < numLoads; ++i) {
+		DdsFile dds;
+		mapOpenTime += MeasureMilliseconds([&] {
+			TEST_CHECK(dds.Open(fileName));
+		});
+		mapTime += MeasureMilliseconds([&] {
+			sums[1] += SumSubresources(dds);
+		});
+	}
+	mapTime += mapOpenTime;
+
+	std::cout << "  " << data.size() / (1024 * 1024) << " MB, read into heap " << readTime / numLoads
+		<< " ms, mapped " << mapTime / numLoads << " ms(open " << mapOpenTime / numLoads << " ms)" << std::endl;
+
+	// Both see the same pixels.
+	TEST_CHECK(sums[0] == sums[1] && sums[0] != 0);
+
+	std::filesystem::remove(fileName);
+}
\ No newline at end of file
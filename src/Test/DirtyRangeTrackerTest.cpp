@@ -0,0 +1,211 @@
+#include "Test/TestCase.h"
+#include "DX12Game/DirtyRangeTracker.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+using namespace Game;
+
+namespace Game {
+	// Found by the comparisons of the vectors in std.
+	bool operator==(const DirtyRange& inLhs, const DirtyRange& inRhs) {
+		return inLhs.mBegin == inRhs.mBegin && inLhs.mEnd == inRhs.mEnd;
+	}
+}
+
+namespace {
+	//* About the size of an InstanceData.
+	struct Element {
+		float mValues[48];
+	};
+
+	//* Ranges passed to the copy callback of a flush.
+	std::vector<DirtyRange> FlushRanges(DirtyRangeTracker& ioTracker, std::uint32_t inMaxGap = 0) {
+		std::vector<DirtyRange> ranges;
+		ioTracker.Flush([&](std::uint32_t inBegin, std::uint32_t inCount) {
+			ranges.push_back({ inBegin, inBegin + inCount });
+		}, inMaxGap);
+		return ranges;
+	}
+
+	template <typename Func>
+	double MeasureMilliseconds(Func&& inFunc) {
+		auto begin = std::chrono::steady_clock::now();
+		inFunc();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+}
+
+TEST_CASE(DirtyRangeTracker_ExtendsAscendingMarks) {
+	DirtyRangeTracker tracker;
+	for (std::uint32_t i = 10; i < 20; ++i)
+		tracker.MarkDirty(i);
+	// Marked again inside the range.
+	tracker.MarkDirty(12, 3);
+	tracker.MarkDirty(18, 5);
+
+	TEST_CHECK(tracker.GetNumMarked() == 12);
+	TEST_CHECK(tracker.GetRanges().size() == 1);
+	TEST_CHECK((tracker.GetRanges()[0] == DirtyRange{ 10, 23 }));
+
+	// Empty marks are ignored.
+	tracker.MarkDirty(40, 0);
+	TEST_CHECK(tracker.GetNumMarked() == 12 && tracker.GetRanges().size() == 1);
+}
+
+TEST_CASE(DirtyRangeTracker_CoalescesUnorderedRanges) {
+	DirtyRangeTracker tracker;
+	tracker.MarkDirty(50, 10);
+	tracker.MarkDirty(10, 5);
+	tracker.MarkDirty(30, 10);
+	tracker.MarkDirty(12, 10);
+	tracker.MarkDirty(60, 2);
+	tracker.MarkDirty(70);
+
+	// Overlapping and touching ranges merge; separated ones are kept apart.
+	tracker.Coalesce();
+	const std::vector<DirtyRange> expected = { { 10, 22 }, { 30, 40 }, { 50, 62 }, { 70, 71 } };
+	TEST_CHECK(tracker.GetRanges() == expected);
+
+	// Coalescing again changes nothing.
+	tracker.Coalesce();
+	TEST_CHECK(tracker.GetRanges() == expected);
+}
+
+TEST_CASE(DirtyRangeTracker_MergesSmallGaps) {
+	auto mark = [](DirtyRangeTracker& outTracker) {
+		outTracker.MarkDirty(0, 4);
+		outTracker.MarkDirty(6, 4);
+		outTracker.MarkDirty(13, 2);
+		outTracker.MarkDirty(30, 1);
+	};
+
+	DirtyRangeTracker tracker;
+	mark(tracker);
+	tracker.Coalesce(2);
+	TEST_CHECK((tracker.GetRanges() == std::vector<DirtyRange>{ { 0, 10 }, { 13, 15 }, { 30, 31 } }));
+
+	tracker.Clear();
+	mark(tracker);
+	tracker.Coalesce(3);
+	TEST_CHECK((tracker.GetRanges() == std::vector<DirtyRange>{ { 0, 15 }, { 30, 31 } }));
+}
+
+TEST_CASE(DirtyRangeTracker_FlushesAndClears) {
+	DirtyRangeTracker tracker;
+	tracker.MarkDirty(20, 5);
+	tracker.MarkDirty(3);
+	tracker.MarkDirty(4);
+	tracker.MarkDirty(22, 6);
+
+	std::vector<DirtyRange> ranges;
+	std::uint32_t numCopied = tracker.Flush([&](std::uint32_t inBegin, std::uint32_t inCount) {
+		ranges.push_back({ inBegin, inBegin + inCount });
+	});
+	TEST_CHECK(numCopied == 10);
+	TEST_CHECK((ranges == std::vector<DirtyRange>{ { 3, 5 }, { 20, 28 } }));
+
+	TEST_CHECK(tracker.GetRanges().empty() && tracker.GetNumMarked() == 0);
+	TEST_CHECK(FlushRanges(tracker).empty());
+
+	// The order is reset by the flush; ascending marks extend the last range again.
+	tracker.MarkDirty(5);
+	tracker.MarkDirty(6);
+	TEST_CHECK((FlushRanges(tracker) == std::vector<DirtyRange>{ { 5, 7 } }));
+}
+
+TEST_CASE(DirtyRangeTracker_FlushCoversEveryMarkedElement) {
+	const std::uint32_t numElements = 4096;
+
+	std::mt19937 rng(4);
+	for (std::uint32_t maxGap : { 0u, 1u, 8u }) {
+		DirtyRangeTracker tracker;
+		std::vector<bool> marked(numElements, false);
+
+		for (int i = 0; i < 600; ++i) {
+			std::uint32_t begin = rng() % numElements;
+			std::uint32_t count = std::min(1 + static_cast<std::uint32_t>(rng() % 6), numElements - begin);
+			tracker.MarkDirty(begin, count);
+			for (std::uint32_t e = begin; e < begin + count; ++e)
+				marked[e] = true;
+		}
+
+		auto ranges = FlushRanges(tracker, maxGap);
+
+		// Sorted, disjoint and separated by more than the gap; every marked element is copied exactly once.
+		std::vector<int> copied(numElements, 0);
+		for (size_t r = 0; r < ranges.size(); ++r) {
+			TEST_CHECK(ranges[r].mBegin < ranges[r].mEnd && ranges[r].mEnd <= numElements);
+			if (r > 0)
+				TEST_CHECK(ranges[r - 1].mEnd + maxGap < ranges[r].mBegin);
+			for (std::uint32_t e = ranges[r].mBegin; e < ranges[r].mEnd; ++e)
+				++copied[e];
+		}
+
+		for (std::uint32_t e = 0; e < numElements; ++e) {
+			TEST_CHECK(copied[e] <= 1);
+			if (marked[e])
+				TEST_CHECK(copied[e] == 1);
+		}
+	}
+}
+
+TEST_CASE(DirtyRangeTracker_UploadBenchmark) {
+	// An instance buffer where the moving instances come in runs, as the render-items update them.
+	// Plain memory is cached, so the times are close here; on the write-combined upload heap
+	//  the number of copies is what counts.
+	const std::uint32_t numElements = 64 * 1024;
+	const int numFrames = 20;
+
+	std::vector<Element> staging(numElements);
+	for (std::uint32_t i = 0; i < numElements; ++i)
+		staging[i].mValues[0] = static_cast<float>(i);
+
+	std::vector<std::uint32_t> dirty;
+	std::mt19937 rng(6);
+	for (std::uint32_t i = 0; i < numElements;) {
+		std::uint32_t run = 1 + rng() % 32;
+		if (rng() % 2 == 0) {
+			for (std::uint32_t e = i; e < std::min(i + run, numElements); ++e)
+				dirty.push_back(e);
+		}
+		i += run;
+	}
+
+	std::vector<Element> perElement(numElements);
+	std::vector<Element> ranged(numElements);
+	std::uint64_t numElementCopies = 0;
+	std::uint64_t numRangeCopies = 0;
+
+	// The upload before the tracker: one copy for every modified element.
+	double elementTime = MeasureMilliseconds([&] {
+		for (int f = 0; f < numFrames; ++f) {
+			for (auto e : dirty) {
+				std::memcpy(&perElement[e], &staging[e], sizeof(Element));
+				++numElementCopies;
+			}
+		}
+	});
+
+	DirtyRangeTracker tracker;
+	double rangeTime = MeasureMilliseconds([&] {
+		for (int f = 0; f < numFrames; ++f) {
+			for (auto e : dirty)
+				tracker.MarkDirty(e);
+			tracker.Flush([&](std::uint32_t inBegin, std::uint32_t inCount) {
+				std::memcpy(&ranged[inBegin], &staging[inBegin], inCount * sizeof(Element));
+				++numRangeCopies;
+			});
+		}
+	});
+
+	std::cout << "  " << dirty.size() << " of " << numElements << " elements, per element " << elementTime
+		<< " ms(" << numElementCopies / numFrames << " copies), ranges " << rangeTime << " ms("
+		<< numRangeCopies / numFrames << " copies)" << std::endl;
+
+	TEST_CHECK(std::memcmp(perElement.data(), ranged.data(), numElements * sizeof(Element)) == 0);
+	TEST_CHECK(numRangeCopies * 4 < numElementCopies);
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "Test/TestCase.h"
+#include "DX12Game/DrawPacket.h"
+#include "DX12Game/MockCommandRecorder.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <thread>
+
+using namespace Game;
+
+namespace {
+	struct MockDraw {
+		std::uint32_t mPipeline;
+		std::uint32_t mGeometry;
+		std::uint32_t mMaterial;
+		std::uint32_t mTopology;
+		float mDepth;
+	};
+
+	const std::uint32_t NumPipelines = 4;
+	const std::uint32_t NumGeometries = 32;
+
+	//* Pipelines and geometries stand in for the objects the renderer binds.
+	char gPipelines[NumPipelines];
+	char gGeometries[NumGeometries];
+
+	std::vector<MockDraw> BuildDraws(std::uint32_t inNumDraws) {
+		std::mt19937 rng(29);
+		std::uniform_int_distribution<std::uint32_t> pipelineDist(0, NumPipelines - 1);
+		std::uniform_int_distribution<std::uint32_t> geometryDist(0, NumGeometries - 1);
+		std::uniform_real_distribution<float> depthDist(0.0f, 1.0f);
+
+		std::vector<MockDraw> draws(inNumDraws);
+		for (auto& draw : draws) {
+			draw.mPipeline = pipelineDist(rng);
+			draw.mGeometry = geometryDist(rng);
+			draw.mMaterial = draw.mGeometry % 8;
+			// The topology comes with the pipeline state.
+			draw.mTopology = draw.mPipeline == 0 ? 1 : 4;
+			draw.mDepth = depthDist(rng);
+		}
+
+		return draws;
+	}
+
+	std::vector<DrawPacket> BuildPackets(const std::vector<MockDraw>& inDraws) {
+		std::vector<DrawPacket> packets;
+		for (std::uint32_t i = 0, end = static_cast<std::uint32_t>(inDraws.size()); i < end; ++i) {
+			const auto& draw = inDraws[i];
+			packets.push_back({ DrawSortKey::Build(0, draw.mPipeline, draw.mGeometry, draw.mMaterial, draw.mDepth), i });
+		}
+
+		return packets;
+	}
+
+	void Record(MockCommandRecorder& ioRecorder, const std::vector<MockDraw>& inDraws, const std::vector<DrawPacket>& inPackets) {
+		ioRecorder.Reset();
+
+		for (const auto& packet : inPackets) {
+			const auto& draw = inDraws[packet.mIndex];
+			ioRecorder.SetPipelineState(&gPipelines[draw.mPipeline]);
+			ioRecorder.DrawIndexedInstanced(&gGeometries[draw.mGeometry], draw.mTopology, packet.mIndex * 256ull, 36, 1);
+		}
+	}
+
+	//* Blocks until inNumThreads threads arrive; never reports termination.
+	class Barrier {
+	public:
+		Barrier(std::uint32_t inNumThreads) : mNumThreads(inNumThreads) {}
+
+	public:
+		bool Wait() {
+			std::unique_lock<std::mutex> lock(mMutex);
+
+			std::uint32_t generation = mGeneration;
+			if (++mNumArrived == mNumThreads) {
+				mNumArrived = 0;
+				++mGeneration;
+				mCondition.notify_all();
+			}
+			else {
+				mCondition.wait(lock, [&]() { return mGeneration != generation; });
+			}
+
+			return false;
+		}
+
+	private:
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		std::uint32_t mNumThreads;
+		std::uint32_t mNumArrived = 0;
+		std::uint32_t mGeneration = 0;
+	};
+}
+
+TEST_CASE(DrawPacket_KeyFieldsRoundTrip) {
+	std::uint64_t key = DrawSortKey::Build(3, 200, 40000, 1000, 0.5f);
+	TEST_CHECK(DrawSortKey::GetPass(key) == 3);
+	TEST_CHECK(DrawSortKey::GetPipeline(key) == 200);
+	TEST_CHECK(DrawSortKey::GetGeometry(key) == 40000);
+	TEST_CHECK(DrawSortKey::GetMaterial(key) == 1000);
+
+	// Opaque draws front-to-back, blended ones back-to-front.
+	TEST_CHECK(DrawSortKey::Build(0, 0, 0, 0, 0.1f) < DrawSortKey::Build(0, 0, 0, 0, 0.9f));
+	TEST_CHECK(DrawSortKey::Build(0, 0, 0, 0, 0.1f, true) > DrawSortKey::Build(0, 0, 0, 0, 0.9f, true));
+	// The pass outranks every other field.
+	TEST_CHECK(DrawSortKey::Build(0, 255, 65535, 4095, 1.0f) < DrawSortKey::Build(1, 0, 0, 0, 0.0f));
+}
+
+TEST_CASE(DrawPacket_SorterMatchesStableSort) {
+	auto draws = BuildDraws(5000);
+	auto packets = BuildPackets(draws);
+
+	auto expected = packets;
+	std::stable_sort(expected.begin(), expected.end(), [](const DrawPacket& inLhs, const DrawPacket& inRhs) {
+		return inLhs.mKey < inRhs.mKey;
+	});
+
+	auto single = packets;
+	DrawPacketSorter sorter;
+	sorter.Sort(single);
+
+	const std::uint32_t numThreads = 4;
+	auto parallel = packets;
+	DrawPacketSorter parallelSorter;
+	parallelSorter.Initialize(numThreads, 256);
+
+	Barrier barrier(numThreads);
+	std::vector<std::thread> threads;
+	for (std::uint32_t tid = 0; tid < numThreads; ++tid) {
+		threads.emplace_back([&, tid]() {
+			parallelSorter.Sort(parallel, tid, [&barrier]() { return barrier.Wait(); });
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	for (size_t i = 0, end = expected.size(); i < end; ++i) {
+		TEST_CHECK(single[i].mKey == expected[i].mKey && single[i].mIndex == expected[i].mIndex);
+		TEST_CHECK(parallel[i].mKey == expected[i].mKey && parallel[i].mIndex == expected[i].mIndex);
+	}
+}
+
+TEST_CASE(MockCommandRecorder_SortedDrawsSkipRedundantBinds) {
+	auto draws = BuildDraws(2000);
+	auto packets = BuildPackets(draws);
+
+	MockCommandRecorder recorder;
+	Record(recorder, draws, packets);
+
+	const auto unsortedCommands = recorder.GetNumCommands();
+	const auto naiveCommands = recorder.GetNumNaiveCommands();
+	const auto numIndices = recorder.GetNumIndices();
+	TEST_CHECK(naiveCommands == 2000 * 6);
+	TEST_CHECK(unsortedCommands <= naiveCommands);
+
+	DrawPacketSorter sorter;
+	sorter.Sort(packets);
+	Record(recorder, draws, packets);
+
+	const auto& stats = recorder.GetStatistics();
+	TEST_CHECK(stats.mNumDraws == 2000);
+	// Once sorted, each pipeline and each geometry under it is bound once.
+	TEST_CHECK(stats.mNumPipelineChanges == NumPipelines);
+	TEST_CHECK(stats.mNumGeometryChanges <= NumPipelines * NumGeometries);
+	TEST_CHECK(stats.mNumTopologyChanges <= NumPipelines);
+	TEST_CHECK(recorder.GetNumNaiveCommands() == naiveCommands);
+	TEST_CHECK(recorder.GetNumIndices() == numIndices);
+	TEST_CHECK(recorder.GetNumCommands() < unsortedCommands);
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "Test/TestCase.h"
+#include "DX12Game/DrawPartitioner.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace Game;
+
+namespace {
+	//* The boundaries must start at 0, end at the number of items and never decrease,
+	//*  so every item is recorded by exactly one part and the order of the list is kept.
+	bool CoversAllItems(const std::vector<std::uint32_t>& inBounds, std::uint32_t inNumParts, std::uint32_t inNumItems) {
+		if (inBounds.size() != inNumParts + 1 || inBounds.front() != 0 || inBounds.back() != inNumItems)
+			return false;
+		return std::is_sorted(inBounds.begin(), inBounds.end());
+	}
+
+	std::uint64_t GetPartCost(const std::vector<std::uint64_t>& inCosts, const std::vector<std::uint32_t>& inBounds, size_t inPart) {
+		std::uint64_t cost = 0;
+		for (auto i = inBounds[inPart]; i < inBounds[inPart + 1]; ++i)
+			cost += inCosts[i];
+		return cost;
+	}
+}
+
+TEST_CASE(DrawPartitioner_EstimatesCost) {
+	TEST_CHECK(DrawPartitioner::EstimateCost(0, 0, 0) == DrawPartitioner::DefaultDrawCost);
+	TEST_CHECK(DrawPartitioner::EstimateCost(300, 10, 2) ==
+		3000 + DrawPartitioner::DefaultDrawCost + 2 * DrawPartitioner::DefaultStateChangeCost);
+	TEST_CHECK(DrawPartitioner::EstimateCost(36, 2, 3, 1, 5) == 72 + 1 + 15);
+
+	// The product doesn't wrap around in 32 bits.
+	TEST_CHECK(DrawPartitioner::EstimateCost(0xFFFFFFFF, 2, 0, 0, 0) == 0x1FFFFFFFEull);
+}
+
+TEST_CASE(DrawPartitioner_SplitsEqualCostsEvenly) {
+	std::vector<std::uint64_t> costs(12, 100);
+	std::vector<std::uint32_t> bounds;
+
+	DrawPartitioner::Partition(costs, 4, bounds);
+	TEST_CHECK((bounds == std::vector<std::uint32_t>{ 0, 3, 6, 9, 12 }));
+
+	DrawPartitioner::Partition(costs, 1, bounds);
+	TEST_CHECK((bounds == std::vector<std::uint32_t>{ 0, 12 }));
+
+	// No part is treated as one part.
+	DrawPartitioner::Partition(costs, 0, bounds);
+	TEST_CHECK((bounds == std::vector<std::uint32_t>{ 0, 12 }));
+}
+
+TEST_CASE(DrawPartitioner_BalancesUnevenCosts) {
+	// A heavy draw takes a part for itself; the light ones share the others.
+	std::vector<std::uint64_t> costs = { 10, 10, 10, 10, 400, 10, 10, 10, 10, 10, 10, 10, 10 };
+	std::vector<std::uint32_t> bounds;
+
+	DrawPartitioner::Partition(costs, 3, bounds);
+	TEST_CHECK(CoversAllItems(bounds, 3, 13));
+	TEST_CHECK(bounds[1] == 4 && bounds[2] == 5);
+	TEST_CHECK(GetPartCost(costs, bounds, 1) == 400);
+
+	// The boundary goes to the closer of the two prefix sums around the ideal share.
+	costs = { 40, 5, 55 };
+	DrawPartitioner::Partition(costs, 2, bounds);
+	TEST_CHECK((bounds == std::vector<std::uint32_t>{ 0, 2, 3 }));
+
+	costs = { 40, 25, 35 };
+	DrawPartitioner::Partition(costs, 2, bounds);
+	TEST_CHECK((bounds == std::vector<std::uint32_t>{ 0, 1, 3 }));
+}
+
+TEST_CASE(DrawPartitioner_HandlesFewItems) {
+	std::vector<std::uint32_t> bounds;
+
+	// More parts than draws; the extra parts are empty.
+	DrawPartitioner::Partition({ 5, 5 }, 4, bounds);
+	TEST_CHECK(CoversAllItems(bounds, 4, 2));
+
+	std::uint32_t numNonEmpty = 0;
+	for (size_t part = 0; part < 4; ++part)
+		numNonEmpty += bounds[part + 1] > bounds[part] ? 1 : 0;
+	TEST_CHECK(numNonEmpty == 2);
+
+	DrawPartitioner::Partition({}, 3, bounds);
+	TEST_CHECK((bounds == std::vector<std::uint32_t>{ 0, 0, 0, 0 }));
+
+	DrawPartitioner::Partition({ 0, 0, 0 }, 2, bounds);
+	TEST_CHECK(CoversAllItems(bounds, 2, 3));
+}
+
+TEST_CASE(DrawPartitioner_RandomListsStayBalanced) {
+	std::mt19937 rng(8);
+	for (int iteration = 0; iteration < 200; ++iteration) {
+		std::uint32_t numItems = 1 + rng() % 2000;
+		std::uint32_t numParts = 1 + rng() % 16;
+
+		std::vector<std::uint64_t> costs(numItems);
+		std::uint64_t total = 0;
+		std::uint64_t maxCost = 0;
+		for (auto& cost : costs) {
+			cost = DrawPartitioner::EstimateCost(rng() % 30000, 1 + rng() % 64, rng() % 3);
+			total += cost;
+			maxCost = std::max(maxCost, cost);
+		}
+
+		std::vector<std::uint32_t> bounds;
+		DrawPartitioner::Partition(costs, numParts, bounds);
+		TEST_CHECK(CoversAllItems(bounds, numParts, numItems));
+
+		// Each boundary is within half an item of its ideal share, so no part exceeds the share by more than one item.
+		std::uint64_t covered = 0;
+		for (std::uint32_t part = 0; part < numParts; ++part) {
+			std::uint64_t cost = GetPartCost(costs, bounds, part);
+			TEST_CHECK(cost <= total / numParts + maxCost + 1);
+			covered += cost;
+		}
+		TEST_CHECK(covered == total);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "Test/TestCase.h"
+#include "DX12Game/ImportCache.h"
+#include "common/MappedFile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace Game;
+
+namespace {
+	std::string GetCacheDirectory() {
+		return (std::filesystem::temp_directory_path() / "ImportCacheTest").string();
+	}
+
+	bool WriteFile(const std::string& inFileName, const std::string& inContents) {
+		std::ofstream file(inFileName, std::ios::binary | std::ios::trunc);
+		file.write(inContents.data(), inContents.size());
+		return file.good();
+	}
+
+	std::string ReadFile(const std::string& inFileName) {
+		MappedFile file;
+		if (!file.Open(inFileName))
+			return {};
+
+		return std::string(reinterpret_cast<const char*>(file.GetData()), static_cast<size_t>(file.GetSize()));
+	}
+
+	//* Bytes 3, 10, 17, ... so every length has a different tail.
+	std::vector<std::uint8_t> BuildSequence(size_t inSize) {
+		std::vector<std::uint8_t> data(inSize);
+		for (size_t i = 0; i < inSize; ++i)
+			data[i] = static_cast<std::uint8_t>(i * 7 + 3);
+		return data;
+	}
+}
+
+TEST_CASE(ImportCache_HashMatchesReferenceXxHash64) {
+	// The values of the reference implementation(XXH64).
+	TEST_CHECK(ImportCache::Hash("", 0) == 0xEF46DB3751D8E999ull);
+	TEST_CHECK(ImportCache::Hash("", 0, 1) == 0xD5AFBA1336A3BE4Bull);
+	TEST_CHECK(ImportCache::Hash("a", 1) == 0xD24EC4F1A98C6E5Bull);
+	TEST_CHECK(ImportCache::Hash("abc", 3) == 0x44BC2CF5AD770999ull);
+	TEST_CHECK(ImportCache::Hash("abc", 3, 0x9E3779B185EBCA87ull) == 0xA7CB2AAC405E36C7ull);
+
+	const char* fox = "The quick brown fox jumps over the lazy dog";
+	TEST_CHECK(ImportCache::Hash(fox, std::strlen(fox)) == 0x0B242D361FDA71BCull);
+
+	// The lanes followed by an 8, a 4 and a 1 byte tail, several lane rounds, and a large buffer.
+	auto data = BuildSequence(4096);
+	TEST_CHECK(ImportCache::Hash(data.data(), 45) == 0x86FAEE00897C4B41ull);
+	TEST_CHECK(ImportCache::Hash(data.data(), 45, 1) == 0xB92A1C5AD80EED36ull);
+	TEST_CHECK(ImportCache::Hash(data.data(), 103) == 0x9CE1E302796DFBC9ull);
+	TEST_CHECK(ImportCache::Hash(data.data(), 103, 1) == 0x8620CA5F9467E837ull);
+	TEST_CHECK(ImportCache::Hash(data.data(), 4096) == 0x796398CD432797CCull);
+	TEST_CHECK(ImportCache::Hash(data.data(), 4096, 1) == 0x22154CB5A9B7BBEFull);
+}
+
+TEST_CASE(ImportCache_KeyFollowsContentsAndOptions) {
+	std::string directory = GetCacheDirectory();
+	std::filesystem::remove_all(directory);
+
+	ImportCache cache;
+	TEST_CHECK(cache.Initialize(directory));
+
+	std::string source = directory + "/source.fbx";
+	std::string copy = directory + "/renamed.fbx";
+	TEST_CHECK(WriteFile(source, "mesh contents"));
+	TEST_CHECK(WriteFile(copy, "mesh contents"));
+
+	std::uint64_t key = 0;
+	TEST_CHECK(cache.ComputeKey(source, 5, 1, key));
+
+	// The key only depends on the contents, the options and the versions.
+	std::uint64_t other = 0;
+	TEST_CHECK(cache.ComputeKey(copy, 5, 1, other) && other == key);
+
+	const std::uint64_t header[] = { 5, ImportCache::ImporterVersion, 1, 13 };
+	TEST_CHECK(key == ImportCache::Hash("mesh contents", 13, ImportCache::Hash(header, sizeof(header))));
+
+	// A newer importer misses the entries cooked by the older one.
+	const std::uint64_t newerHeader[] = { 5, ImportCache::ImporterVersion + 1, 1, 13 };
+	TEST_CHECK(key != ImportCache::Hash("mesh contents", 13, ImportCache::Hash(newerHeader, sizeof(newerHeader))));
+
+	TEST_CHECK(cache.ComputeKey(source, 6, 1, other) && other != key);
+	TEST_CHECK(cache.ComputeKey(source, 5, 2, other) && other != key);
+
+	// Edited in place, and grown with the same leading bytes.
+	TEST_CHECK(WriteFile(source, "mesh Contents"));
+	TEST_CHECK(cache.ComputeKey(source, 5, 1, other) && other != key);
+	TEST_CHECK(WriteFile(source, "mesh contents "));
+	TEST_CHECK(cache.ComputeKey(source, 5, 1, other) && other != key);
+
+	TEST_CHECK(!cache.ComputeKey(directory + "/missing.fbx", 5, 1, other));
+
+	std::filesystem::remove_all(directory);
+}
+
+TEST_CASE(ImportCache_CommitsAndReplacesEntries) {
+	std::string directory = GetCacheDirectory();
+	std::filesystem::remove_all(directory);
+
+	ImportCache cache;
+	TEST_CHECK(cache.Initialize(directory));
+
+	const std::uint64_t key = 0x00000000DEADBEEFull;
+	std::string entry = cache.GetFilePath(key, ".cmesh");
+	TEST_CHECK(entry == directory + "/00000000deadbeef.cmesh");
+
+	// Every temporary file is unique and sits next to the entry.
+	std::string temp = cache.GetTempFilePath(key, ".cmesh");
+	std::string nextTemp = cache.GetTempFilePath(key, ".cmesh");
+	TEST_CHECK(temp != nextTemp);
+	TEST_CHECK(temp.compare(0, entry.size(), entry) == 0);
+
+	TEST_CHECK(WriteFile(temp, "first"));
+	TEST_CHECK(cache.Commit(temp, key, ".cmesh"));
+	TEST_CHECK(!std::filesystem::exists(temp));
+	TEST_CHECK(ReadFile(entry) == "first");
+
+	// A rejected entry is overwritten by the next import.
+	TEST_CHECK(WriteFile(nextTemp, "second"));
+	TEST_CHECK(cache.Commit(nextTemp, key, ".cmesh"));
+	TEST_CHECK(!std::filesystem::exists(nextTemp));
+	TEST_CHECK(ReadFile(entry) == "second");
+
+	// A temporary file that doesn't exist can't be committed, and the entry is kept.
+	TEST_CHECK(!cache.Commit(directory + "/missing.tmp", key, ".cmesh"));
+	TEST_CHECK(ReadFile(entry) == "second");
+
+	std::filesystem::remove_all(directory);
+}
+
+TEST_CASE(ImportCache_DiscardsTemporaryFiles) {
+	std::string directory = GetCacheDirectory();
+	std::filesystem::remove_all(directory);
+
+	ImportCache cache;
+	TEST_CHECK(cache.Initialize(directory + "/"));
+
+	std::string temp = cache.GetTempFilePath(1, ".cmesh");
+	TEST_CHECK(WriteFile(temp, "partial"));
+
+	cache.Discard(temp);
+	TEST_CHECK(!std::filesystem::exists(temp));
+	TEST_CHECK(!std::filesystem::exists(cache.GetFilePath(1, ".cmesh")));
+
+	// Discarding twice is harmless.
+	cache.Discard(temp);
+
+	std::filesystem::remove_all(directory);
+}
+
+TEST_CASE(ImportCache_RecordsStatistics) {
+	ImportCache cache;
+	cache.RecordHit(0.25f);
+	cache.RecordHit(0.5f);
+	cache.RecordMiss(2.0f);
+
+	auto stats = cache.GetStatistics();
+	TEST_CHECK(stats.mNumHits == 2 && stats.mNumMisses == 1);
+	TEST_CHECK_NEAR(stats.mHitTime, 0.75f, 1e-5f);
+	TEST_CHECK_NEAR(stats.mMissTime, 2.0f, 1e-5f);
+}
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "Test/TestCase.h"
+#include "DX12Game/InstanceAllocator.h"
+
+#include <random>
+#include <vector>
+
+using namespace Game;
+
+namespace {
+	//* Live ranges must stay inside the capacity and never share a slot.
+	bool AreRangesDisjoint(const InstanceAllocator& inAllocator, const std::vector<InstanceAllocator::Handle>& inHandles) {
+		std::vector<bool> used(inAllocator.GetCapacity(), false);
+		for (auto handle : inHandles) {
+			std::uint32_t offset = inAllocator.GetOffset(handle);
+			std::uint32_t size = inAllocator.GetSize(handle);
+			if (offset + size > inAllocator.GetCapacity())
+				return false;
+
+			for (std::uint32_t slot = offset; slot < offset + size; ++slot) {
+				if (used[slot])
+					return false;
+				used[slot] = true;
+			}
+		}
+		return true;
+	}
+}
+
+TEST_CASE(InstanceAllocator_AllocatesRoundedRanges) {
+	InstanceAllocator allocator;
+	allocator.Initialize(64, 8);
+
+	auto a = allocator.Allocate(3);
+	auto b = allocator.Allocate(8);
+	auto c = allocator.Allocate(0);
+	TEST_CHECK(allocator.GetOffset(a) == 0 && allocator.GetSize(a) == 8);
+	TEST_CHECK(allocator.GetOffset(b) == 8 && allocator.GetSize(b) == 8);
+	// An empty range still takes one granule, so its offset is unique.
+	TEST_CHECK(allocator.GetOffset(c) == 16 && allocator.GetSize(c) == 8);
+
+	auto stats = allocator.GetStatistics();
+	TEST_CHECK(stats.mCapacity == 64);
+	TEST_CHECK(stats.mReserved == 24);
+	TEST_CHECK(stats.mNumRanges == 3);
+	TEST_CHECK(stats.mNumFreeBlocks == 1 && stats.mLargestFreeBlock == 40);
+	TEST_CHECK(stats.mFragmentation == 0.0f);
+}
+
+TEST_CASE(InstanceAllocator_GrowsAndBumpsGeneration) {
+	InstanceAllocator allocator;
+	allocator.Initialize(16, 8);
+
+	auto a = allocator.Allocate(16);
+	auto generation = allocator.GetGeneration();
+
+	// No free block; the capacity at least doubles.
+	auto b = allocator.Allocate(40);
+	TEST_CHECK(allocator.GetCapacity() == 56);
+	TEST_CHECK(allocator.GetOffset(b) == 16);
+	TEST_CHECK(allocator.GetGeneration() != generation);
+	TEST_CHECK(allocator.GetOffset(a) == 0);
+
+	// Allocating from the free space doesn't move anything.
+	allocator.Free(b);
+	generation = allocator.GetGeneration();
+	allocator.Allocate(8);
+	TEST_CHECK(allocator.GetGeneration() == generation);
+}
+
+TEST_CASE(InstanceAllocator_FreeMergesAndReusesHandles) {
+	InstanceAllocator allocator;
+	allocator.Initialize(32, 8);
+
+	InstanceAllocator::Handle handles[4];
+	for (auto& handle : handles)
+		handle = allocator.Allocate(8);
+
+	allocator.Free(handles[0]);
+	allocator.Free(handles[2]);
+	auto stats = allocator.GetStatistics();
+	TEST_CHECK(stats.mNumFreeBlocks == 2 && stats.mReserved == 16 && stats.mNumRanges == 2);
+	TEST_CHECK_NEAR(stats.mFragmentation, 0.5f, 1e-6f);
+
+	// Freeing twice is ignored.
+	allocator.Free(handles[2]);
+	TEST_CHECK(allocator.GetStatistics().mReserved == 16);
+
+	// The block between the two free blocks merges with both.
+	allocator.Free(handles[1]);
+	stats = allocator.GetStatistics();
+	TEST_CHECK(stats.mNumFreeBlocks == 1 && stats.mLargestFreeBlock == 24);
+
+	// The freed handles are reused and the first fit is taken.
+	auto reused = allocator.Allocate(16);
+	TEST_CHECK(reused == handles[1]);
+	TEST_CHECK(allocator.GetOffset(reused) == 0);
+}
+
+TEST_CASE(InstanceAllocator_ReservesInPlaceOrMoves) {
+	InstanceAllocator allocator;
+	allocator.Initialize(64, 8);
+
+	auto a = allocator.Allocate(8);
+	auto b = allocator.Allocate(8);
+	allocator.Allocate(8);
+	allocator.Free(b);
+
+	// The following block is free; the range doubles in place.
+	auto generation = allocator.GetGeneration();
+	TEST_CHECK(!allocator.Reserve(a, 12));
+	TEST_CHECK(allocator.GetOffset(a) == 0 && allocator.GetSize(a) == 16);
+	TEST_CHECK(allocator.GetGeneration() == generation);
+
+	// Already large enough.
+	TEST_CHECK(!allocator.Reserve(a, 16));
+
+	// Blocked by the third range; the range moves and its old slots are freed.
+	TEST_CHECK(allocator.Reserve(a, 20));
+	TEST_CHECK(allocator.GetOffset(a) == 24 && allocator.GetSize(a) == 32);
+	TEST_CHECK(allocator.GetGeneration() != generation);
+
+	auto stats = allocator.GetStatistics();
+	TEST_CHECK(stats.mReserved == 40);
+	TEST_CHECK(stats.mNumFreeBlocks == 2 && stats.mLargestFreeBlock == 16);
+}
+
+TEST_CASE(InstanceAllocator_DefragmentsScatteredSlots) {
+	InstanceAllocator allocator;
+	allocator.Initialize(64, 8);
+
+	InstanceAllocator::Handle handles[8];
+	for (auto& handle : handles)
+		handle = allocator.Allocate(8);
+
+	// Only the tail is free; nothing to do.
+	allocator.Free(handles[7]);
+	TEST_CHECK(!allocator.Defragment());
+
+	for (int i = 0; i < 7; i += 2)
+		allocator.Free(handles[i]);
+	TEST_CHECK(allocator.GetStatistics().mFragmentation > 0.5f);
+
+	// Under the threshold no range is moved.
+	auto generation = allocator.GetGeneration();
+	TEST_CHECK(!allocator.Defragment(0.9f));
+	TEST_CHECK(allocator.GetGeneration() == generation);
+
+	TEST_CHECK(allocator.Defragment());
+	TEST_CHECK(allocator.GetGeneration() != generation);
+
+	// The live ranges are packed in their order.
+	TEST_CHECK(allocator.GetOffset(handles[1]) == 0);
+	TEST_CHECK(allocator.GetOffset(handles[3]) == 8);
+	TEST_CHECK(allocator.GetOffset(handles[5]) == 16);
+
+	auto stats = allocator.GetStatistics();
+	TEST_CHECK(stats.mNumFreeBlocks == 1 && stats.mLargestFreeBlock == 40);
+	TEST_CHECK(stats.mFragmentation == 0.0f);
+
+	// Already packed.
+	TEST_CHECK(!allocator.Compact());
+}
+
+TEST_CASE(InstanceAllocator_RandomRangesNeverOverlap) {
+	InstanceAllocator allocator;
+	allocator.Initialize(256);
+
+	std::vector<InstanceAllocator::Handle> handles;
+	std::vector<std::uint32_t> counts;
+
+	std::mt19937 rng(2);
+	for (int i = 0; i < 5000; ++i) {
+		switch (rng() % 4) {
+		case 0:
+		case 1:
+			counts.push_back(1 + rng() % 100);
+			handles.push_back(allocator.Allocate(counts.back()));
+			break;
+		case 2:
+			if (!handles.empty()) {
+				size_t index = rng() % handles.size();
+				counts[index] += rng() % 64;
+				allocator.Reserve(handles[index], counts[index]);
+			}
+			break;
+		default:
+			if (!handles.empty()) {
+				size_t index = rng() % handles.size();
+				allocator.Free(handles[index]);
+				handles.erase(handles.begin() + index);
+				counts.erase(counts.begin() + index);
+			}
+			break;
+		}
+
+		if (i % 100 == 0)
+			allocator.Defragment();
+
+		if (i % 50 == 0)
+			TEST_CHECK(AreRangesDisjoint(allocator, handles));
+	}
+
+	std::uint32_t reserved = 0;
+	for (size_t i = 0; i < handles.size(); ++i) {
+		TEST_CHECK(allocator.GetSize(handles[i]) >= counts[i]);
+		reserved += allocator.GetSize(handles[i]);
+	}
+
+	auto stats = allocator.GetStatistics();
+	TEST_CHECK(stats.mReserved == reserved);
+	TEST_CHECK(stats.mNumRanges == handles.size());
+	TEST_CHECK(AreRangesDisjoint(allocator, handles));
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "Test/TestCase.h"
+#include "common/MathHelper.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+	const std::uint32_t NumKeys = 4000;
+	const float KeyInterval = 1.0f / 30.0f;
+
+	//* Key times of a long clip; every third key is held twice as long, like a reduced curve.
+	std::vector<float> BuildKeyTimes() {
+		std::vector<float> times(NumKeys);
+		float time = 0.0f;
+		for (std::uint32_t i = 0; i < NumKeys; ++i) {
+			times[i] = time;
+			time += i % 3 == 0 ? 2.0f * KeyInterval : KeyInterval;
+		}
+		return times;
+	}
+
+	bool IsSegmentOf(const std::vector<float>& inTimes, std::uint32_t inSegment, float inTime) {
+		if (inSegment + 1 >= inTimes.size() || inTime < inTimes[inSegment])
+			return false;
+		return inTime < inTimes[inSegment + 1] || inSegment + 2 == inTimes.size();
+	}
+
+	//* The lookup every update did before the cursor: scan from the first key.
+	std::uint32_t LinearSearch(const std::vector<float>& inTimes, float inTime) {
+		std::uint32_t i = 0;
+		while (i + 2 < inTimes.size() && inTimes[i + 1] <= inTime)
+			++i;
+		return i;
+	}
+
+	template <typename Func>
+	double MeasureMilliseconds(Func&& inFunc) {
+		auto begin = std::chrono::steady_clock::now();
+		inFunc();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+}
+
+TEST_CASE(KeyframeLookup_FindsSegments) {
+	auto times = BuildKeyTimes();
+	const float duration = times.back();
+
+	// Played forward at a few update rates; the cursor moves on by one or more keys per update.
+	for (float step : { 0.25f * KeyInterval, KeyInterval, 3.5f * KeyInterval }) {
+		std::uint32_t cursor = 0;
+		for (float t = 0.0f; t < duration; t += step) {
+			cursor = MathHelper::FindKeyframe(times.data(), NumKeys, t, cursor);
+			TEST_CHECK(IsSegmentOf(times, cursor, t));
+		}
+	}
+
+	// Seeks back and far ahead fall back to the binary search; the last key belongs to the last segment.
+	std::uint32_t cursor = NumKeys / 2;
+	for (float t : { 1.0f, duration * 0.9f, 0.0f, duration, duration * 0.5f }) {
+		cursor = MathHelper::FindKeyframe(times.data(), NumKeys, t, cursor);
+		TEST_CHECK(IsSegmentOf(times, cursor, t));
+	}
+
+	// A stale cursor past the keys is ignored.
+	TEST_CHECK(IsSegmentOf(times, MathHelper::FindKeyframe(times.data(), NumKeys, 2.0f, NumKeys + 10), 2.0f));
+
+	const float twoKeys[] = { 0.0f, 1.0f };
+	TEST_CHECK(MathHelper::FindKeyframe(twoKeys, 2, 0.5f, 0) == 0);
+	TEST_CHECK(MathHelper::FindKeyframe(twoKeys, 2, 1.0f, 0) == 0);
+}
+
+TEST_CASE(KeyframeLookup_CursorBenchmark) {
+	auto times = BuildKeyTimes();
+	const float duration = times.back();
+
+	// A crowd of characters playing the clip at 60 updates per second.
+	const float step = 0.5f * KeyInterval;
+	const int numPlaybacks = 4;
+
+	std::uint64_t checksum[3] = {};
+
+	double linear = MeasureMilliseconds([&] {
+		for (int i = 0; i < numPlaybacks; ++i) {
+			for (float t = 0.0f; t < duration; t += step)
+				checksum[0] += LinearSearch(times, t);
+		}
+	});
+
+	double binary = MeasureMilliseconds([&] {
+		for (int i = 0; i < numPlaybacks; ++i) {
+			for (float t = 0.0f; t < duration; t += step) {
+				auto iter = std::upper_bound(times.begin(), times.end(), t);
+				checksum[1] += std::min(static_cast<std::uint32_t>(iter - times.begin()) - 1, NumKeys - 2);
+			}
+		}
+	});
+
+	double cursor = MeasureMilliseconds([&] {
+		for (int i = 0; i < numPlaybacks; ++i) {
+			std::uint32_t key = 0;
+			for (float t = 0.0f; t < duration; t += step) {
+				key = MathHelper::FindKeyframe(times.data(), NumKeys, t, key);
+				checksum[2] += key;
+			}
+		}
+	});
+
+	std::cout << "  " << NumKeys << " keys, linear " << linear << " ms, binary " << binary
+		<< " ms, cursor " << cursor << " ms" << std::endl;
+
+	TEST_CHECK(checksum[0] == checksum[1] && checksum[1] == checksum[2]);
+	TEST_CHECK(cursor < linear);
+}
\ No newline at end of file
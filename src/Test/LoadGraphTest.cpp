@@ -0,0 +1,162 @@
+#include "Test/TestCase.h"
+#include "DX12Game/AssetLoader.h"
+#include "DX12Game/LoadGraph.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace Game;
+
+namespace {
+	//* Records the issued nodes; the test completes them by hand.
+	LoadGraph::IssueFunc Record(std::vector<LoadGraph::NodeId>& outIssued) {
+		return [&outIssued](LoadGraph::NodeId inNode) { outIssued.push_back(inNode); };
+	}
+}
+
+TEST_CASE(LoadGraph_IssuesNodesAsDependenciesComplete) {
+	std::vector<LoadGraph::NodeId> issued;
+
+	// Two textures, a mesh that needs both, and a level that needs the mesh.
+	LoadGraph graph;
+	auto diffuse = graph.AddNode("diffuse.dds", Record(issued));
+	auto normal = graph.AddNode("normal.dds", Record(issued));
+	auto mesh = graph.AddNode("mesh.fbx", Record(issued));
+	auto level = graph.AddNode("level", Record(issued));
+
+	TEST_CHECK(graph.AddNode("diffuse.dds", Record(issued)) == diffuse);
+	TEST_CHECK(graph.FindNode("mesh.fbx") == mesh);
+	TEST_CHECK(graph.FindNode("missing") == LoadGraph::InvalidNode);
+
+	TEST_CHECK(graph.AddDependency(mesh, diffuse));
+	TEST_CHECK(graph.AddDependency(mesh, normal));
+	TEST_CHECK(graph.AddDependency(level, mesh));
+	TEST_CHECK(!graph.AddDependency(level, level));
+
+	TEST_CHECK(graph.Submit());
+	TEST_CHECK(graph.AddNode("late", nullptr) == LoadGraph::InvalidNode);
+	TEST_CHECK(!graph.AddDependency(level, diffuse));
+
+	// The independent assets are issued together.
+	TEST_CHECK(issued.size() == 2);
+
+	graph.Complete(diffuse, true);
+	TEST_CHECK(issued.size() == 2);
+
+	graph.Complete(normal, true);
+	TEST_CHECK(issued.size() == 3 && issued.back() == mesh);
+
+	graph.Complete(mesh, true);
+	TEST_CHECK(issued.size() == 4 && issued.back() == level);
+	TEST_CHECK(!graph.IsDone());
+
+	graph.Complete(level, true);
+	TEST_CHECK(graph.IsDone());
+
+	std::vector<LoadTimelineEntry> timeline;
+	graph.GetTimeline(timeline);
+	TEST_CHECK(timeline.size() == 4 && timeline[level].mName == "level");
+	for (const auto& entry : timeline)
+		TEST_CHECK(entry.bSucceeded && entry.mIssueTime >= 0.0f && entry.mCompleteTime >= entry.mIssueTime);
+}
+
+TEST_CASE(LoadGraph_FailureSkipsDependents) {
+	std::vector<LoadGraph::NodeId> issued;
+
+	LoadGraph graph;
+	auto texture = graph.AddNode("texture", Record(issued));
+	auto material = graph.AddNode("material", Record(issued));
+	auto mesh = graph.AddNode("mesh", Record(issued));
+	auto other = graph.AddNode("other", Record(issued));
+	graph.AddDependency(material, texture);
+	graph.AddDependency(mesh, material);
+
+	TEST_CHECK(graph.Submit());
+	TEST_CHECK(issued.size() == 2);
+
+	graph.Complete(texture, false);
+	TEST_CHECK(!graph.IsDone());
+
+	graph.Complete(other, true);
+	TEST_CHECK(graph.IsDone());
+	TEST_CHECK(issued.size() == 2);
+
+	std::vector<LoadTimelineEntry> timeline;
+	graph.GetTimeline(timeline);
+	TEST_CHECK(!timeline[texture].bSucceeded && timeline[texture].mCompleteTime >= 0.0f);
+	TEST_CHECK(!timeline[mesh].bSucceeded && timeline[mesh].mIssueTime < 0.0f);
+	TEST_CHECK(timeline[other].bSucceeded);
+}
+
+TEST_CASE(LoadGraph_RejectsCycles) {
+	std::vector<LoadGraph::NodeId> issued;
+
+	LoadGraph graph;
+	auto root = graph.AddNode("root", Record(issued));
+	auto a = graph.AddNode("a", Record(issued));
+	auto b = graph.AddNode("b", Record(issued));
+	graph.AddDependency(a, root);
+	graph.AddDependency(b, a);
+	graph.AddDependency(a, b);
+
+	TEST_CHECK(!graph.Submit());
+	TEST_CHECK(!graph.IsSubmitted());
+	TEST_CHECK(issued.empty());
+}
+
+TEST_CASE(LoadGraph_DrivesAssetLoader) {
+	AssetLoader loader;
+	loader.Initialize(4);
+
+	LoadGraph graph;
+	std::vector<LoadGraph::NodeId> textures;
+
+	// Each texture is loaded in the background; the nodes are completed on this thread by Pump.
+	for (std::uint32_t i = 0; i < 8; ++i) {
+		std::string name = "texture" + std::to_string(i);
+		textures.push_back(graph.AddNode(name, [&loader, &graph, name](LoadGraph::NodeId inNode) {
+			AssetRequest request;
+			request.mKey = name;
+			request.mLoad = [&graph, inNode](std::uint64_t& outUploadBytes) -> bool {
+				graph.MarkLoadBegin(inNode);
+				outUploadBytes = 1024;
+				graph.MarkLoadEnd(inNode, outUploadBytes);
+				return true;
+			};
+			loader.Request(request, [&graph, inNode](bool inSucceeded) { graph.Complete(inNode, inSucceeded); });
+		}));
+	}
+
+	// A node without an issue function only orders the others.
+	auto level = graph.AddNode("level", nullptr);
+	for (auto texture : textures)
+		graph.AddDependency(level, texture);
+
+	TEST_CHECK(graph.Submit());
+	while (!graph.IsDone())
+		loader.Flush();
+
+	std::vector<LoadTimelineEntry> timeline;
+	graph.GetTimeline(timeline);
+	for (auto texture : textures) {
+		const auto& entry = timeline[texture];
+		TEST_CHECK(entry.bSucceeded && entry.mUploadBytes == 1024);
+		TEST_CHECK(entry.mIssueTime <= entry.mLoadBeginTime && entry.mLoadBeginTime <= entry.mLoadEndTime);
+		TEST_CHECK(entry.mLoadEndTime <= entry.mCompleteTime);
+		TEST_CHECK(timeline[level].mIssueTime >= entry.mCompleteTime);
+	}
+
+	std::string fileName = (std::filesystem::temp_directory_path() / "LoadGraphTest.csv").string();
+	TEST_CHECK(graph.WriteTimeline(fileName));
+	{
+		std::ifstream file(fileName);
+		std::string line;
+		std::uint32_t numLines = 0;
+		while (std::getline(file, line))
+			++numLines;
+		TEST_CHECK(numLines == textures.size() + 2);
+	}
+	std::filesystem::remove(fileName);
+
+	loader.CleanUp();
+}
\ No newline at end of file
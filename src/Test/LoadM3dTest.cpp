@@ -0,0 +1,363 @@
+#include "Test/TestCase.h"
+#include "SkinnedMesh/LoadM3d.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace DirectX;
+
+namespace {
+	//* Shape of a generated model; the validation tests break one value at a time.
+	struct ModelDesc {
+		UINT mNumVertices = 6;
+		UINT mNumBones = 3;
+		UINT mNumKeyframes = 4;
+		bool bSkinned = true;
+
+		// First blend index of the last vertex, -1 keeps the generated one.
+		int mLastBoneIndex = -1;
+		// Parent of the last bone, -2 keeps the generated one.
+		int mLastParent = -2;
+		// Last triangle index, -1 keeps the generated one.
+		int mLastIndex = -1;
+		UINT mExtraSubsetFaces = 0;
+	};
+
+	std::string GetTempFileName(const std::string& inName) {
+		return (std::filesystem::temp_directory_path() / inName).string();
+	}
+
+	//* Text m3d with binary fractions only, so every value survives the text and the binary round trip exactly.
+	std::string BuildTextModel(const ModelDesc& inDesc) {
+		const UINT numTriangles = inDesc.mNumVertices / 3;
+		const UINT numBones = inDesc.bSkinned ? inDesc.mNumBones : 0;
+
+		std::ostringstream out;
+		out << "***************m3d-File-Header***************\n";
+		out << "#Materials 1\n#Vertices " << inDesc.mNumVertices << "\n#Triangles " << numTriangles << "\n";
+		out << "#Bones " << numBones << "\n#AnimationClips " << (numBones > 0 ? 1 : 0) << "\n\n";
+
+		out << "***************Materials*********************\n";
+		out << "Name: soldier\nDiffuse: 1 0.5 0.25\nFresnel0: 0.0625 0.0625 0.0625\nRoughness: 0.75\nAlphaClip: 1\n";
+		out << "MaterialTypeName: Skinned\nDiffuseMap: soldier_diff.dds\nNormalMap: soldier_norm.dds\n\n";
+
+		out << "***************SubsetTable*******************\n";
+		out << "SubsetID: 0 VertexStart: 0 VertexCount: " << inDesc.mNumVertices
+			<< " FaceStart: 0 FaceCount: " << numTriangles + inDesc.mExtraSubsetFaces << "\n\n";
+
+		out << "***************Vertices**********************\n";
+		for (UINT i = 0; i < inDesc.mNumVertices; ++i) {
+			const float f = static_cast<float>(i);
+			out << "Position: " << f * 0.5f << " " << -f * 0.25f << " " << f << "\n";
+			out << "Tangent: 1 0 0 " << (i % 2 == 0 ? 1 : -1) << "\n";
+			out << "Normal: 0 1 0\n";
+			out << "Tex-Coords: " << f * 0.125f << " " << 1.0f - f * 0.0625f << "\n";
+
+			if (inDesc.bSkinned) {
+				int first = i + 1 == inDesc.mNumVertices && inDesc.mLastBoneIndex >= 0 ?
+					inDesc.mLastBoneIndex : static_cast<int>(i % numBones);
+				out << "BlendWeights: 0.5 0.25 0.25 0\n";
+				out << "BlendIndices: " << first << " " << (i + 1) % numBones << " " << (i + 2) % numBones << " 0\n";
+			}
+			out << "\n";
+		}
+
+		out << "***************Triangles*********************\n";
+		for (UINT t = 0; t < numTriangles; ++t) {
+			UINT last = t + 1 == numTriangles && inDesc.mLastIndex >= 0 ? inDesc.mLastIndex : 3 * t + 2;
+			out << 3 * t << " " << 3 * t + 1 << " " << last << "\n";
+		}
+
+		if (numBones > 0) {
+			out << "\n***************BoneOffsets*******************\n";
+			for (UINT b = 0; b < numBones; ++b)
+				out << "BoneOffset" << b << " 1 0 0 0 0 1 0 0 0 0 1 0 " << b << " 0 0 1\n";
+
+			out << "\n***************BoneHierarchy*****************\n";
+			for (UINT b = 0; b < numBones; ++b) {
+				int parent = static_cast<int>(b) - 1;
+				if (b + 1 == numBones && inDesc.mLastParent != -2)
+					parent = inDesc.mLastParent;
+				out << "ParentIndexOfBone" << b << ": " << parent << "\n";
+			}
+
+			out << "\n***************AnimationClips****************\n";
+			out << "AnimationClip Take1\n{\n";
+			for (UINT b = 0; b < numBones; ++b) {
+				out << "\tBone" << b << " #Keyframes: " << inDesc.mNumKeyframes << "\n\t{\n";
+				for (UINT k = 0; k < inDesc.mNumKeyframes; ++k) {
+					const float f = static_cast<float>(k);
+					out << "\t\tTime: " << f * 0.5f << " Pos: " << f << " 0 " << -f * 0.25f
+						<< " Scale: 1 1 1 Quat: 0 0.6 0 0.8\n";
+				}
+				out << "\t}\n";
+			}
+			out << "}\n";
+		}
+
+		return out.str();
+	}
+
+	bool WriteFile(const std::string& inFileName, const std::string& inContents) {
+		std::ofstream file(inFileName, std::ios::binary | std::ios::trunc);
+		file.write(inContents.data(), static_cast<std::streamsize>(inContents.size()));
+		return file.good();
+	}
+
+	std::string ReadFile(const std::string& inFileName) {
+		std::ifstream file(inFileName, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	//* A skinned model loaded through the skinned overload.
+	struct SkinnedModel {
+		std::vector<M3DLoader::SkinnedVertex> mVertices;
+		std::vector<USHORT> mIndices;
+		std::vector<M3DLoader::Subset> mSubsets;
+		std::vector<M3DLoader::M3dMaterial> mMaterials;
+		SkinnedData mSkinInfo;
+
+		bool Load(const std::string& inFileName) {
+			M3DLoader loader;
+			return loader.LoadM3d(inFileName, mVertices, mIndices, mSubsets, mMaterials, mSkinInfo);
+		}
+	};
+
+	bool LoadsSkinned(const std::string& inFileName) {
+		SkinnedModel model;
+		return model.Load(inFileName);
+	}
+
+	bool LoadsText(const std::string& inText) {
+		std::string fileName = GetTempFileName("LoadM3dTest_Validate.m3d");
+		bool loaded = WriteFile(fileName, inText) && LoadsSkinned(fileName);
+		std::filesystem::remove(fileName);
+		return loaded;
+	}
+
+	bool AreSame(const SkinnedModel& inLhs, const SkinnedModel& inRhs) {
+		if (inLhs.mVertices.size() != inRhs.mVertices.size() || inLhs.mIndices != inRhs.mIndices ||
+				inLhs.mSubsets.size() != inRhs.mSubsets.size() || inLhs.mMaterials.size() != inRhs.mMaterials.size())
+			return false;
+
+		if (std::memcmp(inLhs.mVertices.data(), inRhs.mVertices.data(), inLhs.mVertices.size() * sizeof(M3DLoader::SkinnedVertex)) != 0 ||
+				std::memcmp(inLhs.mSubsets.data(), inRhs.mSubsets.data(), inLhs.mSubsets.size() * sizeof(M3DLoader::Subset)) != 0)
+			return false;
+
+		for (size_t i = 0; i < inLhs.mMaterials.size(); ++i) {
+			const auto& lhs = inLhs.mMaterials[i];
+			const auto& rhs = inRhs.mMaterials[i];
+			if (lhs.Name != rhs.Name || lhs.MaterialTypeName != rhs.MaterialTypeName ||
+					lhs.DiffuseMapName != rhs.DiffuseMapName || lhs.NormalMapName != rhs.NormalMapName ||
+					lhs.AlphaClip != rhs.AlphaClip || lhs.Roughness != rhs.Roughness ||
+					std::memcmp(&lhs.DiffuseAlbedo, &rhs.DiffuseAlbedo, sizeof(XMFLOAT4)) != 0 ||
+					std::memcmp(&lhs.FresnelR0, &rhs.FresnelR0, sizeof(XMFLOAT3)) != 0)
+				return false;
+		}
+
+		if (inLhs.mSkinInfo.BoneCount() != inRhs.mSkinInfo.BoneCount() ||
+				inLhs.mSkinInfo.GetClipEndTime("Take1") != inRhs.mSkinInfo.GetClipEndTime("Take1"))
+			return false;
+
+		// The same keys give the same poses.
+		std::vector<XMFLOAT4X4> lhsPose(inLhs.mSkinInfo.BoneCount());
+		std::vector<XMFLOAT4X4> rhsPose(inRhs.mSkinInfo.BoneCount());
+		for (float t = 0.0f; t <= inLhs.mSkinInfo.GetClipEndTime("Take1"); t += 0.3f) {
+			inLhs.mSkinInfo.GetFinalTransforms("Take1", t, lhsPose);
+			inRhs.mSkinInfo.GetFinalTransforms("Take1", t, rhsPose);
+			if (std::memcmp(lhsPose.data(), rhsPose.data(), lhsPose.size() * sizeof(XMFLOAT4X4)) != 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	template <typename Func>
+	double MeasureMilliseconds(Func&& inFunc) {
+		auto begin = std::chrono::steady_clock::now();
+		inFunc();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+}
+
+TEST_CASE(LoadM3d_ReadsTextModel) {
+	std::string fileName = GetTempFileName("LoadM3dTest.m3d");
+	TEST_CHECK(WriteFile(fileName, BuildTextModel(ModelDesc())));
+
+	SkinnedModel model;
+	TEST_CHECK(model.Load(fileName));
+	TEST_CHECK(model.mVertices.size() == 6 && model.mIndices.size() == 6);
+	TEST_CHECK(model.mVertices[5].Pos.x == 2.5f && model.mVertices[5].Pos.y == -1.25f);
+	TEST_CHECK(model.mVertices[3].TangentU.x == 1.0f && model.mVertices[3].TexC.y == 1.0f - 3.0f * 0.0625f);
+	TEST_CHECK(model.mVertices[4].BoneWeights.x == 0.5f && model.mVertices[4].BoneWeights.z == 0.25f);
+	TEST_CHECK(model.mVertices[4].BoneIndices[0] == 1 && model.mVertices[4].BoneIndices[1] == 2);
+	TEST_CHECK(model.mIndices[5] == 5);
+
+	TEST_CHECK(model.mSubsets.size() == 1 && model.mSubsets[0].FaceCount == 2);
+	TEST_CHECK(model.mMaterials.size() == 1);
+	TEST_CHECK(model.mMaterials[0].Name == "soldier" && model.mMaterials[0].NormalMapName == "soldier_norm.dds");
+	TEST_CHECK(model.mMaterials[0].AlphaClip && model.mMaterials[0].DiffuseAlbedo.y == 0.5f);
+
+	TEST_CHECK(model.mSkinInfo.BoneCount() == 3);
+	TEST_CHECK(model.mSkinInfo.GetClipEndTime("Take1") == 1.5f);
+
+	// A static model has no blend values; the plain overload reads it.
+	ModelDesc staticDesc;
+	staticDesc.bSkinned = false;
+	TEST_CHECK(WriteFile(fileName, BuildTextModel(staticDesc)));
+
+	M3DLoader loader;
+	std::vector<M3DLoader::Vertex> vertices;
+	std::vector<USHORT> indices;
+	std::vector<M3DLoader::Subset> subsets;
+	std::vector<M3DLoader::M3dMaterial> materials;
+	TEST_CHECK(loader.LoadM3d(fileName, vertices, indices, subsets, materials));
+	TEST_CHECK(vertices.size() == 6 && vertices[1].TangentU.w == -1.0f && indices.size() == 6);
+
+	std::filesystem::remove(fileName);
+}
+
+TEST_CASE(LoadM3d_BinaryMatchesText) {
+	std::string textName = GetTempFileName("LoadM3dTest_RoundTrip.m3d");
+	std::string binaryName = GetTempFileName("LoadM3dTest_RoundTrip.m3db");
+
+	ModelDesc desc;
+	desc.mNumVertices = 300;
+	desc.mNumBones = 20;
+	desc.mNumKeyframes = 9;
+	TEST_CHECK(WriteFile(textName, BuildTextModel(desc)));
+
+	M3DLoader loader;
+	TEST_CHECK(loader.ConvertM3dToBinary(textName, binaryName));
+
+	SkinnedModel text;
+	SkinnedModel binary;
+	TEST_CHECK(text.Load(textName));
+	TEST_CHECK(binary.Load(binaryName));
+	TEST_CHECK(AreSame(text, binary));
+
+	// Converting the binary file writes the same bytes again.
+	std::string againName = GetTempFileName("LoadM3dTest_RoundTrip2.m3db");
+	TEST_CHECK(loader.ConvertM3dToBinary(binaryName, againName));
+	TEST_CHECK(ReadFile(againName) == ReadFile(binaryName));
+
+	std::filesystem::remove(textName);
+	std::filesystem::remove(binaryName);
+	std::filesystem::remove(againName);
+}
+
+TEST_CASE(LoadM3d_RejectsTruncatedFiles) {
+	std::string textName = GetTempFileName("LoadM3dTest_Full.m3d");
+	std::string binaryName = GetTempFileName("LoadM3dTest_Full.m3db");
+	std::string cutName = GetTempFileName("LoadM3dTest_Cut.m3d");
+
+	std::string text = BuildTextModel(ModelDesc());
+	TEST_CHECK(WriteFile(textName, text));
+
+	M3DLoader loader;
+	TEST_CHECK(loader.ConvertM3dToBinary(textName, binaryName));
+	std::string binary = ReadFile(binaryName);
+	TEST_CHECK(binary.size() > 16);
+
+	// Any cut before the closing brace of the last clip loses a value.
+	const size_t textEnd = text.find_last_of('}');
+	for (size_t size = 0; size <= textEnd; size += (size < 64 || size + 64 > textEnd) ? 1 : 7) {
+		TEST_CHECK(WriteFile(cutName, text.substr(0, size)));
+		TEST_CHECK(!LoadsSkinned(cutName));
+	}
+
+	for (size_t size = 0; size < binary.size(); ++size) {
+		TEST_CHECK(WriteFile(cutName, binary.substr(0, size)));
+		TEST_CHECK(!LoadsSkinned(cutName));
+	}
+
+	TEST_CHECK(!LoadsSkinned(GetTempFileName("LoadM3dTest_Missing.m3d")));
+
+	std::filesystem::remove(textName);
+	std::filesystem::remove(binaryName);
+	std::filesystem::remove(cutName);
+}
+
+TEST_CASE(LoadM3d_ValidatesIndices) {
+	TEST_CHECK(LoadsText(BuildTextModel(ModelDesc())));
+
+	// The blend indices are stored in bytes; a skeleton may have more bones, but the vertices can't reach them.
+	ModelDesc desc;
+	desc.mNumBones = 300;
+	desc.mNumKeyframes = 2;
+	desc.mLastBoneIndex = 255;
+	TEST_CHECK(LoadsText(BuildTextModel(desc)));
+	desc.mLastBoneIndex = 256;
+	TEST_CHECK(!LoadsText(BuildTextModel(desc)));
+
+	desc = ModelDesc();
+	desc.mLastBoneIndex = 3;
+	TEST_CHECK(!LoadsText(BuildTextModel(desc)));
+
+	// A parent has to come before its children.
+	desc = ModelDesc();
+	desc.mLastParent = 2;
+	TEST_CHECK(!LoadsText(BuildTextModel(desc)));
+	desc.mLastParent = -1;
+	TEST_CHECK(!LoadsText(BuildTextModel(desc)));
+
+	desc = ModelDesc();
+	desc.mLastIndex = 6;
+	TEST_CHECK(!LoadsText(BuildTextModel(desc)));
+
+	desc = ModelDesc();
+	desc.mExtraSubsetFaces = 1;
+	TEST_CHECK(!LoadsText(BuildTextModel(desc)));
+
+	// Numbers that don't parse completely.
+	std::string text = BuildTextModel(ModelDesc());
+	std::string broken = text;
+	broken.replace(broken.find("Roughness: 0.75"), 15, "Roughness: 0.7x");
+	TEST_CHECK(!LoadsText(broken));
+
+	broken = text;
+	broken.replace(broken.find("#Vertices 6"), 11, "#Vertices 9999999999");
+	TEST_CHECK(!LoadsText(broken));
+}
+
+TEST_CASE(LoadM3d_LargeSkinnedModelBenchmark) {
+	// The most vertices the 16-bit indices reach, on 64 bones, and a 4 second clip at 30 keys per second.
+	ModelDesc desc;
+	desc.mNumVertices = 65535;
+	desc.mNumBones = 64;
+	desc.mNumKeyframes = 120;
+
+	std::string textName = GetTempFileName("LoadM3dTest_Large.m3d");
+	std::string binaryName = GetTempFileName("LoadM3dTest_Large.m3db");
+	TEST_CHECK(WriteFile(textName, BuildTextModel(desc)));
+
+	M3DLoader loader;
+	TEST_CHECK(loader.ConvertM3dToBinary(textName, binaryName));
+
+	const int numLoads = 3;
+	SkinnedModel text;
+	SkinnedModel binary;
+
+	double textTime = MeasureMilliseconds([&] {
+		for (int i = 0; i < numLoads; ++i)
+			TEST_CHECK(text.Load(textName));
+	});
+	double binaryTime = MeasureMilliseconds([&] {
+		for (int i = 0; i < numLoads; ++i)
+			TEST_CHECK(binary.Load(binaryName));
+	});
+
+	std::cout << "  " << std::filesystem::file_size(textName) / 1024 << " KB text " << textTime / numLoads << " ms, "
+		<< std::filesystem::file_size(binaryName) / 1024 << " KB binary " << binaryTime / numLoads << " ms" << std::endl;
+
+	TEST_CHECK(AreSame(text, binary));
+	TEST_CHECK(binaryTime < textTime);
+
+	std::filesystem::remove(textName);
+	std::filesystem::remove(binaryName);
+}
\ No newline at end of file
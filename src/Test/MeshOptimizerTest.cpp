@@ -0,0 +1,182 @@
+#include "Test/TestCase.h"
+#include "DX12Game/MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace DirectX;
+using namespace Game;
+
+namespace {
+	const std::uint32_t GridSize = 64;
+
+	//* Triangles of an inGridSize x inGridSize grid of quads, shuffled so the cache can't reuse anything.
+	void BuildShuffledGrid(std::vector<std::uint32_t>& outIndices, std::vector<XMFLOAT3>& outPositions,
+			std::uint32_t inGridSize = GridSize) {
+		const std::uint32_t numVerts = inGridSize + 1;
+
+		outPositions.clear();
+		for (std::uint32_t y = 0; y < numVerts; ++y) {
+			for (std::uint32_t x = 0; x < numVerts; ++x)
+				outPositions.emplace_back(static_cast<float>(x), static_cast<float>(y), 0.0f);
+		}
+
+		std::vector<std::array<std::uint32_t, 3>> triangles;
+		for (std::uint32_t y = 0; y < inGridSize; ++y) {
+			for (std::uint32_t x = 0; x < inGridSize; ++x) {
+				std::uint32_t i = y * numVerts + x;
+				triangles.push_back({ i, i + numVerts, i + 1 });
+				triangles.push_back({ i + 1, i + numVerts, i + numVerts + 1 });
+			}
+		}
+
+		std::mt19937 rng(7);
+		std::shuffle(triangles.begin(), triangles.end(), rng);
+
+		outIndices.clear();
+		for (const auto& tri : triangles)
+			outIndices.insert(outIndices.end(), tri.begin(), tri.end());
+	}
+
+	//* The triangles rotated to start at their smallest index(keeping the winding) and sorted.
+	std::vector<std::array<std::uint32_t, 3>> SortTriangles(const std::vector<std::uint32_t>& inIndices) {
+		std::vector<std::array<std::uint32_t, 3>> triangles;
+		for (size_t i = 0, end = inIndices.size(); i < end; i += 3) {
+			std::array<std::uint32_t, 3> tri = { inIndices[i], inIndices[i + 1], inIndices[i + 2] };
+			std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+			triangles.push_back(tri);
+		}
+
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	template <typename Func>
+	double MeasureMilliseconds(Func&& inFunc) {
+		auto begin = std::chrono::steady_clock::now();
+		inFunc();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+}
+
+TEST_CASE(MeshOptimizer_VertexCacheKeepsTrianglesAndLowersAcmr) {
+	std::vector<std::uint32_t> indices;
+	std::vector<XMFLOAT3> positions;
+	BuildShuffledGrid(indices, positions);
+
+	auto before = MeshOptimizer::AnalyzeVertexCache(indices, positions.size());
+	auto triangles = SortTriangles(indices);
+
+	MeshOptimizer::OptimizeVertexCache(indices, positions.size());
+
+	auto after = MeshOptimizer::AnalyzeVertexCache(indices, positions.size());
+	TEST_CHECK(SortTriangles(indices) == triangles);
+	TEST_CHECK(after.mAcmr < before.mAcmr * 0.5f);
+	// A regular grid can't do much better than 0.6 with a 16-entry cache.
+	TEST_CHECK(after.mAcmr < 0.8f);
+}
+
+TEST_CASE(MeshOptimizer_OverdrawKeepsTrianglesAndCacheEfficiency) {
+	std::vector<std::uint32_t> indices;
+	std::vector<XMFLOAT3> positions;
+	BuildShuffledGrid(indices, positions);
+
+	MeshOptimizer::OptimizeVertexCache(indices, positions.size());
+	auto cached = MeshOptimizer::AnalyzeVertexCache(indices, positions.size());
+	auto triangles = SortTriangles(indices);
+
+	MeshOptimizer::OptimizeOverdraw(indices, positions);
+
+	auto after = MeshOptimizer::AnalyzeVertexCache(indices, positions.size());
+	TEST_CHECK(SortTriangles(indices) == triangles);
+	TEST_CHECK(after.mAcmr <= cached.mAcmr * 1.05f);
+}
+
+TEST_CASE(MeshOptimizer_VertexFetchRemapOrdersByFirstUse) {
+	std::vector<std::uint32_t> indices;
+	std::vector<XMFLOAT3> positions;
+	BuildShuffledGrid(indices, positions);
+
+	// An unreferenced vertex at the end must be dropped.
+	positions.emplace_back(-1.0f, -1.0f, -1.0f);
+
+	MeshOptimizer::OptimizeVertexCache(indices, positions.size());
+	auto before = MeshOptimizer::AnalyzeVertexFetch(indices, positions.size(), sizeof(XMFLOAT3));
+
+	std::vector<std::uint32_t> remap;
+	size_t numVertices = MeshOptimizer::BuildVertexFetchRemap(remap, indices, positions.size());
+	TEST_CHECK(numVertices == positions.size() - 1);
+	TEST_CHECK(remap.back() == MeshOptimizer::InvalidIndex);
+
+	std::vector<XMFLOAT3> expected;
+	for (auto index : indices)
+		expected.push_back(positions[index]);
+
+	MeshOptimizer::RemapIndices(indices, remap);
+	MeshOptimizer::RemapVertices(positions, remap, numVertices);
+	TEST_CHECK(positions.size() == numVertices);
+
+	// Same positions drawn, and every vertex is first referenced in order.
+	std::uint32_t next = 0;
+	for (size_t i = 0, end = indices.size(); i < end; ++i) {
+		TEST_CHECK(positions[indices[i]].x == expected[i].x && positions[indices[i]].y == expected[i].y);
+		TEST_CHECK(indices[i] <= next);
+		if (indices[i] == next)
+			++next;
+	}
+
+	auto after = MeshOptimizer::AnalyzeVertexFetch(indices, positions.size(), sizeof(XMFLOAT3));
+	TEST_CHECK(after.mOverfetch <= before.mOverfetch);
+}
+
+TEST_CASE(MeshOptimizer_LargeMeshBenchmark) {
+	// About a million triangles, the size of a detailed character or a terrain chunk.
+	std::vector<std::uint32_t> indices;
+	std::vector<XMFLOAT3> positions;
+	BuildShuffledGrid(indices, positions, 708);
+	const size_t numTriangles = indices.size() / 3;
+
+	auto cacheBefore = MeshOptimizer::AnalyzeVertexCache(indices, positions.size());
+	auto fetchBefore = MeshOptimizer::AnalyzeVertexFetch(indices, positions.size(), sizeof(XMFLOAT3));
+
+	double vertexCache = MeasureMilliseconds([&] {
+		MeshOptimizer::OptimizeVertexCache(indices, positions.size());
+	});
+	auto cacheOptimized = MeshOptimizer::AnalyzeVertexCache(indices, positions.size());
+
+	double overdraw = MeasureMilliseconds([&] {
+		MeshOptimizer::OptimizeOverdraw(indices, positions);
+	});
+	auto cacheAfter = MeshOptimizer::AnalyzeVertexCache(indices, positions.size());
+
+	size_t numVertices = 0;
+	double vertexFetch = MeasureMilliseconds([&] {
+		std::vector<std::uint32_t> remap;
+		numVertices = MeshOptimizer::BuildVertexFetchRemap(remap, indices, positions.size());
+		MeshOptimizer::RemapIndices(indices, remap);
+		MeshOptimizer::RemapVertices(positions, remap, numVertices);
+	});
+	auto fetchAfter = MeshOptimizer::AnalyzeVertexFetch(indices, positions.size(), sizeof(XMFLOAT3));
+
+	double analysis = MeasureMilliseconds([&] {
+		MeshOptimizer::AnalyzeVertexCache(indices, positions.size());
+		MeshOptimizer::AnalyzeVertexFetch(indices, positions.size(), sizeof(XMFLOAT3));
+	});
+
+	const double total = vertexCache + overdraw + vertexFetch;
+	std::cout << "  " << numTriangles << " triangles, vertex cache " << vertexCache << " ms, overdraw " << overdraw
+		<< " ms, vertex fetch " << vertexFetch << " ms, analysis " << analysis << " ms, "
+		<< numTriangles / total * 1000.0 << " triangles/s" << std::endl;
+	std::cout << "  ACMR " << cacheBefore.mAcmr << " -> " << cacheOptimized.mAcmr << " -> " << cacheAfter.mAcmr
+		<< ", overfetch " << fetchBefore.mOverfetch << " -> " << fetchAfter.mOverfetch << std::endl;
+
+	TEST_CHECK(numVertices == positions.size());
+	TEST_CHECK(cacheOptimized.mAcmr < 0.8f);
+	TEST_CHECK(cacheAfter.mAcmr <= cacheOptimized.mAcmr * 1.05f);
+	TEST_CHECK(fetchAfter.mOverfetch <= fetchBefore.mOverfetch);
+}
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "Test/TestCase.h"
+#include "DX12Game/PoseCache.h"
+#include "DX12Game/PoseSampler.h"
+#include "DX12Game/SkinnedData.h"
+
+#include <cstring>
+#include <thread>
+
+using namespace DirectX;
+using namespace Game;
+
+namespace {
+	const size_t NumFrames = 20;
+
+	//* Every track slides along x at its own rate, so no two baked frames match.
+	void BuildClip(Animation& outAnimation, size_t inNumTracks, float inRate) {
+		outAnimation.mNumFrames = NumFrames;
+		outAnimation.mFrameDuration = 1.0f / 30.0f;
+		outAnimation.mDuration = NumFrames * outAnimation.mFrameDuration;
+		outAnimation.mCurves.assign(inNumTracks, std::vector<XMFLOAT4X4>(NumFrames));
+
+		for (size_t track = 0; track < inNumTracks; ++track) {
+			for (size_t frame = 0; frame < NumFrames; ++frame) {
+				float t = inRate * static_cast<float>(frame * (track + 1));
+				XMStoreFloat4x4(&outAnimation.mCurves[track][frame],
+					XMMatrixTranslationFromVector(XMVectorSet(t, static_cast<float>(track), 0.0f, 1.0f)));
+			}
+		}
+	}
+
+	//* A chain of bones, one per track.
+	void BuildSkeleton(SkinnedData& outSkinnedData, size_t inNumBones) {
+		for (size_t i = 0; i < inNumBones; ++i) {
+			Bone bone;
+			bone.ParentIndex = static_cast<int>(i) - 1;
+			XMStoreFloat4x4(&bone.GlobalBindPose,
+				XMMatrixTranslationFromVector(XMVectorSet(0.0f, static_cast<float>(i), 0.0f, 1.0f)));
+			outSkinnedData.mSkeleton.mBones.push_back(bone);
+		}
+	}
+
+	//* The pose must be the one the sampler gives for its quantized time.
+	bool IsSampled(const CachedPose& inPose, const SkinnedData& inSkinnedData, const Animation& inAnimation,
+			const std::vector<std::uint32_t>* inBoneMask = nullptr) {
+		std::vector<XMFLOAT4X4> palette(PoseSampler::GetPaletteSize(inAnimation));
+		std::vector<XMFLOAT4X4> bones(inSkinnedData.mSkeleton.mBones.size());
+
+		PoseJob job;
+		job.mSkinnedData = &inSkinnedData;
+		job.mAnimation = &inAnimation;
+		job.mTimePos = inPose.mTimePos;
+		if (inBoneMask != nullptr) {
+			job.mBoneMask = inBoneMask->data();
+			job.mBoneMaskSize = inBoneMask->size();
+		}
+		job.mSkinningPalette = palette.data();
+		job.mBoneTransforms = bones.data();
+		PoseSampler::Sample(job);
+
+		return inPose.bReady &&
+			inPose.mSkinningPalette.size() >= palette.size() && inPose.mBoneTransforms.size() >= bones.size() &&
+			std::memcmp(inPose.mSkinningPalette.data(), palette.data(), palette.size() * sizeof(XMFLOAT4X4)) == 0 &&
+			std::memcmp(inPose.mBoneTransforms.data(), bones.data(), bones.size() * sizeof(XMFLOAT4X4)) == 0;
+	}
+}
+
+TEST_CASE(PoseCache_QuantizesKeys) {
+	SkinnedData skinnedData;
+	BuildSkeleton(skinnedData, 3);
+	SkinnedData otherSkinnedData;
+	BuildSkeleton(otherSkinnedData, 3);
+	Animation walk;
+	BuildClip(walk, 3, 1.0f);
+	Animation run;
+	BuildClip(run, 3, 2.0f);
+	const std::vector<std::uint32_t> mask = { 0, 1, 1 };
+
+	PoseCache cache;
+
+	// Half a frame by default; the time rounds to the nearest step.
+	TEST_CHECK(cache.QuantizeTime(3.2f) == 3.0f);
+	TEST_CHECK(cache.QuantizeTime(3.3f) == 3.5f);
+	TEST_CHECK(cache.QuantizeTime(-0.2f) == 0.0f);
+	TEST_CHECK(cache.QuantizeTime(-0.3f) == -0.5f);
+
+	auto pose = cache.Request(&skinnedData, &walk, 3.1f);
+	TEST_CHECK(pose->mTimePos == 3.0f && !pose->bReady);
+	TEST_CHECK(cache.Request(&skinnedData, &walk, 3.2f) == pose);
+	TEST_CHECK(cache.Request(&skinnedData, &walk, 2.8f) == pose);
+
+	// Another step, clip, skeleton or bone mask is another pose.
+	TEST_CHECK(cache.Request(&skinnedData, &walk, 3.3f) != pose);
+	TEST_CHECK(cache.Request(&skinnedData, &run, 3.1f) != pose);
+	TEST_CHECK(cache.Request(&otherSkinnedData, &walk, 3.1f) != pose);
+	auto masked = cache.Request(&skinnedData, &walk, 3.1f, &mask);
+	TEST_CHECK(masked != pose);
+
+	cache.Update();
+	TEST_CHECK(IsSampled(*pose, skinnedData, walk));
+	TEST_CHECK(IsSampled(*masked, skinnedData, walk, &mask));
+	TEST_CHECK(masked->mSkinningPalette[2].m[3][0] == masked->mSkinningPalette[1].m[3][0]);
+
+	auto stats = cache.GetStatistics();
+	TEST_CHECK(stats.mNumRequests == 7 && stats.mNumHits == 2);
+	TEST_CHECK(stats.mNumSampled == 5 && stats.mNumEntries == 5);
+
+	// A coarser step shares more; the poses already cached keep their times.
+	cache.SetTimeStep(2.0f);
+	TEST_CHECK(cache.QuantizeTime(3.1f) == 4.0f);
+	TEST_CHECK(cache.Request(&skinnedData, &walk, 3.1f) != pose);
+	TEST_CHECK(cache.Request(&skinnedData, &walk, 4.9f)->mTimePos == 4.0f);
+	TEST_CHECK(pose->mTimePos == 3.0f);
+}
+
+TEST_CASE(PoseCache_CountsReferences) {
+	SkinnedData skinnedData;
+	BuildSkeleton(skinnedData, 2);
+	Animation walk;
+	BuildClip(walk, 2, 1.0f);
+
+	PoseCache cache;
+
+	auto pose = cache.Request(&skinnedData, &walk, 5.0f);
+	cache.Update();
+	TEST_CHECK(IsSampled(*pose, skinnedData, walk));
+
+	// Requested every frame, the pose is sampled once and kept.
+	for (int frame = 0; frame < 3; ++frame) {
+		TEST_CHECK(cache.Request(&skinnedData, &walk, 5.0f) == pose);
+		cache.Update();
+		TEST_CHECK(cache.GetStatistics().mNumSampled == 0 && cache.GetStatistics().mNumEvicted == 0);
+		TEST_CHECK(pose->bReady);
+	}
+
+	// One update without requests keeps it for the characters still showing it; the second drops it.
+	cache.Update();
+	TEST_CHECK(pose->bReady && cache.GetStatistics().mNumEntries == 1);
+	cache.Update();
+	TEST_CHECK(!pose->bReady);
+	TEST_CHECK(cache.GetStatistics().mNumEvicted == 1 && cache.GetStatistics().mNumEntries == 0);
+
+	// Requested again, the pose is sampled again.
+	auto again = cache.Request(&skinnedData, &walk, 5.0f);
+	TEST_CHECK(!again->bReady);
+	cache.Update();
+	TEST_CHECK(IsSampled(*again, skinnedData, walk));
+	TEST_CHECK(cache.GetStatistics().mNumSampled == 1);
+}
+
+TEST_CASE(PoseCache_EvictsUnrequestedPoses) {
+	SkinnedData skinnedData;
+	BuildSkeleton(skinnedData, 4);
+	Animation walk;
+	BuildClip(walk, 4, 1.0f);
+
+	PoseCache cache;
+
+	const CachedPose* poses[3];
+	for (int i = 0; i < 3; ++i)
+		poses[i] = cache.Request(&skinnedData, &walk, static_cast<float>(i));
+	cache.Update();
+
+	// Only the first is requested; the others survive this update on the requests before it.
+	cache.Request(&skinnedData, &walk, 0.0f);
+	cache.Update();
+	TEST_CHECK(cache.GetStatistics().mNumEvicted == 0);
+
+	cache.Update();
+	TEST_CHECK(cache.GetStatistics().mNumEvicted == 2);
+	TEST_CHECK(poses[0]->bReady && !poses[1]->bReady && !poses[2]->bReady);
+
+	cache.Update();
+	TEST_CHECK(cache.GetStatistics().mNumEvicted == 1 && cache.GetStatistics().mNumEntries == 0);
+
+	// The slots are reused, the last dropped first, and never move.
+	TEST_CHECK(cache.Request(&skinnedData, &walk, 7.0f) == poses[0]);
+	TEST_CHECK(cache.Request(&skinnedData, &walk, 8.0f) == poses[2]);
+	TEST_CHECK(cache.Request(&skinnedData, &walk, 9.0f) == poses[1]);
+
+	auto fresh = cache.Request(&skinnedData, &walk, 10.0f);
+	TEST_CHECK(fresh != poses[0] && fresh != poses[1] && fresh != poses[2]);
+
+	cache.Update();
+	TEST_CHECK(poses[2]->mTimePos == 8.0f && IsSampled(*poses[2], skinnedData, walk));
+	TEST_CHECK(cache.GetStatistics().mNumEntries == 4);
+}
+
+TEST_CASE(PoseCache_ReportsHitRate) {
+	SkinnedData skinnedData;
+	BuildSkeleton(skinnedData, 3);
+	Animation walk;
+	BuildClip(walk, 3, 1.0f);
+
+	PoseCache cache;
+
+	// A crowd of 400 on 10 poses, requesting from several threads.
+	const int numThreads = 4;
+	const int numCharacters = 400;
+	const CachedPose* poses[numCharacters];
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < numThreads; ++t) {
+		threads.emplace_back([&, t] {
+			for (int i = t; i < numCharacters; i += numThreads)
+				poses[i] = cache.Request(&skinnedData, &walk, static_cast<float>(i % 10) + 0.1f);
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	cache.Update();
+
+	auto stats = cache.GetStatistics();
+	TEST_CHECK(stats.mNumRequests == numCharacters && stats.mNumHits == numCharacters - 10);
+	TEST_CHECK_NEAR(stats.mHitRate, 0.975f, 1e-6f);
+	TEST_CHECK(stats.mNumSampled == 10 && stats.mNumEntries == 10);
+
+	for (int i = 0; i < numCharacters; ++i) {
+		TEST_CHECK(poses[i] == poses[i % 10]);
+		TEST_CHECK(poses[i]->mTimePos == static_cast<float>(i % 10));
+	}
+	TEST_CHECK(IsSampled(*poses[3], skinnedData, walk));
+
+	// Nothing requested, nothing to rate.
+	cache.Update();
+	TEST_CHECK(cache.GetStatistics().mNumRequests == 0 && cache.GetStatistics().mHitRate == 0.0f);
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "Test/TestCase.h"
+#include "DX12Game/PoseSampler.h"
+#include "DX12Game/SkinnedData.h"
+
+#include <cmath>
+
+using namespace DirectX;
+using namespace Game;
+
+namespace {
+	const size_t NumFrames = 10;
+
+	//* Every track turns about z and slides along x at its own rate, so no two baked matrices match.
+	void BuildClip(Animation& outAnimation, size_t inNumTracks, float inRate) {
+		outAnimation.mNumFrames = NumFrames;
+		outAnimation.mFrameDuration = 1.0f / 30.0f;
+		outAnimation.mDuration = NumFrames * outAnimation.mFrameDuration;
+		outAnimation.mCurves.assign(inNumTracks, std::vector<XMFLOAT4X4>(NumFrames));
+
+		XMVECTOR axis = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+		for (size_t track = 0; track < inNumTracks; ++track) {
+			for (size_t frame = 0; frame < NumFrames; ++frame) {
+				float t = inRate * static_cast<float>(frame * (track + 1));
+				XMMATRIX m = XMMatrixMultiply(XMMatrixRotationQuaternion(XMQuaternionRotationAxis(axis, 0.1f * t)),
+					XMMatrixTranslationFromVector(XMVectorSet(t, static_cast<float>(track), 0.0f, 1.0f)));
+				XMStoreFloat4x4(&outAnimation.mCurves[track][frame], m);
+			}
+		}
+	}
+
+	XMFLOAT4X4 Lerp(const XMFLOAT4X4& inA, const XMFLOAT4X4& inB, float inPct) {
+		XMFLOAT4X4 result;
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col)
+				result.m[row][col] = inA.m[row][col] + (inB.m[row][col] - inA.m[row][col]) * inPct;
+		}
+		return result;
+	}
+
+	bool NearlyEqual(const XMFLOAT4X4& inA, const XMFLOAT4X4& inB, float inEpsilon = 1e-5f) {
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				if (std::abs(inA.m[row][col] - inB.m[row][col]) > inEpsilon)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<XMFLOAT4X4> SampleClip(const Animation& inAnimation, float inTimePos) {
+		std::vector<XMFLOAT4X4> palette(PoseSampler::GetPaletteSize(inAnimation));
+
+		PoseJob job;
+		job.mAnimation = &inAnimation;
+		job.mTimePos = inTimePos;
+		job.mSkinningPalette = palette.data();
+		PoseSampler::Sample(job);
+
+		return palette;
+	}
+}
+
+TEST_CASE(PoseSampler_MatchesBakedFrames) {
+	Animation anim;
+	BuildClip(anim, 3, 1.0f);
+	TEST_CHECK(PoseSampler::GetPaletteSize(anim) == 3);
+
+	std::vector<XMFLOAT4X4> frame(anim.GetNumTracks());
+	std::vector<XMFLOAT4X4> next(anim.GetNumTracks());
+
+	for (size_t f = 0; f < NumFrames; ++f) {
+		anim.GetFrame(f, frame.data());
+		auto palette = SampleClip(anim, static_cast<float>(f));
+		for (size_t track = 0; track < frame.size(); ++track)
+			TEST_CHECK(NearlyEqual(palette[track], frame[track]));
+	}
+
+	// Between two baked frames the matrices are blended element by element, like the shaders do.
+	anim.GetFrame(4, frame.data());
+	anim.GetFrame(5, next.data());
+	auto palette = SampleClip(anim, 4.25f);
+	for (size_t track = 0; track < frame.size(); ++track)
+		TEST_CHECK(NearlyEqual(palette[track], Lerp(frame[track], next[track], 0.25f)));
+
+	// Time positions outside the clip are clamped.
+	anim.GetFrame(NumFrames - 1, frame.data());
+	palette = SampleClip(anim, static_cast<float>(NumFrames) + 3.5f);
+	TEST_CHECK(NearlyEqual(palette[2], frame[2]));
+
+	anim.GetFrame(0, frame.data());
+	palette = SampleClip(anim, -1.0f);
+	TEST_CHECK(NearlyEqual(palette[2], frame[2]));
+}
+
+TEST_CASE(PoseSampler_MatchesCompressedFrames) {
+	Animation anim;
+	BuildClip(anim, 3, 0.5f);
+	TEST_CHECK(anim.mCompressed.Compress(anim, AnimationCompressionSettings()));
+	anim.mCurves.clear();
+
+	// With the raw curves released, the sampler reads the same frames GetFrame decompresses.
+	std::vector<XMFLOAT4X4> frame(anim.GetNumTracks());
+	std::vector<XMFLOAT4X4> next(anim.GetNumTracks());
+	anim.GetFrame(6, frame.data());
+	anim.GetFrame(7, next.data());
+
+	auto palette = SampleClip(anim, 6.5f);
+	TEST_CHECK(palette.size() == 3);
+	for (size_t track = 0; track < frame.size(); ++track)
+		TEST_CHECK(NearlyEqual(palette[track], Lerp(frame[track], next[track], 0.5f)));
+}
+
+TEST_CASE(PoseSampler_PlacesBonesAtBindPose) {
+	Animation anim;
+	BuildClip(anim, 2, 1.0f);
+
+	// The third bone has no track in the clip and stays at its bind pose.
+	SkinnedData skinnedData;
+	for (int i = 0; i < 3; ++i) {
+		Bone bone;
+		bone.ParentIndex = i - 1;
+		XMStoreFloat4x4(&bone.GlobalBindPose,
+			XMMatrixTranslationFromVector(XMVectorSet(0.0f, static_cast<float>(i), 0.0f, 1.0f)));
+		skinnedData.mSkeleton.mBones.push_back(bone);
+	}
+
+	std::vector<XMFLOAT4X4> palette(PoseSampler::GetPaletteSize(anim));
+	std::vector<XMFLOAT4X4> bones(skinnedData.mSkeleton.mBones.size());
+
+	PoseJob job;
+	job.mSkinnedData = &skinnedData;
+	job.mAnimation = &anim;
+	job.mTimePos = 3.0f;
+	job.mSkinningPalette = palette.data();
+	job.mBoneTransforms = bones.data();
+	PoseSampler::Sample(job);
+
+	for (size_t i = 0; i < palette.size(); ++i) {
+		XMFLOAT4X4 expected;
+		XMStoreFloat4x4(&expected, XMMatrixMultiply(
+			XMLoadFloat4x4(&skinnedData.mSkeleton.mBones[i].GlobalBindPose), XMLoadFloat4x4(&palette[i])));
+		TEST_CHECK(NearlyEqual(bones[i], expected));
+	}
+	TEST_CHECK(NearlyEqual(bones[2], skinnedData.mSkeleton.mBones[2].GlobalBindPose));
+}
+
+TEST_CASE(PoseSampler_BlendsTerms) {
+	Animation walk;
+	BuildClip(walk, 3, 1.0f);
+	Animation wave;
+	BuildClip(wave, 2, -0.5f);
+
+	PoseTerm terms[2];
+	terms[0].mAnimation = &walk;
+	terms[0].mTimePos = 2.5f;
+	terms[0].mWeight = 0.75f;
+	terms[1].mAnimation = &wave;
+	terms[1].mClipIndex = 1;
+	terms[1].mTimePos = 7.0f;
+	terms[1].mWeight = 0.25f;
+
+	std::vector<XMFLOAT4X4> palette(3);
+
+	PoseJob job;
+	job.mTerms = terms;
+	job.mNumTerms = 2;
+	job.mSkinningPalette = palette.data();
+	PoseSampler::Sample(job);
+
+	auto walkPose = SampleClip(walk, 2.5f);
+	auto wavePose = SampleClip(wave, 7.0f);
+
+	// The weighted sum of the skinning matrices; the track the wave doesn't have only gets the walk's share.
+	for (size_t track = 0; track < palette.size(); ++track) {
+		XMFLOAT4X4 expected;
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				expected.m[row][col] = 0.75f * walkPose[track].m[row][col];
+				if (track < wavePose.size())
+					expected.m[row][col] += 0.25f * wavePose[track].m[row][col];
+			}
+		}
+		TEST_CHECK(NearlyEqual(palette[track], expected));
+	}
+}
+
+TEST_CASE(PoseSampler_AppliesBoneMask) {
+	Animation anim;
+	BuildClip(anim, 4, 1.0f);
+
+	// Bones 2 and 3 follow bone 1.
+	const std::uint32_t mask[] = { 0, 1, 1, 1 };
+
+	std::vector<XMFLOAT4X4> palette(PoseSampler::GetPaletteSize(anim));
+
+	PoseJob job;
+	job.mAnimation = &anim;
+	job.mTimePos = 5.5f;
+	job.mBoneMask = mask;
+	job.mBoneMaskSize = 4;
+	job.mSkinningPalette = palette.data();
+	PoseSampler::Sample(job);
+
+	auto full = SampleClip(anim, 5.5f);
+	TEST_CHECK(NearlyEqual(palette[0], full[0]));
+	TEST_CHECK(NearlyEqual(palette[1], full[1]));
+	TEST_CHECK(NearlyEqual(palette[2], full[1]));
+	TEST_CHECK(NearlyEqual(palette[3], full[1]));
+}
+
+TEST_CASE(PoseSampler_BatchMatchesSingleJobs) {
+	Animation anim;
+	BuildClip(anim, 8, 0.25f);
+
+	const size_t numJobs = 256;
+	const size_t paletteSize = PoseSampler::GetPaletteSize(anim);
+	std::vector<XMFLOAT4X4> palettes(numJobs * paletteSize);
+
+	std::vector<PoseJob> jobs(numJobs);
+	for (size_t i = 0; i < numJobs; ++i) {
+		jobs[i].mAnimation = &anim;
+		jobs[i].mTimePos = static_cast<float>(i % 37) * 0.25f;
+		jobs[i].mSkinningPalette = &palettes[i * paletteSize];
+	}
+	PoseSampler::SampleBatch(jobs);
+
+	for (size_t i = 0; i < numJobs; ++i) {
+		auto expected = SampleClip(anim, jobs[i].mTimePos);
+		for (size_t track = 0; track < paletteSize; ++track)
+			TEST_CHECK(NearlyEqual(palettes[i * paletteSize + track], expected[track]));
+	}
+}
+
+TEST_CASE(PoseSampler_TimePositionWrapsAround) {
+	SkinnedData skinnedData;
+	BuildClip(skinnedData.mAnimations["Walk"], 1, 1.0f);
+
+	const auto& walk = skinnedData.mAnimations["Walk"];
+	TEST_CHECK_NEAR(skinnedData.GetTimePosition("Walk", 0.0f), 0.0f, 1e-4f);
+	TEST_CHECK_NEAR(skinnedData.GetTimePosition("Walk", 2.5f * walk.mFrameDuration), 2.5f, 1e-3f);
+	TEST_CHECK_NEAR(skinnedData.GetTimePosition("Walk", walk.mDuration + 4.0f * walk.mFrameDuration), 4.0f, 1e-3f);
+	TEST_CHECK(skinnedData.GetTimePosition("Run", 1.0f) == 0.0f);
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "Test/TestCase.h"
+#include "DX12Game/FrameResource.h"
+#include "DX12Game/SkinWeights.h"
+
+#include <cmath>
+#include <random>
+#include <utility>
+
+using namespace Game;
+
+namespace {
+	//* Up to eight influences in slot order; the free slots keep the weight 0 and the index -1.
+	SkinnedVertex BuildVertex(const std::vector<std::pair<int, float>>& inInfluences) {
+		float weights[SkinWeights::MaxInfluences] = {};
+		SkinnedVertex vertex;
+		for (size_t i = 0; i < inInfluences.size(); ++i) {
+			weights[i] = inInfluences[i].second;
+			if (i < 4)
+				vertex.mBoneIndices0[i] = inInfluences[i].first;
+			else
+				vertex.mBoneIndices1[i - 4] = inInfluences[i].first;
+		}
+		vertex.mBoneWeights0 = { weights[0], weights[1], weights[2], weights[3] };
+		vertex.mBoneWeights1 = { weights[4], weights[5], weights[6], weights[7] };
+		return vertex;
+	}
+
+	//* Vertices with one to eight influences on inNumBones bones, normalized.
+	std::vector<SkinnedVertex> BuildRandomVertices(size_t inNumVertices, int inNumBones) {
+		std::mt19937 rng(3);
+		std::uniform_real_distribution<float> weight(0.01f, 1.0f);
+
+		std::vector<SkinnedVertex> vertices;
+		vertices.reserve(inNumVertices);
+		for (size_t v = 0; v < inNumVertices; ++v) {
+			std::vector<std::pair<int, float>> influences(1 + rng() % SkinWeights::MaxInfluences);
+
+			float sum = 0.0f;
+			for (auto& influence : influences) {
+				influence = { static_cast<int>(rng() % inNumBones), weight(rng) };
+				sum += influence.second;
+			}
+			for (auto& influence : influences)
+				influence.second /= sum;
+
+			vertices.push_back(BuildVertex(influences));
+		}
+		return vertices;
+	}
+
+	float SumWeights(const SkinnedVertex& inVertex) {
+		return inVertex.mBoneWeights0.x + inVertex.mBoneWeights0.y + inVertex.mBoneWeights0.z + inVertex.mBoneWeights0.w +
+			inVertex.mBoneWeights1.x + inVertex.mBoneWeights1.y + inVertex.mBoneWeights1.z + inVertex.mBoneWeights1.w;
+	}
+}
+
+TEST_CASE(SkinWeights_PrunesToLargestInfluences) {
+	std::vector<SkinnedVertex> vertices = {
+		BuildVertex({ { 3, 0.1f }, { 7, 0.3f }, { 1, 0.05f }, { 2, 0.2f }, { 9, 0.25f }, { 4, 0.1f } }),
+		BuildVertex({ { 5, 0.5f }, { 6, 0.5f } })
+	};
+
+	auto stats = SkinWeights::Prune(vertices);
+	TEST_CHECK(stats.mNumVertices == 2);
+	TEST_CHECK(stats.mNumPrunedVertices == 1);
+	TEST_CHECK_NEAR(stats.mMaxDroppedWeight, 0.15f, 1e-5f);
+	TEST_CHECK_NEAR(stats.mAverageDroppedWeight, 0.15f, 1e-5f);
+
+	// Sorted by weight, the tie going to the lower bone index, and renormalized.
+	const auto& pruned = vertices[0];
+	TEST_CHECK(pruned.mBoneIndices0[0] == 7 && pruned.mBoneIndices0[1] == 9);
+	TEST_CHECK(pruned.mBoneIndices0[2] == 2 && pruned.mBoneIndices0[3] == 3);
+	TEST_CHECK_NEAR(pruned.mBoneWeights0.x, 0.3f / 0.85f, 1e-5f);
+	TEST_CHECK_NEAR(pruned.mBoneWeights0.w, 0.1f / 0.85f, 1e-5f);
+	TEST_CHECK(pruned.mBoneIndices1[0] == -1 && pruned.mBoneWeights1.x == 0.0f);
+	TEST_CHECK_NEAR(SumWeights(pruned), 1.0f, 1e-5f);
+
+	// A vertex within the limit keeps its weights.
+	TEST_CHECK(vertices[1].mBoneIndices0[0] == 5 && vertices[1].mBoneWeights0.y == 0.5f);
+	TEST_CHECK(vertices[1].mBoneIndices0[2] == -1);
+}
+
+TEST_CASE(SkinWeights_PruneStopsAtFreeSlot) {
+	// The shaders never read past the first -1, so neither does the pruning.
+	auto vertex = BuildVertex({ { 1, 0.6f }, { 2, 0.4f } });
+	vertex.mBoneIndices0[3] = 8;
+	vertex.mBoneWeights0.w = 0.9f;
+
+	std::vector<SkinnedVertex> vertices = { vertex };
+	SkinWeights::Prune(vertices, 1);
+	TEST_CHECK(vertices[0].mBoneIndices0[0] == 1 && vertices[0].mBoneIndices0[1] == -1);
+	TEST_CHECK(vertices[0].mBoneIndices0[3] == -1);
+	TEST_CHECK_NEAR(vertices[0].mBoneWeights0.x, 1.0f, 1e-5f);
+}
+
+TEST_CASE(SkinWeights_PrunesRandomVertices) {
+	auto vertices = BuildRandomVertices(10000, 300);
+
+	auto stats = SkinWeights::Prune(vertices);
+	TEST_CHECK(stats.mNumVertices == 10000);
+	TEST_CHECK(stats.mNumPrunedVertices > 0 && stats.mNumPrunedVertices < stats.mNumVertices);
+	TEST_CHECK(stats.mAverageDroppedWeight > 0.0f && stats.mAverageDroppedWeight <= stats.mMaxDroppedWeight);
+	TEST_CHECK(stats.mMaxDroppedWeight < 0.5f);
+
+	for (const auto& vertex : vertices) {
+		TEST_CHECK(vertex.mBoneIndices1[0] == -1 && vertex.mBoneWeights1.x == 0.0f);
+		TEST_CHECK(vertex.mBoneWeights0.x >= vertex.mBoneWeights0.y);
+		TEST_CHECK(vertex.mBoneWeights0.y >= vertex.mBoneWeights0.z);
+		TEST_CHECK_NEAR(SumWeights(vertex), 1.0f, 1e-5f);
+	}
+}
+
+TEST_CASE(SkinWeights_QuantizesWeightsAndIndices) {
+	for (int numBones : { 200, 300 }) {
+		auto vertices = BuildRandomVertices(5000, numBones);
+		SkinWeights::Prune(vertices);
+
+		for (std::uint32_t weightBits : { 8u, 16u }) {
+			QuantizedSkin skin;
+			auto stats = SkinWeights::Quantize(vertices, numBones, weightBits, skin);
+
+			const std::uint32_t indexBits = numBones <= 256 ? 8 : 16;
+			const std::uint32_t maxValue = (1u << weightBits) - 1;
+			TEST_CHECK(skin.mWeightBits == weightBits && skin.mIndexBits == indexBits);
+			TEST_CHECK(skin.mStride == (weightBits + indexBits) / 2);
+			TEST_CHECK(skin.mData.size() == vertices.size() * skin.mStride);
+
+			TEST_CHECK(stats.mQuantizedStride == skin.mStride && stats.mQuantizedBytes == skin.mData.size());
+			TEST_CHECK(stats.mSourceStride == 64);
+			TEST_CHECK(stats.mSourceBytes == vertices.size() * 64);
+			TEST_CHECK(stats.mMaxWeightError <= 1.0f / maxValue);
+
+			for (size_t v = 0; v < vertices.size(); ++v) {
+				float weights[SkinWeights::MaxQuantizedInfluences];
+				std::uint32_t indices[SkinWeights::MaxQuantizedInfluences];
+				SkinWeights::Dequantize(skin, v, weights, indices);
+
+				const float* source = &vertices[v].mBoneWeights0.x;
+				std::uint32_t sum = 0;
+				for (std::uint32_t i = 0; i < SkinWeights::MaxQuantizedInfluences; ++i) {
+					sum += static_cast<std::uint32_t>(weights[i] * maxValue + 0.5f);
+					if (vertices[v].mBoneIndices0[i] < 0) {
+						TEST_CHECK(weights[i] == 0.0f);
+						continue;
+					}
+
+					TEST_CHECK(indices[i] == static_cast<std::uint32_t>(vertices[v].mBoneIndices0[i]));
+					TEST_CHECK(std::abs(weights[i] - source[i]) <= stats.mMaxWeightError + 1e-6f);
+				}
+
+				// Every vertex sums up to exactly 1, so the skinned position isn't scaled.
+				TEST_CHECK(sum == maxValue);
+			}
+		}
+	}
+}
+
+TEST_CASE(SkinWeights_UnboundVertexKeepsZeroWeights) {
+	std::vector<SkinnedVertex> vertices(2);
+	vertices[1] = BuildVertex({ { 4, 1.0f } });
+
+	QuantizedSkin skin;
+	SkinWeights::Quantize(vertices, 16, 8, skin);
+
+	float weights[SkinWeights::MaxQuantizedInfluences];
+	std::uint32_t indices[SkinWeights::MaxQuantizedInfluences];
+	SkinWeights::Dequantize(skin, 0, weights, indices);
+	TEST_CHECK(weights[0] == 0.0f && weights[3] == 0.0f);
+
+	SkinWeights::Dequantize(skin, 1, weights, indices);
+	TEST_CHECK(weights[0] == 1.0f && indices[0] == 4 && weights[1] == 0.0f);
+}
\ No newline at end of file
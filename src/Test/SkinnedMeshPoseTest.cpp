@@ -0,0 +1,274 @@
+#include "Test/TestCase.h"
+#include "SkinnedMesh/SkinnedData.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+using namespace DirectX;
+
+namespace {
+	//* The bones, offsets and clips handed to SkinnedData::Set, kept for the reference below.
+	struct SkinnedModel {
+		std::vector<int> mBoneHierarchy;
+		std::vector<XMFLOAT4X4> mBoneOffsets;
+		std::unordered_map<std::string, AnimationClip> mAnimations;
+		SkinnedData mSkinInfo;
+	};
+
+	//* A binary tree of bones, every clip keyed at uneven times with its own rotations.
+	void BuildModel(SkinnedModel& outModel, UINT inNumBones, UINT inNumKeyframes, UINT inNumClips) {
+		std::mt19937 rng(9);
+		std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+		for (UINT i = 0; i < inNumBones; ++i) {
+			outModel.mBoneHierarchy.push_back(i == 0 ? -1 : static_cast<int>((i - 1) / 2));
+
+			XMFLOAT4X4 offset;
+			XMStoreFloat4x4(&offset, XMMatrixTranslation(value(rng), value(rng), value(rng)));
+			outModel.mBoneOffsets.push_back(offset);
+		}
+
+		for (UINT c = 0; c < inNumClips; ++c) {
+			AnimationClip clip;
+			clip.BoneAnimations.resize(inNumBones);
+			for (auto& bone : clip.BoneAnimations) {
+				bone.Resize(inNumKeyframes);
+
+				float time = 0.0f;
+				for (UINT k = 0; k < inNumKeyframes; ++k) {
+					bone.TimePositions[k] = time;
+					time += 0.05f + 0.05f * std::abs(value(rng));
+
+					bone.Translations[k] = XMFLOAT3(value(rng), value(rng), value(rng));
+					bone.Scales[k] = XMFLOAT3(1.0f + 0.1f * value(rng), 1.0f, 1.0f);
+					XMStoreFloat4(&bone.RotationQuats[k],
+						XMQuaternionNormalize(XMVectorSet(value(rng), value(rng), value(rng), value(rng))));
+				}
+			}
+			outModel.mAnimations.emplace("Clip" + std::to_string(c), std::move(clip));
+		}
+
+		auto boneHierarchy = outModel.mBoneHierarchy;
+		auto boneOffsets = outModel.mBoneOffsets;
+		auto animations = outModel.mAnimations;
+		outModel.mSkinInfo.Set(boneHierarchy, boneOffsets, animations);
+	}
+
+	//* Interpolates a bone the way GetFinalTransforms did before the cursors: a linear key search from the start.
+	void InterpolateLinear(const BoneAnimation& inBone, float inTime, XMFLOAT4X4& outM) {
+		const auto& times = inBone.TimePositions;
+		size_t i = 0;
+		float lerpPercent = 0.0f;
+
+		if (inTime >= times.back()) {
+			i = times.size() - 2;
+			lerpPercent = 1.0f;
+		}
+		else if (inTime > times.front()) {
+			while (!(inTime >= times[i] && inTime <= times[i + 1]))
+				++i;
+			lerpPercent = (inTime - times[i]) / (times[i + 1] - times[i]);
+		}
+
+		XMVECTOR S = XMVectorLerp(XMLoadFloat3(&inBone.Scales[i]), XMLoadFloat3(&inBone.Scales[i + 1]), lerpPercent);
+		XMVECTOR P = XMVectorLerp(XMLoadFloat3(&inBone.Translations[i]), XMLoadFloat3(&inBone.Translations[i + 1]), lerpPercent);
+		XMVECTOR Q = XMQuaternionSlerp(XMLoadFloat4(&inBone.RotationQuats[i]), XMLoadFloat4(&inBone.RotationQuats[i + 1]), lerpPercent);
+
+		XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+		XMStoreFloat4x4(&outM, XMMatrixAffineTransformation(S, zero, Q, P));
+	}
+
+	//* The name lookup, the two allocations and the separate root-space pass of the old GetFinalTransforms.
+	void GetFinalTransformsByName(const SkinnedModel& inModel, const std::string& inClipName, float inTimePos,
+			std::vector<XMFLOAT4X4>& outFinalTransforms) {
+		UINT numBones = (UINT)inModel.mBoneOffsets.size();
+
+		std::vector<XMFLOAT4X4> toParentTransforms(numBones);
+
+		const auto& clip = inModel.mAnimations.find(inClipName)->second;
+		for (UINT i = 0; i < numBones; ++i)
+			InterpolateLinear(clip.BoneAnimations[i], inTimePos, toParentTransforms[i]);
+
+		std::vector<XMFLOAT4X4> toRootTransforms(numBones);
+		toRootTransforms[0] = toParentTransforms[0];
+
+		for (UINT i = 1; i < numBones; ++i) {
+			XMMATRIX toParent = XMLoadFloat4x4(&toParentTransforms[i]);
+			XMMATRIX parentToRoot = XMLoadFloat4x4(&toRootTransforms[inModel.mBoneHierarchy[i]]);
+			XMStoreFloat4x4(&toRootTransforms[i], XMMatrixMultiply(toParent, parentToRoot));
+		}
+
+		for (UINT i = 0; i < numBones; ++i) {
+			XMMATRIX offset = XMLoadFloat4x4(&inModel.mBoneOffsets[i]);
+			XMMATRIX toRoot = XMLoadFloat4x4(&toRootTransforms[i]);
+			XMStoreFloat4x4(&outFinalTransforms[i], XMMatrixTranspose(XMMatrixMultiply(offset, toRoot)));
+		}
+	}
+
+	bool AreSame(const std::vector<XMFLOAT4X4>& inLhs, const std::vector<XMFLOAT4X4>& inRhs) {
+		return inLhs.size() == inRhs.size() &&
+			std::memcmp(inLhs.data(), inRhs.data(), inLhs.size() * sizeof(XMFLOAT4X4)) == 0;
+	}
+
+	bool AreNear(const std::vector<XMFLOAT4X4>& inLhs, const std::vector<XMFLOAT4X4>& inRhs, float inEpsilon) {
+		if (inLhs.size() != inRhs.size())
+			return false;
+
+		for (size_t i = 0; i < inLhs.size(); ++i) {
+			for (int row = 0; row < 4; ++row) {
+				for (int col = 0; col < 4; ++col) {
+					if (std::abs(inLhs[i].m[row][col] - inRhs[i].m[row][col]) > inEpsilon)
+						return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	template <typename Func>
+	double MeasureMilliseconds(Func&& inFunc) {
+		auto begin = std::chrono::steady_clock::now();
+		inFunc();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+}
+
+TEST_CASE(SkinnedMeshPose_HandleMatchesName) {
+	SkinnedModel model;
+	BuildModel(model, 40, 30, 2);
+	const auto& skinInfo = model.mSkinInfo;
+
+	ClipHandle clips[] = { skinInfo.FindClip("Clip0"), skinInfo.FindClip("Clip1") };
+	TEST_CHECK(clips[0] != InvalidClipHandle && clips[1] != InvalidClipHandle && clips[0] != clips[1]);
+	TEST_CHECK(skinInfo.FindClip("Clip2") == InvalidClipHandle);
+	TEST_CHECK(skinInfo.GetClipEndTime(clips[1]) == skinInfo.GetClipEndTime("Clip1"));
+
+	std::vector<XMFLOAT4X4> byName(skinInfo.BoneCount());
+	std::vector<XMFLOAT4X4> byHandle(skinInfo.BoneCount());
+	std::vector<XMFLOAT4X4> reference(skinInfo.BoneCount());
+
+	// Playing forward past the end, seeking back, before the start and switching clips with the same cursor.
+	const float endTime = skinInfo.GetClipEndTime("Clip0");
+	std::vector<std::pair<int, float>> steps;
+	for (float t = 0.0f; t < endTime + 0.1f; t += 1.0f / 60.0f)
+		steps.emplace_back(0, t);
+	for (float t : { 0.5f * endTime, -1.0f, 0.0f, 0.25f * endTime })
+		steps.emplace_back(0, t);
+	for (float t = 0.1f; t < 0.6f; t += 0.07f)
+		steps.emplace_back(1, t);
+	steps.emplace_back(0, 0.75f * endTime);
+
+	AnimationCursor cursor;
+	for (const auto& step : steps) {
+		const std::string clipName = "Clip" + std::to_string(step.first);
+
+		skinInfo.GetFinalTransforms(clipName, step.second, byName);
+		skinInfo.GetFinalTransforms(clips[step.first], step.second, byHandle.data(), cursor);
+		TEST_CHECK(AreSame(byName, byHandle));
+
+		// The old path takes the earlier key on a key time; the blend is the same up to rounding.
+		GetFinalTransformsByName(model, clipName, step.second, reference);
+		TEST_CHECK(AreNear(reference, byHandle, 1e-4f));
+	}
+
+	// An invalid handle leaves the output as it was.
+	auto before = byHandle;
+	skinInfo.GetFinalTransforms(InvalidClipHandle, 0.1f, byHandle.data(), cursor);
+	TEST_CHECK(AreSame(before, byHandle));
+}
+
+TEST_CASE(SkinnedMeshPose_BatchMatchesSerial) {
+	SkinnedModel model;
+	BuildModel(model, 30, 20, 3);
+	const auto& skinInfo = model.mSkinInfo;
+	const UINT numBones = skinInfo.BoneCount();
+
+	const size_t numCharacters = 64;
+	std::vector<AnimationCursor> batchCursors(numCharacters);
+	std::vector<AnimationCursor> serialCursors(numCharacters);
+	std::vector<XMFLOAT4X4> batched(numCharacters * numBones);
+	std::vector<XMFLOAT4X4> serial(numCharacters * numBones);
+
+	std::vector<SkinnedPoseJob> jobs(numCharacters);
+	for (size_t i = 0; i < numCharacters; ++i) {
+		jobs[i].Clip = skinInfo.FindClip("Clip" + std::to_string(i % 3));
+		jobs[i].Cursor = &batchCursors[i];
+		jobs[i].FinalTransforms = &batched[i * numBones];
+	}
+
+	for (int frame = 0; frame < 20; ++frame) {
+		for (size_t i = 0; i < numCharacters; ++i) {
+			jobs[i].TimePos = 0.013f * static_cast<float>(i) + 0.05f * static_cast<float>(frame);
+			skinInfo.GetFinalTransforms(jobs[i].Clip, jobs[i].TimePos, &serial[i * numBones], serialCursors[i]);
+		}
+		skinInfo.GetFinalTransforms(jobs);
+
+		TEST_CHECK(AreSame(batched, serial));
+	}
+}
+
+TEST_CASE(SkinnedMeshPose_ThousandCharactersBenchmark) {
+	SkinnedModel model;
+	BuildModel(model, 60, 120, 4);
+	const auto& skinInfo = model.mSkinInfo;
+	const UINT numBones = skinInfo.BoneCount();
+
+	const size_t numCharacters = 1000;
+	const int numFrames = 10;
+
+	std::vector<std::string> clipNames(numCharacters);
+	std::vector<SkinnedPoseJob> jobs(numCharacters);
+	std::vector<AnimationCursor> cursors(numCharacters);
+	std::vector<std::vector<XMFLOAT4X4>> byName(numCharacters, std::vector<XMFLOAT4X4>(numBones));
+	std::vector<XMFLOAT4X4> byHandle(numCharacters * numBones);
+	std::vector<XMFLOAT4X4> batched(numCharacters * numBones);
+
+	for (size_t i = 0; i < numCharacters; ++i) {
+		clipNames[i] = "Clip" + std::to_string(i % 4);
+		jobs[i].Clip = skinInfo.FindClip(clipNames[i]);
+		jobs[i].Cursor = &cursors[i];
+		jobs[i].FinalTransforms = &batched[i * numBones];
+	}
+
+	auto getTime = [](size_t inCharacter, int inFrame) {
+		return 0.001f * static_cast<float>(inCharacter) + static_cast<float>(inFrame) / 60.0f;
+	};
+
+	double name = MeasureMilliseconds([&] {
+		for (int frame = 0; frame < numFrames; ++frame) {
+			for (size_t i = 0; i < numCharacters; ++i)
+				GetFinalTransformsByName(model, clipNames[i], getTime(i, frame), byName[i]);
+		}
+	});
+
+	double handle = MeasureMilliseconds([&] {
+		for (int frame = 0; frame < numFrames; ++frame) {
+			for (size_t i = 0; i < numCharacters; ++i)
+				skinInfo.GetFinalTransforms(jobs[i].Clip, getTime(i, frame), &byHandle[i * numBones], cursors[i]);
+		}
+	});
+
+	for (auto& cursor : cursors)
+		cursor.KeyIndices.clear();
+
+	double batch = MeasureMilliseconds([&] {
+		for (int frame = 0; frame < numFrames; ++frame) {
+			for (size_t i = 0; i < numCharacters; ++i)
+				jobs[i].TimePos = getTime(i, frame);
+			skinInfo.GetFinalTransforms(jobs);
+		}
+	});
+
+	std::cout << "  " << numCharacters << " characters x " << numFrames << " frames, by name " << name
+		<< " ms, by handle " << handle << " ms, batched " << batch << " ms" << std::endl;
+
+	TEST_CHECK(std::memcmp(byHandle.data(), batched.data(), byHandle.size() * sizeof(XMFLOAT4X4)) == 0);
+	for (size_t i = 0; i < numCharacters; i += 97) {
+		std::vector<XMFLOAT4X4> pose(byHandle.begin() + i * numBones, byHandle.begin() + (i + 1) * numBones);
+		TEST_CHECK(AreNear(byName[i], pose, 1e-4f));
+	}
+}
\ No newline at end of file
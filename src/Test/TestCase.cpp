@@ -0,0 +1,45 @@
+#include "Test/TestCase.h"
+
+#include <chrono>
+#include <exception>
+#include <iostream>
+
+using namespace Test;
+
+std::vector<TestCase>& Test::GetTestCases() {
+	static std::vector<TestCase> testCases;
+	return testCases;
+}
+
+int Test::RunTestCases(const std::string& inFilter) {
+	int numRun = 0;
+	int numFailed = 0;
+
+	for (const auto& test : GetTestCases()) {
+		if (!inFilter.empty() && std::string(test.mName).find(inFilter) == std::string::npos)
+			continue;
+
+		++numRun;
+
+		auto begin = std::chrono::steady_clock::now();
+		bool passed = false;
+		try {
+			test.mFunc();
+			passed = true;
+		}
+		catch (const std::exception& e) {
+			std::cout << "  " << e.what() << std::endl;
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
+		std::cout << (passed ? "[  OK  ] " : "[ FAIL ] ") << test.mName << " (" << elapsed << " ms)" << std::endl;
+
+		if (!passed)
+			++numFailed;
+	}
+
+	std::cout << numRun - numFailed << '/' << numRun << " tests passed" << std::endl;
+
+	return numFailed;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "Test/TestCase.h"
+#include "common/TextReader.h"
+
+#include <cstring>
+#include <string>
+
+namespace {
+	TextReader MakeReader(const std::string& inText) {
+		return TextReader(inText.data(), inText.data() + inText.size());
+	}
+}
+
+TEST_CASE(TextReader_ReadsLabelledValues) {
+	std::string text = "#Vertices 3\r\n#Name\tskull.txt\n  Pos: +1.5 -2 3e2\nAlphaClip: 1 Count: 0\n";
+	TextReader reader = MakeReader(text);
+
+	std::uint32_t count = 0;
+	std::string name;
+	float x = 0.0f, y = 0.0f, z = 0.0f;
+	bool alphaClip = false;
+	bool empty = true;
+
+	reader.Skip(); reader.Read(count);
+	reader.Skip(); reader.Read(name);
+	reader.Skip(); reader.Read(x, y, z);
+	reader.Skip(); reader.Read(alphaClip);
+	reader.Skip(); reader.Read(empty);
+
+	TEST_CHECK(!reader.Failed());
+	TEST_CHECK(count == 3 && name == "skull.txt");
+	TEST_CHECK(x == 1.5f && y == -2.0f && z == 300.0f);
+	TEST_CHECK(alphaClip && !empty);
+
+	// Nothing is left; reading past the end fails.
+	reader.Skip();
+	TEST_CHECK(reader.Failed());
+}
+
+TEST_CASE(TextReader_PeeksWithoutConsuming) {
+	std::string text = "  BlendWeights: 0.5 0.5 0 0";
+	TextReader reader = MakeReader(text);
+
+	TEST_CHECK(reader.PeekStartsWith("Blend"));
+	TEST_CHECK(reader.PeekStartsWith("BlendWeights:"));
+	TEST_CHECK(!reader.PeekStartsWith("BlendIndices"));
+	TEST_CHECK(!reader.PeekStartsWith("BlendWeights: 0.5 0.5 0 0 1"));
+
+	std::string label;
+	reader.Read(label);
+	TEST_CHECK(label == "BlendWeights:");
+	TEST_CHECK(!reader.Failed());
+}
+
+TEST_CASE(TextReader_SkipsSeveralTokens) {
+	std::string text = "VertexList (pos, normal)\n{\n 7";
+	TextReader reader = MakeReader(text);
+
+	int value = 0;
+	reader.Skip(4);
+	reader.Read(value);
+	TEST_CHECK(value == 7 && !reader.Failed());
+}
+
+TEST_CASE(TextReader_RejectsMalformedNumbers) {
+	auto fails = [](const std::string& inText, auto inValue) {
+		TextReader reader = MakeReader(inText);
+		reader.Read(inValue);
+		return reader.Failed();
+	};
+
+	TEST_CHECK(!fails("42", 0));
+	TEST_CHECK(!fails("+42", 0));
+	TEST_CHECK(!fails("-0.25", 0.0f));
+
+	// A number must take the whole token.
+	TEST_CHECK(fails("4x2", 0));
+	TEST_CHECK(fails("1.5", 0));
+	TEST_CHECK(fails("0.7x", 0.0f));
+	TEST_CHECK(fails("+", 0));
+	TEST_CHECK(fails("abc", 0.0f));
+
+	// Out of the range of the type.
+	TEST_CHECK(fails("9999999999", 0u));
+	TEST_CHECK(fails("-1", 0u));
+	TEST_CHECK(fails("300", static_cast<unsigned char>(0)));
+
+	TEST_CHECK(fails("", 0));
+	TEST_CHECK(fails(" \n\t ", 0));
+}
+
+TEST_CASE(TextReader_StaysFailed) {
+	std::string text = "x 5 6";
+	TextReader reader = MakeReader(text);
+
+	int first = 0;
+	int second = 0;
+	reader.Read(first);
+	TEST_CHECK(reader.Failed());
+
+	// The following reads still go on, but the failure isn't cleared.
+	reader.Read(first, second);
+	TEST_CHECK(reader.Failed());
+	TEST_CHECK(first == 5 && second == 6);
+}
+
+TEST_CASE(TextReader_StopsAtTheEndOfTheView) {
+	// The view ends in the middle of the text; the rest isn't read.
+	std::string text = "12 34";
+	TextReader reader(text.data(), text.data() + 4);
+
+	int first = 0;
+	int second = 0;
+	reader.Read(first, second);
+	TEST_CHECK(!reader.Failed());
+	TEST_CHECK(first == 12 && second == 3);
+}
\ No newline at end of file
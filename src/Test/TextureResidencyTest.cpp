@@ -0,0 +1,139 @@
+#include "Test/TestCase.h"
+#include "DX12Game/TextureResidency.h"
+
+#include <cmath>
+#include <limits>
+#include <thread>
+
+using namespace Game;
+
+namespace {
+	//* RGBA8 mip chain of a square texture, finest first.
+	std::vector<std::uint64_t> BuildMipSizes(std::uint32_t inWidth) {
+		std::vector<std::uint64_t> sizes;
+		for (std::uint32_t width = inWidth; width > 0; width >>= 1)
+			sizes.push_back(static_cast<std::uint64_t>(width) * width * 4);
+		return sizes;
+	}
+
+	std::uint64_t SumMips(const std::vector<std::uint64_t>& inSizes, std::uint32_t inFirstMip) {
+		std::uint64_t sum = 0;
+		for (size_t i = inFirstMip, end = inSizes.size(); i < end; ++i)
+			sum += inSizes[i];
+		return sum;
+	}
+
+	const std::uint64_t NoLoadLimit = std::numeric_limits<std::uint64_t>::max();
+}
+
+TEST_CASE(TextureResidency_ComputeMip) {
+	TEST_CHECK(TextureResidency::ComputeMip(0.5f, 11) == 0);
+	TEST_CHECK(TextureResidency::ComputeMip(1.0f, 11) == 0);
+	TEST_CHECK(TextureResidency::ComputeMip(2.0f, 11) == 1);
+	TEST_CHECK(TextureResidency::ComputeMip(5.0f, 11) == 2);
+	TEST_CHECK(TextureResidency::ComputeMip(1e9f, 11) == 10);
+	TEST_CHECK(TextureResidency::ComputeMip(std::nanf(""), 11) == 0);
+	TEST_CHECK(TextureResidency::ComputeMip(4.0f, 0) == 0);
+}
+
+TEST_CASE(TextureResidency_RaisesOneLevelPerUpdate) {
+	auto sizes = BuildMipSizes(1024);
+
+	TextureResidency residency;
+	residency.SetBudget(NoLoadLimit);
+
+	auto handle = residency.Register(1024, sizes, 6);
+	TEST_CHECK(residency.GetNumMips(handle) == 11);
+	TEST_CHECK(residency.GetFirstResidentMip(handle) == 6);
+
+	std::vector<TextureResidencyChange> changes;
+	for (std::uint32_t expected = 5; ; --expected) {
+		// One texel of the top level per pixel wants the full chain.
+		residency.Request(handle, 1.0f / 1024.0f);
+		residency.Update(NoLoadLimit, changes);
+
+		TEST_CHECK(changes.size() == 1);
+		TEST_CHECK(changes[0].mFirstMip == expected && changes[0].mPrevFirstMip == expected + 1);
+		TEST_CHECK(residency.GetStatistics().mResidentBytes == SumMips(sizes, expected));
+
+		if (expected == 0)
+			break;
+	}
+
+	residency.Request(handle, 1.0f / 1024.0f);
+	residency.Update(NoLoadLimit, changes);
+	TEST_CHECK(changes.empty());
+	TEST_CHECK(residency.GetStatistics().mNumPending == 0);
+}
+
+TEST_CASE(TextureResidency_EvictsLeastRecentlyRequested) {
+	auto sizes = BuildMipSizes(256);
+	const std::uint32_t tailMip = 4;
+
+	// Both tails and one full chain.
+	TextureResidency residency;
+	residency.SetBudget(SumMips(sizes, 0) + SumMips(sizes, tailMip));
+
+	auto first = residency.Register(256, sizes, tailMip);
+	auto second = residency.Register(256, sizes, tailMip);
+
+	std::vector<TextureResidencyChange> changes;
+	for (std::uint32_t i = 0; i < tailMip; ++i) {
+		residency.Request(first, 1.0f / 256.0f);
+		residency.Update(NoLoadLimit, changes);
+	}
+	TEST_CHECK(residency.GetFirstResidentMip(first) == 0);
+
+	// The first texture is no longer drawn; the second one takes its levels.
+	for (std::uint32_t i = 0; i < tailMip; ++i) {
+		residency.Request(second, 1.0f / 256.0f);
+		residency.Update(NoLoadLimit, changes);
+
+		const auto& stats = residency.GetStatistics();
+		TEST_CHECK(stats.mResidentBytes <= stats.mBudgetBytes);
+	}
+	TEST_CHECK(residency.GetFirstResidentMip(second) == 0);
+	TEST_CHECK(residency.GetFirstResidentMip(first) == tailMip);
+
+	// Lowering the budget below the tails keeps the tails.
+	residency.SetBudget(0);
+	residency.Update(NoLoadLimit, changes);
+	TEST_CHECK(residency.GetFirstResidentMip(second) == tailMip);
+	TEST_CHECK(residency.GetStatistics().mResidentBytes == 2 * SumMips(sizes, tailMip));
+	TEST_CHECK(residency.GetStatistics().mNumEvictions == 1);
+}
+
+TEST_CASE(TextureResidency_CapsLoadedBytesPerUpdate) {
+	auto sizes = BuildMipSizes(512);
+
+	TextureResidency residency;
+	residency.SetBudget(NoLoadLimit);
+
+	const std::uint32_t numTextures = 16;
+	for (std::uint32_t i = 0; i < numTextures; ++i)
+		residency.Register(512, sizes, 5);
+
+	// Requests may come from every thread that records draws; the finest one wins.
+	std::vector<std::thread> threads;
+	for (std::uint32_t t = 0; t < 4; ++t) {
+		threads.emplace_back([&residency, t]() {
+			for (TextureResidency::Handle i = 0; i < numTextures; ++i)
+				residency.Request(i, (t == 0 ? 1.0f : 8.0f) / 512.0f);
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	// A level of mip 4 is 32x32 texels, so three levels fit.
+	std::vector<TextureResidencyChange> changes;
+	residency.Update(3 * sizes[4], changes);
+	TEST_CHECK(changes.size() == 3);
+	TEST_CHECK(residency.GetStatistics().mLoadedBytes == 3 * sizes[4]);
+	TEST_CHECK(residency.GetStatistics().mNumPending == numTextures);
+
+	// The first load of an update is always taken, even if it is over the cap.
+	for (TextureResidency::Handle i = 0; i < numTextures; ++i)
+		residency.Request(i, 1.0f / 512.0f);
+	residency.Update(1, changes);
+	TEST_CHECK(changes.size() == 1);
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "Test/TestCase.h"
+#include "DX12Game/VertexWelder.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+using namespace Game;
+
+namespace {
+	struct WeldVertex {
+		float mPos[3];
+		float mTexC[2];
+		std::uint32_t mBoneIndex;
+	};
+
+	const std::uint32_t NumFloatWords = 5;
+
+	bool operator==(const WeldVertex& inLhs, const WeldVertex& inRhs) {
+		return std::memcmp(&inLhs, &inRhs, sizeof(WeldVertex)) == 0;
+	}
+
+	//* Every triangle of a grid emitted with its own three vertices, as the importer sees them.
+	std::vector<WeldVertex> BuildUnweldedGrid(std::uint32_t inSize, std::uint32_t inBoneIndex) {
+		auto vertex = [inBoneIndex](std::uint32_t inX, std::uint32_t inY) {
+			WeldVertex v = {};
+			v.mPos[0] = static_cast<float>(inX) * 0.1f;
+			v.mPos[2] = static_cast<float>(inY) * 0.1f;
+			v.mTexC[0] = static_cast<float>(inX) / 8.0f;
+			v.mTexC[1] = static_cast<float>(inY) / 8.0f;
+			v.mBoneIndex = inBoneIndex;
+			return v;
+		};
+
+		std::vector<WeldVertex> vertices;
+		for (std::uint32_t y = 0; y < inSize; ++y) {
+			for (std::uint32_t x = 0; x < inSize; ++x) {
+				vertices.push_back(vertex(x, y));
+				vertices.push_back(vertex(x, y + 1));
+				vertices.push_back(vertex(x + 1, y));
+				vertices.push_back(vertex(x + 1, y));
+				vertices.push_back(vertex(x, y + 1));
+				vertices.push_back(vertex(x + 1, y + 1));
+			}
+		}
+
+		return vertices;
+	}
+
+	//* FNV-1a over the bytes of the vertex, so the map baseline gets a well spread hash.
+	struct WeldVertexHash {
+		size_t operator()(const WeldVertex& inVertex) const {
+			const auto* bytes = reinterpret_cast<const unsigned char*>(&inVertex);
+			std::uint64_t hash = 14695981039346656037ull;
+			for (size_t i = 0; i < sizeof(WeldVertex); ++i) {
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	template <typename Func>
+	double MeasureMilliseconds(Func&& inFunc) {
+		auto begin = std::chrono::steady_clock::now();
+		inFunc();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+}
+
+TEST_CASE(VertexWelder_WeldsSharedGridCorners) {
+	const std::uint32_t size = 16;
+	auto vertices = BuildUnweldedGrid(size, 0);
+
+	std::vector<WeldVertex> welded;
+	std::vector<std::uint32_t> indices;
+	VertexWelder::WeldVertices(vertices, NumFloatWords, welded, indices);
+
+	TEST_CHECK(welded.size() == (size + 1) * (size + 1));
+	TEST_CHECK(indices.size() == vertices.size());
+	for (size_t i = 0, end = vertices.size(); i < end; ++i)
+		TEST_CHECK(welded[indices[i]] == vertices[i]);
+}
+
+TEST_CASE(VertexWelder_QuantizesFloatsButNotIntegers) {
+	VertexWelder welder;
+	welder.Initialize(6, NumFloatWords);
+
+	WeldVertex a = { { 1.0f, 2.0f, 3.0f }, { 0.5f, 0.25f }, 7 };
+	WeldVertex nearA = a;
+	nearA.mPos[0] = std::nextafter(1.0f, 2.0f);
+	WeldVertex otherBone = a;
+	otherBone.mBoneIndex = 8;
+	WeldVertex farA = a;
+	farA.mPos[0] = 1.001f;
+
+	bool inserted;
+	TEST_CHECK(welder.Weld(reinterpret_cast<const std::uint32_t*>(&a), inserted) == 0 && inserted);
+	TEST_CHECK(welder.Weld(reinterpret_cast<const std::uint32_t*>(&nearA), inserted) == 0 && !inserted);
+	TEST_CHECK(welder.Weld(reinterpret_cast<const std::uint32_t*>(&otherBone), inserted) == 1 && inserted);
+	TEST_CHECK(welder.Weld(reinterpret_cast<const std::uint32_t*>(&farA), inserted) == 2 && inserted);
+
+	// -0.0 and denormals weld with +0.0.
+	WeldVertex zero = {};
+	WeldVertex negativeZero = {};
+	negativeZero.mPos[1] = -0.0f;
+	negativeZero.mTexC[0] = 1e-20f;
+	TEST_CHECK(welder.Weld(reinterpret_cast<const std::uint32_t*>(&zero), inserted) == 3 && inserted);
+	TEST_CHECK(welder.Weld(reinterpret_cast<const std::uint32_t*>(&negativeZero), inserted) == 3 && !inserted);
+
+	TEST_CHECK(welder.GetNumUniqueVertices() == 4);
+}
+
+TEST_CASE(VertexWelder_SubmeshesMatchSequentialWeld) {
+	std::vector<std::vector<WeldVertex>> submeshes;
+	std::vector<WeldVertex> sequential;
+
+	// Overlapping grids, so vertices are shared across the submeshes too.
+	for (std::uint32_t i = 0; i < 6; ++i) {
+		submeshes.push_back(BuildUnweldedGrid(8 + i * 4, i % 2));
+		sequential.insert(sequential.end(), submeshes.back().begin(), submeshes.back().end());
+	}
+
+	std::vector<WeldVertex> expectedVertices;
+	std::vector<std::uint32_t> expectedIndices;
+	VertexWelder::WeldVertices(sequential, NumFloatWords, expectedVertices, expectedIndices);
+
+	std::vector<WeldVertex> welded;
+	std::vector<std::uint32_t> indices;
+	VertexWelder::WeldSubmeshes(submeshes, NumFloatWords, 4, welded, indices);
+
+	TEST_CHECK(welded.size() == expectedVertices.size());
+	TEST_CHECK(indices == expectedIndices);
+	for (size_t i = 0, end = welded.size(); i < end; ++i)
+		TEST_CHECK(welded[i] == expectedVertices[i]);
+}
+
+TEST_CASE(VertexWelder_SubmeshesIndependentOfThreadCount) {
+	std::vector<std::vector<WeldVertex>> submeshes;
+	for (std::uint32_t i = 0; i < 12; ++i)
+		submeshes.push_back(BuildUnweldedGrid(4 + (i * 7) % 20, i % 3));
+
+	std::vector<WeldVertex> serialVertices;
+	std::vector<std::uint32_t> serialIndices;
+	VertexWelder::WeldSubmeshes(submeshes, NumFloatWords, 1, serialVertices, serialIndices);
+
+	// The importer gets fewer threads while other imports hold the shared ones; the output must not change.
+	for (std::uint32_t numThreads : { 2u, 3u, 8u, 32u }) {
+		std::vector<WeldVertex> vertices;
+		std::vector<std::uint32_t> indices;
+		VertexWelder::WeldSubmeshes(submeshes, NumFloatWords, numThreads, vertices, indices);
+
+		TEST_CHECK(vertices.size() == serialVertices.size());
+		TEST_CHECK(indices.size() == serialIndices.size());
+		TEST_CHECK(vertices.size() == serialVertices.size() &&
+			std::memcmp(vertices.data(), serialVertices.data(), vertices.size() * sizeof(WeldVertex)) == 0);
+		TEST_CHECK(indices == serialIndices);
+	}
+}
+
+TEST_CASE(VertexWelder_MillionVerticesBenchmark) {
+	// 409 x 409 quads emitted as separate triangles, about a million vertices.
+	auto vertices = BuildUnweldedGrid(409, 0);
+
+	// The importer before the welder: exact matches in an unordered_map.
+	std::vector<WeldVertex> mapVertices;
+	std::vector<std::uint32_t> mapIndices;
+	double mapTime = MeasureMilliseconds([&] {
+		std::unordered_map<WeldVertex, std::uint32_t, WeldVertexHash> uniqueVertices;
+		mapIndices.reserve(vertices.size());
+		for (const auto& vertex : vertices) {
+			auto iter = uniqueVertices.emplace(vertex, static_cast<std::uint32_t>(mapVertices.size()));
+			if (iter.second)
+				mapVertices.push_back(vertex);
+			mapIndices.push_back(iter.first->second);
+		}
+	});
+
+	std::vector<WeldVertex> welded;
+	std::vector<std::uint32_t> indices;
+	double weldTime = MeasureMilliseconds([&] {
+		VertexWelder::WeldVertices(vertices, NumFloatWords, welded, indices);
+	});
+
+	std::cout << "  " << vertices.size() << " vertices, unordered_map " << mapTime << " ms, welder "
+		<< weldTime << " ms" << std::endl;
+
+	// The grid has no near duplicates, so both find the same vertices in the same order.
+	TEST_CHECK(welded.size() == 410 * 410);
+	TEST_CHECK(welded.size() == mapVertices.size());
+	TEST_CHECK(indices == mapIndices);
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "common/MappedFile.h"
+
+#ifdef _WIN32
+	#define NOMINMAX
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+bool MappedFile::Open(const std::string& inFileName) {
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(inFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		CloseHandle(file);
+		return false;
+	}
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	mFile = file;
+	mMapping = mapping;
+	mData = static_cast<const std::uint8_t*>(data);
+	mSize = static_cast<std::uint64_t>(size.QuadPart);
+#else
+	int file = open(inFileName.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0) {
+		close(file);
+		return false;
+	}
+
+	void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	if (data == MAP_FAILED) {
+		close(file);
+		return false;
+	}
+
+	mFile = file;
+	mData = static_cast<const std::uint8_t*>(data);
+	mSize = static_cast<std::uint64_t>(status.st_size);
+#endif
+
+	return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+	if (mData != nullptr)
+		UnmapViewOfFile(mData);
+	if (mMapping != nullptr)
+		CloseHandle(mMapping);
+	if (mFile != nullptr)
+		CloseHandle(mFile);
+
+	mFile = nullptr;
+	mMapping = nullptr;
+#else
+	if (mData != nullptr)
+		munmap(const_cast<std::uint8_t*>(mData), static_cast<size_t>(mSize));
+	if (mFile >= 0)
+		close(mFile);
+
+	mFile = -1;
+#endif
+
+	mData = nullptr;
+	mSize = 0;
+}
+
+bool MappedFile::IsOpen() const {
+	return mData != nullptr;
+}
+
+const std::uint8_t* MappedFile::GetData() const {
+	return mData;
+}
+
+std::uint64_t MappedFile::GetSize() const {
+	return mSize;
+}
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 #include "common/MathHelper.h"
 
+#include <algorithm>
+
 using namespace DirectX;
 
 const float MathHelper::Infinity = FLT_MAX;
@@ -32,6 +34,23 @@ float MathHelper::AngleFromXY(float x, float y) {
 	return theta;
 }
 
+std::uint32_t MathHelper::FindKeyframe(const float* times, std::uint32_t numKeys, float t, std::uint32_t hint) {
+	std::uint32_t lastSegment = numKeys - 2;
+
+	// A clip played forward stays in the same segment or moves on by a few keys per update.
+	if (hint <= lastSegment && t >= times[hint]) {
+		for (std::uint32_t i = hint, end = std::min(hint + 2, lastSegment); ; ++i) {
+			if (t < times[i+1])
+				return i;
+			if (i == end)
+				break;
+		}
+	}
+
+	const float* iter = std::upper_bound(times, times + numKeys, t);
+	return std::min(static_cast<std::uint32_t>(iter - times) - 1, lastSegment);
+}
+
 XMVECTOR MathHelper::RandUnitVec3() {
 	XMVECTOR One  = XMVectorSet(1.0f, 1.0f, 1.0f, 1.0f);
 	XMVECTOR Zero = XMVectorZero();
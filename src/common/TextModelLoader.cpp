@@ -0,0 +1,230 @@
+#include "common/TextModelLoader.h"
+#include "common/MappedFile.h"
+#include "common/TextReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+using namespace DirectX;
+
+namespace {
+	const char BinaryMagic[4] = { 'T', 'M', 'D', 'B' };
+	const std::uint32_t BinaryVersion = 1;
+
+	// On-disk layout of a vertex; the remaining attributes are derived on load.
+	struct BinaryVertex {
+		XMFLOAT3 Position;
+		XMFLOAT3 Normal;
+	};
+
+	struct MinMax {
+		XMFLOAT3 Min;
+		XMFLOAT3 Max;
+	};
+
+	bool IndicesInRange(const GeometryGenerator::MeshData& meshData) {
+		std::uint32_t numVertices = static_cast<std::uint32_t>(meshData.Vertices.size());
+		return std::all_of(meshData.Indices32.begin(), meshData.Indices32.end(), [numVertices](std::uint32_t index) {
+			return index < numVertices;
+		});
+	}
+}
+
+bool TextModelLoader::Load(const std::string& filename, TexCoordMode texCoordMode,
+		GeometryGenerator::MeshData& meshData, BoundingBox& bounds) {
+	std::string cacheFilename = GetCacheFilename(filename);
+
+	std::error_code textError;
+	std::error_code cacheError;
+	auto textTime = std::filesystem::last_write_time(filename, textError);
+	auto cacheTime = std::filesystem::last_write_time(cacheFilename, cacheError);
+
+	GeometryGenerator::MeshData loaded;
+	bool parsed = false;
+
+	// A missing text file leaves the cache usable on its own.
+	if (!cacheError && (textError || textTime <= cacheTime)) {
+		MappedFile file;
+		if (file.Open(cacheFilename))
+			parsed = ParseBinary(reinterpret_cast<const char*>(file.GetData()), static_cast<size_t>(file.GetSize()), loaded);
+	}
+
+	if (!parsed) {
+		MappedFile file;
+		if (!file.Open(filename))
+			return false;
+
+		loaded = GeometryGenerator::MeshData();
+		if (!ParseText(reinterpret_cast<const char*>(file.GetData()), static_cast<size_t>(file.GetSize()), loaded))
+			return false;
+
+		// Failing to write the cache only costs the next run a text parse.
+		SaveBinary(cacheFilename, loaded);
+	}
+
+	BuildVertexAttributes(texCoordMode, loaded);
+	bounds = ComputeBounds(loaded);
+	meshData = std::move(loaded);
+
+	return true;
+}
+
+std::string TextModelLoader::GetCacheFilename(const std::string& filename) {
+	return filename + ".bin";
+}
+
+bool TextModelLoader::ParseText(const char* data, size_t size, GeometryGenerator::MeshData& meshData) {
+	TextReader reader(data, data + size);
+
+	std::uint32_t vcount = 0;
+	std::uint32_t tcount = 0;
+
+	reader.Skip(); reader.Read(vcount);
+	reader.Skip(); reader.Read(tcount);
+
+	// Every vertex and triangle takes several bytes, so corrupted counts fail before allocating.
+	if (reader.Failed() || vcount > size || tcount > size)
+		return false;
+
+	reader.Skip(4); // VertexList (pos, normal) {
+
+	meshData.Vertices.resize(vcount);
+	for (auto& v : meshData.Vertices) {
+		reader.Read(v.Position.x, v.Position.y, v.Position.z);
+		reader.Read(v.Normal.x, v.Normal.y, v.Normal.z);
+
+		if (reader.Failed())
+			return false;
+	}
+
+	reader.Skip(3); // } TriangleList {
+
+	meshData.Indices32.resize(static_cast<size_t>(tcount) * 3);
+	for (auto& index : meshData.Indices32)
+		reader.Read(index);
+
+	return !reader.Failed() && IndicesInRange(meshData);
+}
+
+bool TextModelLoader::ParseBinary(const char* data, size_t size, GeometryGenerator::MeshData& meshData) {
+	const size_t headerSize = sizeof(BinaryMagic) + 3 * sizeof(std::uint32_t);
+	if (size < headerSize || std::memcmp(data, BinaryMagic, sizeof(BinaryMagic)) != 0)
+		return false;
+
+	std::uint32_t header[3];
+	std::memcpy(header, data + sizeof(BinaryMagic), sizeof(header));
+
+	std::uint32_t version = header[0];
+	std::uint64_t vcount = header[1];
+	std::uint64_t icount = header[2];
+
+	if (version != BinaryVersion || size - headerSize != vcount * sizeof(BinaryVertex) + icount * sizeof(std::uint32_t))
+		return false;
+
+	const char* vertices = data + headerSize;
+	const char* indices = vertices + vcount * sizeof(BinaryVertex);
+
+	meshData.Vertices.resize(static_cast<size_t>(vcount));
+	for (size_t i = 0; i < vcount; ++i) {
+		BinaryVertex v;
+		std::memcpy(&v, vertices + i * sizeof(BinaryVertex), sizeof(BinaryVertex));
+
+		meshData.Vertices[i].Position = v.Position;
+		meshData.Vertices[i].Normal = v.Normal;
+	}
+
+	meshData.Indices32.resize(static_cast<size_t>(icount));
+	std::memcpy(meshData.Indices32.data(), indices, static_cast<size_t>(icount) * sizeof(std::uint32_t));
+
+	return IndicesInRange(meshData);
+}
+
+bool TextModelLoader::SaveBinary(const std::string& filename, const GeometryGenerator::MeshData& meshData) {
+	std::vector<BinaryVertex> vertices(meshData.Vertices.size());
+	for (size_t i = 0, end = vertices.size(); i < end; ++i)
+		vertices[i] = { meshData.Vertices[i].Position, meshData.Vertices[i].Normal };
+
+	std::uint32_t header[3] = {
+		BinaryVersion,
+		static_cast<std::uint32_t>(meshData.Vertices.size()),
+		static_cast<std::uint32_t>(meshData.Indices32.size())
+	};
+
+	std::ofstream fout(filename, std::ios::binary | std::ios::trunc);
+	fout.write(BinaryMagic, sizeof(BinaryMagic));
+	fout.write(reinterpret_cast<const char*>(header), sizeof(header));
+	fout.write(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(BinaryVertex));
+	fout.write(reinterpret_cast<const char*>(meshData.Indices32.data()), meshData.Indices32.size() * sizeof(std::uint32_t));
+
+	return static_cast<bool>(fout);
+}
+
+void TextModelLoader::BuildVertexAttributes(TexCoordMode texCoordMode, GeometryGenerator::MeshData& meshData) {
+	std::for_each(std::execution::par, meshData.Vertices.begin(), meshData.Vertices.end(),
+		[texCoordMode](GeometryGenerator::Vertex& vertex) {
+		XMVECTOR P = XMLoadFloat3(&vertex.Position);
+		XMVECTOR N = XMLoadFloat3(&vertex.Normal);
+
+		if (texCoordMode == TexCoordMode::Spherical) {
+			// Project point onto unit sphere and generate spherical texture coordinates.
+			XMFLOAT3 spherePos;
+			XMStoreFloat3(&spherePos, XMVector3Normalize(P));
+
+			float theta = atan2f(spherePos.z, spherePos.x);
+
+			// Put in [0, 2pi].
+			if (theta < 0.0f)
+				theta += XM_2PI;
+
+			float phi = acosf(spherePos.y);
+
+			vertex.TexC = { theta / (2.0f * XM_PI), phi / XM_PI };
+		}
+		else {
+			vertex.TexC = { 0.0f, 0.0f };
+		}
+
+		// We aren't applying a texture map to the model, so we just need any tangent vector
+		// so that the math works out to give us the original interpolated vertex normal.
+		XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+		if (fabsf(XMVectorGetX(XMVector3Dot(N, up))) < 1.0f - 0.001f) {
+			XMStoreFloat3(&vertex.TangentU, XMVector3Normalize(XMVector3Cross(up, N)));
+		}
+		else {
+			up = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+			XMStoreFloat3(&vertex.TangentU, XMVector3Normalize(XMVector3Cross(N, up)));
+		}
+	});
+}
+
+BoundingBox TextModelLoader::ComputeBounds(const GeometryGenerator::MeshData& meshData) {
+	const float inf = std::numeric_limits<float>::infinity();
+	MinMax init = { XMFLOAT3(+inf, +inf, +inf), XMFLOAT3(-inf, -inf, -inf) };
+
+	MinMax minMax = std::transform_reduce(std::execution::par,
+		meshData.Vertices.begin(), meshData.Vertices.end(), init,
+		[](const MinMax& lhs, const MinMax& rhs) {
+			MinMax result;
+			XMStoreFloat3(&result.Min, XMVectorMin(XMLoadFloat3(&lhs.Min), XMLoadFloat3(&rhs.Min)));
+			XMStoreFloat3(&result.Max, XMVectorMax(XMLoadFloat3(&lhs.Max), XMLoadFloat3(&rhs.Max)));
+			return result;
+		},
+		[](const GeometryGenerator::Vertex& vertex) {
+			return MinMax{ vertex.Position, vertex.Position };
+		});
+
+	XMVECTOR vMin = XMLoadFloat3(&minMax.Min);
+	XMVECTOR vMax = XMLoadFloat3(&minMax.Max);
+
+	BoundingBox bounds;
+	XMStoreFloat3(&bounds.Center, 0.5f * (vMin + vMax));
+	XMStoreFloat3(&bounds.Extents, 0.5f * (vMax - vMin));
+
+	return bounds;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "common/TextReader.h"
+
+TextReader::TextReader(const char* inBegin, const char* inEnd) : mCurr(inBegin), mEnd(inEnd) {}
+
+bool TextReader::Failed() const {
+	return bFailed;
+}
+
+void TextReader::Skip(int inCount) {
+	for (int i = 0; i < inCount; ++i) {
+		const char* begin;
+		const char* end;
+		NextToken(begin, end);
+	}
+}
+
+bool TextReader::PeekStartsWith(const char* inPrefix) {
+	SkipSpaces();
+	size_t length = std::strlen(inPrefix);
+	return static_cast<size_t>(mEnd - mCurr) >= length && std::memcmp(mCurr, inPrefix, length) == 0;
+}
+
+void TextReader::Read(std::string& outValue) {
+	const char* begin;
+	const char* end;
+	if (NextToken(begin, end))
+		outValue.assign(begin, end);
+}
+
+void TextReader::Read(bool& outValue) {
+	int i = 0;
+	Read(i);
+	outValue = i != 0;
+}
+
+void TextReader::SkipSpaces() {
+	while (mCurr != mEnd && static_cast<unsigned char>(*mCurr) <= ' ')
+		++mCurr;
+}
+
+bool TextReader::NextToken(const char*& outBegin, const char*& outEnd) {
+	SkipSpaces();
+	if (mCurr == mEnd) {
+		bFailed = true;
+		return false;
+	}
+
+	outBegin = mCurr;
+	while (mCurr != mEnd && static_cast<unsigned char>(*mCurr) > ' ')
+		++mCurr;
+	outEnd = mCurr;
+
+	return true;
+}
\ No newline at end of file